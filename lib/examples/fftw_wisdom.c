@@ -0,0 +1,141 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/phy/common/phy_common_nr.h"
+#include "srsran/srsran.h"
+
+/*
+ * Generates FFTW wisdom ahead of time for every DFT size used by LTE and NR cells: OFDM symbol sizes for all
+ * bandwidths, with and without standard sampling rates, PRACH sizes and transform precoding sizes. The resulting file
+ * can be shared by all the processes of a host, or copied across hosts with the same CPU, through the
+ * SRSRAN_FFTW_WISDOM environment variable.
+ */
+
+#define MAX_NOF_SIZES 1024
+
+char*    output_file_name = NULL;
+uint32_t sizes[MAX_NOF_SIZES];
+uint32_t nof_sizes = 0;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [ov]\n", prog);
+  printf("\t-o output wisdom file [Default $SRSRAN_FFTW_WISDOM or ~/.srsran_fftwisdom]\n");
+  printf("\t-v srsran_verbose\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ov")) != -1) {
+    switch (opt) {
+      case 'o':
+        output_file_name = argv[optind];
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void add_size(uint32_t size)
+{
+  if (size == 0 || nof_sizes == MAX_NOF_SIZES) {
+    return;
+  }
+  for (uint32_t i = 0; i < nof_sizes; i++) {
+    if (sizes[i] == size) {
+      return;
+    }
+  }
+  sizes[nof_sizes++] = size;
+}
+
+static void add_cell_sizes(bool standard_rates)
+{
+  const uint32_t lte_prb[] = {6, 15, 25, 50, 75, 100};
+
+  srsran_use_standard_symbol_size(standard_rates);
+
+  // LTE OFDM symbol and PRACH sizes (preamble formats 0-3 and 4)
+  for (uint32_t i = 0; i < sizeof(lte_prb) / sizeof(lte_prb[0]); i++) {
+    int symbol_sz = srsran_symbol_sz(lte_prb[i]);
+    if (symbol_sz > 0) {
+      add_size((uint32_t)symbol_sz);
+      add_size((uint32_t)symbol_sz * 12);
+      add_size((uint32_t)symbol_sz * 2);
+    }
+  }
+
+  // NR OFDM symbol sizes
+  for (uint32_t nof_prb = 1; nof_prb <= SRSRAN_MAX_PRB_NR; nof_prb++) {
+    add_size(srsran_min_symbol_sz_rb(nof_prb));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval t[3];
+
+  parse_args(argc, argv);
+
+  add_cell_sizes(false);
+  add_cell_sizes(true);
+
+  // PRACH Zadoff-Chu sequence sizes
+  add_size(SRSRAN_PRACH_N_ZC_LONG);
+  add_size(SRSRAN_PRACH_N_ZC_SHORT);
+
+  // Transform precoding sizes
+  for (uint32_t nof_prb = 1; nof_prb <= SRSRAN_MAX_PRB; nof_prb++) {
+    if (srsran_dft_precoding_valid_prb(nof_prb)) {
+      add_size(nof_prb * SRSRAN_NRE);
+    }
+  }
+
+  printf("Planning %d DFT sizes, this may take a while...\n", nof_sizes);
+  gettimeofday(&t[1], NULL);
+  if (srsran_dft_prewarm(sizes, nof_sizes, SRSRAN_DFT_COMPLEX)) {
+    ERROR("Error planning DFT sizes");
+    exit(-1);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("Created %d plans in %ld.%06ld s\n", srsran_dft_cache_nof_plans(), t[0].tv_sec, t[0].tv_usec);
+
+  if (srsran_dft_export_wisdom(output_file_name)) {
+    ERROR("Error writing wisdom file");
+    exit(-1);
+  }
+  printf("Wisdom written to %s\n", output_file_name ? output_file_name : "default location");
+
+  exit(0);
+}
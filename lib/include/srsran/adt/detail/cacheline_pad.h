@@ -0,0 +1,44 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_CACHELINE_PAD_H
+#define SRSRAN_CACHELINE_PAD_H
+
+#include <cstddef>
+
+namespace srsran {
+namespace detail {
+
+constexpr size_t cacheline_size = 64;
+
+/**
+ * Padding that keeps the members declared around it in different cache lines. Unlike alignas(cacheline_size), it does
+ * not over-align the enclosing type, which can then still be allocated with the operator new of C++14.
+ */
+struct cacheline_pad {
+  cacheline_pad() {}
+  char pad[cacheline_size];
+};
+
+} // namespace detail
+} // namespace srsran
+
+#endif // SRSRAN_CACHELINE_PAD_H
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_MPMC_QUEUE_H
+#define SRSRAN_MPMC_QUEUE_H
+
+#include "srsran/adt/detail/cacheline_pad.h"
+#include "srsran/support/srsran_assert.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace srsran {
+
+/**
+ * Bounded lock-free queue with multiple producers and multiple consumers, based on the algorithm of D. Vyukov.
+ * Each slot stores a sequence number that tells producers whether the slot is free for the current lap, and consumers
+ * whether it holds an element of the current lap. Hence, pushing and popping only need a CAS on the tail/head index,
+ * and never block nor allocate. The capacity is exact, except for a capacity of 1, which is raised to 2: with a single
+ * slot, the sequence number of a pushed element is also the one of a free slot in the next lap. Power of two capacities
+ * index the slots with a mask, the others with a modulo.
+ *
+ * @tparam T element type. Must be default constructible and move assignable
+ */
+template <typename T>
+class bounded_mpmc_queue
+{
+public:
+  explicit bounded_mpmc_queue(size_t capacity_) :
+    cap(capacity_ > 1 ? capacity_ : 2), mask(is_pow2(cap) ? cap - 1 : 0), slots(new slot_t[cap])
+  {
+    srsran_assert(capacity_ > 0, "Invalid queue capacity");
+    for (size_t i = 0; i < cap; ++i) {
+      slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+  bounded_mpmc_queue(const bounded_mpmc_queue&) = delete;
+  bounded_mpmc_queue& operator=(const bounded_mpmc_queue&) = delete;
+
+  /// Pushes an element if the queue is not full. The element is left untouched when the push fails
+  template <typename U>
+  bool try_push(U&& elem)
+  {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+      slot_t&   slot = slots[slot_idx(pos)];
+      size_t    seq  = slot.seq.load(std::memory_order_acquire);
+      intptr_t  diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot.value = std::forward<U>(elem);
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // Slot still holds an element of the previous lap
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Pops the oldest element, if the queue is not empty
+  bool try_pop(T& elem)
+  {
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (true) {
+      slot_t&  slot = slots[slot_idx(pos)];
+      size_t   seq  = slot.seq.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          elem = std::move(slot.value);
+          slot.seq.store(pos + cap, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // Slot not yet written in this lap
+        return false;
+      } else {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t capacity() const { return cap; }
+
+  /// Number of elements in the queue. Only exact when no other thread is pushing or popping
+  size_t size() const
+  {
+    size_t t = tail.load(std::memory_order_acquire);
+    size_t h = head.load(std::memory_order_acquire);
+    return t > h ? t - h : 0;
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  struct slot_t {
+    std::atomic<size_t> seq{0};
+    T                   value{};
+  };
+
+  static bool is_pow2(size_t n) { return n > 0 and (n & (n - 1)) == 0; }
+
+  size_t slot_idx(size_t pos) const { return mask != 0 ? pos & mask : pos % cap; }
+
+  const size_t              cap;
+  const size_t              mask; ///< Only set for power of two capacities
+  std::unique_ptr<slot_t[]> slots;
+  // Producers and consumers update different cache lines
+  detail::cacheline_pad pad0;
+  std::atomic<size_t>   tail{0};
+  detail::cacheline_pad pad1;
+  std::atomic<size_t>   head{0};
+  detail::cacheline_pad pad2;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_MPMC_QUEUE_H
@@ -39,14 +39,14 @@ namespace srsran {
  * Note: Taking into account the usage of thread_local, this class is made a singleton
  * Note2: No considerations were made regarding false sharing between threads. It is assumed that the blocks are big
  *        enough to fill a cache line.
- * @tparam NofObjects number of objects in the pool
  * @tparam ObjSize object size
+ * @tparam DefaultNofObjects number of objects in the pool, unless another one is passed to the first get_instance()
  */
-template <size_t ObjSize, bool DebugSanitizeAddress = false>
+template <size_t ObjSize, bool DebugSanitizeAddress = false, size_t DefaultNofObjects = 4096>
 class concurrent_fixed_memory_pool
 {
   static_assert(ObjSize > 256, "This pool is particularly designed for large objects.");
-  using pool_type = concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress>;
+  using pool_type = concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress, DefaultNofObjects>;
 
   struct obj_storage_t {
     typename std::aligned_storage<ObjSize, alignof(detail::max_alignment_t)>::type buffer;
@@ -84,9 +84,9 @@ public:
     allocated_blocks.clear();
   }
 
-  static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress>* get_instance(size_t size = 4096)
+  static pool_type* get_instance(size_t size = DefaultNofObjects)
   {
-    static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress> pool(size);
+    static pool_type pool(size);
     return &pool;
   }
 
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SPSC_QUEUE_H
+#define SRSRAN_SPSC_QUEUE_H
+
+#include "srsran/adt/detail/cacheline_pad.h"
+#include "srsran/support/srsran_assert.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace srsran {
+
+/**
+ * Bounded lock-free queue with a single producer and a single consumer. The producer owns the tail index and the
+ * consumer owns the head index, each in its own cache line, and each side keeps a cached copy of the index of the
+ * other side, so that a push or a pop only reads the shared index when the cached one says the queue is full or
+ * empty. The capacity is rounded up to a power of two.
+ *
+ * @tparam T element type. Must be default constructible and move assignable
+ */
+template <typename T>
+class bounded_spsc_queue
+{
+public:
+  explicit bounded_spsc_queue(size_t capacity_) : mask(round_up_pow2(capacity_) - 1), slots(new T[mask + 1]) {}
+  bounded_spsc_queue(const bounded_spsc_queue&) = delete;
+  bounded_spsc_queue& operator=(const bounded_spsc_queue&) = delete;
+
+  /// Pushes an element if the queue is not full. The element is left untouched when the push fails. Only called by
+  /// the producer
+  template <typename U>
+  bool try_push(U&& elem)
+  {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head_cache > mask) {
+      head_cache = head.load(std::memory_order_acquire);
+      if (t - head_cache > mask) {
+        return false;
+      }
+    }
+    slots[t & mask] = std::forward<U>(elem);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Pops the oldest element, if the queue is not empty. Only called by the consumer
+  bool try_pop(T& elem)
+  {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail_cache) {
+      tail_cache = tail.load(std::memory_order_acquire);
+      if (h == tail_cache) {
+        return false;
+      }
+    }
+    elem = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t capacity() const { return mask + 1; }
+
+  /// Number of elements in the queue. Only exact when called by the producer or by the consumer
+  size_t size() const
+  {
+    size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_acquire);
+    return t > h ? t - h : 0;
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  static size_t round_up_pow2(size_t n)
+  {
+    srsran_assert(n > 0, "Invalid queue capacity");
+    size_t pow2 = 1;
+    while (pow2 < n) {
+      pow2 <<= 1;
+    }
+    return pow2;
+  }
+
+  const size_t          mask;
+  std::unique_ptr<T[]>  slots;
+  detail::cacheline_pad pad0;
+  // Producer side
+  std::atomic<size_t>   tail{0};
+  size_t                head_cache = 0;
+  detail::cacheline_pad pad1;
+  // Consumer side
+  std::atomic<size_t>   head{0};
+  size_t                tail_cache = 0;
+  detail::cacheline_pad pad2;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_SPSC_QUEUE_H
@@ -166,32 +166,57 @@ private:
   uint32_t               capacity;
 };
 
-/// Type of global byte buffer pool
-using byte_buffer_pool = concurrent_fixed_memory_pool<sizeof(byte_buffer_t)>;
+/// Number of large byte buffer storages. The SDUs in flight are mostly kept in medium storages, see
+/// make_sdu_byte_buffer(). Each active UE carrier of the eNB MAC holds 16 large storages for its HARQ Tx buffers, and
+/// part of the pool sits in the thread-local caches. With the medium storages and the byte_buffer_t objects, the pools
+/// take about 49 MB, below the 54 MB of the 4096 full size buffers they replace
+const size_t NOF_LARGE_BYTE_BUFFERS = 2048;
+
+/// Type of global byte buffer pool, which holds the storage of the large byte buffers
+using byte_buffer_pool =
+    concurrent_fixed_memory_pool<byte_buffer_t::LARGE_STORAGE_SIZE, false, NOF_LARGE_BYTE_BUFFERS>;
 
 /// Function used to generate unique byte buffers
 inline unique_byte_buffer_t make_byte_buffer() noexcept
 {
-  return std::unique_ptr<byte_buffer_t>(new (std::nothrow) byte_buffer_t());
+  return unique_byte_buffer_t(byte_buffer_t::create(byte_buffer_t::size_class::large));
 }
 
 inline unique_byte_buffer_t make_byte_buffer(uint32_t size, uint8_t value) noexcept
 {
-  return std::unique_ptr<byte_buffer_t>(new (std::nothrow) byte_buffer_t(size, value));
+  unique_byte_buffer_t buffer(byte_buffer_t::create(byte_buffer_t::fitting_class(size)));
+  if (buffer != nullptr) {
+    buffer->N_bytes = size;
+    std::fill(buffer->msg, buffer->msg + size, value);
+  }
+  return buffer;
 }
 
 inline unique_byte_buffer_t make_byte_buffer(const char* debug_ctxt) noexcept
 {
-  std::unique_ptr<byte_buffer_t> buffer(new (std::nothrow) byte_buffer_t());
+  unique_byte_buffer_t buffer(byte_buffer_t::create(byte_buffer_t::size_class::large));
   if (buffer == nullptr) {
     srslog::fetch_basic_logger("POOL").error("Failed to allocate byte buffer in %s", debug_ctxt);
   }
   return buffer;
 }
 
+/// Creates a byte buffer of the smallest size class that fits nof_bytes. Appending beyond that promotes its storage
+inline unique_byte_buffer_t make_sized_byte_buffer(uint32_t nof_bytes) noexcept
+{
+  return unique_byte_buffer_t(byte_buffer_t::create(byte_buffer_t::fitting_class(nof_bytes)));
+}
+
+/// Creates a byte buffer for a SDU of yet unknown length, which fits an MTU sized IP packet. Longer SDUs must be
+/// written through append_bytes() or after reserve_tailroom(), which promote the storage
+inline unique_byte_buffer_t make_sdu_byte_buffer() noexcept
+{
+  return unique_byte_buffer_t(byte_buffer_t::create(byte_buffer_t::size_class::medium));
+}
+
 inline unique_byte_buffer_t make_byte_buffer(const uint8_t* payload, uint32_t len, const char* debug_ctxt) noexcept
 {
-  std::unique_ptr<byte_buffer_t> buffer(new (std::nothrow) byte_buffer_t());
+  unique_byte_buffer_t buffer(byte_buffer_t::create(byte_buffer_t::fitting_class(len)));
   if (buffer == nullptr) {
     srslog::fetch_basic_logger("POOL").error("Failed to allocate byte buffer in %s", debug_ctxt);
   } else {
@@ -24,6 +24,8 @@
 
 #include "common.h"
 #include "srsran/adt/span.h"
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 
@@ -85,6 +87,13 @@ private:
  * Generic byte buffer with headroom to accommodate packet headers and custom
  * copy constructors & assignment operators for quick copying. Byte buffer
  * holds a next pointer to support linked lists.
+ *
+ * The bytes are kept in a storage of one of three size classes. Small storage
+ * is embedded in the byte_buffer_t, medium and large storages come from their
+ * own pools. Buffers created with make_byte_buffer() get a large storage, while
+ * make_sized_byte_buffer() picks the smallest class that fits the requested
+ * size. Appending beyond the tailroom transparently promotes the storage to a
+ * larger class and shrink_to_fit() moves the bytes to the smallest class.
  *****************************************************************************/
 class byte_buffer_t
 {
@@ -92,9 +101,17 @@ public:
   using iterator       = uint8_t*;
   using const_iterator = const uint8_t*;
 
+  enum class size_class : uint8_t { small = 0, medium, large, nof_classes };
+
+  static const uint32_t SMALL_STORAGE_SIZE  = 256;
+  static const uint32_t MEDIUM_STORAGE_SIZE = 2048;
+  static const uint32_t LARGE_STORAGE_SIZE  = SRSRAN_MAX_BUFFER_SIZE_BYTES;
+  /// Headroom of the small and medium classes, which fits the PDCP, RLC, GTP-U and MAC subheaders of a SDU. Large
+  /// storages keep the SRSRAN_BUFFER_HEADER_OFFSET headroom
+  static const uint32_t SMALL_HEADER_OFFSET = 64;
+
   uint32_t N_bytes = 0;
-  uint8_t  buffer[SRSRAN_MAX_BUFFER_SIZE_BYTES];
-  uint8_t* msg = nullptr;
+  uint8_t* msg     = nullptr;
 #ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
   char debug_name[SRSRAN_BUFFER_POOL_LOG_NAME_LEN];
 #endif
@@ -104,46 +121,41 @@ public:
     buffer_latency_calc tp;
   } md;
 
-  byte_buffer_t() : msg(&buffer[SRSRAN_BUFFER_HEADER_OFFSET])
-  {
-#ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
-    bzero(debug_name, SRSRAN_BUFFER_POOL_LOG_NAME_LEN);
-#endif
-  }
-  explicit byte_buffer_t(uint32_t size) : msg(&buffer[SRSRAN_BUFFER_HEADER_OFFSET]), N_bytes(size)
-  {
-#ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
-    bzero(debug_name, SRSRAN_BUFFER_POOL_LOG_NAME_LEN);
-#endif
-  }
+  byte_buffer_t() : byte_buffer_t(0u) {}
+  explicit byte_buffer_t(uint32_t size);
   byte_buffer_t(uint32_t size, uint8_t val) : byte_buffer_t(size) { std::fill(msg, msg + N_bytes, val); }
-  byte_buffer_t(const byte_buffer_t& buf) : msg(&buffer[SRSRAN_BUFFER_HEADER_OFFSET]), md(buf.md), N_bytes(buf.N_bytes)
+  byte_buffer_t(const byte_buffer_t& buf);
+  byte_buffer_t(byte_buffer_t&& buf) noexcept;
+  ~byte_buffer_t();
+
+  byte_buffer_t& operator=(const byte_buffer_t& buf);
+  byte_buffer_t& operator=(byte_buffer_t&& buf) noexcept;
+
+  /// Creates a buffer with a storage of the given class. Returns nullptr if the pools are depleted
+  static byte_buffer_t* create(size_class cls) noexcept;
+  /// Smallest size class whose storage fits nof_bytes after its default headroom
+  static size_class  fitting_class(uint32_t nof_bytes);
+  static const char* to_string(size_class cls);
+  static uint32_t    storage_size(size_class cls)
   {
-    // copy actual contents
-    memcpy(msg, buf.msg, N_bytes);
+    return cls == size_class::small ? SMALL_STORAGE_SIZE
+                                    : (cls == size_class::medium ? MEDIUM_STORAGE_SIZE : LARGE_STORAGE_SIZE);
   }
-
-  byte_buffer_t& operator=(const byte_buffer_t& buf)
+  static uint32_t default_headroom(size_class cls)
   {
-    // avoid self assignment
-    if (&buf == this)
-      return *this;
-    msg     = &buffer[buf.msg - &(*buf.buffer)];
-    N_bytes = buf.N_bytes;
-    md      = buf.md;
-    memcpy(msg, buf.msg, N_bytes);
-    return *this;
+    return cls == size_class::large ? SRSRAN_BUFFER_HEADER_OFFSET : SMALL_HEADER_OFFSET;
   }
 
   void clear()
   {
-    msg     = &buffer[SRSRAN_BUFFER_HEADER_OFFSET];
+    msg     = storage + default_headroom(cls);
     N_bytes = 0;
     md      = {};
   }
-  uint32_t get_headroom() { return msg - buffer; }
+  uint32_t   get_headroom() const { return msg - storage; }
+  size_class get_size_class() const { return cls; }
   // Returns the remaining space from what is reported to be the length of msg
-  uint32_t                  get_tailroom() const { return (sizeof(buffer) - (msg - buffer) - N_bytes); }
+  uint32_t                  get_tailroom() const { return (storage_size(cls) - (msg - storage) - N_bytes); }
   std::chrono::microseconds get_latency_us() const { return md.tp.get_latency_us(); }
 
   std::chrono::high_resolution_clock::time_point get_timestamp() const { return md.tp.get_timestamp(); }
@@ -152,14 +164,31 @@ public:
 
   void set_timestamp(std::chrono::high_resolution_clock::time_point tp_) { md.tp.set_timestamp(tp_); }
 
-  void append_bytes(uint8_t* buf, uint32_t size)
+  /// Appends the bytes, promoting the storage to a larger class if the tailroom is not enough
+  bool append_bytes(const uint8_t* buf, uint32_t size)
   {
+    if (size > get_tailroom() and not reserve_tailroom(size)) {
+      return false;
+    }
     memcpy(&msg[N_bytes], buf, size);
     N_bytes += size;
+    return true;
   }
 
-  // vector-like interface
-  void           resize(size_t size) { N_bytes = size; }
+  /// Promotes the storage to the smallest larger class that leaves nof_bytes of tailroom
+  bool reserve_tailroom(uint32_t nof_bytes);
+  /// Moves the bytes to the smallest size class that fits them. The headroom is reset to the class default
+  void shrink_to_fit();
+
+  // vector-like interface. Returns false, leaving the buffer untouched, if the storage can't be promoted to fit size
+  bool resize(size_t size)
+  {
+    if (size > N_bytes + get_tailroom() and not reserve_tailroom(size - N_bytes)) {
+      return false;
+    }
+    N_bytes = size;
+    return true;
+  }
   size_t         capacity() const { return get_tailroom(); }
   uint8_t*       data() { return msg; }
   const uint8_t* data() const { return msg; }
@@ -174,8 +203,51 @@ public:
   void* operator new[](size_t sz) = delete;
   void  operator delete(void* ptr);
   void  operator delete[](void* ptr) = delete;
+
+private:
+  friend class shared_byte_buffer_t;
+
+  struct storage_t {
+    uint8_t*   ptr       = nullptr;
+    size_class cls       = size_class::small;
+    bool       from_heap = false;
+  };
+
+  explicit byte_buffer_t(const storage_t& s);
+
+  static storage_t take_storage(size_class new_cls, bool heap_fallback);
+  static storage_t heap_storage();
+  static void      release_storage(const storage_t& s);
+
+  void release_storage();
+  void set_storage(const storage_t& s);
+  void move_bytes_to(const storage_t& s, uint32_t headroom);
+
+  uint8_t*   storage   = nullptr;
+  size_class cls       = size_class::small;
+  bool       from_heap = false;
+  uint8_t    small_storage[SMALL_STORAGE_SIZE];
+
+  /// References held by shared_byte_buffer_t handles, not copied nor moved with the bytes
+  std::atomic<uint32_t> nof_refs{0};
 };
 
+/// Usage of the pool behind each byte_buffer_t size class. The small class counts the byte_buffer_t objects of the pool
+struct byte_buffer_class_metrics_t {
+  uint32_t storage_size       = 0;
+  uint32_t nof_blocks         = 0;
+  uint32_t nof_in_use         = 0;
+  uint32_t max_in_use         = 0;
+  uint64_t nof_alloc_failures = 0;
+  uint64_t nof_promotions     = 0;
+};
+
+using byte_buffer_metrics_t =
+    std::array<byte_buffer_class_metrics_t, static_cast<size_t>(byte_buffer_t::size_class::nof_classes)>;
+
+byte_buffer_metrics_t get_byte_buffer_metrics();
+void                  log_byte_buffer_metrics();
+
 struct bit_buffer_t {
   uint32_t N_bits = 0;
   uint8_t  buffer[SRSRAN_MAX_BUFFER_SIZE_BITS];
@@ -0,0 +1,231 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_BYTE_BUFFER_CHAIN_H
+#define SRSRAN_BYTE_BUFFER_CHAIN_H
+
+#include "byte_buffer.h"
+#include "srsran/adt/bounded_vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace srsran {
+
+/**
+ * Byte buffer shared by the chains that point into it. The bytes are released with the last reference.
+ * The reference count lives in the byte_buffer_t itself, so taking ownership of a pooled buffer does not allocate a
+ * control block as std::shared_ptr would.
+ */
+class shared_byte_buffer_t
+{
+public:
+  shared_byte_buffer_t() = default;
+  shared_byte_buffer_t(std::nullptr_t) {}
+  shared_byte_buffer_t(unique_byte_buffer_t&& buf) : ptr(buf.release())
+  {
+    if (ptr != nullptr) {
+      ptr->nof_refs.store(1, std::memory_order_relaxed);
+    }
+  }
+  shared_byte_buffer_t(const shared_byte_buffer_t& other) : ptr(other.ptr)
+  {
+    if (ptr != nullptr) {
+      ptr->nof_refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  shared_byte_buffer_t(shared_byte_buffer_t&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+  ~shared_byte_buffer_t() { reset(); }
+
+  shared_byte_buffer_t& operator=(const shared_byte_buffer_t& other)
+  {
+    if (other.ptr != ptr) {
+      shared_byte_buffer_t tmp(other);
+      std::swap(ptr, tmp.ptr);
+    }
+    return *this;
+  }
+  shared_byte_buffer_t& operator=(shared_byte_buffer_t&& other) noexcept
+  {
+    if (&other != this) {
+      reset();
+      std::swap(ptr, other.ptr);
+    }
+    return *this;
+  }
+
+  void reset()
+  {
+    if (ptr != nullptr and ptr->nof_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete ptr;
+    }
+    ptr = nullptr;
+  }
+
+  byte_buffer_t* get() const { return ptr; }
+  byte_buffer_t* operator->() const { return ptr; }
+  byte_buffer_t& operator*() const { return *ptr; }
+  explicit       operator bool() const { return ptr != nullptr; }
+  long           use_count() const { return ptr != nullptr ? ptr->nof_refs.load(std::memory_order_relaxed) : 0; }
+
+  bool operator==(std::nullptr_t) const { return ptr == nullptr; }
+  bool operator!=(std::nullptr_t) const { return ptr != nullptr; }
+
+private:
+  byte_buffer_t* ptr = nullptr;
+};
+
+/******************************************************************************
+ * Byte buffer chain
+ *
+ * Scatter-gather view of a PDU made of segments of other byte buffers. Each
+ * segment keeps a reference to the buffer it points into, so the PDU can be
+ * built (e.g. by RLC segmentation/concatenation) without copying the payload
+ * and it is only flattened once into its destination with copy_to().
+ * Small segments are copied instead, next to each other, into a medium
+ * storage owned by the chain. Many small SDUs then take a single segment, and
+ * their buffers are released as soon as they are appended.
+ * The segments are stored inline. A full chain rejects further segments, and
+ * the caller closes the PDU instead.
+ *****************************************************************************/
+class byte_buffer_chain
+{
+public:
+  struct segment_t {
+    shared_byte_buffer_t buffer;
+    const uint8_t*       data   = nullptr;
+    uint32_t             len    = 0;
+    bool                 copied = false; ///< The bytes were copied into a buffer owned by the chain
+  };
+
+  static const size_t MAX_NOF_SEGMENTS = 16;
+  /// Segments up to this length are copied rather than referenced
+  static const uint32_t MAX_COPY_LEN = 512;
+
+  byte_buffer_chain() = default;
+  byte_buffer_chain(byte_buffer_chain&& other) noexcept { *this = std::move(other); }
+  byte_buffer_chain(const byte_buffer_chain&) = delete;
+  byte_buffer_chain& operator=(byte_buffer_chain&& other) noexcept
+  {
+    if (&other != this) {
+      segs      = std::move(other.segs);
+      nof_bytes = other.nof_bytes;
+      other.clear();
+    }
+    return *this;
+  }
+  byte_buffer_chain& operator=(const byte_buffer_chain&) = delete;
+
+  /// Appends a view of len bytes from data, which must point into buf, or a copy of them if len is at most
+  /// MAX_COPY_LEN. Returns false if the chain is full
+  bool append(const shared_byte_buffer_t& buf, const uint8_t* data, uint32_t len)
+  {
+    if (len == 0) {
+      return true;
+    }
+    if (len <= MAX_COPY_LEN and append_copy(data, len)) {
+      return true;
+    }
+    if (segs.full()) {
+      return false;
+    }
+    segs.emplace_back();
+    segs.back().buffer = buf;
+    segs.back().data   = data;
+    segs.back().len    = len;
+    nof_bytes += len;
+    return true;
+  }
+  /// Appends a view of the current bytes of buf
+  bool append(const shared_byte_buffer_t& buf) { return append(buf, buf->msg, buf->N_bytes); }
+
+  void clear()
+  {
+    segs.clear();
+    nof_bytes = 0;
+  }
+
+  uint32_t length() const { return nof_bytes; }
+  bool     empty() const { return nof_bytes == 0; }
+  bool     full() const { return segs.full(); }
+  /// Whether len bytes can still be appended, even if the chain is full
+  bool can_append(uint32_t len) const { return not segs.full() or (len <= MAX_COPY_LEN and fits_last_copy(len)); }
+  size_t   nof_segments() const { return segs.size(); }
+
+  const segment_t& segment(size_t idx) const { return segs[idx]; }
+
+  /// Copies len bytes of the chain, starting at offset, into dst. Returns the number of bytes copied
+  uint32_t copy_to(uint8_t* dst, uint32_t offset, uint32_t len) const
+  {
+    uint32_t copied = 0;
+    for (size_t i = 0; i < segs.size() and copied < len; ++i) {
+      const segment_t& seg = segs[i];
+      if (offset >= seg.len) {
+        offset -= seg.len;
+        continue;
+      }
+      uint32_t n = std::min(seg.len - offset, len - copied);
+      memcpy(dst + copied, seg.data + offset, n);
+      copied += n;
+      offset = 0;
+    }
+    return copied;
+  }
+  /// Flattens the whole chain into dst
+  uint32_t copy_to(uint8_t* dst) const { return copy_to(dst, 0, nof_bytes); }
+
+private:
+  bool fits_last_copy(uint32_t len) const
+  {
+    return not segs.empty() and segs.back().copied and segs.back().buffer->get_tailroom() >= len;
+  }
+
+  /// Copies the bytes after the last copied segment, or into a new copy buffer. Returns false if the chain is full or
+  /// the pools are depleted
+  bool append_copy(const uint8_t* data, uint32_t len)
+  {
+    if (not fits_last_copy(len)) {
+      if (segs.full()) {
+        return false;
+      }
+      unique_byte_buffer_t copy_buf(byte_buffer_t::create(byte_buffer_t::size_class::medium));
+      if (copy_buf == nullptr) {
+        return false;
+      }
+      segs.emplace_back();
+      segs.back().data   = copy_buf->msg;
+      segs.back().buffer = std::move(copy_buf);
+      segs.back().copied = true;
+    }
+    segment_t& seg = segs.back();
+    seg.buffer->append_bytes(data, len);
+    seg.len += len;
+    nof_bytes += len;
+    return true;
+  }
+
+  bounded_vector<segment_t, MAX_NOF_SEGMENTS> segs;
+  uint32_t                                    nof_bytes = 0;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_BYTE_BUFFER_CHAIN_H
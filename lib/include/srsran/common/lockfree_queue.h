@@ -0,0 +1,239 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         lockfree_queue.h
+ *  Description:  Blocking interface on top of the bounded lock-free queues,
+ *                with a choice of how the blocked threads wait.
+ *****************************************************************************/
+
+#ifndef SRSRAN_LOCKFREE_QUEUE_H
+#define SRSRAN_LOCKFREE_QUEUE_H
+
+#include "srsran/adt/detail/cacheline_pad.h"
+#include "srsran/adt/mpmc_queue.h"
+#include "srsran/adt/spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <linux/futex.h>
+#include <string>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace srsran {
+
+/// How a thread waits for a lock-free queue to become non-empty (or non-full)
+enum class queue_wait_policy {
+  sleep,     ///< polls the queue every 100 usec
+  busy_poll, ///< polls the queue continuously, yielding the CPU between polls. Lowest latency, but takes a core
+  spin_futex ///< polls the queue for a while, then sleeps in a futex until the other side wakes it up
+};
+
+inline const char* to_string(queue_wait_policy policy)
+{
+  switch (policy) {
+    case queue_wait_policy::sleep:
+      return "sleep";
+    case queue_wait_policy::busy_poll:
+      return "busy_poll";
+    case queue_wait_policy::spin_futex:
+      return "spin_futex";
+  }
+  return "invalid";
+}
+
+inline bool from_string(const std::string& str, queue_wait_policy& policy)
+{
+  for (queue_wait_policy p : {queue_wait_policy::sleep, queue_wait_policy::busy_poll, queue_wait_policy::spin_futex}) {
+    if (str == to_string(p)) {
+      policy = p;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Blocks the threads that wait for a lock-free queue, according to a queue_wait_policy. The waiting side retries its
+ * operation after announcing that it is going to sleep, and the other side only issues a FUTEX_WAKE when some thread
+ * has announced it, so that notify() never enters the kernel while nobody sleeps.
+ */
+class queue_waiter
+{
+public:
+  static const uint32_t default_nof_spins = 64;
+
+  explicit queue_waiter(queue_wait_policy policy_ = queue_wait_policy::spin_futex,
+                        uint32_t          nof_spins_ = default_nof_spins) :
+    policy(policy_), nof_spins(nof_spins_)
+  {}
+  queue_waiter(const queue_waiter&) = delete;
+  queue_waiter& operator=(const queue_waiter&) = delete;
+
+  queue_wait_policy get_policy() const { return policy.load(std::memory_order_relaxed); }
+  void              set_policy(queue_wait_policy policy_) { policy.store(policy_, std::memory_order_relaxed); }
+
+  /// Calls try_op until it returns true, or until running is cleared. Returns the result of the last try_op call
+  template <typename TryOp>
+  bool wait_until(const std::atomic<bool>& running, TryOp&& try_op)
+  {
+    for (uint32_t nof_polls = 0; running.load(std::memory_order_acquire); ++nof_polls) {
+      if (try_op()) {
+        return true;
+      }
+      queue_wait_policy p = get_policy();
+      if (p == queue_wait_policy::sleep) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      } else if (p == queue_wait_policy::busy_poll or nof_polls < nof_spins) {
+        std::this_thread::yield();
+      } else if (sleep_until_notified(running, try_op)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Called after making progress on the queue (e.g. pushing, for a waiting consumer). Wakes up the sleeping threads
+  void notify()
+  {
+    // Pairs with the fence in sleep_until_notified(): either we see the waiting thread, or it sees our progress
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (nof_sleeping.load(std::memory_order_relaxed) > 0) {
+      wake_up();
+    }
+  }
+
+  /// Unconditionally wakes up the sleeping threads, e.g. after clearing the running flag they wait on
+  void wake_up()
+  {
+    wakeup_seq.fetch_add(1, std::memory_order_release);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wakeup_seq), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+  }
+
+private:
+  template <typename TryOp>
+  bool sleep_until_notified(const std::atomic<bool>& running, TryOp& try_op)
+  {
+    uint32_t seq = wakeup_seq.load(std::memory_order_acquire);
+    nof_sleeping.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Retry after announcing ourselves, the other side may have raced with us
+    bool success = try_op();
+    if (not success and running.load(std::memory_order_acquire)) {
+      // The timeout only bounds the wait if a wake up is lost, e.g. to a running flag cleared without wake_up()
+      ::timespec ts = {0, 100 * 1000 * 1000};
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wakeup_seq), FUTEX_WAIT_PRIVATE, seq, &ts, nullptr, 0);
+    }
+
+    nof_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    return success;
+  }
+
+  std::atomic<queue_wait_policy> policy;
+  const uint32_t                 nof_spins;
+  detail::cacheline_pad          pad;
+  std::atomic<uint32_t>          wakeup_seq{0};
+  std::atomic<uint32_t>          nof_sleeping{0};
+};
+
+/**
+ * Bounded lock-free queue with blocking push and pop. Pushes and pops never take a lock, and the waiting of a blocked
+ * thread follows the given queue_wait_policy.
+ * @tparam T element type
+ * @tparam Queue lock-free queue with try_push/try_pop, which defines how many producers and consumers are supported
+ */
+template <typename T, typename Queue>
+class lockfree_blocking_queue
+{
+public:
+  explicit lockfree_blocking_queue(size_t capacity, queue_wait_policy policy = queue_wait_policy::spin_futex) :
+    queue(capacity), pop_waiter(policy), push_waiter(policy)
+  {}
+
+  /// Pushes an element if the queue is not full
+  template <typename U>
+  bool try_push(U&& elem)
+  {
+    if (not queue.try_push(std::forward<U>(elem))) {
+      return false;
+    }
+    pop_waiter.notify();
+    return true;
+  }
+
+  /// Pushes an element, waiting while the queue is full. Returns false if the queue is stopped
+  template <typename U>
+  bool push(U&& elem)
+  {
+    return push_waiter.wait_until(running, [this, &elem]() { return try_push(std::forward<U>(elem)); });
+  }
+
+  /// Pops an element if the queue is not empty
+  bool try_pop(T& elem)
+  {
+    if (not queue.try_pop(elem)) {
+      return false;
+    }
+    push_waiter.notify();
+    return true;
+  }
+
+  /// Pops an element, waiting while the queue is empty. Returns false if the queue is stopped
+  bool pop_wait(T& elem)
+  {
+    return pop_waiter.wait_until(running, [this, &elem]() { return try_pop(elem); });
+  }
+
+  /// Unblocks the waiting threads. Afterwards, only try_push and try_pop are served
+  void stop()
+  {
+    running.store(false, std::memory_order_release);
+    pop_waiter.wake_up();
+    push_waiter.wake_up();
+  }
+
+  void set_wait_policy(queue_wait_policy policy)
+  {
+    pop_waiter.set_policy(policy);
+    push_waiter.set_policy(policy);
+  }
+
+  size_t capacity() const { return queue.capacity(); }
+  size_t size() const { return queue.size(); }
+  bool   empty() const { return queue.empty(); }
+
+private:
+  Queue             queue;
+  queue_waiter      pop_waiter, push_waiter;
+  std::atomic<bool> running{true};
+};
+
+template <typename T>
+using spsc_blocking_queue = lockfree_blocking_queue<T, bounded_spsc_queue<T> >;
+template <typename T>
+using mpsc_blocking_queue = lockfree_blocking_queue<T, bounded_mpmc_queue<T> >;
+
+} // namespace srsran
+
+#endif // SRSRAN_LOCKFREE_QUEUE_H
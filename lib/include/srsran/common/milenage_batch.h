@@ -0,0 +1,94 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_MILENAGE_BATCH_H
+#define SRSRAN_MILENAGE_BATCH_H
+
+/******************************************************************************
+ * Milenage f1-f5 (3GPP TS 35.206) for batches of authentication vectors.
+ *
+ * Each vector takes five AES encryptions with the subscriber key K: one for
+ * TEMP, then four independent ones for f1, f2/f5, f3 and f4. The batch is
+ * processed in groups of milenage_batch_lanes vectors, so that the AES blocks
+ * of several vectors are in flight at once. With AES-NI (__AES__), the blocks
+ * are interleaved in the AES pipelines. Otherwise, mbedtls encrypts them one
+ * by one, which still saves the key expansion and the repeated TEMP of the
+ * liblte_security_milenage_* functions.
+ *****************************************************************************/
+
+#include "srsran/common/security.h"
+#include "srsran/common/ssl.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace srsran {
+
+/// Vectors processed together. f1 to f5 keep 4 * milenage_batch_lanes AES blocks in flight
+static const size_t milenage_batch_lanes = 2;
+
+struct milenage_input_t;
+struct milenage_output_t;
+
+/// Key schedule of a subscriber key K. It can be expanded once and kept with the subscriber
+class milenage_key
+{
+public:
+  milenage_key() = default;
+  explicit milenage_key(const uint8_t* k) { set(k); }
+
+  void set(const uint8_t* k);
+
+private:
+  friend void milenage_f12345_batch(const milenage_input_t* in, milenage_output_t* out, size_t nof_vectors);
+
+#ifdef __AES__
+  alignas(16) uint8_t round_keys[11][16] = {};
+#else  // __AES__
+  aes_context ctx = {};
+#endif // __AES__
+};
+
+struct milenage_input_t {
+  const milenage_key* key;
+  const uint8_t*      opc;  ///< 16 bytes
+  const uint8_t*      rand; ///< 16 bytes
+  const uint8_t*      sqn;  ///< 6 bytes
+  const uint8_t*      amf;  ///< 2 bytes
+};
+
+struct milenage_output_t {
+  uint8_t mac_a[MAC_LEN]; ///< f1
+  uint8_t res[8];         ///< f2
+  uint8_t ck[CK_LEN];     ///< f3
+  uint8_t ik[IK_LEN];     ///< f4
+  uint8_t ak[AK_LEN];     ///< f5
+};
+
+/**
+ * Computes MAC-A, RES, CK, IK and AK of each input. The inputs may use different keys.
+ * @param in Inputs, nof_vectors of them
+ * @param out Outputs, nof_vectors of them
+ */
+void milenage_f12345_batch(const milenage_input_t* in, milenage_output_t* out, size_t nof_vectors);
+
+} // namespace srsran
+
+#endif // SRSRAN_MILENAGE_BATCH_H
@@ -30,6 +30,7 @@
 
 #include "srsran/adt/circular_buffer.h"
 #include "srsran/adt/move_callback.h"
+#include "srsran/common/lockfree_queue.h"
 #include <algorithm>
 #include <condition_variable>
 #include <functional>
@@ -48,6 +49,8 @@ namespace srsran {
  * The class will pop from the several created ports in a round-robin fashion.
  * The popping() interface is not safe-thread. That means, that it is expected that only one thread will
  * be popping tasks.
+ * The ports are lock-free queues, so pushing never takes a lock nor wakes up the consumer through a condition
+ * variable. A consumer (or a pusher blocked on a full port) waits according to the multiqueue queue_wait_policy.
  * @tparam myobj message type
  */
 template <typename myobj>
@@ -56,38 +59,29 @@ class multiqueue_handler
   class input_port_impl
   {
   public:
-    input_port_impl(uint32_t cap, multiqueue_handler<myobj>* parent_) : buffer(cap), parent(parent_) {}
+    input_port_impl(uint32_t cap, multiqueue_handler<myobj>* parent_) :
+      cap_(cap), buffer(cap), push_waiter(parent_->waiter.get_policy()), parent(parent_)
+    {}
     input_port_impl(const input_port_impl&) = delete;
     input_port_impl(input_port_impl&&)      = delete;
     input_port_impl& operator=(const input_port_impl&) = delete;
     input_port_impl& operator=(input_port_impl&&) = delete;
     ~input_port_impl() { deactivate_blocking(); }
 
-    size_t capacity() const { return buffer.max_size(); }
-    size_t size() const
+    size_t capacity() const { return cap_; }
+    size_t size() const { return buffer.size(); }
+    bool   active() const { return active_.load(std::memory_order_acquire); }
+    void   set_active(bool val)
     {
-      std::lock_guard<std::mutex> lock(q_mutex);
-      return buffer.size();
-    }
-    bool active() const
-    {
-      std::lock_guard<std::mutex> lock(q_mutex);
-      return active_;
-    }
-    void set_active(bool val)
-    {
-      std::unique_lock<std::mutex> lock(q_mutex);
-      if (val == active_) {
+      if (active_.exchange(val, std::memory_order_seq_cst) == val) {
         // no-op
         return;
       }
-      active_ = val;
 
-      if (not active_) {
-        buffer.clear();
-        lock.unlock();
+      if (not val) {
+        clear();
         // unlock blocked pushing threads
-        cv_full.notify_all();
+        push_waiter.wake_up();
       }
     }
 
@@ -95,11 +89,11 @@ class multiqueue_handler
     {
       set_active(false);
 
-      // wait for all the pushers to unlock
-      std::unique_lock<std::mutex> lock(q_mutex);
-      while (nof_waiting > 0) {
-        cv_exit.wait(lock);
+      // wait for all the pushers to leave, and drop what they pushed after the deactivation
+      while (nof_pushing.load(std::memory_order_seq_cst) > 0) {
+        std::this_thread::yield();
       }
+      clear();
     }
 
     template <typename T>
@@ -120,65 +114,64 @@ class multiqueue_handler
 
     bool try_pop(myobj& obj)
     {
-      std::unique_lock<std::mutex> lock(q_mutex);
-      return pop_(lock, obj);
+      if (not buffer.try_pop(obj)) {
+        return false;
+      }
+      nof_reserved.fetch_sub(1, std::memory_order_release);
+      push_waiter.notify();
+      return true;
     }
 
-    bool try_pop(myobj& obj, bool& try_lock_success)
-    {
-      std::unique_lock<std::mutex> lock(q_mutex, std::try_to_lock);
-      try_lock_success = lock.owns_lock();
-      return try_lock_success ? pop_(lock, obj) : false;
-    }
+    void set_wait_policy(queue_wait_policy policy) { push_waiter.set_policy(policy); }
 
   private:
     template <typename T>
     bool push_(T* o, bool blocking) noexcept
     {
-      std::unique_lock<std::mutex> lock(q_mutex);
-      if (not blocking) {
-        // non-blocking case
-        if (not active_ or buffer.full()) {
-          return false;
-        }
+      // Announce the push before checking whether the port is active, so that deactivate_blocking() waits for it
+      nof_pushing.fetch_add(1, std::memory_order_seq_cst);
+      bool ret = false;
+      if (blocking) {
+        ret = push_waiter.wait_until(active_, [this, o]() { return try_push_(o); });
       } else {
-        // blocking case
-        while (active_ and buffer.full()) {
-          nof_waiting++;
-          cv_full.wait(lock);
-          nof_waiting--;
-        }
-        if (not active_) {
-          lock.unlock();
-          cv_exit.notify_one();
-          return false;
-        }
+        ret = active_.load(std::memory_order_seq_cst) and try_push_(o);
       }
-      buffer.push(std::forward<T>(*o));
-      return true;
+      nof_pushing.fetch_sub(1, std::memory_order_release);
+      return ret;
     }
 
-    bool pop_(std::unique_lock<std::mutex>& lock, myobj& obj)
+    template <typename T>
+    bool try_push_(T* o)
     {
-      if (buffer.empty()) {
+      // The lock-free queue may have more slots than cap_, so the producers reserve one of the cap_ places first
+      if (nof_reserved.fetch_add(1, std::memory_order_acquire) >= cap_) {
+        nof_reserved.fetch_sub(1, std::memory_order_relaxed);
         return false;
       }
-      obj = std::move(buffer.top());
-      buffer.pop();
-      if (nof_waiting > 0) {
-        lock.unlock();
-        cv_full.notify_one();
+      if (not buffer.try_push(std::forward<T>(*o))) {
+        // A consumer has not released the slot yet
+        nof_reserved.fetch_sub(1, std::memory_order_relaxed);
+        return false;
       }
+      parent->waiter.notify();
       return true;
     }
 
-    multiqueue_handler<myobj>* parent = nullptr;
+    void clear()
+    {
+      myobj obj;
+      while (buffer.try_pop(obj)) {
+        nof_reserved.fetch_sub(1, std::memory_order_release);
+      }
+    }
 
-    mutable std::mutex                 q_mutex;
-    srsran::dyn_circular_buffer<myobj> buffer;
-    std::condition_variable            cv_full, cv_exit;
-    bool                               active_     = true;
-    int                                nof_waiting = 0;
+    const uint32_t                    cap_;
+    srsran::bounded_mpmc_queue<myobj> buffer;
+    queue_waiter                      push_waiter;
+    std::atomic<bool>                 active_{true};
+    std::atomic<int>                  nof_pushing{0};
+    std::atomic<uint32_t>             nof_reserved{0}; ///< Elements pushed or being pushed, and not yet popped
+    multiqueue_handler<myobj>*        parent = nullptr;
   };
 
 public:
@@ -221,8 +214,9 @@ public:
     std::unique_ptr<input_port_impl, recycle_op> impl;
   };
 
-  explicit multiqueue_handler(uint32_t default_capacity_ = MULTIQUEUE_DEFAULT_CAPACITY) :
-    default_capacity(default_capacity_)
+  explicit multiqueue_handler(uint32_t          default_capacity_ = MULTIQUEUE_DEFAULT_CAPACITY,
+                              queue_wait_policy wait_policy       = queue_wait_policy::spin_futex) :
+    waiter(wait_policy), default_capacity(default_capacity_)
   {}
   ~multiqueue_handler() { stop(); }
 
@@ -234,6 +228,7 @@ public:
       // signal deactivation to pushing threads in a non-blocking way
       q.set_active(false);
     }
+    waiter.wake_up();
     while (consumer_state) {
       cv_exit.wait(lock);
     }
@@ -243,6 +238,16 @@ public:
     }
   }
 
+  /// Sets how the consumer, and the producers blocked on a full queue, wait
+  void set_wait_policy(queue_wait_policy policy)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    waiter.set_policy(policy);
+    for (auto& q : queues) {
+      q.set_wait_policy(policy);
+    }
+  }
+
   /**
    * Adds a new queue with fixed capacity
    * @param capacity_ The capacity of the queue.
@@ -289,20 +294,22 @@ public:
   bool wait_pop(myobj* value)
   {
     std::unique_lock<std::mutex> lock(mutex);
-    consumer_state = true;
-    while (running) {
-      if (round_robin_pop_(value)) {
-        consumer_state = false;
-        return true;
-      }
-      lock.unlock();
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-      lock.lock();
+    if (running and round_robin_pop_(value)) {
+      return true;
     }
+    consumer_state = true;
+    lock.unlock();
+
+    bool ret = waiter.wait_until(running, [this, value]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return round_robin_pop_(value);
+    });
+
+    lock.lock();
     consumer_state = false;
     lock.unlock();
     cv_exit.notify_one();
-    return false;
+    return ret;
   }
 
   bool try_pop(myobj* value)
@@ -321,23 +328,20 @@ private:
       if (q_it == queues.end()) {
         q_it = queues.begin(); // wrap-around
       }
-      bool try_lock_success = true;
-      if (q_it->try_pop(*value, try_lock_success)) {
+      if (q_it->try_pop(*value)) {
         spin_idx = (spin_idx + count + 1) % queues.size();
         return true;
       }
-      if (not try_lock_success) {
-        // restart RR search, as there was a collision with a producer
-        count = 0;
-      }
     }
     return false;
   }
 
   mutable std::mutex          mutex;
   std::condition_variable     cv_exit;
+  queue_waiter                waiter; ///< Wakes up the consumer when a producer pushes
   uint32_t                    spin_idx = 0;
-  bool                        running = true, consumer_state = false;
+  std::atomic<bool>           running{true};
+  bool                        consumer_state = false;
   std::deque<input_port_impl> queues;
   uint32_t                    default_capacity = 0;
 };
@@ -27,14 +27,16 @@
 #include "srsran/common/threads.h"
 
 #include <arpa/inet.h>
-#include <map>
+#include <array>
 #include <mutex>
 #include <netinet/in.h>
 #include <netinet/sctp.h>
 #include <netinet/tcp.h>
 #include <netinet/udp.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <sys/types.h>
+#include <unordered_map>
 
 namespace srsran {
 
@@ -132,9 +134,11 @@ protected:
 };
 
 /**
- * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via a select
+ * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via epoll
  *               The user can register their own (socket fd, data handler) in this class via the
- *               add_socket_handler(fd, task) API or its other variants
+ *               add_socket_handler(fd, task) API or its other variants.
+ *               Ready fds are fetched in batches of up to max_events_per_wait, and each event is dispatched to its
+ *               handler via a hash lookup, so the cost of a wakeup does not grow with the number of registered sockets.
  */
 class socket_manager final : public thread, public socket_manager_itf
 {
@@ -152,25 +156,29 @@ public:
   void run_thread() override;
 
 private:
-  const int thread_prio = 65;
+  const int                 thread_prio         = 65;
+  static constexpr uint32_t max_events_per_wait = 32;
 
-  // used to unlock select
+  // used to unlock epoll_wait
   struct ctrl_cmd_t {
-    enum class cmd_id_t { EXIT, NEW_FD, RM_FD };
+    enum class cmd_id_t { EXIT, RM_FD };
     cmd_id_t cmd;
     int      new_fd;
     bool     signal_rm_complete;
     ctrl_cmd_t() { bzero(this, sizeof(ctrl_cmd_t)); }
   };
-  std::map<int, recv_callback_t>::iterator remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd);
+  void remove_socket_unprotected(int fd);
+  bool handle_ctrl_cmd();
 
   // state
-  std::mutex                     socket_mutex;
-  std::map<int, recv_callback_t> active_sockets;
-  std::atomic<bool>              running   = {false};
-  int                            pipefd[2] = {-1, -1};
-  std::vector<int>               rem_fd_tmp_list;
-  std::condition_variable        rem_cvar;
+  std::mutex                                   socket_mutex;
+  std::unordered_map<int, recv_callback_t>     active_sockets;
+  std::atomic<bool>                            running   = {false};
+  int                                          epoll_fd  = -1;
+  int                                          pipefd[2] = {-1, -1};
+  std::array<epoll_event, max_events_per_wait> events;
+  std::vector<int>                             rem_fd_tmp_list;
+  std::condition_variable                      rem_cvar;
 };
 
 /// Function signature for SDU byte buffers received from SCTP socket
@@ -180,6 +188,12 @@ using sctp_recv_callback_t =
 /// Function signature for SDU byte buffers received from any sockaddr_in-based socket
 using recvfrom_callback_t = srsran::move_callback<void(srsran::unique_byte_buffer_t, const sockaddr_in&)>;
 
+/// Batch of SDU byte buffers, and respective source addresses, received from a socket in a single recvmmsg call
+using rx_sdu_batch_t = std::vector<std::pair<srsran::unique_byte_buffer_t, sockaddr_in>>;
+
+/// Function signature for batches of SDU byte buffers received from any sockaddr_in-based datagram socket
+using recvfrom_batch_callback_t = srsran::move_callback<void(rx_sdu_batch_t&)>;
+
 /**
  * Helper function that creates a callback that is called when a SCTP socket has data, and does the following tasks:
  * 1. receive SDU byte buffer from SCTP socket and associated metadata - sockaddr_in, sctp_sndrcvinfo, flags
@@ -200,6 +214,16 @@ make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& q
 socket_manager_itf::recv_callback_t
 make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, recvfrom_callback_t rx_callback);
 
+/**
+ * Similar to make_sdu_handler, but it reads up to "max_batch_size" datagrams per wakeup via a single recvmmsg call, and
+ * dispatches them as a single task to the "queue"
+ * @param max_batch_size maximum number of datagrams read per recvmmsg call
+ */
+socket_manager_itf::recv_callback_t make_batch_sdu_handler(srslog::basic_logger&      logger,
+                                                           srsran::task_queue_handle& queue,
+                                                           recvfrom_batch_callback_t  rx_callback,
+                                                           uint32_t                   max_batch_size);
+
 inline socket_manager& get_rx_io_manager()
 {
   static socket_manager io;
@@ -33,8 +33,10 @@ namespace srsran {
 class task_scheduler
 {
 public:
-  explicit task_scheduler(uint32_t default_extern_tasks_size = 512, uint32_t nof_timers_prealloc = 100) :
-    external_tasks{default_extern_tasks_size}, timers{nof_timers_prealloc}, internal_tasks(512)
+  explicit task_scheduler(uint32_t          default_extern_tasks_size = 512,
+                          uint32_t          nof_timers_prealloc       = 100,
+                          queue_wait_policy wait_policy               = queue_wait_policy::spin_futex) :
+    external_tasks{default_extern_tasks_size, wait_policy}, timers{nof_timers_prealloc}, internal_tasks(512)
   {
     background_queue = external_tasks.add_queue();
   }
@@ -45,6 +47,9 @@ public:
 
   void stop() { external_tasks.stop(); }
 
+  //! Sets how run_next_task() waits for tasks coming from external threads
+  void set_wait_policy(queue_wait_policy policy) { external_tasks.set_wait_policy(policy); }
+
   srsran::unique_timer get_unique_timer() { return timers.get_unique_timer(); }
 
   //! Creates new queue for tasks coming from external thread
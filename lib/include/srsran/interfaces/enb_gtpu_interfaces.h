@@ -34,6 +34,7 @@ struct gtpu_args_t {
   std::string embms_m1u_if_addr;
   bool        embms_enable                 = false;
   uint32_t    indirect_tunnel_timeout_msec = 0;
+  uint32_t    s1u_batch_size               = 1; ///< Max PDUs per recvmmsg/sendmmsg call on S1-U. 1 disables batching
 };
 
 // GTPU interface for PDCP
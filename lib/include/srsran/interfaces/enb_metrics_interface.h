@@ -29,6 +29,7 @@
 #include "srsenb/hdr/stack/mac/common/mac_metrics.h"
 #include "srsenb/hdr/stack/rrc/rrc_metrics.h"
 #include "srsenb/hdr/stack/s1ap/s1ap_metrics.h"
+#include "srsenb/hdr/stack/upper/gtpu_metrics.h"
 #include "srsran/common/metrics_hub.h"
 #include "srsran/radio/radio_metrics.h"
 #include "srsran/rlc/rlc_metrics.h"
@@ -52,11 +53,13 @@ struct stack_metrics_t {
   rlc_metrics_t  rlc;
   pdcp_metrics_t pdcp;
   s1ap_metrics_t s1ap;
+  gtpu_metrics_t gtpu;
 };
 
 struct enb_metrics_t {
   srsran::rf_metrics_t       rf;
   std::vector<phy_metrics_t> phy;
+  pusch_fanout_metrics_t     pusch_fanout;
   stack_metrics_t            stack;
   stack_metrics_t            nr_stack;
   srsran::sys_metrics_t      sys;
@@ -97,6 +97,7 @@ public:
   virtual bool add_nas_timer(int timer_fd, enum nas_timer_type type, uint64_t imsi) = 0;
   virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi)        = 0;
   virtual bool remove_nas_timer(enum nas_timer_type type, uint64_t imsi)            = 0;
+  virtual void replace_nas_ctx(uint64_t imsi, nas* old_ctx, nas* new_ctx)           = 0;
 };
 
 class s1ap_interface_mme // MME -> S1AP
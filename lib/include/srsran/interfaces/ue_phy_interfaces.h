@@ -100,6 +100,7 @@ struct phy_args_t {
   float       rx_gain_offset               = 62;
   bool        pdsch_csi_enabled            = true;
   bool        pdsch_8bit_decoder           = false;
+  uint32_t    pdsch_cb_workers             = 0;
   uint32_t    intra_freq_meas_len_ms       = 20;
   uint32_t    intra_freq_meas_period_ms    = 200;
   float       force_ul_amplitude           = 0.0f;
@@ -24,6 +24,7 @@
 
 #include "srsran/config.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**********************************************************************************************
  *  File:         dft.h
@@ -102,6 +103,33 @@ SRSRAN_API int srsran_dft_replan_r(srsran_dft_plan_t* plan, int new_dft_points);
 
 SRSRAN_API void srsran_dft_plan_free(srsran_dft_plan_t* plan);
 
+/* Plan cache */
+
+/**
+ * FFTW plans are kept in a process-wide cache keyed by size, direction, mode, strides and buffer alignment, so planning
+ * the same transform again (from another worker or after a PRB change) does not run the FFTW planner. This function
+ * plans the forward and backward transforms of the given sizes, so that later calls to srsran_dft_plan/replan for them
+ * are served from the cache instead of planning in the real-time path.
+ * @param sizes DFT sizes to plan
+ * @param nof_sizes Number of sizes
+ * @param mode Complex or real transform
+ * @return SRSRAN_SUCCESS if all plans were created, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_dft_prewarm(const uint32_t* sizes, uint32_t nof_sizes, srsran_dft_mode_t mode);
+
+/**
+ * Writes the FFTW wisdom accumulated by this process into a file. The wisdom is also written automatically at exit when
+ * new plans were created, to the file given by the SRSRAN_FFTW_WISDOM environment variable or ~/.srsran_fftwisdom.
+ * @param filename Destination file, NULL for the default location
+ * @return SRSRAN_SUCCESS on success, SRSRAN_ERROR otherwise
+ */
+SRSRAN_API int srsran_dft_export_wisdom(const char* filename);
+
+/**
+ * @return Number of plans held in the process-wide plan cache
+ */
+SRSRAN_API uint32_t srsran_dft_cache_nof_plans(void);
+
 /* Set options */
 
 SRSRAN_API void srsran_dft_plan_set_mirror(srsran_dft_plan_t* plan, bool val);
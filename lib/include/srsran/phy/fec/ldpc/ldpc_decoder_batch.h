@@ -0,0 +1,89 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_decoder_batch.h
+ * \brief Declaration of the LDPC batch decoder, which decodes the code blocks of a transport block concurrently.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#ifndef SRSRAN_LDPC_DECODER_BATCH_H
+#define SRSRAN_LDPC_DECODER_BATCH_H
+
+#include "srsran/phy/fec/ldpc/ldpc_decoder.h"
+
+/*!
+ * \brief Code block of a batch: decoder input, output and result.
+ */
+typedef struct {
+  const int8_t* llrs;           /*!< \brief Rate-dematched LLRs of the codeword. */
+  uint8_t*      message;        /*!< \brief Decoded message, it must fit the number of uncoded bits of the graph. */
+  uint32_t      cdwd_rm_length; /*!< \brief Number of LLRs of the codeword (after rate matching). */
+  int           ret;            /*!< \brief Result of srsran_ldpc_decoder_decode_crc_c() for the code block. */
+} srsran_ldpc_decoder_batch_cb_t;
+
+/*!
+ * \brief Pool of threads that decode code blocks besides the calling thread. Each thread has its own decoders for all
+ * the base graphs and lifting sizes, and its own CRC object.
+ */
+typedef struct SRSRAN_API {
+  void*    ptr;         /*!< \brief Worker threads and the batch being decoded. */
+  uint32_t nof_workers; /*!< \brief Number of worker threads, the calling thread is not counted. */
+} srsran_ldpc_decoder_batch_t;
+
+/*!
+ * Creates the worker threads of a batch decoder. With no workers, the batches are decoded by the calling thread.
+ * \param[out] q           A pointer to a srsran_ldpc_decoder_batch_t structure.
+ * \param[in]  args        LDPC configuration arguments for the decoders of the workers (base graph and lifting size
+ *                         are ignored).
+ * \param[in]  nof_workers Number of worker threads.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+SRSRAN_API int srsran_ldpc_decoder_batch_init(srsran_ldpc_decoder_batch_t*      q,
+                                              const srsran_ldpc_decoder_args_t* args,
+                                              uint32_t                          nof_workers);
+
+/*!
+ * Stops the worker threads and frees all the resources of the batch decoder.
+ * \param[in] q A pointer to the dismantled batch decoder.
+ */
+SRSRAN_API void srsran_ldpc_decoder_batch_free(srsran_ldpc_decoder_batch_t* q);
+
+/*!
+ * Decodes a batch of code blocks with 8-bit integer-valued LLRs. The calling thread and the workers take code blocks
+ * until all of them are decoded, and each code block stops iterating as soon as its CRC matches. It returns after
+ * all the code blocks have been decoded.
+ * \param[in] q A pointer to the batch decoder.
+ * \param[in] decoder Decoder of the calling thread, its base graph and lifting size apply to all the code blocks.
+ * \param[in] crc Code-block CRC object for early stop, the workers use a copy of it. Set to NULL to disable check.
+ * \param[in,out] cbs Code blocks to decode; the result of each one is written in its ret field.
+ * \param[in] nof_cbs Number of code blocks.
+ * \return -1 if any code block failed to decode, 0 otherwise.
+ */
+SRSRAN_API int srsran_ldpc_decoder_batch_decode_c(srsran_ldpc_decoder_batch_t*    q,
+                                                  srsran_ldpc_decoder_t*          decoder,
+                                                  srsran_crc_t*                   crc,
+                                                  srsran_ldpc_decoder_batch_cb_t* cbs,
+                                                  uint32_t                        nof_cbs);
+
+#endif // SRSRAN_LDPC_DECODER_BATCH_H
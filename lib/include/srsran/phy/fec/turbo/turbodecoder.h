@@ -55,8 +55,11 @@
 #include "srsran/phy/fec/turbo/turbodecoder_impl.h"
 #undef LLR_IS_16BIT
 
-#define SRSRAN_TDEC_NOF_AUTO_MODES_8 2
-#define SRSRAN_TDEC_NOF_AUTO_MODES_16 3
+#define SRSRAN_TDEC_NOF_AUTO_MODES_8 3
+#define SRSRAN_TDEC_NOF_AUTO_MODES_16 4
+
+// One interleaver for each possible number of sub-blocks (1, 8, 16, 32 or 64)
+#define SRSRAN_TDEC_NOF_INTERLEAVERS 5
 
 typedef enum { SRSRAN_TDEC_8, SRSRAN_TDEC_16 } srsran_tdec_llr_type_t;
 
@@ -90,7 +93,7 @@ typedef struct SRSRAN_API {
   uint32_t               current_long_cb;
   uint32_t               current_inter_idx;
   int                    current_cbidx;
-  srsran_tc_interl_t     interleaver[4][SRSRAN_NOF_TC_CB_SIZES];
+  srsran_tc_interl_t     interleaver[SRSRAN_TDEC_NOF_INTERLEAVERS][SRSRAN_NOF_TC_CB_SIZES];
   int                    n_iter;
 } srsran_tdec_t;
 
@@ -119,6 +119,14 @@ typedef struct SRSRAN_API {
   cf_t                        sub[839 * 2];
   float                       phase[839];
 
+  // Batched detection: the correlations with all the root sequences are computed in one pass
+  bool              batch_detection;
+  uint32_t          batch_stride;  // Distance between the correlations of consecutive roots, for aligned rows
+  cf_t*             batch_spec;    // Correlation spectrum of each root
+  cf_t*             batch_td;      // Time-domain correlation of each root
+  float*            batch_corr;    // Power delay profile of each root
+  srsran_dft_plan_t zc_ifft_batch; // Batched IFFT of all the correlation spectra
+
 } srsran_prach_t;
 
 typedef struct SRSRAN_API {
@@ -157,6 +165,7 @@ typedef struct {
   srsran_tdd_config_t tdd_config;
   bool                enable_successive_cancellation;
   bool                enable_freq_domain_offset_calc;
+  bool                enable_batch_detection;
 } srsran_prach_cfg_t;
 
 typedef struct SRSRAN_API {
@@ -71,6 +71,9 @@ typedef struct SRSRAN_API {
 
   srsran_uci_cqi_pusch_t uci_cqi;
 
+  /* Code block workers, NULL if disabled */
+  void* cb_pool_ptr;
+
 } srsran_sch_t;
 
 SRSRAN_API int srsran_sch_init(srsran_sch_t* q);
@@ -81,6 +84,15 @@ SRSRAN_API void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 
 SRSRAN_API float srsran_sch_last_noi(srsran_sch_t* q);
 
+/**
+ * Spreads the code blocks of the transport blocks to encode or decode across nof_workers threads, besides the calling
+ * one. Each worker has its own turbo encoder and decoder. The call returns once all the code blocks have been
+ * processed, and the result is the same as decoding them serially. A value of 0 disables the workers.
+ */
+SRSRAN_API int srsran_sch_enable_cb_workers(srsran_sch_t* q, uint32_t nof_workers);
+
+SRSRAN_API void srsran_sch_disable_cb_workers(srsran_sch_t* q);
+
 SRSRAN_API int srsran_dlsch_encode(srsran_sch_t* q, srsran_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSRAN_API int srsran_dlsch_encode2(srsran_sch_t*       q,
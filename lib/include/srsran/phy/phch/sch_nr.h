@@ -34,6 +34,7 @@
 #include "srsran/phy/common/phy_common_nr.h"
 #include "srsran/phy/fec/crc.h"
 #include "srsran/phy/fec/ldpc/ldpc_decoder.h"
+#include "srsran/phy/fec/ldpc/ldpc_decoder_batch.h"
 #include "srsran/phy/fec/ldpc/ldpc_encoder.h"
 #include "srsran/phy/fec/ldpc/ldpc_rm.h"
 #include "srsran/phy/phch/phch_cfg_nr.h"
@@ -59,6 +60,7 @@ typedef struct SRSRAN_API {
 
   /// Temporal data buffers
   uint8_t* temp_cb;
+  uint8_t* temp_cb_batch; ///< Decoded code blocks of a batch, only used with code block workers
 
   /// CRC generators
   srsran_crc_t crc_tb_24;
@@ -73,6 +75,9 @@ typedef struct SRSRAN_API {
   srsran_ldpc_decoder_t* decoder_bg1[MAX_LIFTSIZE + 1];
   srsran_ldpc_decoder_t* decoder_bg2[MAX_LIFTSIZE + 1];
 
+  /// Decodes the code blocks of a transport block concurrently
+  srsran_ldpc_decoder_batch_t decoder_batch;
+
   /// LDPC Rate matcher
   srsran_ldpc_rm_t tx_rm;
   srsran_ldpc_rm_t rx_rm;
@@ -85,7 +90,8 @@ typedef struct SRSRAN_API {
   bool     disable_simd;
   bool     decoder_use_flooded;
   float    decoder_scaling_factor;
-  uint32_t max_nof_iter; ///< Maximum number of LDPC iterations
+  uint32_t max_nof_iter;   ///< Maximum number of LDPC iterations
+  uint32_t nof_cb_workers; ///< Number of threads decoding code blocks besides the calling one, 0 decodes serially
 } srsran_sch_nr_args_t;
 
 /**
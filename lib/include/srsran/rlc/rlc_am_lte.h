@@ -113,8 +113,8 @@ private:
 
   rlc_am_config_t cfg = {};
 
-  // TX SDU buffers
-  unique_byte_buffer_t tx_sdu;
+  // TX SDU buffers. The SDU is shared with the tx window PDUs that carry its segments
+  shared_byte_buffer_t tx_sdu;
 
   /****************************************************************************
    * State variables and counters
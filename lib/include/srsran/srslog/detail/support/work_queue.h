@@ -22,26 +22,83 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 #define SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 
-#include "srsran/adt/circular_buffer.h"
 #include "srsran/srslog/detail/support/backend_capacity.h"
-#include "srsran/srslog/detail/support/thread_utils.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <linux/futex.h>
+#include <memory>
+#include <new>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
 
 namespace srslog {
 
 namespace detail {
 
-//: TODO: this is a temp work queue.
+/// Size of a cache line, used to keep the slots and the producer and consumer
+/// indexes apart.
+constexpr size_t work_queue_cacheline_size = 64;
 
 /// Thread safe generic data type work queue.
+/// This is a bounded lock-free multiple producer, single consumer queue based
+/// on a ring of sequenced slots: producers claim a slot with a CAS on the
+/// enqueue index and publish it by bumping the slot sequence number, the
+/// consumer owns the dequeue index exclusively. Each slot is padded to whole
+/// cache lines so that producers writing to adjacent slots do not false share.
+/// A consumer with nothing to do may block in wait_for_entries(), producers
+/// wake it up through a futex only when it has announced it is sleeping, so
+/// the push fast path never enters the kernel.
+/// NOTE: capacity must be a power of two.
 template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
 class work_queue
 {
-  srsran::dyn_circular_buffer<T> queue;
-  mutable mutex                  m;
-  static constexpr size_t        threshold = capacity * 0.98;
+  static_assert(capacity > 1 && (capacity & (capacity - 1)) == 0, "Work queue capacity must be a power of two");
+
+  struct alignas(work_queue_cacheline_size) slot {
+    std::atomic<size_t> sequence;
+    T                   value;
+  };
+
+  /// The slots are over-aligned, which operator new[] does not honour in C++14.
+  struct slot_array_deleter {
+    void operator()(slot* p) const
+    {
+      for (size_t i = 0; i != capacity; ++i) {
+        p[i].~slot();
+      }
+      ::free(p);
+    }
+  };
+
+  static constexpr size_t mask      = capacity - 1;
+  static constexpr size_t threshold = capacity * 0.98;
+
+  std::unique_ptr<slot[], slot_array_deleter> buffer;
+  /// Shared by all producers, lives on its own cache line.
+  alignas(work_queue_cacheline_size) std::atomic<size_t> enqueue_pos;
+  /// Only written by the consumer, lives on its own cache line.
+  alignas(work_queue_cacheline_size) std::atomic<size_t> dequeue_pos;
+  /// Consumer wakeup state.
+  alignas(work_queue_cacheline_size) std::atomic<uint32_t> wakeup_seq;
+  std::atomic<bool> consumer_waiting;
 
 public:
-  work_queue() : queue(capacity) {}
+  work_queue() : enqueue_pos(0), dequeue_pos(0), wakeup_seq(0), consumer_waiting(false)
+  {
+    void* mem = nullptr;
+    if (::posix_memalign(&mem, work_queue_cacheline_size, sizeof(slot) * capacity) != 0) {
+      throw std::bad_alloc();
+    }
+    slot* slots = static_cast<slot*>(mem);
+    for (size_t i = 0; i != capacity; ++i) {
+      new (&slots[i]) slot();
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    buffer.reset(slots);
+  }
 
   work_queue(const work_queue&) = delete;
   work_queue& operator=(const work_queue&) = delete;
@@ -50,52 +107,86 @@ public:
   /// queue is full, otherwise true.
   bool push(const T& value)
   {
-    m.lock();
-    // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
-      return false;
-    }
-    queue.push(value);
-    m.unlock();
-
-    return true;
+    T copy = value;
+    return push(std::move(copy));
   }
 
   /// Inserts a new element into the back of the queue. Returns false when the
   /// queue is full, otherwise true.
   bool push(T&& value)
   {
-    m.lock();
-    // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
-      return false;
+    slot*  s   = nullptr;
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      s             = &buffer[pos & mask];
+      intptr_t diff = static_cast<intptr_t>(s->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // Discard the new element if we reach the maximum capacity.
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    s->value = std::move(value);
+    s->sequence.store(pos + 1, std::memory_order_release);
+
+    // Pairs with the fence in wait_for_entries(): either we see the consumer
+    // waiting, or it sees the new element before going to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_waiting.load(std::memory_order_relaxed)) {
+      wake_up_consumer();
     }
-    queue.push(std::move(value));
-    m.unlock();
 
     return true;
   }
 
   /// Extracts the top most element from the queue if it exists.
   /// Returns a pair with a bool indicating if the pop has been successful.
+  /// NOTE: only one thread may pop elements from the queue.
   std::pair<bool, T> try_pop()
   {
-    m.lock();
-
-    if (queue.empty()) {
-      m.unlock();
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    slot&  s   = buffer[pos & mask];
+    if (s.sequence.load(std::memory_order_acquire) != pos + 1) {
       return {false, T()};
     }
 
-    // Here we have been woken up normally.
-    T Item = std::move(queue.top());
-    queue.pop();
+    T item = std::move(s.value);
+    s.sequence.store(pos + capacity, std::memory_order_release);
+    dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+
+    return {true, std::move(item)};
+  }
+
+  /// Blocks the consumer thread until a new element is pushed, wake_up_consumer()
+  /// is called or the specified timeout expires, whatever happens first.
+  void wait_for_entries(std::chrono::microseconds timeout)
+  {
+    uint32_t seq = wakeup_seq.load(std::memory_order_acquire);
+    consumer_waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Re-check after announcing ourselves, a producer may have raced with us.
+    if (!has_pending_entry()) {
+      ::timespec ts;
+      ts.tv_sec  = timeout.count() / 1000000;
+      ts.tv_nsec = (timeout.count() % 1000000) * 1000;
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wakeup_seq), FUTEX_WAIT_PRIVATE, seq, &ts, nullptr, 0);
+    }
 
-    m.unlock();
+    consumer_waiting.store(false, std::memory_order_relaxed);
+  }
 
-    return {true, std::move(Item)};
+  /// Unblocks the consumer thread if it is waiting in wait_for_entries().
+  void wake_up_consumer()
+  {
+    wakeup_seq.fetch_add(1, std::memory_order_release);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wakeup_seq), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
   }
 
   /// Capacity of the queue.
@@ -104,9 +195,18 @@ public:
   /// Returns true when the queue is almost full, otherwise returns false.
   bool is_almost_full() const
   {
-    scoped_lock lock(m);
+    size_t tail = dequeue_pos.load(std::memory_order_relaxed);
+    size_t head = enqueue_pos.load(std::memory_order_relaxed);
 
-    return queue.size() > threshold;
+    return (head - tail) > threshold;
+  }
+
+private:
+  /// Returns true if the next element to be popped has been published.
+  bool has_pending_entry() const
+  {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    return buffer[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
   }
 };
 
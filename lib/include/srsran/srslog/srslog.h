@@ -195,6 +195,15 @@ sink& fetch_file_sink(const std::string&             path,
                       bool                           force_flush = false,
                       std::unique_ptr<log_formatter> f           = get_default_log_formatter());
 
+/// Returns an instance of a sink that writes log entries in a compact binary
+/// format into a file in the specified path. No string formatting takes place
+/// when writing, use the srslog_decode tool to convert the files into text or
+/// JSON. Specifying a max_size value different to zero will make the sink
+/// create a new file each time the current file exceeds this value. The units
+/// of max_size are bytes.
+/// Setting force_flush to true will flush the sink after every write.
+sink& fetch_binary_file_sink(const std::string& path, size_t max_size = 0, bool force_flush = false);
+
 /// Returns an instance of a sink that writes into syslog
 /// preamble: The string  prepended to every message, If ident is "", the program name is used.
 /// log_local: custom unused facilities that syslog provides which can be used by the user
@@ -182,7 +182,7 @@ protected:
   void            discard_data_header(const unique_byte_buffer_t& pdu);
   void            write_data_header(const srsran::unique_byte_buffer_t& sdu, uint32_t count);
   void            extract_mac(const unique_byte_buffer_t& pdu, uint8_t* mac);
-  void            append_mac(const unique_byte_buffer_t& sdu, uint8_t* mac);
+  bool            append_mac(const unique_byte_buffer_t& sdu, uint8_t* mac);
 
   // Metrics helpers
   pdcp_bearer_metrics_t           metrics = {};
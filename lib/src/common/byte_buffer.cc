@@ -21,19 +21,321 @@
 
 #include "srsran/common/byte_buffer.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/srslog/srslog.h"
+#include <atomic>
+#include <cinttypes>
 
 namespace srsran {
 
+namespace {
+
+/// Number of preallocated byte_buffer_t objects, which also hold the small class storage
+const size_t NOF_BYTE_BUFFERS = 16384;
+/// Number of preallocated medium class storages
+const size_t NOF_MEDIUM_STORAGES = 8192;
+
+using byte_buffer_obj_pool = concurrent_fixed_memory_pool<sizeof(byte_buffer_t)>;
+using medium_storage_pool  = concurrent_fixed_memory_pool<byte_buffer_t::MEDIUM_STORAGE_SIZE>;
+
+static_assert(sizeof(byte_buffer_t) != byte_buffer_t::MEDIUM_STORAGE_SIZE and
+                  sizeof(byte_buffer_t) != byte_buffer_t::LARGE_STORAGE_SIZE,
+              "The byte_buffer_t objects and storages must come from different pools");
+
+const size_t NOF_CLASSES = static_cast<size_t>(byte_buffer_t::size_class::nof_classes);
+
+struct class_counters_t {
+  std::atomic<uint32_t> nof_in_use{0};
+  std::atomic<uint32_t> max_in_use{0};
+  std::atomic<uint64_t> nof_alloc_failures{0};
+  std::atomic<uint64_t> nof_promotions{0};
+};
+
+class_counters_t class_counters[NOF_CLASSES];
+
+class_counters_t& get_counters(byte_buffer_t::size_class cls)
+{
+  return class_counters[static_cast<size_t>(cls)];
+}
+
+void count_in_use(byte_buffer_t::size_class cls)
+{
+  class_counters_t& c    = get_counters(cls);
+  uint32_t          n    = c.nof_in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+  uint32_t          prev = c.max_in_use.load(std::memory_order_relaxed);
+  while (n > prev and not c.max_in_use.compare_exchange_weak(prev, n, std::memory_order_relaxed)) {
+  }
+}
+
+byte_buffer_obj_pool* get_obj_pool()
+{
+  return byte_buffer_obj_pool::get_instance(NOF_BYTE_BUFFERS);
+}
+
+medium_storage_pool* get_medium_pool()
+{
+  return medium_storage_pool::get_instance(NOF_MEDIUM_STORAGES);
+}
+
+} // namespace
+
+const uint32_t byte_buffer_t::SMALL_STORAGE_SIZE;
+const uint32_t byte_buffer_t::MEDIUM_STORAGE_SIZE;
+const uint32_t byte_buffer_t::LARGE_STORAGE_SIZE;
+const uint32_t byte_buffer_t::SMALL_HEADER_OFFSET;
+
+byte_buffer_t::size_class byte_buffer_t::fitting_class(uint32_t nof_bytes)
+{
+  if (nof_bytes + SMALL_HEADER_OFFSET <= SMALL_STORAGE_SIZE) {
+    return size_class::small;
+  }
+  if (nof_bytes + SMALL_HEADER_OFFSET <= MEDIUM_STORAGE_SIZE) {
+    return size_class::medium;
+  }
+  return size_class::large;
+}
+
+const char* byte_buffer_t::to_string(size_class cls)
+{
+  switch (cls) {
+    case size_class::small:
+      return "small";
+    case size_class::medium:
+      return "medium";
+    default:
+      return "large";
+  }
+}
+
+/// Allocates a storage of the given class. When the medium pool is depleted, a large storage is returned instead.
+/// The heap is only used when the large pool is also depleted and heap_fallback is set
+byte_buffer_t::storage_t byte_buffer_t::take_storage(size_class new_cls, bool heap_fallback)
+{
+  storage_t s;
+  s.cls = new_cls;
+  switch (new_cls) {
+    case size_class::small:
+      // embedded in the byte_buffer_t
+      count_in_use(new_cls);
+      return s;
+    case size_class::medium:
+      s.ptr = static_cast<uint8_t*>(get_medium_pool()->allocate_node(MEDIUM_STORAGE_SIZE));
+      break;
+    default:
+      s.ptr = static_cast<uint8_t*>(byte_buffer_pool::get_instance()->allocate_node(LARGE_STORAGE_SIZE));
+      break;
+  }
+  if (s.ptr != nullptr) {
+    count_in_use(new_cls);
+    return s;
+  }
+
+  get_counters(new_cls).nof_alloc_failures.fetch_add(1, std::memory_order_relaxed);
+  if (new_cls == size_class::medium) {
+    return take_storage(size_class::large, heap_fallback);
+  }
+  if (heap_fallback) {
+    s.ptr       = new (std::nothrow) uint8_t[LARGE_STORAGE_SIZE];
+    s.from_heap = true;
+  }
+  return s;
+}
+
+void byte_buffer_t::release_storage(const storage_t& s)
+{
+  if (s.from_heap) {
+    delete[] s.ptr;
+    return;
+  }
+  switch (s.cls) {
+    case size_class::small:
+      break;
+    case size_class::medium:
+      get_medium_pool()->deallocate_node(s.ptr);
+      break;
+    default:
+      byte_buffer_pool::get_instance()->deallocate_node(s.ptr);
+      break;
+  }
+  get_counters(s.cls).nof_in_use.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void byte_buffer_t::release_storage()
+{
+  storage_t s;
+  s.ptr       = cls == size_class::small ? nullptr : storage;
+  s.cls       = cls;
+  s.from_heap = from_heap;
+  release_storage(s);
+  storage = nullptr;
+}
+
+void byte_buffer_t::set_storage(const storage_t& s)
+{
+  storage   = s.cls == size_class::small ? small_storage : s.ptr;
+  cls       = s.cls;
+  from_heap = s.from_heap;
+}
+
+byte_buffer_t::storage_t byte_buffer_t::heap_storage()
+{
+  storage_t s;
+  s.ptr       = new uint8_t[LARGE_STORAGE_SIZE];
+  s.cls       = size_class::large;
+  s.from_heap = true;
+  return s;
+}
+
+byte_buffer_t::byte_buffer_t(const storage_t& s)
+{
+  set_storage(s);
+  msg = storage + default_headroom(cls);
+#ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
+  bzero(debug_name, SRSRAN_BUFFER_POOL_LOG_NAME_LEN);
+#endif
+}
+
+// Standalone buffers keep the full size they used to embed, as their users write into msg without resizing. The
+// storage comes from the large pool, and only from the heap when the pool is depleted
+byte_buffer_t::byte_buffer_t(uint32_t size) : byte_buffer_t(take_storage(size_class::large, true))
+{
+  N_bytes = size;
+}
+
+byte_buffer_t::byte_buffer_t(const byte_buffer_t& buf) : byte_buffer_t(take_storage(buf.cls, true))
+{
+  *this = buf;
+}
+
+byte_buffer_t::byte_buffer_t(byte_buffer_t&& buf) noexcept : byte_buffer_t(take_storage(size_class::small, false))
+{
+  *this = std::move(buf);
+}
+
+byte_buffer_t::~byte_buffer_t()
+{
+  release_storage();
+}
+
+byte_buffer_t& byte_buffer_t::operator=(const byte_buffer_t& buf)
+{
+  // avoid self assignment
+  if (&buf == this) {
+    return *this;
+  }
+  // keep the headroom of the source buffer, promoting the storage if the bytes do not fit
+  uint32_t headroom = buf.get_headroom();
+  if (headroom + buf.N_bytes > storage_size(cls)) {
+    headroom = std::min(headroom, default_headroom(cls));
+  }
+  N_bytes = 0;
+  msg     = storage + headroom;
+  if (not reserve_tailroom(buf.N_bytes)) {
+    // the pools are depleted, the bytes are not truncated but copied into a heap storage
+    move_bytes_to(heap_storage(), headroom);
+  }
+  N_bytes = buf.N_bytes;
+  md      = buf.md;
+  memcpy(msg, buf.msg, N_bytes);
+  return *this;
+}
+
+byte_buffer_t& byte_buffer_t::operator=(byte_buffer_t&& buf) noexcept
+{
+  if (&buf == this) {
+    return *this;
+  }
+  if (buf.cls == size_class::small) {
+    // the embedded storage can't be stolen
+    return *this = buf;
+  }
+  release_storage();
+  storage   = buf.storage;
+  cls       = buf.cls;
+  from_heap = buf.from_heap;
+  msg       = buf.msg;
+  N_bytes   = buf.N_bytes;
+  md        = buf.md;
+
+  // leave the moved-from buffer empty with a small storage
+  buf.set_storage(take_storage(size_class::small, false));
+  buf.clear();
+  return *this;
+}
+
+byte_buffer_t* byte_buffer_t::create(size_class new_cls) noexcept
+{
+  storage_t s = take_storage(new_cls, false);
+  if (s.cls != size_class::small and s.ptr == nullptr) {
+    return nullptr;
+  }
+  void* mem = get_obj_pool()->allocate_node(sizeof(byte_buffer_t));
+  if (mem == nullptr) {
+    get_counters(size_class::small).nof_alloc_failures.fetch_add(1, std::memory_order_relaxed);
+    release_storage(s);
+    return nullptr;
+  }
+  return ::new (mem) byte_buffer_t(s);
+}
+
+bool byte_buffer_t::reserve_tailroom(uint32_t nof_bytes)
+{
+  if (nof_bytes <= get_tailroom()) {
+    return true;
+  }
+  uint32_t headroom = get_headroom();
+  uint32_t needed   = headroom + N_bytes + nof_bytes;
+  if (needed > LARGE_STORAGE_SIZE) {
+    return false;
+  }
+  size_class new_cls = cls;
+  while (storage_size(new_cls) < needed) {
+    new_cls = static_cast<size_class>(static_cast<uint8_t>(new_cls) + 1);
+  }
+  storage_t s = take_storage(new_cls, true);
+  if (s.ptr == nullptr) {
+    return false;
+  }
+  get_counters(s.cls).nof_promotions.fetch_add(1, std::memory_order_relaxed);
+  move_bytes_to(s, headroom);
+  return true;
+}
+
+void byte_buffer_t::shrink_to_fit()
+{
+  size_class new_cls = fitting_class(N_bytes);
+  if (new_cls >= cls) {
+    return;
+  }
+  storage_t s = take_storage(new_cls, false);
+  if (s.cls >= cls or (s.cls != size_class::small and s.ptr == nullptr)) {
+    // the smaller pools are depleted
+    if (s.ptr != nullptr) {
+      release_storage(s);
+    }
+    return;
+  }
+  move_bytes_to(s, default_headroom(s.cls));
+}
+
+void byte_buffer_t::move_bytes_to(const storage_t& s, uint32_t headroom)
+{
+  uint8_t* new_storage = s.cls == size_class::small ? small_storage : s.ptr;
+  memcpy(new_storage + headroom, msg, N_bytes);
+  release_storage();
+  set_storage(s);
+  msg = storage + headroom;
+}
+
 void* byte_buffer_t::operator new(size_t sz, const std::nothrow_t& nothrow_value) noexcept
 {
   assert(sz == sizeof(byte_buffer_t));
-  return byte_buffer_pool::get_instance()->allocate_node(sz);
+  return get_obj_pool()->allocate_node(sz);
 }
 
 void* byte_buffer_t::operator new(size_t sz)
 {
   assert(sz == sizeof(byte_buffer_t));
-  void* ptr = byte_buffer_pool::get_instance()->allocate_node(sz);
+  void* ptr = get_obj_pool()->allocate_node(sz);
   if (ptr == nullptr) {
     throw std::bad_alloc();
   }
@@ -42,7 +344,42 @@ void* byte_buffer_t::operator new(size_t sz)
 
 void byte_buffer_t::operator delete(void* ptr)
 {
-  byte_buffer_pool::get_instance()->deallocate_node(ptr);
+  get_obj_pool()->deallocate_node(ptr);
+}
+
+byte_buffer_metrics_t get_byte_buffer_metrics()
+{
+  byte_buffer_metrics_t metrics;
+  for (size_t i = 0; i < NOF_CLASSES; ++i) {
+    byte_buffer_class_metrics_t& m = metrics[i];
+    m.storage_size                 = byte_buffer_t::storage_size(static_cast<byte_buffer_t::size_class>(i));
+    m.nof_in_use                   = class_counters[i].nof_in_use.load(std::memory_order_relaxed);
+    m.max_in_use                   = class_counters[i].max_in_use.load(std::memory_order_relaxed);
+    m.nof_alloc_failures           = class_counters[i].nof_alloc_failures.load(std::memory_order_relaxed);
+    m.nof_promotions               = class_counters[i].nof_promotions.load(std::memory_order_relaxed);
+  }
+  metrics[static_cast<size_t>(byte_buffer_t::size_class::small)].nof_blocks  = get_obj_pool()->size();
+  metrics[static_cast<size_t>(byte_buffer_t::size_class::medium)].nof_blocks = get_medium_pool()->size();
+  metrics[static_cast<size_t>(byte_buffer_t::size_class::large)].nof_blocks  = byte_buffer_pool::get_instance()->size();
+  return metrics;
+}
+
+void log_byte_buffer_metrics()
+{
+  srslog::basic_logger& logger  = srslog::fetch_basic_logger("POOL");
+  byte_buffer_metrics_t metrics = get_byte_buffer_metrics();
+  for (size_t i = 0; i < NOF_CLASSES; ++i) {
+    const byte_buffer_class_metrics_t& m = metrics[i];
+    logger.info("%s byte buffers (%d B): %d/%d in use, %d max in use, %" PRIu64 " alloc failures, %" PRIu64
+                " promotions",
+                byte_buffer_t::to_string(static_cast<byte_buffer_t::size_class>(i)),
+                m.storage_size,
+                m.nof_in_use,
+                m.nof_blocks,
+                m.max_in_use,
+                m.nof_alloc_failures,
+                m.nof_promotions);
+  }
 }
 
 } // namespace srsran
@@ -0,0 +1,221 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/milenage_batch.h"
+#include <cstring>
+
+#ifdef __AES__
+#include <immintrin.h>
+#endif // __AES__
+
+namespace srsran {
+
+#ifdef __AES__
+
+/*********************************************************************
+ * AES-128 with AES-NI. Each block may use its own key schedule, so
+ * that the blocks of different subscribers share the pipelines.
+ *********************************************************************/
+
+static inline __m128i aes128_expand_step(__m128i key, __m128i keygen)
+{
+  keygen = _mm_shuffle_epi32(keygen, _MM_SHUFFLE(3, 3, 3, 3));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, keygen);
+}
+
+// The round constant of aeskeygenassist must be an immediate
+#define AES128_EXPAND(rk, i, rcon) rk[i] = aes128_expand_step(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+void milenage_key::set(const uint8_t* k)
+{
+  __m128i rk[11];
+  rk[0] = _mm_loadu_si128((const __m128i*)k);
+  AES128_EXPAND(rk, 1, 0x01);
+  AES128_EXPAND(rk, 2, 0x02);
+  AES128_EXPAND(rk, 3, 0x04);
+  AES128_EXPAND(rk, 4, 0x08);
+  AES128_EXPAND(rk, 5, 0x10);
+  AES128_EXPAND(rk, 6, 0x20);
+  AES128_EXPAND(rk, 7, 0x40);
+  AES128_EXPAND(rk, 8, 0x80);
+  AES128_EXPAND(rk, 9, 0x1b);
+  AES128_EXPAND(rk, 10, 0x36);
+  for (uint32_t i = 0; i < 11; i++) {
+    _mm_store_si128((__m128i*)round_keys[i], rk[i]);
+  }
+}
+
+#undef AES128_EXPAND
+
+/// Encrypts N blocks, round by round, so that the N aesenc of a round are independent
+template <size_t N>
+static inline void aes128_encrypt_blocks(const uint8_t (*const rk[N])[16], __m128i* b)
+{
+  for (size_t i = 0; i < N; i++) {
+    b[i] = _mm_xor_si128(b[i], _mm_load_si128((const __m128i*)rk[i][0]));
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    for (size_t i = 0; i < N; i++) {
+      b[i] = _mm_aesenc_si128(b[i], _mm_load_si128((const __m128i*)rk[i][r]));
+    }
+  }
+  for (size_t i = 0; i < N; i++) {
+    b[i] = _mm_aesenclast_si128(b[i], _mm_load_si128((const __m128i*)rk[i][10]));
+  }
+}
+
+/// Milenage of N vectors. TEMP takes N blocks at once, then f1 to f5 take the other 4 * N blocks at once
+template <size_t N>
+static void milenage_f12345_lanes(const uint8_t (*const rk[N])[16], const milenage_input_t* in, milenage_output_t* out)
+{
+  // c2, c3 and c4 of TS 35.206, i.e. 1, 2 and 4 in the last bit positions. c1 is zero
+  const __m128i c2 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1);
+  const __m128i c3 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2);
+  const __m128i c4 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4);
+
+  __m128i opc[N], temp[N];
+  for (size_t i = 0; i < N; i++) {
+    opc[i]  = _mm_loadu_si128((const __m128i*)in[i].opc);
+    temp[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in[i].rand), opc[i]);
+  }
+  // TEMP = E_K(RAND ^ OPc)
+  aes128_encrypt_blocks<N>(rk, temp);
+
+  // f1, f2/f5, f3 and f4, rotated by r1 = 64, r2 = 0, r3 = 32 and r4 = 64 bits
+  const uint8_t(*rk4[4 * N])[16];
+  __m128i b[4 * N];
+  for (size_t i = 0; i < N; i++) {
+    uint8_t in1[16];
+    memcpy(&in1[0], in[i].sqn, 6);
+    memcpy(&in1[6], in[i].amf, 2);
+    memcpy(&in1[8], in[i].sqn, 6);
+    memcpy(&in1[14], in[i].amf, 2);
+    __m128i x1   = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in1), opc[i]);
+    __m128i x    = _mm_xor_si128(temp[i], opc[i]);
+    b[4 * i]     = _mm_xor_si128(_mm_shuffle_epi32(x1, _MM_SHUFFLE(1, 0, 3, 2)), temp[i]);
+    b[4 * i + 1] = _mm_xor_si128(x, c2);
+    b[4 * i + 2] = _mm_xor_si128(_mm_shuffle_epi32(x, _MM_SHUFFLE(0, 3, 2, 1)), c3);
+    b[4 * i + 3] = _mm_xor_si128(_mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)), c4);
+    rk4[4 * i] = rk4[4 * i + 1] = rk4[4 * i + 2] = rk4[4 * i + 3] = rk[i];
+  }
+  aes128_encrypt_blocks<4 * N>(rk4, b);
+
+  for (size_t i = 0; i < N; i++) {
+    uint8_t out1[16], out2[16];
+    _mm_storeu_si128((__m128i*)out1, _mm_xor_si128(b[4 * i], opc[i]));
+    _mm_storeu_si128((__m128i*)out2, _mm_xor_si128(b[4 * i + 1], opc[i]));
+    memcpy(out[i].mac_a, &out1[0], MAC_LEN);
+    memcpy(out[i].ak, &out2[0], AK_LEN);
+    memcpy(out[i].res, &out2[8], 8);
+    _mm_storeu_si128((__m128i*)out[i].ck, _mm_xor_si128(b[4 * i + 2], opc[i]));
+    _mm_storeu_si128((__m128i*)out[i].ik, _mm_xor_si128(b[4 * i + 3], opc[i]));
+  }
+}
+
+void milenage_f12345_batch(const milenage_input_t* in, milenage_output_t* out, size_t nof_vectors)
+{
+  size_t i = 0;
+  for (; i + milenage_batch_lanes <= nof_vectors; i += milenage_batch_lanes) {
+    const uint8_t(*rk[milenage_batch_lanes])[16];
+    for (size_t j = 0; j < milenage_batch_lanes; j++) {
+      rk[j] = in[i + j].key->round_keys;
+    }
+    milenage_f12345_lanes<milenage_batch_lanes>(rk, &in[i], &out[i]);
+  }
+  for (; i < nof_vectors; i++) {
+    const uint8_t(*rk[1])[16] = {in[i].key->round_keys};
+    milenage_f12345_lanes<1>(rk, &in[i], &out[i]);
+  }
+}
+
+#else // __AES__
+
+/*********************************************************************
+ * Without AES-NI, one block at a time through mbedtls
+ *********************************************************************/
+
+void milenage_key::set(const uint8_t* k)
+{
+  aes_setkey_enc(&ctx, k, 128);
+}
+
+static void milenage_encrypt(aes_context*   ctx,
+                             const uint8_t* temp,
+                             const uint8_t* opc,
+                             uint32_t       rot_bytes,
+                             uint8_t        c,
+                             uint8_t*       out)
+{
+  uint8_t input[16];
+  for (uint32_t i = 0; i < 16; i++) {
+    input[(i + 16 - rot_bytes) % 16] = temp[i] ^ opc[i];
+  }
+  input[15] ^= c;
+  aes_crypt_ecb(ctx, AES_ENCRYPT, input, out);
+  for (uint32_t i = 0; i < 16; i++) {
+    out[i] ^= opc[i];
+  }
+}
+
+void milenage_f12345_batch(const milenage_input_t* in, milenage_output_t* out, size_t nof_vectors)
+{
+  for (size_t n = 0; n < nof_vectors; n++) {
+    // mbedtls does not modify the context when encrypting
+    aes_context* ctx = const_cast<aes_context*>(&in[n].key->ctx);
+    uint8_t      input[16], temp[16], in1[16], out1[16];
+
+    for (uint32_t i = 0; i < 16; i++) {
+      input[i] = in[n].rand[i] ^ in[n].opc[i];
+    }
+    aes_crypt_ecb(ctx, AES_ENCRYPT, input, temp);
+
+    // f1
+    memcpy(&in1[0], in[n].sqn, 6);
+    memcpy(&in1[6], in[n].amf, 2);
+    memcpy(&in1[8], in[n].sqn, 6);
+    memcpy(&in1[14], in[n].amf, 2);
+    for (uint32_t i = 0; i < 16; i++) {
+      input[(i + 8) % 16] = in1[i] ^ in[n].opc[i];
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+      input[i] ^= temp[i];
+    }
+    aes_crypt_ecb(ctx, AES_ENCRYPT, input, out1);
+    for (uint32_t i = 0; i < MAC_LEN; i++) {
+      out[n].mac_a[i] = out1[i] ^ in[n].opc[i];
+    }
+
+    // f2 and f5
+    milenage_encrypt(ctx, temp, in[n].opc, 0, 1, out1);
+    memcpy(out[n].ak, &out1[0], AK_LEN);
+    memcpy(out[n].res, &out1[8], 8);
+    // f3 and f4
+    milenage_encrypt(ctx, temp, in[n].opc, 4, 2, out[n].ck);
+    milenage_encrypt(ctx, temp, in[n].opc, 8, 4, out[n].ik);
+  }
+}
+
+#endif // __AES__
+
+} // namespace srsran
@@ -397,9 +397,17 @@ bool unique_socket::sctp_set_init_msg_opts(int max_init_attempts, int max_init_t
 
 socket_manager::socket_manager() : thread("RXsockets"), socket_manager_itf(srslog::fetch_basic_logger("COMN"))
 {
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  srsran_assert(epoll_fd != -1, "Failed to create epoll instance");
+
   // register control pipe fd
   int fd = pipe(pipefd);
   srsran_assert(fd != -1, "Failed to open control pipe");
+  epoll_event ev = {};
+  ev.events      = EPOLLIN;
+  ev.data.fd     = pipefd[0];
+  fd             = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipefd[0], &ev);
+  srsran_assert(fd != -1, "Failed to register control pipe in epoll");
   start(thread_prio);
 }
 
@@ -431,6 +439,10 @@ void socket_manager::stop()
     pipefd[1] = -1;
     rxSockDebug("closed.");
   }
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
 }
 
 bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
@@ -445,14 +457,15 @@ bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
     return false;
   }
 
-  active_sockets.insert(std::make_pair(fd, std::move(handler)));
+  auto ret = active_sockets.insert(std::make_pair(fd, std::move(handler)));
 
-  // this unlocks the reading thread to add new connections
-  ctrl_cmd_t msg;
-  msg.cmd    = ctrl_cmd_t::cmd_id_t::NEW_FD;
-  msg.new_fd = fd;
-  if (write(pipefd[1], &msg, sizeof(msg)) != sizeof(msg)) {
-    rxSockError("while writing to control pipe");
+  // epoll_ctl is thread-safe, so the new fd is seen by the reading thread on its next epoll_wait
+  epoll_event ev = {};
+  ev.events      = EPOLLIN;
+  ev.data.fd     = fd;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+    rxSockError("Failed to register fd=%d in epoll: %s", fd, strerror(errno));
+    active_sockets.erase(ret.first);
     return false;
   }
 
@@ -495,97 +508,93 @@ bool socket_manager::remove_socket(int fd)
   return result;
 }
 
-std::map<int, socket_manager::recv_callback_t>::iterator
-socket_manager::remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd)
+void socket_manager::remove_socket_unprotected(int fd)
 {
   if (fd < 0) {
     rxSockError("fd to be removed is not valid");
-    return active_sockets.end();
+    return;
+  }
+  if (active_sockets.erase(fd) == 0) {
+    return;
+  }
+  // The fd may have already been closed by the owner, in which case the kernel dropped it from the epoll set
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr) == -1 and errno != EBADF and errno != ENOENT) {
+    rxSockWarn("Failed to remove fd=%d from epoll: %s", fd, strerror(errno));
   }
-  auto it = active_sockets.find(fd);
-  it      = active_sockets.erase(it);
-  FD_CLR(fd, total_fd_set);
-  // assumes ordering
-  *max_fd = (active_sockets.empty()) ? pipefd[0] : std::max(pipefd[0], active_sockets.rbegin()->first);
   rxSockDebug("Socket fd=%d has been successfully removed", fd);
-  return it;
+}
+
+/// Handles one message from the control pipe. Returns false if the thread should exit
+bool socket_manager::handle_ctrl_cmd()
+{
+  ctrl_cmd_t msg;
+  ssize_t    nrd = read(pipefd[0], &msg, sizeof(msg));
+  if (nrd <= 0) {
+    rxSockError("Unable to read control message.");
+    return true;
+  }
+  switch (msg.cmd) {
+    case ctrl_cmd_t::cmd_id_t::EXIT:
+      return false;
+    case ctrl_cmd_t::cmd_id_t::RM_FD:
+      remove_socket_unprotected(msg.new_fd);
+      if (msg.signal_rm_complete) {
+        rem_fd_tmp_list.push_back(msg.new_fd);
+        rem_cvar.notify_one();
+      }
+      break;
+    default:
+      rxSockError("ctrl message command %d is not valid", (int)msg.cmd);
+  }
+  return true;
 }
 
 void socket_manager::run_thread()
 {
   running = true;
-  fd_set total_fd_set, read_fd_set;
-  FD_ZERO(&total_fd_set);
-  int max_fd = 0;
-
-  FD_SET(pipefd[0], &total_fd_set);
-  max_fd = std::max(pipefd[0], max_fd);
 
   while (running.load(std::memory_order_relaxed)) {
-    memcpy(&read_fd_set, &total_fd_set, sizeof(total_fd_set));
-    int n = select(max_fd + 1, &read_fd_set, nullptr, nullptr, nullptr);
+    int n = epoll_wait(epoll_fd, events.data(), events.size(), -1);
 
-    // handle select return
+    // handle epoll_wait return
     if (n == -1) {
-      rxSockError("Error from select(%d,...). Number of rx sockets: %d", max_fd + 1, (int)active_sockets.size() + 1);
+      if (errno != EINTR) {
+        rxSockError("Error from epoll_wait: %s. Number of rx sockets: %d", strerror(errno), (int)active_sockets.size());
+      }
       continue;
     }
     if (n == 0) {
-      rxSockDebug("No data from select.");
+      rxSockDebug("No data from epoll_wait.");
       continue;
     }
 
     // Shared state area
     std::lock_guard<std::mutex> lock(socket_mutex);
 
-    // call read callback for all SCTP/TCP/UDP connections
-    for (auto handler_it = active_sockets.begin(); handler_it != active_sockets.end();) {
-      int              fd       = handler_it->first;
-      recv_callback_t& callback = handler_it->second;
-      if (not FD_ISSET(fd, &read_fd_set)) {
-        ++handler_it;
+    // call read callback only for the SCTP/TCP/UDP connections that have been signalled
+    bool ctrl_pending = false;
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == pipefd[0]) {
+        ctrl_pending = true;
+        continue;
+      }
+      auto handler_it = active_sockets.find(fd);
+      if (handler_it == active_sockets.end()) {
+        // fd removed by an earlier event in the same batch
         continue;
       }
-      bool socket_valid = callback(fd);
+      bool socket_valid = handler_it->second(fd);
       if (not socket_valid) {
         rxSockInfo("The socket fd=%d has been closed by peer", fd);
-        handler_it = remove_socket_unprotected(fd, &total_fd_set, &max_fd);
-      } else {
-        ++handler_it;
+        remove_socket_unprotected(fd);
       }
     }
 
     // handle ctrl messages
-    if (FD_ISSET(pipefd[0], &read_fd_set)) {
-      ctrl_cmd_t msg;
-      ssize_t    nrd = read(pipefd[0], &msg, sizeof(msg));
-      if (nrd <= 0) {
-        rxSockError("Unable to read control message.");
-        continue;
-      }
-      switch (msg.cmd) {
-        case ctrl_cmd_t::cmd_id_t::EXIT:
-          running = false;
-          return;
-        case ctrl_cmd_t::cmd_id_t::NEW_FD:
-          if (msg.new_fd >= 0) {
-            FD_SET(msg.new_fd, &total_fd_set);
-            max_fd = std::max(max_fd, msg.new_fd);
-          } else {
-            rxSockError("added fd is not valid");
-          }
-          break;
-        case ctrl_cmd_t::cmd_id_t::RM_FD:
-          remove_socket_unprotected(msg.new_fd, &total_fd_set, &max_fd);
-          if (msg.signal_rm_complete) {
-            rem_fd_tmp_list.push_back(msg.new_fd);
-            rem_cvar.notify_one();
-          }
-          rxSockDebug("Socket fd=%d has been successfully removed", msg.new_fd);
-          break;
-        default:
-          rxSockError("ctrl message command %d is not valid", (int)msg.cmd);
-      }
+    if (ctrl_pending and not handle_ctrl_cmd()) {
+      running = false;
+      return;
     }
   }
 }
@@ -648,29 +657,46 @@ make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& q
   return socket_manager_itf::recv_callback_t(sctp_recvmsg_pdu_task(logger, queue, std::move(rx_callback)));
 }
 
+/// Datagrams are read into medium byte buffers, which fit an MTU sized IP packet. The bytes of longer datagrams spill
+/// over into a scratch area of this size and are appended afterwards, promoting the buffer storage
+const uint32_t rx_spill_size = byte_buffer_t::LARGE_STORAGE_SIZE - SRSRAN_BUFFER_HEADER_OFFSET;
+
+/// Sets the length of a received datagram, appending the bytes that did not fit in the buffer tailroom
+static bool set_rx_datagram_len(byte_buffer_t& pdu, uint32_t nof_bytes, const uint8_t* spill)
+{
+  uint32_t in_place = std::min(nof_bytes, pdu.get_tailroom());
+  pdu.N_bytes       = in_place;
+  return pdu.append_bytes(spill, nof_bytes - in_place);
+}
+
 /**
  * Description: Functor for the case the received data is
- * in the form of unique_byte_buffer, and a recvfrom(...) call is used
+ * in the form of unique_byte_buffer, and a recvmsg(...) call is used
  */
 class recvfrom_pdu_task
 {
 public:
   using callback_t = recvfrom_callback_t;
   explicit recvfrom_pdu_task(srslog::basic_logger& logger, srsran::task_queue_handle& queue_, callback_t func_) :
-    logger(logger), queue(queue_), func(std::move(func_))
+    logger(logger), queue(queue_), func(std::move(func_)), spill(rx_spill_size)
   {}
 
   bool operator()(int fd)
   {
-    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+    srsran::unique_byte_buffer_t pdu = srsran::make_sdu_byte_buffer();
     if (pdu == nullptr) {
       logger.error("Unable to allocate byte buffer");
       return true;
     }
-    sockaddr_in from    = {};
-    socklen_t   fromlen = sizeof(from);
-
-    ssize_t n_recv = recvfrom(fd, pdu->msg, pdu->get_tailroom(), 0, (struct sockaddr*)&from, &fromlen);
+    sockaddr_in from   = {};
+    iovec       iov[2] = {{pdu->msg, pdu->get_tailroom()}, {spill.data(), spill.size()}};
+    msghdr      msg    = {};
+    msg.msg_name       = &from;
+    msg.msg_namelen    = sizeof(from);
+    msg.msg_iov        = iov;
+    msg.msg_iovlen     = 2;
+
+    ssize_t n_recv = recvmsg(fd, &msg, 0);
     if (n_recv == -1 and errno != EAGAIN) {
       logger.error("Error reading from socket: %s", strerror(errno));
       return true;
@@ -680,7 +706,10 @@ public:
       return true;
     }
 
-    pdu->N_bytes = static_cast<uint32_t>(n_recv);
+    if (not set_rx_datagram_len(*pdu, static_cast<uint32_t>(n_recv), spill.data())) {
+      logger.error("Unable to allocate byte buffer for a datagram of %zd bytes", n_recv);
+      return true;
+    }
 
     // Defer handling of received packet to provided queue
     queue.push(
@@ -693,6 +722,7 @@ private:
   srslog::basic_logger&      logger;
   srsran::task_queue_handle& queue;
   callback_t                 func;
+  std::vector<uint8_t>       spill;
 };
 
 socket_manager_itf::recv_callback_t
@@ -701,4 +731,97 @@ make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue,
   return socket_manager_itf::recv_callback_t(recvfrom_pdu_task(logger, queue, std::move(rx_callback)));
 }
 
+/**
+ * Description: Functor for the case the received data is a batch of datagrams, read via a single recvmmsg(...) call.
+ * Byte buffers are kept allocated between calls, so only the ones handed over to the queue need to be replaced
+ */
+class recvmmsg_pdu_task
+{
+public:
+  using callback_t = recvfrom_batch_callback_t;
+  explicit recvmmsg_pdu_task(srslog::basic_logger&      logger,
+                             srsran::task_queue_handle& queue_,
+                             callback_t                 func_,
+                             uint32_t                   max_batch_size) :
+    logger(logger),
+    queue(queue_),
+    func(std::move(func_)),
+    pdus(std::max(max_batch_size, 1U)),
+    addrs(pdus.size()),
+    iovs(2 * pdus.size()),
+    msgs(pdus.size()),
+    spill(pdus.size() * rx_spill_size)
+  {}
+
+  bool operator()(int fd)
+  {
+    uint32_t nof_bufs = 0;
+    for (; nof_bufs < pdus.size(); ++nof_bufs) {
+      if (pdus[nof_bufs] == nullptr) {
+        pdus[nof_bufs] = srsran::make_sdu_byte_buffer();
+        if (pdus[nof_bufs] == nullptr) {
+          break;
+        }
+      }
+      iovs[2 * nof_bufs].iov_base        = pdus[nof_bufs]->msg;
+      iovs[2 * nof_bufs].iov_len         = pdus[nof_bufs]->get_tailroom();
+      iovs[2 * nof_bufs + 1].iov_base    = &spill[nof_bufs * rx_spill_size];
+      iovs[2 * nof_bufs + 1].iov_len     = rx_spill_size;
+      msgs[nof_bufs]                     = {};
+      msgs[nof_bufs].msg_hdr.msg_name    = &addrs[nof_bufs];
+      msgs[nof_bufs].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      msgs[nof_bufs].msg_hdr.msg_iov     = &iovs[2 * nof_bufs];
+      msgs[nof_bufs].msg_hdr.msg_iovlen  = 2;
+    }
+    if (nof_bufs == 0) {
+      logger.error("Unable to allocate byte buffer");
+      return true;
+    }
+
+    int n_recv = recvmmsg(fd, msgs.data(), nof_bufs, MSG_DONTWAIT, nullptr);
+    if (n_recv == -1 and errno != EAGAIN) {
+      logger.error("Error reading from socket: %s", strerror(errno));
+      return true;
+    }
+    if (n_recv == -1 and errno == EAGAIN) {
+      logger.debug("Socket timeout reached");
+      return true;
+    }
+
+    rx_sdu_batch_t batch;
+    batch.reserve(n_recv);
+    for (int i = 0; i < n_recv; ++i) {
+      if (not set_rx_datagram_len(*pdus[i], msgs[i].msg_len, &spill[i * rx_spill_size])) {
+        logger.error("Unable to allocate byte buffer for a datagram of %u bytes", msgs[i].msg_len);
+        pdus[i]->clear();
+        continue;
+      }
+      batch.emplace_back(std::move(pdus[i]), addrs[i]);
+    }
+
+    // Defer handling of received batch to provided queue
+    queue.push([this, batch = std::move(batch)]() mutable { func(batch); });
+
+    return true;
+  }
+
+private:
+  srslog::basic_logger&                     logger;
+  srsran::task_queue_handle&                queue;
+  callback_t                                func;
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+  std::vector<sockaddr_in>                  addrs;
+  std::vector<iovec>                        iovs;
+  std::vector<mmsghdr>                      msgs;
+  std::vector<uint8_t>                      spill;
+};
+
+socket_manager_itf::recv_callback_t make_batch_sdu_handler(srslog::basic_logger&      logger,
+                                                           srsran::task_queue_handle& queue,
+                                                           recvfrom_batch_callback_t  rx_callback,
+                                                           uint32_t                   max_batch_size)
+{
+  return socket_manager_itf::recv_callback_t(recvmmsg_pdu_task(logger, queue, std::move(rx_callback), max_batch_size));
+}
+
 } // namespace srsran
@@ -318,16 +318,13 @@ void pdcp_entity_base::extract_mac(const unique_byte_buffer_t& pdu, uint8_t* mac
   pdu->N_bytes -= 4;
 }
 
-void pdcp_entity_base::append_mac(const unique_byte_buffer_t& sdu, uint8_t* mac)
+bool pdcp_entity_base::append_mac(const unique_byte_buffer_t& sdu, uint8_t* mac)
 {
-  // Check enough space for MAC
-  if (sdu->N_bytes + 4 > sdu->get_tailroom()) {
+  // Append MAC, promoting the SDU buffer if needed
+  if (not sdu->append_bytes(mac, 4)) {
     logger.error("Not enough space to add MAC-I");
-    return;
+    return false;
   }
-
-  // Append MAC
-  memcpy(&sdu->msg[sdu->N_bytes], mac, 4);
-  sdu->N_bytes += 4;
+  return true;
 }
 } // namespace srsran
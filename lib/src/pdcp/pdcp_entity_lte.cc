@@ -198,8 +198,9 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
     integrity_generate(sdu->msg, sdu->N_bytes, tx_count, mac);
   }
 
-  if (is_srb()) {
-    append_mac(sdu, mac);
+  if (is_srb() and not append_mac(sdu, mac)) {
+    logger.warning("Dropping %s SDU, SN=%d", rb_name.c_str(), used_sn);
+    return;
   }
 
   if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
@@ -902,8 +903,8 @@ bool undelivered_sdus_queue::add_sdu(uint32_t                              sn,
     }
   }
 
-  // Allocate buffer and exit on error
-  srsran::unique_byte_buffer_t tmp = make_byte_buffer();
+  // Allocate buffer and exit on error. The copy is kept until the SDU is delivered, so it takes just the space it needs
+  srsran::unique_byte_buffer_t tmp = make_sized_byte_buffer(sdu->N_bytes);
   if (tmp == nullptr) {
     return false;
   }
@@ -1003,7 +1004,7 @@ std::map<uint32_t, srsran::unique_byte_buffer_t> undelivered_sdus_queue::get_buf
   for (auto& sdu : sdus) {
     if (sdu.sdu != nullptr) {
       // TODO: Find ways to avoid deep copy
-      srsran::unique_byte_buffer_t fwd_sdu = make_byte_buffer();
+      srsran::unique_byte_buffer_t fwd_sdu = make_sized_byte_buffer(sdu.sdu->N_bytes);
       if (fwd_sdu != nullptr) {
         *fwd_sdu = *sdu.sdu;
         fwd_sdus.emplace(sdu.sdu->md.pdcp_sn, std::move(fwd_sdu));
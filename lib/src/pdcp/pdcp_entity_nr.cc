@@ -149,7 +149,11 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
   }
   // Append MAC-I
   if (is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX))) {
-    append_mac(sdu, mac);
+    if (not append_mac(sdu, mac)) {
+      logger.warning("Dropping %s SDU, COUNT=%d", rb_name.c_str(), tx_next);
+      discard_timers_map.erase(tx_next);
+      return;
+    }
   }
 
   // TS 38.323, section 5.8: Ciphering
@@ -35,8 +35,16 @@
 
 #define FFTW_WISDOM_FILE "%s/.srsran_fftwisdom"
 
+// Environment variable that overrides the wisdom file location, so a single pre-generated file can be shared
+#define FFTW_WISDOM_ENV "SRSRAN_FFTW_WISDOM"
+
 static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 {
+  const char* env_path = getenv(FFTW_WISDOM_ENV);
+  if (env_path != NULL && env_path[0] != '\0') {
+    return snprintf(full_path, n, "%s", env_path);
+  }
+
   const char* homedir = NULL;
   if ((homedir = getenv("HOME")) == NULL) {
     homedir = getpwuid(getuid())->pw_dir;
@@ -53,6 +61,121 @@ static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 
 static pthread_mutex_t fft_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Process-wide plan cache. FFTW plans are only created once for each transform shape and shared by every
+ * srsran_dft_plan_t that needs it. Plans are always executed through the new-array interface, which is thread-safe and
+ * only requires the arrays to have the same alignment, strides and in-place-ness as the ones used for planning; all of
+ * them are part of the key. The alignment is the one FFTW checks, as reported by fftwf_alignment_of(), so arrays that
+ * FFTW treats the same share a plan. Cached plans live until the process exits.
+ */
+
+typedef struct {
+  int               size;
+  srsran_dft_dir_t  dir;
+  srsran_dft_mode_t mode;
+  bool              is_guru;
+  int               istride;
+  int               ostride;
+  int               how_many;
+  int               idist;
+  int               odist;
+  uint32_t          in_align;
+  uint32_t          out_align;
+  bool              in_place;
+  void*             p;
+} dft_cache_entry_t;
+
+static dft_cache_entry_t* plan_cache       = NULL;
+static uint32_t           plan_cache_len   = 0;
+static uint32_t           plan_cache_cap   = 0;
+static bool               plan_cache_dirty = false; // New plans were created since the wisdom was imported
+
+static bool dft_cache_key_equal(const dft_cache_entry_t* a, const dft_cache_entry_t* b)
+{
+  return a->size == b->size && a->dir == b->dir && a->mode == b->mode && a->is_guru == b->is_guru &&
+         a->istride == b->istride && a->ostride == b->ostride && a->how_many == b->how_many && a->idist == b->idist &&
+         a->odist == b->odist && a->in_align == b->in_align && a->out_align == b->out_align &&
+         a->in_place == b->in_place;
+}
+
+static void dft_cache_key_init(dft_cache_entry_t* key,
+                               int                size,
+                               srsran_dft_dir_t   dir,
+                               srsran_dft_mode_t  mode,
+                               const void*        in,
+                               const void*        out)
+{
+  bzero(key, sizeof(dft_cache_entry_t));
+  key->size      = size;
+  key->dir       = dir;
+  key->mode      = mode;
+  key->istride   = 1;
+  key->ostride   = 1;
+  key->how_many  = 1;
+  key->in_align  = (uint32_t)fftwf_alignment_of((float*)in);
+  key->out_align = (uint32_t)fftwf_alignment_of((float*)out);
+  key->in_place  = (in == out);
+}
+
+// Creates the FFTW plan described by the key, planning over the given arrays. The FFT mutex must be held.
+static void* dft_cache_create_plan(const dft_cache_entry_t* key, void* in, void* out)
+{
+  if (key->mode == SRSRAN_REAL) {
+    int kind = (key->dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+    return fftwf_plan_r2r_1d(key->size, in, out, kind, FFTW_TYPE);
+  }
+
+  int sign = (key->dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  if (!key->is_guru) {
+    return fftwf_plan_dft_1d(key->size, in, out, sign, FFTW_TYPE);
+  }
+
+  const fftwf_iodim iodim        = {key->size, key->istride, key->ostride};
+  const fftwf_iodim howmany_dims = {key->how_many, key->idist, key->odist};
+  return fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in, out, sign, FFTW_TYPE);
+}
+
+// Returns the cached plan matching the key, creating it if it does not exist yet. The FFT mutex must be held.
+static void* dft_cache_get(const dft_cache_entry_t* key, void* in, void* out)
+{
+  for (uint32_t i = 0; i < plan_cache_len; i++) {
+    if (dft_cache_key_equal(&plan_cache[i], key)) {
+      return plan_cache[i].p;
+    }
+  }
+
+  if (plan_cache_len == plan_cache_cap) {
+    uint32_t           new_cap = (plan_cache_cap == 0) ? 64 : plan_cache_cap * 2;
+    dft_cache_entry_t* tmp     = realloc(plan_cache, sizeof(dft_cache_entry_t) * new_cap);
+    if (tmp == NULL) {
+      ERROR("Error allocating DFT plan cache");
+      return NULL;
+    }
+    plan_cache     = tmp;
+    plan_cache_cap = new_cap;
+  }
+
+  void* p = dft_cache_create_plan(key, in, out);
+  if (p == NULL) {
+    return NULL;
+  }
+
+  plan_cache[plan_cache_len]   = *key;
+  plan_cache[plan_cache_len].p = p;
+  plan_cache_len++;
+  plan_cache_dirty = true;
+
+  return p;
+}
+
+static void* dft_cache_get_locked(const dft_cache_entry_t* key, void* in, void* out)
+{
+  pthread_mutex_lock(&fft_mutex);
+  void* p = dft_cache_get(key, in, out);
+  pthread_mutex_unlock(&fft_mutex);
+  return p;
+}
+
 // This function is called in the beggining of any executable where it is linked
 __attribute__((constructor)) static void srsran_dft_load()
 {
@@ -81,29 +204,85 @@ __attribute__((constructor)) static void srsran_dft_load()
 #endif
 }
 
-// This function is called in the ending of any executable where it is linked
-__attribute__((destructor)) void srsran_dft_exit()
+int srsran_dft_export_wisdom(const char* filename)
 {
-#ifdef FFTW_WISDOM_FILE
   char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
+  if (filename == NULL) {
+    get_fftw_wisdom_file(full_path, sizeof(full_path));
+  } else {
+    snprintf(full_path, sizeof(full_path), "%s", filename);
+  }
+
   FILE* fd = fopen(full_path, "w");
   if (fd == NULL) {
-    return;
+    return SRSRAN_ERROR;
   }
   if (lockf(fileno(fd), F_LOCK, 0) == -1) {
     perror("lockf()");
     fclose(fd);
-    return;
+    return SRSRAN_ERROR;
   }
+  pthread_mutex_lock(&fft_mutex);
   fftwf_export_wisdom_to_file(fd);
+  plan_cache_dirty = false;
+  pthread_mutex_unlock(&fft_mutex);
   if (lockf(fileno(fd), F_ULOCK, 0) == -1) {
     perror("u-lockf()");
     fclose(fd);
-    return;
+    return SRSRAN_ERROR;
   }
   fclose(fd);
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_dft_prewarm(const uint32_t* sizes, uint32_t nof_sizes, srsran_dft_mode_t mode)
+{
+  if (sizes == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  for (uint32_t i = 0; i < nof_sizes; i++) {
+    // Plan over arrays with the same layout srsran_dft_plan_c/r allocate, so these plans get reused by them
+    srsran_dft_plan_t plan;
+    for (int d = 0; d < 2; d++) {
+      srsran_dft_dir_t dir = (d == 0) ? SRSRAN_DFT_FORWARD : SRSRAN_DFT_BACKWARD;
+      if (srsran_dft_plan(&plan, (int)sizes[i], dir, mode)) {
+        ERROR("Error pre-warming DFT plan of size %d", sizes[i]);
+        return SRSRAN_ERROR;
+      }
+      srsran_dft_plan_free(&plan);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+uint32_t srsran_dft_cache_nof_plans(void)
+{
+  pthread_mutex_lock(&fft_mutex);
+  uint32_t len = plan_cache_len;
+  pthread_mutex_unlock(&fft_mutex);
+  return len;
+}
+
+// This function is called in the ending of any executable where it is linked
+__attribute__((destructor)) void srsran_dft_exit()
+{
+#ifdef FFTW_WISDOM_FILE
+  // Only rewrite the wisdom file when this process planned something new
+  if (plan_cache_dirty) {
+    srsran_dft_export_wisdom(NULL);
+  }
 #endif
+  pthread_mutex_lock(&fft_mutex);
+  for (uint32_t i = 0; i < plan_cache_len; i++) {
+    fftwf_destroy_plan(plan_cache[i].p);
+  }
+  free(plan_cache);
+  plan_cache     = NULL;
+  plan_cache_len = 0;
+  plan_cache_cap = 0;
+  pthread_mutex_unlock(&fft_mutex);
   fftwf_cleanup();
 }
 
@@ -151,23 +330,22 @@ int srsran_dft_replan_guru_c(srsran_dft_plan_t* plan,
                              int                idist,
                              int                odist)
 {
-  int sign = (plan->forward) ? FFTW_FORWARD : FFTW_BACKWARD;
-
-  const fftwf_iodim iodim        = {new_dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
-
-  pthread_mutex_lock(&fft_mutex);
-
-  /* Destroy current plan */
-  fftwf_destroy_plan(plan->p);
-
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
-
-  pthread_mutex_unlock(&fft_mutex);
-
+  dft_cache_entry_t key;
+  dft_cache_key_init(&key, new_dft_points, plan->dir, SRSRAN_DFT_COMPLEX, in_buffer, out_buffer);
+  key.is_guru  = true;
+  key.istride  = istride;
+  key.ostride  = ostride;
+  key.how_many = how_many;
+  key.idist    = idist;
+  key.odist    = odist;
+
+  // The previous plan is owned by the cache
+  plan->p = dft_cache_get_locked(&key, in_buffer, out_buffer);
   if (!plan->p) {
     return -1;
   }
+  plan->in        = in_buffer;
+  plan->out       = out_buffer;
   plan->size      = new_dft_points;
   plan->init_size = plan->size;
 
@@ -176,21 +354,16 @@ int srsran_dft_replan_guru_c(srsran_dft_plan_t* plan,
 
 int srsran_dft_replan_c(srsran_dft_plan_t* plan, const int new_dft_points)
 {
-  int sign = (plan->dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-
   // No change in size, skip re-planning
   if (plan->size == new_dft_points) {
     return 0;
   }
 
-  pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
-  }
-  plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
+  dft_cache_entry_t key;
+  dft_cache_key_init(&key, new_dft_points, plan->dir, SRSRAN_DFT_COMPLEX, plan->in, plan->out);
 
+  // The previous plan is owned by the cache
+  plan->p = dft_cache_get_locked(&key, plan->in, plan->out);
   if (!plan->p) {
     return -1;
   }
@@ -209,20 +382,22 @@ int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
                            int                idist,
                            int                odist)
 {
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-
-  const fftwf_iodim iodim        = {dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
-
-  pthread_mutex_lock(&fft_mutex);
-
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
-
+  dft_cache_entry_t key;
+  dft_cache_key_init(&key, dft_points, dir, SRSRAN_DFT_COMPLEX, in_buffer, out_buffer);
+  key.is_guru  = true;
+  key.istride  = istride;
+  key.ostride  = ostride;
+  key.how_many = how_many;
+  key.idist    = idist;
+  key.odist    = odist;
+
+  plan->p = dft_cache_get_locked(&key, in_buffer, out_buffer);
   if (!plan->p) {
     return -1;
   }
 
+  plan->in        = in_buffer;
+  plan->out       = out_buffer;
   plan->size      = dft_points;
   plan->init_size = plan->size;
   plan->mode      = SRSRAN_DFT_COMPLEX;
@@ -241,13 +416,10 @@ int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_
 {
   allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
 
-  pthread_mutex_lock(&fft_mutex);
-
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-  plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-
-  pthread_mutex_unlock(&fft_mutex);
+  dft_cache_entry_t key;
+  dft_cache_key_init(&key, dft_points, dir, SRSRAN_DFT_COMPLEX, plan->in, plan->out);
 
+  plan->p = dft_cache_get_locked(&key, plan->in, plan->out);
   if (!plan->p) {
     return -1;
   }
@@ -267,16 +439,11 @@ int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_
 
 int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
 {
-  int sign = (plan->dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
-
-  pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
-  }
-  plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
+  dft_cache_entry_t key;
+  dft_cache_key_init(&key, new_dft_points, plan->dir, SRSRAN_REAL, plan->in, plan->out);
 
+  // The previous plan is owned by the cache
+  plan->p = dft_cache_get_locked(&key, plan->in, plan->out);
   if (!plan->p) {
     return -1;
   }
@@ -287,12 +454,11 @@ int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
 int srsran_dft_plan_r(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir)
 {
   allocate(plan, sizeof(float), sizeof(float), dft_points);
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
-  pthread_mutex_lock(&fft_mutex);
-  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
+  dft_cache_entry_t key;
+  dft_cache_key_init(&key, dft_points, dir, SRSRAN_REAL, plan->in, plan->out);
 
+  plan->p = dft_cache_get_locked(&key, plan->in, plan->out);
   if (!plan->p) {
     return -1;
   }
@@ -372,7 +538,7 @@ void srsran_dft_run_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out)
   fftwf_complex* f_out = plan->out;
 
   copy_pre((uint8_t*)plan->in, (uint8_t*)in, sizeof(cf_t), plan->size, plan->forward, plan->mirror, plan->dc);
-  fftwf_execute(plan->p);
+  fftwf_execute_dft(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / sqrtf(plan->size);
     srsran_vec_sc_prod_cfc(f_out, norm, f_out, plan->size);
@@ -388,7 +554,7 @@ void srsran_dft_run_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out)
 void srsran_dft_run_guru_c(srsran_dft_plan_t* plan)
 {
   if (plan->is_guru == true) {
-    fftwf_execute(plan->p);
+    fftwf_execute_dft(plan->p, plan->in, plan->out);
   } else {
     ERROR("srsran_dft_run_guru_c: the selected plan is not guru!");
   }
@@ -402,7 +568,7 @@ void srsran_dft_run_r(srsran_dft_plan_t* plan, const float* in, float* out)
   float* f_out = plan->out;
 
   memcpy(plan->in, in, sizeof(float) * plan->size);
-  fftwf_execute(plan->p);
+  fftwf_execute_r2r(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / plan->size;
     srsran_vec_sc_prod_fff(f_out, norm, f_out, plan->size);
@@ -422,15 +588,12 @@ void srsran_dft_plan_free(srsran_dft_plan_t* plan)
   if (!plan->size)
     return;
 
-  pthread_mutex_lock(&fft_mutex);
+  // Guru buffers belong to the caller and the plan itself is owned by the cache
   if (!plan->is_guru) {
     if (plan->in)
       fftwf_free(plan->in);
     if (plan->out)
       fftwf_free(plan->out);
   }
-  if (plan->p)
-    fftwf_destroy_plan(plan->p);
-  pthread_mutex_unlock(&fft_mutex);
   bzero(plan, sizeof(srsran_dft_plan_t));
 }
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/srsran.h"
+
+#define TEST_DFT_SIZE 384
+
+// Reference DFT computed without FFTW
+static void naive_dft(const cf_t* in, cf_t* out, uint32_t N, srsran_dft_dir_t dir)
+{
+  float sign = (dir == SRSRAN_DFT_FORWARD) ? -1.0f : 1.0f;
+  for (uint32_t k = 0; k < N; k++) {
+    cf_t acc = 0;
+    for (uint32_t n = 0; n < N; n++) {
+      acc += in[n] * cexpf(sign * I * 2.0f * (float)M_PI * (float)(k * n % N) / (float)N);
+    }
+    out[k] = acc;
+  }
+}
+
+static int test_plan_is_shared(void)
+{
+  srsran_dft_plan_t plan_a = {};
+  srsran_dft_plan_t plan_b = {};
+
+  TESTASSERT(srsran_dft_plan_c(&plan_a, TEST_DFT_SIZE, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  uint32_t nof_plans = srsran_dft_cache_nof_plans();
+
+  // Same transform, the plan must come from the cache
+  TESTASSERT(srsran_dft_plan_c(&plan_b, TEST_DFT_SIZE, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_dft_cache_nof_plans() == nof_plans);
+  TESTASSERT(plan_a.p == plan_b.p);
+
+  // Freeing one of them must not affect the other
+  srsran_dft_plan_free(&plan_a);
+  TESTASSERT(plan_b.p != NULL);
+
+  // Replanning to a size that was already planned does not create a new plan
+  TESTASSERT(srsran_dft_plan_c(&plan_a, TEST_DFT_SIZE / 2, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  nof_plans = srsran_dft_cache_nof_plans();
+  TESTASSERT(srsran_dft_replan_c(&plan_b, TEST_DFT_SIZE / 2) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_dft_cache_nof_plans() == nof_plans);
+  TESTASSERT(plan_a.p == plan_b.p);
+
+  srsran_dft_plan_free(&plan_a);
+  srsran_dft_plan_free(&plan_b);
+  return SRSRAN_SUCCESS;
+}
+
+static int test_prewarm(void)
+{
+  const uint32_t sizes[] = {128, 256, 768};
+
+  TESTASSERT(srsran_dft_prewarm(sizes, 3, SRSRAN_DFT_COMPLEX) == SRSRAN_SUCCESS);
+  uint32_t nof_plans = srsran_dft_cache_nof_plans();
+
+  srsran_dft_plan_t plan = {};
+  for (uint32_t i = 0; i < 3; i++) {
+    TESTASSERT(srsran_dft_plan_c(&plan, sizes[i], SRSRAN_DFT_BACKWARD) == SRSRAN_SUCCESS);
+    srsran_dft_plan_free(&plan);
+  }
+  TESTASSERT(srsran_dft_cache_nof_plans() == nof_plans);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_ofdm_plans_are_shared(void)
+{
+  const uint32_t nof_prb = 25;
+  cf_t*          in[2];
+  cf_t*          out[2];
+  srsran_ofdm_t  ofdm[2] = {};
+  uint32_t       nof_plans[2];
+
+  for (uint32_t i = 0; i < 2; i++) {
+    in[i]  = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(nof_prb));
+    out[i] = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(nof_prb));
+    TESTASSERT(in[i] != NULL && out[i] != NULL);
+
+    // The second modulator uses other buffers, with the same alignment, so its guru plans come from the cache
+    srsran_ofdm_cfg_t cfg = {};
+    cfg.nof_prb           = nof_prb;
+    cfg.in_buffer         = in[i];
+    cfg.out_buffer        = out[i];
+    cfg.cp                = SRSRAN_CP_NORM;
+    TESTASSERT(srsran_ofdm_tx_init_cfg(&ofdm[i], &cfg) == SRSRAN_SUCCESS);
+    nof_plans[i] = srsran_dft_cache_nof_plans();
+  }
+  TESTASSERT(nof_plans[1] == nof_plans[0]);
+  TESTASSERT(ofdm[0].fft_plan_sf[0].p == ofdm[1].fft_plan_sf[0].p);
+  TESTASSERT(ofdm[0].fft_plan_sf[1].p == ofdm[1].fft_plan_sf[1].p);
+
+  for (uint32_t i = 0; i < 2; i++) {
+    srsran_ofdm_tx_free(&ofdm[i]);
+    free(in[i]);
+    free(out[i]);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static int test_shared_plan_output(srsran_random_t random_gen, srsran_dft_dir_t dir)
+{
+  srsran_dft_plan_t plan_a = {};
+  srsran_dft_plan_t plan_b = {};
+  cf_t*             in     = srsran_vec_cf_malloc(TEST_DFT_SIZE);
+  cf_t*             out_a  = srsran_vec_cf_malloc(TEST_DFT_SIZE);
+  cf_t*             out_b  = srsran_vec_cf_malloc(TEST_DFT_SIZE);
+  cf_t*             ref    = srsran_vec_cf_malloc(TEST_DFT_SIZE);
+  TESTASSERT(in != NULL && out_a != NULL && out_b != NULL && ref != NULL);
+
+  TESTASSERT(srsran_dft_plan_c(&plan_a, TEST_DFT_SIZE, dir) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_dft_plan_c(&plan_b, TEST_DFT_SIZE, dir) == SRSRAN_SUCCESS);
+
+  srsran_random_uniform_complex_dist_vector(random_gen, in, TEST_DFT_SIZE, -1.0f, 1.0f);
+  naive_dft(in, ref, TEST_DFT_SIZE, dir);
+
+  // Both plans share the FFTW plan but use their own buffers
+  srsran_dft_run_c(&plan_a, in, out_a);
+  srsran_dft_run_c(&plan_b, in, out_b);
+
+  for (uint32_t i = 0; i < TEST_DFT_SIZE; i++) {
+    TESTASSERT(cabsf(out_a[i] - ref[i]) < 1e-2f);
+    TESTASSERT(cabsf(out_b[i] - ref[i]) < 1e-2f);
+  }
+
+  srsran_dft_plan_free(&plan_a);
+  srsran_dft_plan_free(&plan_b);
+  free(in);
+  free(out_a);
+  free(out_b);
+  free(ref);
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srsran_random_t random_gen = srsran_random_init(0);
+
+  TESTASSERT(test_plan_is_shared() == SRSRAN_SUCCESS);
+  TESTASSERT(test_prewarm() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ofdm_plans_are_shared() == SRSRAN_SUCCESS);
+  TESTASSERT(test_shared_plan_output(random_gen, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  TESTASSERT(test_shared_plan_output(random_gen, SRSRAN_DFT_BACKWARD) == SRSRAN_SUCCESS);
+
+  srsran_random_free(random_gen);
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
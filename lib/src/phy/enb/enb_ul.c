@@ -281,3 +281,89 @@ int srsran_enb_ul_get_pusch(srsran_enb_ul_t*    q,
 
   return srsran_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, q->sf_symbols, res);
 }
+
+int srsran_enb_ul_pusch_init(srsran_enb_ul_pusch_t* q, uint32_t max_prb)
+{
+  int ret = SRSRAN_ERROR_INVALID_INPUTS;
+
+  if (q != NULL) {
+    ret = SRSRAN_ERROR;
+
+    bzero(q, sizeof(srsran_enb_ul_pusch_t));
+
+    q->chest_res.ce = srsran_vec_cf_malloc(SRSRAN_SF_LEN_RE(max_prb, SRSRAN_CP_NORM));
+    if (!q->chest_res.ce) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
+    if (srsran_pusch_init_enb(&q->pusch, max_prb)) {
+      ERROR("Error creating PUSCH object");
+      goto clean_exit;
+    }
+
+    if (srsran_chest_ul_init(&q->chest, max_prb)) {
+      ERROR("Error initiating channel estimator");
+      goto clean_exit;
+    }
+
+    ret = SRSRAN_SUCCESS;
+
+  } else {
+    ERROR("Invalid parameters");
+  }
+
+clean_exit:
+  if (ret == SRSRAN_ERROR) {
+    srsran_enb_ul_pusch_free(q);
+  }
+  return ret;
+}
+
+void srsran_enb_ul_pusch_free(srsran_enb_ul_pusch_t* q)
+{
+  if (q) {
+    srsran_pusch_free(&q->pusch);
+    srsran_chest_ul_free(&q->chest);
+
+    if (q->chest_res.ce) {
+      free(q->chest_res.ce);
+    }
+    bzero(q, sizeof(srsran_enb_ul_pusch_t));
+  }
+}
+
+int srsran_enb_ul_pusch_set_cell(srsran_enb_ul_pusch_t*             q,
+                                 srsran_cell_t                      cell,
+                                 srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg)
+{
+  if (q == NULL || !srsran_cell_isvalid(&cell)) {
+    ERROR("Invalid cell properties: Id=%d, Ports=%d, PRBs=%d", cell.id, cell.nof_ports, cell.nof_prb);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (srsran_pusch_set_cell(&q->pusch, cell)) {
+    ERROR("Error creating PUSCH object");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_chest_ul_set_cell(&q->chest, cell)) {
+    ERROR("Error initiating channel estimator");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_chest_ul_pregen(&q->chest, pusch_cfg, NULL);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_enb_ul_pusch_decode(srsran_enb_ul_pusch_t* q,
+                               const srsran_enb_ul_t* enb_ul,
+                               srsran_ul_sf_cfg_t*    ul_sf,
+                               srsran_pusch_cfg_t*    cfg,
+                               srsran_pusch_res_t*    res)
+{
+  srsran_chest_ul_estimate_pusch(&q->chest, ul_sf, cfg, enb_ul->sf_symbols, &q->chest_res);
+
+  return srsran_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, enb_ul->sf_symbols, res);
+}
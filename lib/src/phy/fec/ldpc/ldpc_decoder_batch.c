@@ -0,0 +1,316 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_decoder_batch.c
+ * \brief Definition of the LDPC batch decoder.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/fec/ldpc/base_graph.h"
+#include "srsran/phy/fec/ldpc/ldpc_decoder_batch.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+typedef struct {
+  pthread_t              pthread;
+  void*                  pool_ptr;
+  srsran_ldpc_decoder_t* decoder_bg1[MAX_LIFTSIZE + 1];
+  srsran_ldpc_decoder_t* decoder_bg2[MAX_LIFTSIZE + 1];
+  srsran_crc_t           crc;
+  sem_t                  start;
+  bool                   started;
+  bool                   quit;
+} ldpc_batch_worker_t;
+
+typedef struct {
+  uint32_t             nof_workers;
+  ldpc_batch_worker_t* workers;
+  sem_t                finish;
+  pthread_mutex_t      mutex;
+
+  /* Batch being decoded: it must be set before posting the start semaphores */
+  srsran_basegraph_t              bg;
+  uint16_t                        ls;
+  bool                            has_crc;
+  srsran_ldpc_decoder_batch_cb_t* cbs;
+  uint32_t                        nof_cbs;
+
+  /* Shared by the workers, protected by the mutex */
+  uint32_t next_cb;
+  int      ret;
+} ldpc_batch_pool_t;
+
+/* Takes code blocks of the batch until all of them are decoded */
+static void ldpc_batch_run(ldpc_batch_pool_t* pool, srsran_ldpc_decoder_t* decoder, srsran_crc_t* crc)
+{
+  while (true) {
+    pthread_mutex_lock(&pool->mutex);
+    uint32_t i = pool->next_cb++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (i >= pool->nof_cbs) {
+      break;
+    }
+
+    srsran_ldpc_decoder_batch_cb_t* cb = &pool->cbs[i];
+    cb->ret = srsran_ldpc_decoder_decode_crc_c(decoder, cb->llrs, cb->message, cb->cdwd_rm_length, crc);
+    if (cb->ret < SRSRAN_SUCCESS) {
+      pthread_mutex_lock(&pool->mutex);
+      pool->ret = SRSRAN_ERROR;
+      pthread_mutex_unlock(&pool->mutex);
+    }
+  }
+}
+
+static void* ldpc_batch_worker_thread(void* arg)
+{
+  ldpc_batch_worker_t* w    = (ldpc_batch_worker_t*)arg;
+  ldpc_batch_pool_t*   pool = (ldpc_batch_pool_t*)w->pool_ptr;
+
+  sem_wait(&w->start);
+  while (!w->quit) {
+    srsran_ldpc_decoder_t* decoder = (pool->bg == BG1) ? w->decoder_bg1[pool->ls] : w->decoder_bg2[pool->ls];
+    ldpc_batch_run(pool, decoder, pool->has_crc ? &w->crc : NULL);
+
+    /* Post finish semaphore */
+    sem_post(&pool->finish);
+
+    /* Wait for next batch */
+    sem_wait(&w->start);
+  }
+
+  return NULL;
+}
+
+static void ldpc_batch_worker_free(ldpc_batch_worker_t* w)
+{
+  for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
+    if (w->decoder_bg1[ls]) {
+      srsran_ldpc_decoder_free(w->decoder_bg1[ls]);
+      free(w->decoder_bg1[ls]);
+    }
+    if (w->decoder_bg2[ls]) {
+      srsran_ldpc_decoder_free(w->decoder_bg2[ls]);
+      free(w->decoder_bg2[ls]);
+    }
+  }
+}
+
+static int ldpc_batch_worker_init(ldpc_batch_worker_t* w, ldpc_batch_pool_t* pool, const srsran_ldpc_decoder_args_t* args)
+{
+  w->pool_ptr = pool;
+
+  // The decoders of all the lifting sizes are created upfront, so that no batch waits for an initialisation
+  for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
+    if (get_ls_index(ls) == VOID_LIFTSIZE) {
+      continue;
+    }
+
+    srsran_ldpc_decoder_args_t decoder_args = *args;
+    decoder_args.ls                         = ls;
+
+    w->decoder_bg1[ls] = calloc(1, sizeof(srsran_ldpc_decoder_t));
+    w->decoder_bg2[ls] = calloc(1, sizeof(srsran_ldpc_decoder_t));
+    if (!w->decoder_bg1[ls] || !w->decoder_bg2[ls]) {
+      ERROR("Error: calloc");
+      return SRSRAN_ERROR;
+    }
+
+    decoder_args.bg = BG1;
+    if (srsran_ldpc_decoder_init(w->decoder_bg1[ls], &decoder_args) < SRSRAN_SUCCESS) {
+      ERROR("Error: initialising BG1 LDPC decoder for ls=%d", ls);
+      return SRSRAN_ERROR;
+    }
+
+    decoder_args.bg = BG2;
+    if (srsran_ldpc_decoder_init(w->decoder_bg2[ls], &decoder_args) < SRSRAN_SUCCESS) {
+      ERROR("Error: initialising BG2 LDPC decoder for ls=%d", ls);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  if (sem_init(&w->start, 0, 0)) {
+    ERROR("Creating semaphore");
+    return SRSRAN_ERROR;
+  }
+  w->started = true;
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ldpc_decoder_batch_free(srsran_ldpc_decoder_batch_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  ldpc_batch_pool_t* pool = (ldpc_batch_pool_t*)q->ptr;
+  if (pool) {
+    if (pool->workers) {
+      for (uint32_t i = 0; i < pool->nof_workers; i++) {
+        ldpc_batch_worker_t* w = &pool->workers[i];
+        if (w->pthread) {
+          w->quit = true;
+          sem_post(&w->start);
+          pthread_join(w->pthread, NULL);
+        }
+        if (w->started) {
+          sem_destroy(&w->start);
+        }
+        ldpc_batch_worker_free(w);
+      }
+      free(pool->workers);
+    }
+    sem_destroy(&pool->finish);
+    pthread_mutex_destroy(&pool->mutex);
+
+    free(pool);
+  }
+
+  q->ptr         = NULL;
+  q->nof_workers = 0;
+}
+
+int srsran_ldpc_decoder_batch_init(srsran_ldpc_decoder_batch_t*      q,
+                                   const srsran_ldpc_decoder_args_t* args,
+                                   uint32_t                          nof_workers)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  if (q == NULL || args == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  q->ptr         = NULL;
+  q->nof_workers = 0;
+  if (nof_workers == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  ldpc_batch_pool_t* pool = calloc(1, sizeof(ldpc_batch_pool_t));
+  if (!pool) {
+    ERROR("Allocating LDPC batch decoder");
+    return SRSRAN_ERROR;
+  }
+  q->ptr = pool;
+
+  if (sem_init(&pool->finish, 0, 0)) {
+    ERROR("Creating semaphore");
+    free(pool);
+    q->ptr = NULL;
+    return SRSRAN_ERROR;
+  }
+  if (pthread_mutex_init(&pool->mutex, NULL)) {
+    ERROR("Creating mutex");
+    sem_destroy(&pool->finish);
+    free(pool);
+    q->ptr = NULL;
+    return SRSRAN_ERROR;
+  }
+
+  pool->workers = calloc(nof_workers, sizeof(ldpc_batch_worker_t));
+  if (!pool->workers) {
+    ERROR("Allocating LDPC batch decoder workers");
+    ret = SRSRAN_ERROR;
+    goto clean_exit;
+  }
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    ldpc_batch_worker_t* w = &pool->workers[i];
+    pool->nof_workers      = i + 1;
+    if (ldpc_batch_worker_init(w, pool, args)) {
+      ret = SRSRAN_ERROR;
+      goto clean_exit;
+    }
+    if (pthread_create(&w->pthread, NULL, ldpc_batch_worker_thread, (void*)w)) {
+      ERROR("Creating LDPC batch decoder thread");
+      w->pthread = 0;
+      ret        = SRSRAN_ERROR;
+      goto clean_exit;
+    }
+  }
+  q->nof_workers = nof_workers;
+
+clean_exit:
+  if (ret) {
+    srsran_ldpc_decoder_batch_free(q);
+  }
+  return ret;
+}
+
+int srsran_ldpc_decoder_batch_decode_c(srsran_ldpc_decoder_batch_t*    q,
+                                       srsran_ldpc_decoder_t*          decoder,
+                                       srsran_crc_t*                   crc,
+                                       srsran_ldpc_decoder_batch_cb_t* cbs,
+                                       uint32_t                        nof_cbs)
+{
+  if (q == NULL || decoder == NULL || (cbs == NULL && nof_cbs > 0)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  ldpc_batch_pool_t* pool = (ldpc_batch_pool_t*)q->ptr;
+
+  // Without workers, or with a single code block, there is nothing to share
+  if (pool == NULL || nof_cbs < 2) {
+    int ret = SRSRAN_SUCCESS;
+    for (uint32_t i = 0; i < nof_cbs; i++) {
+      cbs[i].ret = srsran_ldpc_decoder_decode_crc_c(decoder, cbs[i].llrs, cbs[i].message, cbs[i].cdwd_rm_length, crc);
+      if (cbs[i].ret < SRSRAN_SUCCESS) {
+        ret = SRSRAN_ERROR;
+      }
+    }
+    return ret;
+  }
+
+  pool->bg      = decoder->bg;
+  pool->ls      = decoder->ls;
+  pool->has_crc = (crc != NULL);
+  pool->cbs     = cbs;
+  pool->nof_cbs = nof_cbs;
+  pool->next_cb = 0;
+  pool->ret     = SRSRAN_SUCCESS;
+
+  // Only wake up the workers that have a code block to take, the calling thread takes one too
+  uint32_t nof_active = SRSRAN_MIN(pool->nof_workers, nof_cbs - 1);
+  for (uint32_t i = 0; i < nof_active; i++) {
+    if (crc != NULL) {
+      // The CRC object keeps the checksum state, so each worker checks with its own copy
+      pool->workers[i].crc = *crc;
+    }
+    sem_post(&pool->workers[i].start);
+  }
+
+  ldpc_batch_run(pool, decoder, crc);
+
+  for (uint32_t i = 0; i < nof_active; i++) {
+    sem_wait(&pool->finish);
+  }
+
+  return pool->ret;
+}
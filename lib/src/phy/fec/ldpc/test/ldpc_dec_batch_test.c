@@ -0,0 +1,352 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_dec_batch_test.c
+ * \brief Throughput benchmark and unit test for the LDPC batch decoder.
+ *
+ * For each base graph and lifting size, a batch of code blocks with CB CRC is encoded, 2-PAM modulated and sent over
+ * an AWGN channel. The batch is decoded one code block after the other, and with the batch decoder using worker
+ * threads. The test fails if both decodings differ or if any code block does not match its CRC.
+ *
+ * Synopsis: **ldpc_dec_batch_test [options]**
+ *
+ * Options:
+ *  - **-b \<number\>** Base Graph (1 or 2. Default 0, both).
+ *  - **-l \<number\>** Lifting Size (according to 5GNR standard. Default 0, sweeps a set of lifting sizes).
+ *  - **-C \<number\>** Number of code blocks in a batch (Default 16).
+ *  - **-W \<number\>** Number of worker threads besides the calling one (Default 3).
+ *  - **-N \<number\>** Number of decoded batches per configuration (Default 10).
+ *  - **-s \<number\>** SNR in dB (Default 3 dB).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/fec/ldpc/ldpc_common.h"
+#include "srsran/phy/fec/ldpc/ldpc_decoder_batch.h"
+#include "srsran/phy/fec/ldpc/ldpc_encoder.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+
+static int   base_graph  = 0;  /*!< \brief Base Graph (1 or 2, 0 for both). */
+static int   lift_size   = 0;  /*!< \brief Lifting Size, 0 sweeps the lifting sizes below. */
+static int   nof_cbs     = 16; /*!< \brief Number of code blocks in a batch. */
+static int   nof_workers = 3;  /*!< \brief Number of worker threads. */
+static int   nof_batches = 10; /*!< \brief Number of decoded batches per configuration. */
+static float snr         = 3;  /*!< \brief Signal-to-Noise Ratio [dB]. */
+
+static const uint16_t sweep_lift_sizes[] = {16, 32, 64, 104, 128, 208, 256, 320, 384};
+
+#define MS_SF 0.75f /*!< \brief Scaling factor for the normalized min-sum decoding algorithm. */
+#define CB_CRC_LEN 24
+
+/*!
+ * \brief Prints test help when wrong parameter is passed as input.
+ */
+void usage(char* prog)
+{
+  printf("Usage: %s [-bX] [-lX] [-CX] [-WX] [-NX] [-sX]\n", prog);
+  printf("\t-b Base Graph [(1 or 2) Default %d (both)]\n", base_graph);
+  printf("\t-l Lifting Size [Default %d (sweep)]\n", lift_size);
+  printf("\t-C Number of code blocks in a batch [Default %d]\n", nof_cbs);
+  printf("\t-W Number of worker threads [Default %d]\n", nof_workers);
+  printf("\t-N Number of decoded batches per configuration [Default %d]\n", nof_batches);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr);
+}
+
+/*!
+ * \brief Parses the input line.
+ */
+void parse_args(int argc, char** argv)
+{
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "b:l:C:W:N:s:")) != -1) {
+    switch (opt) {
+      case 'b':
+        base_graph = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'l':
+        lift_size = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'C':
+        nof_cbs = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'W':
+        nof_workers = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'N':
+        nof_batches = (int)strtol(optarg, NULL, 10);
+        break;
+      case 's':
+        snr = (float)strtod(optarg, NULL);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static srsran_ldpc_decoder_type_t decoder_type(void)
+{
+#ifdef LV_HAVE_AVX512
+  return SRSRAN_LDPC_DECODER_C_AVX512;
+#else // LV_HAVE_AVX512
+#ifdef LV_HAVE_AVX2
+  return SRSRAN_LDPC_DECODER_C_AVX2;
+#else  // LV_HAVE_AVX2
+  return SRSRAN_LDPC_DECODER_C;
+#endif // LV_HAVE_AVX2
+#endif // LV_HAVE_AVX512
+}
+
+static srsran_ldpc_encoder_type_t encoder_type(void)
+{
+#ifdef LV_HAVE_AVX512
+  return SRSRAN_LDPC_ENCODER_AVX512;
+#else // LV_HAVE_AVX512
+#ifdef LV_HAVE_AVX2
+  return SRSRAN_LDPC_ENCODER_AVX2;
+#else  // LV_HAVE_AVX2
+  return SRSRAN_LDPC_ENCODER_C;
+#endif // LV_HAVE_AVX2
+#endif // LV_HAVE_AVX512
+}
+
+static double elapsed_us(struct timeval* t)
+{
+  get_time_interval(t);
+  return t[0].tv_sec * 1e6 + t[0].tv_usec;
+}
+
+/*!
+ * \brief Decodes batches of code blocks for a base graph and lifting size, serially and with the batch decoder.
+ */
+static int run_config(srsran_ldpc_decoder_batch_t* batch_decoder,
+                      srsran_random_t              random_gen,
+                      srsran_crc_t*                crc,
+                      srsran_basegraph_t           bg,
+                      uint16_t                     ls)
+{
+  int                            ret       = SRSRAN_ERROR;
+  srsran_ldpc_encoder_t          encoder   = {};
+  srsran_ldpc_decoder_t          decoder   = {};
+  uint8_t*                       messages  = NULL;
+  uint8_t*                       codewords = NULL;
+  float*                         symbols   = NULL;
+  int8_t*                        llrs      = NULL;
+  uint8_t*                       dec_ser   = NULL;
+  uint8_t*                       dec_bat   = NULL;
+  srsran_ldpc_decoder_batch_cb_t cbs_ser[nof_cbs];
+  srsran_ldpc_decoder_batch_cb_t cbs_bat[nof_cbs];
+
+  srsran_ldpc_decoder_args_t decoder_args = {};
+  decoder_args.type                       = decoder_type();
+  decoder_args.bg                         = bg;
+  decoder_args.ls                         = ls;
+  decoder_args.scaling_fctr               = MS_SF;
+  if (srsran_ldpc_encoder_init(&encoder, encoder_type(), bg, ls) != 0 ||
+      srsran_ldpc_decoder_init(&decoder, &decoder_args) != 0) {
+    ERROR("Error initialising LDPC BG%d ls=%d", bg + 1, ls);
+    goto clean_exit;
+  }
+
+  int finalK = encoder.liftK;
+  int finalN = encoder.liftN - 2 * ls;
+
+  messages  = srsran_vec_u8_malloc(finalK * nof_cbs);
+  codewords = srsran_vec_u8_malloc(finalN * nof_cbs);
+  symbols   = srsran_vec_f_malloc(finalN * nof_cbs);
+  llrs      = srsran_vec_i8_malloc(finalN * nof_cbs);
+  dec_ser   = srsran_vec_u8_malloc(finalK * nof_cbs);
+  dec_bat   = srsran_vec_u8_malloc(finalK * nof_cbs);
+  if (!messages || !codewords || !symbols || !llrs || !dec_ser || !dec_bat) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
+  float  noise_var     = srsran_convert_dB_to_power(-snr);
+  float  noise_std_dev = srsran_convert_dB_to_amplitude(-snr);
+  int8_t inf7          = (1U << 6U) - 1;
+  float  gain_c        = inf7 * noise_std_dev / 8 / (1 / noise_std_dev + 2);
+
+  struct timeval t[3];
+  double         time_ser_us = 0;
+  double         time_bat_us = 0;
+  uint64_t       nof_iter    = 0;
+  for (int n = 0; n < nof_batches; n++) {
+    // Random code blocks with CB CRC
+    for (int i = 0; i < nof_cbs; i++) {
+      uint8_t* msg = messages + i * finalK;
+      for (int j = 0; j < finalK - CB_CRC_LEN; j++) {
+        msg[j] = srsran_random_uniform_int_dist(random_gen, 0, 1);
+      }
+      srsran_crc_attach(crc, msg, finalK - CB_CRC_LEN);
+      srsran_ldpc_encoder_encode_rm(&encoder, msg, codewords + i * finalN, finalK, finalN);
+    }
+
+    // 2-PAM over AWGN
+    for (int j = 0; j < finalN * nof_cbs; j++) {
+      symbols[j] = 1 - 2 * codewords[j];
+    }
+    srsran_ch_awgn_f(symbols, symbols, noise_var, finalN * nof_cbs);
+    srsran_vec_sc_prod_fff(symbols, 2 / noise_var, symbols, finalN * nof_cbs);
+    srsran_vec_quant_fc(symbols, llrs, gain_c, 0, inf7, finalN * nof_cbs);
+
+    for (int i = 0; i < nof_cbs; i++) {
+      cbs_ser[i].llrs           = llrs + i * finalN;
+      cbs_ser[i].message        = dec_ser + i * finalK;
+      cbs_ser[i].cdwd_rm_length = finalN;
+      cbs_bat[i]                = cbs_ser[i];
+      cbs_bat[i].message        = dec_bat + i * finalK;
+    }
+
+    // One code block after the other
+    gettimeofday(&t[1], NULL);
+    for (int i = 0; i < nof_cbs; i++) {
+      cbs_ser[i].ret = srsran_ldpc_decoder_decode_crc_c(
+          &decoder, cbs_ser[i].llrs, cbs_ser[i].message, cbs_ser[i].cdwd_rm_length, crc);
+    }
+    gettimeofday(&t[2], NULL);
+    time_ser_us += elapsed_us(t);
+
+    // Batch decoder
+    gettimeofday(&t[1], NULL);
+    if (srsran_ldpc_decoder_batch_decode_c(batch_decoder, &decoder, crc, cbs_bat, nof_cbs) < SRSRAN_SUCCESS) {
+      ERROR("Error decoding batch");
+      goto clean_exit;
+    }
+    gettimeofday(&t[2], NULL);
+    time_bat_us += elapsed_us(t);
+
+    for (int i = 0; i < nof_cbs; i++) {
+      if (cbs_ser[i].ret <= 0 || cbs_bat[i].ret != cbs_ser[i].ret) {
+        ERROR("BG%d ls=%d CB %d: CRC KO or batch mismatch (serial %d, batch %d iterations)",
+              bg + 1,
+              ls,
+              i,
+              cbs_ser[i].ret,
+              cbs_bat[i].ret);
+        goto clean_exit;
+      }
+      if (memcmp(cbs_ser[i].message, cbs_bat[i].message, finalK) != 0 ||
+          memcmp(cbs_ser[i].message, messages + i * finalK, finalK - CB_CRC_LEN) != 0) {
+        ERROR("BG%d ls=%d CB %d: wrong decoded message", bg + 1, ls, i);
+        goto clean_exit;
+      }
+      nof_iter += cbs_ser[i].ret;
+    }
+  }
+
+  double nof_bits = (double)finalK * nof_cbs * nof_batches;
+  printf("  BG%d %5d %6d %11.1f %13.1f %13.1f %9.2f\n",
+         bg + 1,
+         ls,
+         finalK,
+         (double)nof_iter / (nof_cbs * nof_batches),
+         nof_bits / time_ser_us,
+         nof_bits / time_bat_us,
+         time_ser_us / time_bat_us);
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  free(messages);
+  free(codewords);
+  free(symbols);
+  free(llrs);
+  free(dec_ser);
+  free(dec_bat);
+  srsran_ldpc_encoder_free(&encoder);
+  srsran_ldpc_decoder_free(&decoder);
+  return ret;
+}
+
+/*!
+ * \brief Main test function.
+ */
+int main(int argc, char** argv)
+{
+  int                         ret           = SRSRAN_ERROR;
+  srsran_ldpc_decoder_batch_t batch_decoder = {};
+  srsran_random_t             random_gen    = srsran_random_init(0);
+  srsran_crc_t                crc           = {};
+
+  parse_args(argc, argv);
+
+  if (srsran_crc_init(&crc, SRSRAN_LTE_CRC24B, CB_CRC_LEN) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising CRC");
+    goto clean_exit;
+  }
+
+  srsran_ldpc_decoder_args_t batch_args = {};
+  batch_args.type                       = decoder_type();
+  batch_args.scaling_fctr               = MS_SF;
+  if (srsran_ldpc_decoder_batch_init(&batch_decoder, &batch_args, nof_workers) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising LDPC batch decoder");
+    goto clean_exit;
+  }
+
+  printf("LDPC batch decoder: %d code blocks per batch, %d workers, %d batches, SNR %.1f dB\n",
+         nof_cbs,
+         nof_workers,
+         nof_batches,
+         snr);
+  printf("  BG     Z      K  iterations  serial[Mbps]   batch[Mbps]   speedup\n");
+
+  uint32_t        nof_lift_sizes = sizeof(sweep_lift_sizes) / sizeof(sweep_lift_sizes[0]);
+  const uint16_t* lift_sizes     = sweep_lift_sizes;
+  uint16_t        ls             = (uint16_t)lift_size;
+  if (lift_size != 0) {
+    nof_lift_sizes = 1;
+    lift_sizes     = &ls;
+  }
+
+  for (int bg = 1; bg <= 2; bg++) {
+    if (base_graph != 0 && base_graph != bg) {
+      continue;
+    }
+    for (uint32_t i = 0; i < nof_lift_sizes; i++) {
+      if (run_config(&batch_decoder, random_gen, &crc, (bg == 1) ? BG1 : BG2, lift_sizes[i]) < SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_ldpc_decoder_batch_free(&batch_decoder);
+  srsran_random_free(random_gen);
+  if (ret == SRSRAN_SUCCESS) {
+    printf("Test passed\n");
+  } else {
+    printf("Test failed\n");
+  }
+  return ret;
+}
@@ -92,7 +92,8 @@ int srsran_tc_interl_LTE_gen_interl(srsran_tc_interl_t* h, uint32_t long_cb, uin
     h->forward[i] = (uint32_t)j;
     h->reverse[j] = (uint32_t)i;
   }
-  if (interl_win != 1) {
+  // Code blocks shorter than the number of windows can not be split in sub-blocks
+  if (interl_win != 1 && long_cb >= interl_win) {
     uint16_t* f = srsran_vec_u16_malloc(long_cb);
     uint16_t* r = srsran_vec_u16_malloc(long_cb);
     memcpy(f, h->forward, long_cb * sizeof(uint16_t));
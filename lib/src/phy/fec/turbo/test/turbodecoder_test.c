@@ -62,7 +62,8 @@ void usage(char* prog)
   printf("\t-N nof_repetitions [Default %d]\n", nof_repetitions);
   printf("\t-l frame_length [Default %d]\n", frame_length);
   printf("\t-e ebno in dB [Default scan]\n");
-  printf("\t-d Decoder implementation type: 0: Generic, 1: SSE, 2: SSE-window\n");
+  printf("\t-d Decoder implementation type: 0: Auto, 1: Generic, 2: SSE, 3: SSE-window, 5: AVX-window, 6: SSE8-window, "
+         "7: AVX8-window, 8: AVX512-window, 9: AVX512-8-window\n");
   printf("\t-t test: check errors on exit [Default disabled]\n");
   printf("\t-s seed [Default 0=time]\n");
 }
@@ -208,6 +209,16 @@ int main(int argc, char** argv)
 
   srsran_tdec_force_not_sb(&tdec);
 
+  // The AVX-512 decoders get saturated LLRs. The 8-bit one takes the 16-bit LLR truncated to 8 bits, so they are also
+  // scaled down so they do not wrap around
+  bool  llr_saturate = tdec_type == SRSRAN_TDEC_AVX512_WINDOW || tdec_type == SRSRAN_TDEC_AVX512_8_WINDOW;
+  float llr_gain     = 100.0f;
+  float llr_max      = 32767.0f;
+  if (tdec_type == SRSRAN_TDEC_AVX512_8_WINDOW) {
+    llr_gain = 8.0f;
+    llr_max  = 127.0f;
+  }
+
   float ebno_inc, esno_db;
   ebno_inc = (SNR_MAX - SNR_MIN) / SNR_POINTS;
   if (ebno_db == 100.0) {
@@ -250,8 +261,14 @@ int main(int argc, char** argv)
       }
       srsran_ch_awgn_f(llr, llr, var[i], coded_length);
 
-      for (uint32_t j = 0; j < coded_length; j++) {
-        llr_s[j] = (int16_t)(100 * llr[j]);
+      if (llr_saturate) {
+        for (uint32_t j = 0; j < coded_length; j++) {
+          llr_s[j] = (int16_t)SRSRAN_MAX(-llr_max, SRSRAN_MIN(llr_max, llr_gain * llr[j]));
+        }
+      } else {
+        for (uint32_t j = 0; j < coded_length; j++) {
+          llr_s[j] = (int16_t)(100 * llr[j]);
+        }
       }
 
       /* decoder */
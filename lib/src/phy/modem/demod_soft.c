@@ -86,6 +86,409 @@ void demod_16qam_lte_s_sse(const cf_t* symbols, short* llr, int nsymbols);
 #define SCALE_BYTE_CONV_QAM64 40
 #define SCALE_BYTE_CONV_QAM256 50
 
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+/*
+ * The QAM kernels below compute one vector per bit level for the real and imaginary parts of several symbols. The first
+ * level is the negated symbol, and each following level is the absolute value of the previous one minus a threshold.
+ * The LLRs of a symbol are the (real, imaginary) pairs of all the levels, so the level vectors are interleaved pair by
+ * pair before storing them.
+ *
+ * demod_interleave_pattern() gives, for each 32-bit word of the interleaved output, the word and the level vector it
+ * comes from. A pair takes two words with float LLRs and one word with int16 LLRs.
+ */
+static void demod_interleave_pattern(int      nof_levels,
+                                     int      pair_words,
+                                     int      nof_words,
+                                     int32_t* src_word,
+                                     int32_t* src_level)
+{
+  for (int w = 0; w < nof_levels * nof_words; w++) {
+    int pair     = w / pair_words;
+    src_word[w]  = (pair / nof_levels) * pair_words + w % pair_words;
+    src_level[w] = pair % nof_levels;
+  }
+}
+
+typedef struct {
+  __m256i idx[4];
+  __m256i sel[4][4];
+} demod_interleave_avx2_t;
+
+static inline void demod_interleave_init_avx2(demod_interleave_avx2_t* q, int nof_levels, int pair_words)
+{
+  // Only the 64QAM interleaving is done with the permutation
+  if (nof_levels != 3) {
+    return;
+  }
+
+  int32_t src_word[4 * 8], src_level[4 * 8];
+  demod_interleave_pattern(nof_levels, pair_words, 8, src_word, src_level);
+  for (int j = 0; j < nof_levels; j++) {
+    q->idx[j]     = _mm256_loadu_si256((__m256i*)&src_word[8 * j]);
+    __m256i level = _mm256_loadu_si256((__m256i*)&src_level[8 * j]);
+    for (int l = 0; l < nof_levels; l++) {
+      q->sel[j][l] = _mm256_cmpeq_epi32(level, _mm256_set1_epi32(l));
+    }
+  }
+}
+
+/* With 2 and 4 levels the pairs are transposed within each 128-bit lane with unpacks, and then the lanes are put in
+ * order. AVX2 has no two-source permutation, so with 3 levels each output picks its words from every level */
+static inline void demod_interleave_avx2(const demod_interleave_avx2_t* q,
+                                         const __m256i*                 levels,
+                                         int                            nof_levels,
+                                         int                            pair_words,
+                                         __m256i*                       out)
+{
+  __m256i a, b, c, d;
+  switch (nof_levels) {
+    case 2:
+      if (pair_words == 2) {
+        a = _mm256_unpacklo_epi64(levels[0], levels[1]);
+        b = _mm256_unpackhi_epi64(levels[0], levels[1]);
+      } else {
+        a = _mm256_unpacklo_epi32(levels[0], levels[1]);
+        b = _mm256_unpackhi_epi32(levels[0], levels[1]);
+      }
+      out[0] = _mm256_permute2x128_si256(a, b, 0x20);
+      out[1] = _mm256_permute2x128_si256(a, b, 0x31);
+      break;
+    case 4:
+      if (pair_words == 2) {
+        a = _mm256_unpacklo_epi64(levels[0], levels[1]);
+        b = _mm256_unpacklo_epi64(levels[2], levels[3]);
+        c = _mm256_unpackhi_epi64(levels[0], levels[1]);
+        d = _mm256_unpackhi_epi64(levels[2], levels[3]);
+      } else {
+        __m256i t0 = _mm256_unpacklo_epi32(levels[0], levels[1]);
+        __m256i t1 = _mm256_unpacklo_epi32(levels[2], levels[3]);
+        __m256i t2 = _mm256_unpackhi_epi32(levels[0], levels[1]);
+        __m256i t3 = _mm256_unpackhi_epi32(levels[2], levels[3]);
+        a          = _mm256_unpacklo_epi64(t0, t1);
+        b          = _mm256_unpackhi_epi64(t0, t1);
+        c          = _mm256_unpacklo_epi64(t2, t3);
+        d          = _mm256_unpackhi_epi64(t2, t3);
+      }
+      out[0] = _mm256_permute2x128_si256(a, b, 0x20);
+      out[1] = _mm256_permute2x128_si256(c, d, 0x20);
+      out[2] = _mm256_permute2x128_si256(a, b, 0x31);
+      out[3] = _mm256_permute2x128_si256(c, d, 0x31);
+      break;
+    default:
+      for (int j = 0; j < nof_levels; j++) {
+        out[j] = _mm256_permutevar8x32_epi32(levels[0], q->idx[j]);
+        for (int l = 1; l < nof_levels; l++) {
+          out[j] = _mm256_blendv_epi8(out[j], _mm256_permutevar8x32_epi32(levels[l], q->idx[j]), q->sel[j][l]);
+        }
+      }
+      break;
+  }
+}
+
+static inline int demod_qam_lte_avx2(const cf_t*  symbols,
+                                     float*       llr,
+                                     int          nsymbols,
+                                     int          nof_levels,
+                                     const float* thresholds)
+{
+  demod_interleave_avx2_t il;
+  demod_interleave_init_avx2(&il, nof_levels, 2);
+
+  __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 thr[3];
+  for (int l = 1; l < nof_levels; l++) {
+    thr[l - 1] = _mm256_set1_ps(thresholds[l - 1]);
+  }
+
+  int i = 0;
+  for (; i + 4 <= nsymbols; i += 4) {
+    __m256i levels[4];
+    __m256  level = _mm256_xor_ps(_mm256_loadu_ps((float*)&symbols[i]), sign);
+    levels[0]     = _mm256_castps_si256(level);
+    for (int l = 1; l < nof_levels; l++) {
+      level     = _mm256_sub_ps(_mm256_andnot_ps(sign, level), thr[l - 1]);
+      levels[l] = _mm256_castps_si256(level);
+    }
+    __m256i out[4];
+    demod_interleave_avx2(&il, levels, nof_levels, 2, out);
+    for (int j = 0; j < nof_levels; j++) {
+      _mm256_storeu_si256((__m256i*)&llr[2 * nof_levels * i + 8 * j], out[j]);
+    }
+  }
+  return i;
+}
+
+/* Computes the interleaved int16 LLRs of 8 symbols */
+static inline void demod_qam_lte_s_block_avx2(const demod_interleave_avx2_t* il,
+                                              const cf_t*                    symbols,
+                                              __m256                         scale,
+                                              const __m256i*                 thr,
+                                              int                            nof_levels,
+                                              __m256i*                       out)
+{
+  __m256i levels[4];
+  __m256i symbol1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps((float*)&symbols[0]), scale));
+  __m256i symbol2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps((float*)&symbols[4]), scale));
+  levels[0]       = _mm256_permute4x64_epi64(_mm256_packs_epi32(symbol1, symbol2), 0xd8);
+  for (int l = 1; l < nof_levels; l++) {
+    levels[l] = _mm256_sub_epi16(_mm256_abs_epi16(levels[l - 1]), thr[l - 1]);
+  }
+  demod_interleave_avx2(il, levels, nof_levels, 1, out);
+}
+
+static inline int demod_qam_lte_s_avx2(const cf_t*  symbols,
+                                       int16_t*     llr,
+                                       int          nsymbols,
+                                       int          nof_levels,
+                                       float        scale,
+                                       const float* thresholds)
+{
+  demod_interleave_avx2_t il;
+  demod_interleave_init_avx2(&il, nof_levels, 1);
+
+  __m256  scale_v = _mm256_set1_ps(-scale);
+  __m256i thr[3];
+  for (int l = 1; l < nof_levels; l++) {
+    thr[l - 1] = _mm256_set1_epi16((int16_t)(scale * thresholds[l - 1]));
+  }
+
+  int i = 0;
+  for (; i + 8 <= nsymbols; i += 8) {
+    __m256i out[4];
+    demod_qam_lte_s_block_avx2(&il, &symbols[i], scale_v, thr, nof_levels, out);
+    for (int j = 0; j < nof_levels; j++) {
+      _mm256_storeu_si256((__m256i*)&llr[2 * nof_levels * i + 16 * j], out[j]);
+    }
+  }
+  return i;
+}
+
+static inline int demod_qam_lte_b_avx2(const cf_t*  symbols,
+                                       int8_t*      llr,
+                                       int          nsymbols,
+                                       int          nof_levels,
+                                       float        scale,
+                                       const float* thresholds)
+{
+  demod_interleave_avx2_t il;
+  demod_interleave_init_avx2(&il, nof_levels, 1);
+
+  __m256  scale_v = _mm256_set1_ps(-scale);
+  __m256i thr[3];
+  for (int l = 1; l < nof_levels; l++) {
+    thr[l - 1] = _mm256_set1_epi16((int16_t)(scale * thresholds[l - 1]));
+  }
+
+  int i = 0;
+  for (; i + 16 <= nsymbols; i += 16) {
+    // The LLRs are computed with 16 bits and saturated to 8 bits at the end
+    __m256i out[8];
+    demod_qam_lte_s_block_avx2(&il, &symbols[i], scale_v, thr, nof_levels, &out[0]);
+    demod_qam_lte_s_block_avx2(&il, &symbols[i + 8], scale_v, thr, nof_levels, &out[nof_levels]);
+    for (int j = 0; j < nof_levels; j++) {
+      __m256i result = _mm256_permute4x64_epi64(_mm256_packs_epi16(out[2 * j], out[2 * j + 1]), 0xd8);
+      _mm256_storeu_si256((__m256i*)&llr[2 * nof_levels * i + 32 * j], result);
+    }
+  }
+  return i;
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_AVX512
+
+/* With AVX-512 the levels are interleaved two at a time with a two-source permutation, and the pairs of the third and
+ * fourth levels are merged with a mask */
+typedef struct {
+  __m512i   idx[4];
+  __mmask16 upper[4];
+} demod_interleave_avx512_t;
+
+static inline void demod_interleave_init_avx512(demod_interleave_avx512_t* q, int nof_levels, int pair_words)
+{
+  int32_t src_word[4 * 16], src_level[4 * 16];
+  demod_interleave_pattern(nof_levels, pair_words, 16, src_word, src_level);
+  for (int j = 0; j < nof_levels; j++) {
+    __m512i word  = _mm512_loadu_si512(&src_word[16 * j]);
+    __m512i level = _mm512_loadu_si512(&src_level[16 * j]);
+    q->idx[j]     = _mm512_add_epi32(word, _mm512_slli_epi32(_mm512_and_si512(level, _mm512_set1_epi32(1)), 4));
+    q->upper[j]   = _mm512_cmpge_epi32_mask(level, _mm512_set1_epi32(2));
+  }
+}
+
+static inline __m512i demod_interleave_avx512(const demod_interleave_avx512_t* q,
+                                              const __m512i*                   levels,
+                                              int                              nof_levels,
+                                              int                              j)
+{
+  __m512i out = _mm512_permutex2var_epi32(levels[0], q->idx[j], levels[nof_levels > 1 ? 1 : 0]);
+  if (nof_levels > 2) {
+    __m512i upper = _mm512_permutex2var_epi32(levels[2], q->idx[j], levels[nof_levels > 3 ? 3 : 2]);
+    out           = _mm512_mask_mov_epi32(out, q->upper[j], upper);
+  }
+  return out;
+}
+
+static inline int demod_qam_lte_avx512(const cf_t*  symbols,
+                                       float*       llr,
+                                       int          nsymbols,
+                                       int          nof_levels,
+                                       const float* thresholds)
+{
+  demod_interleave_avx512_t il;
+  demod_interleave_init_avx512(&il, nof_levels, 2);
+
+  __m512 thr[3];
+  for (int l = 1; l < nof_levels; l++) {
+    thr[l - 1] = _mm512_set1_ps(thresholds[l - 1]);
+  }
+
+  int i = 0;
+  for (; i + 8 <= nsymbols; i += 8) {
+    __m512i levels[4];
+    __m512  level = _mm512_sub_ps(_mm512_setzero_ps(), _mm512_loadu_ps((float*)&symbols[i]));
+    levels[0]     = _mm512_castps_si512(level);
+    for (int l = 1; l < nof_levels; l++) {
+      level     = _mm512_sub_ps(_mm512_abs_ps(level), thr[l - 1]);
+      levels[l] = _mm512_castps_si512(level);
+    }
+    for (int j = 0; j < nof_levels; j++) {
+      _mm512_storeu_si512(&llr[2 * nof_levels * i + 16 * j], demod_interleave_avx512(&il, levels, nof_levels, j));
+    }
+  }
+  return i;
+}
+
+/* Computes the interleaved int16 LLRs of 16 symbols */
+static inline void demod_qam_lte_s_block_avx512(const demod_interleave_avx512_t* il,
+                                                const cf_t*                      symbols,
+                                                __m512                           scale,
+                                                const __m512i*                   thr,
+                                                int                              nof_levels,
+                                                __m512i*                         out)
+{
+  __m512i levels[4];
+  __m256i symbol1 = _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(&symbols[0]), scale)));
+  __m256i symbol2 = _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(&symbols[8]), scale)));
+  levels[0]       = _mm512_inserti64x4(_mm512_castsi256_si512(symbol1), symbol2, 1);
+  for (int l = 1; l < nof_levels; l++) {
+    levels[l] = _mm512_sub_epi16(_mm512_abs_epi16(levels[l - 1]), thr[l - 1]);
+  }
+  for (int j = 0; j < nof_levels; j++) {
+    out[j] = demod_interleave_avx512(il, levels, nof_levels, j);
+  }
+}
+
+static inline int demod_qam_lte_s_avx512(const cf_t*  symbols,
+                                         int16_t*     llr,
+                                         int          nsymbols,
+                                         int          nof_levels,
+                                         float        scale,
+                                         const float* thresholds)
+{
+  demod_interleave_avx512_t il;
+  demod_interleave_init_avx512(&il, nof_levels, 1);
+
+  __m512  scale_v = _mm512_set1_ps(-scale);
+  __m512i thr[3];
+  for (int l = 1; l < nof_levels; l++) {
+    thr[l - 1] = _mm512_set1_epi16((int16_t)(scale * thresholds[l - 1]));
+  }
+
+  int i = 0;
+  for (; i + 16 <= nsymbols; i += 16) {
+    __m512i out[4];
+    demod_qam_lte_s_block_avx512(&il, &symbols[i], scale_v, thr, nof_levels, out);
+    for (int j = 0; j < nof_levels; j++) {
+      _mm512_storeu_si512(&llr[2 * nof_levels * i + 32 * j], out[j]);
+    }
+  }
+  return i;
+}
+
+static inline int demod_qam_lte_b_avx512(const cf_t*  symbols,
+                                         int8_t*      llr,
+                                         int          nsymbols,
+                                         int          nof_levels,
+                                         float        scale,
+                                         const float* thresholds)
+{
+  demod_interleave_avx512_t il;
+  demod_interleave_init_avx512(&il, nof_levels, 1);
+
+  __m512  scale_v = _mm512_set1_ps(-scale);
+  __m512i thr[3];
+  for (int l = 1; l < nof_levels; l++) {
+    thr[l - 1] = _mm512_set1_epi16((int16_t)(scale * thresholds[l - 1]));
+  }
+
+  int i = 0;
+  for (; i + 32 <= nsymbols; i += 32) {
+    // The LLRs are computed with 16 bits and saturated to 8 bits at the end
+    __m512i out[8];
+    demod_qam_lte_s_block_avx512(&il, &symbols[i], scale_v, thr, nof_levels, &out[0]);
+    demod_qam_lte_s_block_avx512(&il, &symbols[i + 16], scale_v, thr, nof_levels, &out[nof_levels]);
+    for (int j = 0; j < nof_levels; j++) {
+      __m256i result1 = _mm512_cvtsepi16_epi8(out[2 * j]);
+      __m256i result2 = _mm512_cvtsepi16_epi8(out[2 * j + 1]);
+      _mm512_storeu_si512(&llr[2 * nof_levels * i + 64 * j],
+                          _mm512_inserti64x4(_mm512_castsi256_si512(result1), result2, 1));
+    }
+  }
+  return i;
+}
+
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+
+/* Demodulate the symbols that fill whole vectors with the widest instruction set. They return the number of demodulated
+ * symbols, the caller demodulates the rest */
+static inline int demod_qam_lte_simd(const cf_t*  symbols,
+                                     float*       llr,
+                                     int          nsymbols,
+                                     int          nof_levels,
+                                     const float* thresholds)
+{
+#ifdef LV_HAVE_AVX512
+  return demod_qam_lte_avx512(symbols, llr, nsymbols, nof_levels, thresholds);
+#else
+  return demod_qam_lte_avx2(symbols, llr, nsymbols, nof_levels, thresholds);
+#endif
+}
+
+static inline int demod_qam_lte_s_simd(const cf_t*  symbols,
+                                       int16_t*     llr,
+                                       int          nsymbols,
+                                       int          nof_levels,
+                                       float        scale,
+                                       const float* thresholds)
+{
+#ifdef LV_HAVE_AVX512
+  return demod_qam_lte_s_avx512(symbols, llr, nsymbols, nof_levels, scale, thresholds);
+#else
+  return demod_qam_lte_s_avx2(symbols, llr, nsymbols, nof_levels, scale, thresholds);
+#endif
+}
+
+static inline int demod_qam_lte_b_simd(const cf_t*  symbols,
+                                       int8_t*      llr,
+                                       int          nsymbols,
+                                       int          nof_levels,
+                                       float        scale,
+                                       const float* thresholds)
+{
+#ifdef LV_HAVE_AVX512
+  return demod_qam_lte_b_avx512(symbols, llr, nsymbols, nof_levels, scale, thresholds);
+#else
+  return demod_qam_lte_b_avx2(symbols, llr, nsymbols, nof_levels, scale, thresholds);
+#endif
+}
+
+#endif /* LV_HAVE_AVX2 */
+
 void demod_bpsk_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
   for (int i = 0; i < nsymbols; i++) {
@@ -124,7 +527,12 @@ void demod_qpsk_lte(const cf_t* symbols, float* llr, int nsymbols)
 
 void demod_16qam_lte(const cf_t* symbols, float* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {2 / sqrtf(10)};
+  i                        = demod_qam_lte_simd(symbols, llr, nsymbols, 2, thresholds);
+#endif /* LV_HAVE_AVX2 */
+  for (; i < nsymbols; i++) {
     float yre = crealf(symbols[i]);
     float yim = cimagf(symbols[i]);
 
@@ -363,7 +771,12 @@ void demod_16qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
 void demod_16qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
 #ifdef LV_HAVE_SSE
-  demod_16qam_lte_s_sse(symbols, llr, nsymbols);
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {2 / sqrtf(10)};
+  i                        = demod_qam_lte_s_simd(symbols, llr, nsymbols, 2, SCALE_SHORT_CONV_QAM16, thresholds);
+#endif /* LV_HAVE_AVX2 */
+  demod_16qam_lte_s_sse(&symbols[i], &llr[4 * i], nsymbols - i);
 #else
 #ifdef HAVE_NEONv8
   demod_16qam_lte_s_neon(symbols, llr, nsymbols);
@@ -384,7 +797,12 @@ void demod_16qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 void demod_16qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
 #ifdef LV_HAVE_SSE
-  demod_16qam_lte_b_sse(symbols, llr, nsymbols);
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {2 / sqrtf(10)};
+  i                        = demod_qam_lte_b_simd(symbols, llr, nsymbols, 2, SCALE_BYTE_CONV_QAM16, thresholds);
+#endif /* LV_HAVE_AVX2 */
+  demod_16qam_lte_b_sse(&symbols[i], &llr[4 * i], nsymbols - i);
 #else
 #ifdef HAVE_NEONv8
   demod_16qam_lte_b_neon(symbols, llr, nsymbols);
@@ -404,7 +822,12 @@ void demod_16qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 void demod_64qam_lte(const cf_t* symbols, float* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {4 / sqrtf(42), 2 / sqrtf(42)};
+  i                        = demod_qam_lte_simd(symbols, llr, nsymbols, 3, thresholds);
+#endif /* LV_HAVE_AVX2 */
+  for (; i < nsymbols; i++) {
     float yre = crealf(symbols[i]);
     float yim = cimagf(symbols[i]);
 
@@ -734,7 +1157,12 @@ void demod_64qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
 void demod_64qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
 #ifdef LV_HAVE_SSE
-  demod_64qam_lte_s_sse(symbols, llr, nsymbols);
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {4 / sqrtf(42), 2 / sqrtf(42)};
+  i                        = demod_qam_lte_s_simd(symbols, llr, nsymbols, 3, SCALE_SHORT_CONV_QAM64, thresholds);
+#endif /* LV_HAVE_AVX2 */
+  demod_64qam_lte_s_sse(&symbols[i], &llr[6 * i], nsymbols - i);
 #else
 #ifdef HAVE_NEONv8
   demod_64qam_lte_s_neon(symbols, llr, nsymbols);
@@ -757,7 +1185,12 @@ void demod_64qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 void demod_64qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
 #ifdef LV_HAVE_SSE
-  demod_64qam_lte_b_sse(symbols, llr, nsymbols);
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {4 / sqrtf(42), 2 / sqrtf(42)};
+  i                        = demod_qam_lte_b_simd(symbols, llr, nsymbols, 3, SCALE_BYTE_CONV_QAM64, thresholds);
+#endif /* LV_HAVE_AVX2 */
+  demod_64qam_lte_b_sse(&symbols[i], &llr[6 * i], nsymbols - i);
 #else
 #ifdef HAVE_NEONv8
   demod_64qam_lte_b_neon(symbols, llr, nsymbols);
@@ -779,7 +1212,13 @@ void demod_64qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {8.0f / sqrtf(170.0f), 4.0f / sqrtf(170.0f), 2.0f / sqrtf(170.0f)};
+  i                        = demod_qam_lte_simd(symbols, llr, nsymbols, 4, thresholds);
+  llr += 8 * i;
+#endif /* LV_HAVE_AVX2 */
+  for (; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
     float imag = -__imag__ symbols[i];
     *(llr++)   = real;
@@ -801,7 +1240,13 @@ void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
 
 void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {8.0f / sqrtf(170.0f), 4.0f / sqrtf(170.0f), 2.0f / sqrtf(170.0f)};
+  i                        = demod_qam_lte_b_simd(symbols, llr, nsymbols, 4, SCALE_BYTE_CONV_QAM256, thresholds);
+  llr += 8 * i;
+#endif /* LV_HAVE_AVX2 */
+  for (; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
     float imag = -__imag__ symbols[i];
     *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
@@ -823,7 +1268,13 @@ void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
+  int i = 0;
+#ifdef LV_HAVE_AVX2
+  const float thresholds[] = {8.0f / sqrtf(170.0f), 4.0f / sqrtf(170.0f), 2.0f / sqrtf(170.0f)};
+  i                        = demod_qam_lte_s_simd(symbols, llr, nsymbols, 4, SCALE_SHORT_CONV_QAM256, thresholds);
+  llr += 8 * i;
+#endif /* LV_HAVE_AVX2 */
+  for (; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
     float imag = -__imag__ symbols[i];
     *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
@@ -33,19 +33,21 @@
 static uint32_t     nof_frames = 10;
 static uint32_t     num_bits   = 1000;
 static srsran_mod_t modulation = SRSRAN_MOD_NITEMS;
+static bool         benchmark  = false;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)\n", prog);
+  printf("Usage: %s [nfbv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)\n", prog);
   printf("\t-n num_bits [Default %d]\n", num_bits);
   printf("\t-f nof_frames [Default %d]\n", nof_frames);
+  printf("\t-b benchmark all the modulations, ignores -m [Default %s]\n", benchmark ? "true" : "false");
   printf("\t-v srsran_verbose [Default None]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "nmvf")) != -1) {
+  while ((opt = getopt(argc, argv, "nmvfb")) != -1) {
     switch (opt) {
       case 'n':
         num_bits = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -53,6 +55,9 @@ void parse_args(int argc, char** argv)
       case 'f':
         nof_frames = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'b':
+        benchmark = true;
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -85,7 +90,7 @@ void parse_args(int argc, char** argv)
         exit(-1);
     }
   }
-  if (modulation == SRSRAN_MOD_NITEMS) {
+  if (modulation == SRSRAN_MOD_NITEMS && !benchmark) {
     usage(argv[0]);
     exit(-1);
   }
@@ -109,7 +114,7 @@ float mse_threshold()
   }
 }
 
-int main(int argc, char** argv)
+static int test_modulation()
 {
   int                  i;
   srsran_modem_table_t mod;
@@ -119,8 +124,6 @@ int main(int argc, char** argv)
   short*               llr_s;
   int8_t*              llr_b;
 
-  parse_args(argc, argv);
-
   /* initialize objects */
   if (srsran_modem_table_lte(&mod, modulation)) {
     ERROR("Error initializing modem table");
@@ -232,6 +235,10 @@ int main(int argc, char** argv)
         printf("Error in bit %d\n", i);
         goto clean_exit;
       }
+      if (input[i] != (llr_s[i] > 0 ? 1 : 0) || input[i] != (llr_b[i] > 0 ? 1 : 0)) {
+        printf("Error in bit %d of the fixed point LLRs\n", i);
+        goto clean_exit;
+      }
     }
   }
   ret = 0;
@@ -246,12 +253,41 @@ clean_exit:
 
   srsran_modem_table_free(&mod);
 
-  printf("Mean Throughput: %.2f/%.2f/%.2f. Mbps ExTime: %.2f/%.2f/%.2f us\n",
-         num_bits / mean_texec,
-         num_bits / mean_texec_s,
-         num_bits / mean_texec_b,
-         mean_texec,
-         mean_texec_s,
-         mean_texec_b);
-  exit(ret);
+  if (benchmark) {
+    printf("%10s%15.1f%15.1f%15.1f\n",
+           srsran_mod_string(modulation),
+           num_bits / mean_texec,
+           num_bits / mean_texec_s,
+           num_bits / mean_texec_b);
+  } else {
+    printf("Mean Throughput: %.2f/%.2f/%.2f. Mbps ExTime: %.2f/%.2f/%.2f us\n",
+           num_bits / mean_texec,
+           num_bits / mean_texec_s,
+           num_bits / mean_texec_b,
+           mean_texec,
+           mean_texec_s,
+           mean_texec_b);
+  }
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (!benchmark) {
+    exit(test_modulation());
+  }
+
+  // Throughput of the float, int16 and int8 soft demodulators for every modulation
+  printf("%10s%15s%15s%15s\n", "Modulation", "float [Mbps]", "int16 [Mbps]", "int8 [Mbps]");
+  srsran_mod_t modulations[] = {
+      SRSRAN_MOD_BPSK, SRSRAN_MOD_QPSK, SRSRAN_MOD_16QAM, SRSRAN_MOD_64QAM, SRSRAN_MOD_256QAM};
+  for (uint32_t m = 0; m < sizeof(modulations) / sizeof(modulations[0]); m++) {
+    modulation = modulations[m];
+    if (test_modulation()) {
+      exit(-1);
+    }
+  }
+  exit(0);
 }
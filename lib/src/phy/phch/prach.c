@@ -44,6 +44,7 @@
 #define MAX_ROOTS 838     // Max number of root sequences
 //#define PRACH_CANCELLATION_HARD
 #define PRACH_AMP 1.0
+#define PRACH_BATCH_ALIGN 16 // Row alignment of the batched correlations, in samples
 
 // Comment following line for disabling complex exponential look-up table
 #define PRACH_USE_CEXP_LUT
@@ -447,6 +448,48 @@ static cf_t* get_precoded_dft(srsran_prach_t* p, uint32_t idx)
   return p->dft_seqs[idx];
 }
 
+// Allocates the buffers of the batched detection and plans the IFFT of all the searched roots in one call
+static int prach_batch_init(srsran_prach_t* p)
+{
+  if (!p->batch_spec) {
+    uint32_t max_len = N_SEQS * SRSRAN_CEIL(SRSRAN_PRACH_N_ZC_LONG, PRACH_BATCH_ALIGN) * PRACH_BATCH_ALIGN;
+    p->batch_spec    = srsran_vec_cf_malloc(max_len);
+    p->batch_td      = srsran_vec_cf_malloc(max_len);
+    p->batch_corr    = srsran_vec_f_malloc(max_len);
+    if (!p->batch_spec || !p->batch_td || !p->batch_corr) {
+      ERROR("Error allocating memory");
+      return SRSRAN_ERROR;
+    }
+  }
+  p->batch_stride = SRSRAN_CEIL(p->N_zc, PRACH_BATCH_ALIGN) * PRACH_BATCH_ALIGN;
+
+  srsran_dft_plan_free(&p->zc_ifft_batch);
+  if (srsran_dft_plan_guru_c(&p->zc_ifft_batch,
+                             p->N_zc,
+                             SRSRAN_DFT_BACKWARD,
+                             p->batch_spec,
+                             p->batch_td,
+                             1,
+                             1,
+                             p->num_ra_preambles,
+                             p->batch_stride,
+                             p->batch_stride)) {
+    ERROR("Error creating batched DFT plan");
+    return SRSRAN_ERROR;
+  }
+
+  // The padding between rows is never written by the IFFT, keep it to zero so that it does not add to the power
+  uint32_t len = p->num_ra_preambles * p->batch_stride;
+  srsran_vec_cf_zero(p->batch_spec, len);
+  srsran_vec_cf_zero(p->batch_td, len);
+
+  // Precode the searched roots now rather than in the first detection
+  for (uint32_t i = 0; i < p->num_ra_preambles; i++) {
+    get_precoded_dft(p, p->root_seqs_idx[i]);
+  }
+  return SRSRAN_SUCCESS;
+}
+
 int srsran_prach_gen_seqs(srsran_prach_t* p)
 {
   uint32_t u           = 0;
@@ -735,6 +778,11 @@ int srsran_prach_set_cell_(srsran_prach_t*      p,
         }
       }
     }
+
+    p->batch_detection = cfg->enable_batch_detection;
+    if (p->batch_detection && prach_batch_init(p)) {
+      return SRSRAN_ERROR;
+    }
     ret = SRSRAN_SUCCESS;
   } else {
     ERROR("Invalid parameters N_ifft_ul=%d; config_idx=%d; root_seq_idx=%d;",
@@ -858,7 +906,7 @@ float srsran_prach_calculate_time_offset_secs(srsran_prach_t* p, cf_t* cross)
 }
 // calculates the aggregate phase offset of the incomming PRACH signal so it can be applied to the reference signal
 // before it is subtracted from the input
-void srsran_prach_calculate_correction_array(srsran_prach_t* p, cf_t* corr_freq)
+void srsran_prach_calculate_correction_array(srsran_prach_t* p, const cf_t* corr_freq)
 {
   srsran_vec_arg_deg_cf(corr_freq, 0, p->phase, p->N_zc);
   for (int i = 0; i < p->N_zc; i++) {
@@ -866,6 +914,53 @@ void srsran_prach_calculate_correction_array(srsran_prach_t* p, cf_t* corr_freq)
   }
 }
 
+// Correlates the PRACH bins with the root sequence i. Leaves the correlation spectrum in corr_freq and the power delay
+// profile in corr
+static void prach_correlate_root(srsran_prach_t* p, uint32_t i)
+{
+  cf_t* root_spec = get_precoded_dft(p, p->root_seqs_idx[i]);
+
+  srsran_vec_prod_conj_ccc(p->prach_bins, root_spec, p->corr_freq, p->N_zc);
+  srsran_dft_run(&p->zc_ifft, p->corr_freq, p->corr_spec);
+  srsran_vec_abs_square_cf(p->corr_spec, p->corr, p->N_zc);
+}
+
+// Correlates the PRACH bins with all the searched root sequences, one root per row of the batch buffers. The IFFTs run
+// as a single batched transform and the power of all rows is computed in one vector operation
+static void prach_correlate_batch(srsran_prach_t* p)
+{
+  for (uint32_t i = 0; i < p->num_ra_preambles; i++) {
+    cf_t* root_spec = get_precoded_dft(p, p->root_seqs_idx[i]);
+    srsran_vec_prod_conj_ccc(p->prach_bins, root_spec, &p->batch_spec[i * p->batch_stride], p->N_zc);
+  }
+  srsran_dft_run_guru_c(&p->zc_ifft_batch);
+  srsran_vec_abs_square_cf(p->batch_td, p->batch_corr, p->num_ra_preambles * p->batch_stride);
+}
+
+// Finds the peak of the power delay profile in each cyclic shift window and returns the largest of them
+static float prach_find_peaks(srsran_prach_t* p, const float* corr, uint32_t n_wins, uint32_t winsize)
+{
+  float max_peak = 0;
+  for (uint32_t j = 0; j < n_wins; j++) {
+    uint32_t start = (p->N_zc - (j * p->N_cs)) % p->N_zc;
+    uint32_t end   = start + winsize;
+    if (end > p->deadzone) {
+      end -= p->deadzone;
+    }
+    start += p->deadzone;
+    p->peak_values[j] = 0;
+    if (end > start) {
+      uint32_t k = srsran_vec_max_fi(&corr[start], end - start);
+      if (corr[start + k] > 0) {
+        p->peak_values[j]  = corr[start + k];
+        p->peak_offsets[j] = k;
+      }
+    }
+    max_peak = SRSRAN_MAX(max_peak, p->peak_values[j]);
+  }
+  return max_peak;
+}
+
 // This function carries out the main processing on the incomming PRACH signal
 int srsran_prach_process(srsran_prach_t* p,
                          cf_t*           signal,
@@ -879,53 +974,38 @@ int srsran_prach_process(srsran_prach_t* p,
 {
   float max_to_cancel = 0;
   cancellation_idx    = -1;
-  int max_idx         = 0;
   srsran_vec_cf_zero(p->cross, p->N_zc);
-  srsran_vec_cf_zero(p->corr_freq, p->N_zc);
-  for (int i = 0; i < p->num_ra_preambles; i++) {
-    cf_t* root_spec = get_precoded_dft(p, p->root_seqs_idx[i]);
-
-    srsran_vec_prod_conj_ccc(p->prach_bins, root_spec, p->corr_spec, p->N_zc);
-
-    srsran_vec_prod_conj_ccc(p->corr_spec, &p->corr_spec[1], p->cross, p->N_zc - 1);
-    if (p->successive_cancellation) {
-      srsran_vec_cf_copy(p->corr_freq, p->corr_spec, p->N_zc);
-    }
-    srsran_dft_run(&p->zc_ifft, p->corr_spec, p->corr_spec);
 
-    srsran_vec_abs_square_cf(p->corr_spec, p->corr, p->N_zc);
+  uint32_t winsize = 0;
+  if (p->N_cs != 0) {
+    winsize = p->N_cs;
+  } else {
+    winsize = p->N_zc;
+  }
+  uint32_t n_wins = p->N_zc / winsize;
 
-    float corr_ave = srsran_vec_acc_ff(p->corr, p->N_zc) / p->N_zc;
+  if (p->batch_detection) {
+    prach_correlate_batch(p);
+  }
 
-    uint32_t winsize = 0;
-    if (p->N_cs != 0) {
-      winsize = p->N_cs;
+  for (int i = 0; i < p->num_ra_preambles; i++) {
+    const cf_t*  corr_freq = p->corr_freq;
+    const float* corr      = p->corr;
+    if (p->batch_detection) {
+      corr_freq = &p->batch_spec[i * p->batch_stride];
+      corr      = &p->batch_corr[i * p->batch_stride];
     } else {
-      winsize = p->N_zc;
-    }
-    uint32_t n_wins = p->N_zc / winsize;
-
-    float max_peak = 0;
-    for (int j = 0; j < n_wins; j++) {
-      uint32_t start = (p->N_zc - (j * p->N_cs)) % p->N_zc;
-      uint32_t end   = start + winsize;
-      if (end > p->deadzone) {
-        end -= p->deadzone;
-      }
-      start += p->deadzone;
-      p->peak_values[j] = 0;
-      for (int k = start; k < end; k++) {
-        if (p->corr[k] > p->peak_values[j]) {
-          p->peak_values[j]  = p->corr[k];
-          p->peak_offsets[j] = k - start;
-          if (p->peak_values[j] > max_peak) {
-            max_peak = p->peak_values[j];
-            max_idx  = k;
-          }
-        }
-      }
+      prach_correlate_root(p, i);
     }
+
+    float corr_ave = srsran_vec_acc_ff(corr, p->N_zc) / p->N_zc;
+
+    float max_peak = prach_find_peaks(p, corr, n_wins, winsize);
     if (max_peak > (p->detect_factor * corr_ave)) {
+      // The cross-correlation of adjacent bins is only needed for the detected roots
+      if (t_offsets && p->freq_domain_offset_calc) {
+        srsran_vec_prod_conj_ccc(corr_freq, &corr_freq[1], p->cross, p->N_zc - 1);
+      }
       for (int j = 0; j < n_wins; j++) {
         if (p->peak_values[j] > p->detect_factor * corr_ave) {
           if (indices) {
@@ -935,7 +1015,7 @@ int srsran_prach_process(srsran_prach_t* p,
                 max_to_cancel          = max_peak;
                 p->prach_cancel.idx    = cancellation_idx;
                 p->prach_cancel.factor = (sqrt(max_peak / (p->N_zc * p->N_zc)));
-                srsran_prach_calculate_correction_array(p, p->corr_freq);
+                srsran_prach_calculate_correction_array(p, corr_freq);
               }
               if (srsran_prach_have_stored(((i * n_wins) + j), indices, *n_indices)) {
                 break;
@@ -1029,6 +1109,11 @@ int srsran_prach_free(srsran_prach_t* p)
     free(p->signal_fft);
   }
 
+  srsran_dft_plan_free(&p->zc_ifft_batch);
+  free(p->batch_spec);
+  free(p->batch_td);
+  free(p->batch_corr);
+
   for (unsigned int i = 0; i < 64; i++) {
     free(p->td_signals[i]);
   }
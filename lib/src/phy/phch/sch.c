@@ -25,6 +25,8 @@
 #include "srsran/srsran.h"
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -200,6 +202,8 @@ clean:
 
 void srsran_sch_free(srsran_sch_t* q)
 {
+  srsran_sch_disable_cb_workers(q);
+
   srsran_rm_turbo_free_tables();
 
   if (q->cb_in) {
@@ -234,6 +238,526 @@ float srsran_sch_last_noi(srsran_sch_t* q)
   return q->avg_iterations;
 }
 
+/* Code block processing context. The sch object has one for the calling thread and each code block worker another */
+typedef struct {
+  srsran_tcod_t* encoder;
+  srsran_tdec_t* decoder;
+  srsran_crc_t*  crc_tb; // Only carries the TB CRC when the context is serial, otherwise it is scratch
+  srsran_crc_t*  crc_cb;
+  uint8_t*       cb_in;
+  uint8_t*       parity_bits;
+  uint8_t*       cb_out; // Decoded code block including CRC, NULL decodes in-place in the transport block
+  uint32_t       nof_iterations;
+} sch_cb_ctx_t;
+
+typedef struct {
+  pthread_t     pthread;
+  void*         pool_ptr;
+  sch_cb_ctx_t  ctx;
+  srsran_tcod_t encoder;
+  srsran_tdec_t decoder;
+  srsran_crc_t  crc_tb;
+  srsran_crc_t  crc_cb;
+
+  sem_t start;
+  bool  quit;
+} sch_cb_worker_t;
+
+typedef struct {
+  uint32_t         nof_workers;
+  sch_cb_worker_t* workers;
+  sch_cb_ctx_t     caller;
+  srsran_crc_t     caller_crc_tb;
+  uint8_t*         caller_cb_out;
+  uint8_t*         e_temp;
+  sem_t            finish;
+  pthread_mutex_t  mutex;
+
+  /* Transport block being processed: they must be set before posting the start semaphores */
+  srsran_sch_t*           q;
+  bool                    is_encoder;
+  srsran_cbsegm_t*        cb_segm;
+  srsran_softbuffer_tx_t* softbuffer_tx;
+  srsran_softbuffer_rx_t* softbuffer_rx;
+  uint32_t                Qm;
+  uint32_t                rv;
+  uint32_t                nof_e_bits;
+  void*                   e_bits;
+  uint8_t*                data;
+  uint32_t                cb_rp[SRSRAN_MAX_CODEBLOCKS];
+  uint32_t                cb_n_e[SRSRAN_MAX_CODEBLOCKS];
+  uint32_t                cb_e_temp_idx[SRSRAN_MAX_CODEBLOCKS];
+
+  /* Shared by the workers, protected by the mutex */
+  uint32_t next_cb;
+  int      ret;
+} sch_cb_pool_t;
+
+/* Computes the code block and rate matching lengths for the code block i according to 36.212 5.3.2 */
+static void encode_cb_lengths(srsran_cbsegm_t* cb_segm,
+                              uint32_t         Qm,
+                              uint32_t         nof_e_bits,
+                              uint32_t         i,
+                              uint32_t*        cblen_idx,
+                              uint32_t*        rlen,
+                              uint32_t*        n_e)
+{
+  uint32_t Gp     = nof_e_bits / Qm;
+  uint32_t gamma  = (cb_segm->C > 0) ? Gp % cb_segm->C : Gp;
+  uint32_t cb_len = (i < cb_segm->C2) ? cb_segm->K2 : cb_segm->K1;
+
+  *cblen_idx = (i < cb_segm->C2) ? cb_segm->K2_idx : cb_segm->K1_idx;
+  *rlen      = (cb_segm->C > 1) ? cb_len - 24 : cb_len;
+  if (i <= cb_segm->C - gamma - 1) {
+    *n_e = Qm * (Gp / cb_segm->C);
+  } else {
+    *n_e = Qm * ((uint32_t)ceilf((float)Gp / cb_segm->C));
+  }
+}
+
+/* Encodes and rate matches a single code block. The TB CRC is accumulated in crc_tb and appended to the last CB */
+static int encode_cb(sch_cb_ctx_t*           ctx,
+                     srsran_crc_t*           crc_tb,
+                     srsran_softbuffer_tx_t* softbuffer,
+                     srsran_cbsegm_t*        cb_segm,
+                     uint32_t                i,
+                     uint32_t                cblen_idx,
+                     uint32_t                rlen,
+                     uint32_t                rp,
+                     uint32_t                rv,
+                     uint8_t*                data,
+                     uint8_t*                e_bits,
+                     uint32_t                e_offset,
+                     uint32_t                n_e)
+{
+  if (data) {
+    bool last_cb = false;
+
+    /* Copy data to another buffer, making space for the Codeblock CRC */
+    if (i < cb_segm->C - 1) {
+      // Copy data
+      memcpy(ctx->cb_in, &data[rp / 8], rlen * sizeof(uint8_t) / 8);
+    } else {
+      INFO("Last CB, appending parity: %d from %d and 24 to %d", rlen - 24, rp, rlen - 24);
+
+      /* Append Transport Block parity bits to the last CB */
+      memcpy(ctx->cb_in, &data[rp / 8], (rlen - 24) * sizeof(uint8_t) / 8);
+      last_cb = true;
+    }
+
+    /* Turbo Encoding
+     * If Codeblock CRC is required it is given the CRC instance pointer, otherwise CRC pointer shall be NULL
+     */
+    srsran_tcod_encode_lut(ctx->encoder,
+                           crc_tb,
+                           (cb_segm->C > 1) ? ctx->crc_cb : NULL,
+                           ctx->cb_in,
+                           ctx->parity_bits,
+                           cblen_idx,
+                           last_cb);
+  }
+  DEBUG("RM cblen_idx=%d, n_e=%d, e_offset=%d", cblen_idx, n_e, e_offset);
+
+  /* Rate matching */
+  if (srsran_rm_turbo_tx_lut(softbuffer->buffer_b[i],
+                             ctx->cb_in,
+                             ctx->parity_bits,
+                             &e_bits[e_offset / 8],
+                             cblen_idx,
+                             n_e,
+                             e_offset % 8,
+                             rv)) {
+    ERROR("Error in rate matching");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Rate dematches and decodes a single code block. Returns the number of turbo decoder iterations or a negative value
+ * if the rate dematching failed. Code blocks are decoded independently, so the result does not depend on whether
+ * they are processed serially or by the pool workers.
+ */
+static int decode_cb(srsran_sch_t*           q,
+                     sch_cb_ctx_t*           ctx,
+                     srsran_softbuffer_rx_t* softbuffer,
+                     srsran_cbsegm_t*        cb_segm,
+                     uint32_t                Qm,
+                     uint32_t                rv,
+                     uint32_t                nof_e_bits,
+                     void*                   e_bits,
+                     uint8_t*                data,
+                     uint32_t                cb_idx)
+{
+  int8_t*  e_bits_b = e_bits;
+  int16_t* e_bits_s = e_bits;
+
+  /* Do not process blocks with CRC Ok */
+  if (softbuffer->cb_crc[cb_idx] == false) {
+    uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
+    uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
+
+    uint32_t rlen  = cb_segm->C == 1 ? cb_len : (cb_len - 24);
+    uint32_t Gp    = nof_e_bits / Qm;
+    uint32_t gamma = cb_segm->C > 0 ? Gp % cb_segm->C : Gp;
+    uint32_t n_e   = Qm * (Gp / cb_segm->C);
+
+    uint32_t rp   = cb_idx * n_e;
+    uint32_t n_e2 = n_e;
+
+    if (cb_idx > cb_segm->C - gamma) {
+      n_e2 = n_e + Qm;
+      rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
+    }
+
+    if (q->llr_is_8bit) {
+      if (srsran_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+        ERROR("Error in rate matching");
+        return SRSRAN_ERROR;
+      }
+    } else {
+      if (srsran_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+        ERROR("Error in rate matching");
+        return SRSRAN_ERROR;
+      }
+    }
+
+    // The decoded code block overlaps with the next one by the CB CRC length, so concurrent contexts decode it apart
+    uint8_t* cb_out = ctx->cb_out ? ctx->cb_out : &data[cb_idx * rlen / 8];
+
+    srsran_tdec_new_cb(ctx->decoder, cb_len);
+
+    // Run iterations and use CRC for early stopping
+    bool     early_stop = false;
+    uint32_t cb_noi     = 0;
+    while (cb_noi < q->max_iterations && !early_stop) {
+      if (q->llr_is_8bit) {
+        srsran_tdec_iteration_8bit(ctx->decoder, (int8_t*)softbuffer->buffer_f[cb_idx], cb_out);
+      } else {
+        srsran_tdec_iteration(ctx->decoder, softbuffer->buffer_f[cb_idx], cb_out);
+      }
+      cb_noi++;
+
+      uint32_t      len_crc;
+      srsran_crc_t* crc_ptr;
+
+      if (cb_segm->C > 1) {
+        len_crc = cb_len;
+        crc_ptr = ctx->crc_cb;
+      } else {
+        len_crc = cb_segm->tbs + 24;
+        crc_ptr = ctx->crc_tb;
+      }
+
+      // CRC is OK and ran the minimum number of iterations
+      if (!srsran_crc_checksum_byte(crc_ptr, cb_out, len_crc) && (cb_noi >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
+        softbuffer->cb_crc[cb_idx] = true;
+        early_stop                 = true;
+      }
+    }
+
+    if (ctx->cb_out) {
+      memcpy(&data[cb_idx * rlen / 8], ctx->cb_out, rlen / 8 * sizeof(uint8_t));
+    }
+
+    INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
+         cb_idx,
+         rp,
+         n_e2,
+         cb_len,
+         early_stop ? "OK" : "KO",
+         rlen,
+         cb_noi,
+         q->max_iterations);
+
+    return (int)cb_noi;
+  }
+
+  // Copy decoded data from previous transmissions
+  uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
+  uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
+  memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+
+  return 0;
+}
+
+/* Takes code blocks of the pool transport block until all of them are processed */
+static void sch_cb_pool_run(sch_cb_pool_t* pool, sch_cb_ctx_t* ctx)
+{
+  srsran_sch_t* q = pool->q;
+
+  ctx->nof_iterations = 0;
+
+  while (true) {
+    pthread_mutex_lock(&pool->mutex);
+    uint32_t i = pool->next_cb++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (i >= pool->cb_segm->C) {
+      break;
+    }
+
+    int ret = SRSRAN_SUCCESS;
+    if (pool->is_encoder) {
+      uint32_t cblen_idx, rlen, n_e;
+      encode_cb_lengths(pool->cb_segm, pool->Qm, pool->nof_e_bits, i, &cblen_idx, &rlen, &n_e);
+
+      // Only the last code block carries the TB CRC, which has been accumulated already with the rest of CBs data
+      srsran_crc_t* crc_tb = (i == pool->cb_segm->C - 1) ? &q->crc_tb : ctx->crc_tb;
+
+      ret = encode_cb(ctx,
+                      crc_tb,
+                      pool->softbuffer_tx,
+                      pool->cb_segm,
+                      i,
+                      cblen_idx,
+                      rlen,
+                      pool->cb_rp[i],
+                      pool->rv,
+                      pool->data,
+                      pool->e_temp,
+                      pool->cb_e_temp_idx[i] * 8,
+                      n_e);
+    } else {
+      ret = decode_cb(q,
+                      ctx,
+                      pool->softbuffer_rx,
+                      pool->cb_segm,
+                      pool->Qm,
+                      pool->rv,
+                      pool->nof_e_bits,
+                      pool->e_bits,
+                      pool->data,
+                      i);
+      if (ret > 0) {
+        ctx->nof_iterations += (uint32_t)ret;
+      }
+    }
+
+    if (ret < SRSRAN_SUCCESS) {
+      pthread_mutex_lock(&pool->mutex);
+      pool->ret = SRSRAN_ERROR;
+      pthread_mutex_unlock(&pool->mutex);
+    }
+  }
+}
+
+static void* sch_cb_worker_thread(void* arg)
+{
+  sch_cb_worker_t* w    = (sch_cb_worker_t*)arg;
+  sch_cb_pool_t*   pool = (sch_cb_pool_t*)w->pool_ptr;
+
+  sem_wait(&w->start);
+  while (!w->quit) {
+    sch_cb_pool_run(pool, &w->ctx);
+
+    /* Post finish semaphore */
+    sem_post(&pool->finish);
+
+    /* Wait for next transport block */
+    sem_wait(&w->start);
+  }
+
+  return NULL;
+}
+
+/* Processes the transport block set in the pool with all the workers and the calling thread. Returns after all the
+ * workers finished, so the result does not depend on the scheduling of the threads. */
+static int sch_cb_pool_process(srsran_sch_t* q, sch_cb_pool_t* pool)
+{
+  pool->q       = q;
+  pool->next_cb = 0;
+  pool->ret     = SRSRAN_SUCCESS;
+
+  pool->caller.encoder     = &q->encoder;
+  pool->caller.decoder     = &q->decoder;
+  pool->caller.crc_tb      = &pool->caller_crc_tb;
+  pool->caller.crc_cb      = &q->crc_cb;
+  pool->caller.cb_in       = q->cb_in;
+  pool->caller.parity_bits = q->parity_bits;
+  pool->caller.cb_out      = pool->caller_cb_out;
+
+  for (uint32_t i = 0; i < pool->nof_workers; i++) {
+    sem_post(&pool->workers[i].start);
+  }
+
+  sch_cb_pool_run(pool, &pool->caller);
+
+  uint32_t nof_iterations = pool->caller.nof_iterations;
+  for (uint32_t i = 0; i < pool->nof_workers; i++) {
+    sem_wait(&pool->finish);
+  }
+  for (uint32_t i = 0; i < pool->nof_workers; i++) {
+    nof_iterations += pool->workers[i].ctx.nof_iterations;
+  }
+  // Encoding leaves the iterations of the last decoded transport block untouched
+  if (!pool->is_encoder) {
+    q->avg_iterations = nof_iterations;
+  }
+
+  return pool->ret;
+}
+
+void srsran_sch_disable_cb_workers(srsran_sch_t* q)
+{
+  sch_cb_pool_t* pool = (sch_cb_pool_t*)q->cb_pool_ptr;
+  if (pool) {
+    /* Stop threads */
+    for (uint32_t i = 0; i < pool->nof_workers; i++) {
+      pool->workers[i].quit = true;
+      sem_post(&pool->workers[i].start);
+      pthread_join(pool->workers[i].pthread, NULL);
+    }
+
+    if (pool->workers) {
+      for (uint32_t i = 0; i < pool->nof_workers; i++) {
+        sch_cb_worker_t* w = &pool->workers[i];
+        // srsran_tcod_free() would release the encoder tables shared with the sch object encoder
+        if (w->encoder.temp) {
+          free(w->encoder.temp);
+        }
+        srsran_tdec_free(&w->decoder);
+        if (w->ctx.cb_in) {
+          free(w->ctx.cb_in);
+        }
+        if (w->ctx.parity_bits) {
+          free(w->ctx.parity_bits);
+        }
+        if (w->ctx.cb_out) {
+          free(w->ctx.cb_out);
+        }
+        sem_destroy(&w->start);
+      }
+      free(pool->workers);
+    }
+    if (pool->caller_cb_out) {
+      free(pool->caller_cb_out);
+    }
+    if (pool->e_temp) {
+      free(pool->e_temp);
+    }
+    sem_destroy(&pool->finish);
+    pthread_mutex_destroy(&pool->mutex);
+
+    free(pool);
+
+    q->cb_pool_ptr = NULL;
+  }
+}
+
+static int sch_cb_worker_init(sch_cb_worker_t* w, sch_cb_pool_t* pool)
+{
+  w->pool_ptr = pool;
+
+  if (srsran_crc_init(&w->crc_tb, SRSRAN_LTE_CRC24A, 24)) {
+    ERROR("Error initiating CRC");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_crc_init(&w->crc_cb, SRSRAN_LTE_CRC24B, 24)) {
+    ERROR("Error initiating CRC");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_tcod_init(&w->encoder, SRSRAN_TCOD_MAX_LEN_CB)) {
+    ERROR("Error initiating Turbo Coder");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_tdec_init(&w->decoder, SRSRAN_TCOD_MAX_LEN_CB)) {
+    ERROR("Error initiating Turbo Decoder");
+    return SRSRAN_ERROR;
+  }
+
+  w->ctx.encoder     = &w->encoder;
+  w->ctx.decoder     = &w->decoder;
+  w->ctx.crc_tb      = &w->crc_tb;
+  w->ctx.crc_cb      = &w->crc_cb;
+  w->ctx.cb_in       = srsran_vec_u8_malloc((SRSRAN_TCOD_MAX_LEN_CB + 8) / 8);
+  w->ctx.parity_bits = srsran_vec_u8_malloc((3 * SRSRAN_TCOD_MAX_LEN_CB + 16) / 8);
+  w->ctx.cb_out      = srsran_vec_u8_malloc((SRSRAN_TCOD_MAX_LEN_CB + 8) / 8);
+  if (!w->ctx.cb_in || !w->ctx.parity_bits || !w->ctx.cb_out) {
+    ERROR("Allocating code block worker buffers");
+    return SRSRAN_ERROR;
+  }
+
+  if (sem_init(&w->start, 0, 0)) {
+    ERROR("Creating semaphore");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_sch_enable_cb_workers(srsran_sch_t* q, uint32_t nof_workers)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_sch_disable_cb_workers(q);
+
+  if (nof_workers == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  sch_cb_pool_t* pool = calloc(sizeof(sch_cb_pool_t), 1);
+  if (!pool) {
+    ERROR("Allocating code block workers");
+    return SRSRAN_ERROR;
+  }
+  q->cb_pool_ptr = pool;
+
+  if (sem_init(&pool->finish, 0, 0)) {
+    ERROR("Creating semaphore");
+    ret = SRSRAN_ERROR;
+    goto clean;
+  }
+  if (pthread_mutex_init(&pool->mutex, NULL)) {
+    ERROR("Creating mutex");
+    ret = SRSRAN_ERROR;
+    goto clean;
+  }
+  if (srsran_crc_init(&pool->caller_crc_tb, SRSRAN_LTE_CRC24A, 24)) {
+    ERROR("Error initiating CRC");
+    ret = SRSRAN_ERROR;
+    goto clean;
+  }
+
+  pool->caller_cb_out = srsran_vec_u8_malloc((SRSRAN_TCOD_MAX_LEN_CB + 8) / 8);
+  pool->e_temp        = srsran_vec_u8_malloc(SCH_MAX_G_BITS / 8 + SRSRAN_MAX_CODEBLOCKS);
+  pool->workers       = calloc(sizeof(sch_cb_worker_t), nof_workers);
+  if (!pool->caller_cb_out || !pool->e_temp || !pool->workers) {
+    ERROR("Allocating code block workers");
+    ret = SRSRAN_ERROR;
+    goto clean;
+  }
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    sch_cb_worker_t* w = &pool->workers[i];
+    if (sch_cb_worker_init(w, pool)) {
+      // Release the resources of the worker which thread has not been created
+      pool->nof_workers = i + 1;
+      w->quit           = true;
+      ret               = SRSRAN_ERROR;
+      goto clean;
+    }
+    if (pthread_create(&w->pthread, NULL, sch_cb_worker_thread, (void*)w)) {
+      ERROR("Creating code block worker thread");
+      pool->nof_workers = i + 1;
+      w->quit           = true;
+      ret               = SRSRAN_ERROR;
+      goto clean;
+    }
+    pool->nof_workers = i + 1;
+  }
+
+clean:
+  if (ret) {
+    srsran_sch_disable_cb_workers(q);
+  }
+  return ret;
+}
+
 /* Encode a transport block according to 36.212 5.3.2
  *
  */
@@ -248,7 +772,7 @@ static int encode_tb_off(srsran_sch_t*           q,
                          uint32_t                w_offset)
 {
   uint32_t i;
-  uint32_t cb_len = 0, rp = 0, wp = 0, rlen = 0, n_e = 0;
+  uint32_t rp = 0, wp = 0, rlen = 0, n_e = 0, cblen_idx = 0;
   int      ret = SRSRAN_ERROR_INVALID_INPUTS;
 
   if (q != NULL && e_bits != NULL && cb_segm != NULL && softbuffer != NULL) {
@@ -267,79 +791,67 @@ static int encode_tb_off(srsran_sch_t*           q,
       return SRSRAN_ERROR;
     }
 
-    uint32_t Gp = nof_e_bits / Qm;
-
-    uint32_t gamma = Gp;
-    if (cb_segm->C > 0) {
-      gamma = Gp % cb_segm->C;
-    }
-
     /* Reset TB CRC */
     srsran_crc_set_init(&q->crc_tb, 0);
 
-    wp = 0;
-    rp = 0;
-    for (i = 0; i < cb_segm->C; i++) {
-      uint32_t cblen_idx;
-      /* Get read lengths */
-      if (i < cb_segm->C2) {
-        cb_len    = cb_segm->K2;
-        cblen_idx = cb_segm->K2_idx;
-      } else {
-        cb_len    = cb_segm->K1;
-        cblen_idx = cb_segm->K1_idx;
+    /* Code blocks are only spread across the workers when there is new data, retransmissions just rate match */
+    sch_cb_pool_t* pool = (sch_cb_pool_t*)q->cb_pool_ptr;
+    if (pool != NULL && data != NULL && cb_segm->C > 1 && cb_segm->C <= SRSRAN_MAX_CODEBLOCKS &&
+        nof_e_bits <= SCH_MAX_G_BITS) {
+      uint32_t e_temp_idx = 0;
+      for (i = 0; i < cb_segm->C; i++) {
+        encode_cb_lengths(cb_segm, Qm, nof_e_bits, i, &cblen_idx, &rlen, &n_e);
+        pool->cb_rp[i]         = rp;
+        pool->cb_n_e[i]        = n_e;
+        pool->cb_e_temp_idx[i] = e_temp_idx;
+
+        /* The TB CRC of all the CBs but the last is computed upfront, the last CB appends it */
+        if (i < cb_segm->C - 1) {
+          for (uint32_t j = 0; j < rlen / 8; j++) {
+            srsran_crc_checksum_put_byte(&q->crc_tb, data[rp / 8 + j]);
+          }
+        }
+
+        rp += rlen;
+        e_temp_idx += SRSRAN_CEIL(n_e, 8);
       }
-      if (cb_segm->C > 1) {
-        rlen = cb_len - 24;
-      } else {
-        rlen = cb_len;
+
+      pool->is_encoder    = true;
+      pool->cb_segm       = cb_segm;
+      pool->softbuffer_tx = softbuffer;
+      pool->Qm            = Qm;
+      pool->rv            = rv;
+      pool->nof_e_bits    = nof_e_bits;
+      pool->data          = data;
+      if (sch_cb_pool_process(q, pool)) {
+        return SRSRAN_ERROR;
       }
-      if (i <= cb_segm->C - gamma - 1) {
-        n_e = Qm * (Gp / cb_segm->C);
-      } else {
-        n_e = Qm * ((uint32_t)ceilf((float)Gp / cb_segm->C));
+
+      /* Rate matched CBs are byte aligned in the temporal buffer, put them together in the output */
+      for (i = 0; i < cb_segm->C; i++) {
+        srsran_bit_copy(e_bits, wp + w_offset, &pool->e_temp[pool->cb_e_temp_idx[i]], 0, pool->cb_n_e[i]);
+        wp += pool->cb_n_e[i];
       }
 
-      INFO("CB#%d: cb_len: %d, rlen: %d, wp: %d, rp: %d, E: %d", i, cb_len, rlen, wp, rp, n_e);
+      INFO("END CB#%d: wp: %d, rp: %d", i, wp, rp);
+      return SRSRAN_SUCCESS;
+    }
 
-      if (data) {
-        bool last_cb = false;
+    sch_cb_ctx_t ctx = {};
+    ctx.encoder      = &q->encoder;
+    ctx.crc_cb       = &q->crc_cb;
+    ctx.cb_in        = q->cb_in;
+    ctx.parity_bits  = q->parity_bits;
 
-        /* Copy data to another buffer, making space for the Codeblock CRC */
-        if (i < cb_segm->C - 1) {
-          // Copy data
-          memcpy(q->cb_in, &data[rp / 8], rlen * sizeof(uint8_t) / 8);
-        } else {
-          INFO("Last CB, appending parity: %d from %d and 24 to %d", rlen - 24, rp, rlen - 24);
+    wp = 0;
+    rp = 0;
+    for (i = 0; i < cb_segm->C; i++) {
+      encode_cb_lengths(cb_segm, Qm, nof_e_bits, i, &cblen_idx, &rlen, &n_e);
 
-          /* Append Transport Block parity bits to the last CB */
-          memcpy(q->cb_in, &data[rp / 8], (rlen - 24) * sizeof(uint8_t) / 8);
-          last_cb = true;
-        }
+      INFO("CB#%d: cblen_idx: %d, rlen: %d, wp: %d, rp: %d, E: %d", i, cblen_idx, rlen, wp, rp, n_e);
 
-        /* Turbo Encoding
-         * If Codeblock CRC is required it is given the CRC instance pointer, otherwise CRC pointer shall be NULL
-         */
-        srsran_tcod_encode_lut(&q->encoder,
-                               &q->crc_tb,
-                               (cb_segm->C > 1) ? &q->crc_cb : NULL,
-                               q->cb_in,
-                               q->parity_bits,
-                               cblen_idx,
-                               last_cb);
-      }
-      DEBUG("RM cblen_idx=%d, n_e=%d, wp=%d, nof_e_bits=%d", cblen_idx, n_e, wp, nof_e_bits);
-
-      /* Rate matching */
-      if (srsran_rm_turbo_tx_lut(softbuffer->buffer_b[i],
-                                 q->cb_in,
-                                 q->parity_bits,
-                                 &e_bits[(wp + w_offset) / 8],
-                                 cblen_idx,
-                                 n_e,
-                                 (wp + w_offset) % 8,
-                                 rv)) {
-        ERROR("Error in rate matching");
+      if (encode_cb(
+              &ctx, &q->crc_tb, softbuffer, cb_segm, i, cblen_idx, rlen, rp, rv, data, e_bits, wp + w_offset, n_e)) {
         return SRSRAN_ERROR;
       }
 
@@ -377,9 +889,6 @@ bool decode_tb_cb(srsran_sch_t*           q,
                   void*                   e_bits,
                   uint8_t*                data)
 {
-  int8_t*  e_bits_b = e_bits;
-  int16_t* e_bits_s = e_bits;
-
   if (cb_segm->C > SRSRAN_MAX_CODEBLOCKS) {
     ERROR("Error SRSRAN_MAX_CODEBLOCKS=%d", SRSRAN_MAX_CODEBLOCKS);
     return false;
@@ -387,89 +896,31 @@ bool decode_tb_cb(srsran_sch_t*           q,
 
   q->avg_iterations = 0;
 
-  for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
-    /* Do not process blocks with CRC Ok */
-    if (softbuffer->cb_crc[cb_idx] == false) {
-      uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
-      uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
-
-      uint32_t rlen  = cb_segm->C == 1 ? cb_len : (cb_len - 24);
-      uint32_t Gp    = nof_e_bits / Qm;
-      uint32_t gamma = cb_segm->C > 0 ? Gp % cb_segm->C : Gp;
-      uint32_t n_e   = Qm * (Gp / cb_segm->C);
-
-      uint32_t rp   = cb_idx * n_e;
-      uint32_t n_e2 = n_e;
-
-      if (cb_idx > cb_segm->C - gamma) {
-        n_e2 = n_e + Qm;
-        rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
-      }
-
-      if (q->llr_is_8bit) {
-        if (srsran_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching");
-          return SRSRAN_ERROR;
-        }
-      } else {
-        if (srsran_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching");
-          return SRSRAN_ERROR;
-        }
+  sch_cb_pool_t* pool = (sch_cb_pool_t*)q->cb_pool_ptr;
+  if (pool != NULL && cb_segm->C > 1) {
+    pool->is_encoder    = false;
+    pool->cb_segm       = cb_segm;
+    pool->softbuffer_rx = softbuffer;
+    pool->Qm            = Qm;
+    pool->rv            = rv;
+    pool->nof_e_bits    = nof_e_bits;
+    pool->e_bits        = e_bits;
+    pool->data          = data;
+    if (sch_cb_pool_process(q, pool)) {
+      return false;
+    }
+  } else {
+    sch_cb_ctx_t ctx = {};
+    ctx.decoder      = &q->decoder;
+    ctx.crc_tb       = &q->crc_tb;
+    ctx.crc_cb       = &q->crc_cb;
+
+    for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
+      int noi = decode_cb(q, &ctx, softbuffer, cb_segm, Qm, rv, nof_e_bits, e_bits, data, cb_idx);
+      if (noi < SRSRAN_SUCCESS) {
+        return false;
       }
-
-      srsran_tdec_new_cb(&q->decoder, cb_len);
-
-      // Run iterations and use CRC for early stopping
-      bool     early_stop = false;
-      uint32_t cb_noi     = 0;
-      do {
-        if (q->llr_is_8bit) {
-          srsran_tdec_iteration_8bit(&q->decoder, (int8_t*)softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        } else {
-          srsran_tdec_iteration(&q->decoder, softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        }
-        q->avg_iterations++;
-        cb_noi++;
-
-        uint32_t      len_crc;
-        srsran_crc_t* crc_ptr;
-
-        if (cb_segm->C > 1) {
-          len_crc = cb_len;
-          crc_ptr = &q->crc_cb;
-        } else {
-          len_crc = cb_segm->tbs + 24;
-          crc_ptr = &q->crc_tb;
-        }
-
-        // CRC is OK and ran the minimum number of iterations
-        if (!srsran_crc_checksum_byte(crc_ptr, &data[cb_idx * rlen / 8], len_crc) &&
-            (cb_noi >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
-          softbuffer->cb_crc[cb_idx] = true;
-          early_stop                 = true;
-
-          // CRC is error and exceeded maximum iterations for this CB.
-          // Early stop the whole transport block.
-        }
-
-      } while (cb_noi < q->max_iterations && !early_stop);
-
-      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
-           cb_idx,
-           rp,
-           n_e2,
-           cb_len,
-           early_stop ? "OK" : "KO",
-           rlen,
-           cb_noi,
-           q->max_iterations);
-
-    } else {
-      // Copy decoded data from previous transmissions
-      uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
-      uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
-      memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+      q->avg_iterations += noi;
     }
   }
 
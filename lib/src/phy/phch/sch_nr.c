@@ -356,6 +356,23 @@ int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
     return SRSRAN_ERROR;
   }
 
+  // Code block workers, they use the same decoder configuration
+  srsran_ldpc_decoder_args_t batch_args = {};
+  batch_args.type                       = decoder_type;
+  batch_args.scaling_fctr               = scaling_factor;
+  batch_args.max_nof_iter               = args->max_nof_iter;
+  if (srsran_ldpc_decoder_batch_init(&q->decoder_batch, &batch_args, args->nof_cb_workers) < SRSRAN_SUCCESS) {
+    ERROR("Error: initialising %d LDPC code block workers", args->nof_cb_workers);
+    return SRSRAN_ERROR;
+  }
+
+  if (args->nof_cb_workers > 0 && !q->temp_cb_batch) {
+    q->temp_cb_batch = srsran_vec_u8_malloc(SRSRAN_SCH_NR_MAX_NOF_CB_LDPC * SRSRAN_LDPC_MAX_LEN_CB);
+    if (!q->temp_cb_batch) {
+      return SRSRAN_ERROR;
+    }
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -381,6 +398,11 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
     free(q->temp_cb);
   }
 
+  srsran_ldpc_decoder_batch_free(&q->decoder_batch);
+  if (q->temp_cb_batch) {
+    free(q->temp_cb_batch);
+  }
+
   for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
     if (q->encoder_bg1[ls]) {
       srsran_ldpc_encoder_free(q->encoder_bg1[ls]);
@@ -551,6 +573,59 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
   return SRSRAN_SUCCESS;
 }
 
+/* Decodes a batch of rate dematched code blocks and collects their results: the CB CRC in the softbuffer, the packed
+ * CB data and the number of iterations */
+static int sch_nr_decode_batch(srsran_sch_nr_t*                q,
+                               const srsran_sch_nr_tb_info_t*  cfg,
+                               const srsran_sch_tb_t*          tb,
+                               srsran_ldpc_decoder_t*          decoder,
+                               srsran_crc_t*                   crc,
+                               srsran_ldpc_decoder_batch_cb_t* batch,
+                               const uint32_t*                 batch_cb_idx,
+                               uint32_t                        batch_size,
+                               uint32_t*                       cb_ok,
+                               uint32_t*                       nof_iter_sum)
+{
+  if (batch_size == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // Decode. if CRC=KO, then ret=0
+  if (srsran_ldpc_decoder_batch_decode_c(&q->decoder_batch, decoder, crc, batch, batch_size) < SRSRAN_SUCCESS) {
+    ERROR("Error decoding CB");
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < batch_size; i++) {
+    uint32_t r   = batch_cb_idx[i];
+    int      ret = batch[i].ret;
+
+    // Compute number of iterations
+    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
+    *nof_iter_sum += n_iter_cb;
+
+    // Check if CB is all zeros
+    uint32_t cb_len = cfg->Kp - cfg->L_cb;
+
+    tb->softbuffer.rx->cb_crc[r] = (ret != 0);
+    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", r, cfg->C, n_iter_cb, tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO");
+
+    // CB Debug trace
+    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+      DEBUG("CB %d/%d:", r, cfg->C);
+      srsran_vec_fprint_hex(stdout, batch[i].message, cb_len);
+    }
+
+    // Pack and count CRC OK only if CRC is match
+    if (tb->softbuffer.rx->cb_crc[r]) {
+      srsran_bit_pack_vector(batch[i].message, tb->softbuffer.rx->data[r], cb_len);
+      (*cb_ok)++;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 static int sch_nr_decode(srsran_sch_nr_t*        q,
                          const srsran_sch_cfg_t* sch_cfg,
                          const srsran_sch_tb_t*  tb,
@@ -607,6 +682,19 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
   uint32_t cb_ok = 0;
   res->crc       = false;
 
+  // Select CB or TB early stop CRC
+  srsran_crc_t* crc = (cfg.L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
+  if (cfg.L_cb) {
+    crc = &q->crc_cb;
+  }
+
+  // Rate dematched code blocks wait in a batch, which is decoded when it is full and after the last code block. With
+  // code block workers a single batch holds all the code blocks of the transport block
+  srsran_ldpc_decoder_batch_cb_t batch[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
+  uint32_t                       batch_cb_idx[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
+  uint32_t                       batch_max_size = q->temp_cb_batch ? SRSRAN_SCH_NR_MAX_NOF_CB_LDPC : 1;
+  uint32_t                       batch_size     = 0;
+
   // For each code block...
   uint32_t j = 0;
   for (uint32_t r = 0; r < cfg.C; r++) {
@@ -630,6 +718,10 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     uint32_t E = sch_nr_get_E(&cfg, j);
     j++;
 
+    // The CB is transmitted, its bits are skipped even if it is already decoded
+    int8_t* cb_input = input_ptr;
+    input_ptr += E;
+
     // Skip CB if it has a matched CRC
     if (decoded) {
       SCH_INFO_RX("RM CB %d: CRC OK ... Skipping", r);
@@ -648,48 +740,34 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
                 cfg.Qm,
                 cfg.Nref);
     int n_llr =
-        srsran_ldpc_rm_rx_c(&q->rx_rm, input_ptr, rm_buffer, E, cfg.F, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
+        srsran_ldpc_rm_rx_c(&q->rx_rm, cb_input, rm_buffer, E, cfg.F, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
     if (n_llr < SRSRAN_SUCCESS) {
       ERROR("Error in LDPC rate mateching");
       return SRSRAN_ERROR;
     }
 
-    // Select CB or TB early stop CRC
-    srsran_crc_t* crc = (cfg.L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
-    if (cfg.L_cb) {
-      crc = &q->crc_cb;
-    }
-
-    // Decode. if CRC=KO, then ret=0
-    int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
-    if (ret < SRSRAN_SUCCESS) {
-      ERROR("Error decoding CB");
-      return SRSRAN_ERROR;
-    }
-
-    // Compute number of iterations
-    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
-    nof_iter_sum += n_iter_cb;
-
-    // Check if CB is all zeros
-    uint32_t cb_len = cfg.Kp - cfg.L_cb;
-
-    tb->softbuffer.rx->cb_crc[r] = (ret != 0);
-    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", r, cfg.C, n_iter_cb, tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO");
-
-    // CB Debug trace
-    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-      DEBUG("CB %d/%d:", r, cfg.C);
-      srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
-    }
+    // Add CB to the batch
+    batch[batch_size].llrs           = rm_buffer;
+    batch[batch_size].message        = (batch_max_size > 1) ? &q->temp_cb_batch[batch_size * SRSRAN_LDPC_MAX_LEN_CB]
+                                                            : q->temp_cb;
+    batch[batch_size].cdwd_rm_length = (uint32_t)n_llr;
+    batch_cb_idx[batch_size]         = r;
+    batch_size++;
 
-    // Pack and count CRC OK only if CRC is match
-    if (tb->softbuffer.rx->cb_crc[r]) {
-      srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
-      cb_ok++;
+    if (batch_size == batch_max_size) {
+      if (sch_nr_decode_batch(q, &cfg, tb, decoder, crc, batch, batch_cb_idx, batch_size, &cb_ok, &nof_iter_sum) <
+          SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+      batch_size = 0;
     }
+  }
 
-    input_ptr += E;
+  // Decode the CBs left in the batch
+  if (batch_size > 0 &&
+      sch_nr_decode_batch(q, &cfg, tb, decoder, crc, batch, batch_cb_idx, batch_size, &cb_ok, &nof_iter_sum) <
+          SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
   }
   // Set average number of iterations
   res->avg_iter = (float)nof_iter_sum / (float)cfg.C;
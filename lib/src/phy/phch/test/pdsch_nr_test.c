@@ -31,10 +31,11 @@
 
 static srsran_carrier_nr_t carrier = SRSRAN_DEFAULT_CARRIER_NR;
 
-static uint32_t            n_prb     = 0;  // Set to 0 for steering
-static uint32_t            mcs       = 30; // Set to 30 for steering
-static srsran_sch_cfg_nr_t pdsch_cfg = {};
-static uint16_t            rnti      = 0x1234;
+static uint32_t            n_prb          = 0;  // Set to 0 for steering
+static uint32_t            mcs            = 30; // Set to 30 for steering
+static srsran_sch_cfg_nr_t pdsch_cfg      = {};
+static uint16_t            rnti           = 0x1234;
+static uint32_t            nof_cb_workers = 0;
 
 void usage(char* prog)
 {
@@ -44,13 +45,14 @@ void usage(char* prog)
   printf("\t-T Provide MCS table (64qam, 256qam, 64qamLowSE) [Default %s]\n",
          srsran_mcs_table_to_str(pdsch_cfg.sch_cfg.mcs_table));
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
+  printf("\t-W Number of code block workers [Default %d]\n", nof_cb_workers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "pmTLv")) != -1) {
+  while ((opt = getopt(argc, argv, "pmTLWv")) != -1) {
     switch (opt) {
       case 'p':
         n_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -64,6 +66,9 @@ int parse_args(int argc, char** argv)
       case 'L':
         carrier.max_mimo_layers = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'W':
+        nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -98,6 +103,7 @@ int main(int argc, char** argv)
 
   srsran_pdsch_nr_args_t pdsch_args = {};
   pdsch_args.sch.disable_simd       = false;
+  pdsch_args.sch.nof_cb_workers     = nof_cb_workers;
   pdsch_args.measure_evm            = true;
 
   if (srsran_pdsch_nr_init_enb(&pdsch_tx, &pdsch_args) < SRSRAN_SUCCESS) {
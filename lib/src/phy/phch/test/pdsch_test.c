@@ -55,6 +55,7 @@ static char*       input_file                   = NULL;
 static int         M                            = 1;
 static bool        enable_256qam                = false;
 static bool        use_8_bit                    = false;
+static uint32_t    nof_cb_workers               = 0;
 
 void usage(char* prog)
 {
@@ -76,6 +77,7 @@ void usage(char* prog)
   printf("\t-p pmi (multiplex only)  [Default %d]\n", pmi);
   printf("\t-w Swap Transport Blocks\n");
   printf("\t-j Enable PDSCH decoder coworker\n");
+  printf("\t-W Number of code block workers [Default %d]\n", nof_cb_workers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
   printf("\t-q Enable/Disable 256QAM modulation (default %s)\n", enable_256qam ? "enabled" : "disabled");
 }
@@ -83,7 +85,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxj")) != -1) {
+  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxjW")) != -1) {
     switch (opt) {
       case 'f':
         input_file = argv[optind];
@@ -136,6 +138,9 @@ void parse_args(int argc, char** argv)
       case 'j':
         enable_coworker = true;
         break;
+      case 'W':
+        nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -342,6 +347,11 @@ int main(int argc, char** argv)
   pdsch_rx.llr_is_8bit        = use_8_bit;
   pdsch_rx.dl_sch.llr_is_8bit = use_8_bit;
 
+  if (srsran_sch_enable_cb_workers(&pdsch_rx.dl_sch, nof_cb_workers)) {
+    ERROR("Error enabling code block workers");
+    goto quit;
+  }
+
   for (uint32_t i = 0; i < SRSRAN_MAX_CODEWORDS; i++) {
     softbuffers_rx[i] = calloc(sizeof(srsran_softbuffer_rx_t), 1);
     if (!softbuffers_rx[i]) {
@@ -386,6 +396,10 @@ int main(int argc, char** argv)
       ERROR("Error creating PDSCH object");
       goto quit;
     }
+    if (srsran_sch_enable_cb_workers(&pdsch_tx.dl_sch, nof_cb_workers)) {
+      ERROR("Error enabling code block workers");
+      goto quit;
+    }
 
     for (uint32_t i = 0; i < SRSRAN_MAX_CODEWORDS; i++) {
       softbuffers_tx[i] = calloc(sizeof(srsran_softbuffer_tx_t), 1);
@@ -36,6 +36,7 @@
  *   - <tt>-n num</tt>: sets the total number of UL PRBs to \c num.
  *   - <tt>-f num</tt>: sets the preamble format to \c num (for now, format 0 only).
  *   - <tt>-s val</tt>: sets the nominal SNR to \c val dB.
+ *   - <tt>-b </tt>: correlates with all the root sequences in one batch.
  *   - <tt>-v </tt>: activates verbose output.
  *
  * Example:
@@ -61,6 +62,7 @@ static uint32_t config_idx = 0;
 static int      nof_runs   = 100;
 static float    snr_dB     = -14.5F;
 static bool     is_verbose = false;
+static bool     batch      = false;
 
 static void usage(char* prog)
 {
@@ -70,12 +72,13 @@ static void usage(char* prog)
   printf("\t-f Preamble format [Default %d]\n", config_idx);
   printf("\t-s SNR in dB [Default %.2f]\n", snr_dB);
   printf("\t-v Activate verbose output [Default %s]\n", is_verbose ? "true" : "false");
+  printf("\t-b Batched detection of all root sequences [Default %s]\n", batch ? "true" : "false");
 }
 
 static void parse_args(int argc, char** argv)
 {
   int opt = 0;
-  while ((opt = getopt(argc, argv, "N:n:f:s:v")) != -1) {
+  while ((opt = getopt(argc, argv, "N:n:f:s:vb")) != -1) {
     switch (opt) {
       case 'N':
         nof_runs = (int)strtol(optarg, NULL, 10);
@@ -92,6 +95,9 @@ static void parse_args(int argc, char** argv)
       case 'v':
         is_verbose = true;
         break;
+      case 'b':
+        batch = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -133,6 +139,7 @@ int main(int argc, char** argv)
   prach_cfg.root_seq_idx           = 22;    // logical (root sequence) index i
   prach_cfg.zero_corr_zone         = 1;     // zero correlation zone -> implies Ncs = 13
   prach_cfg.num_ra_preambles       = 0;     // use default
+  prach_cfg.enable_batch_detection = batch;
   const uint32_t seq_index         = 32;    // sequence index "v"
   const float    prach_scs_kHz     = 1.25F; // PRACH subcarrier spacing (i.e., Delta f^RA)
   const float    max_time_error_us = 1.04F; // time error tolerance
@@ -177,6 +184,9 @@ int main(int argc, char** argv)
   int   false_detection_signal     = 0;
   int   false_detection_noise      = 0;
   int   offset_est_error           = 0;
+  long  detect_time_us             = 0;
+  long  max_detect_time_us         = 0;
+  int   nof_detections             = 0;
 
   // Timing offset base value is equivalent to N_cs/2
   const uint32_t ZC_length           = prach.N_zc; // Zadoff-Chu sequence length (i.e., L_RA)
@@ -209,7 +219,15 @@ int main(int argc, char** argv)
       srsran_vec_cf_copy(symbols, noise_vec, vector_length);
       srsran_vec_sum_ccc(&symbols[offset_samples], preamble, &symbols[offset_samples], preamble_length);
 
+      struct timeval t[3];
+      gettimeofday(&t[1], NULL);
       srsran_prach_detect_offset(&prach, 0, &symbols[prach.N_cp], slot_length, indices, offset_est, NULL, &n_indices);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      long elapsed_us = t[0].tv_sec * 1000000 + t[0].tv_usec;
+      detect_time_us += elapsed_us;
+      max_detect_time_us = SRSRAN_MAX(max_detect_time_us, elapsed_us);
+      nof_detections++;
       false_detection_signal_tmp = 0;
       for (int j = 0; j < n_indices; j++) {
         if (indices[j] != seq_index) {
@@ -256,6 +274,11 @@ int main(int argc, char** argv)
          (float)false_detection_noise / (float)nof_runs,
          false_detection_noise,
          nof_runs);
+  printf("\nDetection time (%s, %d root sequences): average %.1f us, max %ld us\n",
+         batch ? "batched" : "per root",
+         prach.num_ra_preambles,
+         (double)detect_time_us / nof_detections,
+         max_detect_time_us);
 
   srsran_prach_free(&prach);
 
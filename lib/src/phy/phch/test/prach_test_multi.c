@@ -44,10 +44,12 @@ uint32_t zero_corr_zone   = 1;
 uint32_t n_seqs           = 64;
 uint32_t num_ra_preambles = 0; // use default
 
-bool freq_domain_offset_calc       = false;
-bool test_successive_cancellation  = false;
-bool test_offset_calculation       = false;
-bool stagger_prach_power_and_phase = false;
+bool     freq_domain_offset_calc       = false;
+bool     test_successive_cancellation  = false;
+bool     test_offset_calculation       = false;
+bool     stagger_prach_power_and_phase = false;
+bool     batch_detection               = false;
+uint32_t nof_bench_reps                = 0;
 // this will work best with one or two simultaenous prach
 srsran_filesource_t fsrc;
 
@@ -63,12 +65,14 @@ void usage(char* prog)
   printf("\t-s test_successive_cancellation  [Default false]\n");
   printf("\t-O test_offset_calculation  [Default false]\n");
   printf("\t-F freq_domain_offset_calc [Default false]\n");
+  printf("\t-b batch_detection [Default false]\n");
+  printf("\t-B Number of detections timed with each detection method [Default %d]\n", nof_bench_reps);
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "NfrznioSsOF")) != -1) {
+  while ((opt = getopt(argc, argv, "NfrznioSsOFbB")) != -1) {
     switch (opt) {
       case 'N':
         nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -103,6 +107,12 @@ void parse_args(int argc, char** argv)
       case 'F':
         freq_domain_offset_calc = true;
         break;
+      case 'b':
+        batch_detection = true;
+        break;
+      case 'B':
+        nof_bench_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -149,6 +159,32 @@ void stagger_prach_powers(srsran_prach_t* prach,
   }
 }
 
+// Runs the detection nof_bench_reps times and reports the average and worst detection time
+void benchmark_detection(srsran_prach_t* prach, cf_t* signal, uint32_t len)
+{
+  uint32_t indices[64];
+  float    t_offsets[64];
+  uint32_t n_indices = 0;
+  long     total_us  = 0;
+  long     max_us    = 0;
+  for (uint32_t i = 0; i < nof_bench_reps; i++) {
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+    srsran_prach_detect_offset(prach, 0, signal, len, indices, t_offsets, NULL, &n_indices);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    long elapsed_us = t[0].tv_sec * 1000000 + t[0].tv_usec;
+    total_us += elapsed_us;
+    max_us = SRSRAN_MAX(max_us, elapsed_us);
+  }
+  printf("%s detection: N_cs=%d; nof_roots=%d; avg=%.1f us; max=%ld us\n",
+         prach->batch_detection ? "Batched " : "Per-root",
+         prach->N_cs,
+         prach->num_ra_preambles,
+         (double)total_us / nof_bench_reps,
+         max_us);
+}
+
 int main(int argc, char** argv)
 {
   parse_args(argc, argv);
@@ -178,6 +214,7 @@ int main(int argc, char** argv)
   prach_cfg.num_ra_preambles               = num_ra_preambles;
   prach_cfg.enable_successive_cancellation = test_successive_cancellation;
   prach_cfg.enable_freq_domain_offset_calc = freq_domain_offset_calc;
+  prach_cfg.enable_batch_detection         = batch_detection;
 
   int srate   = srsran_sampling_freq_hz(nof_prb);
   int divisor = srate / PRACH_SRATE;
@@ -255,6 +292,44 @@ int main(int argc, char** argv)
       }
     }
   }
+
+  // The per-root and the batched detection find the same preambles
+  srsran_prach_t prach_cmp;
+  prach_cfg.enable_batch_detection = !batch_detection;
+  if (srsran_prach_init(&prach_cmp, srsran_symbol_sz(nof_prb)) ||
+      srsran_prach_set_cfg(&prach_cmp, &prach_cfg, nof_prb)) {
+    ERROR("Error initiating PRACH object");
+    return -1;
+  }
+  srsran_prach_set_detect_factor(&prach_cmp, 10);
+  uint32_t indices_cmp[64];
+  float    t_offsets_cmp[64];
+  uint32_t n_indices_cmp = 0;
+  srsran_prach_detect_offset(
+      &prach_cmp, 0, &preamble_sum[prach.N_cp], prach_len, indices_cmp, t_offsets_cmp, NULL, &n_indices_cmp);
+  if (n_indices_cmp != n_indices) {
+    printf("%d preambles detected with batch_detection=%d, %d otherwise\n", n_indices, batch_detection, n_indices_cmp);
+    err++;
+  } else {
+    for (int i = 0; i < n_indices; i++) {
+      if (indices_cmp[i] != indices[i] || fabsf(t_offsets_cmp[i] - t_offsets[i]) > 1.0f / srate) {
+        printf("preamble %d detected with offset %e, got preamble %d with offset %e with batch_detection=%d\n",
+               indices[i],
+               t_offsets[i],
+               indices_cmp[i],
+               t_offsets_cmp[i],
+               !batch_detection);
+        err++;
+      }
+    }
+  }
+
+  if (nof_bench_reps > 0) {
+    benchmark_detection(&prach, &preamble_sum[prach.N_cp], prach_len);
+    benchmark_detection(&prach_cmp, &preamble_sum[prach.N_cp], prach_len);
+  }
+  srsran_prach_free(&prach_cmp);
+
   if (err) {
     return -1;
   }
@@ -47,15 +47,16 @@ static srsran_uci_offset_cfg_t uci_cfg = {
 
 static srsran_uci_data_t uci_data_tx = {};
 
-uint32_t     L_rb          = 2;
-uint32_t     tbs           = 0;
-uint32_t     subframe      = 10;
-srsran_mod_t modulation    = SRSRAN_MOD_QPSK;
-uint32_t     rv_idx        = 0;
-int          freq_hop      = -1;
-int          riv           = -1;
-uint32_t     mcs_idx       = 0;
-bool         enable_64_qam = false;
+uint32_t     L_rb           = 2;
+uint32_t     tbs            = 0;
+uint32_t     subframe       = 10;
+srsran_mod_t modulation     = SRSRAN_MOD_QPSK;
+uint32_t     rv_idx         = 0;
+int          freq_hop       = -1;
+int          riv            = -1;
+uint32_t     mcs_idx        = 0;
+bool         enable_64_qam  = false;
+uint32_t     nof_cb_workers = 0;
 
 void usage(char* prog)
 {
@@ -84,6 +85,7 @@ void usage(char* prog)
   printf("\n\tOther parameters:\n");
   printf("\t\t-p enable_64qam [Default %s]\n", enable_64_qam ? "enabled" : "disabled");
   printf("\t\t-s number of subframes [Default %d]\n", subframe);
+  printf("\t\t-W number of code block workers [Default %d]\n", nof_cb_workers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
@@ -139,7 +141,7 @@ void parse_extensive_param(char* param, char* arg)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "msLFrncpvf")) != -1) {
+  while ((opt = getopt(argc, argv, "msLFrncpvfW")) != -1) {
     switch (opt) {
       case 'm':
         mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -169,6 +171,9 @@ void parse_args(int argc, char** argv)
         parse_extensive_param(argv[optind], argv[optind + 1]);
         optind++;
         break;
+      case 'W':
+        nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -243,6 +248,11 @@ int main(int argc, char** argv)
     ERROR("Error creating PUSCH object");
     goto quit;
   }
+  if (srsran_sch_enable_cb_workers(&pusch_tx.ul_sch, nof_cb_workers) ||
+      srsran_sch_enable_cb_workers(&pusch_rx.ul_sch, nof_cb_workers)) {
+    ERROR("Error enabling code block workers");
+    goto quit;
+  }
 
   uint16_t rnti = 62;
   dci.rnti      = rnti;
@@ -71,6 +71,39 @@ typedef struct {
 
 static void update_rates(rf_file_handler_t* handler, double srate);
 
+static int rf_file_open_file_opts(void**         h,
+                                  FILE**         rx_files,
+                                  FILE**         tx_files,
+                                  uint32_t       nof_channels,
+                                  uint32_t       base_srate,
+                                  rf_file_opts_t rx_opts,
+                                  rf_file_opts_t tx_opts);
+
+static int parse_format(char* args, const char* config_arg_base, rf_file_format_t* format)
+{
+  char tmp[RF_PARAM_LEN] = {};
+  if (parse_string(args, config_arg_base, -1, tmp) == SRSRAN_SUCCESS) {
+    if (!strcmp(tmp, "sc16")) {
+      *format = FILERF_TYPE_SC16;
+    } else if (!strcmp(tmp, "fc32")) {
+      *format = FILERF_TYPE_FC32;
+    } else {
+      fprintf(stderr, "[file] Error: unsupported sample format %s\n", tmp);
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static bool parse_bool(char* args, const char* config_arg_base, bool default_value)
+{
+  char tmp[RF_PARAM_LEN] = {};
+  if (parse_string(args, config_arg_base, -1, tmp) == SRSRAN_SUCCESS) {
+    return strncmp(tmp, "true", RF_PARAM_LEN) == 0 || strncmp(tmp, "yes", RF_PARAM_LEN) == 0;
+  }
+  return default_value;
+}
+
 void rf_file_info(char* id, const char* format, ...)
 {
 #if VERBOSE
@@ -179,12 +212,26 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
   FILE* tx_files[SRSRAN_MAX_CHANNELS] = {NULL};
 
   if (h && nof_channels <= SRSRAN_MAX_CHANNELS) {
-    uint32_t base_srate = FILE_BASERATE_DEFAULT_HZ;
+    uint32_t       base_srate = FILE_BASERATE_DEFAULT_HZ;
+    rf_file_opts_t rx_opts    = {};
+    rf_file_opts_t tx_opts    = {};
 
     // parse args
     if (args && strlen(args)) {
       // base_srate
       parse_uint32(args, "base_srate", -1, &base_srate);
+
+      // rx_format, tx_format
+      if (parse_format(args, "rx_format", &rx_opts.sample_format) != SRSRAN_SUCCESS ||
+          parse_format(args, "tx_format", &tx_opts.sample_format) != SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+
+      // rx_loop: restart from the beginning of the rx files when they end, timestamps keep increasing
+      rx_opts.loop = parse_bool(args, "rx_loop", false);
+
+      // rx_mmap: read regular files through a memory mapping
+      rx_opts.use_mmap = parse_bool(args, "rx_mmap", true);
     } else {
       fprintf(stderr, "[file] Error: RF device args are required for file-based no-RF module\n");
       goto clean_exit;
@@ -219,7 +266,7 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
     }
 
     // defer further initialization to open_file method
-    ret = rf_file_open_file(h, rx_files, tx_files, nof_channels, base_srate);
+    ret = rf_file_open_file_opts(h, rx_files, tx_files, nof_channels, base_srate, rx_opts, tx_opts);
     if (ret != SRSRAN_SUCCESS) {
       goto clean_exit;
     }
@@ -243,6 +290,20 @@ clean_exit:
 }
 
 int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate)
+{
+  rf_file_opts_t rx_opts = {};
+  rf_file_opts_t tx_opts = {};
+  rx_opts.use_mmap       = true;
+  return rf_file_open_file_opts(h, rx_files, tx_files, nof_channels, base_srate, rx_opts, tx_opts);
+}
+
+static int rf_file_open_file_opts(void**         h,
+                                  FILE**         rx_files,
+                                  FILE**         tx_files,
+                                  uint32_t       nof_channels,
+                                  uint32_t       base_srate,
+                                  rf_file_opts_t rx_opts,
+                                  rf_file_opts_t tx_opts)
 {
   int ret = SRSRAN_ERROR;
 
@@ -264,10 +325,8 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     handler->nof_channels     = nof_channels;
     strcpy(handler->id, "file\0");
 
-    rf_file_opts_t rx_opts = {};
-    rf_file_opts_t tx_opts = {};
-    tx_opts.id             = handler->id;
-    rx_opts.id             = handler->id;
+    tx_opts.id = handler->id;
+    rx_opts.id = handler->id;
 
     if (pthread_mutex_init(&handler->tx_config_mutex, NULL)) {
       fprintf(stderr, "Mutex init: %s\n", strerror(errno));
@@ -289,11 +348,6 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     // id
     // TODO: set some meaningful ID in handler->id
 
-    // rx_format, tx_format
-    // TODO: add other formats
-    rx_opts.sample_format = FILERF_TYPE_FC32;
-    tx_opts.sample_format = FILERF_TYPE_FC32;
-
     update_rates(handler, 1.92e6);
 
     // Create channels
@@ -696,7 +750,7 @@ int rf_file_recv_with_time_multi(void*    h,
     pthread_mutex_unlock(&handler->rx_gain_mutex);
     // scale shall also incorporate decim_factor
     scale = scale / decim_factor;
-    for (uint32_t c = 0; c < handler->nof_channels; c++) {
+    for (uint32_t c = 0; c < handler->nof_channels && scale != 1.0f; c++) {
       if (buffers[c]) {
         srsran_vec_sc_prod_cfc(buffers[c], scale, buffers[c], nsamples);
       }
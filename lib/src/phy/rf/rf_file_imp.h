@@ -64,14 +64,17 @@ SRSRAN_API void rf_file_register_error_handler(void* h, srsran_rf_error_handler_
 SRSRAN_API int rf_file_open(char* args, void** h);
 
 /**
- * @brief This function is not supported for file-based RF abstraction
+ * @brief Opens the file-based RF abstraction with the files given in the device arguments
  *
- * Use @c rf_file_open_file() to open this device
+ * Besides rx_file[N], tx_file[N] and base_srate, the arguments accept:
+ * - rx_format, tx_format: sample format of the files, fc32 (default) or sc16
+ * - rx_loop: restart from the beginning of the rx files when they end, without resetting the rx timestamp
+ * - rx_mmap: read regular rx files through a memory mapping with read-ahead (default true)
  *
- * @param args not used
- * @param h not used
- * @param nof_channels not used
- * @return SRSRAN_ERROR_INVALID_COMMAND
+ * @param args device arguments
+ * @param h resulting object handle
+ * @param nof_channels number of channels per direction
+ * @return SRSRAN_SUCCESS on success, otherwise error code
  */
 SRSRAN_API int rf_file_open_multi(char* args, void** h, uint32_t nof_channels);
 
@@ -137,6 +140,8 @@ SRSRAN_API int rf_file_send_timed_multi(void*  h,
  * @param[in] nof_channels Number of channels per direction
  * @param[in] base_srate Sample rate of RX and TX files
  * @return SRSRAN_SUCCESS on success, otherwise error code
+ *
+ * Samples are fc32. RX files that are regular files are read through a memory mapping
  */
 SRSRAN_API int
 rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate);
@@ -20,9 +20,71 @@
  */
 
 #include "rf_file_imp_trx.h"
+#include <errno.h>
+#include <inttypes.h>
 #include <srsran/phy/utils/vector.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t rf_file_rx_sample_sz(rf_file_rx_t* q)
+{
+  return (q->sample_format == FILERF_TYPE_SC16) ? 2 * sizeof(int16_t) : sizeof(cf_t);
+}
+
+// Maps the whole file, or extends the mapping if the file has grown since it was mapped
+static int rf_file_rx_map(rf_file_rx_t* q)
+{
+  struct stat st = {};
+  if (fstat(fileno(q->file), &st) < 0) {
+    rf_file_error(q->id, "[file] Error: stat rx file. %s.\n", strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  if ((size_t)st.st_size <= q->map_len) {
+    return SRSRAN_SUCCESS;
+  }
+
+  if (q->map) {
+    munmap(q->map, q->map_len);
+    q->map     = NULL;
+    q->map_len = 0;
+  }
+
+  void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(q->file), 0);
+  if (map == MAP_FAILED) {
+    rf_file_error(q->id, "[file] Error: mapping rx file. %s.\n", strerror(errno));
+    return SRSRAN_ERROR;
+  }
+  madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+  q->map          = (uint8_t*)map;
+  q->map_len      = (size_t)st.st_size;
+  q->prefetch_pos = q->map_pos;
+
+  return SRSRAN_SUCCESS;
+}
+
+// Keeps FILE_PREFETCH_NBYTES ahead of the read position in the page cache, so that the reception does not stall on
+// disk reads, and releases the pages that have already been read unless they are read again when looping
+static void rf_file_rx_prefetch(rf_file_rx_t* q)
+{
+  const size_t page_sz = (size_t)sysconf(_SC_PAGESIZE);
+
+  if (q->prefetch_pos >= q->map_len || q->prefetch_pos > q->map_pos + FILE_PREFETCH_NBYTES / 2) {
+    return;
+  }
+
+  size_t begin = q->map_pos & ~(page_sz - 1);
+  size_t end   = SRSRAN_MIN(q->map_pos + FILE_PREFETCH_NBYTES, q->map_len);
+  madvise(q->map + begin, end - begin, MADV_WILLNEED);
+  if (!q->loop && begin > 0) {
+    madvise(q->map, begin, MADV_DONTNEED);
+  }
+  q->prefetch_pos = end;
+}
 
 int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
 {
@@ -42,6 +104,24 @@ int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
     // Configure formats
     q->sample_format = opts.sample_format;
     q->frequency_mhz = opts.frequency_mhz;
+    q->loop          = opts.loop;
+
+    // Samples start at the current position of the file
+    q->start_offset = ftello(q->file);
+    if (q->start_offset < 0) {
+      q->start_offset = 0;
+    }
+
+    // Only regular files can be mapped, pipes and devices are read with fread
+    struct stat st = {};
+    if (opts.use_mmap && fstat(fileno(q->file), &st) == 0 && S_ISREG(st.st_mode)) {
+      q->use_mmap = true;
+      q->map_pos  = (size_t)q->start_offset;
+      if (rf_file_rx_map(q) != SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+      rf_file_rx_prefetch(q);
+    }
 
     q->temp_buffer = srsran_vec_malloc(FILE_MAX_BUFFER_SIZE);
     if (!q->temp_buffer) {
@@ -69,16 +149,71 @@ clean_exit:
   return ret;
 }
 
-int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
+static int rf_file_rx_baseband_mmap(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
 {
-  uint32_t sample_sz = sizeof(cf_t);
+  size_t sample_sz = rf_file_rx_sample_sz(q);
+
+  if (q->map_pos + sample_sz > q->map_len) {
+    // Pick up samples appended to the file since it was mapped
+    if (rf_file_rx_map(q) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+    // Rewind if there is at least one sample to loop over
+    if (q->map_pos + sample_sz > q->map_len && q->loop && q->start_offset + sample_sz <= q->map_len) {
+      rf_file_info(q->id, " - Rewinding rx file after %" PRIu64 " samples.\n", q->nsamples);
+      q->map_pos      = (size_t)q->start_offset;
+      q->prefetch_pos = q->map_pos;
+    }
+    if (q->map_pos + sample_sz > q->map_len) {
+      return SRSRAN_ERROR_RX_EOF;
+    }
+  }
 
-  int ret = fread(buffer, sample_sz, nsamples, q->file);
-  if (ret > 0) {
-    return ret;
+  uint32_t n   = (uint32_t)SRSRAN_MIN((size_t)nsamples, (q->map_len - q->map_pos) / sample_sz);
+  uint8_t* src = q->map + q->map_pos;
+
+  // Convert straight from the mapping into the destination buffer
+  if (q->sample_format == FILERF_TYPE_SC16) {
+    srsran_vec_convert_if((int16_t*)src, INT16_MAX, (float*)buffer, 2 * n);
   } else {
+    memcpy(buffer, src, NSAMPLES2NBYTES(n));
+  }
+
+  q->map_pos += n * sample_sz;
+  rf_file_rx_prefetch(q);
+
+  return (int)n;
+}
+
+static int rf_file_rx_baseband_fread(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  size_t sample_sz = rf_file_rx_sample_sz(q);
+  void*  buf       = (q->sample_format == FILERF_TYPE_SC16) ? q->temp_buffer_convert : (void*)buffer;
+
+  // The conversion buffer holds as many sc16 samples as FILE_MAX_BUFFER_SIZE fc32 samples
+  size_t ret = fread(buf, sample_sz, nsamples, q->file);
+  if (ret == 0 && q->loop && fseeko(q->file, q->start_offset, SEEK_SET) == 0) {
+    rf_file_info(q->id, " - Rewinding rx file after %" PRIu64 " samples.\n", q->nsamples);
+    ret = fread(buf, sample_sz, nsamples, q->file);
+  }
+  if (ret == 0) {
     return SRSRAN_ERROR_RX_EOF;
   }
+
+  if (q->sample_format == FILERF_TYPE_SC16) {
+    srsran_vec_convert_if((int16_t*)buf, INT16_MAX, (float*)buffer, 2 * (uint32_t)ret);
+  }
+
+  return (int)ret;
+}
+
+int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  int n = q->use_mmap ? rf_file_rx_baseband_mmap(q, buffer, nsamples) : rf_file_rx_baseband_fread(q, buffer, nsamples);
+  if (n > 0) {
+    q->nsamples += n;
+  }
+  return n;
 }
 
 bool rf_file_rx_match_freq(rf_file_rx_t* q, uint32_t freq_hz)
@@ -103,5 +238,10 @@ void rf_file_rx_close(rf_file_rx_t* q)
     free(q->temp_buffer_convert);
   }
 
+  if (q->map) {
+    munmap(q->map, q->map_len);
+    q->map = NULL;
+  }
+
   // not touching q->file as we don't know if we need to close it ourselves
 }
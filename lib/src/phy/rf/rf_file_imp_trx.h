@@ -28,12 +28,15 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/types.h>
 
 /* Definitions */
 #define VERBOSE (0)
 #define NSAMPLES2NBYTES(X) (((uint32_t)(X)) * sizeof(cf_t))
 #define NBYTES2NSAMPLES(X) ((X) / sizeof(cf_t))
 #define FILE_MAX_BUFFER_SIZE (NSAMPLES2NBYTES(3072000)) // 10 subframes at 20 MHz
+// Read-ahead of mapped rx files, ~130 ms of fc32 samples at 30.72 MHz
+#define FILE_PREFETCH_NBYTES (32 * 1024 * 1024)
 #define FILE_TIMEOUT_MS (1000)
 #define FILE_BASERATE_DEFAULT_HZ (23040000)
 #define FILE_ID_STRLEN 16
@@ -66,6 +69,13 @@ typedef struct {
   cf_t*            temp_buffer;
   void*            temp_buffer_convert;
   uint32_t         frequency_mhz;
+  bool             loop;         // rewind to the first sample at the end of the file
+  off_t            start_offset; // file offset of the first sample
+  bool             use_mmap;     // read through a memory mapping of the file instead of fread
+  uint8_t*         map;
+  size_t           map_len;
+  size_t           map_pos;      // offset of the next sample to read within the mapping
+  size_t           prefetch_pos; // end of the range already advised for read-ahead
 } rf_file_rx_t;
 
 typedef struct {
@@ -73,6 +83,8 @@ typedef struct {
   rf_file_format_t sample_format;
   FILE*            file;
   uint32_t         frequency_mhz;
+  bool             loop;
+  bool             use_mmap;
 } rf_file_opts_t;
 
 /*
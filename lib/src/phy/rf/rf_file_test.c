@@ -28,6 +28,7 @@
 #include <srsran/phy/common/phy_common.h>
 #include <srsran/phy/utils/vector.h>
 #include <stdlib.h>
+#include <sys/time.h>
 
 #define PRINT_SAMPLES 0
 #define COMPARE_BITS 0
@@ -38,6 +39,12 @@
 #define RF_BUFFER_SIZE (SF_LEN * NUM_SF)
 #define TX_OFFSET_MS (4)
 
+// 100 PRB cell with 2 rx antennas, looping over files slightly longer than 10 subframes
+#define LOOP_SRATE (30.72e6)
+#define LOOP_SF_LEN (30720)
+#define LOOP_NOF_ANT 2
+#define LOOP_FILE_LEN (10 * LOOP_SF_LEN + 1000)
+
 static cf_t ue_rx_buffer[NOF_RX_ANT][RF_BUFFER_SIZE];
 static cf_t enb_tx_buffer[NOF_RX_ANT][RF_BUFFER_SIZE];
 static cf_t enb_rx_buffer[NOF_RX_ANT][RF_BUFFER_SIZE];
@@ -231,6 +238,101 @@ int param_test(const char* args_param, const int num_channels)
   return SRSRAN_SUCCESS;
 }
 
+int loop_test(const char* format, bool use_mmap, uint32_t nof_sf)
+{
+  int   ret                     = SRSRAN_ERROR;
+  cf_t* pattern[LOOP_NOF_ANT]   = {};
+  cf_t* rx_buffer[LOOP_NOF_ANT] = {};
+  char  rf_args[RF_PARAM_LEN]   = {};
+
+  for (uint32_t c = 0; c < LOOP_NOF_ANT; c++) {
+    pattern[c]   = srsran_vec_cf_malloc(LOOP_FILE_LEN);
+    rx_buffer[c] = srsran_vec_cf_malloc(LOOP_SF_LEN);
+    for (uint32_t i = 0; i < LOOP_FILE_LEN; i++) {
+      pattern[c][i] = (2.0f * rand() / (float)RAND_MAX - 1.0f) + _Complex_I * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+    }
+  }
+
+  // write the files in the given format
+  snprintf(rf_args,
+           RF_PARAM_LEN,
+           "tx_file=tx_file0,tx_file=tx_file1,base_srate=30.72e6,tx_format=%s",
+           format);
+  printf("opening tx device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&enb_radio, "file", rf_args, LOOP_NOF_ANT)) {
+    fprintf(stderr, "Error opening rf\n");
+    goto exit;
+  }
+  srsran_rf_set_tx_srate(&enb_radio, LOOP_SRATE);
+  for (uint32_t i = 0; i < LOOP_FILE_LEN; i += LOOP_SF_LEN) {
+    void* data_ptr[SRSRAN_MAX_PORTS] = {pattern[0] + i, pattern[1] + i};
+    srsran_rf_send_multi(&enb_radio, data_ptr, SRSRAN_MIN(LOOP_SF_LEN, LOOP_FILE_LEN - i), true, true, false);
+  }
+  srsran_rf_close(&enb_radio);
+
+  // read them in a loop, subframe by subframe
+  snprintf(rf_args,
+           RF_PARAM_LEN,
+           "rx_file=tx_file0,rx_file=tx_file1,base_srate=30.72e6,rx_format=%s,rx_loop=true,rx_mmap=%s",
+           format,
+           use_mmap ? "true" : "false");
+  printf("opening rx device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&ue_radio, "file", rf_args, LOOP_NOF_ANT)) {
+    fprintf(stderr, "Error opening rf\n");
+    goto exit;
+  }
+  srsran_rf_set_rx_srate(&ue_radio, LOOP_SRATE);
+
+  float          epsilon = strcmp(format, "sc16") ? COMPARE_EPSILON : 2.0f / INT16_MAX;
+  uint64_t       rx_usec = 0;
+  struct timeval t[3]    = {};
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    srsran_timestamp_t rx_time                    = {};
+    void*              data_ptr[SRSRAN_MAX_PORTS] = {rx_buffer[0], rx_buffer[1]};
+
+    gettimeofday(&t[1], NULL);
+    int n =
+        srsran_rf_recv_with_time_multi(&ue_radio, data_ptr, LOOP_SF_LEN, true, &rx_time.full_secs, &rx_time.frac_secs);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    rx_usec += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+    // Timestamps keep increasing across the rewinds
+    if (n != LOOP_SF_LEN || srsran_timestamp_uint64(&rx_time, LOOP_SRATE) != (uint64_t)sf * LOOP_SF_LEN) {
+      fprintf(stderr, "Error receiving subframe %d (n=%d)\n", sf, n);
+      goto exit;
+    }
+
+    for (uint32_t c = 0; c < LOOP_NOF_ANT; c++) {
+      for (uint32_t i = 0; i < LOOP_SF_LEN; i++) {
+        if (cabsf(rx_buffer[c][i] - pattern[c][((uint64_t)sf * LOOP_SF_LEN + i) % LOOP_FILE_LEN]) > epsilon) {
+          fprintf(stderr, "data mismatch in subframe %d, channel %d, sample %d\n", sf, c, i);
+          goto exit;
+        }
+      }
+    }
+  }
+  srsran_rf_close(&ue_radio);
+
+  printf("format=%s; mmap=%s; rx %d subframes of %dx%d samples in %.1f ms (%.1fx real time)\n",
+         format,
+         use_mmap ? "yes" : "no",
+         nof_sf,
+         LOOP_NOF_ANT,
+         LOOP_SF_LEN,
+         rx_usec / 1000.0,
+         nof_sf * 1000.0 / SRSRAN_MAX(rx_usec, 1));
+
+  ret = SRSRAN_SUCCESS;
+
+exit:
+  for (uint32_t c = 0; c < LOOP_NOF_ANT; c++) {
+    free(pattern[c]);
+    free(rx_buffer[c]);
+  }
+  return ret;
+}
+
 void create_file(const char* filename)
 {
   FILE* f = fopen(filename, "w");
@@ -242,8 +344,13 @@ void remove_file(const char* filename)
   remove(filename);
 }
 
-int main()
+int main(int argc, char** argv)
 {
+  uint32_t nof_loop_sf = 100;
+  if (argc > 1 && strcmp(argv[1], "benchmark") == 0) {
+    nof_loop_sf = 10000;
+  }
+
   // create files for testing
   create_file("rx_file0");
   create_file("rx_file1");
@@ -320,6 +427,16 @@ int main()
     return -1;
   }
 
+  // rx files read in a loop, in both sample formats and with both readers
+  for (uint32_t i = 0; i < 4; i++) {
+    const char* format   = (i / 2) ? "sc16" : "fc32";
+    bool        use_mmap = (i % 2) == 0;
+    if (loop_test(format, use_mmap, nof_loop_sf) != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Loop test failed (format=%s, mmap=%s)!\n", format, use_mmap ? "yes" : "no");
+      return -1;
+    }
+  }
+
   // clean workspace
   remove_file("rx_file0");
   remove_file("rx_file1");
@@ -0,0 +1,211 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Maps the segment of the transmitter, if it exists and differs from the one already mapped
+static int rf_shm_rx_attach(rf_shm_rx_t* q)
+{
+  int fd = shm_open(q->name, O_RDWR, 0);
+  if (fd < 0) {
+    return SRSRAN_ERROR;
+  }
+
+  struct stat st = {};
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(rf_shm_ring_t) || (q->ring && st.st_ino == q->inode)) {
+    close(fd);
+    return SRSRAN_ERROR;
+  }
+
+  void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    rf_shm_error(q->id, "[shm] Error: mapping receiver segment %s: %s\n", q->name, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  // The transmitter may still be initialising the segment
+  rf_shm_ring_t* ring = (rf_shm_ring_t*)ptr;
+  if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+      SHM_SEGMENT_NBYTES(ring->nof_samples) > (size_t)st.st_size) {
+    munmap(ptr, (size_t)st.st_size);
+    return SRSRAN_ERROR;
+  }
+
+  if (q->ring) {
+    rf_shm_info(q->id, "Transmitter of %s restarted, attaching to the new segment\n", q->name);
+    munmap(q->ring, q->ring_nbytes);
+  }
+  q->ring        = ring;
+  q->ring_nbytes = (size_t)st.st_size;
+  q->inode       = st.st_ino;
+
+  rf_shm_info(q->id, "Attached receiver: %s (%d samples)\n", q->name, ring->nof_samples);
+
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, const char* name)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (q && name) {
+    // Zero object
+    bzero(q, sizeof(rf_shm_rx_t));
+
+    // Copy id
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->id[SHM_ID_STRLEN - 1] = '\0';
+
+    // POSIX shared memory names start with a slash
+    snprintf(q->name, RF_PARAM_LEN, "%s%s", name[0] == '/' ? "" : "/", name);
+
+    q->frequency_mhz      = opts.frequency_mhz;
+    q->fail_on_disconnect = opts.fail_on_disconnect;
+    q->trx_timeout_ms     = opts.trx_timeout_ms;
+    q->log_trx_timeout    = opts.log_trx_timeout;
+
+    if (pthread_mutex_init(&q->mutex, NULL)) {
+      fprintf(stderr, "Error: creating mutex\n");
+      goto clean_exit;
+    }
+
+    // The transmitter may not be running yet, the segment is attached on reception otherwise
+    rf_shm_rx_attach(q);
+
+    q->running = true;
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  return ret;
+}
+
+static uint64_t rf_shm_elapsed_ms(const struct timespec* start)
+{
+  struct timespec now = {};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)(now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+int rf_shm_rx_baseband(rf_shm_rx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  struct timespec start         = {};
+  uint64_t        next_check_ms = 0;
+  uint32_t        nof_waits     = 0;
+
+  while (rf_shm_rx_is_running(q)) {
+    rf_shm_ring_t* ring = q->ring;
+
+    if (ring) {
+      uint64_t read_ts  = __atomic_load_n(&ring->read_ts, __ATOMIC_RELAXED);
+      uint64_t write_ts = __atomic_load_n(&ring->write_ts, __ATOMIC_ACQUIRE);
+
+      if (write_ts > read_ts) {
+        // Copy the available samples, in two parts if they wrap around the end of the ring
+        cf_t*    samples = SHM_RING_SAMPLES(ring);
+        uint32_t idx     = (uint32_t)(read_ts & (ring->nof_samples - 1));
+        uint32_t n       = (uint32_t)SRSRAN_MIN((uint64_t)nsamples, write_ts - read_ts);
+        uint32_t first   = SRSRAN_MIN(n, ring->nof_samples - idx);
+        srsran_vec_cf_copy(buffer, &samples[idx], first);
+        srsran_vec_cf_copy(&buffer[first], samples, n - first);
+
+        // Release the room to the transmitter
+        __atomic_store_n(&ring->read_ts, read_ts + n, __ATOMIC_RELEASE);
+        q->nsamples += n;
+        return (int)n;
+      }
+    }
+
+    // Nothing to read yet, spin for a while before sleeping
+    if (nof_waits++ < SHM_SPIN_COUNT) {
+      sched_yield();
+      continue;
+    }
+    if (nof_waits == SHM_SPIN_COUNT + 1) {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+    usleep(SHM_SLEEP_US);
+
+    uint64_t elapsed_ms = rf_shm_elapsed_ms(&start);
+    if (elapsed_ms >= next_check_ms) {
+      // Attach to the segment if the transmitter has just created it, or re-created it after a restart
+      rf_shm_rx_attach(q);
+      next_check_ms = elapsed_ms + SHM_REATTACH_MS;
+    }
+    if (q->trx_timeout_ms && elapsed_ms >= q->trx_timeout_ms) {
+      return SRSRAN_ERROR_TIMEOUT;
+    }
+  }
+
+  return SRSRAN_ERROR;
+}
+
+bool rf_shm_rx_match_freq(rf_shm_rx_t* q, uint32_t freq_hz)
+{
+  bool ret = false;
+  if (q) {
+    ret = (q->frequency_mhz == 0 || q->frequency_mhz == freq_hz);
+  }
+  return ret;
+}
+
+void rf_shm_rx_close(rf_shm_rx_t* q)
+{
+  rf_shm_info(q->id, "Closing ...\n");
+
+  pthread_mutex_lock(&q->mutex);
+  q->running = false;
+  pthread_mutex_unlock(&q->mutex);
+
+  pthread_mutex_destroy(&q->mutex);
+
+  if (q->ring) {
+    munmap(q->ring, q->ring_nbytes);
+    q->ring = NULL;
+  }
+}
+
+bool rf_shm_rx_is_running(rf_shm_rx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  bool ret = false;
+  pthread_mutex_lock(&q->mutex);
+  ret = q->running;
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
+}
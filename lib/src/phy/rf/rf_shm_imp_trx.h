@@ -0,0 +1,144 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RF_SHM_IMP_TRX_H
+#define SRSRAN_RF_SHM_IMP_TRX_H
+
+#include "srsran/config.h"
+#include "srsran/phy/rf/rf.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/* Definitions */
+#define VERBOSE (0)
+#define NSAMPLES2NBYTES(X) (((uint32_t)(X)) * sizeof(cf_t))
+#define NBYTES2NSAMPLES(X) ((X) / sizeof(cf_t))
+#define SHM_MAX_BUFFER_SIZE (NSAMPLES2NBYTES(3072000)) // 10 subframes at 20 MHz
+#define SHM_RING_NSAMPLES (1U << 20)                   // default ring capacity, 8.5 ms at 122.88 MHz
+#define SHM_TIMEOUT_MS (2000)
+#define SHM_BASERATE_DEFAULT_HZ (23040000)
+#define SHM_ID_STRLEN 16
+#define SHM_MAX_GAIN_DB (30.0f)
+#define SHM_MIN_GAIN_DB (0.0f)
+#define SHM_MAGIC (0x73727368) // "srsh"
+#define SHM_CACHE_LINE 64
+#define SHM_SPIN_COUNT 64     // yields before sleeping while waiting on the other end of a ring
+#define SHM_SLEEP_US 20       // sleep between polls of a ring after spinning
+#define SHM_REATTACH_MS 10    // period of the receiver checks for a new segment while waiting for samples
+#define SHM_MAX_NSAMPLES (1U << 28)
+
+/*
+ * Layout of the shared memory segment of a channel: a header followed by a single-producer single-consumer ring of
+ * fc32 samples. The sample with timestamp ts is stored at samples[ts % nof_samples]. The transmitter owns write_ts
+ * and the receiver owns read_ts, each in its own cache line, so that no locks are shared between the processes.
+ */
+typedef struct {
+  uint32_t magic;       // written last by the transmitter, once the segment is initialised
+  uint32_t nof_samples; // ring capacity, power of two
+  uint32_t base_srate;
+  uint8_t  reserved0[SHM_CACHE_LINE - 3 * sizeof(uint32_t)];
+  uint64_t write_ts; // timestamp of the next sample the transmitter writes
+  uint8_t  reserved1[SHM_CACHE_LINE - sizeof(uint64_t)];
+  uint64_t read_ts; // timestamp of the next sample the receiver reads
+  uint8_t  reserved2[SHM_CACHE_LINE - sizeof(uint64_t)];
+} rf_shm_ring_t;
+
+#define SHM_RING_SAMPLES(R) ((cf_t*)((uint8_t*)(R) + sizeof(rf_shm_ring_t)))
+#define SHM_SEGMENT_NBYTES(N) (sizeof(rf_shm_ring_t) + NSAMPLES2NBYTES(N))
+
+typedef struct {
+  char            id[SHM_ID_STRLEN];
+  char            name[RF_PARAM_LEN];
+  rf_shm_ring_t*  ring;
+  size_t          ring_nbytes;
+  uint64_t        nsamples;
+  bool            running;
+  pthread_mutex_t mutex;
+  uint32_t        frequency_mhz;
+} rf_shm_tx_t;
+
+typedef struct {
+  char            id[SHM_ID_STRLEN];
+  char            name[RF_PARAM_LEN];
+  rf_shm_ring_t*  ring; // NULL until the transmitter has created the segment
+  size_t          ring_nbytes;
+  ino_t           inode; // identifies the segment, to detect that the transmitter has re-created it
+  uint64_t        nsamples;
+  bool            running;
+  pthread_mutex_t mutex;
+  uint32_t        frequency_mhz;
+  bool            fail_on_disconnect;
+  uint32_t        trx_timeout_ms;
+  bool            log_trx_timeout;
+} rf_shm_rx_t;
+
+typedef struct {
+  const char* id;
+  uint32_t    frequency_mhz;
+  uint32_t    nof_samples;
+  uint32_t    base_srate;
+  bool        fail_on_disconnect;
+  uint32_t    trx_timeout_ms;
+  bool        log_trx_timeout;
+} rf_shm_opts_t;
+
+/*
+ * Common functions
+ */
+SRSRAN_API void rf_shm_info(char* id, const char* format, ...);
+
+SRSRAN_API void rf_shm_error(char* id, const char* format, ...);
+
+/*
+ * Transmitter functions
+ */
+SRSRAN_API int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, const char* name);
+
+SRSRAN_API int rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts);
+
+SRSRAN_API int rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, float gain, uint32_t nsamples);
+
+SRSRAN_API uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q);
+
+SRSRAN_API int rf_shm_tx_zeros(rf_shm_tx_t* q, uint32_t nsamples);
+
+SRSRAN_API bool rf_shm_tx_match_freq(rf_shm_tx_t* q, uint32_t freq_hz);
+
+SRSRAN_API void rf_shm_tx_close(rf_shm_tx_t* q);
+
+SRSRAN_API bool rf_shm_tx_is_running(rf_shm_tx_t* q);
+
+/*
+ * Receiver functions
+ */
+SRSRAN_API int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, const char* name);
+
+SRSRAN_API int rf_shm_rx_baseband(rf_shm_rx_t* q, cf_t* buffer, uint32_t nsamples);
+
+SRSRAN_API bool rf_shm_rx_match_freq(rf_shm_rx_t* q, uint32_t freq_hz);
+
+SRSRAN_API void rf_shm_rx_close(rf_shm_rx_t* q);
+
+SRSRAN_API bool rf_shm_rx_is_running(rf_shm_rx_t* q);
+
+#endif // SRSRAN_RF_SHM_IMP_TRX_H
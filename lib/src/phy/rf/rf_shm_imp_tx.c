@@ -0,0 +1,232 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <srsran/config.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, const char* name)
+{
+  int ret = SRSRAN_ERROR;
+  int fd  = -1;
+
+  if (q && name) {
+    // Zero object
+    bzero(q, sizeof(rf_shm_tx_t));
+
+    // Copy id
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->id[SHM_ID_STRLEN - 1] = '\0';
+
+    // POSIX shared memory names start with a slash
+    snprintf(q->name, RF_PARAM_LEN, "%s%s", name[0] == '/' ? "" : "/", name);
+
+    q->frequency_mhz = opts.frequency_mhz;
+
+    // Ring capacity must be a power of two
+    uint32_t nof_samples = 1;
+    while (nof_samples < SRSRAN_MIN(opts.nof_samples, SHM_MAX_NSAMPLES)) {
+      nof_samples <<= 1;
+    }
+
+    rf_shm_info(q->id, "Creating transmitter: %s (%d samples)\n", q->name, nof_samples);
+
+    // Replace any segment left by a previous run, so that receivers never attach to stale samples
+    shm_unlink(q->name);
+    fd = shm_open(q->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      fprintf(stderr, "[shm] Error: creating transmitter segment %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+
+    q->ring_nbytes = SHM_SEGMENT_NBYTES(nof_samples);
+    if (ftruncate(fd, (off_t)q->ring_nbytes) < 0) {
+      fprintf(stderr, "[shm] Error: sizing transmitter segment %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+
+    void* ptr = mmap(NULL, q->ring_nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      fprintf(stderr, "[shm] Error: mapping transmitter segment %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+    q->ring = (rf_shm_ring_t*)ptr;
+
+    // The segment is zero filled, publish the header once it is complete
+    q->ring->nof_samples = nof_samples;
+    q->ring->base_srate  = opts.base_srate;
+    __atomic_store_n(&q->ring->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+
+    if (pthread_mutex_init(&q->mutex, NULL)) {
+      fprintf(stderr, "Error: creating mutex\n");
+      goto clean_exit;
+    }
+
+    q->running = true;
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  if (fd >= 0) {
+    close(fd);
+  }
+  return ret;
+}
+
+static int _rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, float gain, uint32_t nsamples)
+{
+  rf_shm_ring_t* ring      = q->ring;
+  cf_t*          samples   = SHM_RING_SAMPLES(ring);
+  uint64_t       mask      = ring->nof_samples - 1;
+  uint32_t       count     = 0;
+  uint32_t       nof_waits = 0;
+
+  while (count < nsamples && __atomic_load_n(&q->running, __ATOMIC_RELAXED)) {
+    // Wait for the receiver to free room in the ring, as the ZMQ transmitter waits for a request
+    uint64_t read_ts = __atomic_load_n(&ring->read_ts, __ATOMIC_ACQUIRE);
+    uint64_t space   = ring->nof_samples - (q->nsamples - read_ts);
+    if (space == 0) {
+      if (nof_waits++ < SHM_SPIN_COUNT) {
+        sched_yield();
+      } else {
+        usleep(SHM_SLEEP_US);
+      }
+      continue;
+    }
+    nof_waits = 0;
+
+    // Write up to the end of the ring, the rest goes in the next iteration
+    uint32_t idx = (uint32_t)(q->nsamples & mask);
+    uint32_t n   = (uint32_t)SRSRAN_MIN(SRSRAN_MIN((uint64_t)(nsamples - count), space), ring->nof_samples - idx);
+    if (buffer == NULL) {
+      srsran_vec_cf_zero(&samples[idx], n);
+    } else if (gain == 1.0f) {
+      srsran_vec_cf_copy(&samples[idx], &buffer[count], n);
+    } else {
+      srsran_vec_sc_prod_cfc(&buffer[count], gain, &samples[idx], n);
+    }
+
+    // Publish the samples
+    q->nsamples += n;
+    count += n;
+    __atomic_store_n(&ring->write_ts, q->nsamples, __ATOMIC_RELEASE);
+  }
+
+  return (int)count;
+}
+
+int rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts)
+{
+  pthread_mutex_lock(&q->mutex);
+
+  int64_t nsamples = (int64_t)ts - (int64_t)q->nsamples;
+
+  if (nsamples > 0) {
+    rf_shm_info(q->id, " - Detected Tx gap of %d samples.\n", nsamples);
+    _rf_shm_tx_baseband(q, NULL, 1.0f, (uint32_t)nsamples);
+  }
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return (int)nsamples;
+}
+
+int rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, float gain, uint32_t nsamples)
+{
+  pthread_mutex_lock(&q->mutex);
+  int n = _rf_shm_tx_baseband(q, buffer, gain, nsamples);
+  pthread_mutex_unlock(&q->mutex);
+
+  return n;
+}
+
+uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q)
+{
+  pthread_mutex_lock(&q->mutex);
+  uint64_t ret = q->nsamples;
+  pthread_mutex_unlock(&q->mutex);
+  return ret;
+}
+
+int rf_shm_tx_zeros(rf_shm_tx_t* q, uint32_t nsamples)
+{
+  pthread_mutex_lock(&q->mutex);
+
+  rf_shm_info(q->id, " - Tx %d Zeros.\n", nsamples);
+  _rf_shm_tx_baseband(q, NULL, 1.0f, nsamples);
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return (int)nsamples;
+}
+
+bool rf_shm_tx_match_freq(rf_shm_tx_t* q, uint32_t freq_hz)
+{
+  bool ret = false;
+  if (q) {
+    ret = (q->frequency_mhz == 0 || q->frequency_mhz == freq_hz);
+  }
+  return ret;
+}
+
+void rf_shm_tx_close(rf_shm_tx_t* q)
+{
+  if (!q->ring) {
+    return;
+  }
+
+  rf_shm_info(q->id, "Closing ...\n");
+
+  // Release a transmission waiting for room in the ring before taking the mutex
+  __atomic_store_n(&q->running, false, __ATOMIC_RELAXED);
+  pthread_mutex_lock(&q->mutex);
+  pthread_mutex_unlock(&q->mutex);
+
+  pthread_mutex_destroy(&q->mutex);
+
+  // Receivers keep their mapping, the name is released for the next run
+  munmap(q->ring, q->ring_nbytes);
+  q->ring = NULL;
+  shm_unlink(q->name);
+}
+
+bool rf_shm_tx_is_running(rf_shm_tx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  bool ret = false;
+  pthread_mutex_lock(&q->mutex);
+  ret = q->running;
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
+}
@@ -0,0 +1,371 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp.h"
+#include "srsran/common/tsan_options.h"
+#include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/utils/debug.h"
+#include <complex.h>
+#include <pthread.h>
+#include <srsran/phy/common/phy_common.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define COMPARE_EPSILON (1e-6f)
+#define NOF_RX_ANT 4
+#define NUM_SF (500)
+#define SF_LEN (1920)
+#define RF_BUFFER_SIZE (SF_LEN * NUM_SF)
+#define TX_OFFSET_MS (4)
+
+// 100 MHz NR carrier with 2 antennas, exchanging 0.5 ms slots in both directions
+#define NR_SRATE (122.88e6)
+#define NR_SLOT_LEN (61440)
+#define NR_NOF_ANT 2
+#define NR_TX_OFFSET_SLOTS (4)
+
+static cf_t ue_rx_buffer[NOF_RX_ANT][RF_BUFFER_SIZE];
+static cf_t enb_tx_buffer[NOF_RX_ANT][RF_BUFFER_SIZE];
+
+static srsran_rf_t ue_radio, enb_radio;
+pthread_t          rx_thread;
+
+void* ue_rx_thread_function(void* args)
+{
+  char rf_args[RF_PARAM_LEN];
+  strncpy(rf_args, (char*)args, RF_PARAM_LEN - 1);
+  rf_args[RF_PARAM_LEN - 1] = 0;
+
+  printf("opening rx device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&ue_radio, "shm", rf_args, NOF_RX_ANT)) {
+    fprintf(stderr, "Error opening rf\n");
+    exit(-1);
+  }
+  srsran_rf_set_rx_srate(&ue_radio, 1.92e6);
+
+  // receive 5 subframes at once (i.e. mimic initial rx that receives one slot)
+  uint32_t num_slots          = NUM_SF / 5;
+  uint32_t num_samps_per_slot = SF_LEN * 5;
+  uint32_t num_rxed_samps     = 0;
+  for (uint32_t i = 0; i < num_slots; ++i) {
+    void* data_ptr[SRSRAN_MAX_PORTS] = {NULL};
+    for (uint32_t c = 0; c < NOF_RX_ANT; c++) {
+      data_ptr[c] = &ue_rx_buffer[c][i * num_samps_per_slot];
+    }
+    srsran_timestamp_t rx_time = {};
+    int                n       = srsran_rf_recv_with_time_multi(
+        &ue_radio, data_ptr, num_samps_per_slot, true, &rx_time.full_secs, &rx_time.frac_secs);
+    if (n != num_samps_per_slot || srsran_timestamp_uint64(&rx_time, 1.92e6) != num_rxed_samps) {
+      fprintf(stderr, "Error receiving slot %d (n=%d)\n", i, n);
+      exit(-1);
+    }
+    num_rxed_samps += n;
+  }
+
+  printf("received %d samples.\n", num_rxed_samps);
+
+  printf("closing ue shm device\n");
+  srsran_rf_close(&ue_radio);
+
+  return NULL;
+}
+
+void enb_tx_function(const char* tx_args)
+{
+  char rf_args[RF_PARAM_LEN];
+  strncpy(rf_args, tx_args, RF_PARAM_LEN - 1);
+  rf_args[RF_PARAM_LEN - 1] = 0;
+
+  printf("opening tx device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&enb_radio, "shm", rf_args, NOF_RX_ANT)) {
+    fprintf(stderr, "Error opening rf\n");
+    exit(-1);
+  }
+  srsran_rf_set_tx_srate(&enb_radio, 1.92e6);
+
+  // generate random tx data
+  for (int c = 0; c < NOF_RX_ANT; c++) {
+    for (int i = 0; i < RF_BUFFER_SIZE; i++) {
+      enb_tx_buffer[c][i] = ((float)rand() / (float)RAND_MAX) + _Complex_I * ((float)rand() / (float)RAND_MAX);
+    }
+  }
+
+  // all transmissions are timed, the first TX_OFFSET_MS subframes are filled with zeros
+  void* data_ptr[SRSRAN_MAX_PORTS] = {NULL};
+  for (uint32_t i = 0; i < NUM_SF - TX_OFFSET_MS; ++i) {
+    for (int c = 0; c < NOF_RX_ANT; c++) {
+      data_ptr[c] = &enb_tx_buffer[c][i * SF_LEN];
+    }
+
+    srsran_timestamp_t tx_time = {};
+    srsran_timestamp_init_uint64(&tx_time, (uint64_t)(i + TX_OFFSET_MS) * SF_LEN, 1.92e6);
+    int ret = srsran_rf_send_timed_multi(
+        &enb_radio, (void**)data_ptr, SF_LEN, tx_time.full_secs, tx_time.frac_secs, true, true, false);
+    if (ret != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending data\n");
+      exit(-1);
+    }
+  }
+
+  printf("transmitted %d subframes\n", NUM_SF - TX_OFFSET_MS);
+
+  printf("closing tx device\n");
+  srsran_rf_close(&enb_radio);
+}
+
+// The receiver runs in its own thread, it is started before the transmitter creates the segments
+int run_test(const char* rx_args, const char* tx_args)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (pthread_create(&rx_thread, NULL, ue_rx_thread_function, (void*)rx_args)) {
+    perror("pthread_create");
+    exit(-1);
+  }
+
+  enb_tx_function(tx_args);
+
+  pthread_join(rx_thread, NULL);
+
+  // channel-wise comparison, the rx buffer starts with TX_OFFSET_MS zero subframes
+  for (int c = 0; c < NOF_RX_ANT; c++) {
+    uint32_t max_ix = srsran_vec_max_abs_ci(ue_rx_buffer[c], TX_OFFSET_MS * SF_LEN);
+    if (cabsf(ue_rx_buffer[c][max_ix]) > COMPARE_EPSILON) {
+      fprintf(stderr, "data before the first transmission at channel %d\n", c);
+      goto exit;
+    }
+
+    cf_t* rx = &ue_rx_buffer[c][TX_OFFSET_MS * SF_LEN];
+    srsran_vec_sub_ccc(rx, enb_tx_buffer[c], rx, (NUM_SF - TX_OFFSET_MS) * SF_LEN);
+    max_ix = srsran_vec_max_abs_ci(rx, (NUM_SF - TX_OFFSET_MS) * SF_LEN);
+    if (cabsf(rx[max_ix]) > COMPARE_EPSILON) {
+      fprintf(stderr, "data mismatch in subframe %d at channel %d\n", max_ix / SF_LEN + TX_OFFSET_MS, c);
+      goto exit;
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+exit:
+  return ret;
+}
+
+int param_test(const char* args_param, const int num_channels)
+{
+  char rf_args[RF_PARAM_LEN] = {};
+  strncpy(rf_args, (char*)args_param, RF_PARAM_LEN - 1);
+  rf_args[RF_PARAM_LEN - 1] = 0;
+
+  printf("opening tx device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&enb_radio, "shm", rf_args, num_channels)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_rf_close(&enb_radio);
+
+  return SRSRAN_SUCCESS;
+}
+
+// Slot that a radio transmits, distinct for each direction and channel. The first sample tags the slot index
+static void nr_slot_fill(cf_t* buffer, bool dl, uint32_t c, uint32_t slot)
+{
+  for (uint32_t i = 1; i < NR_SLOT_LEN; i++) {
+    buffer[i] = (float)(i % 4093) + _Complex_I * (float)(2 * c + (dl ? 0 : 1));
+  }
+  buffer[0] = (float)slot;
+}
+
+/*
+ * Runs a radio that receives nof_slots slots and, after each of them, transmits a slot NR_TX_OFFSET_SLOTS ahead, as
+ * the PHY does. Returns the time spent in microseconds, or 0 on error.
+ */
+static uint64_t nr_radio_function(const char* rf_args, bool dl, uint32_t nof_slots)
+{
+  srsran_rf_t    radio                 = {};
+  cf_t*          tx_buffer[NR_NOF_ANT] = {};
+  cf_t*          rx_buffer[NR_NOF_ANT] = {};
+  cf_t*          expected[NR_NOF_ANT]  = {};
+  uint64_t       usec                  = 0;
+  struct timeval t[3]                  = {};
+
+  if (srsran_rf_open_devname(&radio, "shm", (char*)rf_args, NR_NOF_ANT)) {
+    fprintf(stderr, "Error opening rf\n");
+    return 0;
+  }
+  srsran_rf_set_rx_srate(&radio, NR_SRATE);
+  srsran_rf_set_tx_srate(&radio, NR_SRATE);
+
+  for (uint32_t c = 0; c < NR_NOF_ANT; c++) {
+    tx_buffer[c] = srsran_vec_cf_malloc(NR_SLOT_LEN);
+    rx_buffer[c] = srsran_vec_cf_malloc(NR_SLOT_LEN);
+    expected[c]  = srsran_vec_cf_malloc(NR_SLOT_LEN);
+    nr_slot_fill(tx_buffer[c], dl, c, 0);
+    nr_slot_fill(expected[c], !dl, c, 0);
+  }
+
+  gettimeofday(&t[1], NULL);
+  for (uint32_t slot = 0; slot < nof_slots; slot++) {
+    srsran_timestamp_t rx_time = {};
+    int                n       = srsran_rf_recv_with_time_multi(
+        &radio, (void**)rx_buffer, NR_SLOT_LEN, true, &rx_time.full_secs, &rx_time.frac_secs);
+    uint64_t           rx_ts   = (uint64_t)slot * NR_SLOT_LEN;
+    if (n != NR_SLOT_LEN || srsran_timestamp_uint64(&rx_time, NR_SRATE) != rx_ts) {
+      fprintf(stderr, "Error receiving slot %d (n=%d)\n", slot, n);
+      goto clean_exit;
+    }
+
+    // The other radio starts transmitting NR_TX_OFFSET_SLOTS after the beginning
+    for (uint32_t c = 0; c < NR_NOF_ANT; c++) {
+      bool match;
+      if (slot < NR_TX_OFFSET_SLOTS) {
+        match = rx_buffer[c][srsran_vec_max_abs_ci(rx_buffer[c], NR_SLOT_LEN)] == 0.0f;
+      } else {
+        expected[c][0] = (float)slot;
+        match          = memcmp(rx_buffer[c], expected[c], sizeof(cf_t) * NR_SLOT_LEN) == 0;
+      }
+      if (!match) {
+        fprintf(stderr, "data mismatch in slot %d, channel %d\n", slot, c);
+        goto clean_exit;
+      }
+    }
+
+    uint64_t tx_ts = rx_ts + NR_TX_OFFSET_SLOTS * NR_SLOT_LEN;
+    for (uint32_t c = 0; c < NR_NOF_ANT; c++) {
+      tx_buffer[c][0] = (float)(slot + NR_TX_OFFSET_SLOTS);
+    }
+    srsran_timestamp_t tx_time = {};
+    srsran_timestamp_init_uint64(&tx_time, tx_ts, NR_SRATE);
+    if (srsran_rf_send_timed_multi(
+            &radio, (void**)tx_buffer, NR_SLOT_LEN, tx_time.full_secs, tx_time.frac_secs, true, true, false) !=
+        SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending slot %d\n", slot);
+      goto clean_exit;
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  usec = SRSRAN_MAX(t[0].tv_sec * 1000000UL + t[0].tv_usec, 1);
+
+clean_exit:
+  srsran_rf_close(&radio);
+  for (uint32_t c = 0; c < NR_NOF_ANT; c++) {
+    free(tx_buffer[c]);
+    free(rx_buffer[c]);
+    free(expected[c]);
+  }
+  return usec;
+}
+
+// The gNB and the UE radios run in different processes, exchanging samples in both directions
+int process_test(uint32_t nof_slots)
+{
+  char dl_args[RF_PARAM_LEN] = {};
+  char ul_args[RF_PARAM_LEN] = {};
+  int  pid                   = (int)getpid();
+
+  snprintf(dl_args,
+           RF_PARAM_LEN,
+           "id=gnb,tx_shm=rf_shm_test_dl0_%d,tx_shm=rf_shm_test_dl1_%d,rx_shm=rf_shm_test_ul0_%d,"
+           "rx_shm=rf_shm_test_ul1_%d,base_srate=122.88e6,fail_on_disconnect=true",
+           pid,
+           pid,
+           pid,
+           pid);
+  snprintf(ul_args,
+           RF_PARAM_LEN,
+           "id=ue,tx_shm=rf_shm_test_ul0_%d,tx_shm=rf_shm_test_ul1_%d,rx_shm=rf_shm_test_dl0_%d,"
+           "rx_shm=rf_shm_test_dl1_%d,base_srate=122.88e6,fail_on_disconnect=true",
+           pid,
+           pid,
+           pid,
+           pid);
+
+  fflush(stdout);
+  pid_t child = fork();
+  if (child < 0) {
+    perror("fork");
+    return SRSRAN_ERROR;
+  }
+  if (child == 0) {
+    exit(nr_radio_function(ul_args, false, nof_slots) ? 0 : 1);
+  }
+
+  uint64_t usec   = nr_radio_function(dl_args, true, nof_slots);
+  int      status = 0;
+  waitpid(child, &status, 0);
+  if (usec == 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "Error exchanging samples between processes\n");
+    return SRSRAN_ERROR;
+  }
+
+  printf("srate=%.2f MHz; exchanged %d slots of %dx%d samples in each direction in %.1f ms (%.1fx real time)\n",
+         NR_SRATE / 1e6,
+         nof_slots,
+         NR_NOF_ANT,
+         NR_SLOT_LEN,
+         usec / 1000.0,
+         nof_slots * 500.0 / usec);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t nof_nr_slots = 200;
+  if (argc > 1 && strcmp(argv[1], "benchmark") == 0) {
+    nof_nr_slots = 20000;
+  }
+
+  // one TX and one RX segment
+  if (param_test("tx_shm=rf_shm_param_tx0,rx_shm=rf_shm_param_rx0", 1)) {
+    fprintf(stderr, "Param test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  // two TX, two RX, and all generic options
+  if (param_test("tx_shm0=rf_shm_param_tx0,tx_shm1=rf_shm_param_tx1,rx_shm0=rf_shm_param_rx0,"
+                 "rx_shm1=rf_shm_param_rx1,base_srate=23.04e6,ring_size=1000000,trx_timeout_ms=100",
+                 2)) {
+    fprintf(stderr, "Param test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  // four channels with decimation and timed tx, through rings smaller than the transmitted samples
+  if (run_test("rx_shm=rf_shm_test0,rx_shm=rf_shm_test1,rx_shm=rf_shm_test2,rx_shm=rf_shm_test3,base_srate=23.04e6",
+               "tx_shm=rf_shm_test0,tx_shm=rf_shm_test1,tx_shm=rf_shm_test2,tx_shm=rf_shm_test3,base_srate=23.04e6,"
+               "ring_size=100000") != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Single tx, multi rx test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (process_test(nof_nr_slots) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Inter-process test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  fprintf(stdout, "Test passed!\n");
+
+  return SRSRAN_SUCCESS;
+}
@@ -407,7 +407,19 @@ void srsran_vec_convert_if_simd(const int16_t* x, float* z, const float scale, c
   int         i    = 0;
   const float gain = 1.0f / scale;
 
-#ifdef LV_HAVE_SSE
+#if defined(LV_HAVE_AVX512)
+  __m512 s = _mm512_set1_ps(gain);
+  for (; i < len - 15; i += 16) {
+    __m512i in = _mm512_cvtepi16_epi32(_mm256_loadu_si256((__m256i*)&x[i]));
+    _mm512_storeu_ps(&z[i], _mm512_mul_ps(_mm512_cvtepi32_ps(in), s));
+  }
+#elif defined(LV_HAVE_AVX2)
+  __m256 s = _mm256_set1_ps(gain);
+  for (; i < len - 7; i += 8) {
+    __m256i in = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&x[i]));
+    _mm256_storeu_ps(&z[i], _mm256_mul_ps(_mm256_cvtepi32_ps(in), s));
+  }
+#elif defined(LV_HAVE_SSE)
   __m128 s = _mm_set1_ps(gain);
   if (SRSRAN_IS_ALIGNED(z)) {
     for (; i < len - 3; i += 4) {
@@ -360,7 +360,7 @@ void rlc_am_lte_tx::retransmit_pdu(uint32_t sn)
   rlc_amd_retx_lte_t& retx = retx_queue.push();
   retx.is_segment          = false;
   retx.so_start            = 0;
-  retx.so_end              = pdu.buf->N_bytes;
+  retx.so_end              = pdu.buf.length();
   retx.sn                  = pdu.rlc_sn;
 }
 
@@ -491,7 +491,7 @@ int rlc_am_lte_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   // Set poll bit
   pdu_without_poll++;
-  byte_without_poll += (tx_window[retx.sn].buf->N_bytes + rlc_am_packed_length(&new_header));
+  byte_without_poll += (tx_window[retx.sn].buf.length() + rlc_am_packed_length(&new_header));
   RlcInfo("pdu_without_poll: %d", pdu_without_poll);
   RlcInfo("byte_without_poll: %d", byte_without_poll);
   if (poll_required()) {
@@ -508,32 +508,32 @@ int rlc_am_lte_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&new_header, &ptr);
-  memcpy(ptr, tx_window[retx.sn].buf->msg, tx_window[retx.sn].buf->N_bytes);
+  tx_window[retx.sn].buf.copy_to(ptr);
 
   retx_queue.pop();
 
   RlcHexInfo(payload,
-             tx_window[retx.sn].buf->N_bytes,
+             tx_window[retx.sn].buf.length(),
              "Tx PDU SN=%d (%d B) (attempt %d/%d)",
              retx.sn,
-             tx_window[retx.sn].buf->N_bytes,
+             tx_window[retx.sn].buf.length(),
              tx_window[retx.sn].retx_count + 1,
              cfg.max_retx_thresh);
   log_rlc_amd_pdu_header_to_string(logger.debug, rb_name, "Tx PDU - %s", new_header);
 
   debug_state();
-  return (ptr - payload) + tx_window[retx.sn].buf->N_bytes;
+  return (ptr - payload) + tx_window[retx.sn].buf.length();
 }
 
 int rlc_am_lte_tx::build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_retx_lte_t retx)
 {
-  if (tx_window[retx.sn].buf == NULL) {
+  if (tx_window[retx.sn].buf.empty()) {
     RlcError("In build_segment: retx.sn=%d has null buffer", retx.sn);
     return 0;
   }
   if (!retx.is_segment) {
     retx.so_start = 0;
-    retx.so_end   = tx_window[retx.sn].buf->N_bytes;
+    retx.so_end   = tx_window[retx.sn].buf.length();
   }
 
   // Construct new header
@@ -541,7 +541,7 @@ int rlc_am_lte_tx::build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_r
   rlc_amd_pdu_header_t old_header = tx_window[retx.sn].header;
 
   pdu_without_poll++;
-  byte_without_poll += (tx_window[retx.sn].buf->N_bytes + rlc_am_packed_length(&new_header));
+  byte_without_poll += (tx_window[retx.sn].buf.length() + rlc_am_packed_length(&new_header));
   RlcInfo("pdu_without_poll: %d, byte_without_poll: %d", pdu_without_poll, byte_without_poll);
 
   new_header.dc   = RLC_DC_FIELD_DATA_PDU;
@@ -641,7 +641,7 @@ int rlc_am_lte_tx::build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_r
   srsran_expect(head_len + (retx.so_end - retx.so_start) <= nof_bytes, "The provided buffer was overflown.");
 
   // Update retx_queue
-  if (tx_window[retx.sn].buf->N_bytes == retx.so_end) {
+  if (tx_window[retx.sn].buf.length() == retx.so_end) {
     retx_queue.pop();
     new_header.lsf = 1;
     if (rlc_am_end_aligned(old_header.fi)) {
@@ -669,9 +669,7 @@ int rlc_am_lte_tx::build_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_r
   // Write header and pdu
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&new_header, &ptr);
-  uint8_t* data = &tx_window[retx.sn].buf->msg[retx.so_start];
-  uint32_t len  = retx.so_end - retx.so_start;
-  memcpy(ptr, data, len);
+  uint32_t len = tx_window[retx.sn].buf.copy_to(ptr, retx.so_start, retx.so_end - retx.so_start);
 
   debug_state();
   int pdu_len = (ptr - payload) + len;
@@ -716,23 +714,6 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
     return 0;
   }
 
-  unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == NULL) {
-#ifdef RLC_AM_BUFFER_DEBUG
-    srsran::console("Fatal Error: Could not allocate PDU in build_data_pdu()\n");
-    srsran::console("tx_window size: %zd PDUs\n", tx_window.size());
-    srsran::console("vt_a = %d, vt_ms = %d, vt_s = %d, poll_sn = %d\n", vt_a, vt_ms, vt_s, poll_sn);
-    srsran::console("retx_queue size: %zd PDUs\n", retx_queue.size());
-    std::map<uint32_t, rlc_amd_tx_pdu>::iterator txit;
-    for (txit = tx_window.begin(); txit != tx_window.end(); txit++) {
-      srsran::console("tx_window - SN=%d\n", txit->first);
-    }
-    exit(-1);
-#else
-    RlcError("Fatal Error: Couldn't allocate PDU in build_data_pdu().");
-    return 0;
-#endif
-  }
   rlc_amd_pdu_header_t header = {};
   header.dc                   = RLC_DC_FIELD_DATA_PDU;
   header.fi                   = RLC_FI_FIELD_START_AND_END_ALIGNED;
@@ -750,18 +731,15 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
   uint32_t head_len  = rlc_am_packed_length(&header);
   uint32_t to_move   = 0;
   uint32_t last_li   = 0;
-  uint32_t pdu_space = SRSRAN_MIN(nof_bytes, pdu->get_tailroom());
-  uint8_t* pdu_ptr   = pdu->msg;
+  uint32_t pdu_space = nof_bytes;
 
   RlcDebug("Building PDU - pdu_space: %d, head_len: %d ", pdu_space, head_len);
 
   // Check for SDU segment
   if (tx_sdu != nullptr) {
     to_move = ((pdu_space - head_len) >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : pdu_space - head_len;
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
+    tx_pdu.buf.append(tx_sdu, tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
     tx_sdu->N_bytes -= to_move;
     tx_sdu->msg += to_move;
     if (undelivered_sdu_info_queue.has_pdcp_sn(tx_sdu->md.pdcp_sn)) {
@@ -780,7 +758,7 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
       tx_sdu.reset();
     }
     if (pdu_space > to_move) {
-      pdu_space -= SRSRAN_MIN(to_move, pdu->get_tailroom());
+      pdu_space -= to_move;
     } else {
       pdu_space = 0;
     }
@@ -793,11 +771,21 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
              header.sn);
   }
 
+  // A full chain still takes the next SDU if it is small enough to be copied into its last segment
+  auto chain_has_room = [this, &tx_pdu]() {
+    if (not tx_pdu.buf.full()) {
+      return true;
+    }
+    uint32_t next_sdu_len = tx_sdu_queue.size_tail_bytes();
+    return next_sdu_len > 0 and tx_pdu.buf.can_append(next_sdu_len);
+  };
+
   // Pull SDUs from queue
-  while (pdu_space > head_len && tx_sdu_queue.get_n_sdus() > 0 && header.N_li < MAX_SDUS_PER_PDU) {
+  while (pdu_space > head_len && tx_sdu_queue.get_n_sdus() > 0 && header.N_li < MAX_SDUS_PER_PDU &&
+         chain_has_room()) {
     if (not segment_pool.has_segments()) {
       RlcInfo("Can't build a PDU segment - No segment resources available");
-      if (pdu_ptr != pdu->msg) {
+      if (not tx_pdu.buf.empty()) {
         break; // continue with the segments created up to this point
       }
       tx_window.remove_pdu(tx_pdu.rlc_sn);
@@ -837,10 +825,8 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
     pdcp_pdu_info_lte& pdcp_pdu = undelivered_sdu_info_queue[tx_sdu->md.pdcp_sn];
 
     to_move = ((pdu_space - head_len) >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : pdu_space - head_len;
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
+    tx_pdu.buf.append(tx_sdu, tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
     tx_sdu->N_bytes -= to_move;
     tx_sdu->msg += to_move;
     segment_pool.make_segment(tx_pdu, pdcp_pdu);
@@ -862,7 +848,7 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
   }
 
   // Make sure, at least one SDU (segment) has been added until this point
-  if (pdu->N_bytes == 0) {
+  if (tx_pdu.buf.empty()) {
     RlcError("Generated empty RLC PDU.");
   }
 
@@ -872,7 +858,7 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   // Set Poll bit
   pdu_without_poll++;
-  byte_without_poll += (pdu->N_bytes + head_len);
+  byte_without_poll += (tx_pdu.buf.length() + head_len);
   RlcDebug("pdu_without_poll: %d", pdu_without_poll);
   RlcDebug("byte_without_poll: %d", byte_without_poll);
   if (poll_required()) {
@@ -889,15 +875,13 @@ int rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
   // Update Tx window
   vt_s = (vt_s + 1) % MOD;
 
-  // Write final header and TX
-  tx_pdu.buf                      = std::move(pdu);
-  tx_pdu.header                   = header;
-  const byte_buffer_t* buffer_ptr = tx_pdu.buf.get();
+  // Write final header and TX. The SDU segments are flattened straight into the MAC PDU, while the tx window keeps
+  // referencing the SDUs for retransmissions
+  tx_pdu.header = header;
 
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&header, &ptr);
-  memcpy(ptr, buffer_ptr->msg, buffer_ptr->N_bytes);
-  int total_len = (ptr - payload) + buffer_ptr->N_bytes;
+  int total_len = (ptr - payload) + tx_pdu.buf.copy_to(ptr);
   RlcHexInfo(payload, total_len, "Tx PDU SN=%d (%d B)", header.sn, total_len);
   log_rlc_amd_pdu_header_to_string(logger.debug, rb_name, "%s", header);
   debug_state();
@@ -970,24 +954,24 @@ void rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
             retx.sn         = i;
             retx.is_segment = false;
             retx.so_start   = 0;
-            retx.so_end     = pdu.buf->N_bytes;
+            retx.so_end     = pdu.buf.length();
 
             if (status.nacks[j].has_so) {
               // sanity check
-              if (status.nacks[j].so_start >= pdu.buf->N_bytes) {
+              if (status.nacks[j].so_start >= pdu.buf.length()) {
                 // print error but try to send original PDU again
-                RlcInfo("SO_start is larger than original PDU (%d >= %d)", status.nacks[j].so_start, pdu.buf->N_bytes);
+                RlcInfo("SO_start is larger than original PDU (%d >= %d)", status.nacks[j].so_start, pdu.buf.length());
                 status.nacks[j].so_start = 0;
               }
 
               // check for special SO_end value
               if (status.nacks[j].so_end == 0x7FFF) {
-                status.nacks[j].so_end = pdu.buf->N_bytes;
+                status.nacks[j].so_end = pdu.buf.length();
               } else {
                 retx.so_end = status.nacks[j].so_end + 1;
               }
 
-              if (status.nacks[j].so_start < pdu.buf->N_bytes && status.nacks[j].so_end <= pdu.buf->N_bytes) {
+              if (status.nacks[j].so_start < pdu.buf.length() && status.nacks[j].so_end <= pdu.buf.length()) {
                 retx.is_segment = true;
                 retx.so_start   = status.nacks[j].so_start;
               } else {
@@ -995,7 +979,7 @@ void rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
                            i,
                            status.nacks[j].so_start,
                            status.nacks[j].so_end,
-                           pdu.buf->N_bytes);
+                           pdu.buf.length());
               }
             }
           } else {
@@ -1093,8 +1077,8 @@ int rlc_am_lte_tx::required_buffer_size(const rlc_amd_retx_lte_t& retx)
 {
   if (!retx.is_segment) {
     if (tx_window.has_sn(retx.sn)) {
-      if (tx_window[retx.sn].buf) {
-        return rlc_am_packed_length(&tx_window[retx.sn].header) + tx_window[retx.sn].buf->N_bytes;
+      if (not tx_window[retx.sn].buf.empty()) {
+        return rlc_am_packed_length(&tx_window[retx.sn].header) + tx_window[retx.sn].buf.length();
       } else {
         RlcWarning("retx.sn=%d has null ptr in required_buffer_size()", retx.sn);
         return -1;
@@ -1293,7 +1277,7 @@ void rlc_am_lte_rx::handle_data_pdu_full(uint8_t* payload, uint32_t nof_bytes, r
 
   // Write to rx window
   rlc_amd_rx_pdu& pdu = rx_window.add_pdu(header.sn);
-  pdu.buf             = srsran::make_byte_buffer();
+  pdu.buf             = srsran::make_sized_byte_buffer(nof_bytes);
   if (pdu.buf == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
     srsran::console("Fatal Error: Couldn't allocate PDU in handle_data_pdu().\n");
@@ -1391,7 +1375,7 @@ void rlc_am_lte_rx::handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes
   }
 
   rlc_amd_rx_pdu segment;
-  segment.buf = srsran::make_byte_buffer();
+  segment.buf = srsran::make_sized_byte_buffer(nof_bytes);
   if (segment.buf == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
     srsran::console("Fatal Error: Couldn't allocate PDU in handle_data_pdu_segment().\n");
@@ -1458,7 +1442,7 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
 {
   uint32_t len = 0;
   if (rx_sdu == NULL) {
-    rx_sdu = srsran::make_byte_buffer();
+    rx_sdu = srsran::make_sdu_byte_buffer();
     if (rx_sdu == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
       srsran::console("Fatal Error: Could not allocate PDU in reassemble_rx_sdus() (1)\n");
@@ -1489,8 +1473,8 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
         break;
       }
 
-      if (rx_sdu->get_tailroom() >= len) {
-        if ((rx_window[vr_r].buf->msg - rx_window[vr_r].buf->buffer) + len < SRSRAN_MAX_BUFFER_SIZE_BYTES) {
+      if (rx_sdu->reserve_tailroom(len)) {
+        if (len <= rx_window[vr_r].buf->N_bytes + rx_window[vr_r].buf->get_tailroom()) {
           if (rx_window[vr_r].buf->N_bytes < len) {
             RlcError("Dropping corrupted SN=%d", vr_r);
             rx_sdu.reset();
@@ -1516,7 +1500,7 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
             parent->metrics.num_rx_sdus++;
           }
 
-          rx_sdu = srsran::make_byte_buffer();
+          rx_sdu = srsran::make_sdu_byte_buffer();
           if (rx_sdu == nullptr) {
 #ifdef RLC_AM_BUFFER_DEBUG
             srsran::console("Fatal Error: Could not allocate PDU in reassemble_rx_sdus() (2)\n");
@@ -1527,7 +1511,7 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
 #endif
           }
         } else {
-          int buf_len = rx_window[vr_r].buf->msg - rx_window[vr_r].buf->buffer;
+          int buf_len = rx_window[vr_r].buf->get_headroom();
           RlcError("Cannot read %d bytes from rx_window. vr_r=%d, msg-buffer=%d B", len, vr_r, buf_len);
           rx_sdu.reset();
           goto exit;
@@ -1542,7 +1526,7 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
     // Handle last segment
     len = rx_window[vr_r].buf->N_bytes;
     RlcHexDebug(rx_window[vr_r].buf->msg, len, "Handling last segment of length %d B of SN=%d", len, vr_r);
-    if (rx_sdu->get_tailroom() >= len) {
+    if (rx_sdu->reserve_tailroom(len)) {
       // store timestamp of the first segment when starting to assemble SDUs
       if (rx_sdu->N_bytes == 0) {
         rx_sdu->set_timestamp(rx_window[vr_r].buf->get_timestamp());
@@ -1569,7 +1553,7 @@ void rlc_am_lte_rx::reassemble_rx_sdus()
         parent->metrics.num_rx_sdus++;
       }
 
-      rx_sdu = srsran::make_byte_buffer();
+      rx_sdu = srsran::make_sdu_byte_buffer();
       if (rx_sdu == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
         srsran::console("Fatal Error: Could not allocate PDU in reassemble_rx_sdus() (3)\n");
@@ -321,7 +321,7 @@ void rlc_um_lte::rlc_um_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_b
 
   // Write to rx window
   rlc_umd_pdu_t pdu = {};
-  pdu.buf           = make_byte_buffer();
+  pdu.buf           = make_sized_byte_buffer(nof_bytes);
   if (!pdu.buf) {
     RlcError("Discarding packet: no space in buffer pool");
     return;
@@ -365,7 +365,7 @@ void rlc_um_lte::rlc_um_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_b
 void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
 {
   if (!rx_sdu) {
-    rx_sdu = make_byte_buffer();
+    rx_sdu = make_sdu_byte_buffer();
     if (!rx_sdu) {
       RlcError("Fatal Error: Couldn't allocate buffer in rlc_um::reassemble_rx_sdus().");
       return;
@@ -400,6 +400,14 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
           metrics.num_lost_pdus++;
           break;
         }
+        if (not rx_sdu->reserve_tailroom(len)) {
+          RlcError("Dropping PDU %d in reassembly, no space for a segment of %d B", vr_ur, len);
+          rx_window[vr_ur].buf->msg += len;
+          rx_window[vr_ur].buf->N_bytes -= len;
+          rx_sdu->clear();
+          metrics.num_lost_pdus++;
+          break;
+        }
 
         memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_ur].buf->msg, len);
         rx_sdu->N_bytes += len;
@@ -422,7 +430,7 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
           } else {
             pdcp->write_pdu(lcid, std::move(rx_sdu));
           }
-          rx_sdu = make_byte_buffer();
+          rx_sdu = make_sdu_byte_buffer();
           if (!rx_sdu) {
             RlcError("Fatal Error: Couldn't allocate buffer in rlc_um::reassemble_rx_sdus().");
             return;
@@ -432,7 +440,13 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
       }
 
       // Handle last segment
-      if (rx_sdu->N_bytes > 0 || rlc_um_start_aligned(rx_window[vr_ur].header.fi)) {
+      if (not rx_sdu->reserve_tailroom(rx_window[vr_ur].buf->N_bytes)) {
+        RlcError("Dropping PDU %d in reassembly, no space for a last segment of %d B",
+                 vr_ur,
+                 rx_window[vr_ur].buf->N_bytes);
+        rx_sdu->clear();
+        metrics.num_lost_pdus++;
+      } else if (rx_sdu->N_bytes > 0 || rlc_um_start_aligned(rx_window[vr_ur].header.fi)) {
         RlcInfo("Writing last segment in SDU buffer. Lower edge vr_ur=%d, Buffer size=%d, segment size=%d",
                 vr_ur,
                 rx_sdu->N_bytes,
@@ -456,7 +470,7 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
             } else {
               pdcp->write_pdu(lcid, std::move(rx_sdu));
             }
-            rx_sdu = make_byte_buffer();
+            rx_sdu = make_sdu_byte_buffer();
             if (!rx_sdu) {
               RlcError("Fatal Error: Couldn't allocate buffer in rlc_um::reassemble_rx_sdus().");
               return;
@@ -517,7 +531,7 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
       }
 
       // Check available space in SDU
-      if ((uint32_t)len > rx_sdu->get_tailroom()) {
+      if (not rx_sdu->reserve_tailroom(len)) {
         RlcError("Dropping PDU %d due to buffer mis-alignment (current segment len %d B, received %d B)",
                  vr_ur,
                  rx_sdu->N_bytes,
@@ -561,7 +575,7 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
         } else {
           pdcp->write_pdu(lcid, std::move(rx_sdu));
         }
-        rx_sdu = make_byte_buffer();
+        rx_sdu = make_sdu_byte_buffer();
         if (!rx_sdu) {
           RlcError("Fatal Error: Couldn't allocate buffer in rlc_um::reassemble_rx_sdus().");
           return;
@@ -589,7 +603,8 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
 
     if (rx_sdu->N_bytes < SRSRAN_MAX_BUFFER_SIZE_BYTES &&
         rx_window[vr_ur].buf->N_bytes < SRSRAN_MAX_BUFFER_SIZE_BYTES &&
-        rx_window[vr_ur].buf->N_bytes + rx_sdu->N_bytes < SRSRAN_MAX_BUFFER_SIZE_BYTES) {
+        rx_window[vr_ur].buf->N_bytes + rx_sdu->N_bytes < SRSRAN_MAX_BUFFER_SIZE_BYTES &&
+        rx_sdu->reserve_tailroom(rx_window[vr_ur].buf->N_bytes)) {
       RlcHexInfo(rx_window[vr_ur].buf->msg,
                  rx_window[vr_ur].buf->N_bytes,
                  "Writing last segment in SDU buffer. Updating vr_ur=%d, vr_ur_in_rx_sdu=%d, Buffer size=%d, "
@@ -622,7 +637,7 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
         } else {
           pdcp->write_pdu(lcid, std::move(rx_sdu));
         }
-        rx_sdu = make_byte_buffer();
+        rx_sdu = make_sdu_byte_buffer();
         if (!rx_sdu) {
           RlcError("Fatal Error: Couldn't allocate buffer in rlc_um::reassemble_rx_sdus().");
           return;
@@ -28,6 +28,7 @@ void backend_worker::stop()
 {
   // Signal the worker thread to stop.
   running_flag = false;
+  queue.wake_up_consumer();
   if (worker_thread.joinable()) {
     worker_thread.join();
   }
@@ -94,16 +95,16 @@ void backend_worker::start(backend_priority priority)
 
 void backend_worker::do_work()
 {
-  /// This period defines the time the worker will sleep while waiting for new entries. This is required to check the
-  /// termination variable periodically.
-  constexpr std::chrono::microseconds sleep_period{100};
+  /// This period defines the maximum time the worker will block while waiting for new entries. Producers and stop()
+  /// wake up the worker earlier, the timeout only bounds how often the termination variable is checked.
+  constexpr std::chrono::microseconds sleep_period{10000};
 
   while (running_flag) {
     auto item = queue.try_pop();
 
-    // Spin while there are no new entries to process.
+    // Block while there are no new entries to process.
     if (!item.first) {
-      std::this_thread::sleep_for(sleep_period);
+      queue.wait_for_entries(sleep_period);
       continue;
     }
 
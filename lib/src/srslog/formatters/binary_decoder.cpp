@@ -0,0 +1,287 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_decoder.h"
+#include "binary_format.h"
+#include <cstring>
+
+using namespace srslog;
+
+/// Reads the raw representation of a value from the input stream. Returns
+/// false on a short read.
+template <typename T>
+static bool get(std::FILE* in, T& value)
+{
+  return std::fread(&value, sizeof(T), 1, in) == 1;
+}
+
+/// Reads a length prefixed string from the input stream. Returns false on a
+/// short read.
+static bool get_string(std::FILE* in, std::string& str)
+{
+  uint32_t len;
+  if (!get(in, len)) {
+    return false;
+  }
+  str.resize(len);
+  return len == 0 || std::fread(&str[0], 1, len, in) == len;
+}
+
+static const char truncated_error[] = "Unexpected end of file, the log file is truncated";
+
+bool binary_decoder::read_header(std::FILE* in)
+{
+  char    magic[sizeof(binary_format::magic)];
+  uint8_t version;
+  if (std::fread(magic, sizeof(magic), 1, in) != 1 || !get(in, version)) {
+    return false;
+  }
+
+  return std::memcmp(magic, binary_format::magic, sizeof(magic)) == 0 && version == binary_format::version;
+}
+
+detail::error_string binary_decoder::read_string_record(std::FILE* in)
+{
+  uint32_t    id;
+  std::string str;
+  if (!get(in, id) || !get_string(in, str)) {
+    return truncated_error;
+  }
+
+  if (id == binary_format::invalid_str_id) {
+    return "Invalid string id found in string record";
+  }
+  if (id >= strings.size()) {
+    strings.resize(id + 1);
+  }
+  strings[id] = std::move(str);
+
+  return {};
+}
+
+detail::error_string binary_decoder::lookup_string(uint32_t id, const std::string*& str) const
+{
+  if (id >= strings.size()) {
+    return fmt::format("Reference to undefined string id {}", id);
+  }
+  str = &strings[id];
+  return {};
+}
+
+detail::error_string binary_decoder::read_arg(std::FILE* in)
+{
+  binary_format::arg_type type;
+  if (!get(in, type)) {
+    return truncated_error;
+  }
+
+  bool ok = false;
+  switch (type) {
+    case binary_format::arg_type::int32: {
+      int32_t v;
+      if ((ok = get(in, v))) {
+        store.push_back(static_cast<int>(v));
+      }
+      break;
+    }
+    case binary_format::arg_type::uint32: {
+      uint32_t v;
+      if ((ok = get(in, v))) {
+        store.push_back(static_cast<unsigned>(v));
+      }
+      break;
+    }
+    case binary_format::arg_type::int64: {
+      int64_t v;
+      if ((ok = get(in, v))) {
+        store.push_back(static_cast<long long>(v));
+      }
+      break;
+    }
+    case binary_format::arg_type::uint64: {
+      uint64_t v;
+      if ((ok = get(in, v))) {
+        store.push_back(static_cast<unsigned long long>(v));
+      }
+      break;
+    }
+    case binary_format::arg_type::boolean: {
+      uint8_t v;
+      if ((ok = get(in, v))) {
+        store.push_back(v != 0);
+      }
+      break;
+    }
+    case binary_format::arg_type::character: {
+      char v;
+      if ((ok = get(in, v))) {
+        store.push_back(v);
+      }
+      break;
+    }
+    case binary_format::arg_type::float32: {
+      float v;
+      if ((ok = get(in, v))) {
+        store.push_back(v);
+      }
+      break;
+    }
+    case binary_format::arg_type::float64: {
+      double v;
+      if ((ok = get(in, v))) {
+        store.push_back(v);
+      }
+      break;
+    }
+    case binary_format::arg_type::long_double: {
+      long double v;
+      if ((ok = get(in, v))) {
+        store.push_back(v);
+      }
+      break;
+    }
+    case binary_format::arg_type::string: {
+      std::string v;
+      if ((ok = get_string(in, v))) {
+        store.push_back(v);
+      }
+      break;
+    }
+    case binary_format::arg_type::pointer: {
+      uint64_t v;
+      if ((ok = get(in, v))) {
+        store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(v)));
+      }
+      break;
+    }
+    default:
+      return fmt::format("Unknown argument type {}", static_cast<unsigned>(type));
+  }
+
+  if (!ok) {
+    return truncated_error;
+  }
+  return {};
+}
+
+detail::error_string binary_decoder::read_entry_record(std::FILE* in, detail::log_entry_metadata& metadata)
+{
+  int64_t  timestamp_ns;
+  uint32_t fmt_id;
+  uint32_t name_id;
+  uint8_t  flags;
+  if (!get(in, timestamp_ns) || !get(in, fmt_id) || !get(in, name_id) || !get(in, metadata.log_tag) ||
+      !get(in, flags) || !get(in, metadata.context.value)) {
+    return truncated_error;
+  }
+
+  metadata.tp = std::chrono::high_resolution_clock::time_point(
+      std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::nanoseconds(timestamp_ns)));
+  metadata.context.enabled = flags & binary_format::flag_context_enabled;
+
+  const std::string* name = nullptr;
+  if (auto err_str = lookup_string(name_id, name)) {
+    return err_str;
+  }
+  metadata.log_name = *name;
+
+  store.clear();
+  metadata.store     = nullptr;
+  metadata.fmtstring = nullptr;
+  if (flags & binary_format::flag_preformatted) {
+    if (!get_string(in, message)) {
+      return truncated_error;
+    }
+    metadata.fmtstring = message.c_str();
+  } else {
+    const std::string* fmtstring = nullptr;
+    if (auto err_str = lookup_string(fmt_id, fmtstring)) {
+      return err_str;
+    }
+    if (fmt_id != binary_format::invalid_str_id) {
+      metadata.fmtstring = fmtstring->c_str();
+    }
+
+    if (flags & binary_format::flag_has_args) {
+      uint8_t num_args;
+      if (!get(in, num_args)) {
+        return truncated_error;
+      }
+      for (unsigned i = 0; i != num_args; ++i) {
+        if (auto err_str = read_arg(in)) {
+          return err_str;
+        }
+      }
+      metadata.store = &store;
+    }
+  }
+
+  uint32_t hex_len;
+  if (!get(in, hex_len)) {
+    return truncated_error;
+  }
+  metadata.hex_dump.resize(hex_len);
+  if (hex_len && std::fread(metadata.hex_dump.data(), 1, hex_len, in) != hex_len) {
+    return truncated_error;
+  }
+
+  return {};
+}
+
+detail::error_string binary_decoder::decode(std::FILE* in, std::FILE* out)
+{
+  if (!read_header(in)) {
+    return "Invalid file header, not a srsLog binary file";
+  }
+
+  strings.assign(1, "");
+
+  while (true) {
+    char tag;
+    if (!get(in, tag)) {
+      break;
+    }
+
+    switch (tag) {
+      case binary_format::string_record:
+        if (auto err_str = read_string_record(in)) {
+          return err_str;
+        }
+        break;
+      case binary_format::entry_record: {
+        detail::log_entry_metadata metadata = {};
+        if (auto err_str = read_entry_record(in, metadata)) {
+          return err_str;
+        }
+        buffer.clear();
+        formatter.format(std::move(metadata), buffer);
+        if (std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+          return "Unable to write decoded output";
+        }
+        break;
+      }
+      default:
+        return fmt::format("Unknown record type 0x{:02x} at offset {}", tag, std::ftell(in) - 1);
+    }
+  }
+
+  return {};
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_DECODER_H
+#define SRSLOG_BINARY_DECODER_H
+
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include "srsran/srslog/detail/support/error_string.h"
+#include "srsran/srslog/formatter.h"
+#include <cstdio>
+
+namespace srslog {
+
+/// Decodes files written by the binary_file_sink, rebuilding each log entry and
+/// passing it to the specified formatter, so the output is identical to the one
+/// that formatter would have produced at run time.
+class binary_decoder
+{
+public:
+  explicit binary_decoder(log_formatter& formatter) : formatter(formatter) {}
+
+  binary_decoder(const binary_decoder&) = delete;
+  binary_decoder& operator=(const binary_decoder&) = delete;
+
+  /// Decodes a complete binary log file from the input stream writing the
+  /// formatted entries into the output stream.
+  detail::error_string decode(std::FILE* in, std::FILE* out);
+
+private:
+  /// Reads the file header. Returns false if it is not valid.
+  bool read_header(std::FILE* in);
+
+  /// Reads a string record into the string table.
+  detail::error_string read_string_record(std::FILE* in);
+
+  /// Reads an entry record into the provided metadata.
+  detail::error_string read_entry_record(std::FILE* in, detail::log_entry_metadata& metadata);
+
+  /// Reads a single argument pushing it into the argument store.
+  detail::error_string read_arg(std::FILE* in);
+
+  /// Returns the string with the specified id.
+  detail::error_string lookup_string(uint32_t id, const std::string*& str) const;
+
+private:
+  log_formatter&                                     formatter;
+  std::vector<std::string>                           strings;
+  std::string                                        message;
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  fmt::memory_buffer                                 buffer;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_DECODER_H
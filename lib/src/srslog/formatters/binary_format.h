@@ -0,0 +1,83 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_FORMAT_H
+#define SRSLOG_BINARY_FORMAT_H
+
+#include <cstdint>
+
+namespace srslog {
+
+/// Definitions shared by the binary formatter, the binary file sink and the
+/// offline decoder.
+///
+/// A binary log file starts with a header followed by a sequence of records.
+/// All integers are stored in the native byte order of the host that wrote the
+/// file. Each record begins with a one byte tag:
+///
+///  String record: defines a string that later entries refer to by id.
+///    'S' | u32 id | u32 length | characters
+///
+///  Entry record: a single log entry.
+///    'E' | i64 timestamp (ns since epoch) | u32 format string id | u32 log name id |
+///    u8 tag | u8 flags | u32 context value | message | u32 hex dump length | hex dump bytes
+///
+///    When the preformatted flag is set the message is a u32 length followed by
+///    the already formatted text, otherwise it is a u8 argument count followed by
+///    each argument encoded as a one byte type followed by its value.
+///
+/// String id 0 is reserved to represent an absent string.
+namespace binary_format {
+
+/// Magic string found at the beginning of every binary log file.
+constexpr char     magic[]        = {'S', 'R', 'S', 'L', 'O', 'G', 'B'};
+constexpr uint8_t  version        = 1;
+constexpr uint32_t invalid_str_id = 0;
+
+/// Record tags.
+constexpr char string_record = 'S';
+constexpr char entry_record  = 'E';
+
+/// Entry flags.
+constexpr uint8_t flag_context_enabled = 1u << 0;
+constexpr uint8_t flag_has_args        = 1u << 1;
+constexpr uint8_t flag_preformatted    = 1u << 2;
+
+/// Argument types.
+enum class arg_type : uint8_t {
+  int32,
+  uint32,
+  int64,
+  uint64,
+  boolean,
+  character,
+  float32,
+  float64,
+  long_double,
+  string,
+  pointer
+};
+
+} // namespace binary_format
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_FORMAT_H
@@ -0,0 +1,305 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_formatter.h"
+#include "binary_format.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+
+using namespace srslog;
+
+std::unique_ptr<log_formatter> binary_formatter::clone() const
+{
+  return std::unique_ptr<log_formatter>(new binary_formatter);
+}
+
+/// Appends the raw representation of the input value into the buffer.
+template <typename T>
+static void put(fmt::memory_buffer& buffer, const T& value)
+{
+  const char* p = reinterpret_cast<const char*>(&value);
+  buffer.append(p, p + sizeof(T));
+}
+
+/// Appends a length prefixed string into the buffer.
+static void put_string(fmt::memory_buffer& buffer, fmt::string_view str)
+{
+  put(buffer, static_cast<uint32_t>(str.size()));
+  buffer.append(str.data(), str.data() + str.size());
+}
+
+namespace {
+
+/// Serializes a format argument into a buffer.
+struct arg_serializer {
+  fmt::memory_buffer& buffer;
+
+  template <typename T>
+  void write(binary_format::arg_type type, const T& value)
+  {
+    put(buffer, type);
+    put(buffer, value);
+  }
+
+  void operator()(int v) { write(binary_format::arg_type::int32, static_cast<int32_t>(v)); }
+  void operator()(unsigned v) { write(binary_format::arg_type::uint32, static_cast<uint32_t>(v)); }
+  void operator()(long long v) { write(binary_format::arg_type::int64, static_cast<int64_t>(v)); }
+  void operator()(unsigned long long v) { write(binary_format::arg_type::uint64, static_cast<uint64_t>(v)); }
+  void operator()(bool v) { write(binary_format::arg_type::boolean, static_cast<uint8_t>(v)); }
+  void operator()(char v) { write(binary_format::arg_type::character, v); }
+  void operator()(float v) { write(binary_format::arg_type::float32, v); }
+  void operator()(double v) { write(binary_format::arg_type::float64, v); }
+  void operator()(long double v) { write(binary_format::arg_type::long_double, v); }
+  void operator()(const void* v) { write(binary_format::arg_type::pointer, reinterpret_cast<uint64_t>(v)); }
+  void operator()(const char* v)
+  {
+    put(buffer, binary_format::arg_type::string);
+    put_string(buffer, v ? fmt::string_view(v) : fmt::string_view());
+  }
+  void operator()(fmt::string_view v)
+  {
+    put(buffer, binary_format::arg_type::string);
+    put_string(buffer, v);
+  }
+
+  /// Remaining types are never serialized, see is_serializable().
+  template <typename T>
+  void operator()(T)
+  {
+    assert(false && "Unsupported argument type");
+  }
+};
+
+} // namespace
+
+/// Returns true if all the arguments can be stored in binary form, otherwise
+/// returns false and the message needs to be preformatted.
+static bool is_serializable(const fmt::basic_format_args<fmt::printf_context>& args)
+{
+  for (int i = 0, e = args.max_size(); i != e; ++i) {
+    switch (args.get(i).type()) {
+      case fmt::detail::type::none_type:
+      case fmt::detail::type::int128_type:
+      case fmt::detail::type::uint128_type:
+      case fmt::detail::type::custom_type:
+        return false;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+/// Formats the log message into the input buffer using printf formatting.
+static void format_message(const detail::log_entry_metadata& metadata, fmt::memory_buffer& buffer)
+{
+  if (!metadata.store) {
+    fmt::format_to(buffer, "{}", metadata.fmtstring);
+    return;
+  }
+
+  fmt::basic_format_args<fmt::printf_context> args(*metadata.store);
+  try {
+    fmt::vprintf(buffer, fmt::to_string_view(metadata.fmtstring), args);
+  } catch (...) {
+    fmt::print(stderr, "srsLog error - Invalid format string: \"{}\"\n", metadata.fmtstring);
+    fmt::format_to(buffer, " -> srsLog error - Invalid format string: \"{}\"", metadata.fmtstring);
+#ifdef STOP_ON_WARNING
+    std::abort();
+#endif
+  }
+}
+
+uint32_t binary_formatter::define_string(fmt::string_view str, fmt::memory_buffer& buffer)
+{
+  auto id = static_cast<uint32_t>(strings.size());
+  strings.emplace_back(str.data(), str.size());
+
+  put(buffer, binary_format::string_record);
+  put(buffer, id);
+  put_string(buffer, str);
+
+  return id;
+}
+
+uint32_t binary_formatter::get_fmtstring_id(const char* str, fmt::memory_buffer& buffer)
+{
+  if (!str) {
+    return binary_format::invalid_str_id;
+  }
+
+  auto it = fmtstring_ids.find(str);
+  if (it != fmtstring_ids.end()) {
+    return it->second;
+  }
+
+  uint32_t id = define_string(str, buffer);
+  fmtstring_ids.emplace(str, id);
+  return id;
+}
+
+uint32_t binary_formatter::get_name_id(const std::string& name, fmt::memory_buffer& buffer)
+{
+  if (name.empty()) {
+    return binary_format::invalid_str_id;
+  }
+
+  auto it = name_ids.find(name);
+  if (it != name_ids.end()) {
+    return it->second;
+  }
+
+  uint32_t id = define_string(name, buffer);
+  name_ids.emplace(name, id);
+  return id;
+}
+
+void binary_formatter::format_entry(const detail::log_entry_metadata& metadata,
+                                    const fmt::memory_buffer*         preformatted,
+                                    fmt::memory_buffer&               buffer)
+{
+  // Fall back to formatting the message when some argument has no binary
+  // representation.
+  fmt::memory_buffer fallback;
+  if (!preformatted && metadata.fmtstring && metadata.store &&
+      !is_serializable(fmt::basic_format_args<fmt::printf_context>(*metadata.store))) {
+    format_message(metadata, fallback);
+    preformatted = &fallback;
+  }
+
+  // String definitions must precede the entry that uses them.
+  uint32_t fmt_id  = preformatted ? binary_format::invalid_str_id : get_fmtstring_id(metadata.fmtstring, buffer);
+  uint32_t name_id = get_name_id(metadata.log_name, buffer);
+
+  uint8_t flags = 0;
+  if (metadata.context.enabled) {
+    flags |= binary_format::flag_context_enabled;
+  }
+  if (preformatted) {
+    flags |= binary_format::flag_preformatted;
+  } else if (metadata.store) {
+    flags |= binary_format::flag_has_args;
+  }
+
+  put(buffer, binary_format::entry_record);
+  put(buffer,
+      static_cast<int64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(metadata.tp.time_since_epoch()).count()));
+  put(buffer, fmt_id);
+  put(buffer, name_id);
+  put(buffer, metadata.log_tag);
+  put(buffer, flags);
+  put(buffer, metadata.context.value);
+
+  if (preformatted) {
+    put_string(buffer, fmt::string_view(preformatted->data(), preformatted->size()));
+  } else if (metadata.store) {
+    fmt::basic_format_args<fmt::printf_context> args(*metadata.store);
+    auto                                        num_args = static_cast<uint8_t>(args.max_size());
+    put(buffer, num_args);
+    arg_serializer serializer{buffer};
+    for (int i = 0; i != num_args; ++i) {
+      fmt::visit_format_arg(serializer, args.get(i));
+    }
+  }
+
+  put(buffer, static_cast<uint32_t>(metadata.hex_dump.size()));
+  buffer.append(reinterpret_cast<const char*>(metadata.hex_dump.data()),
+                reinterpret_cast<const char*>(metadata.hex_dump.data() + metadata.hex_dump.size()));
+}
+
+void binary_formatter::format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer)
+{
+  format_entry(metadata, nullptr, buffer);
+}
+
+void binary_formatter::format_file_header(fmt::memory_buffer& buffer) const
+{
+  buffer.append(std::begin(binary_format::magic), std::end(binary_format::magic));
+  put(buffer, binary_format::version);
+
+  // Skip the reserved invalid id.
+  for (uint32_t id = 1, e = strings.size(); id != e; ++id) {
+    put(buffer, binary_format::string_record);
+    put(buffer, id);
+    put_string(buffer, strings[id]);
+  }
+}
+
+/// Contexts are rare compared to plain log entries, they are rendered as text
+/// in a single line and stored as a preformatted message.
+void binary_formatter::format_context_begin(const detail::log_entry_metadata& md,
+                                            fmt::string_view                  ctx_name,
+                                            unsigned                          size,
+                                            fmt::memory_buffer&               buffer)
+{
+  assert(scope_stack.empty() && "Stack should be empty");
+  ctx_buffer.clear();
+  fmt::format_to(ctx_buffer, "[");
+}
+
+void binary_formatter::format_context_end(const detail::log_entry_metadata& md,
+                                          fmt::string_view                  ctx_name,
+                                          fmt::memory_buffer&               buffer)
+{
+  fmt::format_to(ctx_buffer, "]");
+  if (md.fmtstring) {
+    fmt::format_to(ctx_buffer, ": ");
+    format_message(md, ctx_buffer);
+  }
+
+  format_entry(md, &ctx_buffer, buffer);
+  assert(scope_stack.empty() && "Stack should be empty");
+}
+
+void binary_formatter::format_metric_set_begin(fmt::string_view    set_name,
+                                               unsigned            size,
+                                               unsigned            level,
+                                               fmt::memory_buffer& buffer)
+{
+  scope_stack.emplace_back(size, std::string(set_name.data(), set_name.size()));
+  fmt::format_to(ctx_buffer, "[");
+}
+
+void binary_formatter::format_metric_set_end(fmt::string_view set_name, unsigned level, fmt::memory_buffer& buffer)
+{
+  scope_stack.pop_back();
+  fmt::format_to(ctx_buffer, "]");
+}
+
+void binary_formatter::format_metric(fmt::string_view    metric_name,
+                                     fmt::string_view    metric_value,
+                                     fmt::string_view    metric_units,
+                                     metric_kind         kind,
+                                     unsigned            level,
+                                     fmt::memory_buffer& buffer)
+{
+  assert(!scope_stack.empty() && "Metric outside of a metric set");
+  scope& current = scope_stack.back();
+  --current.size;
+  fmt::format_to(ctx_buffer,
+                 "{}_{}: {}{}{}{}",
+                 current.set_name,
+                 metric_name,
+                 metric_value,
+                 metric_units.size() == 0 ? "" : " ",
+                 metric_units,
+                 current.size ? ", " : "");
+}
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_FORMATTER_H
+#define SRSLOG_BINARY_FORMATTER_H
+
+#include "srsran/srslog/formatter.h"
+#include <string>
+#include <unordered_map>
+
+namespace srslog {
+
+/// Binary formatter implementation class.
+/// Log entries are serialized without running any string formatting: the
+/// format string and log name are replaced by numeric ids, and the arguments
+/// and timestamp are copied in their raw representation. Strings are defined
+/// in the output stream the first time they are referenced.
+/// NOTE: The resulting stream is only meaningful when prefixed by the header
+/// generated with format_file_header(), see binary_file_sink.
+class binary_formatter : public log_formatter
+{
+public:
+  binary_formatter() = default;
+
+  std::unique_ptr<log_formatter> clone() const override;
+
+  void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
+
+  /// Formats into the input buffer the file header followed by all the strings
+  /// defined so far, so that a new file can be decoded on its own.
+  void format_file_header(fmt::memory_buffer& buffer) const;
+
+private:
+  void format_context_begin(const detail::log_entry_metadata& md,
+                            fmt::string_view                  ctx_name,
+                            unsigned                          size,
+                            fmt::memory_buffer&               buffer) override;
+
+  void format_context_end(const detail::log_entry_metadata& md,
+                          fmt::string_view                  ctx_name,
+                          fmt::memory_buffer&               buffer) override;
+
+  void format_metric_set_begin(fmt::string_view    set_name,
+                               unsigned            size,
+                               unsigned            level,
+                               fmt::memory_buffer& buffer) override;
+
+  void format_metric_set_end(fmt::string_view set_name, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void
+  format_list_begin(fmt::string_view list_name, unsigned size, unsigned level, fmt::memory_buffer& buffer) override {}
+
+  void format_list_end(fmt::string_view list_name, unsigned level, fmt::memory_buffer& buffer) override {}
+
+  void format_metric(fmt::string_view    metric_name,
+                     fmt::string_view    metric_value,
+                     fmt::string_view    metric_units,
+                     metric_kind         kind,
+                     unsigned            level,
+                     fmt::memory_buffer& buffer) override;
+
+  /// Returns the id of the specified format string, defining it into the
+  /// buffer when seen for the first time. Format strings are identified by
+  /// address as they are string literals.
+  uint32_t get_fmtstring_id(const char* str, fmt::memory_buffer& buffer);
+
+  /// Returns the id of the specified log name, defining it into the buffer when
+  /// seen for the first time.
+  uint32_t get_name_id(const std::string& name, fmt::memory_buffer& buffer);
+
+  /// Defines a new string into the buffer and returns its id.
+  uint32_t define_string(fmt::string_view str, fmt::memory_buffer& buffer);
+
+  /// Formats an entry record into the buffer. When preformatted is not null,
+  /// it is used as the message instead of the format arguments.
+  void format_entry(const detail::log_entry_metadata& metadata,
+                    const fmt::memory_buffer*         preformatted,
+                    fmt::memory_buffer&               buffer);
+
+private:
+  /// Keeps track of the metric set being rendered in a context.
+  struct scope {
+    scope(unsigned size, std::string set_name) : size(size), set_name(std::move(set_name)) {}
+    /// Number of elements this scope holds.
+    unsigned size;
+    /// Set name in this scope.
+    std::string set_name;
+  };
+
+private:
+  std::unordered_map<const char*, uint32_t> fmtstring_ids;
+  std::unordered_map<std::string, uint32_t> name_ids;
+  /// All defined strings indexed by id, used to rebuild the file header.
+  std::vector<std::string>                  strings = {""};
+  /// Scratch buffer where context entries are rendered as text.
+  fmt::memory_buffer                        ctx_buffer;
+  std::vector<scope>                        scope_stack;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_FORMATTER_H
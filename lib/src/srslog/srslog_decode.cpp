@@ -0,0 +1,85 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "formatters/binary_decoder.h"
+#include "formatters/json_formatter.h"
+#include "formatters/text_formatter.h"
+#include <unistd.h>
+
+using namespace srslog;
+
+/// Offline decoder for the files written by the srsLog binary file sink.
+/// Decoded entries are written to stdout in plain text or JSON format.
+
+static void usage(const char* prog)
+{
+  fmt::print("Usage: {} [-j] file [file...]\n", prog);
+  fmt::print("\t-j Output JSON instead of plain text\n");
+  fmt::print("\t-h Show this help\n");
+}
+
+int main(int argc, char** argv)
+{
+  bool use_json = false;
+  int  opt;
+  while ((opt = getopt(argc, argv, "jh")) != -1) {
+    switch (opt) {
+      case 'j':
+        use_json = true;
+        break;
+      case 'h':
+        usage(argv[0]);
+        return 0;
+      default:
+        usage(argv[0]);
+        return -1;
+    }
+  }
+
+  if (optind >= argc) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  std::unique_ptr<log_formatter> formatter =
+      use_json ? std::unique_ptr<log_formatter>(new json_formatter) : std::unique_ptr<log_formatter>(new text_formatter);
+
+  int ret = 0;
+  for (int i = optind; i < argc; ++i) {
+    std::FILE* in = std::fopen(argv[i], "rb");
+    if (!in) {
+      fmt::print(stderr, "Unable to open file \"{}\"\n", argv[i]);
+      ret = -1;
+      continue;
+    }
+
+    // Each file carries its own string table, start from a clean decoder.
+    binary_decoder decoder(*formatter);
+    if (auto err_str = decoder.decode(in, stdout)) {
+      fmt::print(stderr, "Error decoding file \"{}\": {}\n", argv[i], err_str.get_error());
+      ret = -1;
+    }
+
+    std::fclose(in);
+  }
+
+  return ret;
+}
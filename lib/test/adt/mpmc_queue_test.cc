@@ -0,0 +1,135 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/mpmc_queue.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+#include <vector>
+
+namespace srsran {
+
+void test_mpmc_queue_single_thread()
+{
+  bounded_mpmc_queue<std::unique_ptr<int> > queue(5);
+  TESTASSERT(queue.capacity() == 5);
+  TESTASSERT(queue.empty());
+
+  // push until full
+  for (int i = 0; i < (int)queue.capacity(); ++i) {
+    std::unique_ptr<int> elem(new int(i));
+    TESTASSERT(queue.try_push(std::move(elem)));
+    TESTASSERT(queue.size() == (size_t)i + 1);
+  }
+  std::unique_ptr<int> elem(new int(-1));
+  TESTASSERT(not queue.try_push(std::move(elem)));
+  TESTASSERT(elem != nullptr and *elem == -1);
+
+  // pop until empty, wrapping around the slots
+  for (int i = 0; i < 20; ++i) {
+    std::unique_ptr<int> out;
+    TESTASSERT(queue.try_pop(out));
+    TESTASSERT(out != nullptr and *out == i);
+    TESTASSERT(queue.try_push(std::unique_ptr<int>(new int(i + (int)queue.capacity()))));
+  }
+  for (int i = 0; i < (int)queue.capacity(); ++i) {
+    std::unique_ptr<int> out;
+    TESTASSERT(queue.try_pop(out));
+    TESTASSERT(*out == i + 20);
+  }
+  std::unique_ptr<int> out;
+  TESTASSERT(not queue.try_pop(out));
+  TESTASSERT(queue.empty());
+}
+
+void test_mpmc_queue_small_capacity(size_t capacity, size_t expected_capacity)
+{
+  bounded_mpmc_queue<int> queue(capacity);
+  TESTASSERT(queue.capacity() == expected_capacity);
+
+  // fill and drain the queue for a few laps
+  int next_push = 0, next_pop = 0;
+  for (int lap = 0; lap < 4; ++lap) {
+    while (queue.try_push(next_push)) {
+      next_push++;
+    }
+    TESTASSERT(queue.size() == expected_capacity);
+    int out = -1;
+    while (queue.try_pop(out)) {
+      TESTASSERT(out == next_pop++);
+    }
+    TESTASSERT(queue.empty() and next_pop == next_push);
+  }
+  TESTASSERT(next_push == 4 * (int)expected_capacity);
+}
+
+void test_mpmc_queue_multi_producer()
+{
+  const uint32_t nof_producers = 4, nof_elems = 10000;
+
+  bounded_mpmc_queue<uint32_t> queue(64);
+  std::vector<std::thread>     producers;
+  for (uint32_t p = 0; p < nof_producers; ++p) {
+    producers.emplace_back([&queue, p, nof_elems]() {
+      for (uint32_t i = 0; i < nof_elems; ++i) {
+        while (not queue.try_push(p * nof_elems + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Elements of each producer are popped in the order they were pushed
+  std::vector<uint32_t> next_elem(nof_producers, 0);
+  uint32_t              nof_popped = 0;
+  while (nof_popped < nof_producers * nof_elems) {
+    uint32_t elem;
+    if (not queue.try_pop(elem)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t p = elem / nof_elems;
+    TESTASSERT(p < nof_producers);
+    TESTASSERT(elem % nof_elems == next_elem[p]);
+    next_elem[p]++;
+    nof_popped++;
+  }
+  for (std::thread& t : producers) {
+    t.join();
+  }
+  TESTASSERT(queue.empty());
+}
+
+} // namespace srsran
+
+int main(int argc, char** argv)
+{
+  auto& test_log = srslog::fetch_basic_logger("TEST");
+  test_log.set_level(srslog::basic_levels::info);
+
+  srsran::test_init(argc, argv);
+
+  srsran::test_mpmc_queue_single_thread();
+  srsran::test_mpmc_queue_small_capacity(1, 2);
+  srsran::test_mpmc_queue_small_capacity(3, 3);
+  srsran::test_mpmc_queue_multi_producer();
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/spsc_queue.h"
+#include "srsran/common/lockfree_queue.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+
+namespace srsran {
+
+void test_spsc_queue_single_thread()
+{
+  bounded_spsc_queue<std::unique_ptr<int> > queue(5);
+  TESTASSERT(queue.capacity() == 8);
+  TESTASSERT(queue.empty());
+
+  // push until full
+  for (int i = 0; i < (int)queue.capacity(); ++i) {
+    std::unique_ptr<int> elem(new int(i));
+    TESTASSERT(queue.try_push(std::move(elem)));
+    TESTASSERT(queue.size() == (size_t)i + 1);
+  }
+  std::unique_ptr<int> elem(new int(-1));
+  TESTASSERT(not queue.try_push(std::move(elem)));
+  TESTASSERT(elem != nullptr and *elem == -1);
+
+  // pop until empty, wrapping around the slots
+  for (int i = 0; i < 20; ++i) {
+    std::unique_ptr<int> out;
+    TESTASSERT(queue.try_pop(out));
+    TESTASSERT(out != nullptr and *out == i);
+    TESTASSERT(queue.try_push(std::unique_ptr<int>(new int(i + (int)queue.capacity()))));
+  }
+  for (int i = 0; i < (int)queue.capacity(); ++i) {
+    std::unique_ptr<int> out;
+    TESTASSERT(queue.try_pop(out));
+    TESTASSERT(*out == i + 20);
+  }
+  std::unique_ptr<int> out;
+  TESTASSERT(not queue.try_pop(out));
+  TESTASSERT(queue.empty());
+}
+
+void test_spsc_blocking_queue(queue_wait_policy policy)
+{
+  const uint32_t nof_elems = 20000;
+
+  // Small queue, so that both the producer and the consumer have to wait
+  spsc_blocking_queue<uint32_t> queue(4, policy);
+  std::thread                   producer([&queue, nof_elems]() {
+    for (uint32_t i = 0; i < nof_elems; ++i) {
+      TESTASSERT(queue.push(i));
+    }
+  });
+
+  for (uint32_t i = 0; i < nof_elems; ++i) {
+    uint32_t elem = 0;
+    TESTASSERT(queue.pop_wait(elem));
+    TESTASSERT(elem == i);
+  }
+  producer.join();
+  TESTASSERT(queue.empty());
+
+  // stop() unblocks a waiting consumer
+  std::thread consumer([&queue]() {
+    uint32_t elem = 0;
+    TESTASSERT(not queue.pop_wait(elem));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.stop();
+  consumer.join();
+}
+
+void test_queue_wait_policy_strings()
+{
+  for (queue_wait_policy p : {queue_wait_policy::sleep, queue_wait_policy::busy_poll, queue_wait_policy::spin_futex}) {
+    queue_wait_policy parsed = queue_wait_policy::sleep;
+    TESTASSERT(from_string(to_string(p), parsed));
+    TESTASSERT(parsed == p);
+  }
+  queue_wait_policy parsed = queue_wait_policy::sleep;
+  TESTASSERT(not from_string("spin", parsed));
+  TESTASSERT(parsed == queue_wait_policy::sleep);
+}
+
+} // namespace srsran
+
+int main(int argc, char** argv)
+{
+  auto& test_log = srslog::fetch_basic_logger("TEST");
+  test_log.set_level(srslog::basic_levels::info);
+
+  srsran::test_init(argc, argv);
+
+  srsran::test_spsc_queue_single_thread();
+  srsran::test_spsc_blocking_queue(srsran::queue_wait_policy::sleep);
+  srsran::test_spsc_blocking_queue(srsran::queue_wait_policy::busy_poll);
+  srsran::test_spsc_blocking_queue(srsran::queue_wait_policy::spin_futex);
+  srsran::test_queue_wait_policy_strings();
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
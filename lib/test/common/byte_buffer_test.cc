@@ -0,0 +1,352 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/byte_buffer_chain.h"
+#include "srsran/common/test_common.h"
+
+using namespace srsran;
+
+using size_class = byte_buffer_t::size_class;
+
+uint32_t nof_in_use(size_class cls)
+{
+  return get_byte_buffer_metrics()[static_cast<size_t>(cls)].nof_in_use;
+}
+
+uint64_t nof_promotions(size_class cls)
+{
+  return get_byte_buffer_metrics()[static_cast<size_t>(cls)].nof_promotions;
+}
+
+uint64_t nof_alloc_failures(size_class cls)
+{
+  return get_byte_buffer_metrics()[static_cast<size_t>(cls)].nof_alloc_failures;
+}
+
+void fill(byte_buffer_t& buf, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; ++i) {
+    buf.msg[buf.N_bytes + i] = static_cast<uint8_t>(buf.N_bytes + i);
+  }
+  buf.N_bytes += len;
+}
+
+bool check_content(const byte_buffer_t& buf)
+{
+  for (uint32_t i = 0; i < buf.N_bytes; ++i) {
+    if (buf.msg[i] != static_cast<uint8_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int test_size_classes()
+{
+  TESTASSERT(byte_buffer_t::fitting_class(0) == size_class::small);
+  TESTASSERT(byte_buffer_t::fitting_class(40) == size_class::small);
+  TESTASSERT(byte_buffer_t::fitting_class(1500) == size_class::medium);
+  TESTASSERT(byte_buffer_t::fitting_class(9000) == size_class::large);
+
+  uint32_t             nof_small = nof_in_use(size_class::small);
+  unique_byte_buffer_t small   = make_sized_byte_buffer(40);
+  unique_byte_buffer_t medium  = make_sized_byte_buffer(1500);
+  unique_byte_buffer_t large   = make_byte_buffer();
+  TESTASSERT(small != nullptr and medium != nullptr and large != nullptr);
+  TESTASSERT(small->get_size_class() == size_class::small);
+  TESTASSERT(medium->get_size_class() == size_class::medium);
+  TESTASSERT(large->get_size_class() == size_class::large);
+  TESTASSERT(small->get_headroom() == byte_buffer_t::SMALL_HEADER_OFFSET);
+  TESTASSERT(large->get_headroom() == SRSRAN_BUFFER_HEADER_OFFSET);
+  TESTASSERT(small->get_tailroom() >= 40 and medium->get_tailroom() >= 1500);
+  TESTASSERT(nof_in_use(size_class::small) == nof_small + 1);
+
+  small.reset();
+  TESTASSERT(nof_in_use(size_class::small) == nof_small);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_promotion()
+{
+  uint32_t             nof_medium = nof_in_use(size_class::medium);
+  uint64_t             nof_promo  = nof_promotions(size_class::medium);
+  unique_byte_buffer_t pdu        = make_sized_byte_buffer(40);
+  TESTASSERT(pdu != nullptr);
+  fill(*pdu, 40);
+
+  // Prepended headers stay in place across promotions
+  pdu->msg -= 2;
+  pdu->N_bytes += 2;
+  pdu->msg[0] = 0;
+  pdu->msg[1] = 1;
+  for (uint32_t i = 0; i < 40; ++i) {
+    pdu->msg[2 + i] = i + 2;
+  }
+  uint32_t headroom = pdu->get_headroom();
+
+  // Appending beyond the small storage moves the bytes to a medium storage
+  std::array<uint8_t, 1000> payload;
+  for (uint32_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<uint8_t>(pdu->N_bytes + i);
+  }
+  TESTASSERT(pdu->append_bytes(payload.data(), payload.size()));
+  TESTASSERT(pdu->get_size_class() == size_class::medium);
+  TESTASSERT(pdu->get_headroom() == headroom);
+  TESTASSERT(pdu->N_bytes == 1042 and check_content(*pdu));
+  TESTASSERT(nof_in_use(size_class::medium) == nof_medium + 1);
+  TESTASSERT(nof_promotions(size_class::medium) == nof_promo + 1);
+
+  // And beyond the medium storage to a large one
+  pdu->resize(5000);
+  TESTASSERT(pdu->get_size_class() == size_class::large);
+  TESTASSERT(pdu->N_bytes == 5000 and pdu->get_headroom() == headroom);
+  pdu->resize(1042);
+  TESTASSERT(check_content(*pdu));
+  TESTASSERT(nof_in_use(size_class::medium) == nof_medium);
+
+  // Nothing fits beyond the large storage, and a failed resize leaves the buffer untouched
+  TESTASSERT(not pdu->reserve_tailroom(byte_buffer_t::LARGE_STORAGE_SIZE));
+  TESTASSERT(not pdu->resize(byte_buffer_t::LARGE_STORAGE_SIZE));
+  TESTASSERT(pdu->N_bytes == 1042 and check_content(*pdu));
+
+  // Shrinking moves the bytes back to the smallest class
+  pdu->shrink_to_fit();
+  TESTASSERT(pdu->get_size_class() == size_class::medium);
+  TESTASSERT(pdu->get_headroom() == byte_buffer_t::SMALL_HEADER_OFFSET);
+  TESTASSERT(pdu->N_bytes == 1042 and check_content(*pdu));
+  pdu->N_bytes = 100;
+  pdu->shrink_to_fit();
+  TESTASSERT(pdu->get_size_class() == size_class::small);
+  TESTASSERT(pdu->N_bytes == 100 and check_content(*pdu));
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_copy_and_move()
+{
+  unique_byte_buffer_t large = make_byte_buffer();
+  TESTASSERT(large != nullptr);
+  fill(*large, 3000);
+  large->md.pdcp_sn = 5;
+
+  // Copies into smaller storages get promoted
+  unique_byte_buffer_t small = make_sized_byte_buffer(10);
+  TESTASSERT(small != nullptr);
+  *small = *large;
+  TESTASSERT(small->get_size_class() == size_class::large);
+  TESTASSERT(small->N_bytes == 3000 and small->md.pdcp_sn == 5 and check_content(*small));
+
+  // Copies of small buffers keep a small storage
+  unique_byte_buffer_t src = make_sized_byte_buffer(10);
+  TESTASSERT(src != nullptr);
+  fill(*src, 10);
+  byte_buffer_t copy(*src);
+  TESTASSERT(copy.get_size_class() == size_class::small);
+  TESTASSERT(copy.N_bytes == 10 and check_content(copy));
+
+  // Moves steal the pooled storage and leave the source empty
+  byte_buffer_t moved(std::move(*large));
+  TESTASSERT(moved.get_size_class() == size_class::large);
+  TESTASSERT(moved.N_bytes == 3000 and check_content(moved));
+  TESTASSERT(large->N_bytes == 0 and large->get_size_class() == size_class::small);
+
+  // Standalone buffers keep the full size storage, which comes from the large pool
+  uint32_t      nof_large = nof_in_use(size_class::large);
+  byte_buffer_t standalone;
+  TESTASSERT(standalone.get_size_class() == size_class::large);
+  TESTASSERT(standalone.get_tailroom() == SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET);
+  TESTASSERT(nof_in_use(size_class::large) == nof_large + 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_pool_depletion()
+{
+  // Medium requests are served by the large pool when the medium pool is depleted
+  byte_buffer_metrics_t             metrics = get_byte_buffer_metrics();
+  const byte_buffer_class_metrics_t& medium = metrics[static_cast<size_t>(size_class::medium)];
+  std::vector<unique_byte_buffer_t>  pdus;
+  for (uint32_t i = medium.nof_in_use; i < medium.nof_blocks; ++i) {
+    pdus.push_back(make_sized_byte_buffer(1500));
+    TESTASSERT(pdus.back() != nullptr and pdus.back()->get_size_class() == size_class::medium);
+  }
+  uint64_t             nof_failures = nof_alloc_failures(size_class::medium);
+  unique_byte_buffer_t pdu          = make_sized_byte_buffer(1500);
+  TESTASSERT(pdu != nullptr and pdu->get_size_class() == size_class::large);
+  TESTASSERT(nof_alloc_failures(size_class::medium) == nof_failures + 1);
+
+  // A large buffer can't be shrunk while the medium pool is depleted
+  pdu->N_bytes = 1500;
+  pdu->shrink_to_fit();
+  TESTASSERT(pdu->get_size_class() == size_class::large);
+  pdus.clear();
+  pdu->shrink_to_fit();
+  TESTASSERT(pdu->get_size_class() == size_class::medium);
+
+  log_byte_buffer_metrics();
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_large_pool_depletion()
+{
+  unique_byte_buffer_t src = make_byte_buffer();
+  TESTASSERT(src != nullptr);
+  fill(*src, 3000);
+
+  // SDUs of unknown length start in a medium storage
+  unique_byte_buffer_t sdu = make_sdu_byte_buffer();
+  TESTASSERT(sdu != nullptr and sdu->get_size_class() == size_class::medium);
+  TESTASSERT(sdu->get_tailroom() >= 1500);
+
+  std::vector<unique_byte_buffer_t> pdus;
+  for (unique_byte_buffer_t pdu = make_byte_buffer(); pdu != nullptr; pdu = make_byte_buffer()) {
+    pdus.push_back(std::move(pdu));
+  }
+  TESTASSERT(pdus.size() <= NOF_LARGE_BYTE_BUFFERS);
+
+  // Copies are not truncated when the large pool is depleted
+  *sdu = *src;
+  TESTASSERT(sdu->N_bytes == 3000 and check_content(*sdu));
+  TESTASSERT(sdu->get_size_class() == size_class::large);
+
+  // Standalone buffers still get their full size storage
+  byte_buffer_t standalone(10);
+  TESTASSERT(standalone.N_bytes == 10);
+  TESTASSERT(standalone.get_tailroom() == SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET - 10);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_buffer_chain()
+{
+  // Chain views of two SDUs, in segments longer than MAX_COPY_LEN
+  const uint32_t       seg_len = byte_buffer_chain::MAX_COPY_LEN + 1;
+  shared_byte_buffer_t sdu1    = make_sized_byte_buffer(3 * seg_len);
+  shared_byte_buffer_t sdu2    = make_sized_byte_buffer(seg_len);
+  fill(*sdu1, 3 * seg_len);
+  fill(*sdu2, seg_len);
+
+  byte_buffer_chain chain;
+  TESTASSERT(chain.empty() and chain.nof_segments() == 0);
+  for (uint32_t i = 0; i < 3; ++i) {
+    chain.append(sdu1, sdu1->msg + i * seg_len, seg_len);
+  }
+  chain.append(sdu2, sdu2->msg, 0);
+  chain.append(sdu2);
+  TESTASSERT(chain.nof_segments() == 4 and chain.length() == 4 * seg_len);
+  TESTASSERT(sdu1.use_count() == 4 and sdu2.use_count() == 2);
+
+  // Flatten the whole chain and a window that crosses segment boundaries
+  std::vector<uint8_t> out(4 * seg_len);
+  TESTASSERT(chain.copy_to(out.data()) == 4 * seg_len);
+  for (uint32_t i = 0; i < 4 * seg_len; ++i) {
+    TESTASSERT(out[i] == static_cast<uint8_t>(i < 3 * seg_len ? i : i - 3 * seg_len));
+  }
+  TESTASSERT(chain.copy_to(out.data(), seg_len - 5, 20) == 20);
+  for (uint32_t i = 0; i < 20; ++i) {
+    TESTASSERT(out[i] == static_cast<uint8_t>(seg_len - 5 + i));
+  }
+  TESTASSERT(chain.copy_to(out.data(), 4 * seg_len - 10, 20) == 10);
+
+  // The SDUs outlive their owners while the chain references them
+  sdu1.reset();
+  sdu2.reset();
+  byte_buffer_chain chain2 = std::move(chain);
+  TESTASSERT(chain.empty() and chain.nof_segments() == 0);
+  TESTASSERT(chain2.length() == 4 * seg_len and chain2.segment(3).buffer.use_count() == 1);
+  TESTASSERT(chain2.copy_to(out.data(), 3 * seg_len + 50, 1) == 1 and out[0] == 50);
+
+  uint32_t nof_medium = nof_in_use(size_class::medium);
+  chain2.clear();
+  TESTASSERT(chain2.empty() and nof_in_use(size_class::medium) == nof_medium - 2);
+
+  // A full chain rejects new views without taking a reference
+  shared_byte_buffer_t sdu3 = make_sized_byte_buffer(seg_len + byte_buffer_chain::MAX_NOF_SEGMENTS);
+  fill(*sdu3, seg_len + byte_buffer_chain::MAX_NOF_SEGMENTS);
+  for (size_t i = 0; i < byte_buffer_chain::MAX_NOF_SEGMENTS; ++i) {
+    TESTASSERT(chain2.append(sdu3, sdu3->msg + i, seg_len));
+  }
+  TESTASSERT(chain2.full() and not chain2.can_append(seg_len) and not chain2.append(sdu3, sdu3->msg, seg_len));
+  TESTASSERT(chain2.append(sdu3, sdu3->msg, 0));
+  TESTASSERT(chain2.length() == byte_buffer_chain::MAX_NOF_SEGMENTS * seg_len);
+  TESTASSERT(sdu3.use_count() == byte_buffer_chain::MAX_NOF_SEGMENTS + 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_buffer_chain_copies()
+{
+  // Small segments are copied next to each other into a single segment, and do not reference their SDUs
+  byte_buffer_chain chain;
+  uint32_t          nof_small = nof_in_use(size_class::small);
+  for (uint32_t i = 0; i < 10; ++i) {
+    shared_byte_buffer_t sdu = make_sized_byte_buffer(100);
+    fill(*sdu, 100);
+    TESTASSERT(chain.append(sdu, sdu->msg + i, 10));
+    TESTASSERT(sdu.use_count() == 1);
+  }
+  TESTASSERT(nof_in_use(size_class::small) == nof_small);
+  TESTASSERT(chain.nof_segments() == 1 and chain.length() == 100 and chain.segment(0).copied);
+  std::array<uint8_t, 100> out = {};
+  TESTASSERT(chain.copy_to(out.data()) == 100);
+  for (uint32_t i = 0; i < 100; ++i) {
+    TESTASSERT(out[i] == static_cast<uint8_t>(i / 10 + i % 10));
+  }
+
+  // A referenced segment closes the copied one
+  const uint32_t       seg_len = byte_buffer_chain::MAX_COPY_LEN + 1;
+  shared_byte_buffer_t large   = make_sized_byte_buffer(seg_len);
+  fill(*large, seg_len);
+  TESTASSERT(chain.append(large) and chain.nof_segments() == 2 and not chain.segment(1).copied);
+  TESTASSERT(chain.append(large, large->msg, 10) and chain.nof_segments() == 3);
+
+  // A full chain still takes copies that fit the tailroom of its last copied segment
+  while (not chain.full()) {
+    TESTASSERT(chain.append(large));
+  }
+  TESTASSERT(not chain.can_append(10));
+  chain.clear();
+  while (chain.nof_segments() < byte_buffer_chain::MAX_NOF_SEGMENTS - 1) {
+    TESTASSERT(chain.append(large));
+  }
+  TESTASSERT(chain.append(large, large->msg, 10) and chain.full());
+  TESTASSERT(chain.can_append(byte_buffer_chain::MAX_COPY_LEN) and not chain.can_append(seg_len));
+  TESTASSERT(chain.append(large, large->msg, byte_buffer_chain::MAX_COPY_LEN));
+  TESTASSERT(chain.segment(byte_buffer_chain::MAX_NOF_SEGMENTS - 1).len == 10 + byte_buffer_chain::MAX_COPY_LEN);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_size_classes() == SRSRAN_SUCCESS);
+  TESTASSERT(test_promotion() == SRSRAN_SUCCESS);
+  TESTASSERT(test_copy_and_move() == SRSRAN_SUCCESS);
+  TESTASSERT(test_pool_depletion() == SRSRAN_SUCCESS);
+  TESTASSERT(test_large_pool_depletion() == SRSRAN_SUCCESS);
+  TESTASSERT(test_buffer_chain() == SRSRAN_SUCCESS);
+  TESTASSERT(test_buffer_chain_copies() == SRSRAN_SUCCESS);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
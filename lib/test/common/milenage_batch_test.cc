@@ -0,0 +1,237 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/liblte_security.h"
+#include "srsran/common/milenage_batch.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+using namespace srsran;
+
+namespace {
+
+std::mt19937 rand_gen(1234);
+
+struct subscriber_t {
+  uint8_t      k[16];
+  uint8_t      opc[16];
+  uint8_t      rand[16];
+  uint8_t      sqn[6];
+  uint8_t      amf[2];
+  milenage_key key;
+};
+
+void random_bytes(uint8_t* buf, size_t len)
+{
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (size_t i = 0; i < len; i++) {
+    buf[i] = dist(rand_gen);
+  }
+}
+
+void random_subscriber(subscriber_t& sub)
+{
+  random_bytes(sub.k, sizeof(sub.k));
+  random_bytes(sub.opc, sizeof(sub.opc));
+  random_bytes(sub.rand, sizeof(sub.rand));
+  random_bytes(sub.sqn, sizeof(sub.sqn));
+  random_bytes(sub.amf, sizeof(sub.amf));
+  sub.key.set(sub.k);
+}
+
+milenage_input_t make_input(const subscriber_t& sub)
+{
+  return {&sub.key, sub.opc, sub.rand, sub.sqn, sub.amf};
+}
+
+int check_against_liblte(subscriber_t& sub, const milenage_output_t& out)
+{
+  uint8_t mac_a[8], res[8], ck[16], ik[16], ak[6];
+  TESTASSERT(liblte_security_milenage_f1(sub.k, sub.opc, sub.rand, sub.sqn, sub.amf, mac_a) == LIBLTE_SUCCESS);
+  TESTASSERT(liblte_security_milenage_f2345(sub.k, sub.opc, sub.rand, res, ck, ik, ak) == LIBLTE_SUCCESS);
+  TESTASSERT(memcmp(out.mac_a, mac_a, sizeof(mac_a)) == 0);
+  TESTASSERT(memcmp(out.res, res, sizeof(res)) == 0);
+  TESTASSERT(memcmp(out.ck, ck, sizeof(ck)) == 0);
+  TESTASSERT(memcmp(out.ik, ik, sizeof(ik)) == 0);
+  TESTASSERT(memcmp(out.ak, ak, sizeof(ak)) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+/*
+ * Test set 2 of 35.208, as in test_f12345
+ */
+int test_set_2()
+{
+  uint8_t k[]    = {0x46, 0x5b, 0x5c, 0xe8, 0xb1, 0x99, 0xb4, 0x9f, 0xaa, 0x5f, 0x0a, 0x2e, 0xe2, 0x38, 0xa6, 0xbc};
+  uint8_t rand[] = {0x23, 0x55, 0x3c, 0xbe, 0x96, 0x37, 0xa8, 0x9d, 0x21, 0x8a, 0xe6, 0x4d, 0xae, 0x47, 0xbf, 0x35};
+  uint8_t sqn[]  = {0xff, 0x9b, 0xb4, 0xd0, 0xb6, 0x07};
+  uint8_t amf[]  = {0xb9, 0xb9};
+  uint8_t opc[]  = {0xcd, 0x63, 0xcb, 0x71, 0x95, 0x4a, 0x9f, 0x4e, 0x48, 0xa5, 0x99, 0x4e, 0x37, 0xa0, 0x2b, 0xaf};
+
+  uint8_t mac_a[] = {0x4a, 0x9f, 0xfa, 0xc3, 0x54, 0xdf, 0xaf, 0xb3};
+  uint8_t res[]   = {0xa5, 0x42, 0x11, 0xd5, 0xe3, 0xba, 0x50, 0xbf};
+  uint8_t ck[]    = {0xb4, 0x0b, 0xa9, 0xa3, 0xc5, 0x8b, 0x2a, 0x05, 0xbb, 0xf0, 0xd9, 0x87, 0xb2, 0x1b, 0xf8, 0xcb};
+  uint8_t ik[]    = {0xf7, 0x69, 0xbc, 0xd7, 0x51, 0x04, 0x46, 0x04, 0x12, 0x76, 0x72, 0x71, 0x1c, 0x6d, 0x34, 0x41};
+  uint8_t ak[]    = {0xaa, 0x68, 0x9c, 0x64, 0x83, 0x70};
+
+  // The test set in every position of a batch, with a full group of lanes and a remainder
+  const size_t                   nof_vectors = 2 * milenage_batch_lanes + 3;
+  std::vector<subscriber_t>      subs(nof_vectors);
+  std::vector<milenage_input_t>  in(nof_vectors);
+  std::vector<milenage_output_t> out(nof_vectors);
+  milenage_key                   key(k);
+  for (size_t pos = 0; pos < nof_vectors; pos++) {
+    for (size_t i = 0; i < nof_vectors; i++) {
+      random_subscriber(subs[i]);
+      in[i] = make_input(subs[i]);
+    }
+    in[pos] = {&key, opc, rand, sqn, amf};
+    milenage_f12345_batch(in.data(), out.data(), nof_vectors);
+
+    TESTASSERT(memcmp(out[pos].mac_a, mac_a, sizeof(mac_a)) == 0);
+    TESTASSERT(memcmp(out[pos].res, res, sizeof(res)) == 0);
+    TESTASSERT(memcmp(out[pos].ck, ck, sizeof(ck)) == 0);
+    TESTASSERT(memcmp(out[pos].ik, ik, sizeof(ik)) == 0);
+    TESTASSERT(memcmp(out[pos].ak, ak, sizeof(ak)) == 0);
+    for (size_t i = 0; i < nof_vectors; i++) {
+      if (i != pos) {
+        TESTASSERT(check_against_liblte(subs[i], out[i]) == SRSRAN_SUCCESS);
+      }
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+/*
+ * Batches of random subscribers, including several vectors of the same subscriber
+ */
+int test_random_batches()
+{
+  for (size_t nof_vectors = 1; nof_vectors <= 4 * milenage_batch_lanes + 1; nof_vectors++) {
+    std::vector<subscriber_t>      subs(nof_vectors);
+    std::vector<milenage_input_t>  in(nof_vectors);
+    std::vector<milenage_output_t> out(nof_vectors);
+    for (size_t i = 0; i < nof_vectors; i++) {
+      random_subscriber(subs[i]);
+      if (i % 3 == 2) {
+        // Same key and OPc as the previous vector, with another RAND and SQN
+        memcpy(subs[i].k, subs[i - 1].k, sizeof(subs[i].k));
+        memcpy(subs[i].opc, subs[i - 1].opc, sizeof(subs[i].opc));
+        subs[i].key.set(subs[i].k);
+      }
+      in[i] = make_input(subs[i]);
+    }
+    milenage_f12345_batch(in.data(), out.data(), nof_vectors);
+    for (size_t i = 0; i < nof_vectors; i++) {
+      TESTASSERT(check_against_liblte(subs[i], out[i]) == SRSRAN_SUCCESS);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+/*
+ * Authentication vectors per second, for a population of subscribers
+ */
+void run_benchmark()
+{
+  const size_t              nof_subs    = 4096;
+  const size_t              nof_vectors = 1000000;
+  std::vector<subscriber_t> subs(nof_subs);
+  for (subscriber_t& sub : subs) {
+    random_subscriber(sub);
+  }
+
+  auto vectors_per_sec = [](std::chrono::steady_clock::time_point tp) {
+    return nof_vectors / std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+  };
+
+  fmt::print("{:<40}{:>16}\n", "Method", "Vectors/s");
+  fmt::print("--------------------------------------------------------\n");
+
+  // liblte f1 and f2345, with their two key expansions and two TEMP computations
+  uint8_t mac_a[8], res[8], ck[16], ik[16], ak[6];
+  auto    tp = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < nof_vectors; n++) {
+    subscriber_t& sub = subs[n % nof_subs];
+    liblte_security_milenage_f1(sub.k, sub.opc, sub.rand, sub.sqn, sub.amf, mac_a);
+    liblte_security_milenage_f2345(sub.k, sub.opc, sub.rand, res, ck, ik, ak);
+  }
+  fmt::print("{:<40}{:>16.0f}\n", "liblte_security_milenage_f1/f2345", vectors_per_sec(tp));
+
+  // Batch API, expanding the key of each vector
+  milenage_output_t out[64];
+  milenage_input_t  in[64];
+  milenage_key      key;
+  tp = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < nof_vectors; n++) {
+    subscriber_t& sub = subs[n % nof_subs];
+    key.set(sub.k);
+    in[0] = {&key, sub.opc, sub.rand, sub.sqn, sub.amf};
+    milenage_f12345_batch(in, out, 1);
+  }
+  fmt::print("{:<40}{:>16.0f}\n", "batch of 1, key expanded per vector", vectors_per_sec(tp));
+
+  // Batch API, with the key schedules cached per subscriber
+  for (size_t batch_size : {1, 4, 8, 64}) {
+    tp = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < nof_vectors; n += batch_size) {
+      for (size_t i = 0; i < batch_size; i++) {
+        in[i] = make_input(subs[(n + i) % nof_subs]);
+      }
+      milenage_f12345_batch(in, out, batch_size);
+    }
+    fmt::print("{:<40}{:>16.0f}\n", fmt::format("batch of {}, cached key", batch_size), vectors_per_sec(tp));
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  bool benchmark = false;
+  int  opt;
+  while ((opt = getopt(argc, argv, "b")) != -1) {
+    switch (opt) {
+      case 'b':
+        benchmark = true;
+        break;
+      default:
+        printf("Usage: %s [-b]\n", argv[0]);
+        printf("\t-b Run the vectors/s benchmark\n");
+        return SRSRAN_ERROR;
+    }
+  }
+  srslog::init();
+
+  TESTASSERT(test_set_2() == SRSRAN_SUCCESS);
+  TESTASSERT(test_random_batches() == SRSRAN_SUCCESS);
+  if (benchmark) {
+    run_benchmark();
+  }
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -306,6 +306,47 @@ int test_multiqueue_threading4()
   return 0;
 }
 
+int test_multiqueue_concurrent_capacity(int capacity)
+{
+  std::cout << "\n===== TEST multiqueue concurrent capacity test: start =====\n";
+  // Description: producers push concurrently into a port that nobody pops, until it is full. The port capacity may not
+  //              be a power of two, and it must never be exceeded
+
+  const int                nof_producers = 4;
+  multiqueue_handler<int>  multiqueue(capacity);
+  auto                     qid = multiqueue.add_queue();
+  std::atomic<int>         nof_pushed{0};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < nof_producers; ++p) {
+    producers.emplace_back([&qid, &nof_pushed]() {
+      while (qid.try_push(1).has_value()) {
+        nof_pushed++;
+      }
+    });
+  }
+  for (std::thread& t : producers) {
+    t.join();
+  }
+  TESTASSERT(nof_pushed == capacity and qid.size() == (size_t)capacity);
+
+  // the port takes new elements as they are popped, without ever exceeding its capacity
+  int value = 0;
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < capacity; ++i) {
+      TESTASSERT(multiqueue.try_pop(&value));
+    }
+    TESTASSERT(not multiqueue.try_pop(&value));
+    for (int i = 0; i < capacity; ++i) {
+      TESTASSERT(qid.try_push(i));
+    }
+    TESTASSERT(not qid.try_push(capacity));
+  }
+
+  std::cout << "outcome: Success\n";
+  std::cout << "========================================\n";
+  return 0;
+}
+
 int test_task_thread_pool()
 {
   std::cout << "\n====== TEST task thread pool test 1: start ======\n";
@@ -499,6 +540,9 @@ int main()
   TESTASSERT(test_multiqueue_threading2() == 0);
   TESTASSERT(test_multiqueue_threading3() == 0);
   TESTASSERT(test_multiqueue_threading4() == 0);
+  TESTASSERT(test_multiqueue_concurrent_capacity(1) == 0);
+  TESTASSERT(test_multiqueue_concurrent_capacity(3) == 0);
+  TESTASSERT(test_multiqueue_concurrent_capacity(100) == 0);
 
   TESTASSERT(test_task_thread_pool() == 0);
   TESTASSERT(test_task_thread_pool2() == 0);
@@ -130,6 +130,111 @@ int test_socket_handler()
   return 0;
 }
 
+int test_socket_handler_multiple_udp()
+{
+  auto& logger = srslog::fetch_basic_logger("S1AP", false);
+
+  const uint32_t                     nof_sockets = 64;
+  std::atomic<uint32_t>              counter     = {0};
+  std::vector<srsran::unique_socket> rx_socks(nof_sockets);
+  srsran::unique_socket              tx_sock;
+  srsran::socket_manager             sockhandler;
+  rx_thread_tester                   rx_tester;
+  using namespace srsran::net_utils;
+
+  auto pdu_handler = [&counter](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+    if (pdu->N_bytes > 0) {
+      counter++;
+    }
+  };
+  for (auto& sock : rx_socks) {
+    TESTASSERT(sock.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+    TESTASSERT(sock.bind_addr("127.0.0.1", 0));
+    TESTASSERT(sockhandler.add_socket_handler(sock.fd(),
+                                              srsran::make_sdu_handler(logger, rx_tester.task_queue, pdu_handler)));
+  }
+  // registering the same fd twice must fail
+  TESTASSERT(not sockhandler.add_socket_handler(rx_socks[0].fd(),
+                                                srsran::make_sdu_handler(logger, rx_tester.task_queue, pdu_handler)));
+
+  // send one datagram to every registered socket
+  TESTASSERT(tx_sock.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  uint8_t buf[16] = {};
+  for (auto& sock : rx_socks) {
+    sockaddr_in dest    = {};
+    socklen_t   destlen = sizeof(dest);
+    TESTASSERT(getsockname(sock.fd(), (struct sockaddr*)&dest, &destlen) == 0);
+    TESTASSERT(sendto(tx_sock.fd(), buf, sizeof(buf), 0, (struct sockaddr*)&dest, destlen) == sizeof(buf));
+  }
+
+  uint32_t time_elapsed = 0;
+  while (counter != nof_sockets) {
+    usleep(100);
+    time_elapsed += 100;
+    if (time_elapsed > 3000000) {
+      return -1;
+    }
+  }
+
+  for (auto& sock : rx_socks) {
+    TESTASSERT(sockhandler.remove_socket(sock.fd()));
+  }
+  TESTASSERT(not sockhandler.remove_socket(rx_socks[0].fd()));
+  return SRSRAN_SUCCESS;
+}
+
+int test_batch_sdu_handler()
+{
+  auto& logger = srslog::fetch_basic_logger("S1AP", false);
+
+  const uint32_t         nof_pdus = 20, batch_size = 8;
+  std::atomic<uint32_t>  counter   = {0};
+  std::atomic<uint32_t>  nof_calls = {0};
+  srsran::unique_socket  rx_sock, tx_sock;
+  srsran::socket_manager sockhandler;
+  rx_thread_tester       rx_tester;
+  using namespace srsran::net_utils;
+
+  TESTASSERT(rx_sock.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  TESTASSERT(rx_sock.bind_addr("127.0.0.1", 0));
+  TESTASSERT(tx_sock.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  sockaddr_in dest    = {};
+  socklen_t   destlen = sizeof(dest);
+  TESTASSERT(getsockname(rx_sock.fd(), (struct sockaddr*)&dest, &destlen) == 0);
+
+  // Queue datagrams before the socket is registered, so that they are read in batches
+  uint8_t buf[16] = {};
+  for (uint32_t i = 0; i < nof_pdus; ++i) {
+    buf[0] = i;
+    TESTASSERT(sendto(tx_sock.fd(), buf, i + 1, 0, (struct sockaddr*)&dest, destlen) == (ssize_t)i + 1);
+  }
+
+  auto batch_handler = [&counter, &nof_calls](srsran::rx_sdu_batch_t& batch) {
+    TESTASSERT(batch.size() <= batch_size);
+    for (auto& p : batch) {
+      // datagrams must preserve their order and length
+      TESTASSERT(p.first->N_bytes == counter + 1);
+      TESTASSERT(p.first->msg[0] == counter);
+      counter++;
+    }
+    nof_calls++;
+  };
+  TESTASSERT(sockhandler.add_socket_handler(
+      rx_sock.fd(), srsran::make_batch_sdu_handler(logger, rx_tester.task_queue, batch_handler, batch_size)));
+
+  uint32_t time_elapsed = 0;
+  while (counter != nof_pdus) {
+    usleep(100);
+    time_elapsed += 100;
+    if (time_elapsed > 3000000) {
+      return -1;
+    }
+  }
+  TESTASSERT(nof_calls < nof_pdus);
+  TESTASSERT(sockhandler.remove_socket(rx_sock.fd()));
+  return SRSRAN_SUCCESS;
+}
+
 int test_sctp_bind_error()
 {
   srsran::unique_socket sock;
@@ -157,6 +262,8 @@ int main()
   srslog::init();
 
   TESTASSERT(test_socket_handler() == 0);
+  TESTASSERT(test_socket_handler_multiple_udp() == 0);
+  TESTASSERT(test_batch_sdu_handler() == 0);
   TESTASSERT(test_sctp_bind_error() == 0);
 
   return 0;
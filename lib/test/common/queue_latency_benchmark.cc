@@ -0,0 +1,153 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/block_queue.h"
+#include "srsran/common/lockfree_queue.h"
+#include "srsran/common/multiqueue.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+namespace srsran {
+
+struct latency_result {
+  double avg_usec;
+  double q50_usec;
+  double q99_usec;
+  double q999_usec;
+  double max_usec;
+};
+
+static uint64_t now_nsec()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Measures the time from the push of a timestamp by the producer until its pop by the consumer thread. The producer
+/// pushes one timestamp every period_usec, as the PHY threads hand over their results to the stack
+template <typename PushOp, typename PopOp>
+latency_result run_handoff(uint32_t nof_msgs, uint32_t period_usec, PushOp&& push_op, PopOp&& pop_op)
+{
+  std::vector<uint64_t> lat_nsec(nof_msgs);
+  std::thread           consumer([&lat_nsec, &pop_op]() {
+    for (uint64_t& lat : lat_nsec) {
+      uint64_t tstamp = pop_op();
+      lat             = now_nsec() - tstamp;
+    }
+  });
+
+  auto next = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_msgs; ++i) {
+    next += std::chrono::microseconds(period_usec);
+    std::this_thread::sleep_until(next);
+    push_op(now_nsec());
+  }
+  consumer.join();
+
+  std::sort(lat_nsec.begin(), lat_nsec.end());
+  latency_result result;
+  result.avg_usec  = std::accumulate(lat_nsec.begin(), lat_nsec.end(), 0.0) / nof_msgs / 1000.0;
+  result.q50_usec  = lat_nsec[nof_msgs / 2] / 1000.0;
+  result.q99_usec  = lat_nsec[std::min((size_t)(nof_msgs * 0.99), lat_nsec.size() - 1)] / 1000.0;
+  result.q999_usec = lat_nsec[std::min((size_t)(nof_msgs * 0.999), lat_nsec.size() - 1)] / 1000.0;
+  result.max_usec  = lat_nsec.back() / 1000.0;
+  return result;
+}
+
+void print_result(const char* queue_name, const char* policy_name, const latency_result& result)
+{
+  fmt::print("{:>14}{:>12}{:>11.1f}{:>10.1f}{:>10.1f}{:>11.1f}{:>10.1f}\n",
+             queue_name,
+             policy_name,
+             result.avg_usec,
+             result.q50_usec,
+             result.q99_usec,
+             result.q999_usec,
+             result.max_usec);
+}
+
+int run_benchmark(uint32_t nof_msgs, uint32_t period_usec)
+{
+  const uint32_t capacity = 64;
+
+  fmt::print("Handoff latency with one push every {} usec, {} pushes\n", period_usec, nof_msgs);
+  fmt::print(
+      "{:>14}{:>12}{:>11}{:>10}{:>10}{:>11}{:>10}\n", "Queue", "Waiting", "avg [usec]", "q0.5", "q0.99", "q0.999", "max");
+  fmt::print("--------------------------------------------------------------------------------\n");
+
+  {
+    block_queue<uint64_t> queue(capacity);
+    latency_result        result = run_handoff(
+        nof_msgs, period_usec, [&queue](uint64_t t) { queue.push(t); }, [&queue]() { return queue.wait_pop(); });
+    print_result("block_queue", "condvar", result);
+  }
+
+  for (queue_wait_policy policy :
+       {queue_wait_policy::sleep, queue_wait_policy::busy_poll, queue_wait_policy::spin_futex}) {
+    multiqueue_handler<uint64_t>               multiqueue(capacity, policy);
+    multiqueue_handler<uint64_t>::queue_handle port   = multiqueue.add_queue();
+    latency_result                             result = run_handoff(
+        nof_msgs,
+        period_usec,
+        [&port](uint64_t t) { port.push(t); },
+        [&multiqueue]() {
+          uint64_t t = 0;
+          TESTASSERT(multiqueue.wait_pop(&t));
+          return t;
+        });
+    print_result("multiqueue", to_string(policy), result);
+  }
+
+  for (queue_wait_policy policy :
+       {queue_wait_policy::sleep, queue_wait_policy::busy_poll, queue_wait_policy::spin_futex}) {
+    spsc_blocking_queue<uint64_t> queue(capacity, policy);
+    latency_result                result = run_handoff(
+        nof_msgs,
+        period_usec,
+        [&queue](uint64_t t) { TESTASSERT(queue.push(t)); },
+        [&queue]() {
+          uint64_t t = 0;
+          TESTASSERT(queue.pop_wait(t));
+          return t;
+        });
+    print_result("spsc_queue", to_string(policy), result);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsran
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  uint32_t nof_msgs = 200;
+  if (argc > 1 and strcmp(argv[1], "benchmark") == 0) {
+    nof_msgs = 20000;
+  }
+
+  TESTASSERT(srsran::run_benchmark(nof_msgs, 100) == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
@@ -236,6 +236,51 @@ int concat_test()
   return SRSRAN_SUCCESS;
 }
 
+// Many small SDUs fit a single PDU, beyond the number of segments that the PDU payload can reference
+int concat_small_sdus_test()
+{
+  rlc_am_tester         tester(true, nullptr);
+  srsran::timer_handler timers(8);
+
+  rlc_am rlc1(srsran_rat_t::lte, srslog::fetch_basic_logger("RLC_AM_1"), 1, &tester, &tester, &timers);
+  rlc_am rlc2(srsran_rat_t::lte, srslog::fetch_basic_logger("RLC_AM_2"), 1, &tester, &tester, &timers);
+
+  if (not rlc1.configure(rlc_config_t::default_rlc_am_config())) {
+    return -1;
+  }
+
+  if (not rlc2.configure(rlc_config_t::default_rlc_am_config())) {
+    return -1;
+  }
+
+  const uint32_t nof_sdus = 4 * byte_buffer_chain::MAX_NOF_SEGMENTS;
+  const uint32_t sdu_size = 100;
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    unique_byte_buffer_t sdu = srsran::make_sized_byte_buffer(sdu_size);
+    sdu->N_bytes             = sdu_size;
+    std::fill(sdu->msg, sdu->msg + sdu_size, i);
+    sdu->md.pdcp_sn = i;
+    rlc1.write_sdu(std::move(sdu));
+  }
+
+  // Read all SDUs in one PDU
+  uint32_t      buffer_state = rlc1.get_buffer_state();
+  byte_buffer_t pdu_buf;
+  int           len = rlc1.read_pdu(pdu_buf.msg, buffer_state);
+  pdu_buf.N_bytes   = len;
+  TESTASSERT(len == (int)buffer_state);
+  TESTASSERT(0 == rlc1.get_buffer_state());
+
+  rlc2.write_pdu(pdu_buf.msg, pdu_buf.N_bytes);
+  TESTASSERT(tester.sdus.size() == nof_sdus);
+  for (uint32_t i = 0; i < tester.sdus.size(); i++) {
+    TESTASSERT(tester.sdus[i]->N_bytes == sdu_size);
+    TESTASSERT(tester.sdus[i]->msg[0] == i and tester.sdus[i]->msg[sdu_size - 1] == i);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int segment_test(bool in_seq_rx)
 {
   rlc_am_tester         tester(true, nullptr);
@@ -4117,6 +4162,11 @@ int main(int argc, char** argv)
     exit(-1);
   };
 
+  if (concat_small_sdus_test()) {
+    printf("concat_small_sdus_test failed\n");
+    exit(-1);
+  };
+
   if (segment_test(true)) {
     printf("segment_test with in-order PDU reception failed\n");
     exit(-1);
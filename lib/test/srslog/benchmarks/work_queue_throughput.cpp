@@ -0,0 +1,145 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/circular_buffer.h"
+#include "srsran/srslog/detail/support/thread_utils.h"
+#include "srsran/srslog/detail/support/work_queue.h"
+#include "srsran/srslog/bundled/fmt/format.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace srslog;
+
+static constexpr unsigned num_entries_per_thread = 200000;
+
+namespace {
+
+/// Payload pushed through the queues, roughly the size of a log entry.
+struct bench_entry {
+  uint64_t data[8];
+};
+
+/// Mutex protected queue, this was the implementation of the work queue before the lock-free one. Kept here as the
+/// baseline for the comparison.
+template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
+class mutex_work_queue
+{
+  srsran::dyn_circular_buffer<T> queue;
+  detail::mutex                  m;
+
+public:
+  mutex_work_queue() : queue(capacity) {}
+
+  bool push(T&& value)
+  {
+    detail::scoped_lock lock(m);
+    if (queue.full()) {
+      return false;
+    }
+    queue.push(std::move(value));
+    return true;
+  }
+
+  std::pair<bool, T> try_pop()
+  {
+    detail::scoped_lock lock(m);
+    if (queue.empty()) {
+      return {false, T()};
+    }
+    T item = std::move(queue.top());
+    queue.pop();
+    return {true, std::move(item)};
+  }
+};
+
+} // namespace
+
+/// Pushes entries into the queue from the specified number of producer threads while the calling thread consumes
+/// them. Returns the throughput in millions of entries per second.
+template <typename Queue>
+static double run_benchmark(Queue& queue, unsigned num_producers)
+{
+  std::atomic<bool>        start_flag(false);
+  std::vector<std::thread> producers;
+  producers.reserve(num_producers);
+
+  for (unsigned i = 0; i != num_producers; ++i) {
+    producers.emplace_back([&queue, &start_flag, i]() {
+      while (!start_flag.load(std::memory_order_acquire)) {
+      }
+      for (unsigned j = 0; j != num_entries_per_thread; ++j) {
+        bench_entry e = {{i, j}};
+        // Retry when the queue is full so that every entry reaches the consumer.
+        while (!queue.push(std::move(e))) {
+        }
+      }
+    });
+  }
+
+  uint64_t total    = uint64_t(num_producers) * num_entries_per_thread;
+  uint64_t received = 0;
+  uint64_t checksum = 0;
+
+  auto begin = std::chrono::steady_clock::now();
+  start_flag.store(true, std::memory_order_release);
+  while (received != total) {
+    auto item = queue.try_pop();
+    if (item.first) {
+      checksum += item.second.data[1];
+      ++received;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  for (auto& t : producers) {
+    t.join();
+  }
+
+  // Every producer pushes the sequence 0..N-1.
+  uint64_t expected = uint64_t(num_producers) * (uint64_t(num_entries_per_thread) * (num_entries_per_thread - 1) / 2);
+  if (checksum != expected) {
+    fmt::print("Checksum mismatch: expected {}, got {}\n", expected, checksum);
+  }
+
+  double secs = std::chrono::duration_cast<std::chrono::duration<double> >(end - begin).count();
+  return total / secs / 1e6;
+}
+
+int main()
+{
+  fmt::print("SRSLOG Work Queue Throughput Benchmark - {} entries per producer\n"
+             "All values in millions of entries per second\n"
+             "Producers: | Mutex | Lock-free |\n",
+             num_entries_per_thread);
+
+  for (auto n : {1, 2, 4, 8}) {
+    mutex_work_queue<bench_entry>   mutex_queue;
+    detail::work_queue<bench_entry> lockfree_queue;
+
+    double mutex_thr    = run_benchmark(mutex_queue, n);
+    double lockfree_thr = run_benchmark(lockfree_queue, n);
+
+    fmt::print("{:10} |{:7.2f}|{:11.2f}|\n", n, mutex_thr, lockfree_thr);
+  }
+
+  return 0;
+}
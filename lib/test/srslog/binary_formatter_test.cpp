@@ -0,0 +1,219 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "file_test_utils.h"
+#include "src/srslog/formatters/binary_decoder.h"
+#include "src/srslog/formatters/text_formatter.h"
+#include "src/srslog/sinks/binary_file_sink.h"
+#include "testing_helpers.h"
+#include <numeric>
+
+using namespace srslog;
+
+static constexpr char log_filename[] = "binary_formatter_test.log";
+
+/// Helper to build a log entry.
+static detail::log_entry_metadata build_log_entry_metadata(fmt::dynamic_format_arg_store<fmt::printf_context>* store)
+{
+  // Create a time point 50000us from epoch.
+  using tp_ty = std::chrono::time_point<std::chrono::high_resolution_clock>;
+  tp_ty tp(std::chrono::microseconds(50000));
+
+  if (store) {
+    store->push_back(88);
+    store->push_back(3.5);
+    store->push_back("abc");
+    store->push_back('c');
+    store->push_back(-5ll);
+    store->push_back(7u);
+  }
+
+  return {tp, {10, true}, "Text %d %.1f %s %c %lld %u", store, "ABC", 'Z'};
+}
+
+/// Formats the entry with the binary formatter through the sink and returns
+/// the result of decoding the file with the text formatter.
+static std::string binary_roundtrip(std::vector<detail::log_entry_metadata> entries)
+{
+  {
+    binary_file_sink s(log_filename, 0, false);
+    for (auto& entry : entries) {
+      fmt::memory_buffer buffer;
+      s.get_formatter().format(std::move(entry), buffer);
+      s.write(detail::memory_buffer(buffer.data(), buffer.size()));
+    }
+  }
+
+  std::FILE* in  = std::fopen(log_filename, "rb");
+  std::FILE* out = std::tmpfile();
+  if (!in || !out) {
+    return {};
+  }
+
+  text_formatter formatter;
+  binary_decoder decoder(formatter);
+  if (decoder.decode(in, out)) {
+    return {};
+  }
+
+  std::string result(std::ftell(out), '\0');
+  std::rewind(out);
+  result.resize(std::fread(&result[0], 1, result.size(), out));
+  std::fclose(in);
+  std::fclose(out);
+
+  return result;
+}
+
+/// Returns the result of formatting the entry with the text formatter.
+static std::string text_format(detail::log_entry_metadata entry)
+{
+  fmt::memory_buffer buffer;
+  text_formatter{}.format(std::move(entry), buffer);
+  return fmt::to_string(buffer);
+}
+
+static bool when_log_entry_is_decoded_then_text_output_matches()
+{
+  file_test_utils::scoped_file_deleter               deleter(log_filename);
+  fmt::dynamic_format_arg_store<fmt::printf_context> store1;
+  fmt::dynamic_format_arg_store<fmt::printf_context> store2;
+
+  std::vector<detail::log_entry_metadata> entries;
+  entries.push_back(build_log_entry_metadata(&store1));
+  std::string expected = text_format(build_log_entry_metadata(&store2));
+
+  ASSERT_EQ(expected, "1970-01-01T00:00:00.050000 [ABC    ] [Z] [   10] Text 88 3.5 abc c -5 7\n");
+  ASSERT_EQ(binary_roundtrip(std::move(entries)), expected);
+
+  return true;
+}
+
+static bool when_log_entry_has_no_args_then_text_output_matches()
+{
+  file_test_utils::scoped_file_deleter deleter(log_filename);
+
+  auto entry            = build_log_entry_metadata(nullptr);
+  entry.fmtstring       = "Plain text";
+  entry.log_name        = "";
+  entry.log_tag         = '\0';
+  entry.context.enabled = false;
+  std::string expected  = text_format(entry);
+
+  ASSERT_EQ(binary_roundtrip({entry}), expected);
+
+  return true;
+}
+
+static bool when_log_entry_has_hex_dump_then_text_output_matches()
+{
+  file_test_utils::scoped_file_deleter               deleter(log_filename);
+  fmt::dynamic_format_arg_store<fmt::printf_context> store1;
+  fmt::dynamic_format_arg_store<fmt::printf_context> store2;
+
+  std::vector<uint8_t> hex_dump(40);
+  std::iota(hex_dump.begin(), hex_dump.end(), 0);
+
+  std::vector<detail::log_entry_metadata> entries;
+  entries.push_back(build_log_entry_metadata(&store1));
+  entries.back().hex_dump = hex_dump;
+  auto entry              = build_log_entry_metadata(&store2);
+  entry.hex_dump          = hex_dump;
+  std::string expected    = text_format(std::move(entry));
+
+  ASSERT_EQ(binary_roundtrip(std::move(entries)), expected);
+
+  return true;
+}
+
+static bool when_strings_are_repeated_then_they_are_defined_once()
+{
+  file_test_utils::scoped_file_deleter deleter(log_filename);
+
+  auto entry = build_log_entry_metadata(nullptr);
+
+  fmt::memory_buffer first;
+  fmt::memory_buffer second;
+  binary_formatter   formatter;
+  formatter.format(detail::log_entry_metadata(entry), first);
+  formatter.format(detail::log_entry_metadata(entry), second);
+
+  // The second entry refers to the strings defined by the first one.
+  ASSERT_EQ(second.size() < first.size(), true);
+  ASSERT_EQ(second[0], 'E');
+
+  return true;
+}
+
+static bool when_file_is_rotated_then_each_file_is_decodable()
+{
+  std::string                          filename0 = file_utils::build_filename_with_index(log_filename, 0);
+  std::string                          filename1 = file_utils::build_filename_with_index(log_filename, 1);
+  file_test_utils::scoped_file_deleter deleter   = {filename0, filename1};
+
+  auto        entry    = build_log_entry_metadata(nullptr);
+  std::string expected = text_format(entry);
+
+  {
+    // Each entry is far smaller than the minimum file size of 4KB.
+    binary_file_sink s(log_filename, 4 * 1024, false);
+    unsigned         num_entries = 0;
+    while (!file_test_utils::file_exists(filename1)) {
+      fmt::memory_buffer buffer;
+      s.get_formatter().format(detail::log_entry_metadata(entry), buffer);
+      s.write(detail::memory_buffer(buffer.data(), buffer.size()));
+      ++num_entries;
+    }
+    ASSERT_NE(num_entries, 0);
+  }
+
+  // The second file has no entry records defining strings, they come from the
+  // header.
+  std::FILE* in  = std::fopen(filename1.c_str(), "rb");
+  std::FILE* out = std::tmpfile();
+  ASSERT_NE(in, nullptr);
+  ASSERT_NE(out, nullptr);
+
+  text_formatter formatter;
+  binary_decoder decoder(formatter);
+  ASSERT_EQ(bool(decoder.decode(in, out)), false);
+
+  std::string result(std::ftell(out), '\0');
+  std::rewind(out);
+  result.resize(std::fread(&result[0], 1, result.size(), out));
+  std::fclose(in);
+  std::fclose(out);
+
+  ASSERT_EQ(result, expected);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_log_entry_is_decoded_then_text_output_matches);
+  TEST_FUNCTION(when_log_entry_has_no_args_then_text_output_matches);
+  TEST_FUNCTION(when_log_entry_has_hex_dump_then_text_output_matches);
+  TEST_FUNCTION(when_strings_are_repeated_then_they_are_defined_once);
+  TEST_FUNCTION(when_file_is_rotated_then_each_file_is_decodable);
+
+  return 0;
+}
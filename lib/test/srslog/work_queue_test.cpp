@@ -0,0 +1,162 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/srslog/detail/support/work_queue.h"
+#include "testing_helpers.h"
+#include <thread>
+#include <vector>
+
+using namespace srslog;
+
+static constexpr size_t test_capacity = 16;
+
+static bool when_queue_is_empty_then_pop_fails()
+{
+  detail::work_queue<int, test_capacity> queue;
+
+  ASSERT_EQ(queue.try_pop().first, false);
+
+  return true;
+}
+
+static bool when_elements_are_pushed_then_they_are_popped_in_order()
+{
+  detail::work_queue<int, test_capacity> queue;
+
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_EQ(queue.push(i), true);
+  }
+
+  for (int i = 0; i != 3; ++i) {
+    auto item = queue.try_pop();
+    ASSERT_EQ(item.first, true);
+    ASSERT_EQ(item.second, i);
+  }
+  ASSERT_EQ(queue.try_pop().first, false);
+
+  return true;
+}
+
+static bool when_queue_is_full_then_push_fails_and_is_almost_full()
+{
+  detail::work_queue<int, test_capacity> queue;
+
+  ASSERT_EQ(queue.is_almost_full(), false);
+  for (size_t i = 0; i != test_capacity; ++i) {
+    ASSERT_EQ(queue.push(int(i)), true);
+  }
+  ASSERT_EQ(queue.push(-1), false);
+  ASSERT_EQ(queue.is_almost_full(), true);
+
+  // Space is reclaimed after popping.
+  ASSERT_EQ(queue.try_pop().second, 0);
+  ASSERT_EQ(queue.push(-1), true);
+
+  return true;
+}
+
+static bool when_queue_wraps_around_then_elements_are_preserved()
+{
+  detail::work_queue<int, test_capacity> queue;
+
+  for (int i = 0; i != 10 * int(test_capacity); ++i) {
+    ASSERT_EQ(queue.push(i), true);
+    auto item = queue.try_pop();
+    ASSERT_EQ(item.first, true);
+    ASSERT_EQ(item.second, i);
+  }
+
+  return true;
+}
+
+static bool when_multiple_producers_push_then_consumer_receives_all_elements()
+{
+  static constexpr unsigned num_producers = 4;
+  static constexpr unsigned num_elements  = 20000;
+
+  detail::work_queue<unsigned, 1024> queue;
+  std::vector<std::thread>           producers;
+
+  for (unsigned i = 0; i != num_producers; ++i) {
+    producers.emplace_back([&queue, i]() {
+      for (unsigned j = 0; j != num_elements; ++j) {
+        while (!queue.push(i * num_elements + j)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Elements of each producer must arrive in order.
+  std::vector<unsigned> next(num_producers, 0);
+  unsigned              received = 0;
+  while (received != num_producers * num_elements) {
+    auto item = queue.try_pop();
+    if (!item.first) {
+      queue.wait_for_entries(std::chrono::microseconds(1000));
+      continue;
+    }
+    unsigned producer = item.second / num_elements;
+    ASSERT_EQ(item.second % num_elements, next[producer]);
+    ++next[producer];
+    ++received;
+  }
+
+  for (auto& t : producers) {
+    t.join();
+  }
+  ASSERT_EQ(queue.try_pop().first, false);
+
+  return true;
+}
+
+static bool when_consumer_is_waiting_then_push_wakes_it_up()
+{
+  detail::work_queue<int, test_capacity> queue;
+
+  std::thread producer([&queue]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.push(42);
+  });
+
+  auto begin = std::chrono::steady_clock::now();
+  queue.wait_for_entries(std::chrono::microseconds(5000000));
+  auto elapsed = std::chrono::steady_clock::now() - begin;
+  producer.join();
+
+  // The consumer must have been woken up well before the timeout expired.
+  ASSERT_EQ(elapsed < std::chrono::seconds(4), true);
+  ASSERT_EQ(queue.try_pop().second, 42);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_queue_is_empty_then_pop_fails);
+  TEST_FUNCTION(when_elements_are_pushed_then_they_are_popped_in_order);
+  TEST_FUNCTION(when_queue_is_full_then_push_fails_and_is_almost_full);
+  TEST_FUNCTION(when_queue_wraps_around_then_elements_are_preserved);
+  TEST_FUNCTION(when_multiple_producers_push_then_consumer_receives_all_elements);
+  TEST_FUNCTION(when_consumer_is_waiting_then_push_wakes_it_up);
+
+  return 0;
+}
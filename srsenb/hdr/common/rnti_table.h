@@ -0,0 +1,200 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_RNTI_TABLE_H
+#define SRSENB_RNTI_TABLE_H
+
+#include "common_enb.h"
+#include "srsran/adt/detail/type_storage.h"
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/support/srsran_assert.h"
+#include <array>
+#include <atomic>
+
+namespace srsenb {
+
+/**
+ * Flat table of objects indexed by RNTI, with no hashing nor tree walk in the lookups.
+ *
+ * C-RNTIs take the slot rnti % N. With N = SRSENB_MAX_UES the slots never collide, because the MAC only allocates
+ * C-RNTIs whose slot is free in its own rnti_map_t and removes them from the PHY before releasing the slot. RA-RNTIs
+ * and the M/P/SI-RNTIs take one of the NOF_RESERVED_SLOTS slots placed after the C-RNTI ones.
+ *
+ * An object is constructed before its slot is flagged as present (release), and readers check the flag (acquire)
+ * before touching the object, so a lookup never sees a partially built object. Writers must be serialized by the
+ * caller, and an RNTI can only be erased when no other thread is accessing it, which in practice means that the
+ * readers hold the same lock as the writers.
+ *
+ * @tparam T object stored for each RNTI
+ * @tparam N number of C-RNTI slots
+ */
+template <typename T, size_t N = SRSENB_MAX_UES>
+class rnti_table
+{
+public:
+  static const size_t NOF_RESERVED_SLOTS = 16;
+
+  using key_type    = uint16_t;
+  using mapped_type = T;
+  using value_type  = std::pair<uint16_t, T>;
+
+  template <typename Table, typename Value>
+  class iter_impl
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = Value;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = Value*;
+    using reference         = Value&;
+
+    iter_impl(Table* table_, size_t idx_) : table(table_), idx(idx_)
+    {
+      if (idx < table->capacity() and not table->is_present(idx)) {
+        ++(*this);
+      }
+    }
+
+    iter_impl& operator++()
+    {
+      while (++idx < table->capacity() and not table->is_present(idx)) {
+      }
+      return *this;
+    }
+
+    Value& operator*() const
+    {
+      srsran_assert(idx < table->capacity(), "Iterator out-of-bounds (%zd >= %zd)", idx, table->capacity());
+      return table->buffer[idx].get();
+    }
+    Value* operator->() const { return &(**this); }
+
+    bool operator==(const iter_impl& other) const { return table == other.table and idx == other.idx; }
+    bool operator!=(const iter_impl& other) const { return not(*this == other); }
+
+  private:
+    Table* table = nullptr;
+    size_t idx   = 0;
+  };
+  using iterator       = iter_impl<rnti_table<T, N>, value_type>;
+  using const_iterator = iter_impl<const rnti_table<T, N>, const value_type>;
+
+  rnti_table()
+  {
+    for (std::atomic<bool>& p : present) {
+      p.store(false, std::memory_order_relaxed);
+    }
+  }
+  rnti_table(const rnti_table&) = delete;
+  rnti_table& operator=(const rnti_table&) = delete;
+  ~rnti_table() { clear(); }
+
+  /// Slot of a given RNTI, C-RNTIs first and reserved RNTIs afterwards
+  static size_t slot_idx(uint16_t rnti)
+  {
+    return SRSRAN_RNTI_ISUSER(rnti) ? rnti % N : N + rnti % NOF_RESERVED_SLOTS;
+  }
+
+  bool contains(uint16_t rnti) const
+  {
+    size_t idx = slot_idx(rnti);
+    return is_present(idx) and buffer[idx].get().first == rnti;
+  }
+
+  /// Constructs the object in the RNTI slot, fails if the slot is taken by this or another RNTI
+  template <typename... Args>
+  bool emplace(uint16_t rnti, Args&&... args)
+  {
+    size_t idx = slot_idx(rnti);
+    if (is_present(idx)) {
+      return false;
+    }
+    buffer[idx].emplace(std::piecewise_construct,
+                        std::forward_as_tuple(rnti),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    count++;
+    present[idx].store(true, std::memory_order_release);
+    return true;
+  }
+  bool insert(uint16_t rnti, const T& obj) { return emplace(rnti, obj); }
+  bool insert(uint16_t rnti, T&& obj) { return emplace(rnti, std::move(obj)); }
+
+  bool erase(uint16_t rnti)
+  {
+    if (not contains(rnti)) {
+      return false;
+    }
+    size_t idx = slot_idx(rnti);
+    present[idx].store(false, std::memory_order_release);
+    buffer[idx].destroy();
+    count--;
+    return true;
+  }
+
+  void clear()
+  {
+    for (size_t idx = 0; idx < capacity(); ++idx) {
+      if (is_present(idx)) {
+        present[idx].store(false, std::memory_order_release);
+        buffer[idx].destroy();
+      }
+    }
+    count = 0;
+  }
+
+  T& operator[](uint16_t rnti)
+  {
+    srsran_assert(contains(rnti), "Accessing non-existent RNTI=0x%x", rnti);
+    return buffer[slot_idx(rnti)].get().second;
+  }
+  const T& operator[](uint16_t rnti) const
+  {
+    srsran_assert(contains(rnti), "Accessing non-existent RNTI=0x%x", rnti);
+    return buffer[slot_idx(rnti)].get().second;
+  }
+
+  /// Returns a pointer to the RNTI object, or nullptr if the RNTI is not in the table
+  T* find_ptr(uint16_t rnti) { return contains(rnti) ? &buffer[slot_idx(rnti)].get().second : nullptr; }
+  const T* find_ptr(uint16_t rnti) const { return contains(rnti) ? &buffer[slot_idx(rnti)].get().second : nullptr; }
+
+  iterator       find(uint16_t rnti) { return contains(rnti) ? iterator(this, slot_idx(rnti)) : end(); }
+  const_iterator find(uint16_t rnti) const { return contains(rnti) ? const_iterator(this, slot_idx(rnti)) : end(); }
+
+  size_t size() const { return count; }
+  bool   empty() const { return count == 0; }
+  size_t capacity() const { return N + NOF_RESERVED_SLOTS; }
+
+  iterator       begin() { return iterator(this, 0); }
+  iterator       end() { return iterator(this, capacity()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, capacity()); }
+
+private:
+  bool is_present(size_t idx) const { return present[idx].load(std::memory_order_acquire); }
+
+  std::array<srsran::detail::type_storage<value_type>, N + NOF_RESERVED_SLOTS> buffer;
+  std::array<std::atomic<bool>, N + NOF_RESERVED_SLOTS>                      present;
+  std::atomic<size_t>                                                         count{0};
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_RNTI_TABLE_H
@@ -46,6 +46,8 @@ public:
 
   virtual void get_metrics(std::vector<phy_metrics_t>& m) = 0;
 
+  virtual void get_pusch_fanout_metrics(pusch_fanout_metrics_t& m) = 0;
+
   virtual void cmd_cell_gain(uint32_t cell_idx, float gain_db) = 0;
 
   virtual void cmd_cell_measure() = 0;
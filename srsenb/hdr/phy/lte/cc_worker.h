@@ -22,9 +22,14 @@
 #ifndef SRSENB_CC_WORKER_H
 #define SRSENB_CC_WORKER_H
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <string.h>
 
 #include "../phy_common.h"
+#include "srsenb/hdr/common/rnti_table.h"
+#include "srsran/common/thread_pool.h"
 #include "srsran/srslog/srslog.h"
 
 #define LOG_EXECTIME
@@ -37,7 +42,7 @@ class cc_worker
 public:
   cc_worker(srslog::basic_logger& logger);
   ~cc_worker();
-  void init(phy_common* phy, uint32_t cc_idx);
+  void init(phy_common* phy, uint32_t cc_idx, srsran::task_thread_pool* pusch_pool = nullptr);
   void reset();
 
   cf_t* get_buffer_rx(uint32_t antenna_idx);
@@ -62,16 +67,28 @@ public:
                srsran_mbsfn_cfg_t*                  mbsfn_cfg);
 
   uint32_t get_metrics(std::vector<phy_metrics_t>& metrics);
+  void     get_pusch_fanout_metrics(pusch_fanout_metrics_t& metrics);
 
 private:
   constexpr static float PUSCH_RL_SNR_DB_TH = 1.0f;
   constexpr static float PUCCH_RL_CORR_TH   = 0.15f;
 
   int  encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
+  // Decoding result of a single PUSCH grant, kept until it is reported to the MAC in grant order
+  struct pusch_job_t {
+    srsran_ul_cfg_t       ul_cfg       = {};
+    srsran_pusch_res_t    pusch_res    = {};
+    srsran_chest_ul_res_t chest_res    = {};
+    bool                  uci_required = false;
+    bool                  valid        = false;
+    uint32_t              decode_us    = 0;
+  };
+
   int  encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srsran_mbsfn_cfg_t* mbsfn_cfg);
-  bool decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
-                         srsran_ul_cfg_t&                           ul_cfg,
-                         srsran_pusch_res_t&                        pusch_res);
+  bool decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant, uint32_t lane, pusch_job_t& job);
+  void report_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant, pusch_job_t& job);
+  void decode_pusch_lane(uint32_t lane);
+  void decode_pusch_helper(uint32_t round);
   void decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch);
   int  encode_phich(stack_interface_phy_lte::ul_sched_ack_t* acks, uint32_t nof_acks);
   int  encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
@@ -120,9 +137,26 @@ private:
   // Component carrier index
   uint32_t cc_idx = 0;
 
-  // Each worker keeps a local copy of the user database. Uses more memory but more efficient to manage concurrency
-  std::map<uint16_t, ue*> ue_db;
-  std::mutex              mutex;
+  // Each worker keeps a local copy of the user database. Uses more memory but more efficient to manage concurrency.
+  // The mutex is held by work_ul() and work_dl() for the whole subframe, as rem_rnti() destroys the UE object in place
+  rnti_table<ue> ue_db;
+  std::mutex     mutex;
+
+  // PUSCH fan-out. Lane 0 is the carrier own receiver (enb_ul) used by the calling worker, the rest of lanes have
+  // their own receiver and are taken by tasks running in the shared PUSCH decoding pool
+  srsran::task_thread_pool*                                    pusch_pool        = nullptr;
+  std::vector<std::unique_ptr<srsran_enb_ul_pusch_t> >         pusch_lanes;
+  std::vector<uint32_t>                                        pusch_free_lanes;
+  std::array<pusch_job_t, stack_interface_phy_lte::MAX_GRANTS> pusch_jobs        = {};
+  stack_interface_phy_lte::ul_sched_grant_t*                   pusch_grants      = nullptr;
+  uint32_t                                                     nof_pusch_grants  = 0;
+  std::atomic<uint32_t>                                        pusch_next_grant  = {0};
+  std::mutex                                                   pusch_mutex;
+  std::condition_variable                                      pusch_cvar;
+  uint32_t                                                     pusch_round       = 0;
+  bool                                                         pusch_round_open  = false;
+  uint32_t                                                     pusch_nof_helpers = 0;
+  pusch_fanout_metrics_t                                       pusch_metrics     = {}; ///< Protected by pusch_mutex
 };
 
 } // namespace lte
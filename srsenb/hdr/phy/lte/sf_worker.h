@@ -38,7 +38,7 @@ class sf_worker : public srsran::thread_pool::worker
 public:
   sf_worker(srslog::basic_logger& logger) : logger(logger) {}
   ~sf_worker();
-  void init(phy_common* phy);
+  void init(phy_common* phy, srsran::task_thread_pool* pusch_pool = nullptr);
 
   cf_t* get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx);
   void  set_context(const srsran::phy_common_interface::worker_context_t& w_ctx);
@@ -57,6 +57,7 @@ public:
   void     start_plot();
 
   uint32_t get_metrics(std::vector<phy_metrics_t>& metrics);
+  void     get_pusch_fanout_metrics(pusch_fanout_metrics_t& metrics);
 
 private:
   void work_imp() final;
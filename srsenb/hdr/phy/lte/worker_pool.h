@@ -30,8 +30,9 @@ namespace lte {
 
 class worker_pool
 {
-  srsran::thread_pool                      pool;
-  std::vector<std::unique_ptr<sf_worker> > workers;
+  srsran::thread_pool                       pool;
+  std::vector<std::unique_ptr<sf_worker> >  workers;
+  std::unique_ptr<srsran::task_thread_pool> pusch_pool; ///< Shared by all workers for PUSCH decoding fan-out
 
 public:
   sf_worker* operator[](std::size_t pos) { return workers.at(pos).get(); }
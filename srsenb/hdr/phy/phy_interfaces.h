@@ -63,7 +63,10 @@ struct phy_args_t {
   float                   max_prach_offset_us = 10;
   uint32_t                pusch_max_its       = 10;
   uint32_t                nr_pusch_max_its    = 10;
+  uint32_t                nr_pusch_cb_workers = 0;
   bool                    pusch_8bit_decoder  = false;
+  uint32_t                pusch_cb_workers    = 0;
+  uint32_t                pusch_decode_fanout = 1;
   float                   tx_amplitude        = 1.0f;
   uint32_t                nof_phy_threads     = 1;
   std::string             equalizer_mode      = "mmse";
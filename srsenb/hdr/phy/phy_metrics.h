@@ -23,6 +23,7 @@
 #define SRSENB_PHY_METRICS_H
 
 #include <limits>
+#include <stdint.h>
 
 namespace srsenb {
 
@@ -53,6 +54,15 @@ struct phy_metrics_t {
   ul_metrics_t ul;
 };
 
+// PUSCH decoding fan-out metrics, for all the carriers
+
+struct pusch_fanout_metrics_t {
+  uint32_t nof_subframes; ///< Subframes decoded with the fan-out enabled
+  uint32_t nof_grants;
+  uint64_t serial_us;  ///< Sum of the decoding time of every grant
+  uint64_t elapsed_us; ///< Wall-clock decoding time of the subframes
+};
+
 } // namespace srsenb
 
 #endif // SRSENB_PHY_METRICS_H
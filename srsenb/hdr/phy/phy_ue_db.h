@@ -23,9 +23,9 @@
 #define SRSENB_PHY_UE_DB_H_
 
 #include "phy_interfaces.h"
+#include "srsenb/hdr/common/rnti_table.h"
 #include "srsran/interfaces/enb_mac_interfaces.h"
 #include "srsran/interfaces/enb_phy_interfaces.h"
-#include <map>
 #include <mutex>
 #include <srsran/adt/circular_array.h>
 
@@ -104,9 +104,9 @@ private:
   };
 
   /**
-   * UE database indexed by RNTI
+   * UE database indexed by RNTI, the UE objects are stored in place
    */
-  std::map<uint16_t, common_ue> ue_db;
+  rnti_table<common_ue> ue_db;
 
   /**
    * Concurrency protection mutex, allowed modifications from const methods.
@@ -22,8 +22,8 @@
 #ifndef SRSENB_PRACH_WORKER_H
 #define SRSENB_PRACH_WORKER_H
 
-#include "srsran/common/block_queue.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/lockfree_queue.h"
 #include "srsran/common/threads.h"
 #include "srsran/interfaces/enb_phy_interfaces.h"
 #include "srsran/srslog/srslog.h"
@@ -44,7 +44,7 @@ class prach_worker : srsran::thread
 {
 public:
   prach_worker(uint32_t cc_idx_, srslog::basic_logger& logger) :
-    buffer_pool(8), thread("PRACH_WORKER"), logger(logger), running(false)
+    buffer_pool(8), pending_buffers(8), thread("PRACH_WORKER"), logger(logger), running(false)
   {
     cc_idx = cc_idx_;
   }
@@ -91,8 +91,9 @@ private:
     char debug_name[SRSRAN_BUFFER_POOL_LOG_NAME_LEN];
 #endif /* SRSRAN_BUFFER_POOL_LOG_ENABLED */
   };
-  srsran::buffer_pool<sf_buffer>  buffer_pool;
-  srsran::block_queue<sf_buffer*> pending_buffers;
+  srsran::buffer_pool<sf_buffer> buffer_pool;
+  // Filled by the radio thread and emptied by the PRACH thread. Never full, as it can hold all the pool buffers
+  srsran::spsc_blocking_queue<sf_buffer*> pending_buffers;
 
   srslog::basic_logger&    logger;
   sf_buffer*               current_buffer      = nullptr;
@@ -71,6 +71,8 @@ typedef struct {
 typedef struct {
   uint32_t         sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
   uint32_t         gtpu_indirect_tunnel_timeout_msec;
+  uint32_t         gtpu_batch_size;
+  std::string      wait_policy; // How the stack thread waits for tasks (sleep, busy_poll or spin_futex)
   mac_args_t       mac;
   s1ap_args_t      s1ap;
   pcap_args_t      mac_pcap;
@@ -66,12 +66,28 @@ struct mac_cc_info_t {
   uint32_t cc_rach_counter;
 };
 
+/// Contention on the scheduler lock since the previous metrics read.
+struct mac_sched_lock_metrics_t {
+  /// Number of times the scheduler lock was taken.
+  uint64_t nof_locks;
+  /// Number of times the lock was held by another thread and the caller had to wait.
+  uint64_t nof_contended;
+  /// Total time spent waiting for the lock, in microseconds.
+  uint64_t wait_time_us;
+  /// Feedback events pushed to the async feedback queues.
+  uint64_t nof_queued_events;
+  /// Feedback events that found their queue full and were applied under the lock.
+  uint64_t nof_queue_full;
+};
+
 /// Main MAC metrics.
 struct mac_metrics_t {
   /// Per CC info.
   std::vector<mac_cc_info_t> cc_info;
   /// Per UE MAC metrics.
   std::vector<mac_ue_metrics_t> ues;
+  /// Scheduler lock contention.
+  mac_sched_lock_metrics_t sched_lock;
 };
 
 } // namespace srsenb
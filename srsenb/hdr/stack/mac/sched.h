@@ -26,7 +26,13 @@
 #include "sched_interface.h"
 #include "sched_ue.h"
 #include "srsenb/hdr/common/common_enb.h"
+#include "srsenb/hdr/stack/mac/common/mac_metrics.h"
+#include "srsran/adt/move_callback.h"
+#include "srsran/adt/mpmc_queue.h"
+#include "srsran/common/thread_pool.h"
 #include <atomic>
+#include <bitset>
+#include <condition_variable>
 #include <map>
 #include <mutex>
 
@@ -89,15 +95,38 @@ public:
   std::array<int, SRSRAN_MAX_CARRIERS> get_enb_ue_activ_cc_map(uint16_t rnti) final;
   int                                  ul_buffer_add(uint16_t rnti, uint32_t lcid, uint32_t bytes) final;
   int                                  metrics_read(uint16_t rnti, mac_ue_metrics_t& metrics);
+  void                                 lock_metrics_read(mac_sched_lock_metrics_t& metrics);
 
   class carrier_sched;
 
 protected:
+  using cc_mask_t = std::bitset<SRSRAN_MAX_CARRIERS>;
+
   void new_tti(srsran::tti_point tti_rx);
+  void new_tti_parallel(srsran::tti_point tti_rx);
+  void generate_cc_group_results(srsran::tti_point tti_rx, cc_mask_t cc_group);
   bool is_generated(srsran::tti_point, uint32_t enb_cc_idx) const;
   // Helper methods
   template <typename Func>
   int ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name = nullptr, bool log_fail = true);
+  template <typename Func>
+  int  ue_feedback(uint16_t rnti, uint32_t enb_cc_idx, Func&& f, const char* func_name = nullptr);
+  void apply_feedback_queues(bool discard = false);
+  std::unique_lock<std::mutex> lock_sched();
+
+  /// UE feedback that is applied at the start of the next TTI, when async feedback is enabled
+  struct feedback_event_t {
+    uint16_t                                         rnti      = SRSRAN_INVALID_RNTI;
+    const char*                                      func_name = nullptr;
+    srsran::move_callback<void(sched_ue&), 32, true> func;
+  };
+  using feedback_queue_t = srsran::bounded_mpmc_queue<feedback_event_t>;
+
+  bool apply_feedback_queue(feedback_queue_t& q, bool discard = false);
+  int  apply_feedback_event(feedback_event_t& ev);
+
+  static const size_t   feedback_queue_size   = 2048;
+  static const uint32_t ue_feedback_queue_idx = SRSRAN_MAX_CARRIERS;
 
   // args
   rrc_interface_mac*               rrc       = nullptr;
@@ -115,6 +144,23 @@ protected:
   srsran::tti_point last_tti;
   std::mutex        sched_mutex;
   bool              configured;
+
+  // Feedback queues of each carrier (HARQ, CSI, SNR), plus one for the UE feedback not tied to a carrier (RLC, MAC CEs,
+  // BSR, PHR, SR). Only created when async feedback is enabled
+  std::array<std::unique_ptr<feedback_queue_t>, SRSRAN_MAX_CARRIERS + 1> feedback_queues;
+
+  // Contention on sched_mutex, reset on every read
+  std::atomic<uint64_t> nof_locks{0};
+  std::atomic<uint64_t> nof_contended_locks{0};
+  std::atomic<uint64_t> lock_wait_ns{0};
+  std::atomic<uint64_t> nof_queued_events{0};
+  std::atomic<uint64_t> nof_queue_full{0};
+
+  // Workers that generate in parallel the results of carriers that do not share UEs
+  std::mutex                                cc_workers_mutex;
+  std::condition_variable                   cc_workers_cvar;
+  uint32_t                                  nof_pending_cc_groups = 0;
+  std::unique_ptr<srsran::task_thread_pool> cc_workers;
 };
 
 } // namespace srsenb
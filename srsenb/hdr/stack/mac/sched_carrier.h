@@ -44,6 +44,8 @@ public:
   void                   reset();
   void                   carrier_cfg(const sched_cell_params_t& sched_params_);
   void                   set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs);
+  //! Start TTI. Updates the state that is shared with other carriers, so it must not run in parallel with them
+  void                   new_tti(srsran::tti_point tti_rx);
   const cc_sched_result& generate_tti_result(srsran::tti_point tti_rx);
   int                    dl_rach_info(dl_sched_rar_info_t rar_info);
   int                    pdcch_order_info(dl_sched_po_info_t pdcch_order_info);
@@ -72,6 +74,7 @@ private:
 
   // Subframe scheduling logic
   srsran::circular_array<sf_sched, TTIMOD_SZ> sf_scheds;
+  srsran::tti_point                           last_started_tti;
 
   // scheduling results
   sched_result_ringbuffer* prev_sched_results;
@@ -80,6 +80,9 @@ public:
     int         init_dl_cqi               = 5;
     float       max_sib_coderate          = 0.8;
     int         pdcch_cqi_offset          = 0;
+    uint32_t    nof_cc_workers            = 0;     ///< Workers that schedule independent carriers in parallel (0 = off)
+    bool        async_feedback            = false; ///< Queue UE feedback and apply it at the start of the TTI
+    bool        fast_pdcch_alloc          = false; ///< Memoised PDCCH CCE search, bounded in the number of positions
   };
 
   struct cell_cfg_t {
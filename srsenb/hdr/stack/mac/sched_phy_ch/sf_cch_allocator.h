@@ -34,6 +34,9 @@ class sf_cch_allocator
 {
 public:
   const static uint32_t MAX_CFI = 3;
+  /// Maximum number of CCE positions tried by the fast search for each DCI allocation and for each TTI
+  const static uint32_t MAX_FAST_SEARCH_NODES     = 256;
+  const static uint32_t MAX_FAST_SEARCH_NODES_TTI = 512;
   struct tree_node {
     int8_t                pucch_n_prb = -1; ///< this PUCCH resource identifier
     uint16_t              rnti        = SRSRAN_INVALID_RNTI;
@@ -77,12 +80,50 @@ private:
     alloc_type_t alloc_type;
     sched_ue*    user;
   };
+  /// CCEs and PUCCH PRB taken by a partial solution of the fast search
+  struct search_state {
+    std::array<uint64_t, 2> cce_mask   = {};
+    std::array<uint64_t, 2> pucch_mask = {};
+  };
+  /// CCE position of a DCI record whose PUCCH resource is valid, with its footprint in the PDCCH and PUCCH
+  struct dci_candidate {
+    uint32_t     dci_pos_idx;
+    uint32_t     ncce;
+    int          pucch_n_prb;
+    search_state footprint;
+  };
+  using dci_candidate_list = srsran::bounded_vector<dci_candidate, 6>;
+  /// Candidates of a DCI record for each CFI, computed the first time the search visits the record for that CFI
+  struct record_candidates {
+    uint64_t                                record_id = 0; ///< Unique identifier of the DCI record
+    std::array<dci_candidate_list, MAX_CFI> cfi_cands;
+    std::array<bool, MAX_CFI>               computed = {};
+  };
+  /// Search state from which the DCI records after a given depth were found not to fit. It remains valid while the
+  /// DCI records up to the last one of the failed search are allocated, as appending records cannot make them fit
+  struct failed_state {
+    uint64_t     last_record_id = 0;
+    uint32_t     nof_records    = 0;
+    uint32_t     key            = 0;
+    search_state state;
+  };
   const cce_cfi_position_table* get_cce_loc_table(alloc_type_t alloc_type, sched_ue* user, uint32_t cfix) const;
 
   // PDCCH allocation algorithm
   bool alloc_dfs_node(const alloc_record& record, uint32_t start_child_idx);
   bool get_next_dfs();
 
+  // Fast PDCCH allocation algorithm
+  bool alloc_dci_fast();
+  bool fast_dfs(uint32_t depth, const search_state& state);
+  bool try_fast_candidate(uint32_t depth, const dci_candidate& cand, uint32_t cand_idx, const search_state& state);
+  bool fits(const dci_candidate& cand, const search_state& state, search_state& next) const;
+  const dci_candidate_list& get_candidates(uint32_t record_idx);
+  void                      set_fast_solution(uint32_t first_record_idx);
+  bool                      is_valid(const failed_state& e) const;
+  bool                      is_failed_state(uint32_t depth, const search_state& state) const;
+  void                      add_failed_state(uint32_t depth, const search_state& state);
+
   // consts
   const sched_cell_params_t* cc_cfg = nullptr;
   srslog::basic_logger&      logger;
@@ -94,6 +135,18 @@ private:
   uint32_t                  current_max_cfix = 0;
   std::vector<tree_node>    last_dci_dfs, temp_dci_dfs;
   std::vector<alloc_record> dci_record_list; ///< Keeps a record of all the PDCCH allocations done so far
+
+  // fast search vars
+  std::vector<record_candidates> record_cands;    ///< Candidates of each DCI record in dci_record_list
+  std::vector<uint32_t>          solution_cands;  ///< Candidate of each DCI record in the current solution
+  std::vector<search_state>      solution_states; ///< State before each DCI record of the solution, and after the last
+  std::vector<uint32_t>          fast_path;       ///< Candidate of each DCI record in the DFS path being explored
+  std::vector<failed_state>      failed_states;   ///< Hash table of failed search states
+  uint64_t                       next_record_id      = 1;
+  uint32_t                       tti_dfs_node_budget = 0; ///< CCE positions left for the fast search in this TTI
+  uint32_t                       dfs_node_budget     = 0;
+  uint32_t                       nof_dfs_nodes       = 0;
+  bool                           search_aborted      = false;
 };
 
 // Helper methods
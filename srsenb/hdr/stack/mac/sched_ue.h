@@ -84,6 +84,8 @@ public:
   uint32_t                  get_aggr_level(uint32_t enb_cc_idx, uint32_t nof_bits);
   void                      ul_buffer_add(uint8_t lcid, uint32_t bytes);
   void                      metrics_read(mac_ue_metrics_t& metrics);
+  /// Accumulates the bytes of DL TBs ACKed through the async feedback, which are reported in the next metrics_read
+  void                      metrics_dl_acked_bytes(uint32_t nof_bytes) { dl_acked_bytes += nof_bytes; }
 
   /*******************************************************
    * Functions used by scheduler metric objects
@@ -217,6 +219,8 @@ private:
 
   bool phy_config_dedicated_enabled = false;
 
+  uint32_t dl_acked_bytes = 0;
+
   tti_point                  current_tti;
   std::vector<sched_ue_cell> cells; ///< List of eNB cells that may be configured/activated/deactivated for the UE
 };
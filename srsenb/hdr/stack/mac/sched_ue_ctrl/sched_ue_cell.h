@@ -147,6 +147,16 @@ bool find_optimal_rbgmask(const sched_ue_cell&       ue_cell,
                           tbs_info&                  tb,
                           rbgmask_t&                 newtxmask);
 
+/// Same as find_optimal_rbgmask, for the RBGs assigned to a UE per subband, which may not be contiguous. The returned
+/// mask only has available RBGs, and the RBGs with the lowest CQI are the first left out
+bool find_optimal_sb_rbgmask(const sched_ue_cell&       ue_cell,
+                             tti_point                  tti_tx_dl,
+                             const rbgmask_t&           dl_mask,
+                             srsran_dci_format_t        dci_format,
+                             srsran::interval<uint32_t> req_bytes,
+                             tbs_info&                  tb,
+                             rbgmask_t&                 newtxmask);
+
 } // namespace srsenb
 
 #endif // SRSRAN_SCHED_UE_CELL_H
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_FREQ_PF_H
+#define SRSRAN_SCHED_FREQ_PF_H
+
+#include "sched_base.h"
+#include "sched_time_pf.h"
+#include "srsenb/hdr/common/common_enb.h"
+#include "srsran/adt/circular_map.h"
+
+namespace srsenb {
+
+/**
+ * Frequency-domain proportional fair scheduler. Each DL subband is assigned to the UE with the highest PF metric in
+ * that subband, i.e. the spectral efficiency of its subband CQI divided by its average DL rate, until the UE has the
+ * RBGs it needs. The assignment only uses RBG bitmasks, and each UE is then allocated a single grant with its RBGs.
+ * There is no subband CSI for the UL, so the UL is scheduled by the time-domain PF policy.
+ */
+class sched_freq_pf final : public sched_base
+{
+public:
+  sched_freq_pf(const sched_cell_params_t& cell_params_, const sched_interface::sched_args_t& sched_args);
+  void sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
+  void sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
+
+private:
+  static const uint32_t max_nof_subbands   = 13;
+  static const uint32_t max_pdcch_failures = 1;
+  static const uint32_t max_sb_ues         = 2; ///< UEs that are assigned subbands in a TTI
+  static const uint32_t max_newtx_attempts = 4; ///< DL newtx allocation attempts in a TTI
+
+  struct ue_ctxt {
+    ue_ctxt(uint16_t rnti_, float fairness_coeff_) : rnti(rnti_), fairness_coeff(fairness_coeff_) {}
+    float dl_avg_rate() const { return dl_nof_samples == 0 ? 0 : dl_avg_rate_; }
+    void  new_tti(const sched_cell_params_t& cell, uint32_t nof_subbands, sched_ue& ue, sf_sched* tti_sched);
+    void  save_dl_alloc(uint32_t alloc_bytes, float alpha);
+
+    const uint16_t rnti;
+    const float    fairness_coeff;
+
+    float               dl_prio     = 0;
+    const dl_harq_proc* dl_retx_h   = nullptr;
+    const dl_harq_proc* dl_newtx_h  = nullptr;
+    uint32_t            alloc_bytes = 0;
+    bool                sb_capable  = false; ///< Whether the UE takes part in the subband assignment
+    uint32_t            req_rbgs    = 0;     ///< RBGs still missing to transmit all pending DL data
+    bool                req_rbgs_ok = false; ///< Whether req_rbgs was computed, which is only done once a subband is won
+    rbgmask_t           sb_rbgmask;      ///< RBGs assigned to the UE in the subband assignment
+
+    /// PF metric of each subband
+    std::array<float, max_nof_subbands> sb_metric;
+
+  private:
+    float    dl_avg_rate_   = 0;
+    uint32_t dl_nof_samples = 0;
+  };
+
+  void         new_tti(sched_ue_list& ue_db, sf_sched* tti_sched);
+  void         assign_subbands(sched_ue_list& ue_db, sf_sched* tti_sched);
+  alloc_result try_dl_newtx_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* tti_sched);
+
+  const sched_cell_params_t* cc_cfg         = nullptr;
+  float                      fairness_coeff = 1;
+  uint32_t                   nof_subbands   = 1;
+
+  srsran::tti_point current_tti_rx;
+
+  /// RBGs of each subband
+  std::array<rbgmask_t, max_nof_subbands> sb_rbgmasks;
+
+  rnti_map_t<ue_ctxt> ue_history_db;
+
+  /// UEs with an available DL HARQ in the current TTI, sorted by decreasing wideband PF priority
+  std::vector<ue_ctxt*> dl_ues;
+  /// UEs that take part in the subband assignment
+  std::vector<ue_ctxt*> sb_candidates;
+  /// Subband indexes sorted by decreasing best PF metric
+  std::array<uint32_t, max_nof_subbands> sb_order;
+
+  sched_time_pf ul_sched;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_FREQ_PF_H
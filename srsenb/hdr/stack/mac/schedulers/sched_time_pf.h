@@ -34,7 +34,10 @@ class sched_time_pf final : public sched_base
   using ue_cit_t = sched_ue_list::const_iterator;
 
 public:
-  sched_time_pf(const sched_cell_params_t& cell_params_, const sched_interface::sched_args_t& sched_args);
+  /// With dl_enabled_ set to false, only sched_ul_users may be called. The DL state of the UEs is then not computed
+  sched_time_pf(const sched_cell_params_t&          cell_params_,
+                const sched_interface::sched_args_t& sched_args,
+                bool                                 dl_enabled_ = true);
   void sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
   void sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
 
@@ -43,6 +46,7 @@ private:
 
   const sched_cell_params_t* cc_cfg         = nullptr;
   float                      fairness_coeff = 1;
+  bool                       dl_enabled     = true;
 
   srsran::tti_point current_tti_rx;
 
@@ -52,7 +56,7 @@ private:
     float    ul_avg_rate() const { return ul_nof_samples == 0 ? 0 : ul_avg_rate_; }
     uint32_t dl_count() const { return dl_nof_samples; }
     uint32_t ul_count() const { return ul_nof_samples; }
-    void     new_tti(const sched_cell_params_t& cell, sched_ue& ue, sf_sched* tti_sched);
+    void     new_tti(const sched_cell_params_t& cell, sched_ue& ue, sf_sched* tti_sched, bool dl_enabled);
     void     save_dl_alloc(uint32_t alloc_bytes, float alpha);
     void     save_ul_alloc(uint32_t alloc_bytes, float alpha);
 
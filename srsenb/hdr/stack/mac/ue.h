@@ -56,6 +56,8 @@ struct ue_cc_softbuffers {
   const uint32_t          nof_rx_harq_proc;
   cc_softbuffer_tx_list_t softbuffer_tx_list;
   cc_softbuffer_rx_list_t softbuffer_rx_list;
+  // One Tx payload buffer per TB of each HARQ process. They are only taken for the active carriers of the UE
+  std::vector<srsran::unique_byte_buffer_t> tx_payload_list;
 
   ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_);
   ue_cc_softbuffers(ue_cc_softbuffers&&) noexcept = default;
@@ -67,6 +69,10 @@ struct ue_cc_softbuffers {
     return softbuffer_tx_list.at(pid * SRSRAN_MAX_TB + tb_idx);
   }
   srsran_softbuffer_rx_t& get_rx(uint32_t tti) { return softbuffer_rx_list.at(tti % nof_rx_harq_proc); }
+  srsran::byte_buffer_t*  get_tx_payload(uint32_t pid, uint32_t tb_idx)
+  {
+    return tx_payload_list.at(pid * SRSRAN_MAX_TB + tb_idx).get();
+  }
 };
 
 /// Class to manage the allocation, deallocation & access to pending UL HARQ buffers
@@ -98,7 +104,6 @@ private:
 class cc_buffer_handler
 {
 public:
-  explicit cc_buffer_handler();
   ~cc_buffer_handler();
 
   void reset();
@@ -113,7 +118,7 @@ public:
   srsran_softbuffer_rx_t& get_rx_softbuffer(uint32_t tti) { return cc_softbuffers->get_rx(tti); }
   srsran::byte_buffer_t*  get_tx_payload_buffer(size_t harq_pid, size_t tb)
   {
-    return tx_payload_buffer[harq_pid][tb].get();
+    return cc_softbuffers->get_tx_payload(harq_pid, tb);
   }
   cc_used_buffers_map& get_rx_used_buffers() { return rx_used_buffers; }
 
@@ -123,9 +128,6 @@ private:
 
   // buffers
   cc_used_buffers_map rx_used_buffers;
-
-  // One buffer per TB per DL HARQ process and per carrier is needed for each UE.
-  std::array<std::array<srsran::unique_byte_buffer_t, SRSRAN_MAX_TB>, SRSRAN_FDD_NOF_HARQ> tx_payload_buffer;
 };
 
 class ue : public srsran::read_pdu_interface, public mac_ta_ue_interface
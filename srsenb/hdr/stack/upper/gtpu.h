@@ -24,6 +24,7 @@
 #include <unordered_map>
 
 #include "srsenb/hdr/common/common_enb.h"
+#include "srsenb/hdr/stack/upper/gtpu_metrics.h"
 #include "srsran/adt/bounded_vector.h"
 #include "srsran/adt/circular_map.h"
 #include "srsran/common/buffer_pool.h"
@@ -155,6 +156,8 @@ public:
 
   int  init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_);
   void stop();
+  void tti_clock();
+  void get_metrics(gtpu_metrics_t& m);
 
   // gtpu_interface_rrc
   srsran::expected<uint32_t> add_bearer(uint16_t            rnti,
@@ -174,6 +177,7 @@ public:
   // stack interface
   void handle_gtpu_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
   void handle_gtpu_m1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
+  void handle_gtpu_s1u_rx_batch(srsran::rx_sdu_batch_t& batch);
 
 private:
   static const int GTPU_PORT = 2152;
@@ -228,7 +232,15 @@ private:
   // Socket file descriptor
   int fd = -1;
 
+  // S1-U data PDUs pending to be sent in a single sendmmsg call
+  std::vector<std::pair<srsran::unique_byte_buffer_t, sockaddr_in> > tx_batch;
+  std::vector<iovec>                                                   tx_iovs;
+  std::vector<mmsghdr>                                                 tx_msgs;
+  gtpu_metrics_t                                                       metrics = {};
+
   void send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buffer_t pdu, int pdcp_sn = -1);
+  void send_s1u_data_pdu(const sockaddr_in& addr, srsran::unique_byte_buffer_t pdu);
+  void flush_tx_batch();
 
   void echo_response(in_addr_t addr, in_port_t port, uint16_t seq);
   void error_indication(in_addr_t addr, in_port_t port, uint32_t err_teid);
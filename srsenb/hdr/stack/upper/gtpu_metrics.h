@@ -0,0 +1,39 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_GTPU_METRICS_H
+#define SRSENB_GTPU_METRICS_H
+
+#include <cstdint>
+
+namespace srsenb {
+
+/// S1-U socket I/O counters, accumulated since the last metrics report
+struct gtpu_metrics_t {
+  uint32_t nof_rx_batches; ///< Number of socket reads (recvfrom or recvmmsg calls) that returned data
+  uint32_t nof_rx_pdus;    ///< Number of PDUs received
+  uint32_t nof_tx_batches; ///< Number of socket writes (sendto or sendmmsg calls) of data PDUs
+  uint32_t nof_tx_pdus;    ///< Number of data PDUs sent
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_GTPU_METRICS_H
@@ -222,6 +222,7 @@ bool enb::enable_e2_agent(srsenb::e2_interface_metrics* e2_metrics)
 void enb::print_pool()
 {
   srsran::byte_buffer_pool::get_instance()->print_all_buffers();
+  srsran::log_byte_buffer_metrics();
 }
 
 bool enb::get_metrics(enb_metrics_t* m)
@@ -231,6 +232,7 @@ bool enb::get_metrics(enb_metrics_t* m)
   }
   radio->get_metrics(&m->rf);
   phy->get_metrics(m->phy);
+  phy->get_pusch_fanout_metrics(m->pusch_fanout);
   if (eutra_stack) {
     eutra_stack->get_metrics(&m->stack);
   }
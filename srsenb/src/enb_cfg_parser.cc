@@ -2100,9 +2100,10 @@ int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_
   rrc_cfg_->max_mac_ul_kos       = args_->general.max_mac_ul_kos;
   rrc_cfg_->rlf_release_timer_ms = args_->general.rlf_release_timer_ms;
 
-  // Set sync queue capacity to 1 for ZMQ
-  if (args_->rf.device_name == "zmq") {
-    srslog::fetch_basic_logger("ENB").info("Using sync queue size of one for ZMQ based radio.");
+  // Set sync queue capacity to 1 for ZMQ and shared memory radios, which run in lockstep with the other end
+  if (args_->rf.device_name == "zmq" or args_->rf.device_name == "shm") {
+    srslog::fetch_basic_logger("ENB").info("Using sync queue size of one for %s based radio.",
+                                           args_->rf.device_name.c_str());
     args_->stack.sync_queue_size = 1;
   } else {
     // use default size
@@ -141,6 +141,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     ("log.filename",      bpo::value<string>(&args->log.filename)->default_value("/tmp/ue.log"),"Log filename")
     ("log.file_max_size", bpo::value<int>(&args->log.file_max_size)->default_value(-1), "Maximum file size (in kilobytes). When passed, multiple files are created. Default -1 (single file)")
+    ("log.file_format",   bpo::value<string>(&args->log.file_format)->default_value("text"), "Log file format: text or binary. Binary files are decoded with srslog_decode")
 
     /* PCAP */
     ("pcap.enable",    bpo::value<bool>(&args->stack.mac_pcap.enable)->default_value(false),         "Enable MAC packet captures for wireshark")
@@ -157,7 +158,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("pcap.client_port", bpo::value<uint16_t>(&args->stack.mac_pcap_net.client_port)->default_value(5847),    "Enable MAC network captures")
 
     /* Scheduling section */
-    ("scheduler.policy", bpo::value<string>(&args->stack.mac.sched.sched_policy)->default_value("time_pf"), "DL and UL data scheduling policy (E.g. time_rr, time_pf)")
+    ("scheduler.policy", bpo::value<string>(&args->stack.mac.sched.sched_policy)->default_value("time_pf"), "DL and UL data scheduling policy (E.g. time_rr, time_pf, freq_pf)")
     ("scheduler.policy_args", bpo::value<string>(&args->stack.mac.sched.sched_policy_args)->default_value("2"), "Scheduler policy-specific arguments")
     ("scheduler.pdsch_mcs", bpo::value<int>(&args->stack.mac.sched.pdsch_mcs)->default_value(-1), "Optional fixed PDSCH MCS (ignores reported CQIs if specified)")
     ("scheduler.pdsch_max_mcs", bpo::value<int>(&args->stack.mac.sched.pdsch_max_mcs)->default_value(-1), "Optional PDSCH MCS limit")
@@ -181,6 +182,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.init_dl_cqi", bpo::value<int>(&args->stack.mac.sched.init_dl_cqi)->default_value(5), "DL CQI value used before any CQI report is available to the eNB")
     ("scheduler.max_sib_coderate", bpo::value<float>(&args->stack.mac.sched.max_sib_coderate)->default_value(0.8), "Upper bound on SIB and RAR grants coderate")
     ("scheduler.pdcch_cqi_offset", bpo::value<int>(&args->stack.mac.sched.pdcch_cqi_offset)->default_value(0), "CQI offset in derivation of PDCCH aggregation level")
+    ("scheduler.nof_cc_workers", bpo::value<uint32_t>(&args->stack.mac.sched.nof_cc_workers)->default_value(0), "Number of worker threads used to schedule independent carriers in parallel (0 to disable)")
+    ("scheduler.async_feedback", bpo::value<bool>(&args->stack.mac.sched.async_feedback)->default_value(false), "Queue the PHY and RLC feedback without locking the scheduler, and apply it at the start of the TTI")
+    ("scheduler.fast_pdcch_alloc", bpo::value<bool>(&args->stack.mac.sched.fast_pdcch_alloc)->default_value(false), "Memoise and bound the search of PDCCH CCE positions, falling back to a greedy allocation")
 
     /*Slicing conifguration*/
     ("slicing.enable_eMBB", bpo::value<bool>(&args->nr_stack.ngap.nssai[0].active)->default_value(true), "Enables enhanced mobile broadband (eMBB) slice in the gNodeB")
@@ -252,6 +256,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.metrics_csv_filename", bpo::value<string>(&args->general.metrics_csv_filename)->default_value("/tmp/enb_metrics.csv"), "Metrics CSV filename.")
     ("expert.pusch_max_its", bpo::value<uint32_t>(&args->phy.pusch_max_its)->default_value(8), "Maximum number of turbo decoder iterations for LTE.")
     ("expert.pusch_8bit_decoder", bpo::value<bool>(&args->phy.pusch_8bit_decoder)->default_value(false), "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental).")
+    ("expert.pusch_cb_workers", bpo::value<uint32_t>(&args->phy.pusch_cb_workers)->default_value(0), "Number of threads per LTE PUSCH decoder decoding code blocks in parallel (0 decodes them serially).")
+    ("expert.pusch_decode_fanout", bpo::value<uint32_t>(&args->phy.pusch_decode_fanout)->default_value(1), "Maximum number of PUSCH grants decoded in parallel within a subframe.")
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure.")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor.")
     ("expert.nof_phy_threads", bpo::value<uint32_t>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads.")
@@ -278,6 +284,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.max_mac_dl_kos", bpo::value<uint32_t>(&args->general.max_mac_dl_kos)->default_value(100), "Maximum number of consecutive KOs in DL before triggering the UE's release (default 100).")
     ("expert.max_mac_ul_kos", bpo::value<uint32_t>(&args->general.max_mac_ul_kos)->default_value(100), "Maximum number of consecutive KOs in UL before triggering the UE's release (default 100).")
     ("expert.gtpu_tunnel_timeout", bpo::value<uint32_t>(&args->stack.gtpu_indirect_tunnel_timeout_msec)->default_value(0), "Maximum time that GTPU takes to release indirect forwarding tunnel since the last received GTPU PDU (0 for infinity).")
+    ("expert.stack_wait_policy", bpo::value<string>(&args->stack.wait_policy)->default_value("spin_futex"), "How the stack thread waits for PHY and network tasks: sleep (polls every 100 usec), busy_poll or spin_futex.")
+    ("expert.gtpu_batch_size", bpo::value<uint32_t>(&args->stack.gtpu_batch_size)->default_value(1), "Maximum number of S1-U PDUs read/written per recvmmsg/sendmmsg call. Tx batches are flushed every TTI (1 disables batching).")
     ("expert.rlf_release_timer_ms", bpo::value<uint32_t>(&args->general.rlf_release_timer_ms)->default_value(4000), "Time taken by eNB to release UE context after it detects an RLF.")
     ("expert.extended_cp", bpo::value<bool>(&args->phy.extended_cp)->default_value(false), "Use extended cyclic prefix")
     ("expert.ts1_reloc_prep_timeout", bpo::value<uint32_t>(&args->stack.s1ap.ts1_reloc_prep_timeout)->default_value(10000), "S1AP TS 36.413 TS1RelocPrep Expiry Timeout value in milliseconds.")
@@ -303,6 +311,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.nr_pdsch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_dl_mcs)->default_value(28), "Fixed NR DL MCS (-1 for dynamic).")
     ("scheduler.nr_pusch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_ul_mcs)->default_value(28), "Fixed NR UL MCS (-1 for dynamic).")
     ("expert.nr_pusch_max_its", bpo::value<uint32_t>(&args->phy.nr_pusch_max_its)->default_value(10),     "Maximum number of LDPC iterations for NR.")
+    ("expert.nr_pusch_cb_workers", bpo::value<uint32_t>(&args->phy.nr_pusch_cb_workers)->default_value(0), "Number of threads per NR PHY worker decoding PUSCH code blocks in parallel (0 decodes them serially).")
   ;
 
   // Positional options - config file location
@@ -390,6 +399,13 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     }
   }
 
+  if (args->log.file_format != "text" && args->log.file_format != "binary") {
+    fprintf(stderr,
+            "log.file_format = %s. Value is not supported, only text or binary are allowed\n",
+            args->log.file_format.c_str());
+    exit(1);
+  }
+
   // Check PRACH workers
   if (args->phy.nof_prach_threads > 1) {
     fprintf(stderr,
@@ -630,10 +646,15 @@ int main(int argc, char* argv[])
   parse_args(&args, argc, argv);
 
   // Setup the default log sink.
-  srslog::set_default_sink(
-      (args.log.filename == "stdout")
-          ? srslog::fetch_stdout_sink()
-          : srslog::fetch_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size)));
+  if (args.log.filename == "stdout") {
+    srslog::set_default_sink(srslog::fetch_stdout_sink());
+  } else if (args.log.file_format == "binary") {
+    srslog::set_default_sink(
+        srslog::fetch_binary_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size)));
+  } else {
+    srslog::set_default_sink(
+        srslog::fetch_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size)));
+  }
 
   // Alarms log channel creation.
   srslog::sink&        alarm_sink     = srslog::fetch_file_sink(args.general.alarms_filename, 0, true);
@@ -61,7 +61,9 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
   if (file.is_open() && enb != NULL) {
     if (n_reports == 0) {
       file << "time;nof_ue;dl_brate;ul_brate;"
-              "proc_rmem;proc_rmem_kB;proc_vmem_kB;sys_mem;system_load;thread_count";
+              "proc_rmem;proc_rmem_kB;proc_vmem_kB;sys_mem;system_load;thread_count;"
+              "gtpu_rx_batches;gtpu_rx_pdus;gtpu_tx_batches;gtpu_tx_pdus;"
+              "pusch_fanout_nof_sf;pusch_fanout_nof_grants;pusch_fanout_serial_us;pusch_fanout_elapsed_us";
 
       // Add the cpus
       for (uint32_t i = 0, e = metrics.sys.cpu_count; i != e; ++i) {
@@ -108,6 +110,20 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
     file << float_to_string(m.process_cpu_usage, 2);
     file << std::to_string(m.thread_count) << ";";
 
+    // Write the S1-U socket I/O metrics.
+    const gtpu_metrics_t& gtpu = metrics.stack.gtpu;
+    file << std::to_string(gtpu.nof_rx_batches) << ";";
+    file << std::to_string(gtpu.nof_rx_pdus) << ";";
+    file << std::to_string(gtpu.nof_tx_batches) << ";";
+    file << std::to_string(gtpu.nof_tx_pdus) << ";";
+
+    // Write the PUSCH decoding fan-out metrics.
+    const pusch_fanout_metrics_t& pusch_fanout = metrics.pusch_fanout;
+    file << std::to_string(pusch_fanout.nof_subframes) << ";";
+    file << std::to_string(pusch_fanout.nof_grants) << ";";
+    file << std::to_string(pusch_fanout.serial_us) << ";";
+    file << std::to_string(pusch_fanout.elapsed_us) << ";";
+
     // Write the cpu metrics.
     for (uint32_t i = 0, e = m.cpu_count, last_cpu_index = e - 1; i != e; ++i) {
       file << float_to_string(m.cpu_load[i], 2, (i != last_cpu_index));
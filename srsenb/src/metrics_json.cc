@@ -95,13 +95,41 @@ DECLARE_METRIC("nof_rach", metric_nof_rach, uint32_t, "");
 DECLARE_METRIC_LIST("ue_list", mlist_ues, std::vector<mset_ue_container>);
 DECLARE_METRIC_SET("cell_container", mset_cell_container, metric_carrier_id, metric_pci, metric_nof_rach, mlist_ues);
 
+/// S1-U GTP-U container metrics.
+DECLARE_METRIC("rx_batches", metric_gtpu_rx_batches, uint32_t, "");
+DECLARE_METRIC("rx_pdus", metric_gtpu_rx_pdus, uint32_t, "");
+DECLARE_METRIC("tx_batches", metric_gtpu_tx_batches, uint32_t, "");
+DECLARE_METRIC("tx_pdus", metric_gtpu_tx_pdus, uint32_t, "");
+DECLARE_METRIC_SET("gtpu_container",
+                   mset_gtpu_container,
+                   metric_gtpu_rx_batches,
+                   metric_gtpu_rx_pdus,
+                   metric_gtpu_tx_batches,
+                   metric_gtpu_tx_pdus);
+
+/// PUSCH decoding fan-out container metrics.
+DECLARE_METRIC("nof_subframes", metric_pusch_fanout_nof_subframes, uint32_t, "");
+DECLARE_METRIC("nof_grants", metric_pusch_fanout_nof_grants, uint32_t, "");
+DECLARE_METRIC("serial_us", metric_pusch_fanout_serial_us, uint64_t, "us");
+DECLARE_METRIC("elapsed_us", metric_pusch_fanout_elapsed_us, uint64_t, "us");
+DECLARE_METRIC_SET("pusch_fanout_container",
+                   mset_pusch_fanout_container,
+                   metric_pusch_fanout_nof_subframes,
+                   metric_pusch_fanout_nof_grants,
+                   metric_pusch_fanout_serial_us,
+                   metric_pusch_fanout_elapsed_us);
+
 /// Metrics root object.
 DECLARE_METRIC("type", metric_type_tag, std::string, "");
 DECLARE_METRIC("timestamp", metric_timestamp_tag, double, "");
 DECLARE_METRIC_LIST("cell_list", mlist_cell, std::vector<mset_cell_container>);
 
 /// Metrics context.
-using metric_context_t = srslog::build_context_type<metric_type_tag, metric_timestamp_tag, mlist_cell>;
+using metric_context_t = srslog::build_context_type<metric_type_tag,
+                                                    metric_timestamp_tag,
+                                                    mlist_cell,
+                                                    mset_gtpu_container,
+                                                    mset_pusch_fanout_container>;
 
 } // namespace
 
@@ -238,6 +266,20 @@ void metrics_json::set_metrics(const enb_metrics_t& m, const uint32_t period_use
     }
   }
 
+  // S1-U socket I/O.
+  auto& gtpu = ctx.get<mset_gtpu_container>();
+  gtpu.write<metric_gtpu_rx_batches>(m.stack.gtpu.nof_rx_batches);
+  gtpu.write<metric_gtpu_rx_pdus>(m.stack.gtpu.nof_rx_pdus);
+  gtpu.write<metric_gtpu_tx_batches>(m.stack.gtpu.nof_tx_batches);
+  gtpu.write<metric_gtpu_tx_pdus>(m.stack.gtpu.nof_tx_pdus);
+
+  // PUSCH decoding fan-out.
+  auto& pusch_fanout = ctx.get<mset_pusch_fanout_container>();
+  pusch_fanout.write<metric_pusch_fanout_nof_subframes>(m.pusch_fanout.nof_subframes);
+  pusch_fanout.write<metric_pusch_fanout_nof_grants>(m.pusch_fanout.nof_grants);
+  pusch_fanout.write<metric_pusch_fanout_serial_us>(m.pusch_fanout.serial_us);
+  pusch_fanout.write<metric_pusch_fanout_elapsed_us>(m.pusch_fanout.elapsed_us);
+
   // Log the context.
   ctx.write<metric_timestamp_tag>(get_time_stamp());
   log_c(ctx);
@@ -203,6 +203,26 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
 
   set_metrics_helper(metrics.stack.rrc.ues.size(), metrics.stack.mac, metrics.phy, false);
   set_metrics_helper(metrics.nr_stack.mac.ues.size(), metrics.nr_stack.mac, metrics.phy, true);
+
+  // S1-U socket I/O, only when batching packs several PDUs per syscall
+  const gtpu_metrics_t& gtpu = metrics.stack.gtpu;
+  if (gtpu.nof_rx_pdus > gtpu.nof_rx_batches or gtpu.nof_tx_pdus > gtpu.nof_tx_batches) {
+    fmt::print("GTP-U: rx {} PDUs in {} reads, tx {} PDUs in {} writes\n",
+               gtpu.nof_rx_pdus,
+               gtpu.nof_rx_batches,
+               gtpu.nof_tx_pdus,
+               gtpu.nof_tx_batches);
+  }
+
+  // PUSCH decoding fan-out, only when it is enabled
+  const pusch_fanout_metrics_t& pusch_fanout = metrics.pusch_fanout;
+  if (pusch_fanout.nof_subframes > 0) {
+    fmt::print("PUSCH fan-out: {} grants in {} subframes, decoding serial={} us, elapsed={} us\n",
+               pusch_fanout.nof_grants,
+               pusch_fanout.nof_subframes,
+               pusch_fanout.serial_us,
+               pusch_fanout.elapsed_us);
+  }
 }
 
 std::string metrics_stdout::float_to_string(float f, int digits, int field_width)
@@ -19,6 +19,7 @@
  *
  */
 
+#include <chrono>
 #include <iomanip>
 
 #include "srsran/common/threads.h"
@@ -67,6 +68,10 @@ cc_worker::~cc_worker()
   srsran_enb_dl_free(&enb_dl);
   srsran_enb_ul_free(&enb_ul);
 
+  for (auto& q : pusch_lanes) {
+    srsran_enb_ul_pusch_free(q.get());
+  }
+
   for (int p = 0; p < SRSRAN_MAX_PORTS; p++) {
     if (signal_buffer_rx[p]) {
       free(signal_buffer_rx[p]);
@@ -75,21 +80,17 @@ cc_worker::~cc_worker()
       free(signal_buffer_tx[p]);
     }
   }
-
-  // Delete all users
-  for (auto& it : ue_db) {
-    delete it.second;
-  }
 }
 
 #ifdef DEBUG_WRITE_FILE
 FILE* f;
 #endif
 
-void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
+void cc_worker::init(phy_common* phy_, uint32_t cc_idx_, srsran::task_thread_pool* pusch_pool_)
 {
   phy                         = phy_;
   cc_idx                      = cc_idx_;
+  pusch_pool                  = pusch_pool_;
   srsran_cell_t    cell       = phy_->get_cell(cc_idx);
   uint32_t         nof_prb    = phy_->get_nof_prb(cc_idx);
   uint32_t         sf_len     = SRSRAN_SF_LEN_PRB(nof_prb);
@@ -156,6 +157,37 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+
+  // Decode the code blocks of each PUSCH transport block with additional threads
+  if (srsran_sch_enable_cb_workers(&enb_ul.pusch.ul_sch, phy->params.pusch_cb_workers)) {
+    ERROR("Error creating %d PUSCH code block workers", phy->params.pusch_cb_workers);
+    return;
+  }
+
+  // Create the additional PUSCH receivers, one per decoding lane besides the carrier own receiver
+  if (pusch_pool != nullptr) {
+    for (uint32_t lane = 1; lane < phy->params.pusch_decode_fanout; lane++) {
+      std::unique_ptr<srsran_enb_ul_pusch_t> q(new srsran_enb_ul_pusch_t);
+      if (srsran_enb_ul_pusch_init(q.get(), nof_prb)) {
+        ERROR("Error initiating ENB UL PUSCH lane %d", lane);
+        return;
+      }
+      if (srsran_enb_ul_pusch_set_cell(q.get(), cell, &phy->dmrs_pusch_cfg)) {
+        ERROR("Error initiating ENB UL PUSCH lane %d", lane);
+        srsran_enb_ul_pusch_free(q.get());
+        return;
+      }
+      q->pusch.llr_is_8bit        = enb_ul.pusch.llr_is_8bit;
+      q->pusch.ul_sch.llr_is_8bit = enb_ul.pusch.ul_sch.llr_is_8bit;
+      if (srsran_sch_enable_cb_workers(&q->pusch.ul_sch, phy->params.pusch_cb_workers)) {
+        ERROR("Error creating %d PUSCH code block workers", phy->params.pusch_cb_workers);
+        srsran_enb_ul_pusch_free(q.get());
+        return;
+      }
+      pusch_lanes.push_back(std::move(q));
+      pusch_free_lanes.push_back(lane);
+    }
+  }
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
@@ -191,8 +223,9 @@ int cc_worker::add_rnti(uint16_t rnti)
   std::unique_lock<std::mutex> lock(mutex);
 
   // Create user unless already exists
-  if (ue_db.count(rnti) == 0) {
-    ue_db[rnti] = new ue(rnti);
+  if (not ue_db.contains(rnti) and not ue_db.emplace(rnti, rnti)) {
+    Error("Error adding rnti=0x%x, its slot is taken by another RNTI", rnti);
+    return SRSRAN_ERROR;
   }
   return SRSRAN_SUCCESS;
 }
@@ -200,10 +233,7 @@ int cc_worker::add_rnti(uint16_t rnti)
 void cc_worker::rem_rnti(uint16_t rnti)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  if (ue_db.count(rnti)) {
-    delete ue_db[rnti];
-    ue_db.erase(rnti);
-  }
+  ue_db.erase(rnti);
 }
 
 uint32_t cc_worker::get_nof_rnti()
@@ -283,11 +313,11 @@ void cc_worker::work_dl(const srsran_dl_sf_cfg_t&            dl_sf_cfg,
   }
 }
 
-bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
-                                  srsran_ul_cfg_t&                           ul_cfg,
-                                  srsran_pusch_res_t&                        pusch_res)
+bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant, uint32_t lane, pusch_job_t& job)
 {
-  uint16_t rnti = ul_grant.dci.rnti;
+  uint16_t            rnti      = ul_grant.dci.rnti;
+  srsran_ul_cfg_t&    ul_cfg    = job.ul_cfg;
+  srsran_pusch_res_t& pusch_res = job.pusch_res;
 
   // Invalid RNTI
   if (rnti == SRSRAN_INVALID_RNTI) {
@@ -295,7 +325,7 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   }
 
   // RNTI does not exist
-  if (ue_db.count(rnti) == 0) {
+  if (not ue_db.contains(rnti)) {
     return false;
   }
 
@@ -307,7 +337,7 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   }
 
   // Fill UCI configuration
-  bool uci_required =
+  job.uci_required =
       phy->ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, ul_grant.dci.cqi_request, true, ul_cfg.pusch.uci_cfg);
 
   // Compute UL grant
@@ -338,20 +368,39 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     Error("Error setting last UL TB for RNTI %x, CC %d, PID %d", rnti, cc_idx, ul_grant.pid);
   }
 
-  // Run PUSCH decoder
+  // Run PUSCH decoder in the given lane
   ul_cfg.pusch.softbuffers.rx = ul_grant.softbuffer_rx;
   pusch_res.data              = ul_grant.data;
-  if (pusch_res.data) {
-    if (srsran_enb_ul_get_pusch(&enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
+  if (lane == 0) {
+    if (pusch_res.data && srsran_enb_ul_get_pusch(&enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
       Error("Decoding PUSCH for RNTI %x", rnti);
       return false;
     }
+    job.chest_res = enb_ul.chest_res;
+  } else {
+    srsran_enb_ul_pusch_t* q = pusch_lanes[lane - 1].get();
+    if (pusch_res.data && srsran_enb_ul_pusch_decode(q, &enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
+      Error("Decoding PUSCH for RNTI %x", rnti);
+      return false;
+    }
+    job.chest_res = q->chest_res;
   }
+
+  return true;
+}
+
+void cc_worker::report_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant, pusch_job_t& job)
+{
+  uint16_t               rnti      = ul_grant.dci.rnti;
+  srsran_ul_cfg_t&       ul_cfg    = job.ul_cfg;
+  srsran_pusch_res_t&    pusch_res = job.pusch_res;
+  srsran_chest_ul_res_t& chest_res = job.chest_res;
+
   // Save PHICH scheduling for this user. Each user can have just 1 PUSCH dci per TTI
-  ue_db[rnti]->phich_grant.n_prb_lowest = grant.n_prb_tilde[0];
-  ue_db[rnti]->phich_grant.n_dmrs       = ul_grant.dci.n_dmrs;
+  ue_db[rnti].phich_grant.n_prb_lowest = ul_cfg.pusch.grant.n_prb_tilde[0];
+  ue_db[rnti].phich_grant.n_dmrs       = ul_grant.dci.n_dmrs;
 
-  float snr_db = enb_ul.chest_res.snr_db;
+  float snr_db = chest_res.snr_db;
 
   // Notify MAC of RL status
   if (snr_db >= PUSCH_RL_SNR_DB_TH) {
@@ -359,57 +408,142 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     phy->stack->snr_info(ul_sf.tti, rnti, cc_idx, snr_db, mac_interface_phy_lte::PUSCH);
 
     // Notify MAC of Time Alignment only if it enabled and valid measurement, ignore value otherwise
-    if (ul_cfg.pusch.meas_ta_en and not std::isnan(enb_ul.chest_res.ta_us) and not std::isinf(enb_ul.chest_res.ta_us)) {
-      phy->stack->ta_info(ul_sf.tti, rnti, enb_ul.chest_res.ta_us);
+    if (ul_cfg.pusch.meas_ta_en and not std::isnan(chest_res.ta_us) and not std::isinf(chest_res.ta_us)) {
+      phy->stack->ta_info(ul_sf.tti, rnti, chest_res.ta_us);
     }
   }
 
   // Send UCI data to MAC
-  if (uci_required) {
+  if (job.uci_required) {
     phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pusch.uci_cfg, pusch_res.uci);
   }
 
   // Save statistics only if data was provided
   if (ul_grant.data != nullptr) {
     // Save metrics stats
-    ue_db[rnti]->metrics_ul(ul_grant.dci.tb.mcs_idx,
-                            enb_ul.chest_res.epre_dBfs - phy->params.rx_gain_offset,
-                            enb_ul.chest_res.snr_db,
+    ue_db[rnti].metrics_ul(ul_grant.dci.tb.mcs_idx,
+                            chest_res.epre_dBfs - phy->params.rx_gain_offset,
+                            chest_res.snr_db,
                             pusch_res.avg_iterations_block);
   }
-  return true;
+
+  // Notify MAC new received data and HARQ Indication value
+  if (ul_grant.data != nullptr) {
+    // Inform MAC about the CRC result
+    phy->stack->crc_info(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
+    // Push PDU buffer
+    phy->stack->push_pdu(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc, ul_cfg.pusch.grant.L_prb);
+    // Logging
+    if (logger.info.enabled()) {
+      char str[512];
+      srsran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &chest_res, str, sizeof(str));
+      logger.info("PUSCH: cc=%d, %s", cc_idx, str);
+    }
+  }
 }
 
-void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
+void cc_worker::decode_pusch_lane(uint32_t lane)
 {
-  // Iterate over all the grants, all the grants need to report MAC the CRC status
-  for (uint32_t i = 0; i < nof_pusch; i++) {
-    // Get grant itself and RNTI
-    stack_interface_phy_lte::ul_sched_grant_t& ul_grant = grants[i];
-    uint16_t                                   rnti     = ul_grant.dci.rnti;
+  // Claim grants until all of them have been taken by some lane
+  for (uint32_t i = pusch_next_grant++; i < nof_pusch_grants; i = pusch_next_grant++) {
+    pusch_job_t& job   = pusch_jobs[i];
+    auto         start = std::chrono::steady_clock::now();
 
-    srsran_pusch_res_t pusch_res = {};
-    srsran_ul_cfg_t    ul_cfg    = {};
+    job.valid = decode_pusch_rnti(pusch_grants[i], lane, job);
 
-    // Decodes PUSCH for the given grant
-    if (!decode_pusch_rnti(ul_grant, ul_cfg, pusch_res)) {
+    auto elapsed  = std::chrono::steady_clock::now() - start;
+    job.decode_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  }
+}
+
+void cc_worker::decode_pusch_helper(uint32_t round)
+{
+  uint32_t lane = 0;
+  {
+    // Join the round only if it is still open and there is a free lane, otherwise the task is stale
+    std::lock_guard<std::mutex> lock(pusch_mutex);
+    if (not pusch_round_open or round != pusch_round or pusch_free_lanes.empty()) {
       return;
     }
+    lane = pusch_free_lanes.back();
+    pusch_free_lanes.pop_back();
+    pusch_nof_helpers++;
+  }
 
-    // Notify MAC new received data and HARQ Indication value
-    if (ul_grant.data != nullptr) {
-      // Inform MAC about the CRC result
-      phy->stack->crc_info(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
-      // Push PDU buffer
-      phy->stack->push_pdu(
-          tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc, ul_cfg.pusch.grant.L_prb);
-      // Logging
-      if (logger.info.enabled()) {
-        char str[512];
-        srsran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
-        logger.info("PUSCH: cc=%d, %s", cc_idx, str);
-      }
+  decode_pusch_lane(lane);
+
+  std::lock_guard<std::mutex> lock(pusch_mutex);
+  pusch_free_lanes.push_back(lane);
+  pusch_nof_helpers--;
+  pusch_cvar.notify_all();
+}
+
+void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  pusch_grants     = grants;
+  nof_pusch_grants = std::min(nof_pusch, (uint32_t)pusch_jobs.size());
+  pusch_next_grant = 0;
+  for (uint32_t i = 0; i < nof_pusch_grants; i++) {
+    pusch_jobs[i] = {};
+  }
+
+  // Fan-out the decoding of the grants to the PUSCH decoding pool
+  uint32_t nof_helpers = 0;
+  if (pusch_pool != nullptr and nof_pusch_grants > 1) {
+    nof_helpers = std::min(nof_pusch_grants - 1, (uint32_t)pusch_lanes.size());
+
+    uint32_t round = 0;
+    {
+      std::lock_guard<std::mutex> lock(pusch_mutex);
+      round            = ++pusch_round;
+      pusch_round_open = true;
     }
+    for (uint32_t i = 0; i < nof_helpers; i++) {
+      pusch_pool->push_task([this, round]() { decode_pusch_helper(round); });
+    }
+  }
+
+  // The calling worker decodes too, so that all grants are decoded even if no helper gets to run
+  decode_pusch_lane(0);
+
+  // Wait for the helpers before reporting to the MAC, the PHICH ACK depends on it
+  if (nof_helpers > 0) {
+    std::unique_lock<std::mutex> lock(pusch_mutex);
+    pusch_round_open = false;
+    pusch_cvar.wait(lock, [this]() { return pusch_nof_helpers == 0; });
+  }
+
+  auto     elapsed    = std::chrono::steady_clock::now() - start;
+  uint32_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+  if (pusch_pool != nullptr and nof_pusch_grants > 0) {
+    uint32_t serial_us = 0;
+    for (uint32_t i = 0; i < nof_pusch_grants; i++) {
+      serial_us += pusch_jobs[i].decode_us;
+    }
+    {
+      std::lock_guard<std::mutex> lock(pusch_mutex);
+      pusch_metrics.nof_subframes++;
+      pusch_metrics.nof_grants += nof_pusch_grants;
+      pusch_metrics.serial_us += serial_us;
+      pusch_metrics.elapsed_us += elapsed_us;
+    }
+    Info("PUSCH fan-out: cc=%d, nof_grants=%d, nof_lanes=%d, serial=%d us, elapsed=%d us",
+         cc_idx,
+         nof_pusch_grants,
+         nof_helpers + 1,
+         serial_us,
+         elapsed_us);
+  }
+
+  // Iterate over all the grants in order, all the grants need to report MAC the CRC status
+  for (uint32_t i = 0; i < nof_pusch_grants; i++) {
+    if (not pusch_jobs[i].valid) {
+      return;
+    }
+    report_pusch_rnti(grants[i], pusch_jobs[i]);
   }
 }
 
@@ -464,7 +598,7 @@ int cc_worker::decode_pucch()
 
         // Save metrics
         if (pucch_res.detected) {
-          ue_db[rnti]->metrics_ul_pucch(pucch_res.rssi_dbFs - phy->params.rx_gain_offset,
+          ue_db[rnti].metrics_ul_pucch(pucch_res.rssi_dbFs - phy->params.rx_gain_offset,
                                         pucch_res.ni_dbFs - -phy->params.rx_gain_offset,
                                         pucch_res.snr_db);
         }
@@ -477,14 +611,14 @@ int cc_worker::decode_pucch()
 int cc_worker::encode_phich(stack_interface_phy_lte::ul_sched_ack_t* acks, uint32_t nof_acks)
 {
   for (uint32_t i = 0; i < nof_acks; i++) {
-    if (acks[i].rnti && ue_db.count(acks[i].rnti)) {
-      srsran_enb_dl_put_phich(&enb_dl, &ue_db[acks[i].rnti]->phich_grant, acks[i].ack);
+    if (acks[i].rnti && ue_db.contains(acks[i].rnti)) {
+      srsran_enb_dl_put_phich(&enb_dl, &ue_db[acks[i].rnti].phich_grant, acks[i].ack);
 
       Info("PHICH: rnti=0x%x, hi=%d, I_lowest=%d, n_dmrs=%d, tti_tx_dl=%d",
            acks[i].rnti,
            acks[i].ack,
-           ue_db[acks[i].rnti]->phich_grant.n_prb_lowest,
-           ue_db[acks[i].rnti]->phich_grant.n_dmrs,
+           ue_db[acks[i].rnti].phich_grant.n_prb_lowest,
+           ue_db[acks[i].rnti].phich_grant.n_dmrs,
            tti_tx_dl);
     }
   }
@@ -587,8 +721,8 @@ int cc_worker::encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srs
   }
 
   // Save metrics stats
-  if (ue_db.count(SRSRAN_MRNTI)) {
-    ue_db[SRSRAN_MRNTI]->metrics_dl(mbsfn_cfg->mbsfn_mcs);
+  if (ue_db.contains(SRSRAN_MRNTI)) {
+    ue_db[SRSRAN_MRNTI].metrics_dl(mbsfn_cfg->mbsfn_mcs);
   }
   return SRSRAN_SUCCESS;
 }
@@ -600,7 +734,7 @@ int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, u
   for (uint32_t i = 0; i < nof_grants; i++) {
     uint16_t rnti = grants[i].dci.rnti;
 
-    if (rnti && ue_db.count(rnti)) {
+    if (rnti && ue_db.contains(rnti)) {
       srsran_dl_cfg_t dl_cfg = {};
 
       if (phy->ue_db.get_dl_config(rnti, cc_idx, dl_cfg) < SRSRAN_SUCCESS) {
@@ -640,7 +774,7 @@ int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, u
       }
 
       // Save metrics stats
-      ue_db[rnti]->metrics_dl(grants[i].dci.tb[0].mcs_idx);
+      ue_db[rnti].metrics_dl(grants[i].dci.tb[0].mcs_idx);
     } else {
       Error("User rnti=0x%x not found in cc_worker=%d", rnti, cc_idx);
     }
@@ -659,13 +793,23 @@ uint32_t cc_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
   metrics.resize(ue_db.size());
   for (auto& ue : ue_db) {
     if ((SRSRAN_RNTI_ISUSER(ue.first) || ue.first == SRSRAN_MRNTI)) {
-      ue.second->metrics_read(&metrics[cnt++]);
+      ue.second.metrics_read(&metrics[cnt++]);
     }
   }
   metrics.resize(cnt);
   return cnt;
 }
 
+void cc_worker::get_pusch_fanout_metrics(pusch_fanout_metrics_t& metrics)
+{
+  std::lock_guard<std::mutex> lock(pusch_mutex);
+  metrics.nof_subframes += pusch_metrics.nof_subframes;
+  metrics.nof_grants += pusch_metrics.nof_grants;
+  metrics.serial_us += pusch_metrics.serial_us;
+  metrics.elapsed_us += pusch_metrics.elapsed_us;
+  pusch_metrics = {};
+}
+
 void cc_worker::ue::metrics_read(phy_metrics_t* metrics_)
 {
   if (metrics_) {
@@ -72,7 +72,7 @@ namespace lte {
 FILE* f;
 #endif
 
-void sf_worker::init(phy_common* phy_)
+void sf_worker::init(phy_common* phy_, srsran::task_thread_pool* pusch_pool)
 {
   phy = phy_;
 
@@ -82,7 +82,7 @@ void sf_worker::init(phy_common* phy_)
     auto q = new cc_worker(logger);
 
     // Initialise
-    q->init(phy, i);
+    q->init(phy, i, pusch_pool);
 
     // Create unique pointer
     cc_workers.push_back(std::unique_ptr<cc_worker>(q));
@@ -297,6 +297,13 @@ uint32_t sf_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
   return cnt;
 }
 
+void sf_worker::get_pusch_fanout_metrics(pusch_fanout_metrics_t& metrics)
+{
+  for (uint32_t cc = 0; cc < phy->get_nof_carriers_lte(); cc++) {
+    cc_workers[cc]->get_pusch_fanout_metrics(metrics);
+  }
+}
+
 void sf_worker::start_plot()
 {
 #ifdef ENABLE_GUI
@@ -29,13 +29,20 @@ bool worker_pool::init(const phy_args_t& args, phy_common* common, srslog::sink&
 {
   // Add workers to workers pool and start threads.
   srslog::basic_levels log_level = srslog::str_to_basic_level(args.log.phy_level);
+
+  // The worker calling the decoder takes one of the PUSCH decoding lanes, the pool runs the rest
+  if (args.pusch_decode_fanout > 1) {
+    pusch_pool = std::unique_ptr<srsran::task_thread_pool>(
+        new srsran::task_thread_pool(args.pusch_decode_fanout - 1, false, prio));
+  }
+
   for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
     auto& log = srslog::fetch_basic_logger(fmt::format("PHY{}", i), log_sink);
     log.set_level(log_level);
     log.set_hex_dump_max_size(args.log.phy_hex_limit);
 
     auto w = std::unique_ptr<lte::sf_worker>(new sf_worker(log));
-    w->init(common);
+    w->init(common, pusch_pool.get());
     pool.init_worker(i, w.get(), prio);
     workers.push_back(std::move(w));
   }
@@ -61,6 +68,9 @@ sf_worker* worker_pool::wait_worker_id(uint32_t id)
 void worker_pool::stop()
 {
   pool.stop();
+  if (pusch_pool != nullptr) {
+    pusch_pool->stop();
+  }
 }
 
 }; // namespace lte
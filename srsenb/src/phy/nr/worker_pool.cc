@@ -72,6 +72,7 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
     w_args.rf_port                 = cell_list[cell_index].rf_port;
     w_args.srate_hz                = srate_hz;
     w_args.pusch_max_its           = args.pusch_max_its;
+    w_args.pusch_cb_workers        = args.pusch_cb_workers;
     w_args.pusch_min_snr_dB        = args.pusch_min_snr_dB;
 
     if (not w->init(w_args)) {
@@ -23,6 +23,7 @@
 #include "srsran/common/band_helper.h"
 #include "srsran/common/phy_cfg_nr_default.h"
 #include "srsran/common/threads.h"
+#include <algorithm>
 #include <pthread.h>
 #include <sstream>
 #include <string.h>
@@ -142,6 +143,92 @@ int phy::init(const phy_args_t&            args,
   return SRSRAN_SUCCESS;
 }
 
+/// Creates and releases OFDM modulators configured like the ones of srsran_enb_dl/srsran_enb_ul, so that the guru DFT
+/// plans they create per slot (whose strides and distances depend on the cyclic prefix) end up in the DFT plan cache.
+static int prewarm_ofdm_plans(const srsran_cell_t& cell)
+{
+  cf_t* in_buffer  = srsran_vec_cf_malloc(SRSRAN_SF_LEN_MAX);
+  cf_t* out_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_MAX);
+  if (in_buffer == nullptr or out_buffer == nullptr) {
+    free(in_buffer);
+    free(out_buffer);
+    return SRSRAN_ERROR;
+  }
+
+  int               ret      = SRSRAN_SUCCESS;
+  srsran_ofdm_t     ofdm     = {};
+  srsran_ofdm_cfg_t ofdm_cfg = {};
+  ofdm_cfg.nof_prb           = cell.nof_prb;
+  ofdm_cfg.in_buffer         = in_buffer;
+  ofdm_cfg.out_buffer        = out_buffer;
+  ofdm_cfg.normalize         = false;
+
+  // Downlink, normal and MBSFN subframes
+  for (srsran_sf_t sf_type : {SRSRAN_SF_NORM, SRSRAN_SF_MBSFN}) {
+    ofdm_cfg.cp      = (sf_type == SRSRAN_SF_MBSFN) ? SRSRAN_CP_EXT : cell.cp;
+    ofdm_cfg.sf_type = sf_type;
+    if (srsran_ofdm_tx_init_cfg(&ofdm, &ofdm_cfg) != SRSRAN_SUCCESS) {
+      ret = SRSRAN_ERROR;
+    }
+    srsran_ofdm_tx_free(&ofdm);
+  }
+
+  // Uplink
+  ofdm_cfg.cp               = cell.cp;
+  ofdm_cfg.sf_type          = SRSRAN_SF_NORM;
+  ofdm_cfg.freq_shift_f     = -0.5f;
+  ofdm_cfg.rx_window_offset = 0.5f;
+  if (srsran_ofdm_rx_init_cfg(&ofdm, &ofdm_cfg) != SRSRAN_SUCCESS) {
+    ret = SRSRAN_ERROR;
+  }
+  srsran_ofdm_rx_free(&ofdm);
+
+  free(in_buffer);
+  free(out_buffer);
+  return ret;
+}
+
+/// Plans every DFT size the configured cells will use, so that the workers, PRACH and later replans are served from the
+/// DFT plan cache instead of running the FFTW planner.
+static void prewarm_dft_plans(const phy_cfg_t& cfg, srslog::basic_logger& logger)
+{
+  std::vector<uint32_t> sizes;
+  for (const auto& cell_cfg : cfg.phy_cell_cfg) {
+    int symbol_sz = srsran_symbol_sz(cell_cfg.cell.nof_prb);
+    if (symbol_sz <= 0) {
+      continue;
+    }
+    // OFDM symbol and PRACH sizes (preamble formats 0-3 and 4)
+    sizes.push_back(symbol_sz);
+    sizes.push_back(symbol_sz * 12);
+    sizes.push_back(symbol_sz * 2);
+
+    // PUSCH transform precoding sizes
+    for (uint32_t nof_prb = 1; nof_prb <= cell_cfg.cell.nof_prb; nof_prb++) {
+      if (srsran_dft_precoding_valid_prb(nof_prb)) {
+        sizes.push_back(nof_prb * SRSRAN_NRE);
+      }
+    }
+  }
+  sizes.push_back(SRSRAN_PRACH_N_ZC_LONG);
+  sizes.push_back(SRSRAN_PRACH_N_ZC_SHORT);
+
+  std::sort(sizes.begin(), sizes.end());
+  sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+
+  if (srsran_dft_prewarm(sizes.data(), sizes.size(), SRSRAN_DFT_COMPLEX) != SRSRAN_SUCCESS) {
+    logger.warning("Error pre-warming DFT plans, they will be planned on demand");
+    return;
+  }
+  for (const auto& cell_cfg : cfg.phy_cell_cfg) {
+    if (prewarm_ofdm_plans(cell_cfg.cell) != SRSRAN_SUCCESS) {
+      logger.warning("Error pre-warming OFDM plans, they will be planned on demand");
+      return;
+    }
+  }
+  logger.info("Pre-warmed %zd DFT sizes, %d plans cached", sizes.size(), srsran_dft_cache_nof_plans());
+}
+
 int phy::init_lte(const phy_args_t&            args,
                   const phy_cfg_t&             cfg,
                   srsran::radio_interface_phy* radio_,
@@ -180,6 +267,8 @@ int phy::init_lte(const phy_args_t&            args,
 
   parse_common_config(cfg);
 
+  prewarm_dft_plans(cfg, phy_log);
+
   // Add workers to workers pool and start threads
   if (not cfg.phy_cell_cfg.empty()) {
     lte_workers.init(args, &workers_common, log_sink, WORKERS_THREAD_PRIO);
@@ -286,6 +375,14 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
   }
 }
 
+void phy::get_pusch_fanout_metrics(pusch_fanout_metrics_t& metrics)
+{
+  metrics = {};
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    lte_workers[i]->get_pusch_fanout_metrics(metrics);
+  }
+}
+
 void phy::cmd_cell_gain(uint32_t cell_id, float gain_db)
 {
   Info("set_cell_gain: cell_id=%d, gain_db=%.2f", cell_id, gain_db);
@@ -376,6 +473,7 @@ int phy::init_nr(const phy_args_t& args, const phy_cfg_t& cfg, stack_interface_p
   worker_args.log.phy_level           = args.log.phy_level;
   worker_args.log.phy_hex_limit       = args.log.phy_hex_limit;
   worker_args.pusch_max_its           = args.nr_pusch_max_its;
+  worker_args.pusch_cb_workers        = args.nr_pusch_cb_workers;
 
   if (not nr_workers->init(worker_args, cfg.phy_cell_cfg_nr)) {
     return SRSRAN_ERROR;
@@ -36,14 +36,11 @@ inline int phy_ue_db::_add_rnti(uint16_t rnti)
 {
   // Private function not mutexed
 
-  // Assert RNTI does NOT exist
-  if (ue_db.count(rnti)) {
+  // Create new UE, it fails if the RNTI exists or its slot is taken by another RNTI
+  if (not ue_db.emplace(rnti)) {
     return SRSRAN_ERROR;
   }
 
-  // Create new UE by accesing it
-  ue_db[rnti].cell_info[0] = {};
-
   // Get UE
   common_ue& ue = ue_db[rnti];
 
@@ -112,7 +109,7 @@ inline void phy_ue_db::_set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t&
 inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const
 {
   uint32_t         ue_cc_idx = 0;
-  const common_ue& ue        = ue_db.at(rnti);
+  const common_ue& ue        = ue_db[rnti];
 
   for (; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
     const cell_info_t& scell_info = ue.cell_info[ue_cc_idx];
@@ -128,7 +125,7 @@ inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) co
 uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const
 {
   // Find the lowest index available PUSCH grant
-  for (const cell_info_t& cell_info : ue_db.at(rnti).cell_info) {
+  for (const cell_info_t& cell_info : ue_db[rnti].cell_info) {
     if (cell_info.is_grant_available[tti]) {
       return cell_info.enb_cc_idx;
     }
@@ -139,7 +136,7 @@ uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const
 
 inline int phy_ue_db::_assert_rnti(uint16_t rnti) const
 {
-  if (not ue_db.count(rnti)) {
+  if (not ue_db.contains(rnti)) {
     return SRSRAN_ERROR;
   }
 
@@ -173,7 +170,7 @@ inline int phy_ue_db::_assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) cons
   }
 
   // Check cell is PCell
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
+  const cell_info_t& cell_info = ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
   if (cell_info.state != cell_state_primary) {
     return SRSRAN_ERROR;
   }
@@ -192,7 +189,7 @@ inline int phy_ue_db::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
     return SRSRAN_ERROR;
   }
 
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info.at(ue_cc_idx);
+  const cell_info_t& cell_info = ue_db[rnti].cell_info.at(ue_cc_idx);
   if (cell_info.state == cell_state_none) {
     return SRSRAN_ERROR;
   }
@@ -207,7 +204,7 @@ inline int phy_ue_db::_assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx)
   }
 
   // Check SCell is active, ignore PCell state
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
+  const cell_info_t& cell_info = ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
   if (cell_info.state != cell_state_primary and cell_info.state != cell_state_secondary_active) {
     return SRSRAN_ERROR;
   }
@@ -254,7 +251,7 @@ inline int phy_ue_db::_get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, srsra
 
   // Write the current configuration
   uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-  phy_cfg            = ue_db.at(rnti).cell_info.at(ue_cc_idx).phy_cfg;
+  phy_cfg            = ue_db[rnti].cell_info.at(ue_cc_idx).phy_cfg;
   return SRSRAN_SUCCESS;
 }
 
@@ -273,8 +270,9 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
   std::lock_guard<std::mutex> lock(mutex);
 
   // Create new user if did not exist
-  if (ue_db.count(rnti) == 0) {
-    _add_rnti(rnti);
+  if (not ue_db.contains(rnti) and _add_rnti(rnti) != SRSRAN_SUCCESS) {
+    srslog::fetch_basic_logger("PHY").error("Error adding rnti=0x%x to the UE database", rnti);
+    return;
   }
 
   // Get UE by reference
@@ -348,12 +346,10 @@ int phy_ue_db::rem_rnti(uint16_t rnti)
 {
   std::lock_guard<std::mutex> lock(mutex);
 
-  if (ue_db.count(rnti) == 0) {
+  if (not ue_db.erase(rnti)) {
     return SRSRAN_ERROR;
   }
 
-  ue_db.erase(rnti);
-
   return SRSRAN_SUCCESS;
 }
 
@@ -431,10 +427,10 @@ int phy_ue_db::get_dl_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dl_cfg_t
 
   // The DL configuration must overwrite the use_tbs_index_alt value (for 256QAM) with the temporary value
   // in case we are in the middle of a reconfiguration
-  if (ue_db.count(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
+  if (ue_db.contains(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
     uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
     if (ue_cc_idx == 0) {
-      dl_cfg.pdsch.use_tbs_index_alt = ue_db.at(rnti).cell_info[ue_cc_idx].stash_use_tbs_index_alt;
+      dl_cfg.pdsch.use_tbs_index_alt = ue_db[rnti].cell_info[ue_cc_idx].stash_use_tbs_index_alt;
     }
   }
   return SRSRAN_SUCCESS;
@@ -452,10 +448,10 @@ int phy_ue_db::get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dci_
 
   // The DCI configuration used for DL grants must overwrite the multiple_csi_request_enabled value with the
   // temporary value in case we are in the middle of a reconfiguration
-  if (ue_db.count(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
+  if (ue_db.contains(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
     uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
     if (ue_cc_idx == 0) {
-      dci_cfg.multiple_csi_request_enabled = ue_db.at(rnti).stashed_multiple_csi_request_enabled;
+      dci_cfg.multiple_csi_request_enabled = ue_db[rnti].stashed_multiple_csi_request_enabled;
     }
   }
   return SRSRAN_SUCCESS;
@@ -496,7 +492,7 @@ bool phy_ue_db::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srsran_
     return false;
   }
 
-  common_ue& ue        = ue_db.at(dci.rnti);
+  common_ue& ue        = ue_db[dci.rnti];
   uint32_t   ue_cc_idx = _get_ue_cc_idx(dci.rnti, enb_cc_idx);
 
   srsran_pdsch_ack_cc_t& pdsch_ack_cc = ue.pdsch_ack[tti].cc[ue_cc_idx];
@@ -564,7 +560,7 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
     return SRSRAN_SUCCESS;
   }
 
-  common_ue&               ue           = ue_db.at(rnti);
+  common_ue&               ue           = ue_db[rnti];
   const srsran::phy_cfg_t& pcell_cfg    = ue.cell_info[0].phy_cfg;
   bool                     uci_required = false;
 
@@ -678,7 +674,7 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
   }
 
   // Get UE
-  common_ue& ue = ue_db.at(rnti);
+  common_ue& ue = ue_db[rnti];
 
   // Get ACK info
   srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
@@ -705,7 +701,7 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
   }
 
   // Get CQI carrier index
-  cell_info_t& cqi_scell_info = ue_db.at(rnti).cell_info[uci_cfg.cqi.scell_index];
+  cell_info_t& cqi_scell_info = ue_db[rnti].cell_info[uci_cfg.cqi.scell_index];
   uint32_t     cqi_cc_idx     = cqi_scell_info.enb_cc_idx;
 
   // Notify CQI only if CRC is valid
@@ -752,7 +748,7 @@ int phy_ue_db::set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid,
   }
 
   // Save resource allocation
-  ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid] = tb;
+  ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid] = tb;
 
   return SRSRAN_SUCCESS;
 }
@@ -767,7 +763,7 @@ int phy_ue_db::get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid,
   }
 
   // writes the latest stored UL transmission grant
-  ra_tb = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid];
+  ra_tb = ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid];
 
   return SRSRAN_SUCCESS;
 }
@@ -38,6 +38,9 @@ int prach_worker::init(const srsran_cell_t&      cell_,
 
   max_prach_offset_us = 50;
 
+  // Correlate with all the root sequences in one pass, as PRACH processing competes with PUSCH for the cores
+  prach_cfg.enable_batch_detection = true;
+
   if (srsran_prach_init(&prach, srsran_symbol_sz(cell.nof_prb))) {
     return -1;
   }
@@ -80,9 +83,8 @@ int prach_worker::init(const srsran_cell_t&      cell_,
 
 void prach_worker::stop()
 {
-  running      = false;
-  sf_buffer* s = nullptr;
-  pending_buffers.push(s);
+  running = false;
+  pending_buffers.stop();
 
   if (nof_workers > 0) {
     wait_thread_finish();
@@ -131,7 +133,11 @@ int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
         current_buffer->reset();
         buffer_pool.deallocate(current_buffer);
       } else {
-        pending_buffers.push(current_buffer);
+        if (not pending_buffers.try_push(current_buffer)) {
+          logger.error("PRACH: Pending buffer queue is full");
+          current_buffer->reset();
+          buffer_pool.deallocate(current_buffer);
+        }
       }
     }
   }
@@ -188,8 +194,8 @@ void prach_worker::run_thread()
 {
   running = true;
   while (running) {
-    sf_buffer* b = pending_buffers.wait_pop();
-    if (running && b) {
+    sf_buffer* b = nullptr;
+    if (pending_buffers.pop_wait(b) and running) {
       int ret = run_tti(b);
       b->reset();
       buffer_pool.deallocate(b);
@@ -117,6 +117,14 @@ int enb_stack_lte::init(const stack_args_t&      args_,
     s1ap.start_pcap(&s1ap_pcap);
   }
 
+  // Set how the stack thread waits for the PHY and the other threads
+  srsran::queue_wait_policy wait_policy;
+  if (not srsran::from_string(args.wait_policy, wait_policy)) {
+    stack_logger.error("Invalid stack wait policy '%s'", args.wait_policy.c_str());
+    return SRSRAN_ERROR;
+  }
+  task_sched.set_wait_policy(wait_policy);
+
   // add sync queue
   sync_task_queue = task_sched.make_task_queue(args.sync_queue_size);
 
@@ -151,6 +159,7 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   gtpu_args.mme_addr                     = args.s1ap.mme_addr;
   gtpu_args.gtp_bind_addr                = args.s1ap.gtp_bind_addr;
   gtpu_args.indirect_tunnel_timeout_msec = args.gtpu_indirect_tunnel_timeout_msec;
+  gtpu_args.s1u_batch_size               = args.gtpu_batch_size;
   if (gtpu.init(gtpu_args, gtpu_adapter.get()) != SRSRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize GTPU");
     return SRSRAN_ERROR;
@@ -173,6 +182,7 @@ void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
   rrc.tti_clock();
+  gtpu.tti_clock();
 }
 
 void enb_stack_lte::stop()
@@ -224,6 +234,7 @@ bool enb_stack_lte::get_metrics(stack_metrics_t* metrics)
     }
     rrc.get_metrics(metrics.rrc);
     s1ap.get_metrics(metrics.s1ap);
+    gtpu.get_metrics(metrics.gtpu);
     if (not pending_stack_metrics.try_push(metrics)) {
       stack_logger.error("Unable to push metrics to queue");
     }
@@ -20,7 +20,9 @@
  */
 
 #include <srsenb/hdr/stack/mac/sched_ue.h>
+#include <chrono>
 #include <string.h>
+#include <thread>
 
 #include "srsenb/hdr/stack/mac/sched.h"
 #include "srsenb/hdr/stack/mac/sched_carrier.h"
@@ -52,12 +54,22 @@ void sched::init(rrc_interface_mac* rrc_, const sched_args_t& sched_cfg_)
   // Initialize first carrier scheduler
   carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0, &sched_results});
 
+  if (sched_cfg.nof_cc_workers > 0) {
+    cc_workers.reset(new srsran::task_thread_pool(sched_cfg.nof_cc_workers));
+  }
+  if (sched_cfg.async_feedback) {
+    for (std::unique_ptr<feedback_queue_t>& q : feedback_queues) {
+      q.reset(new feedback_queue_t(feedback_queue_size));
+    }
+  }
+
   reset();
 }
 
 int sched::reset()
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
+  apply_feedback_queues(true);
   for (std::unique_ptr<carrier_sched>& c : carrier_schedulers) {
     c->reset();
   }
@@ -68,7 +80,7 @@ int sched::reset()
 /// Called by rrc::init
 int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
   // Setup derived config params
   sched_cell_params.resize(cell_cfg.size());
   for (uint32_t cc_idx = 0; cc_idx < cell_cfg.size(); ++cc_idx) {
@@ -105,8 +117,8 @@ int sched::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg)
 {
   {
     // config existing user
-    std::lock_guard<std::mutex> lock(sched_mutex);
-    auto                        it = ue_db.find(rnti);
+    std::unique_lock<std::mutex> lock = lock_sched();
+    auto                         it   = ue_db.find(rnti);
     if (it != ue_db.end()) {
       it->second->set_cfg(ue_cfg);
       return SRSRAN_SUCCESS;
@@ -114,15 +126,17 @@ int sched::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg)
   }
 
   // Add new user case
-  std::unique_ptr<sched_ue>   ue{new sched_ue(rnti, sched_cell_params, ue_cfg)};
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_ptr<sched_ue>    ue{new sched_ue(rnti, sched_cell_params, ue_cfg)};
+  std::unique_lock<std::mutex> lock = lock_sched();
   ue_db.insert(rnti, std::move(ue));
   return SRSRAN_SUCCESS;
 }
 
 int sched::ue_rem(uint16_t rnti)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
+  // Apply the feedback still queued for the UE, so that it does not reach a new UE with the same RNTI
+  apply_feedback_queues();
   if (ue_db.contains(rnti)) {
     ue_db.erase(rnti);
   } else {
@@ -176,16 +190,34 @@ uint32_t sched::get_ul_buffer(uint16_t rnti)
 
 int sched::dl_rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t prio_tx_queue)
 {
-  return ue_db_access_locked(rnti, [&](sched_ue& ue) { ue.dl_buffer_state(lc_id, tx_queue, prio_tx_queue); });
+  return ue_feedback(rnti, ue_feedback_queue_idx, [lc_id, tx_queue, prio_tx_queue](sched_ue& ue) {
+    ue.dl_buffer_state(lc_id, tx_queue, prio_tx_queue);
+  });
 }
 
 int sched::dl_mac_buffer_state(uint16_t rnti, uint32_t ce_code, uint32_t nof_cmds)
 {
-  return ue_db_access_locked(rnti, [ce_code, nof_cmds](sched_ue& ue) { ue.mac_buffer_state(ce_code, nof_cmds); });
+  return ue_feedback(
+      rnti, ue_feedback_queue_idx, [ce_code, nof_cmds](sched_ue& ue) { ue.mac_buffer_state(ce_code, nof_cmds); });
 }
 
 int sched::dl_ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
 {
+  if (sched_cfg.async_feedback) {
+    // The TBS is not known until the ACK is applied. The ACKed bytes are reported through metrics_read instead
+    ue_feedback(
+        rnti,
+        enb_cc_idx,
+        [tti_rx, enb_cc_idx, tb_idx, ack](sched_ue& ue) {
+          int tbs = ue.set_ack_info(tti_point{tti_rx}, enb_cc_idx, tb_idx, ack);
+          if (ack and tbs > 0) {
+            ue.metrics_dl_acked_bytes(tbs);
+          }
+        },
+        __PRETTY_FUNCTION__);
+    return 0;
+  }
+
   int ret = -1;
   ue_db_access_locked(
       rnti,
@@ -196,72 +228,79 @@ int sched::dl_ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint
 
 int sched::ul_crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool crc)
 {
-  return ue_db_access_locked(
-      rnti, [tti_rx, enb_cc_idx, crc](sched_ue& ue) { ue.set_ul_crc(tti_point{tti_rx}, enb_cc_idx, crc); });
+  return ue_feedback(
+      rnti, enb_cc_idx, [tti_rx, enb_cc_idx, crc](sched_ue& ue) { ue.set_ul_crc(tti_point{tti_rx}, enb_cc_idx, crc); });
 }
 
 int sched::dl_ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value)
 {
-  return ue_db_access_locked(
-      rnti, [tti, enb_cc_idx, ri_value](sched_ue& ue) { ue.set_dl_ri(tti_point{tti}, enb_cc_idx, ri_value); });
+  return ue_feedback(rnti, enb_cc_idx, [tti, enb_cc_idx, ri_value](sched_ue& ue) {
+    ue.set_dl_ri(tti_point{tti}, enb_cc_idx, ri_value);
+  });
 }
 
 int sched::dl_pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi_value)
 {
-  return ue_db_access_locked(
-      rnti, [tti, enb_cc_idx, pmi_value](sched_ue& ue) { ue.set_dl_pmi(tti_point{tti}, enb_cc_idx, pmi_value); });
+  return ue_feedback(rnti, enb_cc_idx, [tti, enb_cc_idx, pmi_value](sched_ue& ue) {
+    ue.set_dl_pmi(tti_point{tti}, enb_cc_idx, pmi_value);
+  });
 }
 
 int sched::dl_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi_value)
 {
-  return ue_db_access_locked(
-      rnti, [tti, enb_cc_idx, cqi_value](sched_ue& ue) { ue.set_dl_cqi(tti_point{tti}, enb_cc_idx, cqi_value); });
+  return ue_feedback(rnti, enb_cc_idx, [tti, enb_cc_idx, cqi_value](sched_ue& ue) {
+    ue.set_dl_cqi(tti_point{tti}, enb_cc_idx, cqi_value);
+  });
 }
 
 int sched::dl_sb_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t sb_idx, uint32_t cqi_value)
 {
-  return ue_db_access_locked(rnti, [tti, enb_cc_idx, cqi_value, sb_idx](sched_ue& ue) {
+  return ue_feedback(rnti, enb_cc_idx, [tti, enb_cc_idx, cqi_value, sb_idx](sched_ue& ue) {
     ue.set_dl_sb_cqi(tti_point{tti}, enb_cc_idx, sb_idx, cqi_value);
   });
 }
 
 int sched::dl_rach_info(uint32_t enb_cc_idx, dl_sched_rar_info_t rar_info)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
   return carrier_schedulers[enb_cc_idx]->dl_rach_info(rar_info);
 }
 
 int sched::ul_snr_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code)
 {
-  return ue_db_access_locked(rnti,
-                             [&](sched_ue& ue) { ue.set_ul_snr(tti_point{tti_rx}, enb_cc_idx, snr, ul_ch_code); });
+  return ue_feedback(rnti, enb_cc_idx, [tti_rx, enb_cc_idx, snr, ul_ch_code](sched_ue& ue) {
+    ue.set_ul_snr(tti_point{tti_rx}, enb_cc_idx, snr, ul_ch_code);
+  });
 }
 
 int sched::ul_bsr(uint16_t rnti, uint32_t lcg_id, uint32_t bsr)
 {
-  return ue_db_access_locked(rnti, [lcg_id, bsr](sched_ue& ue) { ue.ul_buffer_state(lcg_id, bsr); });
+  return ue_feedback(rnti, ue_feedback_queue_idx, [lcg_id, bsr](sched_ue& ue) { ue.ul_buffer_state(lcg_id, bsr); });
 }
 
 int sched::ul_buffer_add(uint16_t rnti, uint32_t lcid, uint32_t bytes)
 {
-  return ue_db_access_locked(rnti, [lcid, bytes](sched_ue& ue) { ue.ul_buffer_add(lcid, bytes); });
+  return ue_feedback(rnti, ue_feedback_queue_idx, [lcid, bytes](sched_ue& ue) { ue.ul_buffer_add(lcid, bytes); });
 }
 
 int sched::ul_phr(uint16_t rnti, int phr, uint32_t ul_nof_prb)
 {
-  return ue_db_access_locked(
-      rnti, [phr, ul_nof_prb](sched_ue& ue) { ue.ul_phr(phr, ul_nof_prb); }, __PRETTY_FUNCTION__);
+  return ue_feedback(
+      rnti,
+      ue_feedback_queue_idx,
+      [phr, ul_nof_prb](sched_ue& ue) { ue.ul_phr(phr, ul_nof_prb); },
+      __PRETTY_FUNCTION__);
 }
 
 int sched::ul_sr_info(uint32_t tti, uint16_t rnti)
 {
-  return ue_db_access_locked(
-      rnti, [](sched_ue& ue) { ue.set_sr(); }, __PRETTY_FUNCTION__);
+  return ue_feedback(
+      rnti, ue_feedback_queue_idx, [](sched_ue& ue) { ue.set_sr(); }, __PRETTY_FUNCTION__);
 }
 
 void sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
   carrier_schedulers[0]->set_dl_tti_mask(tti_mask, nof_sfs);
 }
 
@@ -303,7 +342,7 @@ std::array<int, SRSRAN_MAX_CARRIERS> sched::get_enb_ue_activ_cc_map(uint16_t rnt
 
 int sched::set_pdcch_order(uint32_t enb_cc_idx, dl_sched_po_info_t pdcch_order_info)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
   return carrier_schedulers[enb_cc_idx]->pdcch_order_info(pdcch_order_info);
 }
 
@@ -316,7 +355,7 @@ int sched::set_pdcch_order(uint32_t enb_cc_idx, dl_sched_po_info_t pdcch_order_i
 // Downlink Scheduler API
 int sched::dl_sched(uint32_t tti_tx_dl, uint32_t enb_cc_idx, sched_interface::dl_sched_res_t& sched_result)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
   if (not configured) {
     return 0;
   }
@@ -336,7 +375,7 @@ int sched::dl_sched(uint32_t tti_tx_dl, uint32_t enb_cc_idx, sched_interface::dl
 // Uplink Scheduler API
 int sched::ul_sched(uint32_t tti, uint32_t enb_cc_idx, srsenb::sched_interface::ul_sched_res_t& sched_result)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  std::unique_lock<std::mutex> lock = lock_sched();
   if (not configured) {
     return 0;
   }
@@ -360,6 +399,12 @@ int sched::ul_sched(uint32_t tti, uint32_t enb_cc_idx, srsenb::sched_interface::
 void sched::new_tti(tti_point tti_rx)
 {
   last_tti = std::max(last_tti, tti_rx);
+  apply_feedback_queues();
+
+  if (cc_workers != nullptr and carrier_schedulers.size() > 1) {
+    new_tti_parallel(tti_rx);
+    return;
+  }
 
   // Generate sched results for all CCs, if not yet generated
   for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
@@ -370,6 +415,86 @@ void sched::new_tti(tti_point tti_rx)
   }
 }
 
+/// Generate scheduling decision for tti_rx in parallel for the groups of CCs that do not share any UE
+/// NOTE: CCs linked by a CA UE are kept in the same group and scheduled in increasing enb_cc_idx order, as in the
+///       serial case, because the decisions of a CC depend on the UE allocations in the previous CCs (e.g. UCI on PUSCH)
+void sched::new_tti_parallel(tti_point tti_rx)
+{
+  // Merge step. Start the TTI in all CCs, updating the state that is shared by CCs (e.g. UE buffers, results
+  // ringbuffer, paging)
+  std::array<uint32_t, SRSRAN_MAX_CARRIERS> cc_group_id{};
+  for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    cc_group_id[cc_idx] = cc_idx;
+    if (not is_generated(tti_rx, cc_idx)) {
+      carrier_schedulers[cc_idx]->new_tti(tti_rx);
+    }
+  }
+
+  // Join in the same group the CCs configured for each UE
+  for (auto& ue_pair : ue_db) {
+    sched_ue& ue        = *ue_pair.second;
+    uint32_t  min_group = SRSRAN_MAX_CARRIERS;
+    cc_mask_t ue_groups;
+    for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+      if (ue.find_ue_carrier(cc_idx) != nullptr) {
+        min_group = std::min(min_group, cc_group_id[cc_idx]);
+        ue_groups.set(cc_group_id[cc_idx]);
+      }
+    }
+    if (ue_groups.count() > 1) {
+      for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+        if (ue_groups.test(cc_group_id[cc_idx])) {
+          cc_group_id[cc_idx] = min_group;
+        }
+      }
+    }
+  }
+  std::array<cc_mask_t, SRSRAN_MAX_CARRIERS> cc_groups{};
+  for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    if (not is_generated(tti_rx, cc_idx)) {
+      cc_groups[cc_group_id[cc_idx]].set(cc_idx);
+    }
+  }
+
+  // Generate the results of each group of CCs in a different worker. The last group is handled by the caller thread
+  int last_group = -1;
+  {
+    std::lock_guard<std::mutex> lock(cc_workers_mutex);
+    for (uint32_t group_idx = 0; group_idx < carrier_schedulers.size(); ++group_idx) {
+      if (cc_groups[group_idx].none()) {
+        continue;
+      }
+      if (last_group >= 0) {
+        cc_mask_t cc_group = cc_groups[last_group];
+        nof_pending_cc_groups++;
+        cc_workers->push_task([this, tti_rx, cc_group]() {
+          generate_cc_group_results(tti_rx, cc_group);
+          std::lock_guard<std::mutex> lock(cc_workers_mutex);
+          nof_pending_cc_groups--;
+          cc_workers_cvar.notify_all();
+        });
+      }
+      last_group = group_idx;
+    }
+  }
+  if (last_group >= 0) {
+    generate_cc_group_results(tti_rx, cc_groups[last_group]);
+  }
+
+  // Wait for the remaining groups
+  std::unique_lock<std::mutex> lock(cc_workers_mutex);
+  cc_workers_cvar.wait(lock, [this]() { return nof_pending_cc_groups == 0; });
+}
+
+void sched::generate_cc_group_results(tti_point tti_rx, cc_mask_t cc_group)
+{
+  for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    if (cc_group.test(cc_idx)) {
+      carrier_schedulers[cc_idx]->generate_tti_result(tti_rx);
+    }
+  }
+}
+
 /// Check if TTI result is generated
 bool sched::is_generated(srsran::tti_point tti_rx, uint32_t enb_cc_idx) const
 {
@@ -382,12 +507,117 @@ int sched::metrics_read(uint16_t rnti, mac_ue_metrics_t& metrics)
       rnti, [&metrics](sched_ue& ue) { ue.metrics_read(metrics); }, "metrics_read");
 }
 
+void sched::lock_metrics_read(mac_sched_lock_metrics_t& metrics)
+{
+  metrics.nof_locks         = nof_locks.exchange(0, std::memory_order_relaxed);
+  metrics.nof_contended     = nof_contended_locks.exchange(0, std::memory_order_relaxed);
+  metrics.wait_time_us      = lock_wait_ns.exchange(0, std::memory_order_relaxed) / 1000;
+  metrics.nof_queued_events = nof_queued_events.exchange(0, std::memory_order_relaxed);
+  metrics.nof_queue_full    = nof_queue_full.exchange(0, std::memory_order_relaxed);
+}
+
+/// Takes sched_mutex, accounting for the time spent waiting when it is held by another thread
+std::unique_lock<std::mutex> sched::lock_sched()
+{
+  nof_locks.fetch_add(1, std::memory_order_relaxed);
+  std::unique_lock<std::mutex> lock(sched_mutex, std::try_to_lock);
+  if (not lock.owns_lock()) {
+    auto tp = std::chrono::steady_clock::now();
+    lock.lock();
+    auto wait = std::chrono::steady_clock::now() - tp;
+    nof_contended_locks.fetch_add(1, std::memory_order_relaxed);
+    lock_wait_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count(),
+                           std::memory_order_relaxed);
+  }
+  return lock;
+}
+
+/// Applies the UE feedback queued since the last call, in the order it was received for each queue
+/// NOTE: Must be called with sched_mutex held. The feedback pushed during the call is left for the next TTI, and so is
+///       the feedback queued behind a slot that a preempted producer has not filled yet
+void sched::apply_feedback_queues(bool discard)
+{
+  for (std::unique_ptr<feedback_queue_t>& q : feedback_queues) {
+    if (q != nullptr) {
+      apply_feedback_queue(*q, discard);
+    }
+  }
+}
+
+/// Returns false if it stopped at a slot that a producer reserved but was preempted before filling. The producer is not
+/// waited for under sched_mutex: that slot and the ones behind it are applied by the next call
+/// NOTE: Must be called with sched_mutex held
+bool sched::apply_feedback_queue(feedback_queue_t& q, bool discard)
+{
+  feedback_event_t ev;
+  for (size_t n = q.size(); n > 0; --n) {
+    if (not q.try_pop(ev)) {
+      return false;
+    }
+    if (not discard) {
+      apply_feedback_event(ev);
+    }
+  }
+  return true;
+}
+
+/// NOTE: Must be called with sched_mutex held
+int sched::apply_feedback_event(feedback_event_t& ev)
+{
+  auto it = ue_db.find(ev.rnti);
+  if (it != ue_db.end()) {
+    ev.func(*it->second);
+    return SRSRAN_SUCCESS;
+  }
+  if (ev.func_name != nullptr) {
+    Error("SCHED: User rnti=0x%x not found. Failed to call %s.", ev.rnti, ev.func_name);
+  } else {
+    Error("SCHED: User rnti=0x%x not found.", ev.rnti);
+  }
+  return SRSRAN_ERROR;
+}
+
+/// Pushes UE feedback to the queue of the given carrier, to be applied at the start of the next TTI. If async feedback
+/// is disabled, the feedback is applied right away under sched_mutex. If the queue is full, the queued feedback is
+/// applied before it, so that the feedback of a UE is never reordered
+template <typename Func>
+int sched::ue_feedback(uint16_t rnti, uint32_t enb_cc_idx, Func&& f, const char* func_name)
+{
+  if (enb_cc_idx >= feedback_queues.size() or feedback_queues[enb_cc_idx] == nullptr) {
+    return ue_db_access_locked(rnti, std::forward<Func>(f), func_name);
+  }
+  feedback_event_t ev;
+  ev.rnti      = rnti;
+  ev.func_name = func_name;
+  ev.func      = std::forward<Func>(f);
+  if (feedback_queues[enb_cc_idx]->try_push(std::move(ev))) {
+    nof_queued_events.fetch_add(1, std::memory_order_relaxed);
+    return SRSRAN_SUCCESS;
+  }
+  nof_queue_full.fetch_add(1, std::memory_order_relaxed);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock = lock_sched();
+      if (apply_feedback_queue(*feedback_queues[enb_cc_idx])) {
+        return apply_feedback_event(ev);
+      }
+    }
+    // The oldest feedback is still being pushed by a preempted producer. Queue this one behind it, and wait for the
+    // producer outside sched_mutex if the queue is still full
+    if (feedback_queues[enb_cc_idx]->try_push(std::move(ev))) {
+      nof_queued_events.fetch_add(1, std::memory_order_relaxed);
+      return SRSRAN_SUCCESS;
+    }
+    std::this_thread::yield();
+  }
+}
+
 // Common way to access ue_db elements in a read locking way
 template <typename Func>
 int sched::ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name, bool log_fail)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
-  auto                        it = ue_db.find(rnti);
+  std::unique_lock<std::mutex> lock = lock_sched();
+  auto                         it   = ue_db.find(rnti);
   if (it != ue_db.end()) {
     f(*it->second);
   } else {
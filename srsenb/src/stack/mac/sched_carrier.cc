@@ -21,6 +21,7 @@
 
 #include "srsenb/hdr/stack/mac/sched_carrier.h"
 #include "srsenb/hdr/stack/mac/sched_helpers.h"
+#include "srsenb/hdr/stack/mac/schedulers/sched_freq_pf.h"
 #include "srsenb/hdr/stack/mac/schedulers/sched_time_pf.h"
 #include "srsenb/hdr/stack/mac/schedulers/sched_time_rr.h"
 #include "srsran/common/standard_streams.h"
@@ -362,6 +363,7 @@ void sched::carrier_sched::reset()
   ra_sched_ptr.reset();
   bc_sched_ptr.reset();
   pending_pdcch_orders.clear();
+  last_started_tti = {};
 }
 
 void sched::carrier_sched::carrier_cfg(const sched_cell_params_t& cell_params_)
@@ -377,6 +379,9 @@ void sched::carrier_sched::carrier_cfg(const sched_cell_params_t& cell_params_)
   if (cell_params_.sched_cfg->sched_policy == "time_rr") {
     sched_algo.reset(new sched_time_rr{*cc_cfg, *cell_params_.sched_cfg});
     logger.info("Using time-domain RR scheduling policy for cc=%d", cc_cfg->enb_cc_idx);
+  } else if (cell_params_.sched_cfg->sched_policy == "freq_pf") {
+    sched_algo.reset(new sched_freq_pf{*cc_cfg, *cell_params_.sched_cfg});
+    logger.info("Using frequency-domain PF scheduling policy for cc=%d", cc_cfg->enb_cc_idx);
   } else {
     sched_algo.reset(new sched_time_pf{*cc_cfg, *cell_params_.sched_cfg});
     logger.info("Using time-domain PF scheduling policy for cc=%d", cc_cfg->enb_cc_idx);
@@ -393,19 +398,39 @@ void sched::carrier_sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
   sf_dl_mask.assign(tti_mask, tti_mask + nof_sfs);
 }
 
-const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_rx)
+void sched::carrier_sched::new_tti(tti_point tti_rx)
 {
-  sf_sched*        tti_sched = get_sf_sched(tti_rx);
-  sf_sched_result* sf_result = prev_sched_results->get_sf(tti_rx);
-  cc_sched_result* cc_result = sf_result->get_cc(enb_cc_idx);
+  if (last_started_tti == tti_rx) {
+    return;
+  }
+  last_started_tti = tti_rx;
 
-  bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] == 0;
+  /* Reset the subframe results, including the one used for Msg3 */
+  sf_sched* tti_sched = get_sf_sched(tti_rx);
+  get_sf_sched(tti_rx + MSG3_DELAY_MS);
 
   /* Refresh UE internal buffers and subframe vars */
   for (auto& user : *ue_db) {
     user.second->new_subframe(tti_rx, enb_cc_idx);
   }
 
+  /* Schedule Broadcast data (SIB and paging). The paging queues are shared by all carriers */
+  bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] == 0;
+  if (dl_active) {
+    bc_sched_ptr->dl_sched(tti_sched);
+  }
+}
+
+const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_rx)
+{
+  new_tti(tti_rx);
+
+  sf_sched*        tti_sched = get_sf_sched(tti_rx);
+  sf_sched_result* sf_result = prev_sched_results->get_sf(tti_rx);
+  cc_sched_result* cc_result = sf_result->get_cc(enb_cc_idx);
+
+  bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] == 0;
+
   /* Schedule PHICH */
   for (auto& ue_pair : *ue_db) {
     if (tti_sched->alloc_phich(ue_pair.second.get()) == alloc_result::no_grant_space) {
@@ -415,9 +440,6 @@ const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_r
 
   /* Schedule DL control data */
   if (dl_active) {
-    /* Schedule Broadcast data (SIB and paging) */
-    bc_sched_ptr->dl_sched(tti_sched);
-
     /* Schedule RAR */
     ra_sched_ptr->dl_sched(tti_sched);
 
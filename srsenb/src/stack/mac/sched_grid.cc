@@ -538,7 +538,15 @@ alloc_result sf_sched::alloc_dl_user(sched_ue* user, const rbgmask_t& user_mask,
     }
   }
 
-  bool has_pusch_grant = is_ul_alloc(user->get_rnti()) or cc_results->is_ul_alloc(user->get_rnti());
+  // Only the carriers of the UE are checked, as other carriers may be generating their results in parallel
+  bool has_pusch_grant = is_ul_alloc(user->get_rnti());
+  for (uint32_t cc = 0; cc < cc_results->enb_cc_list.size() and not has_pusch_grant; ++cc) {
+    if (user->find_ue_carrier(cc) != nullptr) {
+      for (const auto& pusch : cc_results->enb_cc_list[cc].ul_sched_result.pusch) {
+        has_pusch_grant |= pusch.dci.rnti == user->get_rnti();
+      }
+    }
+  }
 
   // Check if there is space in the PUCCH for HARQ ACKs
   const sched_interface::ue_cfg_t& ue_cfg    = user->get_ue_cfg();
@@ -822,12 +830,15 @@ uci_pusch_t is_uci_included(const sf_sched*        sf_sched,
   }
 
   for (uint32_t enbccidx = 0; enbccidx < other_cc_results.enb_cc_list.size(); ++enbccidx) {
+    auto p = user->get_active_cell_index(enbccidx);
+    if (not p.first) {
+      continue;
+    }
     for (uint32_t j = 0; j < other_cc_results.enb_cc_list[enbccidx].ul_sched_result.pusch.size(); ++j) {
       // Checks all the UL grants already allocated for the given rnti
       if (other_cc_results.enb_cc_list[enbccidx].ul_sched_result.pusch[j].dci.rnti == user->get_rnti()) {
-        auto p = user->get_active_cell_index(enbccidx);
         // If the UE CC Idx is the lowest so far
-        if (p.first and p.second < ue_cc_idx) {
+        if (p.second < ue_cc_idx) {
           ue_cc_idx      = p.second;
           sel_enb_cc_idx = enbccidx;
         }
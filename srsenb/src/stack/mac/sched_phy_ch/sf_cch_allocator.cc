@@ -40,6 +40,11 @@ void sf_cch_allocator::init(const sched_cell_params_t& cell_params_)
   dci_record_list.reserve(16);
   last_dci_dfs.reserve(16);
   temp_dci_dfs.reserve(16);
+  record_cands.reserve(16);
+  solution_cands.reserve(16);
+  solution_states.reserve(17);
+  fast_path.reserve(16);
+  failed_states.resize(1024);
 }
 
 void sf_cch_allocator::new_tti(tti_point tti_rx_)
@@ -48,6 +53,10 @@ void sf_cch_allocator::new_tti(tti_point tti_rx_)
 
   dci_record_list.clear();
   last_dci_dfs.clear();
+  record_cands.clear();
+  solution_cands.clear();
+  solution_states.assign(1, search_state{});
+  tti_dfs_node_budget = MAX_FAST_SEARCH_NODES_TTI;
   current_cfix     = cc_cfg->sched_cfg->min_nof_ctrl_symbols - 1;
   current_max_cfix = cc_cfg->sched_cfg->max_nof_ctrl_symbols - 1;
 }
@@ -99,6 +108,20 @@ bool sf_cch_allocator::alloc_dci(alloc_type_t alloc_type, uint32_t aggr_idx, sch
     }
   }
 
+  if (cc_cfg->sched_cfg->fast_pdcch_alloc) {
+    dci_record_list.push_back(record);
+    if (alloc_dci_fast()) {
+      if (is_dl_ctrl_alloc(alloc_type)) {
+        current_max_cfix = current_cfix;
+      }
+      return true;
+    }
+    dci_record_list.pop_back();
+    record_cands.pop_back();
+    current_cfix = start_cfix;
+    return false;
+  }
+
   // Try to allocate grant. If it fails, attempt the same grant, but using a different permutation of past grant DCI
   // positions
   do {
@@ -229,6 +252,265 @@ void sf_cch_allocator::rem_last_dci()
   // Remove DCI record
   last_dci_dfs.pop_back();
   dci_record_list.pop_back();
+  if (record_cands.size() > dci_record_list.size()) {
+    record_cands.pop_back();
+    solution_cands.pop_back();
+    solution_states.pop_back();
+  }
+}
+
+/**
+ * Same search as the one of get_next_dfs() and alloc_dfs_node(), i.e. it continues the DFS from the current solution
+ * and then restarts it for higher CFIs, so both find the same solution. However:
+ * - the CCE positions of each DCI record are filtered and their PDCCH/PUCCH footprint computed only once per TTI
+ * - a subtree that was fully explored without finding a solution is remembered, and not explored again while the DCI
+ * records it was explored with remain allocated
+ * - the search gives up after MAX_FAST_SEARCH_NODES positions, or when the TTI has used MAX_FAST_SEARCH_NODES_TTI
+ * positions, and keeps the current solution. Afterwards, DCIs are only placed on top of the current solution (greedy)
+ * @return true if a solution including the last DCI record was found
+ */
+bool sf_cch_allocator::alloc_dci_fast()
+{
+  record_cands.emplace_back();
+  record_cands.back().record_id = next_record_id++;
+  uint32_t new_idx              = dci_record_list.size() - 1;
+  fast_path.resize(dci_record_list.size());
+
+  // Try first to place the new DCI on top of the current solution
+  const dci_candidate_list& new_cands = get_candidates(new_idx);
+  search_state              next;
+  for (uint32_t c = 0; c < new_cands.size(); ++c) {
+    if (fits(new_cands[c], solution_states.back(), next)) {
+      fast_path[new_idx] = c;
+      set_fast_solution(new_idx);
+      return true;
+    }
+  }
+
+  // Continue the DFS from the current solution, backtracking one DCI at a time
+  nof_dfs_nodes   = 0;
+  dfs_node_budget = tti_dfs_node_budget < MAX_FAST_SEARCH_NODES ? tti_dfs_node_budget : MAX_FAST_SEARCH_NODES;
+  search_aborted  = false;
+  bool     success       = false;
+  uint32_t first_changed = 0;
+  for (int depth = new_idx - 1; depth >= 0 and not success and not search_aborted; --depth) {
+    const dci_candidate_list& cands = get_candidates(depth);
+    for (uint32_t c = solution_cands[depth] + 1; c < cands.size() and not success and not search_aborted; ++c) {
+      success       = try_fast_candidate(depth, cands[c], c, solution_states[depth]);
+      first_changed = depth;
+    }
+  }
+
+  // Restart the DFS with a higher CFI
+  uint32_t start_cfix = current_cfix;
+  while (not success and not search_aborted and current_cfix < current_max_cfix) {
+    current_cfix++;
+    success       = fast_dfs(0, search_state{});
+    first_changed = 0;
+  }
+  tti_dfs_node_budget -= nof_dfs_nodes;
+  if (success) {
+    set_fast_solution(first_changed);
+    return true;
+  }
+  current_cfix = start_cfix;
+  return false;
+}
+
+/// Places the DCI records from depth onwards, given the CCEs and PUCCH resources taken by the previous ones
+bool sf_cch_allocator::fast_dfs(uint32_t depth, const search_state& state)
+{
+  if (depth == dci_record_list.size()) {
+    return true;
+  }
+  if (is_failed_state(depth, state)) {
+    return false;
+  }
+  const dci_candidate_list& cands = get_candidates(depth);
+  for (uint32_t c = 0; c < cands.size(); ++c) {
+    if (try_fast_candidate(depth, cands[c], c, state)) {
+      return true;
+    }
+    if (search_aborted) {
+      return false;
+    }
+  }
+  add_failed_state(depth, state);
+  return false;
+}
+
+bool sf_cch_allocator::try_fast_candidate(uint32_t             depth,
+                                          const dci_candidate& cand,
+                                          uint32_t             cand_idx,
+                                          const search_state&  state)
+{
+  if (nof_dfs_nodes == dfs_node_budget) {
+    search_aborted = true;
+    return false;
+  }
+  nof_dfs_nodes++;
+  search_state next;
+  if (not fits(cand, state, next)) {
+    return false;
+  }
+  fast_path[depth] = cand_idx;
+  return fast_dfs(depth + 1, next);
+}
+
+/// Checks whether the DCI candidate collides in the PDCCH or PUCCH with the given state, and computes the next state
+bool sf_cch_allocator::fits(const dci_candidate& cand, const search_state& state, search_state& next) const
+{
+  bool check_pucch = cand.pucch_n_prb >= 0 and not cc_cfg->sched_cfg->pucch_mux_enabled;
+  for (uint32_t w = 0; w < state.cce_mask.size(); ++w) {
+    if ((state.cce_mask[w] & cand.footprint.cce_mask[w]) != 0 or
+        (check_pucch and (state.pucch_mask[w] & cand.footprint.pucch_mask[w]) != 0)) {
+      return false;
+    }
+    next.cce_mask[w]   = state.cce_mask[w] | cand.footprint.cce_mask[w];
+    next.pucch_mask[w] = state.pucch_mask[w] | cand.footprint.pucch_mask[w];
+  }
+  return true;
+}
+
+/// Computes the CCE positions of a DCI record for the current CFI, with the same checks as alloc_dfs_node()
+const sf_cch_allocator::dci_candidate_list& sf_cch_allocator::get_candidates(uint32_t record_idx)
+{
+  record_candidates&  rec_cands = record_cands[record_idx];
+  dci_candidate_list& cands     = rec_cands.cfi_cands[current_cfix];
+  if (rec_cands.computed[current_cfix]) {
+    return cands;
+  }
+  rec_cands.computed[current_cfix] = true;
+  cands.clear();
+
+  const alloc_record&           record   = dci_record_list[record_idx];
+  const cce_cfi_position_table* dci_locs = get_cce_loc_table(record.alloc_type, record.user, current_cfix);
+  if (dci_locs == nullptr) {
+    return cands;
+  }
+  const cce_position_list& dci_pos_list = (*dci_locs)[record.aggr_idx];
+  for (uint32_t i = 0; i < dci_pos_list.size(); ++i) {
+    dci_candidate cand = {};
+    cand.dci_pos_idx   = i;
+    cand.ncce          = dci_pos_list[i];
+    cand.pucch_n_prb   = -1;
+
+    if (record.alloc_type == alloc_type_t::DL_DATA and not record.pusch_uci) {
+      // The UE needs to allocate space in PUCCH for HARQ-ACK
+      pucch_cfg_common.n_pucch = cand.ncce + pucch_cfg_common.N_pucch_1;
+      if (is_pucch_sr_collision(record.user->get_ue_cfg().pucch_cfg, to_tx_dl_ack(tti_rx), pucch_cfg_common.n_pucch)) {
+        continue;
+      }
+      cand.pucch_n_prb = srsran_pucch_n_prb(&cc_cfg->cfg.cell, &pucch_cfg_common, 0);
+      int low_rb       = cand.pucch_n_prb < (int)cc_cfg->cfg.cell.nof_prb / 2
+                             ? cand.pucch_n_prb
+                             : cc_cfg->cfg.cell.nof_prb - cand.pucch_n_prb - 1;
+      if (cc_cfg->sched_cfg->pucch_harq_max_rb > 0 && low_rb >= cc_cfg->sched_cfg->pucch_harq_max_rb) {
+        logger.info("Skipping PDCCH allocation for CCE=%d due to PUCCH HARQ falling outside region\n", cand.ncce);
+        continue;
+      }
+      cand.footprint.pucch_mask[cand.pucch_n_prb / 64] |= 1ULL << (cand.pucch_n_prb % 64U);
+    }
+    for (uint32_t cce = cand.ncce; cce < cand.ncce + (1U << record.aggr_idx); ++cce) {
+      cand.footprint.cce_mask[cce / 64] |= 1ULL << (cce % 64U);
+    }
+    cands.push_back(cand);
+  }
+  return cands;
+}
+
+/// Sets the DFS path found by the fast search as the current solution, starting from the first DCI record whose
+/// position changed. The tree nodes are the ones the exhaustive search would have generated
+void sf_cch_allocator::set_fast_solution(uint32_t first_record_idx)
+{
+  last_dci_dfs.resize(first_record_idx);
+  solution_cands.resize(first_record_idx);
+  solution_states.resize(first_record_idx + 1);
+  for (uint32_t i = first_record_idx; i < dci_record_list.size(); ++i) {
+    const alloc_record&  record = dci_record_list[i];
+    const dci_candidate& cand   = get_candidates(i)[fast_path[i]];
+    solution_cands.push_back(fast_path[i]);
+    solution_states.emplace_back();
+    fits(cand, solution_states[i], solution_states[i + 1]);
+
+    tree_node node;
+    node.dci_pos_idx  = cand.dci_pos_idx;
+    node.dci_pos.L    = record.aggr_idx;
+    node.dci_pos.ncce = cand.ncce;
+    node.rnti         = record.user != nullptr ? record.user->get_rnti() : SRSRAN_INVALID_RNTI;
+    node.pucch_n_prb  = cand.pucch_n_prb;
+    node.current_mask.resize(nof_cces());
+    node.current_mask.fill(cand.ncce, cand.ncce + (1U << record.aggr_idx));
+    if (last_dci_dfs.empty()) {
+      node.total_mask.resize(nof_cces());
+      node.total_pucch_mask.resize(cc_cfg->nof_prb());
+    } else {
+      node.total_mask       = last_dci_dfs.back().total_mask;
+      node.total_pucch_mask = last_dci_dfs.back().total_pucch_mask;
+    }
+    node.total_mask |= node.current_mask;
+    if (node.pucch_n_prb >= 0) {
+      node.total_pucch_mask.set(node.pucch_n_prb);
+    }
+    last_dci_dfs.push_back(node);
+  }
+}
+
+static uint32_t failed_state_key(uint32_t cfix, uint32_t depth)
+{
+  return (cfix << 8U) | depth;
+}
+
+static size_t failed_state_hash(uint32_t key, const std::array<uint64_t, 2>& cce, const std::array<uint64_t, 2>& pucch)
+{
+  uint64_t h = key;
+  for (uint64_t w : {cce[0], cce[1], pucch[0], pucch[1]}) {
+    h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 29U;
+  }
+  return h;
+}
+
+/// Number of hash table slots probed for each failed state
+static const uint32_t failed_state_probes = 4;
+
+bool sf_cch_allocator::is_valid(const failed_state& e) const
+{
+  return e.nof_records > 0 and e.nof_records <= record_cands.size() and
+         record_cands[e.nof_records - 1].record_id == e.last_record_id;
+}
+
+bool sf_cch_allocator::is_failed_state(uint32_t depth, const search_state& state) const
+{
+  uint32_t key  = failed_state_key(current_cfix, depth);
+  size_t   hash = failed_state_hash(key, state.cce_mask, state.pucch_mask);
+  for (uint32_t i = 0; i < failed_state_probes; ++i) {
+    const failed_state& e = failed_states[(hash + i) & (failed_states.size() - 1)];
+    if (e.key == key and e.state.cce_mask == state.cce_mask and e.state.pucch_mask == state.pucch_mask and
+        is_valid(e)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void sf_cch_allocator::add_failed_state(uint32_t depth, const search_state& state)
+{
+  uint32_t key  = failed_state_key(current_cfix, depth);
+  size_t   hash = failed_state_hash(key, state.cce_mask, state.pucch_mask);
+  // Take the first slot without a valid entry, or overwrite the first slot if all of them are valid
+  failed_state* slot = &failed_states[hash & (failed_states.size() - 1)];
+  for (uint32_t i = 0; i < failed_state_probes; ++i) {
+    failed_state& e = failed_states[(hash + i) & (failed_states.size() - 1)];
+    if (not is_valid(e)) {
+      slot = &e;
+      break;
+    }
+  }
+  slot->last_record_id = record_cands.back().record_id;
+  slot->nof_records    = record_cands.size();
+  slot->key            = key;
+  slot->state          = state;
 }
 
 void sf_cch_allocator::get_allocs(alloc_result_t* vec, pdcch_mask_t* tot_mask, size_t idx) const
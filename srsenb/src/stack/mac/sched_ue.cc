@@ -178,6 +178,8 @@ void sched_ue::metrics_read(mac_ue_metrics_t& metrics)
   sched_ue_cell& pcell  = cells[cfg.supported_cc_list[0].enb_cc_idx];
   metrics.ul_snr_offset = pcell.get_ul_snr_offset();
   metrics.dl_cqi_offset = pcell.get_dl_cqi_offset();
+  metrics.tx_brate += dl_acked_bytes * 8;
+  dl_acked_bytes = 0;
 }
 
 tti_point prev_meas_gap_start(tti_point tti, uint32_t period, uint32_t offset)
@@ -519,13 +519,20 @@ tbs_info compute_mcs_and_tbs_lower_bound(const sched_ue_cell& ue_cell,
   return cqi_to_tbs_dl(ue_cell, rbg_mask, nof_re_lb, dci_format);
 }
 
-bool find_optimal_rbgmask(const sched_ue_cell&       ue_cell,
-                          tti_point                  tti_tx_dl,
-                          const rbgmask_t&           dl_mask,
-                          srsran_dci_format_t        dci_format,
-                          srsran::interval<uint32_t> req_bytes,
-                          tbs_info&                  tb,
-                          rbgmask_t&                 newtxmask)
+namespace {
+
+/// Finds the RBG mask, among the available RBGs of dl_mask, with the lowest TBS that fits the max requested bytes.
+/// With wideband CQI, the number of RBGs is found with the TBS estimated for the lowest RBGs, and trim_wideband_mask
+/// reduces newtxmask to that number of RBGs and updates tb. With subband CQI, the RBGs with lowest CQI are removed
+template <typename WidebandTrimFunc>
+bool find_optimal_rbgmask_impl(const sched_ue_cell&       ue_cell,
+                               tti_point                  tti_tx_dl,
+                               const rbgmask_t&           dl_mask,
+                               srsran_dci_format_t        dci_format,
+                               srsran::interval<uint32_t> req_bytes,
+                               tbs_info&                  tb,
+                               rbgmask_t&                 newtxmask,
+                               const WidebandTrimFunc&    trim_wideband_mask)
 {
   // Find the largest set of available RBGs possible
   newtxmask = find_available_rbgmask(dl_mask.size(), dci_format == SRSRAN_DCI_FORMAT1A, dl_mask);
@@ -559,12 +566,8 @@ bool find_optimal_rbgmask(const sched_ue_cell&       ue_cell,
     uint32_t upper_nrbg = std::get<2>(ret);
     int      upper_tbs  = std::get<3>(ret);
     if (upper_tbs >= (int)req_bytes.stop()) {
-      tb      = tb_table[upper_nrbg - 1];
-      int pos = 0;
-      for (uint32_t n_rbgs = newtxmask.count(); n_rbgs > upper_nrbg; --n_rbgs) {
-        pos = newtxmask.find_lowest(pos + 1, newtxmask.size());
-      }
-      newtxmask.from_uint64(~((1U << (uint64_t)pos) - 1U) & ((1U << newtxmask.size()) - 1U));
+      tb = tb_table[upper_nrbg - 1];
+      trim_wideband_mask(upper_nrbg, newtxmask, tb);
     }
     return true;
   }
@@ -576,7 +579,6 @@ bool find_optimal_rbgmask(const sched_ue_cell&       ue_cell,
   //       going to be the optimal solution
 
   // Subtract RBGs with lowest CQI until objective is not met
-  // TODO: can be optimized
   rbgmask_t smaller_mask;
   tbs_info  tb2;
   do {
@@ -587,11 +589,54 @@ bool find_optimal_rbgmask(const sched_ue_cell&       ue_cell,
       newtxmask = smaller_mask;
     }
   } while (tb2.tbs_bytes > (int)req_bytes.stop());
-  if (tb.tbs_bytes <= (int)req_bytes.stop()) {
-    return true;
-  }
 
   return true;
 }
 
+} // namespace
+
+bool find_optimal_rbgmask(const sched_ue_cell&       ue_cell,
+                          tti_point                  tti_tx_dl,
+                          const rbgmask_t&           dl_mask,
+                          srsran_dci_format_t        dci_format,
+                          srsran::interval<uint32_t> req_bytes,
+                          tbs_info&                  tb,
+                          rbgmask_t&                 newtxmask)
+{
+  // The available RBGs are contiguous. Keep the highest nof_rbgs of them
+  auto trim_contiguous = [](uint32_t nof_rbgs, rbgmask_t& mask, tbs_info& tb) {
+    int pos = 0;
+    for (uint32_t n_rbgs = mask.count(); n_rbgs > nof_rbgs; --n_rbgs) {
+      pos = mask.find_lowest(pos + 1, mask.size());
+    }
+    mask.from_uint64(~((1U << (uint64_t)pos) - 1U) & ((1U << mask.size()) - 1U));
+  };
+  return find_optimal_rbgmask_impl(ue_cell, tti_tx_dl, dl_mask, dci_format, req_bytes, tb, newtxmask, trim_contiguous);
+}
+
+bool find_optimal_sb_rbgmask(const sched_ue_cell&       ue_cell,
+                             tti_point                  tti_tx_dl,
+                             const rbgmask_t&           dl_mask,
+                             srsran_dci_format_t        dci_format,
+                             srsran::interval<uint32_t> req_bytes,
+                             tbs_info&                  tb,
+                             rbgmask_t&                 newtxmask)
+{
+  // The available RBGs may not be contiguous. Remove the lowest RBGs one by one, and re-check the TBS with the kept
+  // RBGs, which may have fewer PRBs than the lowest ones (e.g. last RBG)
+  auto trim_subband = [&ue_cell, tti_tx_dl, dci_format, req_bytes](uint32_t nof_rbgs, rbgmask_t& mask, tbs_info& tb) {
+    int last_removed = -1;
+    for (uint32_t n_rbgs = mask.count(); n_rbgs > nof_rbgs; --n_rbgs) {
+      last_removed = mask.find_lowest(0, mask.size());
+      mask.reset(last_removed);
+    }
+    tb = compute_mcs_and_tbs_lower_bound(ue_cell, tti_tx_dl, mask, dci_format);
+    if (tb.tbs_bytes < (int)req_bytes.stop() and last_removed >= 0) {
+      mask.set(last_removed);
+      tb = compute_mcs_and_tbs_lower_bound(ue_cell, tti_tx_dl, mask, dci_format);
+    }
+  };
+  return find_optimal_rbgmask_impl(ue_cell, tti_tx_dl, dl_mask, dci_format, req_bytes, tb, newtxmask, trim_subband);
+}
+
 } // namespace srsenb
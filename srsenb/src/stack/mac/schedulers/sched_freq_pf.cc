@@ -0,0 +1,309 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/schedulers/sched_freq_pf.h"
+#include <algorithm>
+
+namespace srsenb {
+
+using srsran::tti_point;
+
+sched_freq_pf::sched_freq_pf(const sched_cell_params_t& cell_params_, const sched_interface::sched_args_t& sched_args) :
+  cc_cfg(&cell_params_), ul_sched(cell_params_, sched_args, false)
+{
+  if (not sched_args.sched_policy_args.empty()) {
+    fairness_coeff = std::stof(sched_args.sched_policy_args);
+  }
+
+  // Same RBG to subband mapping as the subband CQI reports (TS 36.213, 7.2.1)
+  nof_subbands = std::max(1, srsran_cqi_hl_get_no_subbands(cc_cfg->nof_prb()));
+  srsran_assert(nof_subbands <= max_nof_subbands, "Invalid number of subbands (%d)", nof_subbands);
+  for (uint32_t sb = 0; sb < nof_subbands; ++sb) {
+    sb_rbgmasks[sb] = rbgmask_t(cc_cfg->nof_rbgs);
+  }
+  for (uint32_t rbg = 0; rbg < cc_cfg->nof_rbgs; ++rbg) {
+    sb_rbgmasks[rbg * nof_subbands / cc_cfg->nof_rbgs].set(rbg);
+  }
+
+  dl_ues.reserve(SRSENB_MAX_UES);
+  sb_candidates.reserve(SRSENB_MAX_UES);
+}
+
+void sched_freq_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
+{
+  current_tti_rx = tti_point{tti_sched->get_tti_rx()};
+  // remove deleted users from history
+  for (auto it = ue_history_db.begin(); it != ue_history_db.end();) {
+    if (not ue_db.contains(it->first)) {
+      it = ue_history_db.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // add new users to history db, and update the list of UEs with DL HARQs available
+  dl_ues.clear();
+  for (auto& u : ue_db) {
+    auto it = ue_history_db.find(u.first);
+    if (it == ue_history_db.end()) {
+      it = ue_history_db.insert(u.first, ue_ctxt{u.first, fairness_coeff}).value();
+    }
+    it->second.new_tti(*cc_cfg, nof_subbands, *u.second, tti_sched);
+    if (it->second.dl_newtx_h != nullptr or it->second.dl_retx_h != nullptr) {
+      dl_ues.push_back(&it->second);
+    }
+  }
+  std::sort(dl_ues.begin(), dl_ues.end(), [](const ue_ctxt* lhs, const ue_ctxt* rhs) {
+    bool is_retx1 = lhs->dl_retx_h != nullptr, is_retx2 = rhs->dl_retx_h != nullptr;
+    return (is_retx1 and not is_retx2) or (is_retx1 == is_retx2 and lhs->dl_prio > rhs->dl_prio);
+  });
+}
+
+/*****************************************************************
+ *                         Dowlink
+ *****************************************************************/
+
+void sched_freq_pf::sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+{
+  srsran::tti_point tti_rx{tti_sched->get_tti_rx()};
+  if (current_tti_rx != tti_rx) {
+    new_tti(ue_db, tti_sched);
+  }
+
+  // Retxs keep their number of RBGs, so they are allocated first
+  for (ue_ctxt* ue : dl_ues) {
+    if (ue->dl_retx_h == nullptr) {
+      continue;
+    }
+    alloc_result code = try_dl_retx_alloc(*tti_sched, *ue_db[ue->rnti], *ue->dl_retx_h);
+    if (code == alloc_result::success) {
+      ue->alloc_bytes = ue->dl_retx_h->get_tbs(0) + ue->dl_retx_h->get_tbs(1);
+    }
+    if (code == alloc_result::success or code == alloc_result::no_cch_space) {
+      ue->dl_newtx_h = nullptr;
+    }
+  }
+
+  // Split the free subbands among the UEs with pending data
+  sb_candidates.clear();
+  for (ue_ctxt* ue : dl_ues) {
+    if (ue->dl_newtx_h != nullptr and ue->sb_capable) {
+      sb_candidates.push_back(ue);
+    }
+  }
+  assign_subbands(ue_db, tti_sched);
+
+  // Allocate the UEs that were assigned RBGs, and then the remaining UEs in the RBGs left free (e.g. due to lack of
+  // PDCCH space for some of the assigned UEs). Each UE gets a single attempt, and the attempts are bounded, as each
+  // one searches the CCE positions of the DCIs already allocated and the TBS of the mask
+  uint32_t nof_attempts = 0, nof_pdcch_failures = 0;
+  auto     try_alloc    = [&](ue_ctxt* ue) {
+    if (ue->dl_newtx_h == nullptr or nof_attempts >= max_newtx_attempts or nof_pdcch_failures >= max_pdcch_failures or
+        tti_sched->get_dl_mask().all()) {
+      return;
+    }
+    nof_attempts++;
+    nof_pdcch_failures += try_dl_newtx_alloc(*ue, *ue_db[ue->rnti], tti_sched) == alloc_result::no_cch_space ? 1 : 0;
+  };
+  for (ue_ctxt* ue : dl_ues) {
+    if (ue->sb_rbgmask.any()) {
+      try_alloc(ue);
+    }
+  }
+  for (ue_ctxt* ue : dl_ues) {
+    try_alloc(ue);
+    ue->save_dl_alloc(ue->alloc_bytes, 0.01);
+  }
+}
+
+void sched_freq_pf::assign_subbands(sched_ue_list& ue_db, sf_sched* tti_sched)
+{
+  const rbgmask_t& dl_mask = tti_sched->get_dl_mask();
+  if (sb_candidates.empty() or dl_mask.all()) {
+    return;
+  }
+
+  // Visit the subbands in decreasing order of their best PF metric, so that the UEs get the subbands where their
+  // channel is best before the other UEs fill their needs
+  std::array<float, max_nof_subbands> best_metric{};
+  for (uint32_t sb = 0; sb < nof_subbands; ++sb) {
+    sb_order[sb] = sb;
+    for (const ue_ctxt* ue : sb_candidates) {
+      best_metric[sb] = std::max(best_metric[sb], ue->sb_metric[sb]);
+    }
+  }
+  std::sort(sb_order.begin(), sb_order.begin() + nof_subbands, [&best_metric](uint32_t lhs, uint32_t rhs) {
+    return best_metric[lhs] > best_metric[rhs];
+  });
+
+  uint32_t nof_sb_ues = 0;
+  for (uint32_t i = 0; i < nof_subbands; ++i) {
+    uint32_t  sb       = sb_order[i];
+    rbgmask_t free_sb  = sb_rbgmasks[sb] & ~dl_mask;
+    uint32_t  nof_free = free_sb.count();
+    while (nof_free > 0) {
+      // UE with highest PF metric in the subband, among the ones that still need RBGs
+      size_t best_idx = 0;
+      for (size_t j = 1; j < sb_candidates.size(); ++j) {
+        if (sb_candidates[j]->sb_metric[sb] > sb_candidates[best_idx]->sb_metric[sb]) {
+          best_idx = j;
+        }
+      }
+      ue_ctxt& best = *sb_candidates[best_idx];
+      if (not best.req_rbgs_ok) {
+        // The pending data and grant size are costly to compute, and most UEs do not win any subband when there are
+        // many UEs
+        sched_ue& ue        = *ue_db[best.rnti];
+        uint32_t  req_bytes = ue.get_requested_dl_bytes(cc_cfg->enb_cc_idx).stop();
+        int       prb       = req_bytes == 0 ? 0
+                                             : get_required_prb_dl(*ue.find_ue_carrier(cc_cfg->enb_cc_idx),
+                                                       tti_sched->get_tti_tx_dl(),
+                                                       ue.get_dci_format(),
+                                                       req_bytes);
+        best.req_rbgs       = prb < 0 ? cc_cfg->nof_rbgs : cc_cfg->nof_prbs_to_rbgs(prb);
+        best.req_rbgs_ok    = true;
+      }
+      if (best.sb_rbgmask.none()) {
+        nof_sb_ues++;
+      }
+      for (uint32_t n = std::min(best.req_rbgs, nof_free); n > 0; --n) {
+        int rbg = free_sb.find_lowest(0, free_sb.size());
+        free_sb.reset(rbg);
+        best.sb_rbgmask.set(rbg);
+        best.req_rbgs--;
+        nof_free--;
+      }
+      if (best.req_rbgs == 0) {
+        sb_candidates[best_idx] = sb_candidates.back();
+        sb_candidates.pop_back();
+      }
+      if (nof_sb_ues == max_sb_ues and sb_candidates.size() > nof_sb_ues) {
+        // Each UE takes a DCI, so the other subbands are only shared by the UEs that already have RBGs
+        sb_candidates.erase(std::remove_if(sb_candidates.begin(),
+                                           sb_candidates.end(),
+                                           [](const ue_ctxt* ue) { return ue->sb_rbgmask.none(); }),
+                            sb_candidates.end());
+      }
+      if (sb_candidates.empty()) {
+        return;
+      }
+    }
+  }
+}
+
+alloc_result sched_freq_pf::try_dl_newtx_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* tti_sched)
+{
+  alloc_result code = alloc_result::no_sch_space;
+  rbgmask_t    alloc_mask;
+  if (ue_ctxt.sb_rbgmask.any()) {
+    // Search only in the assigned RBGs. The RBGs with lowest CQI are left out if not needed
+    srsran::interval<uint32_t> req_bytes   = ue.get_requested_dl_bytes(cc_cfg->enb_cc_idx);
+    rbgmask_t                  search_mask = tti_sched->get_dl_mask() | ~ue_ctxt.sb_rbgmask;
+    tbs_info                   tb;
+    if (find_optimal_sb_rbgmask(*ue.find_ue_carrier(cc_cfg->enb_cc_idx),
+                                tti_sched->get_tti_tx_dl(),
+                                search_mask,
+                                ue.get_dci_format(),
+                                req_bytes,
+                                tb,
+                                alloc_mask)) {
+      code = tti_sched->alloc_dl_user(&ue, alloc_mask, ue_ctxt.dl_newtx_h->get_id());
+    }
+  } else {
+    code = try_dl_newtx_alloc_greedy(*tti_sched, ue, *ue_ctxt.dl_newtx_h, &alloc_mask);
+  }
+
+  // The UE is not retried in the same TTI
+  ue_ctxt.dl_newtx_h = nullptr;
+  if (code == alloc_result::success) {
+    ue_ctxt.alloc_bytes = ue.get_expected_dl_bitrate(cc_cfg->enb_cc_idx, alloc_mask.count()) * tti_duration_ms / 8;
+  }
+  return code;
+}
+
+/*****************************************************************
+ *                         Uplink
+ *****************************************************************/
+
+void sched_freq_pf::sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+{
+  ul_sched.sched_ul_users(ue_db, tti_sched);
+}
+
+/*****************************************************************
+ *                          UE history
+ *****************************************************************/
+
+void sched_freq_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell,
+                                     uint32_t                   nof_subbands,
+                                     sched_ue&                  ue,
+                                     sf_sched*                  tti_sched)
+{
+  dl_retx_h   = nullptr;
+  dl_newtx_h  = nullptr;
+  dl_prio     = 0;
+  alloc_bytes = 0;
+  sb_capable  = false;
+  req_rbgs    = 0;
+  req_rbgs_ok = false;
+  sb_rbgmask.resize(cell.nof_rbgs);
+  sb_rbgmask.reset();
+  if (ue.enb_to_ue_cc_idx(cell.enb_cc_idx) < 0) {
+    // not active
+    return;
+  }
+
+  dl_retx_h  = get_dl_retx_harq(ue, tti_sched);
+  dl_newtx_h = get_dl_newtx_harq(ue, tti_sched);
+  if (dl_retx_h == nullptr and dl_newtx_h == nullptr) {
+    return;
+  }
+
+  // Wideband PF priority, used to order the retxs and the grant allocations
+  float r = ue.get_expected_dl_bitrate(cell.enb_cc_idx) / 8;
+  float R = dl_avg_rate();
+  dl_prio = (R != 0) ? r / pow(R, fairness_coeff) : (r == 0 ? 0 : std::numeric_limits<float>::max());
+
+  if (dl_newtx_h == nullptr or ue.get_dci_format() == SRSRAN_DCI_FORMAT1A) {
+    // DCI format 1A only supports contiguous allocations, so the UE is not assigned subbands
+    return;
+  }
+  sb_capable = true;
+
+  // Subband PF metric. The avg rate of UEs that were not served yet is taken as 1 byte, so that they get priority
+  const sched_dl_cqi& dl_cqi = ue.find_ue_carrier(cell.enb_cc_idx)->dl_cqi();
+  float               weight = 1.0F / pow(std::max(R, 1.0F), fairness_coeff);
+  for (uint32_t sb = 0; sb < nof_subbands; ++sb) {
+    sb_metric[sb] = srsran_cqi_to_coderate(dl_cqi.get_subband_cqi(sb), ue.get_ue_cfg().use_tbs_index_alt) * weight;
+  }
+}
+
+void sched_freq_pf::ue_ctxt::save_dl_alloc(uint32_t alloc_bytes_, float exp_avg_alpha)
+{
+  if (dl_nof_samples < 1 / exp_avg_alpha) {
+    // fast start
+    dl_avg_rate_ = dl_avg_rate_ + (alloc_bytes_ - dl_avg_rate_) / (dl_nof_samples + 1);
+  } else {
+    dl_avg_rate_ = (1 - exp_avg_alpha) * dl_avg_rate_ + (exp_avg_alpha)*alloc_bytes_;
+  }
+  dl_nof_samples++;
+}
+
+} // namespace srsenb
@@ -26,7 +26,10 @@ namespace srsenb {
 
 using srsran::tti_point;
 
-sched_time_pf::sched_time_pf(const sched_cell_params_t& cell_params_, const sched_interface::sched_args_t& sched_args)
+sched_time_pf::sched_time_pf(const sched_cell_params_t&          cell_params_,
+                             const sched_interface::sched_args_t& sched_args,
+                             bool                                 dl_enabled_) :
+  dl_enabled(dl_enabled_)
 {
   cc_cfg = &cell_params_;
   if (not sched_args.sched_policy_args.empty()) {
@@ -65,7 +68,7 @@ void sched_time_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
     if (it == ue_history_db.end()) {
       it = ue_history_db.insert(u.first, ue_ctxt{u.first, fairness_coeff}).value();
     }
-    it->second.new_tti(*cc_cfg, *u.second, tti_sched);
+    it->second.new_tti(*cc_cfg, *u.second, tti_sched, dl_enabled);
     if (it->second.dl_newtx_h != nullptr or it->second.dl_retx_h != nullptr) {
       dl_queue.push(&it->second);
     }
@@ -178,7 +181,10 @@ uint32_t sched_time_pf::try_ul_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* t
  *                          UE history
  *****************************************************************/
 
-void sched_time_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell, sched_ue& ue, sf_sched* tti_sched)
+void sched_time_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell,
+                                     sched_ue&                  ue,
+                                     sf_sched*                  tti_sched,
+                                     bool                       dl_enabled)
 {
   dl_retx_h  = nullptr;
   dl_newtx_h = nullptr;
@@ -191,8 +197,10 @@ void sched_time_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell, sched_ue&
   }
 
   // Calculate DL priority
-  dl_retx_h  = get_dl_retx_harq(ue, tti_sched);
-  dl_newtx_h = get_dl_newtx_harq(ue, tti_sched);
+  if (dl_enabled) {
+    dl_retx_h  = get_dl_retx_harq(ue, tti_sched);
+    dl_newtx_h = get_dl_newtx_harq(ue, tti_sched);
+  }
   if (dl_retx_h != nullptr or dl_newtx_h != nullptr) {
     // calculate DL PF priority
     float r = ue.get_expected_dl_bitrate(cell.enb_cc_idx) / 8;
@@ -46,6 +46,16 @@ ue_cc_softbuffers::ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc
   for (auto& buffer : softbuffer_tx_list) {
     srsran_softbuffer_tx_init(&buffer, nof_prb);
   }
+
+  // Create Tx payload buffers
+  tx_payload_list.resize(nof_tx_harq_proc * SRSRAN_MAX_TB);
+  for (srsran::unique_byte_buffer_t& buffer : tx_payload_list) {
+    buffer = srsran::make_byte_buffer();
+    if (buffer == nullptr) {
+      srslog::fetch_basic_logger("MAC").error("Failed to allocate HARQ buffers for UE");
+      return;
+    }
+  }
 }
 
 ue_cc_softbuffers::~ue_cc_softbuffers()
@@ -141,19 +151,6 @@ bool cc_used_buffers_map::has_tti(tti_point tti) const
 
 ////////////////
 
-cc_buffer_handler::cc_buffer_handler()
-{
-  for (auto& harq_buffers : tx_payload_buffer) {
-    for (srsran::unique_byte_buffer_t& tb_buffer : harq_buffers) {
-      tb_buffer = srsran::make_byte_buffer();
-      if (tb_buffer == nullptr) {
-        srslog::fetch_basic_logger("MAC").error("Failed to allocate HARQ buffers for UE");
-        return;
-      }
-    }
-  }
-}
-
 cc_buffer_handler::~cc_buffer_handler()
 {
   deallocate_cc();
@@ -552,9 +549,13 @@ uint8_t* ue::generate_pdu(uint32_t                              enb_cc_idx,
                           uint32_t                              grant_size)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  uint8_t*                    ret = nullptr;
-  if (enb_cc_idx < SRSRAN_MAX_CARRIERS && harq_pid < SRSRAN_FDD_NOF_HARQ && tb_idx < SRSRAN_MAX_TB) {
-    srsran::byte_buffer_t* buffer = cc_buffers[enb_cc_idx].get_tx_payload_buffer(harq_pid, tb_idx);
+  uint8_t*                    ret    = nullptr;
+  srsran::byte_buffer_t*      buffer = nullptr;
+  if (enb_cc_idx < cc_buffers.size() and not cc_buffers[enb_cc_idx].empty() and harq_pid < SRSRAN_FDD_NOF_HARQ and
+      tb_idx < SRSRAN_MAX_TB) {
+    buffer = cc_buffers[enb_cc_idx].get_tx_payload_buffer(harq_pid, tb_idx);
+  }
+  if (buffer != nullptr) {
     buffer->clear();
     mac_msg_dl.init_tx(buffer, grant_size, false);
     for (uint32_t i = 0; i < nof_pdu_elems; i++) {
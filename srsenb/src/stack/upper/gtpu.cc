@@ -427,10 +427,21 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
   }
 
   // Assign a handler to rx S1U packets
-  auto rx_callback = [this](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
-    handle_gtpu_s1u_rx_packet(std::move(pdu), from);
-  };
-  rx_socket_handler->add_socket_handler(fd, srsran::make_sdu_handler(logger, gtpu_queue, rx_callback));
+  if (args.s1u_batch_size > 1) {
+    tx_batch.reserve(args.s1u_batch_size);
+    tx_iovs.resize(args.s1u_batch_size);
+    tx_msgs.resize(args.s1u_batch_size);
+    auto rx_callback = [this](srsran::rx_sdu_batch_t& batch) { handle_gtpu_s1u_rx_batch(batch); };
+    rx_socket_handler->add_socket_handler(
+        fd, srsran::make_batch_sdu_handler(logger, gtpu_queue, rx_callback, args.s1u_batch_size));
+  } else {
+    auto rx_callback = [this](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+      metrics.nof_rx_batches++;
+      metrics.nof_rx_pdus++;
+      handle_gtpu_s1u_rx_packet(std::move(pdu), from);
+    };
+    rx_socket_handler->add_socket_handler(fd, srsran::make_sdu_handler(logger, gtpu_queue, rx_callback));
+  }
 
   // Start MCH socket if enabled
   if (args.embms_enable) {
@@ -444,11 +455,23 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
 void gtpu::stop()
 {
   if (fd > 0) {
+    flush_tx_batch();
     close(fd);
     fd = -1;
   }
 }
 
+void gtpu::tti_clock()
+{
+  flush_tx_batch();
+}
+
+void gtpu::get_metrics(gtpu_metrics_t& m)
+{
+  m       = metrics;
+  metrics = {};
+}
+
 // gtpu_interface_pdcp
 void gtpu::write_pdu(uint16_t rnti, uint32_t eps_bearer_id, srsran::unique_byte_buffer_t pdu)
 {
@@ -496,9 +519,56 @@ void gtpu::send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buf
     logger.error("Error writing GTP-U Header. Flags 0x%x, Message Type 0x%x", header.flags, header.message_type);
     return;
   }
-  if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) < 0) {
-    perror("sendto");
+  send_s1u_data_pdu(servaddr, std::move(pdu));
+}
+
+void gtpu::send_s1u_data_pdu(const sockaddr_in& addr, srsran::unique_byte_buffer_t pdu)
+{
+  if (args.s1u_batch_size <= 1) {
+    if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&addr, sizeof(struct sockaddr_in)) < 0) {
+      perror("sendto");
+      return;
+    }
+    metrics.nof_tx_batches++;
+    metrics.nof_tx_pdus++;
+    return;
   }
+
+  // Batched mode. The PDU is sent when the batch gets full or in the next TTI, whatever happens first
+  tx_batch.emplace_back(std::move(pdu), addr);
+  if (tx_batch.size() >= args.s1u_batch_size) {
+    flush_tx_batch();
+  }
+}
+
+void gtpu::flush_tx_batch()
+{
+  if (tx_batch.empty()) {
+    return;
+  }
+  for (uint32_t i = 0; i < tx_batch.size(); ++i) {
+    tx_iovs[i].iov_base            = tx_batch[i].first->msg;
+    tx_iovs[i].iov_len             = tx_batch[i].first->N_bytes;
+    tx_msgs[i]                     = {};
+    tx_msgs[i].msg_hdr.msg_name    = &tx_batch[i].second;
+    tx_msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    tx_msgs[i].msg_hdr.msg_iov     = &tx_iovs[i];
+    tx_msgs[i].msg_hdr.msg_iovlen  = 1;
+  }
+
+  // sendmmsg may return before the whole batch is sent
+  uint32_t nof_sent = 0;
+  while (nof_sent < tx_batch.size()) {
+    int n = sendmmsg(fd, &tx_msgs[nof_sent], tx_batch.size() - nof_sent, 0);
+    if (n < 0) {
+      logger.error("Failed to send %zu GTPU PDUs: %s", tx_batch.size() - nof_sent, strerror(errno));
+      break;
+    }
+    nof_sent += n;
+    metrics.nof_tx_batches++;
+  }
+  metrics.nof_tx_pdus += nof_sent;
+  tx_batch.clear();
 }
 
 srsran::expected<uint32_t> gtpu::add_bearer(uint16_t            rnti,
@@ -626,6 +696,15 @@ void gtpu::handle_end_marker(const gtpu_tunnel& rx_tunnel)
   rem_tunnel(rx_tunnel.teid_in);
 }
 
+void gtpu::handle_gtpu_s1u_rx_batch(srsran::rx_sdu_batch_t& batch)
+{
+  metrics.nof_rx_batches++;
+  metrics.nof_rx_pdus += batch.size();
+  for (auto& rx_pdu : batch) {
+    handle_gtpu_s1u_rx_packet(std::move(rx_pdu.first), rx_pdu.second);
+  }
+}
+
 void gtpu::handle_gtpu_s1u_rx_packet(srsran::unique_byte_buffer_t pdu, const sockaddr_in& addr)
 {
   srsran_assert(pdu != nullptr, "Called with null PDU");
@@ -754,7 +833,7 @@ void gtpu::error_indication(in_addr_t addr, in_port_t port, uint32_t err_teid)
   logger.info("TX GTPU Error Indication. Seq: %d, Error TEID: %d", tx_seq, err_teid);
 
   gtpu_header_t        header = {};
-  unique_byte_buffer_t pdu    = make_byte_buffer();
+  unique_byte_buffer_t pdu    = make_sized_byte_buffer(GTPU_EXTENDED_HEADER_LEN);
   if (pdu == nullptr) {
     logger.error("Could not allocate byte buffer for error indication");
     return;
@@ -788,7 +867,7 @@ void gtpu::echo_response(in_addr_t addr, in_port_t port, uint16_t seq)
   logger.info("TX GTPU Echo Response, Seq: %d", seq);
 
   gtpu_header_t        header = {};
-  unique_byte_buffer_t pdu    = make_byte_buffer();
+  unique_byte_buffer_t pdu    = make_sized_byte_buffer(GTPU_EXTENDED_HEADER_LEN);
   if (pdu == nullptr) {
     logger.error("Could not allocate byte buffer for echo response");
     return;
@@ -826,7 +905,7 @@ bool gtpu::send_end_marker(uint32_t teidin)
   logger.info("Tx GTPU End Marker, " TEID_IN_FMT ", rnti=0x%x", teidin, tx_tun->rnti);
 
   gtpu_header_t        header = {};
-  unique_byte_buffer_t pdu    = make_byte_buffer();
+  unique_byte_buffer_t pdu    = make_sized_byte_buffer(GTPU_EXTENDED_HEADER_LEN);
   if (pdu == nullptr) {
     logger.warning("Failed to allocate buffer to send End Marker to TEID=%d", teidin);
     return false;
@@ -845,6 +924,8 @@ bool gtpu::send_end_marker(uint32_t teidin)
   servaddr.sin_addr.s_addr    = htonl(tx_tun->spgw_addr);
   servaddr.sin_port           = htons(GTPU_PORT);
 
+  // The End Marker must not overtake any data PDU still pending in the Tx batch
+  flush_tx_batch();
   bool success =
       sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) > 0;
   if (success) {
@@ -24,6 +24,7 @@
 #include "srsran/adt/accumulators.h"
 #include "srsran/common/common_lte.h"
 #include <chrono>
+#include <thread>
 
 namespace srsenb {
 
@@ -33,6 +34,13 @@ struct run_params {
   uint32_t    nof_ttis;
   uint32_t    cqi;
   const char* sched_policy;
+  uint32_t    nof_cells            = 1;
+  uint32_t    nof_cc_workers       = 0;
+  bool        async_feedback       = false;
+  uint32_t    nof_feedback_threads = 0; ///< Threads that report CQIs concurrently with the TTI, as PHY workers do
+  bool        subband_cqi          = false; ///< UEs report subband CQIs that vary across the bandwidth
+  bool        fast_pdcch_alloc     = false;
+  bool        carrier_aggregation  = false; ///< UEs are configured with all cells, with their PCells spread across cells
 };
 
 struct run_params_range {
@@ -40,7 +48,7 @@ struct run_params_range {
   std::vector<uint32_t>    nof_ues      = {1, 2, 5, 32};
   uint32_t                 nof_ttis     = 10000;
   std::vector<uint32_t>    cqi          = {5, 10, 15};
-  std::vector<const char*> sched_policy = {"time_rr", "time_pf"};
+  std::vector<const char*> sched_policy = {"time_rr", "time_pf", "freq_pf"};
 
   size_t     nof_runs() const { return nof_prbs.size() * nof_ues.size() * cqi.size() * sched_policy.size(); }
   run_params get_params(size_t idx) const
@@ -90,8 +98,8 @@ public:
 
   struct throughput_stats {
     srsran::rolling_average<float>  mean_dl_tbs, mean_ul_tbs, avg_dl_mcs, avg_ul_mcs;
-    srsran::rolling_average<double> avg_latency;
-    std::vector<uint32_t>           latency_samples;
+    srsran::rolling_average<double> avg_latency, avg_tti_latency;
+    std::vector<uint32_t>           latency_samples, tti_latency_samples;
   };
   throughput_stats total_stats;
 
@@ -101,6 +109,7 @@ public:
     mac_logger.set_context(tti_rx.to_uint());
     new_tti(tti_rx);
 
+    std::chrono::time_point<std::chrono::steady_clock> tti_tp = std::chrono::steady_clock::now();
     for (uint32_t cc = 0; cc < get_cell_params().size(); ++cc) {
       std::chrono::time_point<std::chrono::steady_clock> tp = std::chrono::steady_clock::now();
       TESTASSERT(sched_ptr->dl_sched(to_tx_dl(tti_rx).to_uint(), cc, dl_result[cc]) == SRSRAN_SUCCESS);
@@ -110,6 +119,10 @@ public:
       total_stats.avg_latency.push(tdur.count());
       total_stats.latency_samples.push_back(tdur.count());
     }
+    std::chrono::nanoseconds tti_dur =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tti_tp);
+    total_stats.avg_tti_latency.push(tti_dur.count());
+    total_stats.tti_latency_samples.push_back(tti_dur.count());
 
     sf_output_res_t sf_out{get_cell_params(), tti_rx, ul_result, dl_result};
     update(sf_out);
@@ -130,6 +143,21 @@ public:
           cc.dl_cqi = current_run_params.cqi;
           cc.ul_snr = 40;
         }
+        if (current_run_params.subband_cqi) {
+          set_subband_cqis(ue_ctxt);
+        }
+      }
+    }
+  }
+
+  /// Each UE sees a different CQI in each subband, up to 6 CQI steps below the wideband CQI
+  void set_subband_cqis(const sim_ue_ctxt_t& ue_ctxt)
+  {
+    uint32_t nof_subbands = srsran_cqi_hl_get_no_subbands(current_run_params.nof_prbs);
+    for (const auto& cc : ue_ctxt.ue_cfg.supported_cc_list) {
+      for (uint32_t sb = 0; sb < nof_subbands; ++sb) {
+        int cqi = static_cast<int>(current_run_params.cqi) - 2 * static_cast<int>((ue_ctxt.rnti * 7 + sb * 3) % 4);
+        sched_ptr->dl_sb_cqi_info(get_tti_rx().to_uint(), ue_ctxt.rnti, cc.enb_cc_idx, sb, std::max(cqi, 1));
       }
     }
   }
@@ -167,14 +195,40 @@ struct run_data {
   float                     avg_ul_mcs;
   std::chrono::microseconds avg_latency;
   std::chrono::microseconds q0_9_latency;
+  std::chrono::microseconds avg_tti_latency;
+  std::chrono::microseconds q0_9_tti_latency;
+  std::chrono::microseconds max_tti_latency;
+  std::chrono::microseconds max_feedback_latency;
+  mac_sched_lock_metrics_t  lock_metrics;
 };
 
 int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results)
 {
-  std::vector<sched_interface::cell_cfg_t> cell_list(1, generate_default_cell_cfg(params.nof_prbs));
-  sched_interface::ue_cfg_t                ue_cfg_default = generate_default_ue_cfg();
-  sched_interface::sched_args_t            sched_args     = {};
-  sched_args.sched_policy                                 = params.sched_policy;
+  std::vector<sched_interface::cell_cfg_t> cell_list(params.nof_cells, generate_default_cell_cfg(params.nof_prbs));
+  for (uint32_t cc = 0; cc < cell_list.size(); ++cc) {
+    cell_list[cc].cell.id = cc;
+    if (params.carrier_aggregation) {
+      for (uint32_t scell = 0; scell < cell_list.size(); ++scell) {
+        if (scell != cc) {
+          sched_interface::cell_cfg_t::scell_cfg_t scell_cfg = {};
+          scell_cfg.enb_cc_idx                               = scell;
+          scell_cfg.cross_carrier_scheduling                 = false;
+          scell_cfg.ul_allowed                               = true;
+          cell_list[cc].scell_list.push_back(scell_cfg);
+        }
+      }
+    }
+  }
+  sched_interface::ue_cfg_t     ue_cfg_default = generate_default_ue_cfg();
+  sched_interface::sched_args_t sched_args     = {};
+  sched_args.sched_policy                      = params.sched_policy;
+  sched_args.nof_cc_workers                    = params.nof_cc_workers;
+  sched_args.async_feedback                    = params.async_feedback;
+  sched_args.fast_pdcch_alloc                  = params.fast_pdcch_alloc;
+  if (params.subband_cqi) {
+    ue_cfg_default.supported_cc_list[0].dl_cfg.cqi_report.subband_wideband_ratio = 4;
+    ue_cfg_default.supported_cc_list[0].dl_cfg.cqi_report.periodic_configured    = true;
+  }
 
   sched     sched_obj;
   rrc_dummy rrc{};
@@ -186,6 +240,17 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
 
   for (uint32_t ue_idx = 0; ue_idx < params.nof_ues; ++ue_idx) {
     uint16_t rnti = 0x46 + ue_idx;
+    // Spread the UEs across the cells
+    ue_cfg_default.supported_cc_list[0].enb_cc_idx = ue_idx % params.nof_cells;
+    if (params.carrier_aggregation) {
+      // The SCells are activated once the UE is configured with them after Msg4. CA requires a CQI configuration in
+      // every carrier
+      ue_cfg_default.supported_cc_list[0].dl_cfg.cqi_report.aperiodic_configured = true;
+      ue_cfg_default.supported_cc_list.resize(params.nof_cells, ue_cfg_default.supported_cc_list[0]);
+      for (uint32_t i = 1; i < params.nof_cells; ++i) {
+        ue_cfg_default.supported_cc_list[i].enb_cc_idx = (ue_idx + i) % params.nof_cells;
+      }
+    }
     // Add user (first need to advance to a PRACH TTI)
     while (not srsran_prach_tti_opportunity_config_fdd(
         tester.get_cell_params()[ue_cfg_default.supported_cc_list[0].enb_cc_idx].cfg.prach_config,
@@ -206,13 +271,51 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
     ue_db_ctxt = tester.get_enb_ctxt().ue_db;
   }
 
+  if (params.subband_cqi) {
+    // Allow DCI formats with distributed RBGs, so that the UEs can be scheduled in their best subbands
+    for (uint32_t ue_idx = 0; ue_idx < params.nof_ues; ++ue_idx) {
+      sched_obj.phy_config_enabled(0x46 + ue_idx, true);
+    }
+  }
+
+  // Launch the threads that report CQIs while the TTIs are being scheduled
+  std::atomic<bool>        running{true};
+  std::atomic<uint32_t>    feedback_tti{tester.get_tti_rx().to_uint()};
+  std::atomic<uint64_t>    max_feedback_ns{0};
+  std::vector<std::thread> feedback_threads;
+  for (uint32_t i = 0; i < params.nof_feedback_threads; ++i) {
+    feedback_threads.emplace_back([&, i]() {
+      while (running.load(std::memory_order_relaxed)) {
+        for (uint32_t ue_idx = i; ue_idx < params.nof_ues; ue_idx += params.nof_feedback_threads) {
+          auto tp = std::chrono::steady_clock::now();
+          sched_obj.dl_cqi_info(feedback_tti.load(), 0x46 + ue_idx, ue_idx % params.nof_cells, params.cqi);
+          uint64_t dur = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp)
+                             .count();
+          uint64_t prev_max = max_feedback_ns.load(std::memory_order_relaxed);
+          while (dur > prev_max and not max_feedback_ns.compare_exchange_weak(prev_max, dur)) {
+          }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+  }
+  mac_sched_lock_metrics_t lock_metrics = {};
+  sched_obj.lock_metrics_read(lock_metrics);
+
   // Run benchmark
   tester.total_stats = {};
-  tester.total_stats.latency_samples.reserve(params.nof_ttis);
+  tester.total_stats.latency_samples.reserve(params.nof_ttis * params.nof_cells);
+  tester.total_stats.tti_latency_samples.reserve(params.nof_ttis);
   for (uint32_t count = 0; count < params.nof_ttis; ++count) {
     tester.advance_tti();
+    feedback_tti = tester.get_tti_rx().to_uint();
+  }
+  running = false;
+  for (std::thread& t : feedback_threads) {
+    t.join();
   }
   std::sort(tester.total_stats.latency_samples.begin(), tester.total_stats.latency_samples.end());
+  std::sort(tester.total_stats.tti_latency_samples.begin(), tester.total_stats.tti_latency_samples.end());
 
   run_data run_result          = {};
   run_result.params            = params;
@@ -223,6 +326,15 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
   run_result.avg_latency  = std::chrono::microseconds(static_cast<int>(tester.total_stats.avg_latency.value() / 1000));
   run_result.q0_9_latency = std::chrono::microseconds(
       tester.total_stats.latency_samples[static_cast<size_t>(tester.total_stats.latency_samples.size() * 0.9)] / 1000);
+  run_result.avg_tti_latency =
+      std::chrono::microseconds(static_cast<int>(tester.total_stats.avg_tti_latency.value() / 1000));
+  run_result.q0_9_tti_latency = std::chrono::microseconds(
+      tester.total_stats
+          .tti_latency_samples[static_cast<size_t>(tester.total_stats.tti_latency_samples.size() * 0.9)] /
+      1000);
+  run_result.max_tti_latency      = std::chrono::microseconds(tester.total_stats.tti_latency_samples.back() / 1000);
+  run_result.max_feedback_latency = std::chrono::microseconds(max_feedback_ns.load() / 1000);
+  sched_obj.lock_metrics_read(run_result.lock_metrics);
   run_results.push_back(run_result);
 
   return SRSRAN_SUCCESS;
@@ -394,6 +506,209 @@ int run_benchmark()
   return SRSRAN_SUCCESS;
 }
 
+/// Measures how the TTI scheduling time scales with the number of cells, when the cells are scheduled serially and when
+/// they are scheduled in parallel by the carrier workers. Each UE is only configured in one cell
+int run_cc_scaling_benchmark(uint32_t nof_ttis)
+{
+  fmt::print("\n====== Scheduler Carrier Scaling Benchmark ======\n\n");
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  run_params params   = {};
+  params.nof_prbs     = 100;
+  params.nof_ttis     = nof_ttis;
+  params.cqi          = 15;
+  params.sched_policy = "time_pf";
+
+  std::vector<run_data> run_results;
+  for (uint32_t nof_cells : {2, 4}) {
+    params.nof_cells = nof_cells;
+    params.nof_ues   = 8 * nof_cells;
+    for (uint32_t nof_workers : {0u, nof_cells - 1}) {
+      params.nof_cc_workers = nof_workers;
+      mac_logger.info("\n### New run: nof_cells=%d, nof_cc_workers=%d ###\n", nof_cells, nof_workers);
+      TESTASSERT(run_benchmark_scenario(params, run_results) == SRSRAN_SUCCESS);
+    }
+  }
+
+  srslog::flush();
+  fmt::print("Ncell | Nue | workers | DL/UL [Mbps] | TTI latency [usec] | TTI latency q0.9 [usec] | speedup\n");
+  fmt::print("--------------------------------------------------------------------------------------------\n");
+  for (uint32_t i = 0; i < run_results.size(); i += 2) {
+    const run_data& serial   = run_results[i];
+    const run_data& parallel = run_results[i + 1];
+
+    // Cells that do not share UEs must get the same decisions, regardless of whether they are scheduled in parallel
+    TESTASSERT(serial.avg_dl_throughput == parallel.avg_dl_throughput);
+    TESTASSERT(serial.avg_ul_throughput == parallel.avg_ul_throughput);
+
+    for (const run_data* r : {&serial, &parallel}) {
+      fmt::print("{:>5d}{:>6d}{:>10d}{:>9.2}/{:>4.2}{:>21d}{:>26d}{:>10.2f}\n",
+                 r->params.nof_cells,
+                 r->params.nof_ues,
+                 r->params.nof_cc_workers,
+                 r->avg_dl_throughput / 1e6,
+                 r->avg_ul_throughput / 1e6,
+                 r->avg_tti_latency.count(),
+                 r->q0_9_tti_latency.count(),
+                 serial.avg_tti_latency.count() / std::max(1.0, (double)r->avg_tti_latency.count()));
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Measures the TTI scheduling time and rates with UEs that aggregate two carriers. A CA UE links its carriers, so
+/// they are scheduled in one group even when there are carrier workers
+int run_ca_benchmark(uint32_t nof_ttis)
+{
+  fmt::print("\n====== Scheduler Carrier Aggregation Benchmark ======\n\n");
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  run_params params   = {};
+  params.nof_prbs     = 100;
+  params.nof_ttis     = nof_ttis;
+  params.cqi          = 15;
+  params.sched_policy = "time_pf";
+  params.nof_cells    = 2;
+
+  std::vector<run_data> run_results;
+  for (uint32_t nof_ues : {1, 16}) {
+    params.nof_ues = nof_ues;
+    for (bool ca : {false, true}) {
+      params.carrier_aggregation = ca;
+      for (uint32_t nof_workers : {0, 1}) {
+        params.nof_cc_workers = nof_workers;
+        mac_logger.info("\n### New run: nof_ues=%d, ca=%d, nof_cc_workers=%d ###\n", nof_ues, ca, nof_workers);
+        TESTASSERT(run_benchmark_scenario(params, run_results) == SRSRAN_SUCCESS);
+      }
+    }
+  }
+
+  srslog::flush();
+  fmt::print("Nue | CA | workers | DL/UL [Mbps] | TTI latency [usec] | TTI latency q0.9 [usec] | max [usec]\n");
+  fmt::print("-----------------------------------------------------------------------------------------\n");
+  for (const run_data& r : run_results) {
+    fmt::print("{:>3d}{:>5}{:>10d}{:>9.2}/{:>4.2}{:>21d}{:>26d}{:>13d}\n",
+               r.params.nof_ues,
+               r.params.carrier_aggregation ? "yes" : "no",
+               r.params.nof_cc_workers,
+               r.avg_dl_throughput / 1e6,
+               r.avg_ul_throughput / 1e6,
+               r.avg_tti_latency.count(),
+               r.q0_9_tti_latency.count(),
+               r.max_tti_latency.count());
+  }
+
+  for (uint32_t i = 0; i < run_results.size(); i += 2) {
+    // The carrier workers must not change the decisions, whether or not the carriers are linked by CA UEs
+    TESTASSERT(run_results[i].avg_dl_throughput == run_results[i + 1].avg_dl_throughput);
+    TESTASSERT(run_results[i].avg_ul_throughput == run_results[i + 1].avg_ul_throughput);
+  }
+  // A single UE only gets the rate of both cells when it aggregates them
+  TESTASSERT(run_results[2].avg_dl_throughput > 1.5 * run_results[0].avg_dl_throughput);
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Measures how long the threads that report UE feedback are blocked by the TTI scheduling, when the feedback takes
+/// the scheduler lock and when it is pushed to the async feedback queues
+int run_feedback_contention_benchmark(uint32_t nof_ttis)
+{
+  fmt::print("\n====== Scheduler Feedback Contention Benchmark ======\n\n");
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  run_params params           = {};
+  params.nof_prbs             = 100;
+  params.nof_ues              = 32;
+  params.nof_ttis             = nof_ttis;
+  params.cqi                  = 15;
+  params.sched_policy         = "time_pf";
+  params.nof_feedback_threads = 2;
+
+  std::vector<run_data> run_results;
+  for (bool async_feedback : {false, true}) {
+    params.async_feedback = async_feedback;
+    mac_logger.info("\n### New run: async_feedback=%s ###\n", async_feedback ? "true" : "false");
+    TESTASSERT(run_benchmark_scenario(params, run_results) == SRSRAN_SUCCESS);
+  }
+
+  srslog::flush();
+  fmt::print("async | TTI latency [usec] | feedback max latency [usec] | locks | contended | lock wait [usec] | queued\n");
+  fmt::print("-------------------------------------------------------------------------------------------------------\n");
+  for (const run_data& r : run_results) {
+    fmt::print("{:>5}{:>21d}{:>30d}{:>8d}{:>12d}{:>19d}{:>9d}\n",
+               r.params.async_feedback ? "yes" : "no",
+               r.avg_tti_latency.count(),
+               r.max_feedback_latency.count(),
+               r.lock_metrics.nof_locks,
+               r.lock_metrics.nof_contended,
+               r.lock_metrics.wait_time_us,
+               r.lock_metrics.nof_queued_events);
+  }
+
+  // With async feedback, the feedback threads only take the lock when their queue is full
+  const run_data& async_run = run_results.back();
+  TESTASSERT(async_run.lock_metrics.nof_queued_events > 0);
+  TESTASSERT(async_run.lock_metrics.nof_contended == 0 or async_run.lock_metrics.nof_queue_full > 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Measures the TTI scheduling time and DL rate of the frequency-domain PF policy with many UEs that report
+/// frequency-selective subband CQIs, against the time-domain PF policy
+int run_freq_pf_benchmark(uint32_t nof_ttis)
+{
+  fmt::print("\n====== Scheduler Frequency-domain PF Benchmark ======\n\n");
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  run_params params  = {};
+  params.nof_prbs    = 100;
+  params.nof_ues     = 64;
+  params.nof_ttis    = nof_ttis;
+  params.cqi         = 15;
+  params.subband_cqi = true;
+
+  std::vector<run_data> run_results;
+  for (bool fast_pdcch_alloc : {false, true}) {
+    for (const char* policy : {"time_pf", "freq_pf"}) {
+      params.sched_policy     = policy;
+      params.fast_pdcch_alloc = fast_pdcch_alloc;
+      mac_logger.info("\n### New run: sched_policy=%s, fast_pdcch_alloc=%d ###\n", policy, fast_pdcch_alloc);
+      TESTASSERT(run_benchmark_scenario(params, run_results) == SRSRAN_SUCCESS);
+    }
+  }
+
+  srslog::flush();
+  fmt::print(
+      "sched pol | PDCCH | Nprb | Nue | DL/UL [Mbps] | DL mcs | TTI latency [usec] | q0.9 [usec] | max [usec]\n");
+  fmt::print("--------------------------------------------------------------------------------------------------\n");
+  for (const run_data& r : run_results) {
+    fmt::print("{:>9}{:>8}{:>7d}{:>6d}{:>9.2}/{:>4.2}{:>9.1f}{:>21d}{:>14d}{:>13d}\n",
+               r.params.sched_policy,
+               r.params.fast_pdcch_alloc ? "fast" : "dfs",
+               r.params.nof_prbs,
+               r.params.nof_ues,
+               r.avg_dl_throughput / 1e6,
+               r.avg_ul_throughput / 1e6,
+               r.avg_dl_mcs,
+               r.avg_tti_latency.count(),
+               r.q0_9_tti_latency.count(),
+               r.max_tti_latency.count());
+  }
+
+  for (uint32_t i = 0; i < run_results.size(); i += 2) {
+    const run_data& time_pf = run_results[i];
+    const run_data& freq_pf = run_results[i + 1];
+    // Picking the best subbands of each UE should not lower the DL MCS nor the DL rate
+    TESTASSERT(freq_pf.avg_dl_mcs >= time_pf.avg_dl_mcs);
+    TESTASSERT(freq_pf.avg_dl_throughput >= time_pf.avg_dl_throughput);
+    // The subband assignment and the bounded allocation attempts should keep the TTI latency in the order of time_pf
+    TESTASSERT(freq_pf.avg_tti_latency.count() <= 2 * time_pf.avg_tti_latency.count());
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 } // namespace srsenb
 
 int main(int argc, char* argv[])
@@ -422,8 +737,20 @@ int main(int argc, char* argv[])
 
   if (argc == 1 or strcmp(argv[1], "test") == 0) {
     TESTASSERT(srsenb::run_rate_test() == SRSRAN_SUCCESS);
+    TESTASSERT(srsenb::run_cc_scaling_benchmark(1000) == SRSRAN_SUCCESS);
+    TESTASSERT(srsenb::run_ca_benchmark(1000) == SRSRAN_SUCCESS);
+    TESTASSERT(srsenb::run_feedback_contention_benchmark(1000) == SRSRAN_SUCCESS);
+    TESTASSERT(srsenb::run_freq_pf_benchmark(1000) == SRSRAN_SUCCESS);
   } else if (strcmp(argv[1], "benchmark") == 0) {
     TESTASSERT(srsenb::run_benchmark() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "cc_scaling") == 0) {
+    TESTASSERT(srsenb::run_cc_scaling_benchmark(100000) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "ca") == 0) {
+    TESTASSERT(srsenb::run_ca_benchmark(100000) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "feedback") == 0) {
+    TESTASSERT(srsenb::run_feedback_contention_benchmark(100000) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "freq_pf") == 0) {
+    TESTASSERT(srsenb::run_freq_pf_benchmark(100000) == SRSRAN_SUCCESS);
   } else {
     TESTASSERT(srsenb::run_all() == SRSRAN_SUCCESS);
   }
@@ -251,6 +251,91 @@ int test_6prbs()
   return SRSRAN_SUCCESS;
 }
 
+int test_pdcch_fast_search()
+{
+  using rand_uint = std::uniform_int_distribution<uint32_t>;
+  // Params
+  uint32_t nof_prb = srsran::lte_cell_nof_prbs[rand_uint{0, 2}(get_rand_gen())];
+  uint32_t nof_ues = 8, nof_ttis = 100, max_allocs = 10;
+
+  std::vector<sched_cell_params_t> cell_params(1), fast_cell_params(1);
+  sched_interface::ue_cfg_t        ue_cfg   = generate_default_ue_cfg();
+  sched_interface::cell_cfg_t      cell_cfg = generate_default_cell_cfg(nof_prb);
+  sched_interface::sched_args_t    sched_args{}, fast_sched_args{};
+  fast_sched_args.fast_pdcch_alloc = true;
+  TESTASSERT(cell_params[0].set_cfg(0, cell_cfg, sched_args));
+  TESTASSERT(fast_cell_params[0].set_cfg(0, cell_cfg, fast_sched_args));
+
+  sf_cch_allocator       pdcch, fast_pdcch;
+  std::vector<sched_ue*> ues;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    ues.push_back(new sched_ue{(uint16_t)(0x46 + i), cell_params, ue_cfg});
+  }
+  pdcch.init(cell_params[0]);
+  fast_pdcch.init(fast_cell_params[0]);
+
+  // TEST: The fast search finds the same DCI positions and CFI as the exhaustive search, unless it gives up
+  uint32_t  nof_aborted = 0;
+  tti_point tti_rx{rand_uint{0, 10240}(get_rand_gen())};
+  for (uint32_t tti_count = 0; tti_count < nof_ttis; ++tti_count, ++tti_rx) {
+    pdcch.new_tti(tti_rx);
+    fast_pdcch.new_tti(tti_rx);
+    for (uint32_t i = 0; i < max_allocs; ++i) {
+      alloc_type_t alloc_type = alloc_type_t::DL_DATA;
+      uint32_t     aggr_idx   = rand_uint{0, 3}(get_rand_gen());
+      sched_ue*    user       = ues[rand_uint{0, nof_ues - 1}(get_rand_gen())];
+      float        r          = randf();
+      if (r < 0.05) {
+        alloc_type = alloc_type_t::DL_BC;
+        aggr_idx   = 2;
+        user       = nullptr;
+      } else if (r < 0.1) {
+        alloc_type = alloc_type_t::DL_RAR;
+        aggr_idx   = 2;
+        user       = nullptr;
+      } else if (r < 0.5) {
+        alloc_type = alloc_type_t::UL_DATA;
+      }
+      bool has_pusch_grant = randf() < 0.3;
+
+      bool success      = pdcch.alloc_dci(alloc_type, aggr_idx, user, has_pusch_grant);
+      bool fast_success = fast_pdcch.alloc_dci(alloc_type, aggr_idx, user, has_pusch_grant);
+      if (success != fast_success) {
+        TESTASSERT(success and not fast_success);
+        nof_aborted++;
+        break;
+      }
+      if (randf() < 0.1 and pdcch.nof_allocs() > 0) {
+        // TEST: Ability to revert last allocation
+        pdcch.rem_last_dci();
+        fast_pdcch.rem_last_dci();
+      }
+
+      sf_cch_allocator::alloc_result_t dci_result, fast_dci_result;
+      pdcch_mask_t                     pdcch_mask, fast_pdcch_mask;
+      pdcch.get_allocs(&dci_result, &pdcch_mask);
+      fast_pdcch.get_allocs(&fast_dci_result, &fast_pdcch_mask);
+      TESTASSERT(pdcch.get_cfi() == fast_pdcch.get_cfi());
+      TESTASSERT(dci_result.size() == fast_dci_result.size());
+      TESTASSERT(pdcch_mask == fast_pdcch_mask);
+      for (uint32_t j = 0; j < dci_result.size(); ++j) {
+        TESTASSERT(dci_result[j]->rnti == fast_dci_result[j]->rnti);
+        TESTASSERT(dci_result[j]->dci_pos.ncce == fast_dci_result[j]->dci_pos.ncce);
+        TESTASSERT(dci_result[j]->dci_pos.L == fast_dci_result[j]->dci_pos.L);
+        TESTASSERT(dci_result[j]->pucch_n_prb == fast_dci_result[j]->pucch_n_prb);
+        TESTASSERT(dci_result[j]->total_pucch_mask == fast_dci_result[j]->total_pucch_mask);
+      }
+    }
+  }
+  srslog::fetch_basic_logger("TEST").info(
+      "Fast PDCCH search gave up in %d out of %d TTIs with nof_prb=%d", nof_aborted, nof_ttis, nof_prb);
+
+  for (sched_ue* u : ues) {
+    delete u;
+  }
+  return SRSRAN_SUCCESS;
+}
+
 int main()
 {
   srsenb::set_randseed(seed);
@@ -265,6 +350,7 @@ int main()
   TESTASSERT(test_pdcch_one_ue() == SRSRAN_SUCCESS);
   TESTASSERT(test_pdcch_ue_and_sibs() == SRSRAN_SUCCESS);
   TESTASSERT(test_6prbs() == SRSRAN_SUCCESS);
+  TESTASSERT(test_pdcch_fast_search() == SRSRAN_SUCCESS);
 
   srslog::flush();
 
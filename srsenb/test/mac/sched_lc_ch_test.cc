@@ -197,6 +197,38 @@ int test_lc_ch_pbr_finite()
   return SRSRAN_SUCCESS;
 }
 
+/// Feedback that does not fit in the full async feedback queue must be applied after the feedback queued before it
+int test_async_feedback_queue_full()
+{
+  const uint16_t rnti = 0x46, ref_rnti = 0x47, flush_rnti = 0x48;
+  const uint32_t lcid = drb_to_lcid(lte_drb::drb1), nof_updates = 5000;
+
+  rrc_dummy                     rrc{};
+  sched                         sched_obj;
+  sched_interface::sched_args_t sched_args = {};
+  sched_args.async_feedback                = true;
+  sched_obj.init(&rrc, sched_args);
+  TESTASSERT(sched_obj.cell_cfg({generate_default_cell_cfg(25)}) == SRSRAN_SUCCESS);
+  for (uint16_t r : {rnti, ref_rnti, flush_rnti}) {
+    TESTASSERT(sched_obj.ue_cfg(r, generate_default_ue_cfg()) == SRSRAN_SUCCESS);
+  }
+
+  // The queue fills up and the last updates are applied right away
+  for (uint32_t i = 1; i <= nof_updates; ++i) {
+    TESTASSERT(sched_obj.dl_rlc_buffer_state(rnti, lcid, i, 0) == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(sched_obj.dl_rlc_buffer_state(ref_rnti, lcid, nof_updates, 0) == SRSRAN_SUCCESS);
+  mac_sched_lock_metrics_t metrics = {};
+  sched_obj.lock_metrics_read(metrics);
+  TESTASSERT(metrics.nof_queue_full > 0);
+
+  // Removing a UE applies the feedback that is still queued. The last update must prevail
+  TESTASSERT(sched_obj.ue_rem(flush_rnti) == SRSRAN_SUCCESS);
+  TESTASSERT(sched_obj.get_dl_buffer(rnti) == sched_obj.get_dl_buffer(ref_rnti));
+
+  return SRSRAN_SUCCESS;
+}
+
 int main()
 {
   srsenb::set_randseed(seed);
@@ -210,6 +242,7 @@ int main()
 
   TESTASSERT(test_lc_ch_pbr_infinity() == SRSRAN_SUCCESS);
   TESTASSERT(test_lc_ch_pbr_finite() == SRSRAN_SUCCESS);
+  TESTASSERT(test_async_feedback_queue_full() == SRSRAN_SUCCESS);
 
   srslog::flush();
 
@@ -0,0 +1,159 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "sched_test_common.h"
+#include "srsenb/hdr/stack/mac/sched_phy_ch/sf_cch_allocator.h"
+#include "srsenb/hdr/stack/mac/sched_ue.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <numeric>
+
+namespace srsenb {
+
+struct run_params {
+  uint32_t nof_prb;
+  uint32_t nof_ues;
+  bool     fast_pdcch_alloc;
+};
+
+struct run_result {
+  float  avg_dcis;    ///< DCIs allocated per TTI
+  double avg_usec;    ///< PDCCH allocation time per TTI
+  double q99_usec;
+  double max_usec;
+};
+
+/// Tries to allocate a DL and an UL DCI for every UE in each TTI, after the SIB and RAR DCIs, and measures the time
+/// spent in the PDCCH allocator
+int run_pdcch_alloc(const run_params& params, uint32_t nof_ttis, run_result& result)
+{
+  using rand_uint = std::uniform_int_distribution<uint32_t>;
+
+  std::vector<sched_cell_params_t> cell_params(1);
+  sched_interface::ue_cfg_t        ue_cfg   = generate_default_ue_cfg();
+  sched_interface::cell_cfg_t      cell_cfg = generate_default_cell_cfg(params.nof_prb);
+  sched_interface::sched_args_t    sched_args{};
+  sched_args.fast_pdcch_alloc = params.fast_pdcch_alloc;
+  TESTASSERT(cell_params[0].set_cfg(0, cell_cfg, sched_args));
+
+  // Each UE keeps its aggregation level, with low aggregation levels being the most common
+  std::vector<std::unique_ptr<sched_ue> > ues;
+  std::vector<uint32_t>                   ue_aggr_idx;
+  std::default_random_engine              rgen(params.nof_ues);
+  for (uint32_t i = 0; i < params.nof_ues; ++i) {
+    ues.emplace_back(new sched_ue{(uint16_t)(0x46 + i), cell_params, ue_cfg});
+    ue_aggr_idx.push_back(std::min(rand_uint{0, 4}(rgen), 3U));
+  }
+
+  sf_cch_allocator pdcch;
+  pdcch.init(cell_params[0]);
+
+  std::vector<uint32_t> tti_nsec;
+  tti_nsec.reserve(nof_ttis);
+  uint64_t nof_dcis = 0;
+  for (uint32_t count = 0; count < nof_ttis; ++count) {
+    tti_point tti_rx{count};
+    auto      tp = std::chrono::steady_clock::now();
+
+    pdcch.new_tti(tti_rx);
+    if (to_tx_dl(tti_rx).sf_idx() == 5) {
+      pdcch.alloc_dci(alloc_type_t::DL_BC, 2);
+    }
+    if (count % 4 == 0) {
+      pdcch.alloc_dci(alloc_type_t::DL_RAR, 2);
+    }
+    // Rotate the UE that gets the first chance, as the scheduler policies do
+    for (uint32_t i = 0; i < params.nof_ues and pdcch.nof_allocs() < sf_cch_allocator::alloc_result_t{}.capacity();
+         ++i) {
+      uint32_t ue_idx = (count + i) % params.nof_ues;
+      pdcch.alloc_dci(alloc_type_t::DL_DATA, ue_aggr_idx[ue_idx], ues[ue_idx].get(), false);
+      if (pdcch.nof_allocs() < sf_cch_allocator::alloc_result_t{}.capacity()) {
+        pdcch.alloc_dci(alloc_type_t::UL_DATA, ue_aggr_idx[ue_idx], ues[ue_idx].get());
+      }
+    }
+
+    auto duration = std::chrono::steady_clock::now() - tp;
+    tti_nsec.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    nof_dcis += pdcch.nof_allocs();
+
+    // TEST: DCIs do not collide in the PDCCH
+    sf_cch_allocator::alloc_result_t dci_result;
+    pdcch_mask_t                     total_mask, mask(pdcch.nof_cces());
+    pdcch.get_allocs(&dci_result, &total_mask);
+    for (const sf_cch_allocator::tree_node* node : dci_result) {
+      TESTASSERT((mask & node->current_mask).none());
+      mask |= node->current_mask;
+    }
+    TESTASSERT(mask == total_mask);
+  }
+
+  std::sort(tti_nsec.begin(), tti_nsec.end());
+  result.avg_dcis = nof_dcis / (float)nof_ttis;
+  result.avg_usec = std::accumulate(tti_nsec.begin(), tti_nsec.end(), 0.0) / nof_ttis / 1000.0;
+  result.q99_usec = tti_nsec[std::min((size_t)(nof_ttis * 0.99), tti_nsec.size() - 1)] / 1000.0;
+  result.max_usec = tti_nsec.back() / 1000.0;
+  return SRSRAN_SUCCESS;
+}
+
+int run_benchmark(uint32_t nof_ttis)
+{
+  const uint32_t nof_prb = 100;
+  // The exhaustive search takes up to seconds per TTI with many UEs
+  const uint32_t max_exhaustive_ttis = 200;
+
+  fmt::print("PDCCH alloc | Nprb | Nue | DCIs/TTI | TTI latency [usec] | q0.99 [usec] | max [usec]\n");
+  fmt::print("--------------------------------------------------------------------------------\n");
+  for (uint32_t nof_ues : {4, 8, 16, 32, 64}) {
+    for (bool fast : {false, true}) {
+      run_result result   = {};
+      uint32_t   run_ttis = fast ? nof_ttis : std::min(nof_ttis, max_exhaustive_ttis);
+      TESTASSERT(run_pdcch_alloc(run_params{nof_prb, nof_ues, fast}, run_ttis, result) == SRSRAN_SUCCESS);
+      fmt::print("{:>11}{:>7}{:>6}{:>11.1f}{:>21.1f}{:>15.1f}{:>13.1f}\n",
+                 fast ? "fast" : "exhaustive",
+                 nof_prb,
+                 nof_ues,
+                 result.avg_dcis,
+                 result.avg_usec,
+                 result.q99_usec,
+                 result.max_usec);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char** argv)
+{
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  uint32_t nof_ttis = 20;
+  if (argc > 1 and strcmp(argv[1], "benchmark") == 0) {
+    nof_ttis = 10000;
+  }
+
+  TESTASSERT(srsenb::run_benchmark(nof_ttis) == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
@@ -133,6 +133,9 @@ void sched_tester::new_test_tti()
 
 void sched_tester::before_sched()
 {
+  // apply the feedback that the scheduler would otherwise apply at the start of the TTI, before the HARQ snapshot
+  apply_feedback_queues();
+
   // check pending data buffers
   for (auto& it : ue_db) {
     uint16_t            rnti = it.first;
@@ -305,6 +308,9 @@ sched_sim_events rand_sim_params(uint32_t nof_ttis)
   sim_gen.sim_args.sched_args.pusch_mcs =
       boolean_dist() ? -1 : std::uniform_int_distribution<>{0, 24}(srsenb::get_rand_gen());
   sim_gen.sim_args.sched_args.min_aggr_level = std::uniform_int_distribution<>{0, 3}(srsenb::get_rand_gen());
+  sim_gen.sim_args.sched_args.async_feedback   = boolean_dist();
+  sim_gen.sim_args.sched_args.sched_policy     = pick_random_uniform({"time_rr", "time_pf", "freq_pf"});
+  sim_gen.sim_args.sched_args.fast_pdcch_alloc = boolean_dist();
 
   generator.tti_events.resize(nof_ttis);
 
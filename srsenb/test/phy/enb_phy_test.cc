@@ -28,6 +28,7 @@
 #include <boost/program_options/parsers.hpp>
 #include <iostream>
 #include <mutex>
+#include <queue>
 #include <srsenb/hdr/phy/phy.h>
 #include <srsran/common/string_helpers.h>
 #include <srsran/common/test_common.h>
@@ -272,6 +273,8 @@ typedef std::unique_ptr<dummy_radio> unique_dummy_radio_t;
 class dummy_stack final : public srsenb::stack_interface_phy_lte
 {
 private:
+  using harq_softbuffers_rx_t = std::array<srsran_softbuffer_rx_t, SRSRAN_FDD_NOF_HARQ>;
+
   static constexpr float    prob_dl_grant = 0.50f;
   static constexpr float    prob_ul_grant = 0.10f;
   static constexpr uint32_t cfi           = 2;
@@ -285,6 +288,9 @@ private:
   srsran_softbuffer_rx_t                            softbuffer_rx[SRSRAN_MAX_CARRIERS][SRSRAN_FDD_NOF_HARQ] = {};
   uint8_t*                                          data                                                    = nullptr;
   uint16_t                                          ue_rnti                                                 = 0;
+  uint32_t                                          nof_extra_pusch                                         = 0;
+  std::vector<harq_softbuffers_rx_t>                extra_softbuffer_rx;
+  std::vector<std::vector<uint8_t> >                extra_data;
   srsran_random_t                                   random_gen                                              = nullptr;
 
   CALLBACK(sr_detected);
@@ -344,9 +350,13 @@ public:
   explicit dummy_stack(const srsenb::phy_cfg_t&                                 phy_cfg_,
                        const srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t& phy_rrc_,
                        const std::string&                                       log_level,
-                       uint16_t                                                 rnti_) :
+                       uint16_t                                                 rnti_,
+                       uint32_t                                                 nof_extra_pusch_) :
     logger(srslog::fetch_basic_logger("STACK", false)),
     ue_rnti(rnti_),
+    nof_extra_pusch(nof_extra_pusch_),
+    extra_softbuffer_rx(nof_extra_pusch_),
+    extra_data(nof_extra_pusch_, std::vector<uint8_t>(150000)),
     random_gen(srsran_random_init(rnti_)),
     phy_cell_cfg(phy_cfg_.phy_cell_cfg),
     phy_rrc(phy_rrc_)
@@ -358,6 +368,11 @@ public:
         srsran_softbuffer_rx_init(&sb, SRSRAN_MAX_PRB);
       }
     }
+    for (auto& v : extra_softbuffer_rx) {
+      for (auto& sb : v) {
+        srsran_softbuffer_rx_init(&sb, SRSRAN_MAX_PRB);
+      }
+    }
 
     srsran_pdcch_t pdcch = {};
     srsran_regs_t  regs  = {};
@@ -408,6 +423,11 @@ public:
         srsran_softbuffer_rx_free(&sb);
       }
     }
+    for (auto& v : extra_softbuffer_rx) {
+      for (auto& sb : v) {
+        srsran_softbuffer_rx_free(&sb);
+      }
+    }
     if (data) {
       free(data);
     }
@@ -711,6 +731,21 @@ public:
 
         // Push to queue
         tti_ul_info_sched_queue.push(tti_ul_info);
+
+        // Extra grants in the PCell, for RNTIs without any UE transmitting, so that the eNb decodes several PUSCH in
+        // the same subframe. They do not need PDCCH and their CRC is expected to fail
+        for (uint32_t i = 0; i < nof_extra_pusch and scell_idx == 0; i++) {
+          auto& pusch         = ul_sched.pusch[ul_sched.nof_grants++];
+          pusch               = ul_sched.pusch[0];
+          pusch.dci.rnti      = ue_rnti + 1 + i;
+          pusch.data          = extra_data[i].data();
+          pusch.needs_pdcch   = false;
+          pusch.softbuffer_rx = &extra_softbuffer_rx[i][tti % SRSRAN_FDD_NOF_HARQ];
+          srsran_softbuffer_rx_reset(pusch.softbuffer_rx);
+
+          tti_ul_info.crc = false;
+          tti_ul_info_sched_queue.push(tti_ul_info);
+        }
       } else {
         ul_sched.nof_grants = 0;
       }
@@ -1175,6 +1210,8 @@ public:
     uint32_t              period_pcell_rotate = 0;
     srsran_tm_t           tm                  = SRSRAN_TM1;
     bool                  extended_cp         = false;
+    uint32_t              pusch_fanout        = 1;
+    uint32_t              nof_extra_pusch     = 0;
     args_t()
     {
       cell.nof_prb   = 6;
@@ -1242,7 +1279,8 @@ public:
 
     // PHY arguments
     phy_args.log.phy_level   = args.log_level;
-    phy_args.nof_phy_threads = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.nof_phy_threads     = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.pusch_decode_fanout = args.pusch_fanout;
 
     // Create cell configuration
     phy_cfg.phy_cell_cfg.resize(args.nof_enb_cells);
@@ -1333,7 +1371,8 @@ public:
         new dummy_radio(args.nof_enb_cells * args.cell.nof_ports, args.cell.nof_prb, args.log_level));
 
     /// Create Dummy Stack instance
-    stack = unique_dummy_stack_t(new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti));
+    stack = unique_dummy_stack_t(
+        new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti, args.nof_extra_pusch));
     stack->set_active_cell_list(args.ue_cell_list);
 
     /// Initiate eNb PHY with the given RNTI
@@ -1344,6 +1383,17 @@ public:
     enb_phy->complete_config(args.rnti);
     enb_phy->set_activation_deactivation_scell(args.rnti, activation);
 
+    /// RNTIs of the extra PUSCH grants, only in the PCell and without any UCI
+    srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t extra_rrc_cfg(1);
+    extra_rrc_cfg[0]                                                = phy_rrc_cfg[0];
+    extra_rrc_cfg[0].phy_cfg.dl_cfg.cqi_report.periodic_configured = false;
+    extra_rrc_cfg[0].phy_cfg.dl_cfg.cqi_report.ri_idx_present      = false;
+    extra_rrc_cfg[0].phy_cfg.ul_cfg.pucch.sr_configured            = false;
+    for (uint32_t i = 0; i < args.nof_extra_pusch; i++) {
+      enb_phy->set_config(args.rnti + 1 + i, extra_rrc_cfg);
+      enb_phy->complete_config(args.rnti + 1 + i);
+    }
+
     /// Create dummy UE instance
     ue_phy = unique_dummy_ue_phy_t(new dummy_ue(radio.get(), phy_cfg.phy_cell_cfg, args.log_level, args.rnti));
 
@@ -1436,6 +1486,13 @@ public:
   {
     // nothing to do
   }
+
+  srsenb::pusch_fanout_metrics_t get_pusch_fanout_metrics()
+  {
+    srsenb::pusch_fanout_metrics_t metrics = {};
+    enb_phy->get_pusch_fanout_metrics(metrics);
+    return metrics;
+  }
 };
 
 typedef std::unique_ptr<phy_test_bench> unique_phy_test_bench;
@@ -1462,6 +1519,8 @@ int parse_args(int argc, char** argv, phy_test_bench::args_t& args)
       ("cell.cp",        bpo::value<bool>(&args.extended_cp)->default_value(false),                      "use extended CP")
       ("tm", bpo::value<uint32_t>(&args.tm_u32)->default_value(args.tm_u32),                             "Transmission mode")
       ("rotation", bpo::value<uint32_t>(&args.period_pcell_rotate),                      "Serving cells rotation period in ms, set to zero to disable")
+      ("pusch_fanout",    bpo::value<uint32_t>(&args.pusch_fanout)->default_value(args.pusch_fanout),       "Maximum number of PUSCH grants decoded in parallel")
+      ("nof_extra_pusch", bpo::value<uint32_t>(&args.nof_extra_pusch)->default_value(args.nof_extra_pusch), "Additional PUSCH grants per subframe in the PCell, for RNTIs without UE")
       ;
   options.add(common).add_options()("help", "Show this message");
   // clang-format on
@@ -1524,6 +1583,15 @@ int main(int argc, char** argv)
     err_code = test_bench->run_tti();
   }
 
+  // All the PUSCH grants of a subframe go through the fan-out, when it is enabled
+  srsenb::pusch_fanout_metrics_t pusch_fanout = test_bench->get_pusch_fanout_metrics();
+  if (test_args.pusch_fanout > 1 and test_args.nof_extra_pusch > 0) {
+    TESTASSERT(pusch_fanout.nof_subframes > 0);
+    TESTASSERT(pusch_fanout.nof_grants == pusch_fanout.nof_subframes * (1 + test_args.nof_extra_pusch));
+  } else if (test_args.pusch_fanout <= 1) {
+    TESTASSERT(pusch_fanout.nof_subframes == 0);
+  }
+
   test_bench->stop();
 
   srslog::flush();
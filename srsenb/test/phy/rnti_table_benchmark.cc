@@ -0,0 +1,160 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/common/rnti_table.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <map>
+#include <random>
+
+namespace srsenb {
+
+// First C-RNTI allocated by the MAC
+const uint16_t first_rnti = 0x46;
+
+// Number of UE table lookups done by the PHY workers for each scheduled UE in a TTI (DL config, DCI config, UL config,
+// UCI config, pending ACK and metrics)
+const uint32_t nof_lookups_x_ue = 6;
+
+struct ue_dummy {
+  explicit ue_dummy(uint16_t rnti_) : rnti(rnti_) {}
+  uint16_t                 rnti = 0;
+  std::array<uint32_t, 32> data = {};
+};
+
+int test_rnti_table()
+{
+  rnti_table<ue_dummy, 16> table;
+  TESTASSERT(table.empty() and table.size() == 0);
+  TESTASSERT(table.begin() == table.end());
+
+  // C-RNTIs
+  TESTASSERT(table.emplace(first_rnti, first_rnti));
+  TESTASSERT(table.contains(first_rnti) and table[first_rnti].rnti == first_rnti);
+  TESTASSERT(not table.emplace(first_rnti, first_rnti));
+  TESTASSERT(table.emplace(first_rnti + 1, first_rnti + 1));
+  TESTASSERT(table.size() == 2);
+
+  // A C-RNTI whose slot is taken by another C-RNTI is rejected
+  TESTASSERT(not table.contains(first_rnti + 16));
+  TESTASSERT(not table.emplace(first_rnti + 16, first_rnti + 16));
+  TESTASSERT(table.find_ptr(first_rnti + 16) == nullptr);
+
+  // Reserved RNTIs do not collide with C-RNTIs nor among them
+  TESTASSERT(table.emplace(SRSRAN_SIRNTI, SRSRAN_SIRNTI));
+  TESTASSERT(table.emplace(SRSRAN_PRNTI, SRSRAN_PRNTI));
+  TESTASSERT(table.emplace(SRSRAN_MRNTI, SRSRAN_MRNTI));
+  for (uint16_t rnti = SRSRAN_RARNTI_START; rnti <= SRSRAN_RARNTI_END; rnti++) {
+    TESTASSERT(table.emplace(rnti, rnti));
+  }
+  TESTASSERT(table.size() == 2 + 3 + SRSRAN_RARNTI_END - SRSRAN_RARNTI_START + 1);
+  TESTASSERT(table[SRSRAN_SIRNTI].rnti == SRSRAN_SIRNTI);
+  TESTASSERT(table.find(SRSRAN_PRNTI)->first == SRSRAN_PRNTI);
+
+  // Iteration visits every RNTI once
+  uint32_t count = 0;
+  for (std::pair<uint16_t, ue_dummy>& e : table) {
+    TESTASSERT(e.first == e.second.rnti);
+    count++;
+  }
+  TESTASSERT(count == table.size());
+
+  // Erasing frees the slot for another RNTI
+  TESTASSERT(not table.erase(first_rnti + 16));
+  TESTASSERT(table.erase(first_rnti));
+  TESTASSERT(not table.contains(first_rnti));
+  TESTASSERT(table.emplace(first_rnti + 16, first_rnti + 16));
+  TESTASSERT(table[first_rnti + 16].rnti == first_rnti + 16);
+
+  table.clear();
+  TESTASSERT(table.empty() and table.begin() == table.end());
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Runs nof_ttis TTIs in which every UE is looked up nof_lookups_x_ue times, returns the average TTI time in ns
+template <typename Table>
+double run_ttis(Table& table, const std::vector<uint16_t>& rntis, uint32_t nof_ttis)
+{
+  uint64_t checksum = 0;
+  auto     tp       = std::chrono::steady_clock::now();
+  for (uint32_t tti = 0; tti < nof_ttis; tti++) {
+    for (uint16_t rnti : rntis) {
+      for (uint32_t i = 0; i < nof_lookups_x_ue; i++) {
+        auto it = table.find(rnti);
+        if (it != table.end()) {
+          checksum += it->second.data[i];
+        }
+      }
+    }
+  }
+  auto duration = std::chrono::steady_clock::now() - tp;
+  // Keep the lookups from being optimized out
+  TESTASSERT(checksum == 0);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / (double)nof_ttis;
+}
+
+template <size_t N>
+int run_benchmark(uint32_t nof_ttis)
+{
+  // Pick the UEs as the MAC would, skipping the RNTIs whose slot is taken, and look them up in a random order
+  rnti_table<ue_dummy, N>         table;
+  std::map<uint16_t, ue_dummy>    map;
+  std::vector<uint16_t>           rntis;
+  std::mt19937                    rgen(N);
+  std::uniform_int_distribution<> rnti_dist(first_rnti, 60000);
+  while (rntis.size() < N) {
+    uint16_t rnti = rnti_dist(rgen);
+    if (table.emplace(rnti, rnti)) {
+      map.emplace(rnti, ue_dummy{rnti});
+      rntis.push_back(rnti);
+    }
+  }
+  std::shuffle(rntis.begin(), rntis.end(), rgen);
+
+  double map_ns   = run_ttis(map, rntis, nof_ttis);
+  double table_ns = run_ttis(table, rntis, nof_ttis);
+  printf("nof_ues=%4zd; lookups/TTI=%5zd; std::map=%9.1f ns/TTI; rnti_table=%9.1f ns/TTI; speedup=%.1fx\n",
+         N,
+         N * nof_lookups_x_ue,
+         map_ns,
+         table_ns,
+         map_ns / table_ns);
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char** argv)
+{
+  uint32_t nof_ttis = 100;
+  if (argc > 1 and strcmp(argv[1], "benchmark") == 0) {
+    nof_ttis = 10000;
+  }
+
+  TESTASSERT(srsenb::test_rnti_table() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::run_benchmark<64>(nof_ttis) == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::run_benchmark<256>(nof_ttis) == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::run_benchmark<1024>(nof_ttis) == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
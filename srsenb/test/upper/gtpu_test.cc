@@ -157,6 +157,120 @@ srsran::unique_byte_buffer_t read_socket(int fd)
   return pdu;
 }
 
+/// Reads a datagram from a non-blocking UDP socket, or returns nullptr if there is none
+srsran::unique_byte_buffer_t try_read_socket(int fd)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  ssize_t                      n   = recv(fd, pdu->msg, pdu->get_tailroom(), MSG_DONTWAIT);
+  if (n <= 0) {
+    return nullptr;
+  }
+  pdu->N_bytes = n;
+  return pdu;
+}
+
+/// UDP socket standing for a GTP-U peer that is not under test
+bool open_peer_socket(srsran::unique_socket& sock, const char* addr_str)
+{
+  return sock.open_socket(srsran::net_utils::addr_family::ipv4,
+                          srsran::net_utils::socket_type::datagram,
+                          srsran::net_utils::protocol_type::UDP) and
+         sock.bind_addr(addr_str, GTPU_PORT);
+}
+
+int test_gtpu_batched_tx()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("TEST");
+  logger.info("\n\n**** Test GTPU batched Tx ****\n");
+  const uint32_t     batch_size = 4;
+  uint16_t           rnti       = 0x46;
+  uint32_t           drb1_bearer_id = 5, sgw_teidout = 1, tenb_teidout = 7;
+  const char *       sgw_addr_str = "127.0.0.1", *senb_addr_str = "127.0.1.1", *tenb_addr_str = "127.0.1.2";
+  struct sockaddr_in sgw_sockaddr = {}, senb_sockaddr = {}, tenb_sockaddr = {};
+  srsran::net_utils::set_sockaddr(&sgw_sockaddr, sgw_addr_str, GTPU_PORT);
+  srsran::net_utils::set_sockaddr(&senb_sockaddr, senb_addr_str, GTPU_PORT);
+  srsran::net_utils::set_sockaddr(&tenb_sockaddr, tenb_addr_str, GTPU_PORT);
+  uint32_t sgw_addr  = ntohl(sgw_sockaddr.sin_addr.s_addr);
+  uint32_t tenb_addr = ntohl(tenb_sockaddr.sin_addr.s_addr);
+
+  // The S-GW and the TeNB are plain sockets, so that the datagrams and their order can be checked
+  srsran::unique_socket sgw_sock, tenb_sock;
+  TESTASSERT(open_peer_socket(sgw_sock, sgw_addr_str) and open_peer_socket(tenb_sock, tenb_addr_str));
+  int sgw_fd = sgw_sock.fd(), tenb_fd = tenb_sock.fd();
+
+  srsran::task_scheduler task_sched;
+  dummy_socket_manager   senb_rx_sockets;
+  srsenb::gtpu senb_gtpu(&task_sched, srslog::fetch_basic_logger("GTPU1"), srsran::srsran_rat_t::lte, &senb_rx_sockets);
+  pdcp_tester            senb_pdcp;
+  gtpu_args_t            gtpu_args;
+  gtpu_args.gtp_bind_addr  = senb_addr_str;
+  gtpu_args.mme_addr       = sgw_addr_str;
+  gtpu_args.s1u_batch_size = batch_size;
+  TESTASSERT(senb_gtpu.init(gtpu_args, &senb_pdcp) == SRSRAN_SUCCESS);
+  uint32_t addr_in;
+  uint32_t senb_teid_in = senb_gtpu.add_bearer(rnti, drb1_bearer_id, sgw_addr, sgw_teidout, addr_in).value();
+
+  std::vector<uint8_t>         data(10);
+  srsran::unique_byte_buffer_t pdu;
+  gtpu_metrics_t               metrics;
+  auto                         write_ul_pdu = [&](uint8_t value) {
+    std::fill(data.begin(), data.end(), value);
+    senb_gtpu.write_pdu(rnti, drb1_bearer_id, encode_ipv4_packet(data, senb_teid_in, senb_sockaddr, sgw_sockaddr));
+  };
+  auto check_data_pdu = [&](const srsran::unique_byte_buffer_t& rx_pdu, uint8_t value) {
+    TESTASSERT(rx_pdu != nullptr);
+    TESTASSERT(rx_pdu->msg[1] == GTPU_MSG_DATA_PDU);
+    TESTASSERT(std::count(rx_pdu->msg + PDU_HEADER_SIZE + 8, rx_pdu->msg + rx_pdu->N_bytes, value) == 10);
+    return SRSRAN_SUCCESS;
+  };
+
+  // TEST: UL PDUs are held until the batch is full, and then sent in order with a single sendmmsg
+  for (uint8_t i = 0; i < batch_size - 1; ++i) {
+    write_ul_pdu(i);
+  }
+  TESTASSERT(try_read_socket(sgw_fd) == nullptr);
+  senb_gtpu.get_metrics(metrics);
+  TESTASSERT(metrics.nof_tx_batches == 0 and metrics.nof_tx_pdus == 0);
+  write_ul_pdu(batch_size - 1);
+  for (uint8_t i = 0; i < batch_size; ++i) {
+    TESTASSERT(check_data_pdu(try_read_socket(sgw_fd), i) == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(try_read_socket(sgw_fd) == nullptr);
+  senb_gtpu.get_metrics(metrics);
+  TESTASSERT(metrics.nof_tx_batches == 1 and metrics.nof_tx_pdus == batch_size);
+
+  // TEST: a partial batch is sent in the next TTI
+  write_ul_pdu(10);
+  write_ul_pdu(11);
+  TESTASSERT(try_read_socket(sgw_fd) == nullptr);
+  senb_gtpu.tti_clock();
+  TESTASSERT(check_data_pdu(try_read_socket(sgw_fd), 10) == SRSRAN_SUCCESS);
+  TESTASSERT(check_data_pdu(try_read_socket(sgw_fd), 11) == SRSRAN_SUCCESS);
+  senb_gtpu.get_metrics(metrics);
+  TESTASSERT(metrics.nof_tx_batches == 1 and metrics.nof_tx_pdus == 2);
+
+  // TEST: the End Marker does not overtake the DL PDUs still batched towards the TeNB
+  gtpu::bearer_props props;
+  props.forward_from_teidin_present = true;
+  props.forward_from_teidin         = senb_teid_in;
+  senb_gtpu.add_bearer(rnti, drb1_bearer_id, tenb_addr, tenb_teidout, addr_in, &props);
+  for (uint8_t i = 20; i < 22; ++i) {
+    std::fill(data.begin(), data.end(), i);
+    senb_gtpu.handle_gtpu_s1u_rx_packet(encode_gtpu_packet(data, senb_teid_in, sgw_sockaddr, senb_sockaddr),
+                                        sgw_sockaddr);
+  }
+  TESTASSERT(try_read_socket(tenb_fd) == nullptr);
+  senb_gtpu.handle_gtpu_s1u_rx_packet(encode_end_marker(senb_teid_in), sgw_sockaddr);
+  TESTASSERT(check_data_pdu(try_read_socket(tenb_fd), 20) == SRSRAN_SUCCESS);
+  TESTASSERT(check_data_pdu(try_read_socket(tenb_fd), 21) == SRSRAN_SUCCESS);
+  pdu = try_read_socket(tenb_fd);
+  TESTASSERT(pdu != nullptr and pdu->msg[1] == GTPU_MSG_END_MARKER);
+  TESTASSERT(try_read_socket(tenb_fd) == nullptr);
+
+  senb_gtpu.stop();
+  return SRSRAN_SUCCESS;
+}
+
 void test_gtpu_tunnel_manager()
 {
   const char*        sgw_addr_str = "127.0.0.1";
@@ -399,6 +513,7 @@ int main(int argc, char** argv)
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::wait_end_marker_timeout) == SRSRAN_SUCCESS);
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::ue_removal_no_marker) == SRSRAN_SUCCESS);
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::reest_senb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_gtpu_batched_tx() == SRSRAN_SUCCESS);
 
   srslog::flush();
 
@@ -28,13 +28,19 @@
 #ifndef SRSEPC_HSS_H
 #define SRSEPC_HSS_H
 
+#include "srsepc/hdr/hss/hss_db.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/milenage_batch.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
 
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -47,29 +53,7 @@ struct hss_args_t {
   std::string db_file;
   uint16_t    mcc;
   uint16_t    mnc;
-};
-
-enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
-
-struct hss_ue_ctx_t {
-  // Members
-  std::string        name;
-  uint64_t           imsi;
-  enum hss_auth_algo algo;
-  uint8_t            key[16];
-  bool               op_configured;
-  uint8_t            op[16];
-  uint8_t            opc[16];
-  uint8_t            amf[2];
-  uint8_t            sqn[6];
-  uint16_t           qci;
-  uint8_t            last_rand[16];
-  std::string        static_ip_addr;
-
-  // Helper getters/setters
-  void set_sqn(const uint8_t* sqn_);
-  void set_last_rand(const uint8_t* rand_);
-  void get_last_rand(uint8_t* rand_);
+  uint32_t    auth_vector_batch;
 };
 
 class hss : public hss_interface_nas
@@ -92,11 +76,27 @@ private:
   virtual ~hss();
   static hss* m_instance;
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
+  hss_db m_db;
+
+  // Milenage vectors generated ahead of the AIRs that use them. Only the subscribers with vectors left are kept, so
+  // the stash stays empty with a batch of 1. The mutex only guards the stash: the vectors of a subscriber are generated
+  // by the thread that handles it, like the rest of its SQN updates, with the key the store expanded at load
+  struct milenage_vector_t {
+    uint8_t                   rand[16];
+    uint8_t                   sqn[6];
+    srsran::milenage_output_t out;
+  };
+  static const uint32_t                                         max_auth_vector_batch = 32;
+  std::mutex                                                    m_milenage_mutex;
+  std::unordered_map<uint64_t, std::vector<milenage_vector_t> > m_milenage_stash; // Next vector at the back
+  uint32_t                                                      m_auth_vector_batch = 1;
+
+  bool gen_milenage_vectors(hss_ue_ctx_t* ue_ctx, milenage_vector_t* vectors);
+  bool pop_milenage_vector(uint64_t imsi, milenage_vector_t& vector);
 
   void gen_rand(uint8_t rand_[16]);
 
-  void
+  bool
        gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
   void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
 
@@ -105,8 +105,8 @@ private:
 
   void                     get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len);
 
-  void increment_ue_sqn(hss_ue_ctx_t* ue_ctx);
-  void increment_seq_after_resync(hss_ue_ctx_t* ue_ctx);
+  bool increment_ue_sqn(hss_ue_ctx_t* ue_ctx);
+  bool increment_seq_after_resync(hss_ue_ctx_t* ue_ctx);
   void increment_sqn(uint8_t* sqn, uint8_t* next_sqn);
 
   bool          set_auth_algo(std::string auth_algo);
@@ -123,23 +123,7 @@ private:
 
   uint16_t mcc;
   uint16_t mnc;
-
-  std::map<std::string, uint64_t> m_ip_to_imsi;
 };
 
-inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
-{
-  memcpy(sqn, sqn_, 6);
-}
-
-inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
-{
-  memcpy(last_rand, last_rand_, 16);
-}
-
-inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
-{
-  memcpy(last_rand_, last_rand, 16);
-}
 } // namespace srsepc
 #endif // SRSEPC_HSS_H
@@ -0,0 +1,207 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_db.h
+ * Description: Subscriber store of the HSS. Either loaded from the user_db.csv
+ *              or memory mapped from its binary conversion, in which case the
+ *              SQN updates are persisted through a write-ahead journal.
+ *****************************************************************************/
+
+#ifndef SRSEPC_HSS_DB_H
+#define SRSEPC_HSS_DB_H
+
+#include "srsran/common/milenage_batch.h"
+#include "srsran/srslog/srslog.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace srsepc {
+
+enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
+
+/// Subscriber record. Its layout is also the on-disk layout of the binary store, so it must stay fixed size and POD
+struct hss_ue_ctx_t {
+  static const size_t max_name_len = 39;
+
+  // Members
+  uint64_t imsi;
+  uint8_t  key[16];
+  uint8_t  op[16];
+  uint8_t  opc[16];
+  uint8_t  amf[2];
+  uint8_t  sqn[6];
+  uint8_t  last_rand[16];
+  uint16_t qci;
+  uint8_t  algo; // hss_auth_algo
+  bool     op_configured;
+  uint32_t static_ip;              // Network byte order. 0 for a dynamically allocated IP
+  char     name[max_name_len + 1]; // Null terminated, truncated to max_name_len characters
+
+  // Helper getters/setters
+  void set_sqn(const uint8_t* sqn_);
+  void set_last_rand(const uint8_t* rand_);
+  void get_last_rand(uint8_t* rand_);
+  void set_name(const std::string& name_);
+};
+static_assert(sizeof(hss_ue_ctx_t) == 128, "The subscriber record is part of the binary store format");
+
+inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
+{
+  memcpy(sqn, sqn_, 6);
+}
+
+inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
+{
+  memcpy(last_rand, last_rand_, 16);
+}
+
+inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
+{
+  memcpy(last_rand_, last_rand, 16);
+}
+
+inline void hss_ue_ctx_t::set_name(const std::string& name_)
+{
+  size_t len = std::min(name_.size(), max_name_len);
+  memcpy(name, name_.data(), len);
+  name[len] = '\0';
+}
+
+/**
+ * Subscriber store, with O(1) lookup by IMSI through an open addressing hash index.
+ *
+ * The binary store (see write_binary()) is a header, followed by the subscriber records, the hash index and the
+ * static IP table. It is memory mapped as is, so opening it does not depend on the number of subscribers. The SQN
+ * updates are written to the mapping and appended to the journal file (<store>.journal), which is fsync'ed before
+ * sqn_updated() returns. Concurrent updates are committed together, with a single fsync. A background thread folds
+ * the journal back into the store, by rotating it and syncing the mapping, once it grows beyond
+ * compact_nof_entries. The rotated journal (<store>.journal.old) is only removed once the mapping is synced, and the
+ * journal is not rotated again while it is there. When opening the store, the journals left behind by a crash are
+ * replayed.
+ *
+ * The Milenage key schedule of each subscriber is expanded when the store is loaded, and kept next to the records
+ * rather than in them, so that the binary store format does not depend on the AES implementation.
+ *
+ * Lookups may run concurrently with each other and with sqn_updated(), but the records of a subscriber are only
+ * expected to be modified by one thread at a time.
+ */
+class hss_db
+{
+public:
+  static const uint32_t compact_nof_entries = 65536;
+
+  hss_db() = default;
+  ~hss_db();
+  hss_db(const hss_db&) = delete;
+  hss_db& operator=(const hss_db&) = delete;
+
+  /// Whether the file is a binary store, as opposed to a CSV file
+  static bool is_binary(const std::string& filename);
+
+  bool load_csv(const std::string& filename);
+  bool write_csv(const std::string& filename) const;
+  bool open_binary(const std::string& filename);
+  bool write_binary(const std::string& filename) const;
+
+  /// Syncs and closes the binary store, or just drops the loaded CSV
+  void close();
+
+  bool          is_binary() const { return map_base != nullptr; }
+  size_t        size() const { return nof_records; }
+  hss_ue_ctx_t* find(uint64_t imsi) const;
+
+  /// Expanded key K of a record returned by find(). It does not change while the store is open, so it can be read
+  /// without locking
+  const srsran::milenage_key& get_milenage_key(const hss_ue_ctx_t& ue_ctx) const
+  {
+    return milenage_keys[&ue_ctx - records];
+  }
+
+  /// Persists the SQN of the subscriber. No-op for CSV files, which are only written back on stop. Returns false if
+  /// the SQN could not be made durable, in which case the caller is expected to restore the previous one. Once a
+  /// journal write fails, no later update is accepted until the store is reopened
+  bool sqn_updated(const hss_ue_ctx_t& ue_ctx);
+
+  std::map<std::string, uint64_t> get_ip_to_imsi() const { return ip_to_imsi; }
+
+private:
+  struct journal_entry_t {
+    uint64_t imsi;
+    uint8_t  sqn[6];
+    uint16_t checksum;
+  };
+
+  bool build_index();
+  void expand_keys();
+  bool open_journal();
+  bool replay_journal(const std::string& filename);
+  bool compact(bool force);
+  bool drop_rotated_journal(const std::string& old_filename);
+  void run_compactor();
+
+  static uint16_t journal_checksum(const journal_entry_t& entry);
+
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("HSS");
+
+  // Store
+  std::string                       db_filename;
+  hss_ue_ctx_t*                     records     = nullptr;
+  size_t                            nof_records = 0;
+  const uint32_t*                   buckets     = nullptr; // Record index + 1 of each bucket, 0 when empty
+  uint64_t                          bucket_mask = 0;
+  std::map<std::string, uint64_t>   ip_to_imsi;
+  std::vector<srsran::milenage_key> milenage_keys; // Same order as the records
+
+  // CSV files are kept in memory
+  std::vector<hss_ue_ctx_t> csv_records;
+  std::vector<uint32_t>     csv_buckets;
+
+  // Binary stores are memory mapped
+  void*  map_base = nullptr;
+  size_t map_len  = 0;
+
+  // Journal, with group commit: the first thread that finds the pending entries unsynced writes and fsyncs them on
+  // behalf of the others
+  std::mutex                   journal_mutex;
+  std::condition_variable      journal_cvar;
+  std::vector<journal_entry_t> pending_entries;
+  int                          journal_fd     = -1;
+  uint64_t                     appended_seq   = 0;
+  uint64_t                     synced_seq     = 0;
+  uint64_t                     failed_seq     = 0; // First entry that could not be journaled, 0 if none
+  bool                         flushing       = false;
+  uint32_t                     nof_journaled  = 0; // Entries in the journal since the last compaction
+  bool                         compactor_stop = false;
+  std::condition_variable      compactor_cvar;
+  std::thread                  compactor;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_HSS_DB_H
@@ -30,9 +30,14 @@
 
 #include "s1ap.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/lockfree_queue.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/threads.h"
+#include <condition_variable>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace srsepc {
 
@@ -48,8 +53,23 @@ typedef struct {
   enum nas_timer_type type;
 } mme_timer_t;
 
+// Work handed by the MME thread to the S1AP/NAS worker that owns the UE
+struct mme_task_t {
+  enum task_type_t { S1AP_PDU, S11_PDU, NAS_TIMER, REPLACE_NAS_CTX, PAUSE };
+
+  task_type_t                  type = S1AP_PDU;
+  srsran::unique_byte_buffer_t pdu;
+  struct sctp_sndrcvinfo       sri        = {};
+  enum nas_timer_type          timer_type = T_3413;
+  uint64_t                     imsi       = 0;
+  nas*                         old_ctx    = nullptr;
+  nas*                         new_ctx    = nullptr;
+};
+
 class mme : public srsran::thread, public mme_interface_nas
 {
+  class ue_worker;
+
 public:
   static mme* get_instance(void);
   static void cleanup(void);
@@ -64,6 +84,9 @@ public:
   virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi);
   virtual bool remove_nas_timer(enum nas_timer_type type, uint64_t imsi);
 
+  // UE context handover between workers
+  virtual void replace_nas_ctx(uint64_t imsi, nas* old_ctx, nas* new_ctx);
+
 private:
   mme();
   virtual ~mme();
@@ -74,15 +97,59 @@ private:
   bool   m_running;
   fd_set m_set;
 
-  // Timer map
+  // S1AP/NAS workers. If empty, all PDUs are handled by the MME thread itself
+  std::vector<std::unique_ptr<ue_worker> > m_workers;
+  std::mutex                               m_pause_mutex;
+  std::condition_variable                  m_pause_cvar;
+  bool                                     m_paused     = false;
+  size_t                                   m_nof_paused = 0;
+
+  void handle_task(mme_task_t& task);
+  void dispatch_task(uint32_t worker_idx, mme_task_t task);
+  void pause_workers();
+  void resume_workers();
+  void wait_resume();
+  bool is_stale_task(const mme_task_t& task);
+
+  // Contexts replaced by a worker that does not own them, which the MME thread hands to their owner for deletion
+  std::mutex              m_replaced_ctxs_mutex;
+  std::vector<mme_task_t> m_replaced_ctxs;
+
+  // Timer map. With workers, timers are started and stopped by the workers, and the MME thread polls them
+  std::mutex               m_timers_mutex;
   std::vector<mme_timer_t> timers;
+  std::vector<int>         m_closed_timer_fds; // Closed by the MME thread, once they are out of its select()
+  int                      m_timer_wakeup_fd = -1; // eventfd that interrupts select() for the requests of the workers
 
   // Timer Methods
   void handle_timer_expire(int timer_fd);
+  void wakeup_mme_thread();
 
   // Logs
   srslog::basic_logger& m_s1ap_logger = srslog::fetch_basic_logger("S1AP");
 };
 
+/**
+ * S1AP/NAS worker thread. It decodes and handles the S1AP PDUs, S11 messages and NAS timer expirations of the UEs that
+ * it owns, which the MME thread pushes to its task queue.
+ */
+class mme::ue_worker : public srsran::thread
+{
+public:
+  static const uint32_t task_queue_size = 1024;
+
+  ue_worker(mme* mme_, uint32_t worker_idx);
+  bool push(mme_task_t task);
+  void stop();
+
+private:
+  void run_thread() override;
+
+  mme*                                     m_mme;
+  uint32_t                                 m_worker_idx;
+  std::atomic<bool>                        m_running;
+  srsran::spsc_blocking_queue<mme_task_t> m_tasks;
+};
+
 } // namespace srsepc
 #endif // SRSEPC_MME_H
@@ -22,8 +22,10 @@
 #define SRSEPC_MME_GTPC_H
 
 #include "nas.h"
+#include "ue_ctx_table.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/buffer_pool.h"
+#include <atomic>
 #include <sys/socket.h>
 #include <sys/un.h>
 
@@ -58,7 +60,8 @@ public:
   void         send_downlink_data_notification_acknowledge(uint64_t imsi, enum srsran::gtpc_cause_value cause);
   virtual bool send_downlink_data_notification_failure_indication(uint64_t imsi, enum srsran::gtpc_cause_value cause);
 
-  int get_s11();
+  int  get_s11();
+  bool get_imsi_from_ctrl_teid(uint32_t mme_ctrl_teid, uint64_t& imsi);
 
 private:
   mme_gtpc() = default;
@@ -66,9 +69,9 @@ private:
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("MME GTPC");
   s1ap*                 m_s1ap;
 
-  uint32_t                            m_next_ctrl_teid;
-  std::map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
-  std::map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
+  std::atomic<uint32_t>              m_next_ctrl_teid;
+  ue_ctx_table<uint32_t, uint64_t>   m_mme_ctr_teid_to_imsi;
+  ue_ctx_table<uint64_t, gtpc_ctx_t> m_imsi_to_gtpc_ctx;
 
   int                m_s11;
   struct sockaddr_un m_mme_addr, m_spgw_addr;
@@ -79,7 +82,7 @@ private:
 
 inline uint32_t mme_gtpc::get_new_ctrl_teid()
 {
-  return m_next_ctrl_teid++;
+  return m_next_ctrl_teid.fetch_add(1, std::memory_order_relaxed);
 }
 
 inline int mme_gtpc::get_s11()
@@ -264,6 +264,9 @@ public:
   esm_ctx_t m_esm_ctx[MAX_ERABS_PER_UE] = {};
   sec_ctx_t m_sec_ctx                   = {};
 
+  // S1AP/NAS worker that owns the UE context, i.e. the one that created it
+  uint32_t m_worker_idx = 0;
+
 private:
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("NAS");
   gtpc_interface_nas*   m_gtpc   = nullptr;
@@ -28,6 +28,7 @@
 #include "s1ap_mngmt_proc.h"
 #include "s1ap_nas_transport.h"
 #include "s1ap_paging.h"
+#include "ue_ctx_table.h"
 #include "srsepc/hdr/hss/hss.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/asn1/liblte_mme.h"
@@ -38,13 +39,16 @@
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <arpa/inet.h>
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <netinet/sctp.h>
 #include <set>
 #include <strings.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
 namespace srsepc {
 
@@ -66,6 +70,16 @@ public:
 
   void delete_enb_ctx(int32_t assoc_id);
 
+  // S1AP/NAS worker pool. UE contexts are sharded across workers: the worker that creates a UE context owns it, and
+  // all the PDUs, S11 messages and timers of the UE are handled by that worker.
+  static const uint32_t no_worker = UINT32_MAX; ///< The PDU is not UE-associated and is handled by the MME thread
+  uint32_t              get_nof_workers();
+  static uint32_t       get_worker_idx();
+  static void           set_worker_idx(uint32_t worker_idx);
+  uint32_t              get_pdu_worker(const srsran::byte_buffer_t* pdu, const struct sctp_sndrcvinfo* enb_sri);
+  uint32_t              get_imsi_worker(uint64_t imsi);
+  uint32_t              get_mme_ue_s1ap_id_worker(uint32_t mme_ue_s1ap_id);
+
   bool s1ap_tx_pdu(const s1ap_pdu_t& pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri);
@@ -92,6 +106,7 @@ public:
   bool         release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id);
   void         release_ues_ecm_ctx_in_enb(int32_t enb_assoc);
   virtual bool delete_ue_ctx(uint64_t imsi);
+  void         replace_nas_ctx(uint64_t imsi, nas* old_ctx, nas* new_ctx);
 
   uint32_t         allocate_m_tmsi(uint64_t imsi);
   virtual uint64_t find_imsi_from_m_tmsi(uint32_t m_tmsi);
@@ -105,8 +120,9 @@ public:
   s1ap_erab_mngmt_proc* m_s1ap_erab_mngmt_proc;
   s1ap_paging*          m_s1ap_paging;
 
-  std::map<uint32_t, uint64_t>   m_tmsi_to_imsi;
-  std::map<uint16_t, enb_ctx_t*> m_active_enbs;
+  ue_ctx_table<uint32_t, uint64_t> m_tmsi_to_imsi;
+  std::map<uint16_t, enb_ctx_t*>   m_active_enbs;
+  std::mutex                       m_enb_mutex; // Protects m_active_enbs and the eNB association maps
 
   // Interfaces
   virtual bool send_initial_context_setup_request(uint64_t imsi, uint16_t erab_to_setup);
@@ -141,11 +157,12 @@ private:
   std::map<int32_t, uint16_t>            m_sctp_to_enb_id;
   std::map<int32_t, std::set<uint32_t> > m_enb_assoc_to_ue_ids;
 
-  std::map<uint64_t, nas*> m_imsi_to_nas_ctx;
-  std::map<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
+  ue_ctx_table<uint64_t, nas*> m_imsi_to_nas_ctx;
+  ue_ctx_table<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
 
-  uint32_t m_next_mme_ue_s1ap_id;
-  uint32_t m_next_m_tmsi;
+  uint32_t              m_nof_workers;
+  std::vector<uint32_t> m_next_mme_ue_s1ap_id; // One counter per worker, see get_next_mme_ue_s1ap_id()
+  std::atomic<uint32_t> m_next_m_tmsi;
 
   // GTP-C Interface
   mme_gtpc* m_mme_gtpc;
@@ -153,6 +170,7 @@ private:
   // PCAP
   bool              m_pcap_enable;
   srsran::s1ap_pcap m_pcap;
+  std::mutex        m_pcap_mutex;
 };
 
 inline uint32_t s1ap::get_plmn()
@@ -165,5 +183,10 @@ inline uint16_t s1ap::get_tac()
   return m_s1ap_args.tac;
 }
 
+inline uint32_t s1ap::get_nof_workers()
+{
+  return m_nof_workers;
+}
+
 } // namespace srsepc
 #endif // SRSEPC_S1AP_H
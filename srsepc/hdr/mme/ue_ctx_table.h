@@ -0,0 +1,160 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/******************************************************************************
+ * File:        ue_ctx_table.h
+ * Description: Hashed UE context tables of the MME, shared by the S1AP/NAS
+ *              workers. Each table is split in lock stripes, so that workers
+ *              serving different UEs rarely contend.
+ *****************************************************************************/
+
+#ifndef SRSEPC_UE_CTX_TABLE_H
+#define SRSEPC_UE_CTX_TABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace srsepc {
+
+/// Spreads UE identifiers, which are usually consecutive, across hash buckets
+inline uint64_t ue_id_hash(uint64_t id)
+{
+  return (id * 0x9E3779B97F4A7C15ULL) >> 32U;
+}
+
+/**
+ * Hash table from a UE identifier (IMSI, MME-UE-S1AP-ID, M-TMSI, control TEID) to a UE context or to another
+ * identifier. The table is split in stripes, each one an unordered_map with its own mutex, and a key always lands in
+ * the same stripe.
+ * - All methods are thread-safe. They only lock the stripe of the key, except for_each() and clear(), which lock each
+ *   stripe in turn.
+ * - The values are copied out of the table. Values that are modified in place must be accessed with visit(), which
+ *   runs under the lock of the stripe.
+ * - When T is a pointer, the pointed object is not protected by the table. The MME relies on each UE context being
+ *   only handled by the worker that owns it.
+ */
+template <typename Key, typename T>
+class ue_ctx_table
+{
+public:
+  static const uint32_t nof_stripes = 64;
+
+  ue_ctx_table() : stripes(new stripe_t[nof_stripes]) {}
+  ue_ctx_table(const ue_ctx_table&) = delete;
+  ue_ctx_table& operator=(const ue_ctx_table&) = delete;
+
+  /// Adds a value. Returns false, leaving the table untouched, if the key already exists
+  bool insert(const Key& key, const T& value)
+  {
+    stripe_t&                   s = get_stripe(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.map.emplace(key, value).second;
+  }
+
+  /// Copies the value of the key to value. Returns false if the key does not exist
+  bool find(const Key& key, T& value) const
+  {
+    const stripe_t&             s = get_stripe(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto                        it = s.map.find(key);
+    if (it == s.map.end()) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+
+  bool contains(const Key& key) const
+  {
+    const stripe_t&             s = get_stripe(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.map.count(key) > 0;
+  }
+
+  /// Calls f(T&) on the value of the key, holding the lock of its stripe. Returns false if the key does not exist
+  template <typename F>
+  bool visit(const Key& key, F&& f)
+  {
+    stripe_t&                   s = get_stripe(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto                        it = s.map.find(key);
+    if (it == s.map.end()) {
+      return false;
+    }
+    f(it->second);
+    return true;
+  }
+
+  /// Removes the key. Returns false if it does not exist
+  bool erase(const Key& key)
+  {
+    stripe_t&                   s = get_stripe(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.map.erase(key) > 0;
+  }
+
+  /// Calls f(const Key&, T&) for each entry, one stripe at a time. f must not access the table
+  template <typename F>
+  void for_each(F&& f)
+  {
+    for (uint32_t i = 0; i < nof_stripes; ++i) {
+      std::lock_guard<std::mutex> lock(stripes[i].mutex);
+      for (auto& kv : stripes[i].map) {
+        f(kv.first, kv.second);
+      }
+    }
+  }
+
+  void clear()
+  {
+    for (uint32_t i = 0; i < nof_stripes; ++i) {
+      std::lock_guard<std::mutex> lock(stripes[i].mutex);
+      stripes[i].map.clear();
+    }
+  }
+
+  size_t size() const
+  {
+    size_t n = 0;
+    for (uint32_t i = 0; i < nof_stripes; ++i) {
+      std::lock_guard<std::mutex> lock(stripes[i].mutex);
+      n += stripes[i].map.size();
+    }
+    return n;
+  }
+
+private:
+  struct stripe_t {
+    mutable std::mutex         mutex;
+    std::unordered_map<Key, T> map;
+  };
+
+  stripe_t&       get_stripe(const Key& key) { return stripes[ue_id_hash(key) % nof_stripes]; }
+  const stripe_t& get_stripe(const Key& key) const { return stripes[ue_id_hash(key) % nof_stripes]; }
+
+  std::unique_ptr<stripe_t[]> stripes;
+};
+
+} // namespace srsepc
+#endif // SRSEPC_UE_CTX_TABLE_H
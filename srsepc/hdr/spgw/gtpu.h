@@ -22,6 +22,7 @@
 #ifndef SRSEPC_GTPU_H
 #define SRSEPC_GTPU_H
 
+#include "srsepc/hdr/spgw/gtpu_tunnel_table.h"
 #include "srsepc/hdr/spgw/spgw.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/buffer_pool.h"
@@ -29,7 +30,9 @@
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 namespace srsepc {
 
@@ -41,14 +44,19 @@ public:
   int  init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc);
   void stop();
 
-  int init_sgi(spgw_args_t* args);
-  int init_s1u(spgw_args_t* args);
-  int get_sgi();
-  int get_s1u();
+  int      init_sgi(spgw_args_t* args);
+  int      init_s1u(spgw_args_t* args);
+  int      get_sgi(uint32_t worker_idx = 0);
+  int      get_s1u(uint32_t worker_idx = 0);
+  int      get_dl_notification_fd();
+  uint32_t get_nof_workers();
 
-  void handle_sgi_pdu(srsran::unique_byte_buffer_t msg);
-  void handle_s1u_pdu(srsran::byte_buffer_t* msg);
-  void send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg);
+  void handle_sgi_rx(uint32_t worker_idx = 0);
+  void handle_s1u_rx(srsran::byte_buffer_t* msg, uint32_t worker_idx = 0);
+  void handle_sgi_pdu(srsran::unique_byte_buffer_t msg, uint32_t worker_idx = 0);
+  void handle_s1u_pdu(srsran::byte_buffer_t* msg, uint32_t worker_idx = 0);
+  void send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg, uint32_t worker_idx = 0);
+  void handle_pending_dl_notifications();
 
   virtual in_addr_t get_s1u_addr();
 
@@ -61,29 +69,48 @@ public:
   spgw*                m_spgw;
   gtpc_interface_gtpu* m_gtpc;
 
-  bool m_sgi_up;
-  int  m_sgi;
+  uint32_t m_nof_workers;
 
-  bool        m_s1u_up;
-  int         m_s1u;
-  sockaddr_in m_s1u_addr;
+  bool             m_sgi_up;
+  int              m_sgi;
+  std::vector<int> m_sgi_queues; // One TUN queue per user plane worker. The first one is m_sgi
 
-  std::map<in_addr_t, srsran::gtp_fteid_t> m_ip_to_usr_teid; // Map IP to User-plane TEID for downlink traffic
-  std::map<in_addr_t, uint32_t>            m_ip_to_ctr_teid; // IP to control TEID map. Important to check if
-                                                             // UE is attached without an active user-plane
-                                                             // for downlink notifications.
+  bool             m_s1u_up;
+  int              m_s1u;
+  std::vector<int> m_s1u_socks; // One SO_REUSEPORT socket per user plane worker. The first one is m_s1u
+  sockaddr_in      m_s1u_addr;
+
+  // Maps UE IP to the User-plane TEID for downlink traffic, and to the control TEID. The latter is important to check
+  // if UE is attached without an active user-plane for downlink notifications.
+  gtpu_tunnel_table m_tunnels;
+
+  // SGi PDUs of UEs that are not ECM connected, received by the user plane workers. They are handed over to the
+  // S11 thread, which owns the GTP-C state, via an eventfd.
+  std::mutex                                                      m_dl_notif_mutex;
+  std::vector<std::pair<uint32_t, srsran::unique_byte_buffer_t> > m_dl_notif_pdus;
+  int                                                             m_dl_notif_fd;
 
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("GTPU");
 };
 
-inline int spgw::gtpu::get_sgi()
+inline int spgw::gtpu::get_sgi(uint32_t worker_idx)
+{
+  return m_sgi_queues[worker_idx];
+}
+
+inline int spgw::gtpu::get_s1u(uint32_t worker_idx)
 {
-  return m_sgi;
+  return m_s1u_socks[worker_idx];
 }
 
-inline int spgw::gtpu::get_s1u()
+inline int spgw::gtpu::get_dl_notification_fd()
 {
-  return m_s1u;
+  return m_dl_notif_fd;
+}
+
+inline uint32_t spgw::gtpu::get_nof_workers()
+{
+  return m_nof_workers;
 }
 
 inline in_addr_t spgw::gtpu::get_s1u_addr()
@@ -91,5 +118,25 @@ inline in_addr_t spgw::gtpu::get_s1u_addr()
   return m_s1u_addr.sin_addr.s_addr;
 }
 
+/**
+ * User plane worker thread. It serves one SGi TUN queue and one S1-U socket, so that the downlink traffic is spread
+ * across workers by the TUN flow hash, and the uplink traffic is spread by TEID.
+ */
+class spgw::gtpu_worker : public srsran::thread
+{
+public:
+  gtpu_worker(spgw::gtpu* gtpu, uint32_t worker_idx);
+  void stop();
+
+private:
+  void run_thread() override;
+
+  spgw::gtpu*       m_gtpu;
+  uint32_t          m_worker_idx;
+  std::atomic<bool> m_running;
+
+  srslog::basic_logger& m_logger = srslog::fetch_basic_logger("GTPU");
+};
+
 } // namespace srsepc
 #endif // SRSEPC_GTPU_H
@@ -0,0 +1,194 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        gtpu_tunnel_table.h
+ * Description: UE IP to GTP tunnel table of the SP-GW user plane. Lookups
+ *              are lock-free, so that several user plane workers can query
+ *              it while the S11 thread adds and removes tunnels.
+ *****************************************************************************/
+
+#ifndef SRSEPC_GTPU_TUNNEL_TABLE_H
+#define SRSEPC_GTPU_TUNNEL_TABLE_H
+
+#include "srsran/asn1/gtpc_ies.h"
+#include <atomic>
+#include <memory>
+#include <netinet/in.h>
+
+namespace srsepc {
+
+/**
+ * Open addressing hash table that maps UE IPv4 addresses to the downlink user plane F-TEID and to the uplink control
+ * TEID of the UE.
+ * - find() is wait-free as long as there is no concurrent update of the same UE entry. Each entry is protected by a
+ *   sequence lock, so readers retry instead of blocking the writer.
+ * - All the update methods must be called from a single thread (the S11 thread).
+ * Slots are never released once a UE IP is inserted. Since UE IPs are taken from a bounded pool, this keeps probe
+ * chains intact without tombstones. The capacity must be a power of 2 and larger than the UE IP pool.
+ */
+class gtpu_tunnel_table
+{
+public:
+  struct tunnel_info {
+    bool                usr_found = false;
+    srsran::gtp_fteid_t usr_fteid = {};
+    bool                ctr_found = false;
+    uint32_t            ctr_teid  = 0;
+  };
+
+  explicit gtpu_tunnel_table(uint32_t capacity_ = 1U << 16U) : capacity(capacity_), entries(new entry_t[capacity_]) {}
+
+  tunnel_info find(in_addr_t ue_ipv4) const
+  {
+    tunnel_info    ret;
+    const entry_t* e = find_entry(ue_ipv4);
+    if (e == nullptr) {
+      return ret;
+    }
+    uint32_t seq0, seq1;
+    do {
+      seq0 = e->seq.load(std::memory_order_acquire);
+      if ((seq0 & 1U) != 0) {
+        // writer in progress
+        continue;
+      }
+      uint8_t flags      = e->flags.load(std::memory_order_relaxed);
+      ret.usr_found      = (flags & usr_flag) != 0;
+      ret.ctr_found      = (flags & ctr_flag) != 0;
+      ret.usr_fteid.teid = e->usr_teid.load(std::memory_order_relaxed);
+      ret.usr_fteid.ipv4 = e->usr_ipv4.load(std::memory_order_relaxed);
+      ret.ctr_teid       = e->ctr_teid.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      seq1 = e->seq.load(std::memory_order_relaxed);
+    } while ((seq0 & 1U) != 0 or seq0 != seq1);
+    return ret;
+  }
+
+  bool set_tunnel(in_addr_t ue_ipv4, const srsran::gtp_fteid_t& usr_fteid, uint32_t ctr_teid)
+  {
+    entry_t* e = find_or_insert_entry(ue_ipv4);
+    if (e == nullptr) {
+      return false;
+    }
+    write_begin(*e);
+    e->usr_teid.store(usr_fteid.teid, std::memory_order_relaxed);
+    e->usr_ipv4.store(usr_fteid.ipv4, std::memory_order_relaxed);
+    e->ctr_teid.store(ctr_teid, std::memory_order_relaxed);
+    e->flags.store(usr_flag | ctr_flag, std::memory_order_relaxed);
+    write_end(*e);
+    return true;
+  }
+
+  /// Removes the user plane tunnel of the UE. Returns false if there was none
+  bool erase_usr(in_addr_t ue_ipv4) { return clear_flag(ue_ipv4, usr_flag); }
+
+  /// Removes the control TEID of the UE. Returns false if there was none
+  bool erase_ctr(in_addr_t ue_ipv4) { return clear_flag(ue_ipv4, ctr_flag); }
+
+private:
+  static const in_addr_t empty_key = 0; ///< 0.0.0.0 is never assigned to an UE
+  static const uint8_t   usr_flag  = 0x1;
+  static const uint8_t   ctr_flag  = 0x2;
+
+  struct entry_t {
+    std::atomic<in_addr_t> ue_ipv4{empty_key};
+    std::atomic<uint32_t>  seq{0};
+    std::atomic<uint8_t>   flags{0};
+    std::atomic<uint32_t>  usr_teid{0};
+    std::atomic<uint32_t>  usr_ipv4{0};
+    std::atomic<uint32_t>  ctr_teid{0};
+  };
+
+  uint32_t slot_of(in_addr_t ue_ipv4) const
+  {
+    // UE IPs are consecutive, and differ mostly in the least significant bits (most significant in network order)
+    uint32_t h = ntohl(ue_ipv4);
+    h ^= h >> 16U;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16U;
+    return h & (capacity - 1);
+  }
+
+  const entry_t* find_entry(in_addr_t ue_ipv4) const
+  {
+    if (ue_ipv4 == empty_key) {
+      return nullptr;
+    }
+    uint32_t slot = slot_of(ue_ipv4);
+    for (uint32_t i = 0; i < capacity; ++i, slot = (slot + 1) & (capacity - 1)) {
+      in_addr_t key = entries[slot].ue_ipv4.load(std::memory_order_acquire);
+      if (key == ue_ipv4) {
+        return &entries[slot];
+      }
+      if (key == empty_key) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  entry_t* find_or_insert_entry(in_addr_t ue_ipv4)
+  {
+    if (ue_ipv4 == empty_key) {
+      return nullptr;
+    }
+    uint32_t slot = slot_of(ue_ipv4);
+    for (uint32_t i = 0; i < capacity; ++i, slot = (slot + 1) & (capacity - 1)) {
+      in_addr_t key = entries[slot].ue_ipv4.load(std::memory_order_relaxed);
+      if (key == ue_ipv4) {
+        return &entries[slot];
+      }
+      if (key == empty_key) {
+        // The entry fields are still zero, so readers that see the new key will report the tunnel as not found
+        entries[slot].ue_ipv4.store(ue_ipv4, std::memory_order_release);
+        return &entries[slot];
+      }
+    }
+    return nullptr;
+  }
+
+  bool clear_flag(in_addr_t ue_ipv4, uint8_t flag)
+  {
+    entry_t* e = const_cast<entry_t*>(find_entry(ue_ipv4));
+    if (e == nullptr or (e->flags.load(std::memory_order_relaxed) & flag) == 0) {
+      return false;
+    }
+    write_begin(*e);
+    e->flags.store(e->flags.load(std::memory_order_relaxed) & ~flag, std::memory_order_relaxed);
+    write_end(*e);
+    return true;
+  }
+
+  static void write_begin(entry_t& e)
+  {
+    e.seq.store(e.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  static void write_end(entry_t& e) { e.seq.store(e.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  const uint32_t             capacity;
+  std::unique_ptr<entry_t[]> entries;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_GTPU_TUNNEL_TABLE_H
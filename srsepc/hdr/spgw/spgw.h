@@ -33,7 +33,9 @@
 #include "srsran/common/threads.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
+#include <memory>
 #include <queue>
+#include <vector>
 
 namespace srsepc {
 
@@ -46,6 +48,7 @@ typedef struct {
   std::string sgi_if_addr;
   std::string sgi_if_name;
   uint32_t    max_paging_queue;
+  uint32_t    nof_up_workers;
 } spgw_args_t;
 
 typedef struct spgw_tunnel_ctx {
@@ -64,6 +67,7 @@ class spgw : public srsran::thread
 {
   class gtpc;
   class gtpu;
+  class gtpu_worker;
 
 public:
   static spgw* get_instance(void);
@@ -87,6 +91,9 @@ private:
   gtpc* m_gtpc;
   gtpu* m_gtpu;
 
+  // User plane workers. If empty, the user plane is served by the SP-GW thread itself
+  std::vector<std::unique_ptr<gtpu_worker> > m_gtpu_workers;
+
   // Logs
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("SPGW");
 };
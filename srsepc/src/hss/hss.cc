@@ -23,7 +23,6 @@
 #include "srsran/common/string_helpers.h"
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
-#include <iomanip>
 #include <sstream>
 #include <stdlib.h> /* srand, rand */
 #include <string>
@@ -77,9 +76,19 @@ int hss::init(hss_args_t* hss_args)
   mcc = hss_args->mcc;
   mnc = hss_args->mnc;
 
+  m_auth_vector_batch = hss_args->auth_vector_batch;
+  if (m_auth_vector_batch == 0 || m_auth_vector_batch > max_auth_vector_batch) {
+    m_logger.warning("Invalid auth_vector_batch %d. Using 1", hss_args->auth_vector_batch);
+    m_auth_vector_batch = 1;
+  }
+
   db_file = hss_args->db_file;
 
-  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d", hss_args->db_file.c_str(), mcc, mnc);
+  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d, auth vector batch: %d",
+                hss_args->db_file.c_str(),
+                mcc,
+                mnc,
+                m_auth_vector_batch);
   srsran::console("HSS Initialized.\n");
   return 0;
 }
@@ -87,171 +96,25 @@ int hss::init(hss_args_t* hss_args)
 void hss::stop()
 {
   write_db_file(db_file);
+  m_db.close();
   return;
 }
 
 bool hss::read_db_file(std::string db_filename)
 {
-  std::ifstream m_db_file;
-
-  m_db_file.open(db_filename.c_str(), std::ifstream::in);
-  if (!m_db_file.is_open()) {
-    return false;
+  if (hss_db::is_binary(db_filename)) {
+    return m_db.open_binary(db_filename);
   }
-  m_logger.info("Opened DB file: %s", db_filename.c_str());
-
-  std::string line;
-  while (std::getline(m_db_file, line)) {
-    if (line[0] != '#' && line.length() > 0) {
-      uint                     column_size = 10;
-      std::vector<std::string> split       = srsran::split_string(line, ',');
-      if (split.size() != column_size) {
-        m_logger.error("Error parsing UE database. Wrong number of columns in .csv");
-        m_logger.error("Columns: %zd, Expected %d.", split.size(), column_size);
-
-        srsran::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
-        srsran::console("Perhaps you are using an old user_db.csv?\n");
-        srsran::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
-        return false;
-      }
-      std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
-      ue_ctx->name                         = split[0];
-      if (split[1] == std::string("xor")) {
-        ue_ctx->algo = HSS_ALGO_XOR;
-      } else if (split[1] == std::string("mil")) {
-        ue_ctx->algo = HSS_ALGO_MILENAGE;
-      } else {
-        m_logger.error("Neither XOR nor MILENAGE configured.");
-        return false;
-      }
-      ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
-      srsran::get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
-      if (split[4] == std::string("op")) {
-        ue_ctx->op_configured = true;
-        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
-        srsran::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
-      } else if (split[4] == std::string("opc")) {
-        ue_ctx->op_configured = false;
-        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
-      } else {
-        m_logger.error("Neither OP nor OPc configured.");
-        return false;
-      }
-      srsran::get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
-      srsran::get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
-
-      m_logger.debug("Added user from DB, IMSI: %015" PRIu64 "", ue_ctx->imsi);
-      m_logger.debug(ue_ctx->key, 16, "User Key : ");
-      if (ue_ctx->op_configured) {
-        m_logger.debug(ue_ctx->op, 16, "User OP : ");
-      }
-      m_logger.debug(ue_ctx->opc, 16, "User OPc : ");
-      m_logger.debug(ue_ctx->amf, 2, "AMF : ");
-      m_logger.debug(ue_ctx->sqn, 6, "SQN : ");
-      ue_ctx->qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
-      m_logger.debug("Default Bearer QCI: %d", ue_ctx->qci);
-
-      if (split[9] == std::string("dynamic")) {
-        ue_ctx->static_ip_addr = "0.0.0.0";
-      } else {
-        char buf[128] = {0};
-        if (inet_pton(AF_INET, split[9].c_str(), buf)) {
-          if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
-            ue_ctx->static_ip_addr = split[9];
-            m_logger.info("static ip addr %s", ue_ctx->static_ip_addr.c_str());
-          } else {
-            m_logger.info("duplicate static ip addr %s", split[9].c_str());
-            return false;
-          }
-        } else {
-          m_logger.info("invalid static ip addr %s, %s", split[9].c_str(), strerror(errno));
-          return false;
-        }
-      }
-      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
-    }
-  }
-
-  if (m_db_file.is_open()) {
-    m_db_file.close();
-  }
-
-  return true;
+  return m_db.load_csv(db_filename);
 }
 
 bool hss::write_db_file(std::string db_filename)
 {
-  std::string line;
-  uint8_t     k[16];
-  uint8_t     amf[2];
-  uint8_t     op[16];
-  uint8_t     sqn[6];
-
-  std::ofstream m_db_file;
-
-  m_db_file.open(db_filename.c_str(), std::ofstream::out);
-  if (!m_db_file.is_open()) {
-    return false;
+  // The binary store is kept up to date by its SQN journal
+  if (m_db.is_binary()) {
+    return true;
   }
-  m_logger.info("Opened DB file: %s", db_filename.c_str());
-
-  // Write comment info
-  m_db_file << "#                                                                                           \n"
-            << "# .csv to store UE's information in HSS                                                     \n"
-            << "# Kept in the following format: \"Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc\"  \n"
-            << "#                                                                                           \n"
-            << "# Name:     Human readable name to help distinguish UE's. Ignored by the HSS                \n"
-            << "# Auth:     Authentication algorithm used by the UE. Valid algorithms are XOR               \n"
-            << "#           (xor) and MILENAGE (mil)                                                        \n"
-            << "# IMSI:     UE's IMSI value                                                                 \n"
-            << "# Key:      UE's key, where other keys are derived from. Stored in hexadecimal              \n"
-            << "# OP_Type:  Operator's code type, either OP or OPc                                          \n"
-            << "# OP/OPc:   Operator Code/Cyphered Operator Code, stored in hexadecimal                     \n"
-            << "# AMF:      Authentication management field, stored in hexadecimal                          \n"
-            << "# SQN:      UE's Sequence number for freshness of the authentication                        \n"
-            << "# QCI:      QoS Class Identifier for the UE's default bearer.                               \n"
-            << "# IP_alloc: IP allocation stratagy for the SPGW.                                            \n"
-            << "#           With 'dynamic' the SPGW will automatically allocate IPs                         \n"
-            << "#           With a valid IPv4 (e.g. '172.16.0.2') the UE will have a statically assigned IP.\n"
-            << "#                                                                                           \n"
-            << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
-
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
-  while (it != m_imsi_to_ue_ctx.end()) {
-    m_db_file << it->second->name;
-    m_db_file << ",";
-    m_db_file << (it->second->algo == HSS_ALGO_XOR ? "xor" : "mil");
-    m_db_file << ",";
-    m_db_file << std::setfill('0') << std::setw(15) << it->second->imsi;
-    m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->key, 16);
-    m_db_file << ",";
-    if (it->second->op_configured) {
-      m_db_file << "op,";
-      m_db_file << srsran::hex_string(it->second->op, 16);
-    } else {
-      m_db_file << "opc,";
-      m_db_file << srsran::hex_string(it->second->opc, 16);
-    }
-    m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->amf, 2);
-    m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->sqn, 6);
-    m_db_file << ",";
-    m_db_file << it->second->qci;
-    if (it->second->static_ip_addr != "0.0.0.0") {
-      m_db_file << ",";
-      m_db_file << it->second->static_ip_addr;
-    } else {
-      m_db_file << ",dynamic";
-    }
-    m_db_file << std::endl;
-    it++;
-  }
-  if (m_db_file.is_open()) {
-    m_db_file.close();
-  }
-  return true;
+  return m_db.write_csv(db_filename);
 }
 
 bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
@@ -268,75 +131,123 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
       gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
-      break;
+      return increment_ue_sqn(ue_ctx);
     case HSS_ALGO_MILENAGE:
-      gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
-      break;
+      // The SQN is advanced when the vectors are generated
+      return gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
   }
-  increment_ue_sqn(ue_ctx);
   return true;
 }
 
-void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
+bool hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
                                         uint8_t*      k_asme,
                                         uint8_t*      autn,
                                         uint8_t*      rand,
                                         uint8_t*      xres)
 {
-  // Get K, AMF, OPC and SQN
-  uint8_t* k   = ue_ctx->key;
-  uint8_t* amf = ue_ctx->amf;
-  uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
-
-  // Temp variables
-  uint8_t ck[16];
-  uint8_t ik[16];
-  uint8_t ak[6];
-  uint8_t mac[8];
-
-  gen_rand(rand);
+  milenage_vector_t vector;
+  if (not pop_milenage_vector(ue_ctx->imsi, vector)) {
+    // Generated and journaled without holding the stash lock, so that the AIRs of other subscribers go on meanwhile
+    milenage_vector_t vectors[max_auth_vector_batch];
+    if (not gen_milenage_vectors(ue_ctx, vectors)) {
+      return false;
+    }
+    vector = vectors[0];
+    if (m_auth_vector_batch > 1) {
+      std::lock_guard<std::mutex>     lock(m_milenage_mutex);
+      std::vector<milenage_vector_t>& stash = m_milenage_stash[ue_ctx->imsi];
+      for (uint32_t i = m_auth_vector_batch - 1; i > 0; i--) {
+        stash.push_back(vectors[i]);
+      }
+    }
+  }
 
-  srsran::security_milenage_f2345(k, opc, rand, xres, ck, ik, ak);
+  uint8_t*                         amf = ue_ctx->amf;
+  uint8_t*                         sqn = vector.sqn;
+  const srsran::milenage_output_t& out = vector.out;
+  memcpy(rand, vector.rand, 16);
+  memcpy(xres, out.res, 8);
 
-  m_logger.debug(k, 16, "User Key : ");
-  m_logger.debug(opc, 16, "User OPc : ");
+  m_logger.debug(ue_ctx->key, 16, "User Key : ");
+  m_logger.debug(ue_ctx->opc, 16, "User OPc : ");
   m_logger.debug(rand, 16, "User Rand : ");
   m_logger.debug(xres, 8, "User XRES: ");
-  m_logger.debug(ck, 16, "User CK: ");
-  m_logger.debug(ik, 16, "User IK: ");
-  m_logger.debug(ak, 6, "User AK: ");
-
-  srsran::security_milenage_f1(k, opc, rand, sqn, amf, mac);
-
+  m_logger.debug(out.ck, 16, "User CK: ");
+  m_logger.debug(out.ik, 16, "User IK: ");
+  m_logger.debug(out.ak, 6, "User AK: ");
   m_logger.debug(sqn, 6, "User SQN : ");
-  m_logger.debug(mac, 8, "User MAC : ");
+  m_logger.debug(out.mac_a, 8, "User MAC : ");
 
   uint8_t ak_xor_sqn[6];
   for (int i = 0; i < 6; i++) {
-    ak_xor_sqn[i] = sqn[i] ^ ak[i];
+    ak_xor_sqn[i] = sqn[i] ^ out.ak[i];
   }
   // Generate K_asme
-  srsran::security_generate_k_asme(ck, ik, ak_xor_sqn, mcc, mnc, k_asme);
+  srsran::security_generate_k_asme(out.ck, out.ik, ak_xor_sqn, mcc, mnc, k_asme);
 
   m_logger.debug("User MCC : %x  MNC : %x ", mcc, mnc);
   m_logger.debug(k_asme, 32, "User k_asme : ");
 
   // Generate AUTN (autn = sqn ^ ak |+| amf |+| mac)
   for (int i = 0; i < 6; i++) {
-    autn[i] = sqn[i] ^ ak[i];
+    autn[i] = sqn[i] ^ out.ak[i];
   }
   for (int i = 0; i < 2; i++) {
     autn[6 + i] = amf[i];
   }
   for (int i = 0; i < 8; i++) {
-    autn[8 + i] = mac[i];
+    autn[8 + i] = out.mac_a[i];
   }
   m_logger.debug(autn, 16, "User AUTN: ");
 
   // Set last RAND
   ue_ctx->set_last_rand(rand);
-  return;
+  return true;
+}
+
+bool hss::pop_milenage_vector(uint64_t imsi, milenage_vector_t& vector)
+{
+  std::lock_guard<std::mutex> lock(m_milenage_mutex);
+  auto                        it = m_milenage_stash.find(imsi);
+  if (it == m_milenage_stash.end()) {
+    return false;
+  }
+  vector = it->second.back();
+  it->second.pop_back();
+  if (it->second.empty()) {
+    m_milenage_stash.erase(it);
+  }
+  return true;
+}
+
+bool hss::gen_milenage_vectors(hss_ue_ctx_t* ue_ctx, milenage_vector_t* vectors)
+{
+  // Consecutive SQNs from the current one. The stored SQN moves past all of them with a single journal entry
+  uint8_t sqn[6];
+  memcpy(sqn, ue_ctx->sqn, 6);
+  const srsran::milenage_key& key = m_db.get_milenage_key(*ue_ctx);
+  srsran::milenage_input_t    in[max_auth_vector_batch];
+  srsran::milenage_output_t   out[max_auth_vector_batch];
+  for (uint32_t i = 0; i < m_auth_vector_batch; i++) {
+    gen_rand(vectors[i].rand);
+    memcpy(vectors[i].sqn, ue_ctx->sqn, 6);
+    increment_sqn(ue_ctx->sqn, ue_ctx->sqn);
+    in[i] = {&key, ue_ctx->opc, vectors[i].rand, vectors[i].sqn, ue_ctx->amf};
+  }
+  if (not m_db.sqn_updated(*ue_ctx)) {
+    // None of the vectors is handed out, so their SQNs are used again
+    ue_ctx->set_sqn(sqn);
+    m_logger.error("Could not store the SQN of IMSI: %015" PRIu64 "", ue_ctx->imsi);
+    return false;
+  }
+
+  srsran::milenage_f12345_batch(in, out, m_auth_vector_batch);
+  for (uint32_t i = 0; i < m_auth_vector_batch; i++) {
+    vectors[i].out = out[i];
+  }
+  m_logger.debug("Generated %d Milenage vectors -- IMSI: %015" PRIu64 "", m_auth_vector_batch, ue_ctx->imsi);
+  m_logger.debug(ue_ctx->sqn, 6, "SQN: ");
+  return true;
 }
 
 void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
@@ -440,13 +351,12 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
 
 bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+  const hss_ue_ctx_t* ue_ctx = m_db.find(imsi);
+  if (ue_ctx == nullptr) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
     srsran::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     return false;
   }
-  const std::unique_ptr<hss_ue_ctx_t>& ue_ctx = ue_ctx_it->second;
   m_logger.info("Found User %015" PRIu64 "", imsi);
   *qci = ue_ctx->qci;
   return true;
@@ -462,6 +372,8 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
     return false;
   }
 
+  uint8_t sqn[6];
+  memcpy(sqn, ue_ctx->sqn, 6);
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
       resync_sqn_xor(ue_ctx, auts);
@@ -471,8 +383,16 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
       break;
   }
 
-  increment_seq_after_resync(ue_ctx);
-  return true;
+  bool ret = increment_seq_after_resync(ue_ctx);
+  if (not ret) {
+    ue_ctx->set_sqn(sqn);
+    m_logger.error("Could not store the SQN of IMSI: %015" PRIu64 "", imsi);
+  }
+
+  // Vectors generated before the resynchronization carry stale SQNs
+  std::lock_guard<std::mutex> lock(m_milenage_mutex);
+  m_milenage_stash.erase(imsi);
+  return ret;
 }
 
 void hss::resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
@@ -535,11 +455,20 @@ void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
   return;
 }
 
-void hss::increment_ue_sqn(hss_ue_ctx_t* ue_ctx)
+bool hss::increment_ue_sqn(hss_ue_ctx_t* ue_ctx)
 {
+  uint8_t sqn[6];
+  memcpy(sqn, ue_ctx->sqn, 6);
   increment_sqn(ue_ctx->sqn, ue_ctx->sqn);
+  if (not m_db.sqn_updated(*ue_ctx)) {
+    // The vector that used the SQN is not handed out
+    ue_ctx->set_sqn(sqn);
+    m_logger.error("Could not store the SQN of IMSI: %015" PRIu64 "", ue_ctx->imsi);
+    return false;
+  }
   m_logger.debug("Incremented SQN  -- IMSI: %015" PRIu64 "", ue_ctx->imsi);
   m_logger.debug(ue_ctx->sqn, 6, "SQN: ");
+  return true;
 }
 
 void hss::increment_sqn(uint8_t* sqn, uint8_t* next_sqn)
@@ -572,7 +501,7 @@ void hss::increment_sqn(uint8_t* sqn, uint8_t* next_sqn)
   return;
 }
 
-void hss::increment_seq_after_resync(hss_ue_ctx_t* ue_ctx)
+bool hss::increment_seq_after_resync(hss_ue_ctx_t* ue_ctx)
 {
   // This function only increment the SEQ part of the SQN for resynchronization purpose
   uint8_t* sqn = ue_ctx->sqn;
@@ -599,7 +528,7 @@ void hss::increment_seq_after_resync(hss_ue_ctx_t* ue_ctx)
   for (int i = 0; i < 6; i++) {
     sqn[i] = (nextsqn >> (5 - i) * 8) & 0xFF;
   }
-  return;
+  return m_db.sqn_updated(*ue_ctx);
 }
 
 void hss::gen_rand(uint8_t rand_[16])
@@ -612,18 +541,18 @@ void hss::gen_rand(uint8_t rand_[16])
 
 hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+  hss_ue_ctx_t* ue_ctx = m_db.find(imsi);
+  if (ue_ctx == nullptr) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
     return nullptr;
   }
 
-  return ue_ctx_it->second.get();
+  return ue_ctx;
 }
 
 std::map<std::string, uint64_t> hss::get_ip_to_imsi(void) const
 {
-  return m_ip_to_imsi;
+  return m_db.get_ip_to_imsi();
 }
 
 } // namespace srsepc
@@ -0,0 +1,661 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srsran/common/security.h"
+#include "srsran/common/standard_streams.h"
+#include "srsran/common/string_helpers.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstddef>
+#include <fcntl.h>
+#include <fstream>
+#include <inttypes.h> // for printing uint64_t
+#include <iomanip>
+#include <libgen.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace srsepc {
+
+/// Header of the binary store. All the fields, and the records, are in host byte order
+struct hss_db_header_t {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t nof_records;
+  uint64_t nof_buckets;
+  uint64_t nof_static_ips;
+  uint64_t records_offset;
+  uint64_t buckets_offset;
+  uint64_t static_ips_offset;
+};
+static_assert(sizeof(hss_db_header_t) == 64, "Unexpected binary store header size");
+
+struct hss_db_static_ip_t {
+  uint64_t imsi;
+  uint32_t ipv4;
+  uint32_t reserved;
+};
+
+const size_t   hss_ue_ctx_t::max_name_len;
+const uint32_t hss_db::compact_nof_entries;
+
+static const char     hss_db_magic[8] = {'S', 'R', 'S', 'H', 'S', 'S', 'D', 'B'};
+static const uint32_t hss_db_version  = 1;
+
+static uint64_t imsi_hash(uint64_t imsi)
+{
+  // MurmurHash3 finalizer. IMSIs are mostly consecutive, and only differ in the low digits
+  imsi ^= imsi >> 33U;
+  imsi *= 0xff51afd7ed558ccdULL;
+  imsi ^= imsi >> 33U;
+  return imsi;
+}
+
+static bool write_all(int fd, const void* data, size_t len)
+{
+  const uint8_t* ptr = static_cast<const uint8_t*>(data);
+  while (len > 0) {
+    ssize_t n = ::write(fd, ptr, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += n;
+    len -= n;
+  }
+  return true;
+}
+
+/// Makes the creation, removal or renaming of a file durable
+static bool sync_parent_dir(const std::string& filename)
+{
+  std::vector<char> path(filename.begin(), filename.end());
+  path.push_back('\0');
+  int fd = ::open(dirname(path.data()), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ret = fsync(fd) == 0;
+  ::close(fd);
+  return ret;
+}
+
+hss_db::~hss_db()
+{
+  close();
+}
+
+bool hss_db::is_binary(const std::string& filename)
+{
+  std::ifstream file(filename, std::ifstream::binary);
+  char          magic[sizeof(hss_db_magic)] = {};
+  return file.read(magic, sizeof(magic)) and memcmp(magic, hss_db_magic, sizeof(magic)) == 0;
+}
+
+bool hss_db::load_csv(const std::string& filename)
+{
+  std::ifstream m_db_file;
+
+  m_db_file.open(filename.c_str(), std::ifstream::in);
+  if (!m_db_file.is_open()) {
+    return false;
+  }
+  logger.info("Opened DB file: %s", filename.c_str());
+
+  std::string line;
+  while (std::getline(m_db_file, line)) {
+    if (line[0] != '#' && line.length() > 0) {
+      uint                     column_size = 10;
+      std::vector<std::string> split       = srsran::split_string(line, ',');
+      if (split.size() != column_size) {
+        logger.error("Error parsing UE database. Wrong number of columns in .csv");
+        logger.error("Columns: %zd, Expected %d.", split.size(), column_size);
+
+        srsran::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
+        srsran::console("Perhaps you are using an old user_db.csv?\n");
+        srsran::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
+        return false;
+      }
+      hss_ue_ctx_t ue_ctx = {};
+      if (split[0].size() > hss_ue_ctx_t::max_name_len) {
+        logger.warning("Truncating UE name %s to %zd characters", split[0].c_str(), hss_ue_ctx_t::max_name_len);
+      }
+      ue_ctx.set_name(split[0]);
+      if (split[1] == std::string("xor")) {
+        ue_ctx.algo = HSS_ALGO_XOR;
+      } else if (split[1] == std::string("mil")) {
+        ue_ctx.algo = HSS_ALGO_MILENAGE;
+      } else {
+        logger.error("Neither XOR nor MILENAGE configured.");
+        return false;
+      }
+      ue_ctx.imsi = strtoull(split[2].c_str(), nullptr, 10);
+      srsran::get_uint_vec_from_hex_str(split[3], ue_ctx.key, 16);
+      if (split[4] == std::string("op")) {
+        ue_ctx.op_configured = true;
+        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx.op, 16);
+        srsran::compute_opc(ue_ctx.key, ue_ctx.op, ue_ctx.opc);
+      } else if (split[4] == std::string("opc")) {
+        ue_ctx.op_configured = false;
+        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx.opc, 16);
+      } else {
+        logger.error("Neither OP nor OPc configured.");
+        return false;
+      }
+      srsran::get_uint_vec_from_hex_str(split[6], ue_ctx.amf, 2);
+      srsran::get_uint_vec_from_hex_str(split[7], ue_ctx.sqn, 6);
+
+      logger.debug("Added user from DB, IMSI: %015" PRIu64 "", ue_ctx.imsi);
+      logger.debug(ue_ctx.key, 16, "User Key : ");
+      if (ue_ctx.op_configured) {
+        logger.debug(ue_ctx.op, 16, "User OP : ");
+      }
+      logger.debug(ue_ctx.opc, 16, "User OPc : ");
+      logger.debug(ue_ctx.amf, 2, "AMF : ");
+      logger.debug(ue_ctx.sqn, 6, "SQN : ");
+      ue_ctx.qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
+      logger.debug("Default Bearer QCI: %d", ue_ctx.qci);
+
+      if (split[9] != std::string("dynamic")) {
+        in_addr addr = {};
+        if (inet_pton(AF_INET, split[9].c_str(), &addr)) {
+          if (ip_to_imsi.insert(std::make_pair(split[9], ue_ctx.imsi)).second) {
+            ue_ctx.static_ip = addr.s_addr;
+            logger.info("static ip addr %s", split[9].c_str());
+          } else {
+            logger.info("duplicate static ip addr %s", split[9].c_str());
+            return false;
+          }
+        } else {
+          logger.info("invalid static ip addr %s, %s", split[9].c_str(), strerror(errno));
+          return false;
+        }
+      }
+      csv_records.push_back(ue_ctx);
+    }
+  }
+
+  // Kept sorted by IMSI, and with the first entry of each IMSI, as when the users were stored in a std::map
+  std::stable_sort(csv_records.begin(), csv_records.end(), [](const hss_ue_ctx_t& lhs, const hss_ue_ctx_t& rhs) {
+    return lhs.imsi < rhs.imsi;
+  });
+  auto last =
+      std::unique(csv_records.begin(), csv_records.end(), [](const hss_ue_ctx_t& lhs, const hss_ue_ctx_t& rhs) {
+        return lhs.imsi == rhs.imsi;
+      });
+  if (last != csv_records.end()) {
+    logger.warning("Ignoring %zd users with a duplicate IMSI", (size_t)(csv_records.end() - last));
+    csv_records.erase(last, csv_records.end());
+  }
+
+  records     = csv_records.data();
+  nof_records = csv_records.size();
+  expand_keys();
+  return build_index();
+}
+
+bool hss_db::build_index()
+{
+  if (nof_records >= UINT32_MAX / 2) {
+    logger.error("Too many users in the DB: %zd", nof_records);
+    return false;
+  }
+  // At most half full, so that the probe sequences stay short
+  uint64_t nof_buckets = 16;
+  while (nof_buckets < 2 * nof_records) {
+    nof_buckets <<= 1U;
+  }
+  csv_buckets.assign(nof_buckets, 0);
+  bucket_mask = nof_buckets - 1;
+  for (uint32_t idx = 0; idx < nof_records; ++idx) {
+    uint64_t b = imsi_hash(records[idx].imsi) & bucket_mask;
+    while (csv_buckets[b] != 0) {
+      b = (b + 1) & bucket_mask;
+    }
+    csv_buckets[b] = idx + 1;
+  }
+  buckets = csv_buckets.data();
+  return true;
+}
+
+void hss_db::expand_keys()
+{
+  milenage_keys.resize(nof_records);
+  for (size_t idx = 0; idx < nof_records; ++idx) {
+    if (records[idx].algo == HSS_ALGO_MILENAGE) {
+      milenage_keys[idx].set(records[idx].key);
+    }
+  }
+}
+
+hss_ue_ctx_t* hss_db::find(uint64_t imsi) const
+{
+  if (buckets == nullptr) {
+    return nullptr;
+  }
+  for (uint64_t b = imsi_hash(imsi) & bucket_mask; buckets[b] != 0; b = (b + 1) & bucket_mask) {
+    hss_ue_ctx_t* ue_ctx = &records[buckets[b] - 1];
+    if (ue_ctx->imsi == imsi) {
+      return ue_ctx;
+    }
+  }
+  return nullptr;
+}
+
+bool hss_db::write_csv(const std::string& filename) const
+{
+  std::ofstream m_db_file;
+
+  m_db_file.open(filename.c_str(), std::ofstream::out);
+  if (!m_db_file.is_open()) {
+    return false;
+  }
+  logger.info("Opened DB file: %s", filename.c_str());
+
+  // Write comment info
+  m_db_file << "#                                                                                           \n"
+            << "# .csv to store UE's information in HSS                                                     \n"
+            << "# Kept in the following format: \"Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc\"  \n"
+            << "#                                                                                           \n"
+            << "# Name:     Human readable name to help distinguish UE's. Ignored by the HSS                \n"
+            << "# Auth:     Authentication algorithm used by the UE. Valid algorithms are XOR               \n"
+            << "#           (xor) and MILENAGE (mil)                                                        \n"
+            << "# IMSI:     UE's IMSI value                                                                 \n"
+            << "# Key:      UE's key, where other keys are derived from. Stored in hexadecimal              \n"
+            << "# OP_Type:  Operator's code type, either OP or OPc                                          \n"
+            << "# OP/OPc:   Operator Code/Cyphered Operator Code, stored in hexadecimal                     \n"
+            << "# AMF:      Authentication management field, stored in hexadecimal                          \n"
+            << "# SQN:      UE's Sequence number for freshness of the authentication                        \n"
+            << "# QCI:      QoS Class Identifier for the UE's default bearer.                               \n"
+            << "# IP_alloc: IP allocation stratagy for the SPGW.                                            \n"
+            << "#           With 'dynamic' the SPGW will automatically allocate IPs                         \n"
+            << "#           With a valid IPv4 (e.g. '172.16.0.2') the UE will have a statically assigned IP.\n"
+            << "#                                                                                           \n"
+            << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
+
+  for (size_t idx = 0; idx < nof_records; ++idx) {
+    hss_ue_ctx_t* ue_ctx = &records[idx];
+    m_db_file << ue_ctx->name;
+    m_db_file << ",";
+    m_db_file << (ue_ctx->algo == HSS_ALGO_XOR ? "xor" : "mil");
+    m_db_file << ",";
+    m_db_file << std::setfill('0') << std::setw(15) << ue_ctx->imsi;
+    m_db_file << ",";
+    m_db_file << srsran::hex_string(ue_ctx->key, 16);
+    m_db_file << ",";
+    if (ue_ctx->op_configured) {
+      m_db_file << "op,";
+      m_db_file << srsran::hex_string(ue_ctx->op, 16);
+    } else {
+      m_db_file << "opc,";
+      m_db_file << srsran::hex_string(ue_ctx->opc, 16);
+    }
+    m_db_file << ",";
+    m_db_file << srsran::hex_string(ue_ctx->amf, 2);
+    m_db_file << ",";
+    m_db_file << srsran::hex_string(ue_ctx->sqn, 6);
+    m_db_file << ",";
+    m_db_file << ue_ctx->qci;
+    if (ue_ctx->static_ip != 0) {
+      char ip_str[INET_ADDRSTRLEN] = {};
+      in_addr addr                 = {};
+      addr.s_addr                  = ue_ctx->static_ip;
+      m_db_file << ",";
+      m_db_file << inet_ntop(AF_INET, &addr, ip_str, sizeof(ip_str));
+    } else {
+      m_db_file << ",dynamic";
+    }
+    m_db_file << std::endl;
+  }
+  if (m_db_file.is_open()) {
+    m_db_file.close();
+  }
+  return true;
+}
+
+bool hss_db::write_binary(const std::string& filename) const
+{
+  std::vector<hss_db_static_ip_t> static_ips;
+  for (size_t idx = 0; idx < nof_records; ++idx) {
+    if (records[idx].static_ip != 0) {
+      static_ips.push_back({records[idx].imsi, records[idx].static_ip, 0});
+    }
+  }
+
+  hss_db_header_t header = {};
+  memcpy(header.magic, hss_db_magic, sizeof(header.magic));
+  header.version           = hss_db_version;
+  header.record_size       = sizeof(hss_ue_ctx_t);
+  header.nof_records       = nof_records;
+  header.nof_buckets       = bucket_mask + 1;
+  header.nof_static_ips    = static_ips.size();
+  header.records_offset    = sizeof(header);
+  header.buckets_offset    = header.records_offset + nof_records * sizeof(hss_ue_ctx_t);
+  header.static_ips_offset = header.buckets_offset + header.nof_buckets * sizeof(uint32_t);
+
+  // Written aside and renamed, so that a crash never leaves a partial store behind
+  std::string tmp_filename = filename + ".tmp";
+  int         fd           = ::open(tmp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0) {
+    logger.error("Error creating %s: %s", tmp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  bool ret = write_all(fd, &header, sizeof(header)) and
+             write_all(fd, records, nof_records * sizeof(hss_ue_ctx_t)) and
+             write_all(fd, buckets, header.nof_buckets * sizeof(uint32_t)) and
+             write_all(fd, static_ips.data(), static_ips.size() * sizeof(hss_db_static_ip_t)) and fsync(fd) == 0;
+  ::close(fd);
+  if (not ret or rename(tmp_filename.c_str(), filename.c_str()) != 0 or not sync_parent_dir(filename)) {
+    logger.error("Error writing %s: %s", filename.c_str(), strerror(errno));
+    unlink(tmp_filename.c_str());
+    return false;
+  }
+  logger.info("Wrote %zd users to binary DB file %s", nof_records, filename.c_str());
+  return true;
+}
+
+bool hss_db::open_binary(const std::string& filename)
+{
+  int fd = ::open(filename.c_str(), O_RDWR);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 or (size_t)st.st_size < sizeof(hss_db_header_t)) {
+    logger.error("Invalid binary DB file %s", filename.c_str());
+    ::close(fd);
+    return false;
+  }
+  void* base = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    logger.error("Error mapping %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  map_base = base;
+  map_len  = st.st_size;
+  // Lookups are spread over the whole file
+  madvise(map_base, map_len, MADV_RANDOM);
+
+  const hss_db_header_t& header = *static_cast<const hss_db_header_t*>(map_base);
+  if (memcmp(header.magic, hss_db_magic, sizeof(header.magic)) != 0 or header.version != hss_db_version or
+      header.record_size != sizeof(hss_ue_ctx_t) or header.nof_buckets == 0 or
+      (header.nof_buckets & (header.nof_buckets - 1)) != 0 or
+      header.buckets_offset < header.records_offset + header.nof_records * sizeof(hss_ue_ctx_t) or
+      header.static_ips_offset < header.buckets_offset + header.nof_buckets * sizeof(uint32_t) or
+      map_len < header.static_ips_offset + header.nof_static_ips * sizeof(hss_db_static_ip_t) or
+      header.records_offset % alignof(hss_ue_ctx_t) != 0) {
+    logger.error("Invalid or incompatible binary DB file %s", filename.c_str());
+    close();
+    return false;
+  }
+  uint8_t* ptr = static_cast<uint8_t*>(map_base);
+  records      = reinterpret_cast<hss_ue_ctx_t*>(ptr + header.records_offset);
+  nof_records  = header.nof_records;
+  buckets      = reinterpret_cast<const uint32_t*>(ptr + header.buckets_offset);
+  bucket_mask  = header.nof_buckets - 1;
+  expand_keys();
+
+  const hss_db_static_ip_t* static_ips = reinterpret_cast<const hss_db_static_ip_t*>(ptr + header.static_ips_offset);
+  for (uint64_t i = 0; i < header.nof_static_ips; ++i) {
+    char    ip_str[INET_ADDRSTRLEN] = {};
+    in_addr addr                    = {};
+    addr.s_addr                     = static_ips[i].ipv4;
+    ip_to_imsi.insert(std::make_pair(inet_ntop(AF_INET, &addr, ip_str, sizeof(ip_str)), static_ips[i].imsi));
+  }
+
+  // Recover the SQNs of the journals left by the previous run. The rotated one, if any, is the older
+  db_filename = filename;
+  if (not replay_journal(db_filename + ".journal.old") or not replay_journal(db_filename + ".journal") or
+      not open_journal()) {
+    close();
+    return false;
+  }
+
+  compactor_stop = false;
+  compactor      = std::thread([this]() { run_compactor(); });
+  logger.info("Opened binary DB file %s with %zd users", filename.c_str(), nof_records);
+  return true;
+}
+
+uint16_t hss_db::journal_checksum(const journal_entry_t& entry)
+{
+  // Fletcher-16 over the rest of the entry, to detect a torn write at the end of the journal
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(&entry);
+  uint16_t       sum1 = 0, sum2 = 0;
+  for (size_t i = 0; i < offsetof(journal_entry_t, checksum); ++i) {
+    sum1 = (sum1 + data[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+  return (sum2 << 8U) | sum1;
+}
+
+bool hss_db::replay_journal(const std::string& filename)
+{
+  std::ifstream journal(filename, std::ifstream::binary);
+  if (not journal.is_open()) {
+    // Nothing to recover
+    return true;
+  }
+  journal_entry_t entry     = {};
+  uint32_t        nof_valid = 0;
+  while (journal.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+    if (entry.checksum != journal_checksum(entry)) {
+      break;
+    }
+    hss_ue_ctx_t* ue_ctx = find(entry.imsi);
+    if (ue_ctx == nullptr) {
+      logger.warning("Journaled SQN of unknown IMSI: %015" PRIu64 "", entry.imsi);
+      continue;
+    }
+    ue_ctx->set_sqn(entry.sqn);
+    nof_valid++;
+  }
+  if (journal.gcount() != 0 or not journal.eof()) {
+    logger.warning("Ignoring the incomplete end of SQN journal %s", filename.c_str());
+  }
+  logger.info("Recovered %d SQNs from journal %s", nof_valid, filename.c_str());
+  return true;
+}
+
+bool hss_db::open_journal()
+{
+  // The recovered SQNs are made durable in the store before the journals are dropped
+  if (msync(map_base, map_len, MS_SYNC) != 0) {
+    logger.error("Error syncing binary DB file %s: %s", db_filename.c_str(), strerror(errno));
+    return false;
+  }
+  std::string filename = db_filename + ".journal";
+  journal_fd           = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+  if (journal_fd < 0) {
+    logger.error("Error opening SQN journal %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  unlink((db_filename + ".journal.old").c_str());
+  return sync_parent_dir(filename);
+}
+
+bool hss_db::sqn_updated(const hss_ue_ctx_t& ue_ctx)
+{
+  if (not is_binary()) {
+    return true;
+  }
+  journal_entry_t entry = {};
+  entry.imsi            = ue_ctx.imsi;
+  memcpy(entry.sqn, ue_ctx.sqn, sizeof(entry.sqn));
+  entry.checksum = journal_checksum(entry);
+
+  std::unique_lock<std::mutex> lock(journal_mutex);
+  if (failed_seq != 0) {
+    return false;
+  }
+  pending_entries.push_back(entry);
+  uint64_t seq = ++appended_seq;
+  while (synced_seq < seq) {
+    if (flushing) {
+      journal_cvar.wait(lock);
+      continue;
+    }
+    // Commit every pending entry, including the ones of the threads that wait for us
+    flushing = true;
+    std::vector<journal_entry_t> batch;
+    batch.swap(pending_entries);
+    uint64_t batch_seq = appended_seq;
+    int      fd        = journal_fd;
+    lock.unlock();
+
+    bool ok = write_all(fd, batch.data(), batch.size() * sizeof(journal_entry_t)) and fdatasync(fd) == 0;
+    if (not ok) {
+      logger.error("Error writing the SQN journal: %s", strerror(errno));
+    }
+
+    lock.lock();
+    if (not ok and failed_seq == 0) {
+      failed_seq = synced_seq + 1;
+    }
+    nof_journaled += batch.size();
+    synced_seq = batch_seq;
+    flushing   = false;
+    journal_cvar.notify_all();
+    if (nof_journaled >= compact_nof_entries) {
+      compactor_cvar.notify_one();
+    }
+  }
+  return failed_seq == 0 or seq < failed_seq;
+}
+
+bool hss_db::compact(bool force)
+{
+  std::string filename     = db_filename + ".journal";
+  std::string old_filename = db_filename + ".journal.old";
+
+  // A previous compaction may have failed to sync the store after rotating the journal. Rotating again would overwrite
+  // the rotated journal and lose its SQNs, so it must be dropped first
+  if (access(old_filename.c_str(), F_OK) == 0 and not drop_rotated_journal(old_filename)) {
+    logger.error("Not rotating the SQN journal while %s is pending", old_filename.c_str());
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(journal_mutex);
+    journal_cvar.wait(lock, [this]() { return not flushing; });
+    if (not force and nof_journaled < compact_nof_entries) {
+      return true;
+    }
+    // Rotate the journal. The committers wait meanwhile, as during a flush
+    int fd = -1;
+    if (rename(filename.c_str(), old_filename.c_str()) == 0) {
+      fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+      if (fd < 0) {
+        // Keep on appending to the current journal under its own name
+        rename(old_filename.c_str(), filename.c_str());
+      }
+    }
+    if (fd < 0 or not sync_parent_dir(filename)) {
+      logger.error("Error rotating the SQN journal: %s", strerror(errno));
+      if (fd >= 0) {
+        ::close(fd);
+      }
+      return false;
+    }
+    ::close(journal_fd);
+    journal_fd    = fd;
+    nof_journaled = 0;
+  }
+
+  if (not drop_rotated_journal(old_filename)) {
+    return false;
+  }
+  logger.debug("Compacted the SQN journal into %s", db_filename.c_str());
+  return true;
+}
+
+bool hss_db::drop_rotated_journal(const std::string& old_filename)
+{
+  // The SQNs of the rotated journal were written to the mapping before being journaled
+  if (msync(map_base, map_len, MS_SYNC) != 0) {
+    logger.error("Error syncing binary DB file %s: %s", db_filename.c_str(), strerror(errno));
+    return false;
+  }
+  unlink(old_filename.c_str());
+  sync_parent_dir(old_filename);
+  return true;
+}
+
+void hss_db::run_compactor()
+{
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(journal_mutex);
+      compactor_cvar.wait(lock, [this]() { return compactor_stop or nof_journaled >= compact_nof_entries; });
+      if (compactor_stop) {
+        return;
+      }
+    }
+    if (not compact(false)) {
+      // Retry later, rather than spinning on a failing disk
+      std::unique_lock<std::mutex> lock(journal_mutex);
+      compactor_cvar.wait_for(lock, std::chrono::seconds(1), [this]() { return compactor_stop; });
+    }
+  }
+}
+
+void hss_db::close()
+{
+  if (compactor.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(journal_mutex);
+      compactor_stop = true;
+    }
+    compactor_cvar.notify_one();
+    compactor.join();
+    compact(true);
+  }
+  if (journal_fd >= 0) {
+    ::close(journal_fd);
+    journal_fd = -1;
+  }
+  if (map_base != nullptr) {
+    munmap(map_base, map_len);
+    map_base = nullptr;
+    map_len  = 0;
+  }
+  csv_records.clear();
+  csv_buckets.clear();
+  ip_to_imsi.clear();
+  milenage_keys.clear();
+  pending_entries.clear();
+  records       = nullptr;
+  nof_records   = 0;
+  buckets       = nullptr;
+  bucket_mask   = 0;
+  appended_seq  = 0;
+  synced_seq    = 0;
+  failed_seq    = 0;
+  nof_journaled = 0;
+}
+
+} // namespace srsepc
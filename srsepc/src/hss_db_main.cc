@@ -0,0 +1,67 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_db_main.cc
+ * Description: Converts a user_db.csv to the binary subscriber store of the
+ *              HSS, or a binary store back to CSV.
+ *****************************************************************************/
+
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srsran/common/standard_streams.h"
+#include "srsran/config.h"
+#include "srsran/srslog/srslog.h"
+
+using namespace srsepc;
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    srsran::console("Usage: %s <input> <output>\n", argv[0]);
+    srsran::console("Converts a user_db.csv to a binary subscriber store, or a binary store back to CSV.\n");
+    srsran::console("Binary stores must not be converted while the HSS is running on them.\n");
+    return SRSRAN_ERROR;
+  }
+  std::string input  = argv[1];
+  std::string output = argv[2];
+
+  srslog::fetch_basic_logger("HSS").set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  hss_db db;
+  bool   ret;
+  if (hss_db::is_binary(input)) {
+    // Opening the store folds the SQN journal into it, so the CSV gets the latest SQNs
+    ret = db.open_binary(input) and db.write_csv(output);
+  } else {
+    ret = db.load_csv(input) and db.write_binary(output);
+  }
+  if (not ret) {
+    srsran::console("Error converting %s to %s\n", input.c_str(), output.c_str());
+    srslog::flush();
+    return SRSRAN_ERROR;
+  }
+  srsran::console("Converted %zd users from %s to %s\n", db.size(), input.c_str(), output.c_str());
+  db.close();
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
@@ -126,11 +126,14 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("mme.paging_timer",    bpo::value<uint16_t>(&paging_timer)->default_value(2),           "Set paging timer value in seconds (T3413)")
     ("mme.request_imeisv",  bpo::value<bool>(&request_imeisv)->default_value(false),         "Enable IMEISV request in Security mode command")
     ("mme.lac",             bpo::value<string>(&lac)->default_value("0x01"),                 "Location Area Code")
-    ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
+    ("mme.nof_workers",     bpo::value<uint32_t>(&args->mme_args.s1ap_args.nof_workers)->default_value(1), "Number of S1AP/NAS worker threads. UEs are sharded across them by MME UE S1AP Id and IMSI")
+    ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file, or binary store converted with srsepc_hss_db, that stores UE's keys")
+    ("hss.auth_vector_batch", bpo::value<uint32_t>(&args->hss_args.auth_vector_batch)->default_value(1), "Milenage authentication vectors generated at once per UE (1 to 32)")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
     ("spgw.sgi_if_name",    bpo::value<string>(&sgi_if_name)->default_value("srs_spgw_sgi"), "Name of TUN interface for the SGi connection")
     ("spgw.max_paging_queue", bpo::value<uint32_t>(&max_paging_queue)->default_value(100), "Max number of packets in paging queue")
+    ("spgw.nof_up_workers", bpo::value<uint32_t>(&args->spgw_args.nof_up_workers)->default_value(1), "Number of user plane worker threads. UEs are sharded across them by TEID (uplink) and flow (downlink)")
 
     ("pcap.enable",   bpo::value<bool>(&args->mme_args.s1ap_args.pcap_enable)->default_value(false),         "Enable S1AP PCAP")
     ("pcap.filename", bpo::value<string>(&args->mme_args.s1ap_args.pcap_filename)->default_value("/tmp/epc.pcap"), "PCAP filename")
@@ -23,6 +23,7 @@
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -77,6 +78,22 @@ int mme::init(mme_args_t* args)
     exit(-1);
   }
 
+  /*Init S1AP/NAS workers*/
+  // With more than one worker, the MME thread only does the socket I/O and hands each UE-associated message to the
+  // worker that owns the UE. Non-UE-associated S1AP procedures are still handled by the MME thread.
+  uint32_t nof_workers = m_s1ap->get_nof_workers();
+  if (nof_workers > 1) {
+    m_timer_wakeup_fd = eventfd(0, EFD_NONBLOCK);
+    if (m_timer_wakeup_fd == -1) {
+      srsran::console("Error creating the MME timer eventfd: %s\n", strerror(errno));
+      exit(-1);
+    }
+    for (uint32_t i = 0; i < nof_workers; ++i) {
+      m_workers.emplace_back(new ue_worker(this, i));
+    }
+    srsran::console("MME S1AP/NAS running in %d worker threads.\n", nof_workers);
+  }
+
   /*Log successful initialization*/
   m_s1ap_logger.info("MME Initialized. MCC: 0x%x, MNC: 0x%x", args->s1ap_args.mcc, args->s1ap_args.mnc);
   srsran::console("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
@@ -86,11 +103,23 @@ int mme::init(mme_args_t* args)
 void mme::stop()
 {
   if (m_running) {
-    m_s1ap->stop();
-    m_s1ap->cleanup();
     m_running = false;
     thread_cancel();
     wait_thread_finish();
+
+    // The MME thread may have been cancelled with the workers paused
+    resume_workers();
+    for (auto& worker : m_workers) {
+      worker->stop();
+    }
+    m_workers.clear();
+
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+  }
+  if (m_timer_wakeup_fd != -1) {
+    close(m_timer_wakeup_fd);
+    m_timer_wakeup_fd = -1;
   }
   return;
 }
@@ -111,6 +140,10 @@ void mme::run_thread()
   int rd_sz;
   int msg_flags = 0;
 
+  for (auto& worker : m_workers) {
+    worker->start();
+  }
+
   // Mark the thread as running
   m_running = true;
 
@@ -118,19 +151,39 @@ void mme::run_thread()
   int s1mme = m_s1ap->get_s1_mme();
   int s11   = m_mme_gtpc->get_s11();
 
+  std::vector<mme_timer_t> expired_timers;
   while (m_running) {
+    // The previous PDU may have been handed over to a worker
+    if (pdu == nullptr) {
+      pdu = srsran::make_byte_buffer("mme::run_thread");
+      if (pdu == nullptr) {
+        m_s1ap_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+        return;
+      }
+    }
     pdu->clear();
     int max_fd = std::max(s1mme, s11);
 
     FD_ZERO(&m_set);
     FD_SET(s1mme, &m_set);
     FD_SET(s11, &m_set);
+    if (m_timer_wakeup_fd != -1) {
+      FD_SET(m_timer_wakeup_fd, &m_set);
+      max_fd = std::max(max_fd, m_timer_wakeup_fd);
+    }
 
     // Add timers to select
-    for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
-      FD_SET(it->fd, &m_set);
-      max_fd = std::max(max_fd, it->fd);
-      m_s1ap_logger.debug("Adding Timer fd %d to fd_set", it->fd);
+    {
+      std::lock_guard<std::mutex> lock(m_timers_mutex);
+      for (int fd : m_closed_timer_fds) {
+        close(fd);
+      }
+      m_closed_timer_fds.clear();
+      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
+        FD_SET(it->fd, &m_set);
+        max_fd = std::max(max_fd, it->fd);
+        m_s1ap_logger.debug("Adding Timer fd %d to fd_set", it->fd);
+      }
     }
 
     m_s1ap_logger.debug("Waiting for S1-MME or S11 Message");
@@ -153,32 +206,95 @@ void mme::run_thread()
             if (notification->sn_header.sn_type == SCTP_SHUTDOWN_EVENT) {
               m_s1ap_logger.info("SCTP Association Shutdown. Association: %d", sri.sinfo_assoc_id);
               srsran::console("SCTP Association Shutdown. Association: %d\n", sri.sinfo_assoc_id);
+              // Releasing the UEs of the eNB touches the contexts owned by every worker
+              pause_workers();
               m_s1ap->delete_enb_ctx(sri.sinfo_assoc_id);
+              resume_workers();
             }
           } else {
             // Received data
             pdu->N_bytes = rd_sz;
             m_s1ap_logger.info("Received S1AP msg. Size: %d", pdu->N_bytes);
-            m_s1ap->handle_s1ap_rx_pdu(pdu.get(), &sri);
+            uint32_t worker_idx = s1ap::no_worker;
+            if (not m_workers.empty()) {
+              worker_idx = m_s1ap->get_pdu_worker(pdu.get(), &sri);
+            }
+            if (worker_idx == s1ap::no_worker) {
+              m_s1ap->handle_s1ap_rx_pdu(pdu.get(), &sri);
+            } else {
+              mme_task_t task;
+              task.type = mme_task_t::S1AP_PDU;
+              task.pdu  = std::move(pdu);
+              task.sri  = sri;
+              dispatch_task(worker_idx, std::move(task));
+            }
           }
         }
       }
       // Handle S11
       if (FD_ISSET(s11, &m_set)) {
+        if (pdu == nullptr) {
+          pdu = srsran::make_byte_buffer("mme::run_thread");
+          if (pdu == nullptr) {
+            m_s1ap_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+            return;
+          }
+        }
         pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
-        m_mme_gtpc->handle_s11_pdu(pdu.get());
+        // The S11 messages are addressed to the MME control TEID of the UE
+        uint64_t imsi = 0;
+        if (m_workers.empty() or
+            not m_mme_gtpc->get_imsi_from_ctrl_teid(((srsran::gtpc_pdu*)pdu->msg)->header.teid, imsi)) {
+          m_mme_gtpc->handle_s11_pdu(pdu.get());
+        } else {
+          mme_task_t task;
+          task.type = mme_task_t::S11_PDU;
+          task.pdu  = std::move(pdu);
+          task.imsi = imsi;
+          dispatch_task(m_s1ap->get_imsi_worker(imsi), std::move(task));
+        }
+      }
+      // Drain the wake-ups of the workers, which only interrupt select() to update the timer fd_set
+      if (m_timer_wakeup_fd != -1 and FD_ISSET(m_timer_wakeup_fd, &m_set)) {
+        uint64_t count;
+        rd_sz = read(m_timer_wakeup_fd, &count, sizeof(uint64_t));
+      }
+      // Hand the UE contexts replaced by other workers to the workers that own them
+      std::vector<mme_task_t> replaced_ctxs;
+      {
+        std::lock_guard<std::mutex> lock(m_replaced_ctxs_mutex);
+        replaced_ctxs.swap(m_replaced_ctxs);
+      }
+      for (mme_task_t& task : replaced_ctxs) {
+        dispatch_task(m_s1ap->get_imsi_worker(task.imsi), std::move(task));
       }
       // Handle NAS Timers
-      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
-        if (FD_ISSET(it->fd, &m_set)) {
-          m_s1ap_logger.info("Timer expired");
-          uint64_t exp;
-          rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
-          close(it->fd);
-          timers.erase(it);
+      expired_timers.clear();
+      {
+        std::lock_guard<std::mutex> lock(m_timers_mutex);
+        for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
+          if (FD_ISSET(it->fd, &m_set)) {
+            m_s1ap_logger.info("Timer expired");
+            uint64_t exp;
+            rd_sz = read(it->fd, &exp, sizeof(uint64_t));
+            close(it->fd);
+            expired_timers.push_back(*it);
+            it = timers.erase(it);
+          } else {
+            ++it;
+          }
+        }
+      }
+      // The expiry handlers may start or stop timers
+      for (const mme_timer_t& timer : expired_timers) {
+        if (m_workers.empty()) {
+          m_s1ap->expire_nas_timer(timer.type, timer.imsi);
         } else {
-          ++it;
+          mme_task_t task;
+          task.type       = mme_task_t::NAS_TIMER;
+          task.timer_type = timer.type;
+          task.imsi       = timer.imsi;
+          dispatch_task(m_s1ap->get_imsi_worker(timer.imsi), std::move(task));
         }
       }
     } else {
@@ -188,6 +304,119 @@ void mme::run_thread()
   return;
 }
 
+/*
+ * S1AP/NAS workers
+ */
+void mme::handle_task(mme_task_t& task)
+{
+  switch (task.type) {
+    case mme_task_t::S1AP_PDU:
+      m_s1ap->handle_s1ap_rx_pdu(task.pdu.get(), &task.sri);
+      break;
+    case mme_task_t::S11_PDU:
+      if (not is_stale_task(task)) {
+        m_mme_gtpc->handle_s11_pdu(task.pdu.get());
+      }
+      break;
+    case mme_task_t::NAS_TIMER:
+      if (not is_stale_task(task)) {
+        m_s1ap->expire_nas_timer(task.timer_type, task.imsi);
+      }
+      break;
+    case mme_task_t::REPLACE_NAS_CTX:
+      m_s1ap->replace_nas_ctx(task.imsi, task.old_ctx, task.new_ctx);
+      break;
+    case mme_task_t::PAUSE:
+      wait_resume();
+      break;
+  }
+}
+
+// The S11 messages and timers of a UE context that was replaced by another worker may still be queued to the worker
+// that owned it. By then, the IMSI belongs to the new context
+bool mme::is_stale_task(const mme_task_t& task)
+{
+  if (m_s1ap->get_imsi_worker(task.imsi) == s1ap::get_worker_idx()) {
+    return false;
+  }
+  m_s1ap_logger.warning("Dropping MME task. IMSI %015" PRIu64 " is not owned by this worker", task.imsi);
+  return true;
+}
+
+void mme::dispatch_task(uint32_t worker_idx, mme_task_t task)
+{
+  if (not m_workers[worker_idx]->push(std::move(task))) {
+    m_s1ap_logger.warning("Dropping MME task. S1AP/NAS worker %d is stopped", worker_idx);
+  }
+}
+
+void mme::pause_workers()
+{
+  if (m_workers.empty()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(m_pause_mutex);
+  m_paused     = true;
+  m_nof_paused = 0;
+  lock.unlock();
+
+  // The pause is queued behind the pending tasks of each worker
+  for (uint32_t i = 0; i < m_workers.size(); ++i) {
+    mme_task_t task;
+    task.type = mme_task_t::PAUSE;
+    dispatch_task(i, std::move(task));
+  }
+
+  lock.lock();
+  m_pause_cvar.wait(lock, [this]() { return m_nof_paused == m_workers.size(); });
+}
+
+void mme::resume_workers()
+{
+  std::lock_guard<std::mutex> lock(m_pause_mutex);
+  m_paused = false;
+  m_pause_cvar.notify_all();
+}
+
+void mme::wait_resume()
+{
+  std::unique_lock<std::mutex> lock(m_pause_mutex);
+  m_nof_paused++;
+  m_pause_cvar.notify_all();
+  m_pause_cvar.wait(lock, [this]() { return not m_paused; });
+}
+
+mme::ue_worker::ue_worker(mme* mme_, uint32_t worker_idx) :
+  thread("MME_WORKER" + std::to_string(worker_idx)),
+  m_mme(mme_),
+  m_worker_idx(worker_idx),
+  m_running(true),
+  m_tasks(task_queue_size)
+{}
+
+bool mme::ue_worker::push(mme_task_t task)
+{
+  return m_tasks.push(std::move(task));
+}
+
+void mme::ue_worker::stop()
+{
+  m_running = false;
+  m_tasks.stop();
+  wait_thread_finish();
+}
+
+void mme::ue_worker::run_thread()
+{
+  s1ap::set_worker_idx(m_worker_idx);
+  while (m_running) {
+    mme_task_t task;
+    if (m_tasks.pop_wait(task) and m_running) {
+      m_mme->handle_task(task);
+    }
+  }
+}
+
 /*
  * Timer Handling
  */
@@ -200,12 +429,17 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
   timer.type = type;
   timer.imsi = imsi;
 
-  timers.push_back(timer);
+  {
+    std::lock_guard<std::mutex> lock(m_timers_mutex);
+    timers.push_back(timer);
+  }
+  wakeup_mme_thread();
   return true;
 }
 
 bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(m_timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -217,23 +451,62 @@ bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 
 bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 {
-  std::vector<mme_timer_t>::iterator it;
-  for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
-      break; // found timer to remove
+  {
+    std::lock_guard<std::mutex>        lock(m_timers_mutex);
+    std::vector<mme_timer_t>::iterator it;
+    for (it = timers.begin(); it != timers.end(); ++it) {
+      if (it->type == type && it->imsi == imsi) {
+        break; // found timer to remove
+      }
+    }
+    if (it == timers.end()) {
+      m_s1ap_logger.warning("Could not find timer to remove. IMSI %" PRIu64 ", Type %d", imsi, type);
+      return false;
     }
+
+    // removing timer. The fd may still be in the fd_set of the MME thread, so it is closed by the MME thread
+    m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, it->fd);
+    m_closed_timer_fds.push_back(it->fd);
+    timers.erase(it);
   }
-  if (it == timers.end()) {
-    m_s1ap_logger.warning("Could not find timer to remove. IMSI %" PRIu64 ", Type %d", imsi, type);
-    return false;
+  wakeup_mme_thread();
+  return true;
+}
+
+/*
+ * UE context handover
+ */
+void mme::replace_nas_ctx(uint64_t imsi, nas* old_ctx, nas* new_ctx)
+{
+  // The IMSI map is read instead of the old context, which may be deleted by its worker at any time
+  if (m_workers.empty() or m_s1ap->get_imsi_worker(imsi) == s1ap::get_worker_idx()) {
+    m_s1ap->replace_nas_ctx(imsi, old_ctx, new_ctx);
+    return;
   }
 
-  // removing timer
-  m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
-  close(it->fd);
-  timers.erase(it);
-  return true;
+  // The old context may have tasks in flight in its worker, which must be the one deleting it. Only the MME thread
+  // pushes tasks to the workers
+  mme_task_t task;
+  task.type    = mme_task_t::REPLACE_NAS_CTX;
+  task.imsi    = imsi;
+  task.old_ctx = old_ctx;
+  task.new_ctx = new_ctx;
+  {
+    std::lock_guard<std::mutex> lock(m_replaced_ctxs_mutex);
+    m_replaced_ctxs.push_back(std::move(task));
+  }
+  wakeup_mme_thread();
+}
+
+void mme::wakeup_mme_thread()
+{
+  // Only the workers start and stop timers or replace UE contexts outside of the MME thread
+  if (m_timer_wakeup_fd != -1 and not m_workers.empty()) {
+    uint64_t one = 1;
+    if (write(m_timer_wakeup_fd, &one, sizeof(uint64_t)) != sizeof(uint64_t)) {
+      m_s1ap_logger.debug("Could not wake up the MME thread: %s", strerror(errno));
+    }
+  }
 }
 
 } // namespace srsepc
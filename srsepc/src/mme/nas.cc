@@ -51,6 +51,7 @@ nas::nas(const nas_init_t& args, const nas_if_t& itf) :
 {
   m_sec_ctx.integ_algo  = args.integ_algo;
   m_sec_ctx.cipher_algo = args.cipher_algo;
+  m_worker_idx          = s1ap::get_worker_idx();
   m_logger.debug("NAS Context Initialized. MCC: 0x%x, MNC 0x%x", m_mcc, m_mnc);
 }
 
@@ -1225,16 +1226,17 @@ bool nas::handle_identity_response(srsran::byte_buffer_t* nas_rx)
   // Identity reponse from unknown GUTI atach. Assigning new eKSI.
   m_sec_ctx.eksi = 0;
 
-  // Make sure UE context was not previously stored in IMSI map
+  // Make sure UE context was not previously stored in IMSI map. The UE was routed by its unknown GUTI, so the previous
+  // context may belong to another worker, which has to be the one deleting it
   nas* nas_ctx = m_s1ap->find_nas_ctx_from_imsi(imsi);
   if (nas_ctx != nullptr) {
     m_logger.warning("UE context already exists.");
-    m_s1ap->delete_ue_ctx(imsi);
+    m_mme->replace_nas_ctx(imsi, nas_ctx, this);
+  } else {
+    // Store UE context im IMSI map
+    m_s1ap->add_nas_ctx_to_imsi_map(this);
   }
 
-  // Store UE context im IMSI map
-  m_s1ap->add_nas_ctx_to_imsi_map(this);
-
   // Pack NAS Authentication Request in Downlink NAS Transport msg
   nas_tx = srsran::make_byte_buffer();
   if (nas_tx == nullptr) {
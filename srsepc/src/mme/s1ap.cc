@@ -22,6 +22,7 @@
 #include "srsepc/hdr/mme/s1ap.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/bcd_helpers.h"
+#include "srsran/common/int_helpers.h"
 #include "srsran/common/liblte_security.h"
 #include "srsran/common/network_utils.h"
 #include <cmath>
@@ -33,7 +34,10 @@ namespace srsepc {
 s1ap*           s1ap::m_instance    = NULL;
 pthread_mutex_t s1ap_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-s1ap::s1ap() : m_s1mme(-1), m_next_mme_ue_s1ap_id(1), m_mme_gtpc(NULL) {}
+// Index of the S1AP/NAS worker running in the calling thread
+static thread_local uint32_t s1ap_worker_idx = 0;
+
+s1ap::s1ap() : m_s1mme(-1), m_nof_workers(1), m_next_mme_ue_s1ap_id(1, 0), m_mme_gtpc(NULL) {}
 
 s1ap::~s1ap()
 {
@@ -70,6 +74,9 @@ int s1ap::init(const s1ap_args_t& s1ap_args)
   std::uniform_int_distribution<uint32_t> distr(0, std::numeric_limits<uint32_t>::max());
   m_next_m_tmsi = distr(generator);
 
+  m_nof_workers = std::max(s1ap_args.nof_workers, 1U);
+  m_next_mme_ue_s1ap_id.assign(m_nof_workers, 0);
+
   // Get pointer to the HSS
   m_hss = hss::get_instance();
 
@@ -108,21 +115,24 @@ void s1ap::stop()
   if (m_s1mme != -1) {
     close(m_s1mme);
   }
-  std::map<uint16_t, enb_ctx_t*>::iterator enb_it = m_active_enbs.begin();
-  while (enb_it != m_active_enbs.end()) {
-    m_logger.info("Deleting eNB context. eNB Id: 0x%x", enb_it->second->enb_id);
-    srsran::console("Deleting eNB context. eNB Id: 0x%x\n", enb_it->second->enb_id);
-    delete enb_it->second;
-    m_active_enbs.erase(enb_it++);
+  {
+    std::lock_guard<std::mutex> lock(m_enb_mutex);
+    std::map<uint16_t, enb_ctx_t*>::iterator enb_it = m_active_enbs.begin();
+    while (enb_it != m_active_enbs.end()) {
+      m_logger.info("Deleting eNB context. eNB Id: 0x%x", enb_it->second->enb_id);
+      srsran::console("Deleting eNB context. eNB Id: 0x%x\n", enb_it->second->enb_id);
+      delete enb_it->second;
+      m_active_enbs.erase(enb_it++);
+    }
   }
 
-  std::map<uint64_t, nas*>::iterator ue_it = m_imsi_to_nas_ctx.begin();
-  while (ue_it != m_imsi_to_nas_ctx.end()) {
-    m_logger.info("Deleting UE EMM context. IMSI: %015" PRIu64 "", ue_it->first);
-    srsran::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", ue_it->first);
-    delete ue_it->second;
-    m_imsi_to_nas_ctx.erase(ue_it++);
-  }
+  m_imsi_to_nas_ctx.for_each([this](uint64_t imsi, nas* nas_ctx) {
+    m_logger.info("Deleting UE EMM context. IMSI: %015" PRIu64 "", imsi);
+    srsran::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", imsi);
+    delete nas_ctx;
+  });
+  m_imsi_to_nas_ctx.clear();
+  m_mme_ue_s1ap_id_to_nas_ctx.clear();
 
   // Cleanup message handlers
   s1ap_mngmt_proc::cleanup();
@@ -143,7 +153,172 @@ int s1ap::get_s1_mme()
 
 uint32_t s1ap::get_next_mme_ue_s1ap_id()
 {
-  return m_next_mme_ue_s1ap_id++;
+  // The MME UE S1AP Ids are interleaved across workers, so that the worker owning a UE is known from its Id. With a
+  // single worker, this gives 1, 2, 3...
+  uint32_t worker_idx = get_worker_idx();
+  return m_next_mme_ue_s1ap_id[worker_idx]++ * m_nof_workers + worker_idx + 1;
+}
+
+uint32_t s1ap::get_worker_idx()
+{
+  return s1ap_worker_idx;
+}
+
+void s1ap::set_worker_idx(uint32_t worker_idx)
+{
+  s1ap_worker_idx = worker_idx;
+}
+
+uint32_t s1ap::get_mme_ue_s1ap_id_worker(uint32_t mme_ue_s1ap_id)
+{
+  return (mme_ue_s1ap_id - 1) % m_nof_workers;
+}
+
+uint32_t s1ap::get_imsi_worker(uint64_t imsi)
+{
+  // A UE context stays with the worker that created it. Contexts that do not exist yet are spread by IMSI
+  uint32_t worker_idx = ue_id_hash(imsi) % m_nof_workers;
+  m_imsi_to_nas_ctx.visit(imsi, [&worker_idx](nas* nas_ctx) { worker_idx = nas_ctx->m_worker_idx; });
+  return worker_idx;
+}
+
+namespace {
+
+/// UE identifiers of a received S1AP PDU
+struct s1ap_pdu_ue_ids_t {
+  uint16_t                        proc_code              = 0;
+  bool                            mme_ue_s1ap_id_present = false;
+  uint32_t                        mme_ue_s1ap_id         = 0;
+  uint32_t                        enb_ue_s1ap_id         = 0;
+  bool                            s_tmsi_present         = false;
+  uint32_t                        m_tmsi                 = 0;
+  asn1::unbounded_octstring<true> nas_pdu;
+};
+
+/// Reads the procedure code and the UE identifiers of an S1AP PDU, skipping all the other IEs. This is much cheaper
+/// than unpacking the whole PDU, and it is enough to pick the worker that handles it
+bool peek_s1ap_ue_ids(const srsran::byte_buffer_t* pdu, s1ap_pdu_ue_ids_t& ids)
+{
+  asn1::cbit_ref    bref(pdu->msg, pdu->N_bytes);
+  s1ap_pdu_t::types type;
+  asn1::crit_e      crit;
+  uint32_t          len, nof_ies;
+  bool              ext;
+  if (type.unpack(bref) != asn1::SRSASN_SUCCESS or
+      asn1::unpack_integer(ids.proc_code, bref, (uint16_t)0u, (uint16_t)255u, false, true) != asn1::SRSASN_SUCCESS or
+      crit.unpack(bref) != asn1::SRSASN_SUCCESS or asn1::unpack_length(len, bref, true) != asn1::SRSASN_SUCCESS or
+      bref.unpack(ext, 1) != asn1::SRSASN_SUCCESS or
+      asn1::unpack_length(nof_ies, bref, 0u, 65535u, true) != asn1::SRSASN_SUCCESS) {
+    return false;
+  }
+
+  for (; nof_ies > 0; --nof_ies) {
+    uint32_t id, ie_len;
+    if (asn1::unpack_integer(id, bref, (uint32_t)0u, (uint32_t)65535u, false, true) != asn1::SRSASN_SUCCESS or
+        crit.unpack(bref) != asn1::SRSASN_SUCCESS or asn1::unpack_length(ie_len, bref, true) != asn1::SRSASN_SUCCESS) {
+      return false;
+    }
+    asn1::cbit_ref ie_bref = bref;
+    switch (id) {
+      case ASN1_S1AP_ID_MME_UE_S1AP_ID: {
+        asn1::s1ap::mme_ue_s1ap_id_t mme_ue_s1ap_id;
+        if (mme_ue_s1ap_id.unpack(ie_bref) != asn1::SRSASN_SUCCESS) {
+          return false;
+        }
+        ids.mme_ue_s1ap_id_present = true;
+        ids.mme_ue_s1ap_id         = mme_ue_s1ap_id.value;
+        break;
+      }
+      case ASN1_S1AP_ID_ENB_UE_S1AP_ID: {
+        asn1::s1ap::enb_ue_s1ap_id_t enb_ue_s1ap_id;
+        if (enb_ue_s1ap_id.unpack(ie_bref) != asn1::SRSASN_SUCCESS) {
+          return false;
+        }
+        ids.enb_ue_s1ap_id = enb_ue_s1ap_id.value;
+        break;
+      }
+      case ASN1_S1AP_ID_S_TMSI: {
+        asn1::s1ap::s_tmsi_s s_tmsi;
+        if (s_tmsi.unpack(ie_bref) != asn1::SRSASN_SUCCESS) {
+          return false;
+        }
+        ids.s_tmsi_present = true;
+        srsran::uint8_to_uint32(s_tmsi.m_tmsi.data(), &ids.m_tmsi);
+        break;
+      }
+      case ASN1_S1AP_ID_NAS_PDU:
+        if (ids.nas_pdu.unpack(ie_bref) != asn1::SRSASN_SUCCESS) {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+    if (bref.advance_bits(ie_len * 8) != asn1::SRSASN_SUCCESS) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Reads the EPS mobile identity of a NAS Attach Request. Returns false if the NAS PDU is not an Attach Request
+bool peek_attach_request_mobile_id(const asn1::unbounded_octstring<true>& nas_pdu,
+                                   LIBLTE_MME_EPS_MOBILE_ID_STRUCT&       mobile_id)
+{
+  if (nas_pdu.size() < 2) {
+    return false;
+  }
+  // Plain NAS messages have a 2 byte header, integrity protected ones are preceded by 6 more bytes
+  uint32_t hdr_len = ((nas_pdu[0] >> 4U) == LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS) ? 2 : 8;
+  // The EPS mobile identity follows the EPS attach type and NAS KSI byte
+  uint32_t id_offset = hdr_len + 1;
+  if (nas_pdu.size() <= id_offset or nas_pdu[hdr_len - 1] != LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST or
+      nas_pdu.size() <= id_offset + nas_pdu[id_offset]) {
+    return false;
+  }
+  uint8_t* ie_ptr = const_cast<uint8_t*>(&nas_pdu[id_offset]);
+  return liblte_mme_unpack_eps_mobile_id_ie(&ie_ptr, &mobile_id) == LIBLTE_SUCCESS;
+}
+
+} // namespace
+
+uint32_t s1ap::get_pdu_worker(const srsran::byte_buffer_t* pdu, const struct sctp_sndrcvinfo* enb_sri)
+{
+  s1ap_pdu_ue_ids_t ids;
+  if (not peek_s1ap_ue_ids(pdu, ids)) {
+    // Leave it to the MME thread, which will report the decoding error
+    return no_worker;
+  }
+  if (ids.mme_ue_s1ap_id_present) {
+    return get_mme_ue_s1ap_id_worker(ids.mme_ue_s1ap_id);
+  }
+  if (ids.proc_code != ASN1_S1AP_ID_INIT_UE_MSG) {
+    // Non UE-associated signalling, e.g. S1 Setup
+    return no_worker;
+  }
+
+  // Initial UE Message. Find the UE the same way the NAS handlers do: by the mobile identity of an Attach Request,
+  // and by the S-TMSI otherwise
+  uint64_t                        imsi      = 0;
+  LIBLTE_MME_EPS_MOBILE_ID_STRUCT mobile_id = {};
+  if (peek_attach_request_mobile_id(ids.nas_pdu, mobile_id)) {
+    if (mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI) {
+      for (int i = 0; i <= 14; i++) {
+        imsi = imsi * 10 + mobile_id.imsi[i];
+      }
+    } else if (mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI) {
+      m_tmsi_to_imsi.find(mobile_id.guti.m_tmsi, imsi);
+    }
+  } else if (ids.s_tmsi_present) {
+    m_tmsi_to_imsi.find(ids.m_tmsi, imsi);
+  }
+  if (imsi != 0) {
+    return get_imsi_worker(imsi);
+  }
+
+  // The MME does not know the UE yet (e.g. GUTI attach from another MME). Any worker can create its context
+  uint64_t enb_ue_id = ((uint64_t)(uint32_t)enb_sri->sinfo_assoc_id << 32U) | ids.enb_ue_s1ap_id;
+  return ue_id_hash(enb_ue_id) % m_nof_workers;
 }
 
 int s1ap::enb_listen()
@@ -223,6 +398,7 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
   }
 
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(buf->msg, buf->N_bytes);
   }
 
@@ -233,6 +409,7 @@ void s1ap::handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, struct sctp_sndrcvinfo
 {
   // Save PCAP
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
@@ -317,6 +494,8 @@ void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinf
   std::set<uint32_t> ue_set;
   enb_ctx_t*         enb_ptr = new enb_ctx_t;
   *enb_ptr                   = enb_ctx;
+
+  std::lock_guard<std::mutex> lock(m_enb_mutex);
   m_active_enbs.emplace(enb_ptr->enb_id, enb_ptr);
   m_sctp_to_enb_id.emplace(enb_sri->sinfo_assoc_id, enb_ptr->enb_id);
   m_enb_assoc_to_ue_ids.emplace(enb_sri->sinfo_assoc_id, ue_set);
@@ -324,6 +503,7 @@ void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinf
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 {
+  std::lock_guard<std::mutex>              lock(m_enb_mutex);
   std::map<uint16_t, enb_ctx_t*>::iterator it = m_active_enbs.find(enb_id);
   if (it == m_active_enbs.end()) {
     return nullptr;
@@ -334,11 +514,16 @@ enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 
 void s1ap::delete_enb_ctx(int32_t assoc_id)
 {
+  std::lock_guard<std::mutex>           lock(m_enb_mutex);
   std::map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
-  uint16_t                              enb_id   = it_assoc->second;
+  if (it_assoc == m_sctp_to_enb_id.end()) {
+    m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
+    return;
+  }
+  uint16_t enb_id = it_assoc->second;
 
   std::map<uint16_t, enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
-  if (it_ctx == m_active_enbs.end() || it_assoc == m_sctp_to_enb_id.end()) {
+  if (it_ctx == m_active_enbs.end()) {
     m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
     return;
   }
@@ -353,25 +538,24 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
   delete it_ctx->second;
   m_active_enbs.erase(it_ctx);
   m_sctp_to_enb_id.erase(it_assoc);
+  m_enb_assoc_to_ue_ids.erase(assoc_id);
   return;
 }
 
 // UE Context Management
 bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 {
-  std::map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
-  if (ctx_it != m_imsi_to_nas_ctx.end()) {
-    m_logger.error("UE Context already exists. IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
-    return false;
-  }
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-    if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
+    nas* nas_ctx2 = find_nas_ctx_from_mme_ue_s1ap_id(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    if (nas_ctx2 != nullptr && nas_ctx2 != nas_ctx) {
       m_logger.error("Context identified with IMSI does not match context identified by MME UE S1AP Id.");
       return false;
     }
   }
-  m_imsi_to_nas_ctx.emplace(nas_ctx->m_emm_ctx.imsi, nas_ctx);
+  if (not m_imsi_to_nas_ctx.insert(nas_ctx->m_emm_ctx.imsi, nas_ctx)) {
+    m_logger.error("UE Context already exists. IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
+    return false;
+  }
   m_logger.debug("Saved UE context corresponding to IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
   return true;
 }
@@ -382,25 +566,17 @@ bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
     m_logger.error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.");
     return false;
   }
-  std::map<uint32_t, nas*>::iterator ctx_it = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-  if (ctx_it != m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  if (not m_mme_ue_s1ap_id_to_nas_ctx.insert(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_ctx)) {
     m_logger.error("UE Context already exists. MME UE S1AP Id %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
-  if (nas_ctx->m_emm_ctx.imsi != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-    if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
-      m_logger.error("Context identified with MME UE S1AP Id does not match context identified by IMSI.");
-      return false;
-    }
-  }
-  m_mme_ue_s1ap_id_to_nas_ctx.emplace(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_ctx);
   m_logger.debug("Saved UE context corresponding to MME UE S1AP Id %d", nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
   return true;
 }
 
 bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
+  std::lock_guard<std::mutex>                      lock(m_enb_mutex);
   std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
   if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
     m_logger.error("Could not find eNB from eNB SCTP association %d", enb_assoc);
@@ -418,36 +594,42 @@ bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 
 nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
-  std::map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
-    return NULL;
-  } else {
-    return it->second;
-  }
+  nas* nas_ctx = NULL;
+  m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id, nas_ctx);
+  return nas_ctx;
 }
 
 nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 {
-  std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
-  if (it == m_imsi_to_nas_ctx.end()) {
-    return NULL;
-  } else {
-    return it->second;
-  }
+  nas* nas_ctx = NULL;
+  m_imsi_to_nas_ctx.find(imsi, nas_ctx);
+  return nas_ctx;
 }
 
+// Called with m_enb_mutex locked. With several workers, they must be paused, as the UEs of the eNB can belong to any
+// of them
 void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
   srsran::console("Releasing UEs context\n");
   std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  std::set<uint32_t>::iterator                     ue_id      = ues_in_enb->second.begin();
+  if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
+    m_logger.error("Could not find eNB from eNB SCTP association %d", enb_assoc);
+    return;
+  }
+  std::set<uint32_t>::iterator ue_id = ues_in_enb->second.begin();
   if (ue_id == ues_in_enb->second.end()) {
     srsran::console("No UEs to be released\n");
   } else {
     while (ue_id != ues_in_enb->second.end()) {
-      std::map<uint32_t, nas*>::iterator nas_ctx = m_mme_ue_s1ap_id_to_nas_ctx.find(*ue_id);
-      emm_ctx_t*                         emm_ctx = &nas_ctx->second->m_emm_ctx;
-      ecm_ctx_t*                         ecm_ctx = &nas_ctx->second->m_ecm_ctx;
+      nas* nas_ctx = find_nas_ctx_from_mme_ue_s1ap_id(*ue_id);
+      if (nas_ctx == NULL) {
+        m_logger.warning("Could not find UE context to release. MME UE S1AP Id: %d", *ue_id);
+        ues_in_enb->second.erase(ue_id++);
+        continue;
+      }
+      m_mme_ue_s1ap_id_to_nas_ctx.erase(*ue_id);
+      emm_ctx_t* emm_ctx = &nas_ctx->m_emm_ctx;
+      ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
 
       m_logger.info(
           "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
@@ -474,18 +656,21 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
   ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
 
   // Delete UE within eNB UE set
-  std::map<int32_t, uint16_t>::iterator it = m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (it == m_sctp_to_enb_id.end()) {
-    m_logger.error("Could not find eNB for UE release request.");
-    return false;
-  }
-  uint16_t                                         enb_id = it->second;
-  std::map<int32_t, std::set<uint32_t> >::iterator ue_set = m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (ue_set == m_enb_assoc_to_ue_ids.end()) {
-    m_logger.error("Could not find the eNB's UEs.");
-    return false;
+  {
+    std::lock_guard<std::mutex>           lock(m_enb_mutex);
+    std::map<int32_t, uint16_t>::iterator it = m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id);
+    if (it == m_sctp_to_enb_id.end()) {
+      m_logger.error("Could not find eNB for UE release request.");
+      return false;
+    }
+    std::map<int32_t, std::set<uint32_t> >::iterator ue_set =
+        m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
+    if (ue_set == m_enb_assoc_to_ue_ids.end()) {
+      m_logger.error("Could not find the eNB's UEs.");
+      return false;
+    }
+    ue_set->second.erase(mme_ue_s1ap_id);
   }
-  ue_set->second.erase(mme_ue_s1ap_id);
 
   // Release UE ECM context
   m_mme_ue_s1ap_id_to_nas_ctx.erase(mme_ue_s1ap_id);
@@ -517,24 +702,37 @@ bool s1ap::delete_ue_ctx(uint64_t imsi)
   return true;
 }
 
+// Called by the worker that owns the old context
+void s1ap::replace_nas_ctx(uint64_t imsi, nas* old_ctx, nas* new_ctx)
+{
+  // The old context may be gone already, e.g. if the UE was detached in the meantime
+  if (find_nas_ctx_from_imsi(imsi) == old_ctx) {
+    delete_ue_ctx(imsi);
+  }
+  if (not m_imsi_to_nas_ctx.insert(imsi, new_ctx)) {
+    m_logger.error("UE Context already exists. IMSI %015" PRIu64 "", imsi);
+    return;
+  }
+  m_logger.debug("Saved UE context corresponding to IMSI %015" PRIu64 "", imsi);
+}
+
 // UE Bearer Managment
 void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
-  std::map<uint64_t, nas*>::iterator ue_ctx_it = m_imsi_to_nas_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_nas_ctx.end()) {
+  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+  if (nas_ctx == NULL) {
     m_logger.error("Could not activate EPS bearer: Could not find UE context");
     return;
   }
   // Make sure NAS is active
-  uint32_t                           mme_ue_s1ap_id = ue_ctx_it->second->m_ecm_ctx.mme_ue_s1ap_id;
-  std::map<uint32_t, nas*>::iterator it             = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  uint32_t mme_ue_s1ap_id = nas_ctx->m_ecm_ctx.mme_ue_s1ap_id;
+  if (not m_mme_ue_s1ap_id_to_nas_ctx.contains(mme_ue_s1ap_id)) {
     m_logger.error("Could not activate EPS bearer: ECM context seems to be missing");
     return;
   }
 
-  ecm_ctx_t* ecm_ctx = &ue_ctx_it->second->m_ecm_ctx;
-  esm_ctx_t* esm_ctx = &ue_ctx_it->second->m_esm_ctx[ebi];
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+  esm_ctx_t* esm_ctx = &nas_ctx->m_esm_ctx[ebi];
   if (esm_ctx->state != ERAB_CTX_SETUP) {
     m_logger.error(
         "Could not be activate EPS Bearer, bearer in wrong state: MME S1AP Id %d, EPS Bearer id %d, state %d",
@@ -557,20 +755,23 @@ void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 
 uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 {
-  uint32_t m_tmsi = m_next_m_tmsi;
-  m_next_m_tmsi   = (m_next_m_tmsi + 1) % UINT32_MAX;
+  uint32_t m_tmsi = m_next_m_tmsi.fetch_add(1, std::memory_order_relaxed);
+  if (m_tmsi == UINT32_MAX) {
+    // 0xFFFFFFFF is not a valid M-TMSI
+    m_tmsi = m_next_m_tmsi.fetch_add(1, std::memory_order_relaxed);
+  }
 
-  m_tmsi_to_imsi.emplace(m_tmsi, imsi);
+  m_tmsi_to_imsi.insert(m_tmsi, imsi);
   m_logger.debug("Allocated M-TMSI 0x%x to IMSI %015" PRIu64 ",", m_tmsi, imsi);
   return m_tmsi;
 }
 
 uint64_t s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi)
 {
-  std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
-  if (it != m_tmsi_to_imsi.end()) {
-    m_logger.debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x", it->second, m_tmsi);
-    return it->second;
+  uint64_t imsi = 0;
+  if (m_tmsi_to_imsi.find(m_tmsi, imsi)) {
+    m_logger.debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x", imsi, m_tmsi);
+    return imsi;
   } else {
     m_logger.debug("Could not find IMSI from M-TMSI 0x%x", m_tmsi);
     return SRSRAN_SUCCESS;
@@ -28,10 +28,12 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <inttypes.h> // for printing uint64_t
+#include <linux/filter.h>
 #include <linux/if.h>
 #include <linux/if_tun.h>
 #include <linux/ip.h>
 #include <netinet/in.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 
@@ -44,7 +46,7 @@ namespace srsepc {
  *
  **************************************/
 
-spgw::gtpu::gtpu() : m_sgi_up(false), m_s1u_up(false)
+spgw::gtpu::gtpu() : m_nof_workers(1), m_sgi_up(false), m_s1u_up(false), m_dl_notif_fd(-1)
 {
   return;
 }
@@ -62,6 +64,15 @@ int spgw::gtpu::init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc)
   m_spgw = spgw;
   m_gtpc = gtpc;
 
+  m_nof_workers = std::max(args->nof_up_workers, 1U);
+  if (m_nof_workers > 1) {
+    m_dl_notif_fd = eventfd(0, EFD_NONBLOCK);
+    if (m_dl_notif_fd < 0) {
+      m_logger.error("Failed to create downlink notification eventfd: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+  }
+
   // Init SGi interface
   err = init_sgi(args);
   if (err != SRSRAN_SUCCESS) {
@@ -85,11 +96,19 @@ void spgw::gtpu::stop()
 {
   // Clean up SGi interface
   if (m_sgi_up) {
-    close(m_sgi);
+    for (int sgi_queue : m_sgi_queues) {
+      close(sgi_queue);
+    }
   }
-  // Clean up S1-U socket
+  // Clean up S1-U sockets
   if (m_s1u_up) {
-    close(m_s1u);
+    for (int s1u_sock : m_s1u_socks) {
+      close(s1u_sock);
+    }
+  }
+  if (m_dl_notif_fd >= 0) {
+    close(m_dl_notif_fd);
+    m_dl_notif_fd = -1;
   }
 }
 
@@ -110,8 +129,14 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
     return SRSRAN_ERROR_CANT_START;
   }
 
+  // With several user plane workers, each one reads from its own TUN queue
+  short tun_flags = IFF_TUN | IFF_NO_PI;
+  if (m_nof_workers > 1) {
+    tun_flags |= IFF_MULTI_QUEUE;
+  }
+
   memset(&ifr, 0, sizeof(ifr));
-  ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+  ifr.ifr_flags = tun_flags;
   strncpy(
       ifr.ifr_ifrn.ifrn_name, args->sgi_if_name.c_str(), std::min(args->sgi_if_name.length(), (size_t)(IFNAMSIZ - 1)));
   ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = '\0';
@@ -168,51 +193,132 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
   }
 
   close(sgi_sock);
+  m_sgi_queues.push_back(m_sgi);
   m_sgi_up = true;
-  m_logger.info("Initialized SGi interface");
+
+  // Attach one more queue to the TUN device per additional user plane worker
+  for (uint32_t i = 1; i < m_nof_workers; ++i) {
+    int sgi_queue = open("/dev/net/tun", O_RDWR);
+    if (sgi_queue < 0) {
+      m_logger.error("Failed to open TUN device queue: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = tun_flags;
+    strncpy(ifr.ifr_ifrn.ifrn_name,
+            args->sgi_if_name.c_str(),
+            std::min(args->sgi_if_name.length(), (size_t)(IFNAMSIZ - 1)));
+    ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = '\0';
+    if (ioctl(sgi_queue, TUNSETIFF, &ifr) < 0) {
+      m_logger.error("Failed to attach queue %d to TUN device: %s", i, strerror(errno));
+      close(sgi_queue);
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_sgi_queues.push_back(sgi_queue);
+  }
+  m_logger.info("Initialized SGi interface with %d queue(s)", m_nof_workers);
   return SRSRAN_SUCCESS;
 }
 
 int spgw::gtpu::init_s1u(spgw_args_t* args)
 {
-  // Open S1-U socket
-  m_s1u = socket(AF_INET, SOCK_DGRAM, 0);
-  if (m_s1u == -1) {
-    m_logger.error("Failed to open socket: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
-  }
-  m_s1u_up = true;
-
-  // Bind the socket
-  m_s1u_addr.sin_family      = AF_INET;
+  // Bind address
+  m_s1u_addr.sin_family = AF_INET;
   if (inet_pton(m_s1u_addr.sin_family, args->gtpu_bind_addr.c_str(), &m_s1u_addr.sin_addr.s_addr) != 1) {
     m_logger.error("Invalid gtpu_bind_addr: %s", args->gtpu_bind_addr.c_str());
     srsran::console("Invalid gtpu_bind_addr: %s\n", args->gtpu_bind_addr.c_str());
     return SRSRAN_ERROR_CANT_START;
   }
-  m_s1u_addr.sin_port        = htons(GTPU_RX_PORT);
-
-  if (bind(m_s1u, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
-    m_logger.error("Failed to bind socket: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
+  m_s1u_addr.sin_port = htons(GTPU_RX_PORT);
+
+  // Open S1-U sockets. With several user plane workers, all of them are bound to the same port via SO_REUSEPORT
+  for (uint32_t i = 0; i < m_nof_workers; ++i) {
+    int s1u_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (s1u_sock == -1) {
+      m_logger.error("Failed to open socket: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_s1u_socks.push_back(s1u_sock);
+    m_s1u_up = true;
+
+    int enable = 1;
+    if (m_nof_workers > 1 and setsockopt(s1u_sock, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int)) < 0) {
+      m_logger.error("Failed to set SO_REUSEPORT: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+
+    // Bind the socket
+    if (bind(s1u_sock, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
+      m_logger.error("Failed to bind socket: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+  }
+  m_s1u = m_s1u_socks[0];
+
+  // All the datagrams come from the same eNB address and port, so the default SO_REUSEPORT flow hash would send them
+  // to the same socket. Instead, select the socket (i.e. the worker) as TEID % nof_workers. The BPF program runs with
+  // the UDP payload as packet data, and the TEID is at offset 4 of the GTP-U header.
+  if (m_nof_workers > 1) {
+    struct sock_filter code[] = {{BPF_LD | BPF_W | BPF_ABS, 0, 0, 4},
+                                 {BPF_ALU | BPF_MOD | BPF_K, 0, 0, m_nof_workers},
+                                 {BPF_RET | BPF_A, 0, 0, 0}};
+    struct sock_fprog  prog   = {};
+    prog.len                  = sizeof(code) / sizeof(code[0]);
+    prog.filter               = code;
+    if (setsockopt(m_s1u, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+      m_logger.warning("Failed to attach TEID sharding filter, using the kernel flow hash: %s", strerror(errno));
+    }
   }
+
   m_logger.info("S1-U socket = %d", m_s1u);
   m_logger.info("S1-U IP = %s, Port = %d ", inet_ntoa(m_s1u_addr.sin_addr), ntohs(m_s1u_addr.sin_port));
 
-  m_logger.info("Initialized S1-U interface");
+  m_logger.info("Initialized S1-U interface with %d socket(s)", m_nof_workers);
   return SRSRAN_SUCCESS;
 }
 
-void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
+void spgw::gtpu::handle_sgi_rx(uint32_t worker_idx)
+{
+  /*
+   * SGi messages may need to be queued when waiting for UE Paging procedure.
+   * For this reason, buffers for SGi pdus are allocated here and deallocated
+   * at the gtpu::send_s1u_pdu() when the PDU is sent, at handle_sgi_pdu() when the PDU is dropped or at
+   * gtpc::free_all_queued_packets, which is called when the Downlink Data Notification
+   * procedure fails (see handle_downlink_data_notification_acknowledgment and
+   * handle_downlink_data_notification_failure)
+   */
+  srsran::unique_byte_buffer_t sgi_msg = srsran::make_byte_buffer("spgw::gtpu::sgi_msg");
+  if (sgi_msg == nullptr) {
+    m_logger.error("Couldn't allocate buffer for SGi PDU");
+    return;
+  }
+  int n = read(m_sgi_queues[worker_idx], sgi_msg->msg, sgi_msg->get_tailroom());
+  if (n <= 0) {
+    m_logger.error("Error reading from TUN interface: %s", strerror(errno));
+    return;
+  }
+  sgi_msg->N_bytes = n;
+  handle_sgi_pdu(std::move(sgi_msg), worker_idx);
+}
+
+void spgw::gtpu::handle_s1u_rx(srsran::byte_buffer_t* msg, uint32_t worker_idx)
 {
-  bool usr_found = false;
-  bool ctr_found = false;
-
-  std::map<uint32_t, srsran::gtpc_f_teid_ie>::iterator gtpu_fteid_it;
-  std::map<in_addr_t, uint32_t>::iterator              gtpc_teid_it;
-  srsran::gtpc_f_teid_ie                               enb_fteid;
-  uint32_t                                             spgw_teid;
-  struct iphdr*                                        iph = (struct iphdr*)msg->msg;
+  struct sockaddr_in src_addr_in;
+  socklen_t          addrlen = sizeof(src_addr_in);
+  msg->clear();
+  int n = recvfrom(
+      m_s1u_socks[worker_idx], msg->msg, msg->get_tailroom(), 0, (struct sockaddr*)&src_addr_in, &addrlen);
+  if (n <= 0) {
+    m_logger.error("Error reading from S1-U socket: %s", strerror(errno));
+    return;
+  }
+  msg->N_bytes = n;
+  handle_s1u_pdu(msg, worker_idx);
+}
+
+void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg, uint32_t worker_idx)
+{
+  struct iphdr* iph = (struct iphdr*)msg->msg;
   m_logger.debug("Received SGi PDU. Bytes %d", msg->N_bytes);
 
   if (iph->version != 4) {
@@ -234,41 +340,68 @@ void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
   m_logger.debug("SGi PDU -- IP dst addr %s", srsran::to_c_str(buffer));
 
   // Find user and control tunnel
-  gtpu_fteid_it = m_ip_to_usr_teid.find(iph->daddr);
-  if (gtpu_fteid_it != m_ip_to_usr_teid.end()) {
-    usr_found = true;
-    enb_fteid = gtpu_fteid_it->second;
-  }
-  gtpc_teid_it = m_ip_to_ctr_teid.find(iph->daddr);
-  if (gtpc_teid_it != m_ip_to_ctr_teid.end()) {
-    ctr_found = true;
-    spgw_teid = gtpc_teid_it->second;
-  }
+  gtpu_tunnel_table::tunnel_info tun = m_tunnels.find(iph->daddr);
 
   // Handle SGi packet
-  if (usr_found == false && ctr_found == false) {
+  if (tun.usr_found == false && tun.ctr_found == false) {
     m_logger.debug("Packet for unknown UE.");
-  } else if (usr_found == false && ctr_found == true) {
+  } else if (tun.usr_found == false && tun.ctr_found == true) {
     m_logger.debug("Packet for attached UE that is not ECM connected.");
+    if (m_nof_workers > 1) {
+      // GTP-C state is only accessed from the S11 thread
+      std::lock_guard<std::mutex> lock(m_dl_notif_mutex);
+      m_dl_notif_pdus.emplace_back(tun.ctr_teid, std::move(msg));
+      uint64_t one = 1;
+      if (write(m_dl_notif_fd, &one, sizeof(one)) != sizeof(one)) {
+        m_logger.error("Failed to signal the S11 thread of a pending Downlink Notification");
+      }
+      return;
+    }
     m_logger.debug("Triggering Donwlink Notification Requset.");
-    m_gtpc->send_downlink_data_notification(spgw_teid);
-    m_gtpc->queue_downlink_packet(spgw_teid, std::move(msg));
+    m_gtpc->send_downlink_data_notification(tun.ctr_teid);
+    m_gtpc->queue_downlink_packet(tun.ctr_teid, std::move(msg));
     return;
-  } else if (usr_found == true && ctr_found == false) {
+  } else if (tun.usr_found == true && tun.ctr_found == false) {
     m_logger.error("User plane tunnel found without a control plane tunnel present.");
   } else {
-    send_s1u_pdu(enb_fteid, msg.get());
+    send_s1u_pdu(tun.usr_fteid, msg.get(), worker_idx);
+  }
+}
+
+void spgw::gtpu::handle_pending_dl_notifications()
+{
+  uint64_t nof_events;
+  if (read(m_dl_notif_fd, &nof_events, sizeof(nof_events)) != sizeof(nof_events)) {
+    return;
+  }
+  std::vector<std::pair<uint32_t, srsran::unique_byte_buffer_t> > pdus;
+  {
+    std::lock_guard<std::mutex> lock(m_dl_notif_mutex);
+    pdus.swap(m_dl_notif_pdus);
+  }
+
+  for (auto& pdu : pdus) {
+    // The UE may have become ECM connected since the PDU was received by the worker
+    struct iphdr*                  iph = (struct iphdr*)pdu.second->msg;
+    gtpu_tunnel_table::tunnel_info tun = m_tunnels.find(iph->daddr);
+    if (tun.usr_found and tun.ctr_found) {
+      send_s1u_pdu(tun.usr_fteid, pdu.second.get());
+      continue;
+    }
+    m_logger.debug("Triggering Donwlink Notification Requset.");
+    m_gtpc->send_downlink_data_notification(pdu.first);
+    m_gtpc->queue_downlink_packet(pdu.first, std::move(pdu.second));
   }
 }
 
-void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg)
+void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg, uint32_t worker_idx)
 {
   srsran::gtpu_header_t header;
   srsran::gtpu_read_header(msg, &header, m_logger);
 
   m_logger.debug("Received PDU from S1-U. Bytes=%d", msg->N_bytes);
   m_logger.debug("TEID 0x%x. Bytes=%d", header.teid, msg->N_bytes);
-  int n = write(m_sgi, msg->msg, msg->N_bytes);
+  int n = write(m_sgi_queues[worker_idx], msg->msg, msg->N_bytes);
   if (n < 0) {
     m_logger.error("Could not write to TUN interface.");
   } else {
@@ -277,7 +410,7 @@ void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg)
   return;
 }
 
-void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg)
+void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg, uint32_t worker_idx)
 {
   // Set eNB destination address
   struct sockaddr_in enb_addr;
@@ -303,7 +436,7 @@ void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer
   }
 
   // Send packet to destination
-  n = sendto(m_s1u, msg->msg, msg->N_bytes, 0, (struct sockaddr*)&enb_addr, sizeof(enb_addr));
+  n = sendto(m_s1u_socks[worker_idx], msg->msg, msg->N_bytes, 0, (struct sockaddr*)&enb_addr, sizeof(enb_addr));
   if (n < 0) {
     m_logger.error("Error sending packet to eNB");
   } else if ((unsigned int)n != msg->N_bytes) {
@@ -340,17 +473,17 @@ bool spgw::gtpu::modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtpc_f_teid_ie dw
   srsran::gtpu_ntoa(buffer, dw_user_fteid.ipv4);
   m_logger.info("Downlink eNB addr %s, U-TEID 0x%x", srsran::to_c_str(buffer), dw_user_fteid.teid);
   m_logger.info("Uplink C-TEID: 0x%x", up_ctrl_teid);
-  m_ip_to_usr_teid[ue_ipv4] = dw_user_fteid;
-  m_ip_to_ctr_teid[ue_ipv4] = up_ctrl_teid;
+  if (not m_tunnels.set_tunnel(ue_ipv4, dw_user_fteid, up_ctrl_teid)) {
+    m_logger.error("GTP-U tunnel table is full.");
+    return false;
+  }
   return true;
 }
 
 bool spgw::gtpu::delete_gtpu_tunnel(in_addr_t ue_ipv4)
 {
   // Remove GTP-U connections, if any.
-  if (m_ip_to_usr_teid.count(ue_ipv4)) {
-    m_ip_to_usr_teid.erase(ue_ipv4);
-  } else {
+  if (not m_tunnels.erase_usr(ue_ipv4)) {
     m_logger.error("Could not find GTP-U Tunnel to delete.");
     return false;
   }
@@ -360,13 +493,59 @@ bool spgw::gtpu::delete_gtpu_tunnel(in_addr_t ue_ipv4)
 bool spgw::gtpu::delete_gtpc_tunnel(in_addr_t ue_ipv4)
 {
   // Remove Ctrl TEID from IP mapping.
-  if (m_ip_to_ctr_teid.count(ue_ipv4)) {
-    m_ip_to_ctr_teid.erase(ue_ipv4);
-  } else {
+  if (not m_tunnels.erase_ctr(ue_ipv4)) {
     m_logger.error("Could not find GTP-C Tunnel info to delete.");
     return false;
   }
   return true;
 }
 
+/**************************************
+ *
+ * User plane worker
+ *
+ **************************************/
+
+spgw::gtpu_worker::gtpu_worker(spgw::gtpu* gtpu, uint32_t worker_idx) :
+  thread("GTPU_WORKER" + std::to_string(worker_idx)), m_gtpu(gtpu), m_worker_idx(worker_idx), m_running(false)
+{}
+
+void spgw::gtpu_worker::stop()
+{
+  if (m_running) {
+    m_running = false;
+    thread_cancel();
+    wait_thread_finish();
+  }
+}
+
+void spgw::gtpu_worker::run_thread()
+{
+  m_running                            = true;
+  srsran::unique_byte_buffer_t s1u_msg = srsran::make_byte_buffer("spgw::gtpu_worker::s1u");
+
+  int sgi = m_gtpu->get_sgi(m_worker_idx);
+  int s1u = m_gtpu->get_s1u(m_worker_idx);
+
+  fd_set set;
+  int    max_fd = std::max(s1u, sgi);
+  while (m_running) {
+    FD_ZERO(&set);
+    FD_SET(s1u, &set);
+    FD_SET(sgi, &set);
+
+    int n = select(max_fd + 1, &set, NULL, NULL, NULL);
+    if (n == -1) {
+      m_logger.error("Error from select");
+    } else if (n) {
+      if (FD_ISSET(sgi, &set)) {
+        m_gtpu->handle_sgi_rx(m_worker_idx);
+      }
+      if (FD_ISSET(s1u, &set)) {
+        m_gtpu->handle_s1u_rx(s1u_msg.get(), m_worker_idx);
+      }
+    }
+  }
+}
+
 } // namespace srsepc
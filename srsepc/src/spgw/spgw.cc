@@ -81,6 +81,14 @@ int spgw::init(spgw_args_t* args, const std::map<std::string, uint64_t>& ip_to_i
     return SRSRAN_ERROR_CANT_START;
   }
 
+  // With more than one user plane worker, the SP-GW thread is left to serve S11
+  if (m_gtpu->get_nof_workers() > 1) {
+    for (uint32_t i = 0; i < m_gtpu->get_nof_workers(); ++i) {
+      m_gtpu_workers.emplace_back(new gtpu_worker(m_gtpu, i));
+    }
+    srsran::console("SP-GW user plane running in %d worker threads.\n", m_gtpu->get_nof_workers());
+  }
+
   m_logger.info("SP-GW Initialized.");
   srsran::console("SP-GW Initialized.\n");
   return SRSRAN_SUCCESS;
@@ -93,6 +101,9 @@ void spgw::stop()
     thread_cancel();
     wait_thread_finish();
   }
+  for (auto& worker : m_gtpu_workers) {
+    worker->stop();
+  }
 
   m_gtpu->stop();
   m_gtpc->stop();
@@ -103,55 +114,54 @@ void spgw::run_thread()
 {
   // Mark the thread as running
   m_running = true;
-  srsran::unique_byte_buffer_t sgi_msg, s1u_msg, s11_msg;
+  srsran::unique_byte_buffer_t s1u_msg, s11_msg;
   s1u_msg = srsran::make_byte_buffer("spgw::run_thread::s1u");
   s11_msg = srsran::make_byte_buffer("spgw::run_thread::s11");
 
-  struct sockaddr_in src_addr_in;
   struct sockaddr_un src_addr_un;
-  struct iphdr*      ip_pkt;
 
-  int sgi = m_gtpu->get_sgi();
-  int s1u = m_gtpu->get_s1u();
-  int s11 = m_gtpc->get_s11();
+  for (auto& worker : m_gtpu_workers) {
+    worker->start();
+  }
+
+  // With user plane workers, this thread serves S11 and the Downlink Data Notifications raised by the workers
+  bool serve_up = m_gtpu_workers.empty();
+  int  sgi      = m_gtpu->get_sgi();
+  int  s1u      = m_gtpu->get_s1u();
+  int  dl_notif = m_gtpu->get_dl_notification_fd();
+  int  s11      = m_gtpc->get_s11();
 
   size_t buf_len = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
 
   fd_set set;
-  int    max_fd = std::max(s1u, sgi);
+  int    max_fd = serve_up ? std::max(s1u, sgi) : dl_notif;
   max_fd        = std::max(max_fd, s11);
   while (m_running) {
-    s1u_msg->clear();
     s11_msg->clear();
 
     FD_ZERO(&set);
-    FD_SET(s1u, &set);
-    FD_SET(sgi, &set);
+    if (serve_up) {
+      FD_SET(s1u, &set);
+      FD_SET(sgi, &set);
+    } else {
+      FD_SET(dl_notif, &set);
+    }
     FD_SET(s11, &set);
 
     int n = select(max_fd + 1, &set, NULL, NULL, NULL);
     if (n == -1) {
       m_logger.error("Error from select");
     } else if (n) {
-      if (FD_ISSET(sgi, &set)) {
-        /*
-         * SGi messages may need to be queued when waiting for UE Paging procedure.
-         * For this reason, buffers for SGi pdus are allocated here and deallocated
-         * at the gtpu::send_s1u_pdu() when the PDU is sent, at handle_sgi_pdu() when the PDU is dropped or at
-         * gtpc::free_all_queued_packets, which is called when the Downlink Data Notification
-         * procedure fails (see handle_downlink_data_notification_acknowledgment and
-         * handle_downlink_data_notification_failure)
-         */
+      if (serve_up and FD_ISSET(sgi, &set)) {
         m_logger.debug("Message received at SPGW: SGi Message");
-        sgi_msg          = srsran::make_byte_buffer("spgw::run_thread::sgi_msg");
-        sgi_msg->N_bytes = read(sgi, sgi_msg->msg, buf_len);
-        m_gtpu->handle_sgi_pdu(std::move(sgi_msg));
+        m_gtpu->handle_sgi_rx();
       }
-      if (FD_ISSET(s1u, &set)) {
+      if (serve_up and FD_ISSET(s1u, &set)) {
         m_logger.debug("Message received at SPGW: S1-U Message");
-        socklen_t addrlen = sizeof(src_addr_in);
-        s1u_msg->N_bytes  = recvfrom(s1u, s1u_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_in, &addrlen);
-        m_gtpu->handle_s1u_pdu(s1u_msg.get());
+        m_gtpu->handle_s1u_rx(s1u_msg.get());
+      }
+      if (not serve_up and FD_ISSET(dl_notif, &set)) {
+        m_gtpu->handle_pending_dl_notifications();
       }
       if (FD_ISSET(s11, &set)) {
         m_logger.debug("Message received at SPGW: S11 Message");
@@ -0,0 +1,188 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/spgw/gtpu_tunnel_table.h"
+#include "srsran/common/test_common.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace srsepc {
+
+const uint32_t first_ue_ip   = 0xac100002; // 172.16.0.2
+const uint32_t enb_ip        = 0x7f000001; // 127.0.0.1
+const uint32_t nof_up_shards = 4;
+
+in_addr_t ue_ip(uint32_t i)
+{
+  return htonl(first_ue_ip + i);
+}
+
+// TEIDs are allocated so that consecutive UEs are served by different user plane workers (TEID % nof_up_shards)
+srsran::gtp_fteid_t usr_fteid(uint32_t i, uint32_t gen = 0)
+{
+  srsran::gtp_fteid_t fteid = {};
+  fteid.teid                = (gen << 16U) + i + 1;
+  fteid.ipv4                = htonl(enb_ip);
+  return fteid;
+}
+
+uint32_t ctr_teid(uint32_t i, uint32_t gen = 0)
+{
+  return (gen << 16U) + 0x1000 + i;
+}
+
+int test_insert_find_erase()
+{
+  // Small table, so that the probe chains are long and wrap around the end of the table
+  const uint32_t    nof_ues = 60;
+  gtpu_tunnel_table table(64);
+
+  // Unknown UE and the reserved 0.0.0.0 key
+  TESTASSERT(not table.find(ue_ip(0)).usr_found);
+  TESTASSERT(not table.find(0).ctr_found);
+  TESTASSERT(not table.set_tunnel(0, usr_fteid(0), ctr_teid(0)));
+
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    TESTASSERT(table.set_tunnel(ue_ip(i), usr_fteid(i), ctr_teid(i)));
+  }
+  std::vector<uint32_t> ues_per_shard(nof_up_shards, 0);
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    gtpu_tunnel_table::tunnel_info info = table.find(ue_ip(i));
+    TESTASSERT(info.usr_found and info.ctr_found);
+    TESTASSERT(info.usr_fteid.teid == usr_fteid(i).teid);
+    TESTASSERT(info.usr_fteid.ipv4 == htonl(enb_ip));
+    TESTASSERT(info.ctr_teid == ctr_teid(i));
+    ues_per_shard[info.usr_fteid.teid % nof_up_shards]++;
+  }
+  for (uint32_t n : ues_per_shard) {
+    TESTASSERT(n == nof_ues / nof_up_shards);
+  }
+  TESTASSERT(not table.find(ue_ip(nof_ues)).usr_found);
+
+  // Removal of the user plane tunnel keeps the control TEID, and the other UEs of the probe chain stay reachable
+  for (uint32_t i = 0; i < nof_ues; i += 2) {
+    TESTASSERT(table.erase_usr(ue_ip(i)));
+    TESTASSERT(not table.erase_usr(ue_ip(i)));
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    gtpu_tunnel_table::tunnel_info info = table.find(ue_ip(i));
+    TESTASSERT(info.usr_found == (i % 2 == 1));
+    TESTASSERT(info.ctr_found);
+    TESTASSERT(info.ctr_teid == ctr_teid(i));
+  }
+  for (uint32_t i = 0; i < nof_ues; i += 2) {
+    TESTASSERT(table.erase_ctr(ue_ip(i)));
+    TESTASSERT(not table.erase_ctr(ue_ip(i)));
+    TESTASSERT(not table.find(ue_ip(i)).ctr_found);
+  }
+  TESTASSERT(not table.erase_usr(ue_ip(nof_ues)));
+
+  // A new session of a released UE reuses its slot, in another shard
+  for (uint32_t i = 0; i < nof_ues; i += 2) {
+    TESTASSERT(table.set_tunnel(ue_ip(i), usr_fteid(i + 1, 1), ctr_teid(i, 1)));
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    gtpu_tunnel_table::tunnel_info info = table.find(ue_ip(i));
+    TESTASSERT(info.usr_found and info.ctr_found);
+    TESTASSERT(info.usr_fteid.teid == (i % 2 == 0 ? usr_fteid(i + 1, 1).teid : usr_fteid(i).teid));
+    TESTASSERT(info.ctr_teid == ctr_teid(i, i % 2 == 0 ? 1 : 0));
+  }
+
+  // The table is full once every slot holds a UE
+  for (uint32_t i = nof_ues; i < 64; ++i) {
+    TESTASSERT(table.set_tunnel(ue_ip(i), usr_fteid(i), ctr_teid(i)));
+  }
+  TESTASSERT(not table.set_tunnel(ue_ip(64), usr_fteid(64), ctr_teid(64)));
+  TESTASSERT(not table.find(ue_ip(64)).usr_found);
+  TESTASSERT(table.find(ue_ip(63)).usr_found);
+  return SRSRAN_SUCCESS;
+}
+
+/*
+ * One reader per user plane worker, looking up the UEs of its shard while the S11 thread keeps replacing and
+ * removing their tunnels. A reader must never see a torn entry.
+ */
+int test_concurrent_lookup()
+{
+  const uint32_t    nof_ues  = 256;
+  const uint32_t    nof_gens = 200;
+  gtpu_tunnel_table table(512);
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    TESTASSERT(table.set_tunnel(ue_ip(i), usr_fteid(i), ctr_teid(i)));
+  }
+
+  std::atomic<bool>        running{true};
+  std::atomic<uint32_t>    nof_errors{0};
+  std::vector<std::thread> workers;
+  for (uint32_t shard = 0; shard < nof_up_shards; ++shard) {
+    workers.emplace_back([&, shard]() {
+      while (running.load(std::memory_order_relaxed)) {
+        for (uint32_t i = 0; i < nof_ues; ++i) {
+          if ((i + 1) % nof_up_shards != shard) {
+            continue;
+          }
+          gtpu_tunnel_table::tunnel_info info = table.find(ue_ip(i));
+          if (not info.ctr_found) {
+            // Only the user plane tunnel is ever removed
+            nof_errors++;
+            continue;
+          }
+          uint32_t gen = info.ctr_teid >> 16U;
+          if (info.ctr_teid != ctr_teid(i, gen) or
+              (info.usr_found and (info.usr_fteid.teid != usr_fteid(i, gen).teid or
+                                   info.usr_fteid.ipv4 != htonl(enb_ip)))) {
+            nof_errors++;
+          }
+        }
+      }
+    });
+  }
+
+  for (uint32_t gen = 1; gen < nof_gens; ++gen) {
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      if (gen % 2 == 0) {
+        table.erase_usr(ue_ip(i));
+      }
+      TESTASSERT(table.set_tunnel(ue_ip(i), usr_fteid(i, gen), ctr_teid(i, gen)));
+    }
+  }
+  running = false;
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  TESTASSERT(nof_errors == 0);
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsepc
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(srsepc::test_insert_find_erase() == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_concurrent_lookup() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,252 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srsran/common/test_common.h"
+#include <csignal>
+#include <fstream>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+
+namespace srsepc {
+
+const uint64_t first_imsi = 1010000000000ULL; // 001010000000000
+const uint32_t nof_users  = 1000;
+
+uint64_t sqn_to_uint(const uint8_t* sqn)
+{
+  uint64_t v = 0;
+  for (int i = 0; i < 6; i++) {
+    v = (v << 8U) | sqn[i];
+  }
+  return v;
+}
+
+void uint_to_sqn(uint64_t v, uint8_t* sqn)
+{
+  for (int i = 5; i >= 0; i--) {
+    sqn[i] = v & 0xffU;
+    v >>= 8U;
+  }
+}
+
+void copy_file(const std::string& from, const std::string& to)
+{
+  std::ifstream src(from, std::ios::binary);
+  std::ofstream dst(to, std::ios::binary);
+  dst << src.rdbuf();
+}
+
+int write_user_db(const std::string& filename)
+{
+  std::ofstream db(filename);
+  TESTASSERT(db.is_open());
+  db << "# Test users\n";
+  // Out of IMSI order, and with a duplicate, which is dropped
+  for (uint32_t i = nof_users; i > 0; --i) {
+    db << fmt::format("ue{},{},{:015},00112233445566778899aabbccddeeff,opc,63bfa50ee6523365ff14c1f45f88737d,8000,"
+                      "{:012x},{},{}\n",
+                      i - 1,
+                      (i % 2) ? "mil" : "xor",
+                      first_imsi + i - 1,
+                      i - 1,
+                      7 + i % 3,
+                      (i % 100) ? "dynamic" : fmt::format("172.16.0.{}", i / 100));
+  }
+  db << "dup,mil," << first_imsi << ",00112233445566778899aabbccddeeff,op,63bfa50ee6523365ff14c1f45f88737d,8000,"
+     << "000000000000,9,dynamic\n";
+  return SRSRAN_SUCCESS;
+}
+
+int test_csv_to_binary(const std::string& dir)
+{
+  std::string csv_file = dir + "/user_db.csv";
+  std::string bin_file = dir + "/user_db.bin";
+  TESTASSERT(write_user_db(csv_file) == SRSRAN_SUCCESS);
+
+  hss_db csv_db;
+  TESTASSERT(not hss_db::is_binary(csv_file));
+  TESTASSERT(csv_db.load_csv(csv_file));
+  TESTASSERT(not csv_db.is_binary());
+  TESTASSERT(csv_db.size() == nof_users);
+  TESTASSERT(csv_db.write_binary(bin_file));
+  TESTASSERT(hss_db::is_binary(bin_file));
+
+  hss_db bin_db;
+  TESTASSERT(bin_db.open_binary(bin_file));
+  TESTASSERT(bin_db.is_binary());
+  TESTASSERT(bin_db.size() == nof_users);
+  for (uint32_t i = 0; i < nof_users; ++i) {
+    const hss_ue_ctx_t* ue_ctx = bin_db.find(first_imsi + i);
+    TESTASSERT(ue_ctx != nullptr);
+    TESTASSERT(memcmp(ue_ctx, csv_db.find(first_imsi + i), sizeof(hss_ue_ctx_t)) == 0);
+    TESTASSERT(ue_ctx->imsi == first_imsi + i);
+    TESTASSERT(std::string(ue_ctx->name) == fmt::format("ue{}", i));
+    TESTASSERT(sqn_to_uint(ue_ctx->sqn) == i);
+    TESTASSERT(ue_ctx->qci == 7 + (i + 1) % 3);
+    TESTASSERT(ue_ctx->algo == ((i + 1) % 2 ? HSS_ALGO_MILENAGE : HSS_ALGO_XOR));
+    if (ue_ctx->algo == HSS_ALGO_MILENAGE) {
+      // The key expanded at load gives the same vectors as one expanded from K
+      const srsran::milenage_key& loaded_key = bin_db.get_milenage_key(*ue_ctx);
+      srsran::milenage_key        key(ue_ctx->key);
+      uint8_t                     rand[16] = {(uint8_t)i};
+      srsran::milenage_input_t    in[2]    = {{&loaded_key, ue_ctx->opc, rand, ue_ctx->sqn, ue_ctx->amf},
+                                              {&key, ue_ctx->opc, rand, ue_ctx->sqn, ue_ctx->amf}};
+      srsran::milenage_output_t   out[2]   = {};
+      srsran::milenage_f12345_batch(in, out, 2);
+      TESTASSERT(memcmp(&out[0], &out[1], sizeof(out[0])) == 0);
+    }
+  }
+  TESTASSERT(bin_db.find(first_imsi - 1) == nullptr);
+  TESTASSERT(bin_db.find(first_imsi + nof_users) == nullptr);
+  TESTASSERT(bin_db.get_ip_to_imsi() == csv_db.get_ip_to_imsi());
+  TESTASSERT(bin_db.get_ip_to_imsi().size() == nof_users / 100);
+  TESTASSERT(bin_db.get_ip_to_imsi().at("172.16.0.1") == first_imsi + 99);
+
+  // Back to CSV, without loss
+  std::string csv_file2 = dir + "/user_db2.csv";
+  TESTASSERT(bin_db.write_csv(csv_file2));
+  bin_db.close();
+  hss_db csv_db2;
+  TESTASSERT(csv_db2.load_csv(csv_file2));
+  TESTASSERT(csv_db2.size() == nof_users);
+  for (uint32_t i = 0; i < nof_users; ++i) {
+    TESTASSERT(memcmp(csv_db2.find(first_imsi + i), csv_db.find(first_imsi + i), sizeof(hss_ue_ctx_t)) == 0);
+  }
+
+  unlink(csv_file.c_str());
+  unlink(csv_file2.c_str());
+  return SRSRAN_SUCCESS;
+}
+
+int test_sqn_journal(const std::string& dir)
+{
+  std::string bin_file   = dir + "/user_db.bin";
+  std::string crash_file = dir + "/crash_db.bin";
+  copy_file(bin_file, crash_file);
+
+  {
+    hss_db db;
+    TESTASSERT(db.open_binary(bin_file));
+
+    // Concurrent updates, committed in groups
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t) {
+      threads.emplace_back([&db, t]() {
+        for (uint32_t i = t; i < nof_users; i += 4) {
+          hss_ue_ctx_t* ue_ctx = db.find(first_imsi + i);
+          for (uint32_t n = 0; n < 3; ++n) {
+            uint_to_sqn(sqn_to_uint(ue_ctx->sqn) + 32, ue_ctx->sqn);
+            db.sqn_updated(*ue_ctx);
+          }
+        }
+      });
+    }
+    for (std::thread& t : threads) {
+      t.join();
+    }
+
+    // Crash: the store as it was when the HSS started, and the journal as it is now, plus a torn entry
+    copy_file(bin_file + ".journal", crash_file + ".journal");
+    std::ofstream journal(crash_file + ".journal", std::ios::binary | std::ios::app);
+    journal.write("torn", 4);
+
+    // A compaction that failed to sync the store leaves the rotated journal behind
+    copy_file(bin_file + ".journal", bin_file + ".journal.old");
+  }
+
+  // The journal was folded into the store on close, once the rotated journal was dropped
+  std::ifstream journal(bin_file + ".journal", std::ios::binary | std::ios::ate);
+  TESTASSERT(journal.is_open() and journal.tellg() == 0);
+  TESTASSERT(access((bin_file + ".journal.old").c_str(), F_OK) != 0);
+
+  for (const std::string& filename : {bin_file, crash_file}) {
+    hss_db db;
+    TESTASSERT(db.open_binary(filename));
+    for (uint32_t i = 0; i < nof_users; ++i) {
+      TESTASSERT(sqn_to_uint(db.find(first_imsi + i)->sqn) == i + 3 * 32);
+    }
+    db.close();
+    unlink(filename.c_str());
+    unlink((filename + ".journal").c_str());
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_journal_failure(const std::string& dir)
+{
+  std::string bin_file  = dir + "/user_db.bin";
+  std::string fail_file = dir + "/fail_db.bin";
+  copy_file(bin_file, fail_file);
+
+  hss_db db;
+  TESTASSERT(db.open_binary(fail_file));
+  hss_ue_ctx_t* ue_ctx = db.find(first_imsi);
+  TESTASSERT(ue_ctx != nullptr);
+  uint_to_sqn(32, ue_ctx->sqn);
+  TESTASSERT(db.sqn_updated(*ue_ctx));
+
+  // The journal cannot grow any further
+  struct rlimit limit = {};
+  TESTASSERT(getrlimit(RLIMIT_FSIZE, &limit) == 0);
+  struct rlimit small_limit = limit;
+  small_limit.rlim_cur      = sizeof(uint64_t);
+  signal(SIGXFSZ, SIG_IGN);
+  TESTASSERT(setrlimit(RLIMIT_FSIZE, &small_limit) == 0);
+  uint_to_sqn(64, ue_ctx->sqn);
+  bool ret = db.sqn_updated(*ue_ctx);
+  TESTASSERT(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+  TESTASSERT(not ret);
+
+  // Nothing is accepted after a failed write, as the journal may have lost entries
+  TESTASSERT(not db.sqn_updated(*ue_ctx));
+  db.close();
+
+  TESTASSERT(db.open_binary(fail_file));
+  ue_ctx = db.find(first_imsi);
+  TESTASSERT(db.sqn_updated(*ue_ctx));
+  db.close();
+  unlink(fail_file.c_str());
+  unlink((fail_file + ".journal").c_str());
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsepc
+
+int main()
+{
+  auto& logger = srslog::fetch_basic_logger("HSS", false);
+  logger.set_level(srslog::basic_levels::info);
+  srslog::init();
+
+  char dir[] = "/tmp/hss_db_test_XXXXXX";
+  TESTASSERT(mkdtemp(dir) != nullptr);
+
+  TESTASSERT(srsepc::test_csv_to_binary(dir) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_journal_failure(dir) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_sqn_journal(dir) == SRSRAN_SUCCESS);
+
+  rmdir(dir);
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,614 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * MME attach rate benchmark. Emulated eNBs connect to the MME over S1-MME and run IMSI attaches of Milenage
+ * subscribers end to end, i.e. until the EMM Information that follows the Attach Complete, while a stub S-GW answers
+ * the S11 requests. Requires SCTP support in the kernel.
+ *
+ * Usage: mme_attach_benchmark [nof_workers [nof_ues [nof_enbs]]]
+ */
+
+#include "srsepc/hdr/hss/hss.h"
+#include "srsepc/hdr/mme/mme.h"
+#include "srsran/asn1/liblte_mme.h"
+#include "srsran/asn1/s1ap.h"
+#include "srsran/common/bcd_helpers.h"
+#include "srsran/common/network_utils.h"
+#include "srsran/common/security.h"
+#include "srsran/common/test_common.h"
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+namespace srsepc {
+
+using namespace asn1::s1ap;
+
+const char*    bench_mme_addr = "127.0.1.100";
+const uint16_t bench_mcc      = 0xf001; // 001
+const uint16_t bench_mnc      = 0xff01; // 01
+const uint16_t bench_tac      = 7;
+const uint64_t first_imsi     = 1010000000000ULL; // 001010000000000
+const uint8_t  ue_key[16]     = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+const uint8_t ue_opc[16] = {
+    0x63, 0xbf, 0xa5, 0x0e, 0xe6, 0x52, 0x33, 0x65, 0xff, 0x14, 0xc1, 0xf4, 0x5f, 0x88, 0x73, 0x7d};
+
+struct run_params {
+  uint32_t nof_workers;
+  uint32_t nof_ues;
+  uint32_t nof_enbs;
+  uint32_t max_inflight; ///< attaches in flight per eNB
+};
+
+struct run_result {
+  double attaches_per_sec;
+  double avg_msec; ///< attach latency, from the Initial UE Message to the EMM Information
+  double q50_msec;
+  double q99_msec;
+  double max_msec;
+};
+
+/// Answers the Create Session and Modify Bearer Requests of the MME, in place of the SP-GW
+class stub_sgw
+{
+public:
+  bool init()
+  {
+    sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (sock < 0) {
+      return false;
+    }
+    sockaddr_un addr = {};
+    addr.sun_family  = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", "@spgw_s11");
+    addr.sun_path[0] = '\0';
+    if (bind(sock, (const sockaddr*)&addr, sizeof(addr)) == -1) {
+      return false;
+    }
+    mme_addr            = {};
+    mme_addr.sun_family = AF_UNIX;
+    snprintf(mme_addr.sun_path, sizeof(mme_addr.sun_path), "%s", "@mme_s11");
+    mme_addr.sun_path[0] = '\0';
+
+    // Lets the thread check the running flag
+    timeval tv = {0, 100000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    running = true;
+    worker  = std::thread([this]() { run(); });
+    return true;
+  }
+
+  void stop()
+  {
+    running = false;
+    if (worker.joinable()) {
+      worker.join();
+    }
+    close(sock);
+  }
+
+private:
+  void run()
+  {
+    srsran::gtpc_pdu req, resp;
+    while (running) {
+      if (recv(sock, &req, sizeof(req), 0) != sizeof(req)) {
+        continue;
+      }
+      std::memset(&resp, 0, sizeof(resp));
+      resp.header.teid_present = true;
+      if (req.header.type == srsran::GTPC_MSG_TYPE_CREATE_SESSION_REQUEST) {
+        const srsran::gtpc_create_session_request& cs_req = req.choice.create_session_request;
+        srsran::gtpc_create_session_response&      cs_resp = resp.choice.create_session_response;
+        resp.header.type                                    = srsran::GTPC_MSG_TYPE_CREATE_SESSION_RESPONSE;
+        resp.header.teid                                    = cs_req.sender_f_teid.teid;
+        cs_resp.cause.cause_value                           = srsran::GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+        cs_resp.paa_present                                 = true;
+        cs_resp.paa.pdn_type                                = srsran::GTPC_PDN_TYPE_IPV4;
+        cs_resp.paa.ipv4                                    = htonl(0xac100002 + next_ue_ip++);
+        cs_resp.eps_bearer_context_created.ebi              = cs_req.eps_bearer_context_created.ebi;
+        cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid_present = true;
+        cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid.teid    = cs_req.sender_f_teid.teid;
+        cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid.ipv4    = inet_addr(bench_mme_addr);
+      } else if (req.header.type == srsran::GTPC_MSG_TYPE_MODIFY_BEARER_REQUEST) {
+        resp.header.type = srsran::GTPC_MSG_TYPE_MODIFY_BEARER_RESPONSE;
+        resp.header.teid = req.header.teid;
+        resp.choice.modify_bearer_response.cause.cause_value = srsran::GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+        resp.choice.modify_bearer_response.eps_bearer_context_modified.ebi =
+            req.choice.modify_bearer_request.eps_bearer_context_to_modify.ebi;
+      } else {
+        continue;
+      }
+      sendto(sock, &resp, sizeof(resp), 0, (const sockaddr*)&mme_addr, sizeof(mme_addr));
+    }
+  }
+
+  int               sock = -1;
+  sockaddr_un       mme_addr;
+  uint32_t          next_ue_ip = 0;
+  std::atomic<bool> running{false};
+  std::thread       worker;
+};
+
+/// eNB that attaches its share of the UEs, keeping up to max_inflight attaches in flight
+class enb_emulator
+{
+public:
+  enb_emulator(uint32_t enb_idx, const run_params& params) :
+    enb_id(0x19b + enb_idx), max_inflight(params.max_inflight)
+  {
+    // The UEs are spread across the eNBs, and the eNB UE S1AP Id is the index of the UE in the eNB
+    for (uint32_t i = enb_idx; i < params.nof_ues; i += params.nof_enbs) {
+      ue_t ue   = {};
+      ue.imsi   = first_imsi + i;
+      ue.ue_idx = ues.size();
+      ues.push_back(ue);
+    }
+    latencies_usec.reserve(ues.size());
+  }
+
+  bool s1_setup()
+  {
+    if (not sock.open_socket(srsran::net_utils::addr_family::ipv4,
+                             srsran::net_utils::socket_type::seqpacket,
+                             srsran::net_utils::protocol_type::SCTP) or
+        not sock.connect_to(bench_mme_addr, S1MME_PORT, &mme_addr)) {
+      return false;
+    }
+    // Fail the run rather than hang if the MME stops answering
+    timeval tv = {5, 0};
+    setsockopt(sock.fd(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    uint32_t plmn;
+    srsran::s1ap_mccmnc_to_plmn(bench_mcc, bench_mnc, &plmn);
+    tai.plm_nid.from_number(plmn);
+    tai.tac.from_number(bench_tac);
+    eutran_cgi.plm_nid.from_number(plmn);
+    eutran_cgi.cell_id.from_number(enb_id << 8U);
+
+    plmn = htonl(plmn);
+    s1ap_pdu_c pdu;
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+    s1_setup_request_s& container = pdu.init_msg().value.s1_setup_request();
+    std::memcpy(container->global_enb_id.value.plm_nid.data(), (uint8_t*)&plmn + 1, 3);
+    container->global_enb_id.value.enb_id.set_macro_enb_id().from_number(enb_id);
+    container->supported_tas.value.resize(1);
+    container->supported_tas.value[0].tac.from_number(bench_tac);
+    container->supported_tas.value[0].broadcast_plmns.resize(1);
+    std::memcpy(container->supported_tas.value[0].broadcast_plmns[0].data(), (uint8_t*)&plmn + 1, 3);
+    container->default_paging_drx.value.value = paging_drx_opts::v128;
+    if (not send_pdu(pdu, 0)) {
+      return false;
+    }
+
+    s1ap_pdu_c rx_pdu;
+    return recv_pdu(rx_pdu) and rx_pdu.type().value == s1ap_pdu_c::types_opts::successful_outcome and
+           rx_pdu.successful_outcome().value.type().value ==
+               s1ap_elem_procs_o::successful_outcome_c::types_opts::s1_setup_resp;
+  }
+
+  bool run()
+  {
+    uint32_t next_ue = 0, nof_done = 0;
+    for (; next_ue < std::min<size_t>(max_inflight, ues.size()); ++next_ue) {
+      TESTASSERT(send_attach_request(ues[next_ue]));
+    }
+    while (nof_done < ues.size()) {
+      s1ap_pdu_c pdu;
+      TESTASSERT(recv_pdu(pdu));
+      ue_t* ue = nullptr;
+      TESTASSERT(handle_rx_pdu(pdu, ue));
+      if (ue != nullptr and ue->state == ue_t::attached) {
+        auto latency = std::chrono::steady_clock::now() - ue->t_start;
+        latencies_usec.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+        nof_done++;
+        if (next_ue < ues.size()) {
+          TESTASSERT(send_attach_request(ues[next_ue++]));
+        }
+      }
+    }
+    return true;
+  }
+
+  void                         close() { sock.close(); }
+  const std::vector<uint32_t>& get_latencies_usec() const { return latencies_usec; }
+
+private:
+  struct ue_t {
+    enum state_t { wait_auth_request, wait_smc, wait_ctx_setup, wait_emm_info, attached };
+
+    uint64_t                              imsi;
+    uint32_t                              ue_idx;
+    uint32_t                              mme_ue_s1ap_id;
+    state_t                               state;
+    uint32_t                              ul_count;
+    uint8_t                               k_asme[32];
+    uint8_t                               k_nas_int[32];
+    std::chrono::steady_clock::time_point t_start;
+  };
+
+  bool send_pdu(const s1ap_pdu_c& pdu, uint16_t stream_id)
+  {
+    uint8_t       buf[2048];
+    asn1::bit_ref bref(buf, sizeof(buf));
+    if (pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+      return false;
+    }
+    return sctp_sendmsg(sock.fd(),
+                        buf,
+                        bref.distance_bytes(),
+                        (sockaddr*)&mme_addr,
+                        sizeof(mme_addr),
+                        htonl((uint32_t)srsran::net_utils::ppid_values::S1AP),
+                        0,
+                        stream_id,
+                        0,
+                        0) > 0;
+  }
+
+  bool recv_pdu(s1ap_pdu_c& pdu)
+  {
+    uint8_t         buf[2048];
+    sockaddr_in     from    = {};
+    socklen_t       fromlen = sizeof(from);
+    sctp_sndrcvinfo sri     = {};
+    int             flags   = 0;
+    ssize_t         n;
+    do {
+      n = sctp_recvmsg(sock.fd(), buf, sizeof(buf), (sockaddr*)&from, &fromlen, &sri, &flags);
+    } while (n > 0 and (flags & MSG_NOTIFICATION));
+    if (n <= 0) {
+      return false;
+    }
+    asn1::cbit_ref bref(buf, n);
+    return pdu.unpack(bref) == asn1::SRSASN_SUCCESS;
+  }
+
+  bool send_attach_request(ue_t& ue)
+  {
+    LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT           attach_req  = {};
+    LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+    pdn_con_req.proc_transaction_id                            = 1;
+    pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+    pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+    liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+    attach_req.eps_attach_type = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+    for (uint32_t i = 0; i < 4; i++) {
+      attach_req.ue_network_cap.eea[i] = true;
+      attach_req.ue_network_cap.eia[i] = i > 0;
+    }
+    attach_req.nas_ksi.tsc_flag         = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+    attach_req.nas_ksi.nas_ksi          = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+    attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+    uint64_t imsi                       = ue.imsi;
+    for (int i = 14; i >= 0; --i) {
+      attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+      imsi /= 10;
+    }
+    srsran::byte_buffer_t nas;
+    liblte_mme_pack_attach_request_msg(&attach_req, (LIBLTE_BYTE_MSG_STRUCT*)&nas);
+
+    ue.state    = ue_t::wait_auth_request;
+    ue.ul_count = 0;
+    ue.t_start  = std::chrono::steady_clock::now();
+
+    s1ap_pdu_c pdu;
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+    init_ue_msg_s& container        = pdu.init_msg().value.init_ue_msg();
+    container->enb_ue_s1ap_id.value = ue.ue_idx;
+    container->nas_pdu.value.resize(nas.N_bytes);
+    std::memcpy(container->nas_pdu.value.data(), nas.msg, nas.N_bytes);
+    container->tai.value                     = tai;
+    container->eutran_cgi.value              = eutran_cgi;
+    container->rrc_establishment_cause.value = rrc_establishment_cause_opts::mo_sig;
+    return send_pdu(pdu, 1);
+  }
+
+  bool send_ul_nas(ue_t& ue, srsran::byte_buffer_t& nas, bool integrity)
+  {
+    if (integrity) {
+      srsran::security_128_eia2(&ue.k_nas_int[16],
+                                ue.ul_count,
+                                0,
+                                srsran::SECURITY_DIRECTION_UPLINK,
+                                &nas.msg[5],
+                                nas.N_bytes - 5,
+                                &nas.msg[1]);
+      ue.ul_count++;
+    }
+    s1ap_pdu_c pdu;
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+    ul_nas_transport_s& container   = pdu.init_msg().value.ul_nas_transport();
+    container->mme_ue_s1ap_id.value = ue.mme_ue_s1ap_id;
+    container->enb_ue_s1ap_id.value = ue.ue_idx;
+    container->nas_pdu.value.resize(nas.N_bytes);
+    std::memcpy(container->nas_pdu.value.data(), nas.msg, nas.N_bytes);
+    container->eutran_cgi.value = eutran_cgi;
+    container->tai.value        = tai;
+    return send_pdu(pdu, 1);
+  }
+
+  bool handle_rx_pdu(const s1ap_pdu_c& pdu, ue_t*& ue)
+  {
+    TESTASSERT(pdu.type().value == s1ap_pdu_c::types_opts::init_msg);
+    const s1ap_elem_procs_o::init_msg_c& msg = pdu.init_msg().value;
+    if (msg.type().value == s1ap_elem_procs_o::init_msg_c::types_opts::dl_nas_transport) {
+      const dl_nas_transport_s& dl_nas = msg.dl_nas_transport();
+      TESTASSERT(dl_nas->enb_ue_s1ap_id.value.value < ues.size());
+      ue                 = &ues[dl_nas->enb_ue_s1ap_id.value.value];
+      ue->mme_ue_s1ap_id = dl_nas->mme_ue_s1ap_id.value.value;
+      srsran::byte_buffer_t nas;
+      std::memcpy(nas.msg, dl_nas->nas_pdu.value.data(), dl_nas->nas_pdu.value.size());
+      nas.N_bytes = dl_nas->nas_pdu.value.size();
+      return handle_dl_nas(*ue, nas);
+    }
+    if (msg.type().value == s1ap_elem_procs_o::init_msg_c::types_opts::init_context_setup_request) {
+      const init_context_setup_request_s& ctx_req = msg.init_context_setup_request();
+      TESTASSERT(ctx_req->enb_ue_s1ap_id.value.value < ues.size());
+      ue = &ues[ctx_req->enb_ue_s1ap_id.value.value];
+      TESTASSERT(ue->state == ue_t::wait_ctx_setup);
+      return handle_ctx_setup_request(*ue, ctx_req);
+    }
+    // Other procedures, e.g. paging, are not part of the attach
+    return true;
+  }
+
+  bool handle_dl_nas(ue_t& ue, srsran::byte_buffer_t& nas)
+  {
+    switch (ue.state) {
+      case ue_t::wait_auth_request: {
+        LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+        TESTASSERT(liblte_mme_unpack_authentication_request_msg((LIBLTE_BYTE_MSG_STRUCT*)&nas, &auth_req) ==
+                   LIBLTE_SUCCESS);
+        uint8_t k[16], opc[16], ck[16], ik[16], ak[6], ak_xor_sqn[6];
+        std::memcpy(k, ue_key, sizeof(k));
+        std::memcpy(opc, ue_opc, sizeof(opc));
+        LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_resp = {};
+        srsran::security_milenage_f2345(k, opc, auth_req.rand, auth_resp.res, ck, ik, ak);
+        auth_resp.res_len = 8;
+        // SQN xor AK, as in the AUTN
+        std::memcpy(ak_xor_sqn, auth_req.autn, sizeof(ak_xor_sqn));
+        srsran::security_generate_k_asme(ck, ik, ak_xor_sqn, bench_mcc, bench_mnc, ue.k_asme);
+
+        srsran::byte_buffer_t resp;
+        liblte_mme_pack_authentication_response_msg(
+            &auth_resp, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, (LIBLTE_BYTE_MSG_STRUCT*)&resp);
+        ue.state = ue_t::wait_smc;
+        return send_ul_nas(ue, resp, false);
+      }
+      case ue_t::wait_smc: {
+        uint8_t k_nas_enc[32];
+        srsran::security_generate_k_nas(ue.k_asme,
+                                        srsran::CIPHERING_ALGORITHM_ID_EEA0,
+                                        srsran::INTEGRITY_ALGORITHM_ID_128_EIA2,
+                                        k_nas_enc,
+                                        ue.k_nas_int);
+        LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sm_comp = {};
+        srsran::byte_buffer_t                        resp;
+        liblte_mme_pack_security_mode_complete_msg(
+            &sm_comp,
+            LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT,
+            ue.ul_count,
+            (LIBLTE_BYTE_MSG_STRUCT*)&resp);
+        ue.state = ue_t::wait_ctx_setup;
+        return send_ul_nas(ue, resp, true);
+      }
+      case ue_t::wait_emm_info:
+        ue.state = ue_t::attached;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  bool handle_ctx_setup_request(ue_t& ue, const init_context_setup_request_s& ctx_req)
+  {
+    // Initial Context Setup Response, with all the E-RABs set up
+    s1ap_pdu_c pdu;
+    pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+    init_context_setup_resp_s& container = pdu.successful_outcome().value.init_context_setup_resp();
+    container->mme_ue_s1ap_id.value      = ue.mme_ue_s1ap_id;
+    container->enb_ue_s1ap_id.value      = ue.ue_idx;
+    const erab_to_be_setup_list_ctxt_su_req_l& erabs = ctx_req->erab_to_be_setup_list_ctxt_su_req.value;
+    container->erab_setup_list_ctxt_su_res.value.resize(erabs.size());
+    for (size_t i = 0; i < erabs.size(); ++i) {
+      container->erab_setup_list_ctxt_su_res.value[i].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+      erab_setup_item_ctxt_su_res_s& item = container->erab_setup_list_ctxt_su_res.value[i]->erab_setup_item_ctxt_su_res();
+      item.erab_id                        = erabs[i]->erab_to_be_setup_item_ctxt_su_req().erab_id;
+      item.transport_layer_address.resize(32);
+      item.transport_layer_address.from_number(ntohl(inet_addr(bench_mme_addr)));
+      item.gtp_teid.from_number(ue.mme_ue_s1ap_id);
+    }
+    TESTASSERT(send_pdu(pdu, 1));
+
+    // Attach Complete, with the Activate Default EPS Bearer Context Accept
+    LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_comp = {};
+    LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_accept  = {};
+    act_accept.eps_bearer_id                                                     = 5;
+    act_accept.proc_transaction_id                                               = 1;
+    liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_accept, &attach_comp.esm_msg);
+    srsran::byte_buffer_t nas;
+    liblte_mme_pack_attach_complete_msg(
+        &attach_comp, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, ue.ul_count, (LIBLTE_BYTE_MSG_STRUCT*)&nas);
+    ue.state = ue_t::wait_emm_info;
+    return send_ul_nas(ue, nas, true);
+  }
+
+  uint32_t              enb_id;
+  uint32_t              max_inflight;
+  srsran::unique_socket sock;
+  sockaddr_in           mme_addr = {};
+  tai_s                 tai;
+  eutran_cgi_s          eutran_cgi;
+  std::vector<ue_t>     ues;
+  std::vector<uint32_t> latencies_usec;
+};
+
+int write_user_db(const std::string& filename, uint32_t nof_ues)
+{
+  std::ofstream db(filename);
+  TESTASSERT(db.is_open());
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    db << fmt::format("ue{},mil,{:015},{:02x},opc,{:02x},8000,000000001234,7,dynamic\n",
+                      i,
+                      first_imsi + i,
+                      fmt::join(ue_key, ue_key + sizeof(ue_key), ""),
+                      fmt::join(ue_opc, ue_opc + sizeof(ue_opc), ""));
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int run_attaches(const run_params& params, run_result& result)
+{
+  char db_file[] = "/tmp/mme_attach_benchmark_XXXXXX";
+  int  db_fd     = mkstemp(db_file);
+  TESTASSERT(db_fd >= 0);
+  ::close(db_fd);
+  TESTASSERT(write_user_db(db_file, params.nof_ues) == SRSRAN_SUCCESS);
+
+  hss_args_t hss_args = {};
+  hss_args.db_file    = db_file;
+  hss_args.mcc        = bench_mcc;
+  hss_args.mnc        = bench_mnc;
+
+  mme_args_t   mme_args  = {};
+  s1ap_args_t& s1ap_args = mme_args.s1ap_args;
+  s1ap_args.mme_code        = 0x1a;
+  s1ap_args.mme_group       = 1;
+  s1ap_args.tac             = bench_tac;
+  s1ap_args.mcc             = bench_mcc;
+  s1ap_args.mnc             = bench_mnc;
+  s1ap_args.paging_timer    = 2;
+  s1ap_args.mme_bind_addr   = bench_mme_addr;
+  s1ap_args.mme_name        = "srsmme01";
+  s1ap_args.dns_addr        = "8.8.8.8";
+  s1ap_args.full_net_name   = "Software Radio Systems RAN";
+  s1ap_args.short_net_name  = "srsRAN";
+  s1ap_args.mme_apn         = "srsapn";
+  s1ap_args.encryption_algo = srsran::CIPHERING_ALGORITHM_ID_EEA0;
+  s1ap_args.integrity_algo  = srsran::INTEGRITY_ALGORITHM_ID_128_EIA2;
+  s1ap_args.lac             = 1;
+  s1ap_args.nof_workers     = params.nof_workers;
+
+  // The MME reports every NAS message on the console. Keep it out of the results
+  fflush(stdout);
+  int stdout_fd = dup(STDOUT_FILENO);
+  int null_fd   = open("/dev/null", O_WRONLY);
+  dup2(null_fd, STDOUT_FILENO);
+  ::close(null_fd);
+
+  hss* hss = hss::get_instance();
+  TESTASSERT(hss->init(&hss_args) == SRSRAN_SUCCESS);
+  stub_sgw sgw;
+  TESTASSERT(sgw.init());
+  mme* mme = mme::get_instance();
+  TESTASSERT(mme->init(&mme_args) == SRSRAN_SUCCESS);
+  mme->start();
+
+  std::vector<std::unique_ptr<enb_emulator> > enbs;
+  for (uint32_t i = 0; i < params.nof_enbs; ++i) {
+    enbs.emplace_back(new enb_emulator(i, params));
+    TESTASSERT(enbs.back()->s1_setup());
+  }
+
+  std::atomic<uint32_t>    nof_failed{0};
+  std::vector<std::thread> enb_threads;
+  auto                     tp = std::chrono::steady_clock::now();
+  for (auto& enb : enbs) {
+    enb_threads.emplace_back([&enb, &nof_failed]() {
+      if (enb->run() != true) {
+        nof_failed++;
+      }
+    });
+  }
+  for (std::thread& t : enb_threads) {
+    t.join();
+  }
+  double duration_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+
+  for (auto& enb : enbs) {
+    enb->close();
+  }
+  mme->stop();
+  mme->cleanup();
+  sgw.stop();
+  hss->stop();
+  hss->cleanup();
+  unlink(db_file);
+
+  fflush(stdout);
+  dup2(stdout_fd, STDOUT_FILENO);
+  ::close(stdout_fd);
+  TESTASSERT(nof_failed == 0);
+
+  std::vector<uint32_t> latencies_usec;
+  for (auto& enb : enbs) {
+    latencies_usec.insert(
+        latencies_usec.end(), enb->get_latencies_usec().begin(), enb->get_latencies_usec().end());
+  }
+  TESTASSERT(latencies_usec.size() == params.nof_ues);
+  std::sort(latencies_usec.begin(), latencies_usec.end());
+  size_t nof_ues          = latencies_usec.size();
+  result.attaches_per_sec = nof_ues / duration_sec;
+  result.avg_msec         = std::accumulate(latencies_usec.begin(), latencies_usec.end(), 0.0) / nof_ues / 1000.0;
+  result.q50_msec         = latencies_usec[nof_ues / 2] / 1000.0;
+  result.q99_msec         = latencies_usec[std::min((size_t)(nof_ues * 0.99), nof_ues - 1)] / 1000.0;
+  result.max_msec         = latencies_usec.back() / 1000.0;
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsepc
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  srsepc::run_params params = {};
+  params.nof_workers        = argc > 1 ? std::stoul(argv[1]) : 4;
+  params.nof_ues            = argc > 2 ? std::stoul(argv[2]) : 1000;
+  params.nof_enbs           = argc > 3 ? std::stoul(argv[3]) : 4;
+  params.max_inflight       = 64;
+  TESTASSERT(params.nof_workers > 0 and params.nof_ues > 0 and params.nof_enbs > 0);
+
+  srsepc::run_result result = {};
+  TESTASSERT(srsepc::run_attaches(params, result) == SRSRAN_SUCCESS);
+
+  fmt::print("Workers | eNBs |   UEs | Attaches/s | avg [msec] | q0.5 [msec] | q0.99 [msec] | max [msec]\n");
+  fmt::print("-------------------------------------------------------------------------------------------\n");
+  fmt::print("{:>7}{:>7}{:>8}{:>13.1f}{:>13.2f}{:>14.2f}{:>15.2f}{:>13.2f}\n",
+             params.nof_workers,
+             params.nof_enbs,
+             params.nof_ues,
+             result.attaches_per_sec,
+             result.avg_msec,
+             result.q50_msec,
+             result.q99_msec,
+             result.max_msec);
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
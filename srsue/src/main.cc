@@ -405,6 +405,10 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
        bpo::value<bool>(&args->phy.pdsch_8bit_decoder)->default_value(false),
        "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental)")
 
+    ("phy.pdsch_cb_workers",
+       bpo::value<uint32_t>(&args->phy.pdsch_cb_workers)->default_value(0),
+       "Number of threads per PDSCH decoder decoding code blocks in parallel (0 decodes them serially)")
+
     ("phy.force_ul_amplitude",
        bpo::value<float>(&args->phy.force_ul_amplitude)->default_value(0.0),
        "Forces the peak amplitude in the PUCCH, PUSCH and SRS (set 0.0 to 1.0, set to 0 or negative for disabling)")
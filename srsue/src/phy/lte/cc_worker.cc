@@ -109,6 +109,11 @@ cc_worker::cc_worker(uint32_t cc_idx_, uint32_t max_prb, srsue::phy_common* phy_
     ue_dl.pdsch.llr_is_8bit        = true;
     ue_dl.pdsch.dl_sch.llr_is_8bit = true;
   }
+
+  // Decode the code blocks of each PDSCH transport block with additional threads
+  if (srsran_sch_enable_cb_workers(&ue_dl.pdsch.dl_sch, phy->args->pdsch_cb_workers)) {
+    ERROR("Error creating %d PDSCH code block workers", phy->args->pdsch_cb_workers);
+  }
 }
 
 cc_worker::~cc_worker()
@@ -371,7 +371,8 @@ void gw::run_thread()
           break;
         }
 
-        // Send PDU directly to PDCP
+        // Send PDU directly to PDCP, releasing the large buffer it was read into
+        pdu->shrink_to_fit();
         pdu->set_timestamp();
         ul_tput_bytes += pdu->N_bytes;
         stack->write_sdu(eps_bearer_id, std::move(pdu));